@@ -0,0 +1,272 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pbitset.h
+ * @brief Bit set
+ * @author Alexander Saprykin
+ *
+ * A bit set is a fixed-size array of bits, each bit can be set or cleared
+ * individually. Bit sets are useful for occupancy and allocation maps, sets of
+ * small integers and similar structures where every element takes just a
+ * single bit.
+ *
+ * #PBitSet stores bits in 64-bit words, so all bulk operations process 64 bits
+ * at once. The bitwise operations between two sets (zbitset_and(),
+ * zbitset_or(), zbitset_xor(), zbitset_andnot()), counting of the set bits
+ * with zbitset_count() and searching with zbitset_find_next_set() and
+ * zbitset_find_next_clear() use AVX2 instructions when they are available at
+ * runtime, processing 256 bits per instruction.
+ *
+ * Iteration over the set bits can be done either with the zbitset_foreach()
+ * call or manually:
+ * @code
+ * pssize index;
+ *
+ * for (index = zbitset_find_next_set (bitset, 0);
+ *      index >= 0;
+ *      index = zbitset_find_next_set (bitset, (psize) index + 1)) {
+ *     ...
+ * }
+ * @endcode
+ *
+ * A bit set can be placed into an external memory block using
+ * zbitset_new_from_memory(). That way a bit set can live inside a #PShm
+ * segment and be shared between several processes. Use
+ * zbitset_get_memory_size() to get the size of the memory required to store a
+ * given number of bits. Access to a shared bit set must be synchronized
+ * externally, i.e. with zshm_lock().
+ *
+ * #PBitSet is not thread-safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PBITSET_H
+#define PLIBSYS_HEADER_PBITSET_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+
+P_BEGIN_DECLS
+
+/** Bit set opaque data structure. */
+typedef struct PBitSet_ PBitSet;
+
+/**
+ * @brief Function to iterate through the set bits.
+ * @param index Index of the set bit.
+ * @param user_data Data provided by a user, maybe NULL.
+ * @return FALSE to continue iterating, TRUE to stop it.
+ * @since 0.0.5
+ */
+typedef pboolean (*PBitSetFunc) (psize index, ppointer user_data);
+
+/**
+ * @brief Creates a new #PBitSet with all the bits cleared.
+ * @param nbits Number of bits in the set, must be greater than 0.
+ * @return Newly created #PBitSet in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PBitSet *	zbitset_new			(psize			nbits);
+
+/**
+ * @brief Creates a new #PBitSet using an external memory block for the bits.
+ * @param mem Memory to store the bits in, aligned at least to 8 bytes.
+ * @param size Size of the @a mem, in bytes, should be at least the value
+ * returned by zbitset_get_memory_size() for @a nbits.
+ * @param nbits Number of bits in the set, must be greater than 0.
+ * @return Newly created #PBitSet in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The memory is neither copied nor cleared, so previous contents of the bit set
+ * stored in the @a mem are preserved. The memory must stay valid until the bit
+ * set is freed, freeing the bit set doesn't free the @a mem.
+ */
+P_LIB_API PBitSet *	zbitset_new_from_memory		(ppointer		mem,
+							 psize			size,
+							 psize			nbits);
+
+/**
+ * @brief Gets the size of the memory required to store bits.
+ * @param nbits Number of bits.
+ * @return Size of the memory, in bytes.
+ * @since 0.0.5
+ */
+P_LIB_API psize		zbitset_get_memory_size		(psize			nbits);
+
+/**
+ * @brief Gets the number of bits in a #PBitSet.
+ * @param bitset #PBitSet to get the number of bits for.
+ * @return Number of bits in the set.
+ * @since 0.0.5
+ */
+P_LIB_API psize		zbitset_get_nbits		(const PBitSet		*bitset);
+
+/**
+ * @brief Sets a bit to 1.
+ * @param bitset #PBitSet to set the bit in.
+ * @param index Index of the bit.
+ * @since 0.0.5
+ */
+P_LIB_API void		zbitset_set_bit			(PBitSet		*bitset,
+							 psize			index);
+
+/**
+ * @brief Sets a bit to 0.
+ * @param bitset #PBitSet to clear the bit in.
+ * @param index Index of the bit.
+ * @since 0.0.5
+ */
+P_LIB_API void		zbitset_clear_bit		(PBitSet		*bitset,
+							 psize			index);
+
+/**
+ * @brief Inverts a bit.
+ * @param bitset #PBitSet to flip the bit in.
+ * @param index Index of the bit.
+ * @since 0.0.5
+ */
+P_LIB_API void		zbitset_flip_bit		(PBitSet		*bitset,
+							 psize			index);
+
+/**
+ * @brief Checks whether a bit is set.
+ * @param bitset #PBitSet to check the bit in.
+ * @param index Index of the bit.
+ * @return TRUE if the bit is set, FALSE if it is cleared or out of range.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zbitset_test_bit		(const PBitSet		*bitset,
+							 psize			index);
+
+/**
+ * @brief Sets all the bits to 1.
+ * @param bitset #PBitSet to fill.
+ * @since 0.0.5
+ */
+P_LIB_API void		zbitset_set_all			(PBitSet		*bitset);
+
+/**
+ * @brief Sets all the bits to 0.
+ * @param bitset #PBitSet to clear.
+ * @since 0.0.5
+ */
+P_LIB_API void		zbitset_clear_all		(PBitSet		*bitset);
+
+/**
+ * @brief Performs the bitwise 'and' operation: @a dst = @a dst & @a src.
+ * @param dst #PBitSet to store the result in.
+ * @param src Second operand.
+ * @return TRUE in case of success, FALSE if the sets have different sizes.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zbitset_and			(PBitSet		*dst,
+							 const PBitSet		*src);
+
+/**
+ * @brief Performs the bitwise 'or' operation: @a dst = @a dst | @a src.
+ * @param dst #PBitSet to store the result in.
+ * @param src Second operand.
+ * @return TRUE in case of success, FALSE if the sets have different sizes.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zbitset_or			(PBitSet		*dst,
+							 const PBitSet		*src);
+
+/**
+ * @brief Performs the bitwise 'xor' operation: @a dst = @a dst ^ @a src.
+ * @param dst #PBitSet to store the result in.
+ * @param src Second operand.
+ * @return TRUE in case of success, FALSE if the sets have different sizes.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zbitset_xor			(PBitSet		*dst,
+							 const PBitSet		*src);
+
+/**
+ * @brief Clears the bits which are set in another set: @a dst = @a dst & ~@a src.
+ * @param dst #PBitSet to store the result in.
+ * @param src Second operand.
+ * @return TRUE in case of success, FALSE if the sets have different sizes.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zbitset_andnot			(PBitSet		*dst,
+							 const PBitSet		*src);
+
+/**
+ * @brief Counts the set bits.
+ * @param bitset #PBitSet to count the bits in.
+ * @return Number of the set bits.
+ * @since 0.0.5
+ */
+P_LIB_API psize		zbitset_count			(const PBitSet		*bitset);
+
+/**
+ * @brief Searches for the first set bit starting from a given index.
+ * @param bitset #PBitSet to search in.
+ * @param from Index of the bit to start from (inclusive).
+ * @return Index of the found bit, -1 if no set bits were found.
+ * @since 0.0.5
+ */
+P_LIB_API pssize	zbitset_find_next_set		(const PBitSet		*bitset,
+							 psize			from);
+
+/**
+ * @brief Searches for the first cleared bit starting from a given index.
+ * @param bitset #PBitSet to search in.
+ * @param from Index of the bit to start from (inclusive).
+ * @return Index of the found bit, -1 if no cleared bits were found.
+ * @since 0.0.5
+ */
+P_LIB_API pssize	zbitset_find_next_clear		(const PBitSet		*bitset,
+							 psize			from);
+
+/**
+ * @brief Iterates in ascending order through the set bits.
+ * @param bitset #PBitSet to iterate through.
+ * @param func Function to call for every set bit.
+ * @param user_data Additional (maybe NULL) user-provided data for the
+ * @a func.
+ * @since 0.0.5
+ *
+ * The bit set should not be modified while iterating.
+ */
+P_LIB_API void		zbitset_foreach			(const PBitSet		*bitset,
+							 PBitSetFunc		func,
+							 ppointer		user_data);
+
+/**
+ * @brief Frees a #PBitSet.
+ * @param bitset #PBitSet to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		zbitset_free			(PBitSet		*bitset);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PBITSET_H */
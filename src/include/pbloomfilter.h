@@ -0,0 +1,192 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pbloomfilter.h
+ * @brief Bloom filter
+ * @author Alexander Saprykin
+ *
+ * A Bloom filter is a space-efficient probabilistic data structure used to
+ * test whether an element is a member of a set. False positive matches are
+ * possible, but false negatives are not: if the filter says that an element is
+ * absent, it was never inserted. This makes the filter a cheap guard in front
+ * of an expensive lookup (disk or network I/O) for the keys which are likely to
+ * be missing. Elements can't be removed from the filter, see #PCuckooFilter if
+ * you need deletion.
+ *
+ * #PBloomFilter is a blocked (split block) Bloom filter: the bit array is
+ * divided into 256-bit blocks, and all the bits of a single element are placed
+ * into the one block chosen by its hash, one bit per every 32-bit word of the
+ * block. A block never crosses a cache line boundary, so every operation
+ * touches exactly one cache line. The block layout allows to set or test all
+ * the bits of an element at once using SIMD instructions, AVX2 is used when
+ * available at runtime.
+ *
+ * Use zbloom_filter_new() to create a filter for a given number of elements and
+ * a desired false positive probability. Keys are arbitrary byte sequences,
+ * insert them with zbloom_filter_insert() and test with
+ * zbloom_filter_contains().
+ *
+ * The filter can be serialized into a flat position-independent image with
+ * zbloom_filter_save_image(). The image can be placed into a #PShm segment and
+ * opened in place by several processes with zbloom_filter_new_from_image(),
+ * without copying:
+ * @code
+ * PShm         *shm;
+ * PBloomFilter *filter;
+ * ...
+ * shm = zshm_new ("bloom_filter", zbloom_filter_get_image_size (filter),
+ *                 P_SHM_ACCESS_READWRITE, NULL);
+ * zbloom_filter_save_image (filter, zshm_get_address (shm), zshm_get_size (shm));
+ * ...
+ * // In another process
+ * filter = zbloom_filter_new_from_image (zshm_get_address (shm),
+ *                                        zshm_get_size (shm),
+ *                                        TRUE);
+ * @endcode
+ *
+ * In the shared mode zbloom_filter_insert() and zbloom_filter_contains() can be
+ * called concurrently from several threads and processes: both use atomic
+ * operations, so a lookup never misses an element which was completely
+ * inserted before. zbloom_filter_clear() and zbloom_filter_save_image() are
+ * not atomic and require exclusive access to the filter.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PBLOOMFILTER_H
+#define PLIBSYS_HEADER_PBLOOMFILTER_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+
+P_BEGIN_DECLS
+
+/** Bloom filter opaque data structure. */
+typedef struct PBloomFilter_ PBloomFilter;
+
+/**
+ * @brief Creates a new #PBloomFilter.
+ * @param capacity Expected number of elements, must be greater than 0.
+ * @param fpp Desired false positive probability for @a capacity elements, in
+ * the (0, 1) range.
+ * @return Newly created empty #PBloomFilter in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PBloomFilter *	zbloom_filter_new		(psize			capacity,
+								 double			fpp);
+
+/**
+ * @brief Opens a #PBloomFilter in a memory image.
+ * @param image Memory with the filter image previously stored with
+ * zbloom_filter_save_image().
+ * @param size Size of the @a image memory, in bytes.
+ * @param shared Whether the @a image can be concurrently accessed by several
+ * threads or processes.
+ * @return #PBloomFilter working directly with the @a image memory in case of
+ * success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The image is not copied, so it must stay valid until the filter is freed.
+ * All the insertions are performed in place. Freeing the filter doesn't free
+ * the @a image.
+ */
+P_LIB_API PBloomFilter *	zbloom_filter_new_from_image	(ppointer		image,
+								 psize			size,
+								 pboolean		shared);
+
+/**
+ * @brief Inserts an element into a #PBloomFilter.
+ * @param filter #PBloomFilter to insert the element into.
+ * @param data Element data.
+ * @param len Length of the @a data, in bytes.
+ * @since 0.0.5
+ */
+P_LIB_API void			zbloom_filter_insert		(PBloomFilter		*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Checks whether a #PBloomFilter may contain an element.
+ * @param filter #PBloomFilter to check.
+ * @param data Element data.
+ * @param len Length of the @a data, in bytes.
+ * @return FALSE if the element was definitely not inserted, TRUE if it
+ * probably was.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zbloom_filter_contains		(const PBloomFilter	*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Removes all the elements from a #PBloomFilter.
+ * @param filter #PBloomFilter to clear.
+ * @since 0.0.5
+ * @note The filter must not be accessed concurrently while it is cleared, even
+ * in the shared mode.
+ */
+P_LIB_API void			zbloom_filter_clear		(PBloomFilter		*filter);
+
+/**
+ * @brief Gets the size of a #PBloomFilter image.
+ * @param filter #PBloomFilter to get the image size for.
+ * @return Size of the memory image, in bytes, in case of success, 0
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API psize			zbloom_filter_get_image_size	(const PBloomFilter	*filter);
+
+/**
+ * @brief Stores a #PBloomFilter into a memory image.
+ * @param filter #PBloomFilter to store.
+ * @param[out] buf Buffer to store the image into, must be aligned at least to
+ * 8 bytes.
+ * @param size Size of the @a buf, in bytes, should be at least the value
+ * returned by zbloom_filter_get_image_size().
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The image is position-independent and can be opened with
+ * zbloom_filter_new_from_image() by any process on the same host. Align
+ * @a buf to 64 bytes (memory mapped segments always are) to keep the filter
+ * blocks within the cache lines.
+ */
+P_LIB_API pboolean		zbloom_filter_save_image	(const PBloomFilter	*filter,
+								 ppointer		buf,
+								 psize			size);
+
+/**
+ * @brief Frees a #PBloomFilter.
+ * @param filter #PBloomFilter to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			zbloom_filter_free		(PBloomFilter		*filter);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PBLOOMFILTER_H */
@@ -0,0 +1,83 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCPUINFO_PRIVATE_H
+#define PLIBSYS_HEADER_PCPUINFO_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/* Compiler can emit code for x86 extensions in a per-function manner using
+ * the target attribute, without enabling them for the whole library */
+#if (defined (P_CPU_X86_32) || defined (P_CPU_X86_64)) && defined (P_CC_GNU) && \
+    (defined (P_CC_CLANG) || (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#  define PLIBSYS_HAS_X86_TARGET_ATTR
+#  define P_CPU_TARGET(ext) __attribute__ ((target (ext)))
+#endif
+
+/* The same for the ARMv8 cryptography extension */
+#if defined (P_CPU_ARM_64) && defined (P_CC_GNU) && defined (P_OS_LINUX) && \
+    (defined (P_CC_CLANG) || (__GNUC__ > 5))
+#  define PLIBSYS_HAS_ARM_TARGET_ATTR
+#  ifndef P_CPU_TARGET
+#    define P_CPU_TARGET(ext) __attribute__ ((target (ext)))
+#  endif
+#endif
+
+/** CPU features which can be detected at runtime. */
+typedef enum PCpuFeature_ {
+	P_CPU_FEATURE_SSE2	= 1 << 0,	/**< x86 SSE2.				*/
+	P_CPU_FEATURE_SSSE3	= 1 << 1,	/**< x86 SSSE3.				*/
+	P_CPU_FEATURE_SSE41	= 1 << 2,	/**< x86 SSE4.1.			*/
+	P_CPU_FEATURE_POPCNT	= 1 << 3,	/**< x86 POPCNT instruction.		*/
+	P_CPU_FEATURE_AVX2	= 1 << 4,	/**< x86 AVX2 (with OS support).	*/
+	P_CPU_FEATURE_AVX512	= 1 << 5,	/**< x86 AVX-512 F+VL+BW (with OS).	*/
+	P_CPU_FEATURE_SHA	= 1 << 6,	/**< x86 SHA extensions.		*/
+	P_CPU_FEATURE_ARM_SHA1	= 1 << 7,	/**< ARMv8 SHA-1 instructions.		*/
+	P_CPU_FEATURE_ARM_SHA2	= 1 << 8	/**< ARMv8 SHA-256 instructions.	*/
+} PCpuFeature;
+
+/**
+ * @brief Detects CPU features, called once on library initialization.
+ */
+void		zcpu_info_init		(void);
+
+/**
+ * @brief Checks whether a CPU feature is available at runtime.
+ * @param feature Feature to check.
+ * @return TRUE if the feature can be used, FALSE otherwise.
+ * @note All features are reported as unavailable before zlibsys_init().
+ */
+pboolean	zcpu_info_has_feature	(PCpuFeature	feature);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCPUINFO_PRIVATE_H */
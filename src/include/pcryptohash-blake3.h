@@ -0,0 +1,71 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* BLAKE3 interface implementation for #PCryptoHash */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCRYPTOHASHBLAKE3_H
+#define PLIBSYS_HEADER_PCRYPTOHASHBLAKE3_H
+
+#include "ptypes.h"
+#include "pmacros.h"
+
+P_BEGIN_DECLS
+
+#define P_BLAKE3_BLOCK_LEN		64
+#define P_BLAKE3_OUT_LEN		32
+#define P_BLAKE3_MAX_DEPTH		54
+
+typedef struct PHashBLAKE3_ PHashBLAKE3;
+
+typedef struct PBlake3Chunk_ {
+	puint32		cv[8];
+	puint64		counter;
+	puchar		buf[P_BLAKE3_BLOCK_LEN];
+	puint		buf_len;
+	puint		blocks_compressed;
+} PBlake3Chunk;
+
+struct PHashBLAKE3_ {
+	PBlake3Chunk	chunk;
+	puchar		cv_stack[(P_BLAKE3_MAX_DEPTH + 1) * P_BLAKE3_OUT_LEN];
+	puint		cv_stack_len;
+	puchar		hash[P_BLAKE3_OUT_LEN];
+	puint		threads;
+};
+
+void		zcrypto_hash_blake3_init	(PHashBLAKE3 *ctx);
+void		zcrypto_hash_blake3_update	(PHashBLAKE3 *ctx, const puchar *data, psize len);
+void		zcrypto_hash_blake3_finish	(PHashBLAKE3 *ctx);
+const puchar *	zcrypto_hash_blake3_digest	(PHashBLAKE3 *ctx);
+void		zcrypto_hash_blake3_reset	(PHashBLAKE3 *ctx);
+void		zcrypto_hash_blake3_set_threads	(PHashBLAKE3 *ctx, puint threads);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCRYPTOHASHBLAKE3_H */
@@ -39,14 +39,20 @@ P_BEGIN_DECLS
 
 typedef struct PHashGOST3411_ PHashGOST3411;
 
-PHashGOST3411 *	zcrypto_hash_gost3411_new	(void);
+struct PHashGOST3411_ {
+	puint32	buf[8];  /* Buffer to handle incoming data. */
+	puint32	hash[8]; /* State of calculated hash.       */
+	puint32	len[8];  /* Length of hashed data, in bits. */
+	puint32	sum[8];  /* 256-bit sum of hashed data.     */
+};
+
+void		zcrypto_hash_gost3411_init	(PHashGOST3411		*ctx);
 void		zcrypto_hash_gost3411_update	(PHashGOST3411		*ctx,
 						 const puchar		*data,
 						 psize			len);
 void		zcrypto_hash_gost3411_finish	(PHashGOST3411		*ctx);
 const puchar *	zcrypto_hash_gost3411_digest	(PHashGOST3411		*ctx);
 void		zcrypto_hash_gost3411_reset	(PHashGOST3411		*ctx);
-void		zcrypto_hash_gost3411_free	(PHashGOST3411		*ctx);
 
 P_END_DECLS
 
@@ -0,0 +1,59 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Multi-buffer hashing of independent messages for #PCryptoHash */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCRYPTOHASHMANY_PRIVATE_H
+#define PLIBSYS_HEADER_PCRYPTOHASHMANY_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "pcryptohash.h"
+
+P_BEGIN_DECLS
+
+/**
+ * @brief Hashes independent messages interleaved across SIMD lanes.
+ * @param type Hash function type.
+ * @param inputs Messages to hash.
+ * @param lengths Message lengths, in bytes.
+ * @param digests Buffers for the raw digests.
+ * @param count Number of messages.
+ * @return TRUE if the messages were hashed, FALSE if there is no SIMD
+ * implementation for @a type on the current CPU.
+ */
+pboolean	zcrypto_hash_many_simd	(PCryptoHashType	type,
+					 const puchar * const	*inputs,
+					 const psize		*lengths,
+					 puchar * const		*digests,
+					 psize			count);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCRYPTOHASHMANY_PRIVATE_H */
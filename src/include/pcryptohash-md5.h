@@ -39,12 +39,22 @@ P_BEGIN_DECLS
 
 typedef struct PHashMD5_ PHashMD5;
 
-PHashMD5 *	zcrypto_hash_md5_new		(void);
+struct PHashMD5_ {
+	union {
+		puchar	buf[64];
+		puint32	buf_w[16];
+	} buf;
+	puint32		hash[4];
+
+	puint32		len_high;
+	puint32		len_low;
+};
+
+void		zcrypto_hash_md5_init		(PHashMD5 *ctx);
 void		zcrypto_hash_md5_update	(PHashMD5 *ctx, const puchar *data, psize len);
 void		zcrypto_hash_md5_finish	(PHashMD5 *ctx);
 const puchar *	zcrypto_hash_md5_digest	(PHashMD5 *ctx);
 void		zcrypto_hash_md5_reset		(PHashMD5 *ctx);
-void		zcrypto_hash_md5_free		(PHashMD5 *ctx);
 
 P_END_DECLS
 
@@ -0,0 +1,82 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Internal access to #PCryptoHash contexts for the modules built on top of it */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCRYPTOHASH_PRIVATE_H
+#define PLIBSYS_HEADER_PCRYPTOHASH_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "pcryptohash.h"
+
+P_BEGIN_DECLS
+
+/**
+ * @brief Gets the input block size of a hash function.
+ * @param type Hash function type.
+ * @return Block size in bytes (the rate for the SHA-3 types), 0 for an invalid
+ * @a type.
+ */
+psize		zcrypto_hash_get_block_size	(PCryptoHashType	type);
+
+/**
+ * @brief Gets the memory size needed for a #PCryptoHash context.
+ * @param type Hash function type.
+ * @return Size in bytes of the context header and the algorithm state, a
+ * multiple of 8, 0 for an invalid @a type.
+ */
+psize		zcrypto_hash_get_memory_size	(PCryptoHashType	type);
+
+/**
+ * @brief Initializes a #PCryptoHash context in caller-provided memory.
+ * @param mem Memory of at least zcrypto_hash_get_memory_size() bytes, aligned
+ * to 8 bytes.
+ * @param type Hash function type.
+ * @return Context placed in @a mem, NULL for an invalid @a type.
+ *
+ * The context doesn't own @a mem, zcrypto_hash_free() does nothing for it.
+ */
+PCryptoHash *	zcrypto_hash_init_at		(ppointer		mem,
+						 PCryptoHashType	type);
+
+/**
+ * @brief Copies the whole state of a context into another one.
+ * @param dst Context to copy into, must be of the same type as @a src.
+ * @param src Context to copy from.
+ *
+ * The algorithm state is copied as is, so the hashing of @a dst continues
+ * from the same point as @a src without reprocessing any data.
+ */
+void		zcrypto_hash_copy_state	(PCryptoHash		*dst,
+						 const PCryptoHash	*src);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCRYPTOHASH_PRIVATE_H */
@@ -39,12 +39,22 @@ P_BEGIN_DECLS
 
 typedef struct PHashSHA1_ PHashSHA1;
 
-PHashSHA1 *	zcrypto_hash_sha1_new		(void);
+struct PHashSHA1_ {
+	union {
+		puchar	buf[64];
+		puint32	buf_w[16];
+	} buf;
+	puint32		hash[5];
+
+	puint32		len_high;
+	puint32		len_low;
+};
+
+void		zcrypto_hash_sha1_init		(PHashSHA1 *ctx);
 void		zcrypto_hash_sha1_update	(PHashSHA1 *ctx, const puchar *data, psize len);
 void		zcrypto_hash_sha1_finish	(PHashSHA1 *ctx);
 const puchar *	zcrypto_hash_sha1_digest	(PHashSHA1 *ctx);
 void		zcrypto_hash_sha1_reset	(PHashSHA1 *ctx);
-void		zcrypto_hash_sha1_free		(PHashSHA1 *ctx);
 
 P_END_DECLS
 
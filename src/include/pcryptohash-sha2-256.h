@@ -39,20 +39,31 @@ P_BEGIN_DECLS
 
 typedef struct PHashSHA2_256_ PHashSHA2_256;
 
-PHashSHA2_256 *	zcrypto_hash_sha2_256_new	(void);
+struct PHashSHA2_256_ {
+	union {
+		puchar	buf[64];
+		puint32	buf_w[16];
+	} buf;
+	puint32		hash[8];
+
+	puint32		len_high;
+	puint32		len_low;
+
+	pboolean	is224;
+};
+
+void		zcrypto_hash_sha2_256_init	(PHashSHA2_256 *ctx);
 void		zcrypto_hash_sha2_256_update	(PHashSHA2_256 *ctx, const puchar *data, psize len);
 void		zcrypto_hash_sha2_256_finish	(PHashSHA2_256 *ctx);
 const puchar *	zcrypto_hash_sha2_256_digest	(PHashSHA2_256 *ctx);
 void		zcrypto_hash_sha2_256_reset	(PHashSHA2_256 *ctx);
-void		zcrypto_hash_sha2_256_free	(PHashSHA2_256 *ctx);
 
-PHashSHA2_256 *	zcrypto_hash_sha2_224_new	(void);
+void		zcrypto_hash_sha2_224_init	(PHashSHA2_256 *ctx);
 
 #define zcrypto_hash_sha2_224_update zcrypto_hash_sha2_256_update
 #define zcrypto_hash_sha2_224_finish zcrypto_hash_sha2_256_finish
 #define zcrypto_hash_sha2_224_digest zcrypto_hash_sha2_256_digest
 #define zcrypto_hash_sha2_224_reset  zcrypto_hash_sha2_256_reset
-#define zcrypto_hash_sha2_224_free   zcrypto_hash_sha2_256_free
 
 P_END_DECLS
 
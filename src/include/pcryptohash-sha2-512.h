@@ -39,20 +39,31 @@ P_BEGIN_DECLS
 
 typedef struct PHashSHA2_512_ PHashSHA2_512;
 
-PHashSHA2_512 *	zcrypto_hash_sha2_512_new	(void);
+struct PHashSHA2_512_ {
+	union {
+		puchar	buf[128];
+		puint64	buf_w[16];
+	} buf;
+	puint64		hash[8];
+
+	puint64		len_high;
+	puint64		len_low;
+
+	pboolean	is384;
+};
+
+void		zcrypto_hash_sha2_512_init	(PHashSHA2_512 *ctx);
 void		zcrypto_hash_sha2_512_update	(PHashSHA2_512 *ctx, const puchar *data, psize len);
 void		zcrypto_hash_sha2_512_finish	(PHashSHA2_512 *ctx);
 const puchar *	zcrypto_hash_sha2_512_digest	(PHashSHA2_512 *ctx);
 void		zcrypto_hash_sha2_512_reset	(PHashSHA2_512 *ctx);
-void		zcrypto_hash_sha2_512_free	(PHashSHA2_512 *ctx);
 
-PHashSHA2_512 *	zcrypto_hash_sha2_384_new	(void);
+void		zcrypto_hash_sha2_384_init	(PHashSHA2_512 *ctx);
 
 #define zcrypto_hash_sha2_384_update zcrypto_hash_sha2_512_update
 #define zcrypto_hash_sha2_384_finish zcrypto_hash_sha2_512_finish
 #define zcrypto_hash_sha2_384_digest zcrypto_hash_sha2_512_digest
 #define zcrypto_hash_sha2_384_reset  zcrypto_hash_sha2_512_reset
-#define zcrypto_hash_sha2_384_free   zcrypto_hash_sha2_512_free
 
 P_END_DECLS
 
@@ -55,7 +55,8 @@
  * - SHA-3/256;
  * - SHA-3/384;
  * - SHA-3/512;
- * - GOST (R 34.11-94).
+ * - GOST (R 34.11-94);
+ * - BLAKE3.
  *
  * Use zcrypto_hash_new() to initialize a new hash context with one of the
  * mentioned above types. Data for hashing can be added in several chunks using
@@ -67,6 +68,33 @@
  * a hexidemical string or in a raw representation.
  *
  * A hashing algorithm couldn't be changed after the context initialization.
+ *
+ * zcrypto_hash_new() allocates the context on the heap. To avoid any heap
+ * allocation, initialize a context in place in a caller-provided
+ * #PCryptoHashStorage (on the stack, or embedded into another structure) with
+ * zcrypto_hash_init(), or use zcrypto_hash_compute() to hash a single buffer
+ * at once. Use zcrypto_hash_get_hex() or zcrypto_hash_get_digest() with such
+ * contexts, as zcrypto_hash_get_string() allocates the result string.
+ *
+ * SHA-1 and SHA-2/224/256 use the x86 SHA extensions or the ARMv8
+ * cryptography extension when the CPU supports them, the result doesn't
+ * depend on the implementation being used.
+ *
+ * BLAKE3 uses the SSE4.1 or AVX2 instructions when available. Its input forms
+ * a tree, so large updates can also be split between several threads, see
+ * zcrypto_hash_set_threads().
+ *
+ * To hash a lot of small independent messages use zcrypto_hash_many(): it
+ * doesn't allocate a context per message, and for MD5, SHA-1 and SHA-2/224/256
+ * it processes eight messages at once in the AVX2 vector lanes when the CPU
+ * supports them, four messages at once for the SHA-3 types.
+ *
+ * Files can be hashed with zcrypto_hash_file(): it maps the file into memory
+ * or reads it with large sequential reads, optionally on a helper thread
+ * while the previous block is being hashed, and can report the throughput.
+ *
+ * Keyed message authentication (HMAC) and key derivation (HKDF) on top of
+ * these hash functions are provided by #PCryptoHmac.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -78,6 +106,7 @@
 
 #include <pmacros.h>
 #include <ptypes.h>
+#include <perror.h>
 
 P_BEGIN_DECLS
 
@@ -96,9 +125,43 @@ typedef enum PCryptoHashType_ {
 	P_CRYPTO_HASH_TYPE_SHA3_256	= 7, /**< SHA-2/256 hash function.		@since 0.0.2	*/
 	P_CRYPTO_HASH_TYPE_SHA3_384	= 8, /**< SHA-2/384 hash function.		@since 0.0.2	*/
 	P_CRYPTO_HASH_TYPE_SHA3_512	= 9, /**< SHA-3/512 hash function.		@since 0.0.2	*/
-	P_CRYPTO_HASH_TYPE_GOST		= 10 /**< GOST (R 34.11-94) hash function.	@since 0.0.1	*/
+	P_CRYPTO_HASH_TYPE_GOST		= 10, /**< GOST (R 34.11-94) hash function.	@since 0.0.1	*/
+	P_CRYPTO_HASH_TYPE_BLAKE3	= 11 /**< BLAKE3 hash function (256 bits).	@since 0.0.5	*/
 } PCryptoHashType;
 
+/** Maximum digest length of all the hash function types, in bytes. */
+#define P_CRYPTO_HASH_MAX_LENGTH	64
+
+/** Size of #PCryptoHashStorage, in bytes. */
+#define P_CRYPTO_HASH_STORAGE_SIZE	2048
+
+/** Caller-provided storage for a #PCryptoHash context, see zcrypto_hash_init(). */
+typedef struct PCryptoHashStorage_ {
+	puint64	data[P_CRYPTO_HASH_STORAGE_SIZE / 8];	/**< Opaque data, shouldn't be accessed directly.	*/
+} PCryptoHashStorage;
+
+/**
+ * File hashing flags for zcrypto_hash_file().
+ *
+ * A mapped file must not be truncated while it is being hashed: reading the
+ * mapped pages beyond the new end of the file raises SIGBUS, which terminates
+ * the process unless the signal is handled. Use #P_CRYPTO_HASH_FILE_FLAG_NO_MAP
+ * for files which other processes may truncate (logs, files being written).
+ */
+typedef enum PCryptoHashFileFlags_ {
+	P_CRYPTO_HASH_FILE_FLAG_NONE		= 0,		/**< Map regular files, read other ones.		*/
+	P_CRYPTO_HASH_FILE_FLAG_NO_MAP		= 1 << 0,	/**< Always use sequential reads.			*/
+	P_CRYPTO_HASH_FILE_FLAG_THREADED	= 1 << 1	/**< Allow helper threads for reading and hashing.	*/
+} PCryptoHashFileFlags;
+
+/** File hashing statistics filled by zcrypto_hash_file(). */
+typedef struct PCryptoHashFileStats_ {
+	puint64		bytes;		/**< Number of bytes hashed.				*/
+	puint64		elapsed_usecs;	/**< Time spent on reading and hashing, in microseconds.	*/
+	puint64		bytes_per_sec;	/**< Average throughput, in bytes per second.		*/
+	pboolean	is_mapped;	/**< Whether the file was (partly) memory mapped.	*/
+} PCryptoHashFileStats;
+
 /**
  * @brief Initializes a new #PCryptoHash context.
  * @param type Hash function type to use, can't be changed later.
@@ -108,6 +171,38 @@ typedef enum PCryptoHashType_ {
  */
 P_LIB_API PCryptoHash *		zcrypto_hash_new		(PCryptoHashType	type);
 
+/**
+ * @brief Initializes a #PCryptoHash context in caller-provided storage.
+ * @param storage Storage to initialize the context in.
+ * @param type Hash function type to use, can't be changed later.
+ * @return #PCryptoHash context placed in @a storage in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * No memory is allocated, the context is valid as long as @a storage is. It
+ * can be used in the same way as a context returned by zcrypto_hash_new(),
+ * calling zcrypto_hash_free() for it is not required and does nothing.
+ */
+P_LIB_API PCryptoHash *		zcrypto_hash_init		(PCryptoHashStorage	*storage,
+								 PCryptoHashType	type);
+
+/**
+ * @brief Hashes a single buffer at once.
+ * @param type Hash function type to use.
+ * @param data Data to hash, may be NULL only if @a len is zero.
+ * @param len Data length, in bytes.
+ * @param[out] digest Buffer to store the raw digest in, must hold at least the
+ * digest length of @a type (#P_CRYPTO_HASH_MAX_LENGTH is enough for any type).
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The context is kept on the stack, so no memory is allocated.
+ */
+P_LIB_API pboolean		zcrypto_hash_compute		(PCryptoHashType	type,
+								 const puchar		*data,
+								 psize			len,
+								 puchar			*digest);
+
 /**
  * @brief Adds a new chunk of data for hashing.
  * @param hash #PCryptoHash context to add @a data to.
@@ -144,6 +239,22 @@ P_LIB_API void			zcrypto_hash_reset		(PCryptoHash		*hash);
  */
 P_LIB_API pchar *		zcrypto_hash_get_string	(PCryptoHash		*hash);
 
+/**
+ * @brief Gets a hash in a hexidemical representation without allocating.
+ * @param hash #PCryptoHash context to get a string from.
+ * @param[out] buf Buffer to write the NULL-terminated lowercase string into.
+ * @param size Size of @a buf in bytes, at least twice the digest length plus
+ * one for the terminating zero.
+ * @return Length of the written string without the terminating zero in case of
+ * success, 0 otherwise.
+ * @note Before writing the string the hash context will be closed for further
+ * updates.
+ * @since 0.0.5
+ */
+P_LIB_API psize			zcrypto_hash_get_hex		(PCryptoHash		*hash,
+								 pchar			*buf,
+								 psize			size);
+
 /**
  * @brief Gets a hash in a raw representation.
  * @param hash #PCryptoHash context to get a digest from.
@@ -183,6 +294,77 @@ P_LIB_API PCryptoHashType	zcrypto_hash_get_type		(const PCryptoHash	*hash);
  */
 P_LIB_API void			zcrypto_hash_free		(PCryptoHash		*hash);
 
+/**
+ * @brief Sets the maximum number of threads to use for a single update.
+ * @param hash #PCryptoHash context to set the threads for.
+ * @param threads Maximum number of threads including the calling one, 0 or 1
+ * disables the additional threads.
+ * @return TRUE if the hash function type of @a hash supports parallel
+ * hashing, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Only #P_CRYPTO_HASH_TYPE_BLAKE3 supports parallel hashing. The additional
+ * threads are started only for large updates (at least a few hundreds of
+ * kilobytes) and are finished before zcrypto_hash_update() returns, the
+ * result doesn't depend on the number of threads.
+ */
+P_LIB_API pboolean		zcrypto_hash_set_threads	(PCryptoHash			*hash,
+								 puint				threads);
+
+/**
+ * @brief Hashes several independent messages at once.
+ * @param type Hash function type to use.
+ * @param inputs Messages to hash, an input may be NULL only if its length is
+ * zero.
+ * @param lengths Lengths of the messages, in bytes.
+ * @param digests Buffers to store the raw digests in, every buffer must hold
+ * at least the digest length of @a type.
+ * @param count Number of messages in @a inputs.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The result is the same as hashing every message with a separate
+ * #PCryptoHash context, but much faster for short messages: no memory is
+ * allocated per message, and the messages are interleaved across the SIMD
+ * lanes where an implementation for @a type is available.
+ */
+P_LIB_API pboolean		zcrypto_hash_many		(PCryptoHashType		type,
+								 const puchar * const		*inputs,
+								 const psize			*lengths,
+								 puchar * const			*digests,
+								 psize				count);
+
+/**
+ * @brief Hashes the contents of a file.
+ * @param type Hash function type to use.
+ * @param path Path to the file to hash.
+ * @param flags Hashing flags, see #PCryptoHashFileFlags.
+ * @param[out] stats Hashing statistics, NULL to ignore.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Newly initialized #PCryptoHash context containing the whole file in
+ * case of success, NULL otherwise. Get the hash value from it and free it with
+ * zcrypto_hash_free().
+ * @since 0.0.5
+ *
+ * Regular files are memory mapped in large windows on systems supporting it:
+ * the data is hashed right from the page cache without copying, and the
+ * kernel is asked to read ahead the next window while the current one is
+ * being hashed. Other files (pipes, devices), or every file with
+ * #P_CRYPTO_HASH_FILE_FLAG_NO_MAP, are read in large blocks at block-aligned
+ * offsets with the sequential access hint given to the system. If mapping
+ * fails, the rest of the file is read in the same way.
+ *
+ * With #P_CRYPTO_HASH_FILE_FLAG_THREADED the reads are done on a helper
+ * thread into a second buffer while the previous block is being hashed, and
+ * #P_CRYPTO_HASH_TYPE_BLAKE3 is allowed to use all the available CPU cores
+ * (see zcrypto_hash_set_threads()).
+ */
+P_LIB_API PCryptoHash *		zcrypto_hash_file		(PCryptoHashType		type,
+								 const pchar			*path,
+								 PCryptoHashFileFlags		flags,
+								 PCryptoHashFileStats		*stats,
+								 PError				**error);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PCRYPTOHASH_H */
@@ -0,0 +1,243 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pcryptohmac.h
+ * @brief Keyed-hash message authentication codes and key derivation
+ * @author Alexander Saprykin
+ *
+ * HMAC (RFC 2104) authenticates a message with a secret key on top of any
+ * #PCryptoHash function: the message is hashed together with the key
+ * XOR-ed with an inner pad, and the result is hashed once more with the key
+ * XOR-ed with an outer pad.
+ *
+ * Create a #PCryptoHmac context for a key with zcrypto_hmac_new(). The key
+ * blocks are hashed only once at that time and the resulting inner and outer
+ * hash states are kept in the context, so every message costs two
+ * compression function calls less than hashing the padded key blocks again.
+ * Add the message with zcrypto_hmac_update() and get the code with
+ * zcrypto_hmac_get_digest(), then call zcrypto_hmac_reset() to start the next
+ * message with the same key.
+ *
+ * A message available at once can be authenticated with
+ * zcrypto_hmac_compute(): it uses a copy of the cached states on the stack
+ * and doesn't modify the context, so several threads can share a single
+ * context this way.
+ *
+ * HKDF (RFC 5869) derives keys of any length from an input key material: the
+ * material is condensed into a pseudorandom key with zcrypto_hkdf_extract(),
+ * which is then expanded into the output key with zcrypto_hkdf_expand(). Use
+ * zcrypto_hkdf() to do both steps at once. The HKDF functions don't allocate
+ * memory.
+ *
+ * Every #PCryptoHashType can be used. For the SHA-3 types the block size is
+ * the sponge rate, as specified in FIPS 202 and NIST SP 800-224.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCRYPTOHMAC_H
+#define PLIBSYS_HEADER_PCRYPTOHMAC_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <pcryptohash.h>
+
+P_BEGIN_DECLS
+
+/** HMAC context opaque data structure. */
+typedef struct PCryptoHmac_ PCryptoHmac;
+
+/**
+ * @brief Initializes a new #PCryptoHmac context for a key.
+ * @param type Hash function type to use.
+ * @param key Secret key, may be NULL only if @a key_len is 0.
+ * @param key_len Key length, in bytes. A key longer than the hash block size
+ * is hashed first, as required by HMAC.
+ * @return Newly initialized #PCryptoHmac context in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PCryptoHmac *		zcrypto_hmac_new		(PCryptoHashType	type,
+								 const puchar		*key,
+								 psize			key_len);
+
+/**
+ * @brief Adds a new chunk of a message.
+ * @param hmac #PCryptoHmac context to add @a data to.
+ * @param data Data to add.
+ * @param len Data length, in bytes.
+ * @note After calling zcrypto_hmac_get_digest() the context couldn't be
+ * updated anymore until zcrypto_hmac_reset() is called.
+ * @since 0.0.5
+ */
+P_LIB_API void			zcrypto_hmac_update		(PCryptoHmac		*hmac,
+								 const puchar		*data,
+								 psize			len);
+
+/**
+ * @brief Starts a new message with the same key.
+ * @param hmac #PCryptoHmac context to reset.
+ * @since 0.0.5
+ *
+ * The cached key states are restored, the key is not hashed again.
+ */
+P_LIB_API void			zcrypto_hmac_reset		(PCryptoHmac		*hmac);
+
+/**
+ * @brief Gets the authentication code of the message.
+ * @param hmac #PCryptoHmac context to get the code from.
+ * @param buf Buffer to store the raw code in.
+ * @param[in,out] len Size of @a buf when calling, count of written bytes
+ * after.
+ * @note Before getting the code the context will be closed for further
+ * updates.
+ * @since 0.0.5
+ */
+P_LIB_API void			zcrypto_hmac_get_digest	(PCryptoHmac		*hmac,
+								 puchar			*buf,
+								 psize			*len);
+
+/**
+ * @brief Gets the authentication code length.
+ * @param hmac #PCryptoHmac context to get the length for.
+ * @return Code length in bytes (the digest length of the hash function) in
+ * case of success, 0 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pssize		zcrypto_hmac_get_length	(const PCryptoHmac	*hmac);
+
+/**
+ * @brief Gets the hash function type of a #PCryptoHmac context.
+ * @param hmac #PCryptoHmac context to get the type for.
+ * @return Hash function type used in the context, -1 in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API PCryptoHashType	zcrypto_hmac_get_type		(const PCryptoHmac	*hmac);
+
+/**
+ * @brief Authenticates a single buffer with the key of a context.
+ * @param hmac #PCryptoHmac context holding the key.
+ * @param data Message, may be NULL only if @a len is 0.
+ * @param len Message length, in bytes.
+ * @param[out] digest Buffer to store the raw code in, must hold at least
+ * zcrypto_hmac_get_length() bytes.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The context is not modified, the message being accumulated with
+ * zcrypto_hmac_update() is not affected. No memory is allocated.
+ */
+P_LIB_API pboolean		zcrypto_hmac_compute		(const PCryptoHmac	*hmac,
+								 const puchar		*data,
+								 psize			len,
+								 puchar			*digest);
+
+/**
+ * @brief Frees a #PCryptoHmac context.
+ * @param hmac #PCryptoHmac context to free.
+ * @since 0.0.5
+ *
+ * The key states are wiped before the memory is released.
+ */
+P_LIB_API void			zcrypto_hmac_free		(PCryptoHmac		*hmac);
+
+/**
+ * @brief Extracts a pseudorandom key from an input key material (HKDF-Extract).
+ * @param type Hash function type to use.
+ * @param salt Optional salt, NULL to use a string of zeros of the digest
+ * length.
+ * @param salt_len Salt length, in bytes.
+ * @param ikm Input key material, may be NULL only if @a ikm_len is 0.
+ * @param ikm_len Input key material length, in bytes.
+ * @param[out] prk Buffer to store the pseudorandom key in, must hold at least
+ * the digest length of @a type.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zcrypto_hkdf_extract		(PCryptoHashType	type,
+								 const puchar		*salt,
+								 psize			salt_len,
+								 const puchar		*ikm,
+								 psize			ikm_len,
+								 puchar			*prk);
+
+/**
+ * @brief Expands a pseudorandom key into an output key (HKDF-Expand).
+ * @param type Hash function type to use.
+ * @param prk Pseudorandom key, usually the result of zcrypto_hkdf_extract().
+ * @param prk_len Pseudorandom key length, at least the digest length of
+ * @a type.
+ * @param info Optional context information, may be NULL only if @a info_len
+ * is 0.
+ * @param info_len Context information length, in bytes.
+ * @param[out] okm Buffer to store the output key in.
+ * @param okm_len Output key length, at most 255 digest lengths of @a type.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The key states of @a prk are computed once for all the output blocks.
+ */
+P_LIB_API pboolean		zcrypto_hkdf_expand		(PCryptoHashType	type,
+								 const puchar		*prk,
+								 psize			prk_len,
+								 const puchar		*info,
+								 psize			info_len,
+								 puchar			*okm,
+								 psize			okm_len);
+
+/**
+ * @brief Derives a key from an input key material (HKDF).
+ * @param type Hash function type to use.
+ * @param salt Optional salt, NULL to use a string of zeros of the digest
+ * length.
+ * @param salt_len Salt length, in bytes.
+ * @param ikm Input key material, may be NULL only if @a ikm_len is 0.
+ * @param ikm_len Input key material length, in bytes.
+ * @param info Optional context information, may be NULL only if @a info_len
+ * is 0.
+ * @param info_len Context information length, in bytes.
+ * @param[out] okm Buffer to store the output key in.
+ * @param okm_len Output key length, at most 255 digest lengths of @a type.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Same as zcrypto_hkdf_extract() followed by zcrypto_hkdf_expand().
+ */
+P_LIB_API pboolean		zcrypto_hkdf			(PCryptoHashType	type,
+								 const puchar		*salt,
+								 psize			salt_len,
+								 const puchar		*ikm,
+								 psize			ikm_len,
+								 const puchar		*info,
+								 psize			info_len,
+								 puchar			*okm,
+								 psize			okm_len);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCRYPTOHMAC_H */
@@ -0,0 +1,190 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pcuckoofilter.h
+ * @brief Cuckoo filter
+ * @author Alexander Saprykin
+ *
+ * A cuckoo filter is a probabilistic data structure used to test whether an
+ * element is a member of a set, like a Bloom filter (see #PBloomFilter). In
+ * contrast to the Bloom filter it supports removal of the previously inserted
+ * elements.
+ *
+ * #PCuckooFilter keeps 16-bit fingerprints of the elements in a table of
+ * buckets with 4 slots each. Every element has two candidate buckets, so a
+ * lookup reads at most two cache lines. The false positive probability is
+ * about 0.01%, and the table can be filled up to about 95% of its slots. When
+ * both candidate buckets of a new element are full, the existing fingerprints
+ * are relocated to their alternate buckets. If no free slot is found after a
+ * limited number of relocations, the insertion fails and the filter is
+ * considered to be full.
+ *
+ * Use zcuckoo_filter_new() to create a filter with a given capacity, then
+ * zcuckoo_filter_insert(), zcuckoo_filter_contains() and
+ * zcuckoo_filter_remove() to work with it. Only remove the elements which were
+ * actually inserted, otherwise another element with the same fingerprint may
+ * be removed instead.
+ *
+ * The filter can be serialized into a flat position-independent image with
+ * zcuckoo_filter_save_image() and opened in place with
+ * zcuckoo_filter_new_from_image(), i.e. within a #PShm segment to share it
+ * between several processes. Lookups may run concurrently with each other, but
+ * modifications of a shared filter must be serialized with the other
+ * operations (i.e. using zshm_lock()).
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCUCKOOFILTER_H
+#define PLIBSYS_HEADER_PCUCKOOFILTER_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+
+P_BEGIN_DECLS
+
+/** Cuckoo filter opaque data structure. */
+typedef struct PCuckooFilter_ PCuckooFilter;
+
+/**
+ * @brief Creates a new #PCuckooFilter.
+ * @param capacity Maximum number of elements to store, must be greater than 0.
+ * @return Newly created empty #PCuckooFilter in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PCuckooFilter *	zcuckoo_filter_new		(psize			capacity);
+
+/**
+ * @brief Opens a #PCuckooFilter in a memory image.
+ * @param image Memory with the filter image previously stored with
+ * zcuckoo_filter_save_image().
+ * @param size Size of the @a image memory, in bytes.
+ * @return #PCuckooFilter working directly with the @a image memory in case of
+ * success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The image is not copied, so it must stay valid until the filter is freed.
+ * All the modifications are performed in place. Freeing the filter doesn't free
+ * the @a image.
+ */
+P_LIB_API PCuckooFilter *	zcuckoo_filter_new_from_image	(ppointer		image,
+								 psize			size);
+
+/**
+ * @brief Inserts an element into a #PCuckooFilter.
+ * @param filter #PCuckooFilter to insert the element into.
+ * @param data Element data.
+ * @param len Length of the @a data, in bytes.
+ * @return TRUE in case of success, FALSE if the filter is full.
+ * @since 0.0.5
+ *
+ * The same element can be inserted several times (up to 8), it should be
+ * removed the same number of times then.
+ *
+ * The insertion which fills the table still succeeds: the fingerprint evicted
+ * last is kept aside, so no element is lost. Only the next insertion fails,
+ * until some element is removed.
+ */
+P_LIB_API pboolean		zcuckoo_filter_insert		(PCuckooFilter		*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Checks whether a #PCuckooFilter may contain an element.
+ * @param filter #PCuckooFilter to check.
+ * @param data Element data.
+ * @param len Length of the @a data, in bytes.
+ * @return FALSE if the element is definitely absent, TRUE if it is probably
+ * present.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zcuckoo_filter_contains		(const PCuckooFilter	*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Removes an element from a #PCuckooFilter.
+ * @param filter #PCuckooFilter to remove the element from.
+ * @param data Element data.
+ * @param len Length of the @a data, in bytes.
+ * @return TRUE if the element was found and removed, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zcuckoo_filter_remove		(PCuckooFilter		*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Gets the number of elements in a #PCuckooFilter.
+ * @param filter #PCuckooFilter to get the number of elements for.
+ * @return Number of the stored elements.
+ * @since 0.0.5
+ */
+P_LIB_API psize			zcuckoo_filter_get_count	(const PCuckooFilter	*filter);
+
+/**
+ * @brief Removes all the elements from a #PCuckooFilter.
+ * @param filter #PCuckooFilter to clear.
+ * @since 0.0.5
+ */
+P_LIB_API void			zcuckoo_filter_clear		(PCuckooFilter		*filter);
+
+/**
+ * @brief Gets the size of a #PCuckooFilter image.
+ * @param filter #PCuckooFilter to get the image size for.
+ * @return Size of the memory image, in bytes, in case of success, 0
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API psize			zcuckoo_filter_get_image_size	(const PCuckooFilter	*filter);
+
+/**
+ * @brief Stores a #PCuckooFilter into a memory image.
+ * @param filter #PCuckooFilter to store.
+ * @param[out] buf Buffer to store the image into, must be aligned at least to
+ * 8 bytes.
+ * @param size Size of the @a buf, in bytes, should be at least the value
+ * returned by zcuckoo_filter_get_image_size().
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zcuckoo_filter_save_image	(const PCuckooFilter	*filter,
+								 ppointer		buf,
+								 psize			size);
+
+/**
+ * @brief Frees a #PCuckooFilter.
+ * @param filter #PCuckooFilter to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			zcuckoo_filter_free		(PCuckooFilter		*filter);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCUCKOOFILTER_H */
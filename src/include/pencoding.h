@@ -0,0 +1,155 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pencoding.h
+ * @brief Hex and base64 encoding
+ * @author Alexander Saprykin
+ *
+ * Binary data often needs to be represented as text: digests are printed in
+ * the hexadecimal form, keys and blobs are stored in configuration files and
+ * network messages in the base64 form.
+ *
+ * zencoding_hex_encode() and zencoding_hex_decode() convert between binary
+ * data and lowercase hexadecimal text (decoding accepts both cases).
+ * zencoding_base64_encode() and zencoding_base64_decode() use the standard
+ * base64 alphabet from RFC 4648 with '=' padding.
+ *
+ * All the routines write into caller-provided buffers and never allocate
+ * memory. Use #P_ENCODING_HEX_ENCODED_LEN, #P_ENCODING_BASE64_ENCODED_LEN and
+ * #P_ENCODING_BASE64_DECODED_LEN to find out the required buffer sizes.
+ *
+ * Large inputs are processed with SSSE3 or AVX2 instructions when they are
+ * available at runtime (16 or 32 input bytes per iteration), otherwise a
+ * table-driven scalar code is used. The result is the same in both cases.
+ *
+ * All the routines are thread-safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PENCODING_H
+#define PLIBSYS_HEADER_PENCODING_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+
+P_BEGIN_DECLS
+
+/** Length of the hexadecimal text for @a len bytes, without the trailing
+ * zero. */
+#define P_ENCODING_HEX_ENCODED_LEN(len)		((len) * 2)
+
+/** Length of the base64 text for @a len bytes, with padding and without the
+ * trailing zero. */
+#define P_ENCODING_BASE64_ENCODED_LEN(len)	((((len) + 2) / 3) * 4)
+
+/** Maximum number of bytes decoded from @a len base64 characters. */
+#define P_ENCODING_BASE64_DECODED_LEN(len)	(((len) + 3) / 4 * 3)
+
+/**
+ * @brief Encodes binary data to the hexadecimal text.
+ * @param data Data to encode.
+ * @param len Length of @a data, in bytes.
+ * @param[out] buf Buffer to put the text into.
+ * @param size Size of @a buf, in bytes.
+ * @return Length of the text without the trailing zero in case of success, 0
+ * otherwise.
+ * @since 0.0.5
+ *
+ * Two lowercase hexadecimal digits are written for every byte, followed by the
+ * trailing zero, so @a size should be at least
+ * #P_ENCODING_HEX_ENCODED_LEN (@a len) + 1. Nothing is written if @a buf is
+ * too small.
+ */
+P_LIB_API psize		zencoding_hex_encode		(const puchar	*data,
+							 psize		len,
+							 pchar		*buf,
+							 psize		size);
+
+/**
+ * @brief Decodes hexadecimal text to binary data.
+ * @param str Text to decode, may not be zero terminated.
+ * @param len Length of @a str, in characters.
+ * @param[out] buf Buffer to put the data into.
+ * @param size Size of @a buf, in bytes.
+ * @return Number of decoded bytes in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * Both lowercase and uppercase digits are accepted. The input must have an
+ * even length and contain only hexadecimal digits, no whitespaces or prefixes
+ * are allowed. @a size should be at least @a len / 2. The contents of @a buf
+ * are undefined in case of an error.
+ */
+P_LIB_API pssize	zencoding_hex_decode		(const pchar	*str,
+							 psize		len,
+							 puchar		*buf,
+							 psize		size);
+
+/**
+ * @brief Encodes binary data to the base64 text.
+ * @param data Data to encode.
+ * @param len Length of @a data, in bytes.
+ * @param[out] buf Buffer to put the text into.
+ * @param size Size of @a buf, in bytes.
+ * @return Length of the text without the trailing zero in case of success, 0
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The standard alphabet is used, the text is padded with '=' characters and is
+ * followed by the trailing zero, so @a size should be at least
+ * #P_ENCODING_BASE64_ENCODED_LEN (@a len) + 1. Nothing is written if @a buf is
+ * too small.
+ */
+P_LIB_API psize		zencoding_base64_encode	(const puchar	*data,
+							 psize		len,
+							 pchar		*buf,
+							 psize		size);
+
+/**
+ * @brief Decodes base64 text to binary data.
+ * @param str Text to decode, may not be zero terminated.
+ * @param len Length of @a str, in characters.
+ * @param[out] buf Buffer to put the data into.
+ * @param size Size of @a buf, in bytes.
+ * @return Number of decoded bytes in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * The standard alphabet is expected. Padding at the end is optional, but if it
+ * is present it must be correct. Whitespaces and other characters outside of
+ * the alphabet are rejected. @a size should be at least
+ * #P_ENCODING_BASE64_DECODED_LEN (@a len). The contents of @a buf are
+ * undefined in case of an error.
+ */
+P_LIB_API pssize	zencoding_base64_decode	(const pchar	*str,
+							 psize		len,
+							 puchar		*buf,
+							 psize		size);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PENCODING_H */
@@ -0,0 +1,123 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Epoch-based reclamation of memory in lock-free data structures */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PEPOCH_PRIVATE_H
+#define PLIBSYS_HEADER_PEPOCH_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Per-thread participation record, opaque. */
+typedef struct PEpochRecord_ PEpochRecord;
+
+/** Link of a retired object, embedded into the object. */
+typedef struct PEpochEntry_ {
+	struct PEpochEntry_	*next;	/**< Next entry in the limbo list.	*/
+	puint			epoch;	/**< Global epoch at the retirement.	*/
+} PEpochEntry;
+
+/** Function to free a retired object by its embedded entry. */
+typedef void (*PEpochFreeFunc) (PEpochEntry *entry, ppointer user_data);
+
+/** Retired objects of a single data structure waiting to be freed. */
+typedef struct PEpochLimbo_ {
+	ppointer	head;		/**< Lock-free stack of #PEpochEntry.	*/
+	volatile pint	count;		/**< Number of entries in the stack.	*/
+	pint		threshold;	/**< Number of entries to reclaim at.	*/
+	PEpochFreeFunc	free_func;	/**< Function to free an entry.		*/
+	ppointer	user_data;	/**< Data to pass to @a free_func.	*/
+} PEpochLimbo;
+
+/**
+ * @brief Initializes an empty limbo list.
+ * @param limbo Limbo list to initialize.
+ * @param threshold Number of the retired objects to start reclamation at.
+ * @param free_func Function to free the retired objects.
+ * @param user_data Data to pass to @a free_func.
+ *
+ * Small objects which are retired often should use a larger threshold to
+ * amortize the reclamation, large ones should be freed as soon as possible.
+ */
+void		zepoch_limbo_init	(PEpochLimbo		*limbo,
+					 pint			threshold,
+					 PEpochFreeFunc		free_func,
+					 ppointer		user_data);
+
+/**
+ * @brief Frees all the objects of a limbo list at once.
+ * @param limbo Limbo list to flush.
+ *
+ * No other thread may use the data structure at this time.
+ */
+void		zepoch_limbo_flush	(PEpochLimbo		*limbo);
+
+/**
+ * @brief Enters a critical section of the calling thread.
+ * @return Record to pass to zepoch_leave().
+ *
+ * Objects reachable inside the critical section are not freed until the
+ * thread leaves it. Critical sections may be nested.
+ */
+PEpochRecord *	zepoch_enter		(void);
+
+/**
+ * @brief Leaves a critical section.
+ * @param record Record returned by zepoch_enter().
+ */
+void		zepoch_leave		(PEpochRecord		*record);
+
+/**
+ * @brief Retires an object which is not reachable anymore.
+ * @param limbo Limbo list of the data structure the object belongs to.
+ * @param entry Entry embedded into the object.
+ *
+ * Must be called inside a critical section. The object is freed after all the
+ * threads which could have seen it have left their critical sections.
+ */
+void		zepoch_retire		(PEpochLimbo		*limbo,
+					 PEpochEntry		*entry);
+
+/**
+ * @brief Frees the retired objects which are safe to free.
+ * @param limbo Limbo list to reclaim.
+ *
+ * Does nothing until the limbo list grows up to its threshold, so it is
+ * cheap to call after every retirement. Should be called outside of a
+ * critical section, otherwise the objects retired by the calling thread in
+ * the current epoch can't be freed.
+ */
+void		zepoch_reclaim		(PEpochLimbo		*limbo);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PEPOCH_PRIVATE_H */
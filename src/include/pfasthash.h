@@ -0,0 +1,160 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pfasthash.h
+ * @brief Fast non-cryptographic hash functions
+ * @author Alexander Saprykin
+ *
+ * A non-cryptographic hash function maps data of any length to a fixed size
+ * value with a good distribution and a very low cost per byte. It is suitable
+ * for hash tables, sharding, checksums and deduplication, but it is not
+ * designed to resist an attacker: use #PCryptoHash when collisions could be
+ * crafted on purpose.
+ *
+ * The module implements the XXH3 algorithm of the xxHash family with 64-bit
+ * and 128-bit results. The results are the same on every platform and match
+ * the XXH3_64bits_withSeed() and XXH3_128bits_withSeed() functions of the
+ * reference implementation. Inputs longer than 240 bytes are processed with
+ * SSE2 or AVX2 instructions when they are available at runtime.
+ *
+ * Use zfast_hash64() or zfast_hash128() to hash data which is available at
+ * once. For data coming in several chunks create a streaming state with
+ * zfast_hash_new(), add the chunks with zfast_hash_update() and get the result
+ * with zfast_hash_digest64() or zfast_hash_digest128(). The result of the
+ * streaming hashing is the same as of the one-shot call for the concatenated
+ * data.
+ *
+ * All the functions accept a seed: different seeds produce independent hash
+ * values for the same data.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PFASTHASH_H
+#define PLIBSYS_HEADER_PFASTHASH_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+
+P_BEGIN_DECLS
+
+/** Streaming hash state opaque data structure. */
+typedef struct PFastHash_ PFastHash;
+
+/** 128-bit hash value. */
+typedef struct PFastHash128_ {
+	puint64	low;	/**< Lower 64 bits.	*/
+	puint64	high;	/**< Higher 64 bits.	*/
+} PFastHash128;
+
+/**
+ * @brief Calculates a 64-bit hash value.
+ * @param data Data to hash, may be NULL if @a len is 0.
+ * @param len Data length, in bytes.
+ * @param seed Hash seed.
+ * @return 64-bit hash value.
+ * @since 0.0.5
+ */
+P_LIB_API puint64	zfast_hash64		(pconstpointer		data,
+						 psize			len,
+						 puint64		seed);
+
+/**
+ * @brief Calculates a 128-bit hash value.
+ * @param data Data to hash, may be NULL if @a len is 0.
+ * @param len Data length, in bytes.
+ * @param seed Hash seed.
+ * @param[out] result Hash value.
+ * @since 0.0.5
+ *
+ * The lower 64 bits are not the same as the result of zfast_hash64().
+ */
+P_LIB_API void		zfast_hash128		(pconstpointer		data,
+						 psize			len,
+						 puint64		seed,
+						 PFastHash128		*result);
+
+/**
+ * @brief Creates a new streaming hash state.
+ * @param seed Hash seed.
+ * @return Newly created #PFastHash in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PFastHash *	zfast_hash_new		(puint64		seed);
+
+/**
+ * @brief Adds a chunk of data to the streaming hash state.
+ * @param hash #PFastHash state.
+ * @param data Data to add, may be NULL if @a len is 0.
+ * @param len Data length, in bytes.
+ * @since 0.0.5
+ */
+P_LIB_API void		zfast_hash_update	(PFastHash		*hash,
+						 pconstpointer		data,
+						 psize			len);
+
+/**
+ * @brief Gets the 64-bit hash value of all the data added so far.
+ * @param hash #PFastHash state.
+ * @return 64-bit hash value, the same as zfast_hash64() returns for the whole
+ * data.
+ * @since 0.0.5
+ * @note The state is not changed, more data can be added after that.
+ */
+P_LIB_API puint64	zfast_hash_digest64	(const PFastHash	*hash);
+
+/**
+ * @brief Gets the 128-bit hash value of all the data added so far.
+ * @param hash #PFastHash state.
+ * @param[out] result Hash value, the same as zfast_hash128() returns for the
+ * whole data.
+ * @since 0.0.5
+ * @note The state is not changed, more data can be added after that.
+ */
+P_LIB_API void		zfast_hash_digest128	(const PFastHash	*hash,
+						 PFastHash128		*result);
+
+/**
+ * @brief Resets the streaming hash state to start hashing new data.
+ * @param hash #PFastHash state.
+ * @param seed New hash seed.
+ * @since 0.0.5
+ */
+P_LIB_API void		zfast_hash_reset	(PFastHash		*hash,
+						 puint64		seed);
+
+/**
+ * @brief Frees a streaming hash state.
+ * @param hash #PFastHash state to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		zfast_hash_free		(PFastHash		*hash);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PFASTHASH_H */
@@ -0,0 +1,263 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pflatmap.h
+ * @brief Flat sorted map
+ * @author Alexander Saprykin
+ *
+ * #PFlatMap is an ordered key-value map stored as a single sorted array of the
+ * key-value pairs. It has no per-node memory overhead and keeps the pairs next
+ * to each other in memory, so for small and medium maps which are searched
+ * much more often than modified it is considerably faster than #PTree.
+ *
+ * Use zflat_map_new(), or its detailed variations like zflat_map_new_with_data()
+ * and zflat_map_new_full() to create a map. Take attention that a caller owns
+ * the key and the value data passed when inserting new pairs, so you should
+ * manually free the memory after the map usage. Or you can provide destroy
+ * notification functions for the keys and the values separately.
+ *
+ * New key-value pairs are inserted with zflat_map_insert(). Insertion is
+ * batched: new pairs are appended to the end of the array, and the whole batch
+ * is sorted and merged into the map on the next search. Thus building a map
+ * with N pairs takes O(NlogN) time instead of O(N^2) for the one-by-one
+ * insertion into a sorted array. You can also merge the pending pairs
+ * explicitly with zflat_map_commit(). If the same key is inserted several
+ * times, the last inserted value wins.
+ *
+ * Use zflat_map_lookup() to find the value by a given key and
+ * zflat_map_remove() to remove a pair. zflat_map_foreach() and
+ * zflat_map_foreach_range() traverse the pairs in order.
+ *
+ * #PFlatMap is not thread-safe. Several threads can search in the same map
+ * concurrently only if there are no pending pairs (i.e. after
+ * zflat_map_commit() call) and the map is not modified.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PFLATMAP_H
+#define PLIBSYS_HEADER_PFLATMAP_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+
+P_BEGIN_DECLS
+
+/** Flat map opaque data structure. */
+typedef struct PFlatMap_ PFlatMap;
+
+/**
+ * @brief Initializes new #PFlatMap.
+ * @param func Key compare function.
+ * @return Newly initialized #PFlatMap object in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The caller takes ownership of all the keys and the values passed to the map.
+ */
+P_LIB_API PFlatMap *	zflat_map_new			(PCompareFunc		func);
+
+/**
+ * @brief Initializes new #PFlatMap with additional data.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @return Newly initialized #PFlatMap object in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The caller takes ownership of all the keys and the values passed to the map.
+ */
+P_LIB_API PFlatMap *	zflat_map_new_with_data		(PCompareDataFunc	func,
+							 ppointer		data);
+
+/**
+ * @brief Initializes new #PFlatMap with additional data and memory management.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @param key_destroy Function to call on every key before the pair
+ * destruction, maybe NULL.
+ * @param value_destroy Function to call on every value before the pair
+ * destruction, maybe NULL.
+ * @return Newly initialized #PFlatMap object in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * Upon every pair destruction the corresponding key and value functions would
+ * be called.
+ */
+P_LIB_API PFlatMap *	zflat_map_new_full		(PCompareDataFunc	func,
+							 ppointer		data,
+							 PDestroyFunc		key_destroy,
+							 PDestroyFunc		value_destroy);
+
+/**
+ * @brief Reserves memory for the key-value pairs.
+ * @param map #PFlatMap to reserve memory for.
+ * @param npairs Total number of the pairs to reserve memory for.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Use this call before inserting a lot of pairs with known count to avoid
+ * memory reallocations.
+ */
+P_LIB_API pboolean	zflat_map_reserve		(PFlatMap		*map,
+							 psize			npairs);
+
+/**
+ * @brief Inserts a new key-value pair into a map.
+ * @param map #PFlatMap to insert a pair in.
+ * @param key Key to insert.
+ * @param value Value corresponding to the given @a key.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The pair is appended to the pending ones and merged into the map on the
+ * next search or zflat_map_commit() call. If the @a key already exists in the
+ * map then it will be replaced with the new one at this moment. If a key
+ * destroy function was provided it would be called on the old key. If a value
+ * destroy function was provided it would be called on the old value.
+ */
+P_LIB_API pboolean	zflat_map_insert		(PFlatMap		*map,
+							 ppointer		key,
+							 ppointer		value);
+
+/**
+ * @brief Merges all the pending pairs into a map.
+ * @param map #PFlatMap to merge pending pairs for.
+ * @since 0.0.5
+ *
+ * Pending pairs are sorted and merged into the map in O(N + MlogM) time, where
+ * N is the map size and M is the number of the pending pairs. All the search
+ * calls do this implicitly.
+ */
+P_LIB_API void		zflat_map_commit		(PFlatMap		*map);
+
+/**
+ * @brief Removes a key from a map.
+ * @param map #PFlatMap to remove a key from.
+ * @param key Key to remove.
+ * @return TRUE if the key was removed, FALSE if the key was not found.
+ * @since 0.0.5
+ *
+ * If a key destroy function was provided it would be called on the key. If a
+ * value destroy function was provided it would be called on the value.
+ */
+P_LIB_API pboolean	zflat_map_remove		(PFlatMap		*map,
+							 pconstpointer		key);
+
+/**
+ * @brief Lookups a value by a given key.
+ * @param map #PFlatMap to lookup in.
+ * @param key Key to lookup.
+ * @return Value for the given @a key in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	zflat_map_lookup		(PFlatMap		*map,
+							 pconstpointer		key);
+
+/**
+ * @brief Checks whether a map contains a given key.
+ * @param map #PFlatMap to lookup in.
+ * @param key Key to lookup.
+ * @return TRUE if the @a key was found, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Use this call to distinguish missing keys from the keys with NULL values.
+ */
+P_LIB_API pboolean	zflat_map_contains		(PFlatMap		*map,
+							 pconstpointer		key);
+
+/**
+ * @brief Iterates in-order through the map pairs.
+ * @param map #PFlatMap to traverse.
+ * @param traverse_func Function for traversing, return TRUE from it to stop
+ * the iteration.
+ * @param user_data Additional (maybe NULL) user-provided data for the
+ * @a traverse_func.
+ * @since 0.0.5
+ *
+ * The map should not be modified while traversing.
+ */
+P_LIB_API void		zflat_map_foreach		(PFlatMap		*map,
+							 PTraverseFunc		traverse_func,
+							 ppointer		user_data);
+
+/**
+ * @brief Iterates in-order through the map pairs within a key range.
+ * @param map #PFlatMap to traverse.
+ * @param from Lower (inclusive) bound of the keys.
+ * @param to Upper (exclusive) bound of the keys.
+ * @param traverse_func Function for traversing, return TRUE from it to stop
+ * the iteration.
+ * @param user_data Additional (maybe NULL) user-provided data for the
+ * @a traverse_func.
+ * @since 0.0.5
+ *
+ * The map should not be modified while traversing.
+ */
+P_LIB_API void		zflat_map_foreach_range		(PFlatMap		*map,
+							 pconstpointer		from,
+							 pconstpointer		to,
+							 PTraverseFunc		traverse_func,
+							 ppointer		user_data);
+
+/**
+ * @brief Gets pair count.
+ * @param map #PFlatMap to get pair count for.
+ * @return Pair count.
+ * @since 0.0.5
+ *
+ * Pending pairs are merged into the map before counting, so the returned
+ * count doesn't include duplicated keys.
+ */
+P_LIB_API pint		zflat_map_get_nnodes		(PFlatMap		*map);
+
+/**
+ * @brief Clears a map.
+ * @param map #PFlatMap to clear.
+ * @since 0.0.5
+ *
+ * All the keys will be deleted. Key and value destroy functions would be
+ * called on every pair if any of them was provided. Allocated memory is kept
+ * for the reuse.
+ */
+P_LIB_API void		zflat_map_clear			(PFlatMap		*map);
+
+/**
+ * @brief Frees a previously initialized map object.
+ * @param map #PFlatMap object to free.
+ * @since 0.0.5
+ *
+ * All the keys will be deleted. Key and value destroy functions would be
+ * called on every pair if any of them was provided.
+ */
+P_LIB_API void		zflat_map_free			(PFlatMap		*map);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PFLATMAP_H */
@@ -65,6 +65,22 @@
  * To parse a file, create #PIniFile with zini_file_new() and then parse it
  * with the zini_file_parse() routine.
  *
+ * By default the file is read line by line and every line is limited to 1024
+ * bytes, the rest of a longer line is treated as the next one. Use
+ * zini_file_parse_with_flags() with the #P_INI_FILE_PARSE_FLAG_MAPPED flag to
+ * memory map the file and scan it in a single pass instead: there is no line
+ * length limit in that mode and the names and values of every section are
+ * copied into a single memory block, which is usually much faster for large
+ * files.
+ *
+ * A parsed file can be reloaded with zini_file_reload() to pick up changes.
+ * The reload does nothing if the file is not changed, and parses again only
+ * the changed sections otherwise. The new contents replace the old ones at
+ * once, so the getters called from other threads during the reload never
+ * block and see either the old or the new contents of the file. Only
+ * zini_file_free() must not be called while the file is in use by other
+ * threads.
+ *
  * #PIniFile handles (skips) UTF-8/16/32 BOM characters (marks).
  *
  * Example of the INI file contents:
@@ -108,6 +124,12 @@ P_BEGIN_DECLS
 /** INI file opaque data structure. */
 typedef struct PIniFile_ PIniFile;
 
+/** INI file parsing flags. */
+typedef enum PIniFileParseFlags_ {
+	P_INI_FILE_PARSE_FLAG_NONE	= 0,		/**< Read line by line, lines are limited to 1024 bytes.	*/
+	P_INI_FILE_PARSE_FLAG_MAPPED	= 1 << 0	/**< Map the whole file and scan it without line limits.	*/
+} PIniFileParseFlags;
+
 /**
  * @brief Creates a new #PIniFile for parsing.
  * @param path Path to a file to parse.
@@ -133,6 +155,51 @@ P_LIB_API void		zini_file_free			(PIniFile	*file);
 P_LIB_API pboolean	zini_file_parse		(PIniFile	*file,
 							 PError		**error);
 
+/**
+ * @brief Parses given #PIniFile using the specified parsing mode.
+ * @param file #PIniFile file to parse.
+ * @param flags Parsing flags, see #PIniFileParseFlags.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * With #P_INI_FILE_PARSE_FLAG_MAPPED the file is memory mapped (or read
+ * entirely on systems without memory mapping support), split into lines with
+ * memchr() and parsed in a single pass. The mapping is released before the
+ * call returns. A BOM is skipped only at the beginning of the file.
+ *
+ * The parsing mode is remembered for the following zini_file_reload() calls.
+ *
+ * zini_file_parse() is the same as calling this routine with
+ * #P_INI_FILE_PARSE_FLAG_NONE.
+ */
+P_LIB_API pboolean	zini_file_parse_with_flags	(PIniFile		*file,
+							 PIniFileParseFlags	flags,
+							 PError			**error);
+
+/**
+ * @brief Reloads given #PIniFile if it was changed since the last parsing.
+ * @param file #PIniFile file to reload.
+ * @param[out] is_changed Whether the contents were changed, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The file is considered unchanged if its modification time and size are the
+ * same as during the last parsing, or if its contents have the same hash.
+ * Otherwise only the sections with changed text are parsed again, all the
+ * other sections are shared with the previous contents.
+ *
+ * The new contents are published atomically: concurrent getters are never
+ * blocked and see either the old or the new contents. The old contents are
+ * freed when no thread uses them. Concurrent reloads are serialized. In case
+ * of an error the old contents are kept.
+ *
+ * If the file was not parsed before, it is parsed as with zini_file_parse().
+ */
+P_LIB_API pboolean	zini_file_reload		(PIniFile	*file,
+							 pboolean	*is_changed,
+							 PError		**error);
+
 /**
  * @brief Checks whether #PIniFile was already parsed or not.
  * @param file #PIniFile to check.
@@ -194,6 +261,25 @@ P_LIB_API pchar *	zini_file_parameter_string	(const PIniFile	*file,
 							 const pchar	*key,
 							 const pchar	*default_val);
 
+/**
+ * @brief Gets specified parameter's value as a string without copying it.
+ * @param file #PIniFile to get the value from. The @a file should be parsed
+ * before.
+ * @param section Section to get the value from.
+ * @param key Key to get the value from.
+ * @param default_val Default value to return if no specified key exists.
+ * @return Key's value in case of success, @a default_value otherwise.
+ * @since 0.0.5
+ * @note The returned string belongs to @a file and must not be modified or
+ * freed. It stays valid until the file is freed or its changed contents are
+ * loaded with zini_file_reload(), so use zini_file_parameter_string() to get
+ * a copy if the file can be reloaded concurrently.
+ */
+P_LIB_API const pchar *	zini_file_parameter_string_view	(const PIniFile	*file,
+								 const pchar	*section,
+								 const pchar	*key,
+								 const pchar	*default_val);
+
 /**
  * @brief Gets specified parameter's value as an integer.
  * @param file #PIniFile to get the value from. The @a file should be parsed
@@ -203,6 +289,8 @@ P_LIB_API pchar *	zini_file_parameter_string	(const PIniFile	*file,
  * @param default_val Default value to return if no specified key exists.
  * @return Key's value in case of success, @a default_value otherwise.
  * @since 0.0.1
+ * @note The converted value is cached after the first call, so the following
+ * calls for the same key don't parse it again and never allocate memory.
  */
 P_LIB_API pint		zini_file_parameter_int	(const PIniFile	*file,
 							 const pchar	*section,
@@ -218,6 +306,7 @@ P_LIB_API pint		zini_file_parameter_int	(const PIniFile	*file,
  * @param default_val Default value to return if no specified key exists.
  * @return Key's value in case of success, @a default_value otherwise.
  * @since 0.0.1
+ * @note The converted value is cached after the first call.
  */
 P_LIB_API double	zini_file_parameter_double	(const PIniFile	*file,
 							 const pchar	*section,
@@ -232,6 +321,7 @@ P_LIB_API double	zini_file_parameter_double	(const PIniFile	*file,
  * @param default_val Default value to return if no specified key exists.
  * @return Key's value in case of success, @a default_value otherwise.
  * @since 0.0.1
+ * @note The converted value is cached after the first call.
  */
 
 P_LIB_API pboolean	zini_file_parameter_boolean	(const PIniFile	*file,
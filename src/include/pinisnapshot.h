@@ -0,0 +1,197 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pinisnapshot.h
+ * @brief Compiled INI file snapshot
+ * @author Alexander Saprykin
+ *
+ * Parsing a large INI file on every program start costs time and memory in
+ * every process which reads the same configuration. A parsed #PIniFile can be
+ * compiled once with zini_snapshot_write() into a binary snapshot file, which
+ * is then opened with zini_snapshot_open() without any parsing at all.
+ *
+ * The snapshot contains a string table with all the (deduplicated) names and
+ * values followed by the hash indexes for the sections and the keys of every
+ * section. All the references inside the snapshot are offsets from its
+ * beginning, so the snapshot is memory mapped read-only and queried in place:
+ * opening a snapshot costs only the validation of its header, the pages are
+ * read lazily on the first access, and all the processes using the same
+ * snapshot share its pages in the page cache. The strings returned by the
+ * getters point directly into the mapping and stay valid until the snapshot is
+ * closed.
+ *
+ * The lookup rules are the same as for #PIniFile: if there are several
+ * sections or keys with the same name, the one which is returned by the
+ * #PIniFile getters is stored in the snapshot. Parameter lists are not
+ * supported, but their string form is stored as is.
+ *
+ * The snapshot is written into a temporary file which then replaces the target
+ * one, so the processes which have the old snapshot opened keep using it
+ * unchanged. The snapshot format depends on the byte order of the platform,
+ * a snapshot with a different byte order or a different format version is
+ * rejected by zini_snapshot_open().
+ *
+ * #PIniSnapshot is read-only and can be used from several threads at once.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PINISNAPSHOT_H
+#define PLIBSYS_HEADER_PINISNAPSHOT_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <perror.h>
+#include <pinifile.h>
+
+P_BEGIN_DECLS
+
+/** INI file snapshot opaque data structure. */
+typedef struct PIniSnapshot_ PIniSnapshot;
+
+/**
+ * @brief Compiles a parsed #PIniFile into a snapshot file.
+ * @param file #PIniFile to compile, must be parsed.
+ * @param path Path to the snapshot file to write, an existing file is
+ * replaced.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @note @a file must not be reloaded with zini_file_reload() while the
+ * snapshot is written.
+ *
+ * The snapshot is written to a uniquely named temporary file in the same
+ * directory, synced to the disk and then renamed over @a path, so several
+ * threads or processes may write the same snapshot at once and readers never
+ * see a partially written file.
+ */
+P_LIB_API pboolean	zini_snapshot_write			(const PIniFile	*file,
+								 const pchar	*path,
+								 PError		**error);
+
+/**
+ * @brief Opens a snapshot file written with zini_snapshot_write().
+ * @param path Path to the snapshot file.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Newly opened #PIniSnapshot in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The snapshot header is validated, and all the offsets are checked on every
+ * access, so a damaged snapshot never leads to reading outside of it.
+ */
+P_LIB_API PIniSnapshot *	zini_snapshot_open			(const pchar	*path,
+								 PError		**error);
+
+/**
+ * @brief Closes a snapshot and unmaps it from memory.
+ * @param snapshot #PIniSnapshot to close.
+ * @since 0.0.5
+ */
+P_LIB_API void		zini_snapshot_close			(PIniSnapshot	*snapshot);
+
+/**
+ * @brief Gets the number of the (unique) sections in a snapshot.
+ * @param snapshot #PIniSnapshot to get the number of the sections for.
+ * @return Number of the sections.
+ * @since 0.0.5
+ */
+P_LIB_API psize		zini_snapshot_section_count		(const PIniSnapshot	*snapshot);
+
+/**
+ * @brief Checks whether a key exists in a snapshot.
+ * @param snapshot #PIniSnapshot to check in.
+ * @param section Section to check in.
+ * @param key Key to check.
+ * @return TRUE if @a key exists, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zini_snapshot_is_key_exists		(const PIniSnapshot	*snapshot,
+								 const pchar		*section,
+								 const pchar		*key);
+
+/**
+ * @brief Gets a parameter value as a string without copying it.
+ * @param snapshot #PIniSnapshot to get the value from.
+ * @param section Section to get the value from.
+ * @param key Key to get the value for.
+ * @param default_val Default value to return if no specified key exists.
+ * @return Parameter value (pointing into the snapshot) in case of success,
+ * @a default_val otherwise.
+ * @since 0.0.5
+ * @note The returned string is valid until @a snapshot is closed.
+ */
+P_LIB_API const pchar *	zini_snapshot_parameter_string		(const PIniSnapshot	*snapshot,
+								 const pchar		*section,
+								 const pchar		*key,
+								 const pchar		*default_val);
+
+/**
+ * @brief Gets a parameter value as an integer.
+ * @param snapshot #PIniSnapshot to get the value from.
+ * @param section Section to get the value from.
+ * @param key Key to get the value for.
+ * @param default_val Default value to return if no specified key exists.
+ * @return Parameter value in case of success, @a default_val otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pint		zini_snapshot_parameter_int		(const PIniSnapshot	*snapshot,
+								 const pchar		*section,
+								 const pchar		*key,
+								 pint			default_val);
+
+/**
+ * @brief Gets a parameter value as a floating point number.
+ * @param snapshot #PIniSnapshot to get the value from.
+ * @param section Section to get the value from.
+ * @param key Key to get the value for.
+ * @param default_val Default value to return if no specified key exists.
+ * @return Parameter value in case of success, @a default_val otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API double	zini_snapshot_parameter_double		(const PIniSnapshot	*snapshot,
+								 const pchar		*section,
+								 const pchar		*key,
+								 double			default_val);
+
+/**
+ * @brief Gets a parameter value as a boolean.
+ * @param snapshot #PIniSnapshot to get the value from.
+ * @param section Section to get the value from.
+ * @param key Key to get the value for.
+ * @param default_val Default value to return if no specified key exists.
+ * @return Parameter value in case of success, @a default_val otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zini_snapshot_parameter_boolean		(const PIniSnapshot	*snapshot,
+								 const pchar		*section,
+								 const pchar		*key,
+								 pboolean		default_val);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PINISNAPSHOT_H */
@@ -30,13 +30,21 @@
 
 #include "plibsysconfig.h"
 #include "patomic.h"
+#include "pbitset.h"
+#include "pbloomfilter.h"
 #include "pcondvariable.h"
 #include "pcryptohash.h"
+#include "pcryptohmac.h"
+#include "pcuckoofilter.h"
 #include "pdir.h"
+#include "pencoding.h"
 #include "perror.h"
+#include "pfasthash.h"
 #include "pfile.h"
+#include "pflatmap.h"
 #include "phashtable.h"
 #include "pinifile.h"
+#include "pinisnapshot.h"
 #include "plibraryloader.h"
 #include "plist.h"
 #include "pmacros.h"
@@ -47,15 +55,18 @@
 #include "pmem.h"
 #include "pmutex.h"
 #include "pprocess.h"
+#include "pradixtree.h"
 #include "prwlock.h"
 #include "psemaphore.h"
 #include "pshm.h"
 #include "pshmbuffer.h"
+#include "pskiplist.h"
 #include "psocket.h"
 #include "psocketaddress.h"
 #include "pspinlock.h"
 #include "pstdarg.h"
 #include "pstring.h"
+#include "pstringbuilder.h"
 #include "ptimeprofiler.h"
 #include "ptree.h"
 #include "ptypes.h"
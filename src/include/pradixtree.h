@@ -0,0 +1,237 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pradixtree.h
+ * @brief Radix tree for IP address prefixes
+ * @author Alexander Saprykin
+ *
+ * A radix tree (also known as a compressed trie or a PATRICIA tree) stores IP
+ * network prefixes (i.e. 192.168.0.0/16) and allows to find the longest prefix
+ * which matches a given address. This is the classic task of routing tables
+ * and access control lists: the most specific network containing a client
+ * address wins.
+ *
+ * #PRadixTree keeps IPv4 and IPv6 prefixes in separate trees. Every node of a
+ * tree checks a single bit of an address, and chains of nodes with only one
+ * child are collapsed into a single node. Thus a lookup takes at most as many
+ * steps as there are bits in the address (32 or 128) regardless of the number
+ * of stored prefixes, and usually much less.
+ *
+ * Prefixes are inserted with zradix_tree_insert() from a #PSocketAddress, or
+ * with zradix_tree_insert_native() from a native socket address structure
+ * (i.e. obtained with zsocket_address_to_native() or returned by the system
+ * calls). The host bits beyond the prefix length are ignored, as well as the
+ * port number of the address. Use zradix_tree_lookup() or
+ * zradix_tree_lookup_native() to find the value of the longest matching
+ * prefix. Lookups do not allocate memory.
+ *
+ * Example of the address classification:
+ * @code
+ * PRadixTree     *tree;
+ * PSocketAddress *addr;
+ * ppointer       value;
+ *
+ * tree = zradix_tree_new ();
+ *
+ * addr = zsocket_address_new ("10.0.0.0", 0);
+ * zradix_tree_insert (tree, addr, 8, "internal");
+ * zsocket_address_free (addr);
+ *
+ * addr = zsocket_address_new ("10.1.0.0", 0);
+ * zradix_tree_insert (tree, addr, 16, "lab");
+ * zsocket_address_free (addr);
+ *
+ * // Returns "lab" for 10.1.2.3 and "internal" for 10.2.3.4
+ * value = zradix_tree_lookup (tree, client_addr, NULL);
+ * @endcode
+ *
+ * Take attention that the tree doesn't own the values unless a value destroy
+ * function is provided with zradix_tree_new_full().
+ *
+ * #PRadixTree is not thread-safe, but several threads can lookup in the same
+ * tree concurrently as long as it is not modified.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PRADIXTREE_H
+#define PLIBSYS_HEADER_PRADIXTREE_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <psocketaddress.h>
+
+P_BEGIN_DECLS
+
+/** Radix tree opaque data structure. */
+typedef struct PRadixTree_ PRadixTree;
+
+/**
+ * @brief Creates a new empty #PRadixTree.
+ * @return Newly created #PRadixTree in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The caller takes ownership of all the values passed to the tree.
+ */
+P_LIB_API PRadixTree *	zradix_tree_new			(void);
+
+/**
+ * @brief Creates a new empty #PRadixTree with memory management.
+ * @param value_destroy Function to call on every value before the prefix
+ * removal, maybe NULL.
+ * @return Newly created #PRadixTree in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PRadixTree *	zradix_tree_new_full		(PDestroyFunc		value_destroy);
+
+/**
+ * @brief Inserts a network prefix into a #PRadixTree.
+ * @param tree #PRadixTree to insert the prefix into.
+ * @param prefix Network address of the prefix.
+ * @param prefix_len Prefix length, in bits: up to 32 for IPv4 and up to 128
+ * for IPv6.
+ * @param value Value for the prefix.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * If the prefix already exists in the tree, its value is replaced. If a value
+ * destroy function was provided it would be called on the old value.
+ */
+P_LIB_API pboolean	zradix_tree_insert		(PRadixTree		*tree,
+							 const PSocketAddress	*prefix,
+							 puint			prefix_len,
+							 ppointer		value);
+
+/**
+ * @brief Inserts a network prefix given as a native address into a
+ * #PRadixTree.
+ * @param tree #PRadixTree to insert the prefix into.
+ * @param native Pointer to the native socket address structure (struct
+ * sockaddr_in or struct sockaddr_in6).
+ * @param len Size of the @a native structure, in bytes.
+ * @param prefix_len Prefix length, in bits.
+ * @param value Value for the prefix.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zradix_tree_insert_native	(PRadixTree		*tree,
+							 pconstpointer		native,
+							 psize			len,
+							 puint			prefix_len,
+							 ppointer		value);
+
+/**
+ * @brief Removes a network prefix from a #PRadixTree.
+ * @param tree #PRadixTree to remove the prefix from.
+ * @param prefix Network address of the prefix.
+ * @param prefix_len Prefix length, in bits.
+ * @return TRUE if the prefix was removed, FALSE if it was not found.
+ * @since 0.0.5
+ *
+ * Only the exactly matching prefix is removed. If a value destroy function was
+ * provided it would be called on the value.
+ */
+P_LIB_API pboolean	zradix_tree_remove		(PRadixTree		*tree,
+							 const PSocketAddress	*prefix,
+							 puint			prefix_len);
+
+/**
+ * @brief Removes a network prefix given as a native address from a
+ * #PRadixTree.
+ * @param tree #PRadixTree to remove the prefix from.
+ * @param native Pointer to the native socket address structure.
+ * @param len Size of the @a native structure, in bytes.
+ * @param prefix_len Prefix length, in bits.
+ * @return TRUE if the prefix was removed, FALSE if it was not found.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zradix_tree_remove_native	(PRadixTree		*tree,
+							 pconstpointer		native,
+							 psize			len,
+							 puint			prefix_len);
+
+/**
+ * @brief Searches for the longest prefix matching an address.
+ * @param tree #PRadixTree to lookup in.
+ * @param addr Address to lookup for.
+ * @param[out] prefix_len Length of the found prefix, in bits, maybe NULL.
+ * @return Value of the longest matching prefix in case of success, NULL if no
+ * prefix matches the address.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	zradix_tree_lookup		(const PRadixTree	*tree,
+							 const PSocketAddress	*addr,
+							 puint			*prefix_len);
+
+/**
+ * @brief Searches for the longest prefix matching a native address.
+ * @param tree #PRadixTree to lookup in.
+ * @param native Pointer to the native socket address structure.
+ * @param len Size of the @a native structure, in bytes.
+ * @param[out] prefix_len Length of the found prefix, in bits, maybe NULL.
+ * @return Value of the longest matching prefix in case of success, NULL if no
+ * prefix matches the address.
+ * @since 0.0.5
+ *
+ * This is the fastest way to classify an incoming connection, as the address
+ * returned by the system can be used as is.
+ */
+P_LIB_API ppointer	zradix_tree_lookup_native	(const PRadixTree	*tree,
+							 pconstpointer		native,
+							 psize			len,
+							 puint			*prefix_len);
+
+/**
+ * @brief Gets the number of prefixes stored in a #PRadixTree.
+ * @param tree #PRadixTree to get the number of prefixes for.
+ * @return Number of prefixes.
+ * @since 0.0.5
+ */
+P_LIB_API psize		zradix_tree_get_nprefixes	(const PRadixTree	*tree);
+
+/**
+ * @brief Removes all the prefixes from a #PRadixTree.
+ * @param tree #PRadixTree to clear.
+ * @since 0.0.5
+ *
+ * If a value destroy function was provided it would be called on every value.
+ */
+P_LIB_API void		zradix_tree_clear		(PRadixTree		*tree);
+
+/**
+ * @brief Frees a #PRadixTree.
+ * @param tree #PRadixTree to free.
+ * @since 0.0.5
+ *
+ * If a value destroy function was provided it would be called on every value.
+ */
+P_LIB_API void		zradix_tree_free		(PRadixTree		*tree);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PRADIXTREE_H */
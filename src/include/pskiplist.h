@@ -0,0 +1,229 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pskiplist.h
+ * @brief Lock-free concurrent skip list
+ * @author Alexander Saprykin
+ *
+ * #PSkipList is an ordered key-value map which can be modified and searched
+ * from many threads at the same time without any locking. Unlike #PTree
+ * guarded with a #PRWLock, writers do not serialize on a single lock and
+ * readers never block: all the operations are built upon the atomic
+ * compare-and-exchange (see zatomic_pointer_compare_and_exchange()), so a
+ * stalled thread can't prevent other threads from making progress.
+ *
+ * A skip list is a set of sorted linked lists layered on top of each other.
+ * The bottom list contains all the keys, and every upper list contains about
+ * a quarter of the keys of the list below it. A search starts from the top
+ * list and descends down when it passes the key, so it takes O(logN) steps on
+ * average.
+ *
+ * Use zskip_list_new(), or its detailed variations like
+ * zskip_list_new_with_data() and zskip_list_new_full() to create a skip list.
+ * New key-value pairs can be inserted with zskip_list_insert() and removed
+ * with zskip_list_remove(). Unlike ztree_insert(), zskip_list_insert() never
+ * replaces an existing key. Use zskip_list_lookup() to find the value by a key,
+ * zskip_list_foreach() and zskip_list_foreach_range() to iterate through the
+ * keys in order.
+ *
+ * Memory of the removed nodes is reclaimed safely: a removed node is retired
+ * and freed only when no other thread could still hold a reference to it,
+ * i.e. at a moment when the calling thread is the only one operating on the
+ * list. Key and value destroy functions (if provided) are called at the same
+ * moment, so the keys and the values passed to a traverse function stay valid
+ * during the call even if they are being removed concurrently. Take attention
+ * that the value returned by zskip_list_lookup() is not protected this way:
+ * if the values are removed concurrently with a destroy function provided, the
+ * caller must use the traverse functions instead or manage the values
+ * lifetime by itself.
+ *
+ * Iteration is weakly consistent: it never returns a key twice and always
+ * returns keys in order, but the keys inserted or removed concurrently may or
+ * may not be visited.
+ *
+ * Only zskip_list_free() is not thread-safe and must be called when no other
+ * thread uses the list.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSKIPLIST_H
+#define PLIBSYS_HEADER_PSKIPLIST_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+
+P_BEGIN_DECLS
+
+/** Skip list opaque data structure. */
+typedef struct PSkipList_ PSkipList;
+
+/**
+ * @brief Initializes new #PSkipList.
+ * @param func Key compare function.
+ * @return Newly initialized #PSkipList object in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The caller takes ownership of all the keys and the values passed to the
+ * list.
+ */
+P_LIB_API PSkipList *	zskip_list_new			(PCompareFunc		func);
+
+/**
+ * @brief Initializes new #PSkipList with additional data.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @return Newly initialized #PSkipList object in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The caller takes ownership of all the keys and the values passed to the
+ * list.
+ */
+P_LIB_API PSkipList *	zskip_list_new_with_data	(PCompareDataFunc	func,
+							 ppointer		data);
+
+/**
+ * @brief Initializes new #PSkipList with additional data and memory
+ * management.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @param key_destroy Function to call on every key before the node destruction,
+ * maybe NULL.
+ * @param value_destroy Function to call on every value before the node
+ * destruction, maybe NULL.
+ * @return Newly initialized #PSkipList object in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The destroy functions are called when the memory of a removed node is
+ * reclaimed, which may happen later than the removal itself.
+ */
+P_LIB_API PSkipList *	zskip_list_new_full		(PCompareDataFunc	func,
+							 ppointer		data,
+							 PDestroyFunc		key_destroy,
+							 PDestroyFunc		value_destroy);
+
+/**
+ * @brief Inserts a new key-value pair into a skip list.
+ * @param list #PSkipList to insert a node in.
+ * @param key Key to insert.
+ * @param value Value corresponding to the given @a key.
+ * @return TRUE if the key was inserted, FALSE if the key already exists or
+ * in case of error.
+ * @since 0.0.5
+ *
+ * An existing key is never replaced, the caller still owns the @a key and the
+ * @a value if the call fails.
+ */
+P_LIB_API pboolean	zskip_list_insert		(PSkipList		*list,
+							 ppointer		key,
+							 ppointer		value);
+
+/**
+ * @brief Removes a key from a skip list.
+ * @param list #PSkipList to remove a key from.
+ * @param key Key to remove.
+ * @return TRUE if the key was removed, FALSE if the key was not found.
+ * @since 0.0.5
+ *
+ * If several threads remove the same key concurrently, only one of them
+ * succeeds.
+ */
+P_LIB_API pboolean	zskip_list_remove		(PSkipList		*list,
+							 pconstpointer		key);
+
+/**
+ * @brief Lookups a value by a given key.
+ * @param list #PSkipList to lookup in.
+ * @param key Key to lookup.
+ * @param[out] value Value for the given @a key, maybe NULL.
+ * @return TRUE if the @a key was found, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	zskip_list_lookup		(PSkipList		*list,
+							 pconstpointer		key,
+							 ppointer		*value);
+
+/**
+ * @brief Iterates in-order through all the skip list nodes.
+ * @param list #PSkipList to traverse.
+ * @param traverse_func Function for traversing, return TRUE from it to stop
+ * the iteration.
+ * @param user_data Additional (maybe NULL) user-provided data for the
+ * @a traverse_func.
+ * @since 0.0.5
+ */
+P_LIB_API void		zskip_list_foreach		(PSkipList		*list,
+							 PTraverseFunc		traverse_func,
+							 ppointer		user_data);
+
+/**
+ * @brief Iterates in-order through the skip list nodes within a key range.
+ * @param list #PSkipList to traverse.
+ * @param from Lower (inclusive) bound of the keys.
+ * @param to Upper (exclusive) bound of the keys.
+ * @param traverse_func Function for traversing, return TRUE from it to stop
+ * the iteration.
+ * @param user_data Additional (maybe NULL) user-provided data for the
+ * @a traverse_func.
+ * @since 0.0.5
+ *
+ * The first node is found in O(logN) time, so iterating a small range in a
+ * large list is cheap.
+ */
+P_LIB_API void		zskip_list_foreach_range	(PSkipList		*list,
+							 pconstpointer		from,
+							 pconstpointer		to,
+							 PTraverseFunc		traverse_func,
+							 ppointer		user_data);
+
+/**
+ * @brief Gets node count.
+ * @param list #PSkipList to get node count for.
+ * @return Node count.
+ * @since 0.0.5
+ *
+ * The value is exact only if the list is not being modified concurrently.
+ */
+P_LIB_API pint		zskip_list_get_nnodes		(const PSkipList	*list);
+
+/**
+ * @brief Frees a previously initialized skip list object.
+ * @param list #PSkipList object to free.
+ * @since 0.0.5
+ *
+ * Key and value destroy functions would be called on every node if any of
+ * them was provided. No other thread should use the list during this call.
+ */
+P_LIB_API void		zskip_list_free			(PSkipList		*list);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSKIPLIST_H */
@@ -46,6 +46,14 @@
 
 P_BEGIN_DECLS
 
+/** Buffer size enough for any 64-bit integer printed with zstr_from_int64() or
+ * zstr_from_uint64(), including the trailing zero. */
+#define P_STR_INT64_BUF_SIZE	21
+
+/** Buffer size enough for any value printed with zstr_from_double(), including
+ * the trailing zero. */
+#define P_STR_DOUBLE_BUF_SIZE	32
+
 /**
  * @brief Copies a string.
  * @param str String with the trailing zero to copy.
@@ -55,6 +63,22 @@ P_BEGIN_DECLS
  */
 P_LIB_API pchar *	zstrdup	(const pchar	*str);
 
+/**
+ * @brief Copies a given number of characters from a string.
+ * @param str String to copy, may not be zero terminated.
+ * @param len Number of characters to copy from @a str.
+ * @return Zero terminated copy of the first @a len characters of @a str in
+ * case of success, NULL otherwise. The caller takes ownership of the returned
+ * string.
+ * @since 0.0.5
+ *
+ * Exactly @a len characters are copied, zero characters inside @a str are not
+ * treated specially. This call is useful to make a standalone string from a
+ * span returned by zstrchomp_span() or zstrtok_span().
+ */
+P_LIB_API pchar *	zstrndup	(const pchar	*str,
+					 psize		len);
+
 /**
  * @brief Removes trailing and leading whitespaces.
  * @param str String with the trailing zero to process.
@@ -64,6 +88,37 @@ P_LIB_API pchar *	zstrdup	(const pchar	*str);
  */
 P_LIB_API pchar *	zstrchomp	(const pchar	*str);
 
+/**
+ * @brief Finds a span without trailing and leading whitespaces.
+ * @param str String to process, may not be zero terminated.
+ * @param len Length of @a str, in characters.
+ * @param[out] span_len Length of the resulting span, may be NULL.
+ * @return Pointer to the first non-whitespace character inside @a str, NULL
+ * if @a str is NULL.
+ * @since 0.0.5
+ *
+ * This is a non-allocating version of zstrchomp(): the input string is not
+ * modified and nothing is copied, the result is a pointer and a length inside
+ * the original buffer. If @a str consists of whitespaces only, the returned
+ * span has zero length.
+ */
+P_LIB_API const pchar *	zstrchomp_span	(const pchar	*str,
+					 psize		len,
+					 psize		*span_len);
+
+/**
+ * @brief Removes trailing and leading whitespaces in place.
+ * @param str String with the trailing zero to process.
+ * @return Pointer to the first non-whitespace character inside @a str, NULL
+ * if @a str is NULL.
+ * @since 0.0.5
+ *
+ * Unlike zstrchomp(), no memory is allocated: the character after the last
+ * non-whitespace one is replaced with the trailing zero and a pointer inside
+ * @a str is returned.
+ */
+P_LIB_API pchar *	zstrchomp_inplace	(pchar		*str);
+
 /**
  * @brief Tokenizes a string by given delimiters.
  * @param[in,out] str String to tokenize.
@@ -100,6 +155,37 @@ P_LIB_API pchar *	zstrtok	(pchar		*str,
 					 const pchar	*delim,
 					 pchar		**buf);
 
+/**
+ * @brief Splits a length-bounded string into tokens without modifying it.
+ * @param[in,out] str Pointer to the string to split, advanced past the
+ * returned token on each call.
+ * @param[in,out] len Pointer to the remaining length of @a str, decreased
+ * accordingly.
+ * @param delim Zero terminated set of delimiter characters.
+ * @param[out] token_len Length of the returned token, may be NULL.
+ * @return Pointer to the next token inside the original string, NULL if there
+ * are no more tokens.
+ * @since 0.0.5
+ *
+ * Leading delimiters are skipped and the token runs up to the next delimiter
+ * or the end of the string. The string is not modified and the token is not
+ * zero terminated, so the call works on read-only and non-terminated buffers
+ * and doesn't need any hidden state. Example:
+ * @code
+ * const pchar *str = "a, b,,c";
+ * psize        len = strlen (str);
+ * const pchar *token;
+ * psize        token_len;
+ *
+ * while ((token = zstrtok_span (&str, &len, ", ", &token_len)) != NULL)
+ *     printf ("Token: %.*s\n", (int) token_len, token);
+ * @endcode
+ */
+P_LIB_API const pchar *	zstrtok_span	(const pchar	**str,
+					 psize		*len,
+					 const pchar	*delim,
+					 psize		*token_len);
+
 /**
  * @brief Converts a string to @a double without a locale dependency.
  * @param str String to convert.
@@ -109,9 +195,155 @@ P_LIB_API pchar *	zstrtok	(pchar		*str,
  * Since the atof() system call is locale dependent, you can use this call to
  * convert string variables to @a double values. The decimal point is '.' as in
  * the 'C' locale.
+ *
+ * Leading whitespaces are skipped, parsing stops at the first character which
+ * doesn't belong to the number. The result is correctly rounded to the nearest
+ * @a double value (ties to even), no memory is allocated.
+ *
+ * For compatibility reasons a positive decimal exponent given after 'e' or 'E'
+ * is clamped to 308. Negative exponents are not clamped, so subnormal values
+ * and underflow to zero follow IEEE 754. Use zstrntod() to get IEEE 754
+ * overflow behavior as well.
  */
 P_LIB_API double	zstrtod	(const pchar	*str);
 
+/**
+ * @brief Converts a length-bounded string to @a double without a locale
+ * dependency.
+ * @param str String to convert, may not be zero terminated.
+ * @param len Maximum number of characters to read from @a str.
+ * @param[out] end Pointer to the first character after the parsed number, may
+ * be NULL. Set to @a str if no number was found.
+ * @return Floating point value in case of success, 0 otherwise.
+ * @since 0.0.5
+ *
+ * The accepted syntax is: optional leading whitespaces, optional sign, decimal
+ * digits with an optional '.' decimal point (at least one digit is required)
+ * and an optional exponent part. The exponent part is consumed only when it
+ * contains at least one digit. Infinity and NaN literals are not recognized.
+ *
+ * The result is correctly rounded to the nearest @a double value (ties to
+ * even). Values too large in magnitude are converted to infinity, values too
+ * small are converted to zero (or a subnormal number if possible).
+ *
+ * No memory is allocated, so the call is suitable for parsing numbers in place
+ * from larger buffers.
+ */
+P_LIB_API double	zstrntod	(const pchar	*str,
+					 psize		len,
+					 const pchar	**end);
+
+/**
+ * @brief Converts a signed 64-bit integer to a string.
+ * @param val Value to convert.
+ * @param[out] buf Buffer to put the string into.
+ * @param size Size of @a buf, in bytes.
+ * @return Length of the string without the trailing zero in case of success,
+ * 0 otherwise.
+ * @since 0.0.5
+ *
+ * The string is written with the trailing zero, #P_STR_INT64_BUF_SIZE bytes
+ * are always enough. If @a buf is too small, nothing is written except the
+ * trailing zero and 0 is returned.
+ *
+ * No memory is allocated and the call doesn't depend on the current locale,
+ * unlike snprintf(), so it is suitable for hot logging and serialization
+ * paths.
+ */
+P_LIB_API psize		zstr_from_int64	(pint64		val,
+					 pchar		*buf,
+					 psize		size);
+
+/**
+ * @brief Converts an unsigned 64-bit integer to a string.
+ * @param val Value to convert.
+ * @param[out] buf Buffer to put the string into.
+ * @param size Size of @a buf, in bytes.
+ * @return Length of the string without the trailing zero in case of success,
+ * 0 otherwise.
+ * @since 0.0.5
+ *
+ * Works the same way as zstr_from_int64().
+ */
+P_LIB_API psize		zstr_from_uint64	(puint64	val,
+					 pchar		*buf,
+					 psize		size);
+
+/**
+ * @brief Converts a @a double value to the shortest string which reads back
+ * to the same value.
+ * @param val Value to convert.
+ * @param[out] buf Buffer to put the string into.
+ * @param size Size of @a buf, in bytes.
+ * @return Length of the string without the trailing zero in case of success,
+ * 0 otherwise.
+ * @since 0.0.5
+ *
+ * The result contains the minimal number of significant digits needed to
+ * parse it back with zstrntod() (or strtod()) to exactly the same value. If
+ * several such strings exist, the closest one to the exact value is taken.
+ *
+ * The layout follows the %g format of printf(): the scientific notation (like
+ * "1.5e+300" or "2e-05") is used if the decimal exponent is less than -4 or
+ * greater than 16, otherwise a plain notation is used (like "0.001" or "100").
+ * The decimal point is always '.', NaN and infinity values are printed as
+ * "nan", "inf" and "-inf".
+ *
+ * The string is written with the trailing zero, #P_STR_DOUBLE_BUF_SIZE bytes
+ * are always enough. If @a buf is too small, nothing is written except the
+ * trailing zero and 0 is returned. No memory is allocated.
+ */
+P_LIB_API psize		zstr_from_double	(double		val,
+					 pchar		*buf,
+					 psize		size);
+
+/**
+ * @brief Interns a string.
+ * @param str String with the trailing zero to intern.
+ * @return Canonical copy of @a str in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The intern pool keeps exactly one copy of every distinct string passed to
+ * it, so equal strings are interned to the same pointer. Interned strings can
+ * be compared with the == operator and used directly as #PHashTable keys.
+ *
+ * The returned string is owned by the library and must not be modified or
+ * freed. It remains valid until zlibsys_shutdown() is called. Strings are
+ * stored in large memory chunks, so interning many short strings is cheap in
+ * terms of both time and memory.
+ *
+ * This call is thread-safe.
+ */
+P_LIB_API const pchar *	zstr_intern	(const pchar	*str);
+
+/**
+ * @brief Interns a length-bounded string.
+ * @param str String to intern, may not be zero terminated.
+ * @param len Length of @a str, in characters.
+ * @return Canonical zero terminated copy of the first @a len characters of
+ * @a str in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Works the same way as zstr_intern(), but allows to intern a span returned
+ * by zstrchomp_span() or zstrtok_span() without copying it first.
+ */
+P_LIB_API const pchar *	zstr_intern_len	(const pchar	*str,
+					 psize		len);
+
+/**
+ * @brief Looks up an already interned string.
+ * @param str String with the trailing zero to look up.
+ * @return Canonical copy of @a str if it was interned before, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Unlike zstr_intern(), this call never adds new strings to the pool, so it
+ * can be used to check untrusted input against a set of interned names
+ * without growing the pool.
+ *
+ * This call is thread-safe.
+ */
+P_LIB_API const pchar *	zstr_intern_lookup	(const pchar	*str);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PSTRING_H */
@@ -0,0 +1,231 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pstringbuilder.h
+ * @brief Growable string builder
+ * @author Alexander Saprykin
+ *
+ * #PStringBuilder assembles a string from pieces in a single growable buffer.
+ * Building a string with the plain zmalloc(), strcpy() and strcat() calls
+ * allocates and copies the whole string for every added piece, while the
+ * builder grows its buffer geometrically (doubling the capacity), so the
+ * amortized cost of an append is proportional only to the appended length.
+ * If the final length is known in advance, use zstring_builder_reserve() to
+ * build the string with exactly one allocation.
+ *
+ * Strings, raw bytes, characters, integers and floating point numbers can be
+ * appended, as well as the printf-style formatted text which is printed
+ * directly into the buffer. The built string is always zero-terminated and
+ * can be accessed with zstring_builder_get_str().
+ *
+ * When the string is ready, take it with zstring_builder_steal(): the buffer
+ * is handed over to the caller without copying and the builder becomes empty,
+ * so it can be reused or freed with zstring_builder_free().
+ *
+ * If a memory allocation fails, an append call returns FALSE and leaves the
+ * builder contents untouched.
+ *
+ * #PStringBuilder is not thread-safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSTRINGBUILDER_H
+#define PLIBSYS_HEADER_PSTRINGBUILDER_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <pstdarg.h>
+
+P_BEGIN_DECLS
+
+/** String builder opaque data structure. */
+typedef struct PStringBuilder_ PStringBuilder;
+
+/**
+ * @brief Creates a new empty #PStringBuilder.
+ * @param reserve Number of characters to reserve memory for, maybe 0.
+ * @return Newly created #PStringBuilder in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PStringBuilder *	zstring_builder_new		(psize			reserve);
+
+/**
+ * @brief Reserves memory for the characters to be appended.
+ * @param builder #PStringBuilder to reserve memory for.
+ * @param len Number of characters to be appended after the current string.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * After the successful call, appending up to @a len characters doesn't
+ * require any memory allocation.
+ */
+P_LIB_API pboolean		zstring_builder_reserve		(PStringBuilder		*builder,
+								 psize			len);
+
+/**
+ * @brief Appends a zero-terminated string.
+ * @param builder #PStringBuilder to append to.
+ * @param str String to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zstring_builder_append		(PStringBuilder		*builder,
+								 const pchar		*str);
+
+/**
+ * @brief Appends a given number of bytes.
+ * @param builder #PStringBuilder to append to.
+ * @param data Bytes to append, may contain zero bytes.
+ * @param len Number of bytes to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zstring_builder_append_len	(PStringBuilder		*builder,
+								 const pchar		*data,
+								 psize			len);
+
+/**
+ * @brief Appends a single character.
+ * @param builder #PStringBuilder to append to.
+ * @param c Character to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zstring_builder_append_char	(PStringBuilder		*builder,
+								 pchar			c);
+
+/**
+ * @brief Appends a signed integer in the decimal form.
+ * @param builder #PStringBuilder to append to.
+ * @param val Integer to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zstring_builder_append_int64	(PStringBuilder		*builder,
+								 pint64			val);
+
+/**
+ * @brief Appends an unsigned integer in the decimal form.
+ * @param builder #PStringBuilder to append to.
+ * @param val Integer to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zstring_builder_append_uint64	(PStringBuilder		*builder,
+								 puint64		val);
+
+/**
+ * @brief Appends a floating point number.
+ * @param builder #PStringBuilder to append to.
+ * @param val Number to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The number is printed with the shortest number of digits to be read back
+ * exactly, the decimal point is '.' regardless of the current locale. See
+ * zstr_from_double() for the details of the format.
+ */
+P_LIB_API pboolean		zstring_builder_append_double	(PStringBuilder		*builder,
+								 double			val);
+
+/**
+ * @brief Appends a printf-style formatted string.
+ * @param builder #PStringBuilder to append to.
+ * @param format Format string, as for printf().
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The text is printed directly into the builder buffer, growing it if needed.
+ */
+P_LIB_API pboolean		zstring_builder_append_printf	(PStringBuilder		*builder,
+								 const pchar		*format,
+								 ...);
+
+/**
+ * @brief Appends a printf-style formatted string with variable arguments.
+ * @param builder #PStringBuilder to append to.
+ * @param format Format string, as for vprintf().
+ * @param args Arguments for the @a format.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		zstring_builder_append_vprintf	(PStringBuilder		*builder,
+								 const pchar		*format,
+								 zva_list		args);
+
+/**
+ * @brief Gets the built string.
+ * @param builder #PStringBuilder to get the string from.
+ * @return Zero-terminated string, it is valid until the next modification of
+ * the @a builder.
+ * @since 0.0.5
+ */
+P_LIB_API const pchar *		zstring_builder_get_str		(const PStringBuilder	*builder);
+
+/**
+ * @brief Gets the length of the built string.
+ * @param builder #PStringBuilder to get the length for.
+ * @return Length of the string in bytes, without the trailing zero.
+ * @since 0.0.5
+ */
+P_LIB_API psize			zstring_builder_get_len		(const PStringBuilder	*builder);
+
+/**
+ * @brief Truncates the built string.
+ * @param builder #PStringBuilder to truncate.
+ * @param len New length of the string, should not exceed the current one.
+ * @since 0.0.5
+ *
+ * Allocated memory is kept for the reuse.
+ */
+P_LIB_API void			zstring_builder_truncate	(PStringBuilder		*builder,
+								 psize			len);
+
+/**
+ * @brief Takes the built string from a builder without copying.
+ * @param builder #PStringBuilder to take the string from.
+ * @return Zero-terminated string in case of success, NULL otherwise. The caller
+ * takes ownership of the returned string and should free it with zfree().
+ * @since 0.0.5
+ *
+ * The builder becomes empty after the call and can be used to build another
+ * string.
+ */
+P_LIB_API pchar *		zstring_builder_steal		(PStringBuilder		*builder);
+
+/**
+ * @brief Frees a #PStringBuilder.
+ * @param builder #PStringBuilder to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			zstring_builder_free		(PStringBuilder		*builder);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSTRINGBUILDER_H */
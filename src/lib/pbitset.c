@@ -0,0 +1,504 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pbitset.h"
+#include "pmem.h"
+#include "pcpuinfo-private.h"
+
+#include <string.h>
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+#  include <immintrin.h>
+#endif
+
+#define P_BITSET_WORD_BITS	64
+#define P_BITSET_NWORDS(nbits)	(((nbits) + P_BITSET_WORD_BITS - 1) / P_BITSET_WORD_BITS)
+#define P_BITSET_WORD(index)	((index) / P_BITSET_WORD_BITS)
+#define P_BITSET_MASK(index)	(((puint64) 1) << ((index) % P_BITSET_WORD_BITS))
+
+/* Number of 64-bit words in an AVX2 register */
+#define P_BITSET_AVX2_WORDS	4
+
+typedef enum PBitSetOp_ {
+	P_BITSET_OP_AND		= 0,
+	P_BITSET_OP_OR		= 1,
+	P_BITSET_OP_XOR		= 2,
+	P_BITSET_OP_ANDNOT	= 3
+} PBitSetOp;
+
+struct PBitSet_ {
+	puint64		*words;
+	psize		nwords;
+	psize		nbits;
+	pboolean	own_memory;
+};
+
+static pint pzbitset_popcount (puint64 val);
+static pint pzbitset_ctz (puint64 val);
+static puint64 pzbitset_last_word_mask (const PBitSet *bitset);
+static void pzbitset_apply_op_scalar (puint64 *dst, const puint64 *src, psize from, psize nwords, PBitSetOp op);
+static pboolean pzbitset_apply_op (PBitSet *dst, const PBitSet *src, PBitSetOp op);
+static pssize pzbitset_find_next (const PBitSet *bitset, psize from, puint64 invert);
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+static P_CPU_TARGET ("avx2") psize pzbitset_apply_op_avx2 (puint64 *dst, const puint64 *src, psize nwords, PBitSetOp op);
+static P_CPU_TARGET ("avx2") psize pzbitset_count_avx2 (const puint64 *words, psize nwords, psize *processed);
+static P_CPU_TARGET ("avx2") psize pzbitset_skip_avx2 (const puint64 *words, psize from, psize nwords, puint64 invert);
+
+static psize
+pzbitset_apply_op_avx2 (puint64		*dst,
+			const puint64	*src,
+			psize		nwords,
+			PBitSetOp	op)
+{
+	__m256i	a, b;
+	psize	i;
+
+	for (i = 0; i + P_BITSET_AVX2_WORDS <= nwords; i += P_BITSET_AVX2_WORDS) {
+		a = _mm256_loadu_si256 ((const __m256i *) (dst + i));
+		b = _mm256_loadu_si256 ((const __m256i *) (src + i));
+
+		switch (op) {
+		case P_BITSET_OP_AND:
+			a = _mm256_and_si256 (a, b);
+			break;
+		case P_BITSET_OP_OR:
+			a = _mm256_or_si256 (a, b);
+			break;
+		case P_BITSET_OP_XOR:
+			a = _mm256_xor_si256 (a, b);
+			break;
+		case P_BITSET_OP_ANDNOT:
+			a = _mm256_andnot_si256 (b, a);
+			break;
+		}
+
+		_mm256_storeu_si256 ((__m256i *) (dst + i), a);
+	}
+
+	return i;
+}
+
+static psize
+pzbitset_count_avx2 (const puint64	*words,
+		     psize		nwords,
+		     psize		*processed)
+{
+	__m256i	lookup, low_mask, acc, v, lo, hi, cnt;
+	puint64	lanes[P_BITSET_AVX2_WORDS];
+	psize	i;
+
+	/* Population count of every nibble value */
+	lookup   = _mm256_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+				     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	low_mask = _mm256_set1_epi8 (0x0F);
+	acc      = _mm256_setzero_si256 ();
+
+	for (i = 0; i + P_BITSET_AVX2_WORDS <= nwords; i += P_BITSET_AVX2_WORDS) {
+		v   = _mm256_loadu_si256 ((const __m256i *) (words + i));
+		lo  = _mm256_and_si256 (v, low_mask);
+		hi  = _mm256_and_si256 (_mm256_srli_epi16 (v, 4), low_mask);
+		cnt = _mm256_add_epi8 (_mm256_shuffle_epi8 (lookup, lo),
+				       _mm256_shuffle_epi8 (lookup, hi));
+		acc = _mm256_add_epi64 (acc, _mm256_sad_epu8 (cnt, _mm256_setzero_si256 ()));
+	}
+
+	_mm256_storeu_si256 ((__m256i *) lanes, acc);
+	*processed = i;
+
+	return (psize) (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+static psize
+pzbitset_skip_avx2 (const puint64	*words,
+		    psize		from,
+		    psize		nwords,
+		    puint64		invert)
+{
+	__m256i	v, pattern;
+
+	/* Skip the whole registers without matching bits */
+	pattern = _mm256_set1_epi64x ((pint64) invert);
+
+	for (; from + P_BITSET_AVX2_WORDS <= nwords; from += P_BITSET_AVX2_WORDS) {
+		v = _mm256_xor_si256 (_mm256_loadu_si256 ((const __m256i *) (words + from)), pattern);
+
+		if (!_mm256_testz_si256 (v, v))
+			break;
+	}
+
+	return from;
+}
+#endif
+
+static pint
+pzbitset_popcount (puint64 val)
+{
+#ifdef P_CC_GNU
+	return __builtin_popcountll (val);
+#else
+	val = val - ((val >> 1) & 0x5555555555555555ULL);
+	val = (val & 0x3333333333333333ULL) + ((val >> 2) & 0x3333333333333333ULL);
+	val = (val + (val >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+	return (pint) ((val * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+static pint
+pzbitset_ctz (puint64 val)
+{
+#ifdef P_CC_GNU
+	return __builtin_ctzll (val);
+#else
+	pint ret = 0;
+
+	while ((val & 0xFF) == 0) {
+		val >>= 8;
+		ret += 8;
+	}
+
+	while ((val & 1) == 0) {
+		val >>= 1;
+		++ret;
+	}
+
+	return ret;
+#endif
+}
+
+static puint64
+pzbitset_last_word_mask (const PBitSet *bitset)
+{
+	psize tail = bitset->nbits % P_BITSET_WORD_BITS;
+
+	return tail == 0 ? P_MAXUINT64 : (((puint64) 1) << tail) - 1;
+}
+
+static void
+pzbitset_apply_op_scalar (puint64	*dst,
+			  const puint64	*src,
+			  psize		from,
+			  psize		nwords,
+			  PBitSetOp	op)
+{
+	psize i;
+
+	for (i = from; i < nwords; ++i) {
+		switch (op) {
+		case P_BITSET_OP_AND:
+			dst[i] &= src[i];
+			break;
+		case P_BITSET_OP_OR:
+			dst[i] |= src[i];
+			break;
+		case P_BITSET_OP_XOR:
+			dst[i] ^= src[i];
+			break;
+		case P_BITSET_OP_ANDNOT:
+			dst[i] &= ~src[i];
+			break;
+		}
+	}
+}
+
+static pboolean
+pzbitset_apply_op (PBitSet		*dst,
+		   const PBitSet	*src,
+		   PBitSetOp		op)
+{
+	psize done = 0;
+
+	if (P_UNLIKELY (dst == NULL || src == NULL || dst->nbits != src->nbits))
+		return FALSE;
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		done = pzbitset_apply_op_avx2 (dst->words, src->words, dst->nwords, op);
+#endif
+
+	pzbitset_apply_op_scalar (dst->words, src->words, done, dst->nwords, op);
+
+	return TRUE;
+}
+
+static pssize
+pzbitset_find_next (const PBitSet	*bitset,
+		    psize		from,
+		    puint64		invert)
+{
+	puint64	word;
+	psize	index;
+
+	if (P_UNLIKELY (bitset == NULL || from >= bitset->nbits))
+		return -1;
+
+	index = P_BITSET_WORD (from);
+
+	/* Ignore the bits before the starting one in the first word */
+	word = (bitset->words[index] ^ invert) & (P_MAXUINT64 << (from % P_BITSET_WORD_BITS));
+
+	while (word == 0) {
+		if (++index >= bitset->nwords)
+			return -1;
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+		if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2)) {
+			index = pzbitset_skip_avx2 (bitset->words, index, bitset->nwords, invert);
+
+			if (index >= bitset->nwords)
+				return -1;
+		}
+#endif
+
+		word = bitset->words[index] ^ invert;
+	}
+
+	from = index * P_BITSET_WORD_BITS + (psize) pzbitset_ctz (word);
+
+	return from < bitset->nbits ? (pssize) from : -1;
+}
+
+P_LIB_API PBitSet *
+zbitset_new (psize nbits)
+{
+	PBitSet *ret;
+
+	if (P_UNLIKELY (nbits == 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PBitSet))) == NULL)) {
+		P_ERROR ("PBitSet::zbitset_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	ret->nbits      = nbits;
+	ret->nwords     = P_BITSET_NWORDS (nbits);
+	ret->own_memory = TRUE;
+
+	if (P_UNLIKELY ((ret->words = zmalloc0 (ret->nwords * sizeof (puint64))) == NULL)) {
+		P_ERROR ("PBitSet::zbitset_new: failed(2) to allocate memory");
+		zfree (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PBitSet *
+zbitset_new_from_memory (ppointer	mem,
+			 psize		size,
+			 psize		nbits)
+{
+	PBitSet *ret;
+
+	if (P_UNLIKELY (mem == NULL || nbits == 0 || size < zbitset_get_memory_size (nbits)))
+		return NULL;
+
+	if (P_UNLIKELY (((puintptr) mem) % sizeof (puint64) != 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PBitSet))) == NULL)) {
+		P_ERROR ("PBitSet::zbitset_new_from_memory: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->words      = (puint64 *) mem;
+	ret->nbits      = nbits;
+	ret->nwords     = P_BITSET_NWORDS (nbits);
+	ret->own_memory = FALSE;
+
+	/* Keep the unused tail bits cleared */
+	ret->words[ret->nwords - 1] &= pzbitset_last_word_mask (ret);
+
+	return ret;
+}
+
+P_LIB_API psize
+zbitset_get_memory_size (psize nbits)
+{
+	return P_BITSET_NWORDS (nbits) * sizeof (puint64);
+}
+
+P_LIB_API psize
+zbitset_get_nbits (const PBitSet *bitset)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return 0;
+
+	return bitset->nbits;
+}
+
+P_LIB_API void
+zbitset_set_bit (PBitSet	*bitset,
+		 psize		index)
+{
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->nbits))
+		return;
+
+	bitset->words[P_BITSET_WORD (index)] |= P_BITSET_MASK (index);
+}
+
+P_LIB_API void
+zbitset_clear_bit (PBitSet	*bitset,
+		   psize	index)
+{
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->nbits))
+		return;
+
+	bitset->words[P_BITSET_WORD (index)] &= ~P_BITSET_MASK (index);
+}
+
+P_LIB_API void
+zbitset_flip_bit (PBitSet	*bitset,
+		  psize		index)
+{
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->nbits))
+		return;
+
+	bitset->words[P_BITSET_WORD (index)] ^= P_BITSET_MASK (index);
+}
+
+P_LIB_API pboolean
+zbitset_test_bit (const PBitSet	*bitset,
+		  psize		index)
+{
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->nbits))
+		return FALSE;
+
+	return (bitset->words[P_BITSET_WORD (index)] & P_BITSET_MASK (index)) != 0;
+}
+
+P_LIB_API void
+zbitset_set_all (PBitSet *bitset)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return;
+
+	memset (bitset->words, 0xFF, bitset->nwords * sizeof (puint64));
+	bitset->words[bitset->nwords - 1] &= pzbitset_last_word_mask (bitset);
+}
+
+P_LIB_API void
+zbitset_clear_all (PBitSet *bitset)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return;
+
+	memset (bitset->words, 0, bitset->nwords * sizeof (puint64));
+}
+
+P_LIB_API pboolean
+zbitset_and (PBitSet		*dst,
+	     const PBitSet	*src)
+{
+	return pzbitset_apply_op (dst, src, P_BITSET_OP_AND);
+}
+
+P_LIB_API pboolean
+zbitset_or (PBitSet		*dst,
+	    const PBitSet	*src)
+{
+	return pzbitset_apply_op (dst, src, P_BITSET_OP_OR);
+}
+
+P_LIB_API pboolean
+zbitset_xor (PBitSet		*dst,
+	     const PBitSet	*src)
+{
+	return pzbitset_apply_op (dst, src, P_BITSET_OP_XOR);
+}
+
+P_LIB_API pboolean
+zbitset_andnot (PBitSet		*dst,
+		const PBitSet	*src)
+{
+	return pzbitset_apply_op (dst, src, P_BITSET_OP_ANDNOT);
+}
+
+P_LIB_API psize
+zbitset_count (const PBitSet *bitset)
+{
+	psize	ret = 0;
+	psize	i   = 0;
+
+	if (P_UNLIKELY (bitset == NULL))
+		return 0;
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		ret = pzbitset_count_avx2 (bitset->words, bitset->nwords, &i);
+#endif
+
+	for (; i < bitset->nwords; ++i)
+		ret += (psize) pzbitset_popcount (bitset->words[i]);
+
+	return ret;
+}
+
+P_LIB_API pssize
+zbitset_find_next_set (const PBitSet	*bitset,
+		       psize		from)
+{
+	return pzbitset_find_next (bitset, from, 0);
+}
+
+P_LIB_API pssize
+zbitset_find_next_clear (const PBitSet	*bitset,
+			 psize		from)
+{
+	return pzbitset_find_next (bitset, from, P_MAXUINT64);
+}
+
+P_LIB_API void
+zbitset_foreach (const PBitSet	*bitset,
+		 PBitSetFunc	func,
+		 ppointer	user_data)
+{
+	puint64	word;
+	psize	i;
+
+	if (P_UNLIKELY (bitset == NULL || func == NULL))
+		return;
+
+	for (i = 0; i < bitset->nwords; ++i) {
+		/* Extract the lowest set bit until the word is empty */
+		for (word = bitset->words[i]; word != 0; word &= word - 1)
+			if (func (i * P_BITSET_WORD_BITS + (psize) pzbitset_ctz (word), user_data))
+				return;
+	}
+}
+
+P_LIB_API void
+zbitset_free (PBitSet *bitset)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return;
+
+	if (bitset->own_memory)
+		zfree (bitset->words);
+
+	zfree (bitset);
+}
@@ -0,0 +1,430 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pbloomfilter.h"
+#include "pmem.h"
+#include "pcpuinfo-private.h"
+#include "phashfunc-private.h"
+
+#include <string.h>
+#include <math.h>
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+#  include <immintrin.h>
+#endif
+
+#define P_BLOOM_FILTER_MAGIC		0x464C4250
+#define P_BLOOM_FILTER_VERSION		1
+#define P_BLOOM_FILTER_HEADER_SIZE	64
+#define P_BLOOM_FILTER_BLOCK_WORDS	8
+#define P_BLOOM_FILTER_BLOCK_SIZE	(P_BLOOM_FILTER_BLOCK_WORDS * sizeof (puint32))
+#define P_BLOOM_FILTER_MAX_BLOCKS	P_MAXUINT32
+#define P_BLOOM_FILTER_ALIGN		64
+
+/* Image header, the blocks follow it */
+typedef struct PBloomFilterHeader_ {
+	puint32		magic;
+	puint32		version;
+	puint64		nblocks;
+	puchar		reserved[P_BLOOM_FILTER_HEADER_SIZE - 16];
+} PBloomFilterHeader;
+
+struct PBloomFilter_ {
+	ppointer		mem;
+	PBloomFilterHeader	*header;
+	puint32			*blocks;
+	puint64			nblocks;
+	pboolean		shared;
+};
+
+/* Odd constants used to derive 8 bit positions from a single 32-bit key */
+static const puint32 pzbloom_filter_salts[P_BLOOM_FILTER_BLOCK_WORDS] = {
+	0x47B6137BU, 0x44974D91U, 0x8824AD5BU, 0xA2B7289DU,
+	0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U
+};
+
+static puint32 * pzbloom_filter_find_block (const PBloomFilter *filter, pconstpointer data, psize len, puint32 *key);
+static void pzbloom_filter_make_mask (puint32 key, puint32 mask[P_BLOOM_FILTER_BLOCK_WORDS]);
+static double pzbloom_filter_estimate_fpp (double load);
+static puint64 pzbloom_filter_calc_nblocks (psize capacity, double fpp);
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+static P_CPU_TARGET ("avx2") __m256i pzbloom_filter_make_mask_avx2 (puint32 key);
+static P_CPU_TARGET ("avx2") void pzbloom_filter_insert_avx2 (puint32 *block, puint32 key);
+static P_CPU_TARGET ("avx2") pboolean pzbloom_filter_contains_avx2 (const puint32 *block, puint32 key);
+
+static __m256i
+pzbloom_filter_make_mask_avx2 (puint32 key)
+{
+	__m256i salts, hashes;
+
+	salts  = _mm256_loadu_si256 ((const __m256i *) pzbloom_filter_salts);
+	hashes = _mm256_mullo_epi32 (_mm256_set1_epi32 ((pint) key), salts);
+	hashes = _mm256_srli_epi32 (hashes, 27);
+
+	return _mm256_sllv_epi32 (_mm256_set1_epi32 (1), hashes);
+}
+
+static void
+pzbloom_filter_insert_avx2 (puint32 *block, puint32 key)
+{
+	__m256i bits;
+
+	bits = _mm256_loadu_si256 ((const __m256i *) block);
+	bits = _mm256_or_si256 (bits, pzbloom_filter_make_mask_avx2 (key));
+
+	_mm256_storeu_si256 ((__m256i *) block, bits);
+}
+
+static pboolean
+pzbloom_filter_contains_avx2 (const puint32 *block, puint32 key)
+{
+	__m256i bits;
+
+	bits = _mm256_loadu_si256 ((const __m256i *) block);
+
+	return _mm256_testc_si256 (bits, pzbloom_filter_make_mask_avx2 (key)) != 0;
+}
+#endif
+
+static puint32 *
+pzbloom_filter_find_block (const PBloomFilter	*filter,
+			   pconstpointer	data,
+			   psize		len,
+			   puint32		*key)
+{
+	puint64 hash;
+	puint64 index;
+
+	hash = zhash_func_bytes (data, len, 0);
+
+	/* Fast range reduction of the high half, the low half is the key */
+	index = ((hash >> 32) * filter->nblocks) >> 32;
+	*key  = (puint32) hash;
+
+	return filter->blocks + index * P_BLOOM_FILTER_BLOCK_WORDS;
+}
+
+static void
+pzbloom_filter_make_mask (puint32 key, puint32 mask[P_BLOOM_FILTER_BLOCK_WORDS])
+{
+	pint i;
+
+	for (i = 0; i < P_BLOOM_FILTER_BLOCK_WORDS; ++i)
+		mask[i] = ((puint32) 1) << ((key * pzbloom_filter_salts[i]) >> 27);
+}
+
+/* False positive probability of a split block filter with the given average
+ * number of elements per block. Block loads follow the Poisson distribution,
+ * and a block with j elements gives a false positive with probability
+ * (1 - (31/32)^j)^8, as every element sets one bit in each of its words. */
+static double
+pzbloom_filter_estimate_fpp (double load)
+{
+	double	weight;
+	double	weight_sum;
+	double	ret;
+	double	range;
+	double	mode;
+	double	j;
+
+	/* Weights are relative to the mode to avoid underflow of exp(-load) */
+	mode  = floor (load);
+	range = 10.0 * sqrt (load) + 20.0;
+
+	weight_sum = 0.0;
+	ret        = 0.0;
+
+	for (j = mode, weight = 1.0; j <= mode + range; ++j) {
+		ret        += weight * pow (1.0 - pow (31.0 / 32.0, j), P_BLOOM_FILTER_BLOCK_WORDS);
+		weight_sum += weight;
+		weight     *= load / (j + 1.0);
+	}
+
+	for (j = mode - 1.0, weight = mode / load; j >= 0.0 && j >= mode - range; --j) {
+		ret        += weight * pow (1.0 - pow (31.0 / 32.0, j), P_BLOOM_FILTER_BLOCK_WORDS);
+		weight_sum += weight;
+		weight     *= j / load;
+	}
+
+	return ret / weight_sum;
+}
+
+/* Returns the least number of blocks giving the desired probability, or 0 if
+ * it is too large */
+static puint64
+pzbloom_filter_calc_nblocks (psize	capacity,
+			     double	fpp)
+{
+	double	nblocks;
+	puint64	lo;
+	puint64	hi;
+	puint64	mid;
+
+	/* Uniform Bloom filter with 8 hash functions is a lower bound, uneven
+	 * block loads always need more bits */
+	nblocks = ceil (-8.0 * (double) capacity / log (1.0 - pow (fpp, 1.0 / 8.0)) /
+			(P_BLOOM_FILTER_BLOCK_WORDS * 32));
+
+	if (P_UNLIKELY (nblocks > (double) P_BLOOM_FILTER_MAX_BLOCKS))
+		return 0;
+
+	hi = (puint64) nblocks;
+
+	if (hi == 0)
+		hi = 1;
+
+	lo = hi;
+
+	while (pzbloom_filter_estimate_fpp ((double) capacity / (double) hi) > fpp) {
+		lo = hi + 1;
+		hi = hi + hi / 4 + 1;
+
+		if (P_UNLIKELY (hi > P_BLOOM_FILTER_MAX_BLOCKS))
+			return 0;
+	}
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+
+		if (pzbloom_filter_estimate_fpp ((double) capacity / (double) mid) > fpp)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return hi;
+}
+
+P_LIB_API PBloomFilter *
+zbloom_filter_new (psize	capacity,
+		   double	fpp)
+{
+	PBloomFilter	*ret;
+	puint64		nblocks;
+	psize		image_size;
+
+	if (P_UNLIKELY (capacity == 0 || !(fpp > 0.0 && fpp < 1.0)))
+		return NULL;
+
+	/* Every element sets 8 bits in a single block, so the filter is sized by
+	 * the split block model rather than by the classic Bloom filter formula */
+	nblocks = pzbloom_filter_calc_nblocks (capacity, fpp);
+
+	if (P_UNLIKELY (nblocks == 0 ||
+			nblocks > (P_MAXSIZE - P_BLOOM_FILTER_HEADER_SIZE - P_BLOOM_FILTER_ALIGN) /
+				  P_BLOOM_FILTER_BLOCK_SIZE))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PBloomFilter))) == NULL)) {
+		P_ERROR ("PBloomFilter::zbloom_filter_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	image_size = P_BLOOM_FILTER_HEADER_SIZE + (psize) nblocks * P_BLOOM_FILTER_BLOCK_SIZE;
+
+	if (P_UNLIKELY ((ret->mem = zmalloc0 (image_size + P_BLOOM_FILTER_ALIGN)) == NULL)) {
+		P_ERROR ("PBloomFilter::zbloom_filter_new: failed(2) to allocate memory");
+		zfree (ret);
+		return NULL;
+	}
+
+	ret->header = (PBloomFilterHeader *) (((puintptr) ret->mem + P_BLOOM_FILTER_ALIGN - 1) &
+					      ~((puintptr) P_BLOOM_FILTER_ALIGN - 1));
+	ret->blocks = (puint32 *) ((puchar *) ret->header + P_BLOOM_FILTER_HEADER_SIZE);
+	ret->nblocks = nblocks;
+	ret->shared  = FALSE;
+
+	ret->header->magic   = P_BLOOM_FILTER_MAGIC;
+	ret->header->version = P_BLOOM_FILTER_VERSION;
+	ret->header->nblocks = nblocks;
+
+	return ret;
+}
+
+P_LIB_API PBloomFilter *
+zbloom_filter_new_from_image (ppointer	image,
+			      psize	size,
+			      pboolean	shared)
+{
+	PBloomFilter		*ret;
+	PBloomFilterHeader	*header;
+
+	if (P_UNLIKELY (image == NULL || size < P_BLOOM_FILTER_HEADER_SIZE))
+		return NULL;
+
+	if (P_UNLIKELY (((puintptr) image) % sizeof (puint64) != 0))
+		return NULL;
+
+	header = (PBloomFilterHeader *) image;
+
+	if (P_UNLIKELY (header->magic != P_BLOOM_FILTER_MAGIC ||
+			header->version != P_BLOOM_FILTER_VERSION))
+		return NULL;
+
+	if (P_UNLIKELY (header->nblocks == 0 ||
+			header->nblocks > P_BLOOM_FILTER_MAX_BLOCKS ||
+			header->nblocks > (size - P_BLOOM_FILTER_HEADER_SIZE) / P_BLOOM_FILTER_BLOCK_SIZE))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PBloomFilter))) == NULL)) {
+		P_ERROR ("PBloomFilter::zbloom_filter_new_from_image: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->mem     = NULL;
+	ret->header  = header;
+	ret->blocks  = (puint32 *) ((puchar *) image + P_BLOOM_FILTER_HEADER_SIZE);
+	ret->nblocks = header->nblocks;
+	ret->shared  = shared;
+
+	return ret;
+}
+
+P_LIB_API void
+zbloom_filter_insert (PBloomFilter	*filter,
+		      pconstpointer	data,
+		      psize		len)
+{
+	puint32	*block;
+	puint32	mask[P_BLOOM_FILTER_BLOCK_WORDS];
+	puint32	key;
+	pint	i;
+
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return;
+
+	block = pzbloom_filter_find_block (filter, data, len, &key);
+
+	if (filter->shared) {
+		pzbloom_filter_make_mask (key, mask);
+
+		for (i = 0; i < P_BLOOM_FILTER_BLOCK_WORDS; ++i)
+			zatomic_int_or ((volatile puint *) (block + i), mask[i]);
+
+		return;
+	}
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2)) {
+		pzbloom_filter_insert_avx2 (block, key);
+		return;
+	}
+#endif
+
+	pzbloom_filter_make_mask (key, mask);
+
+	for (i = 0; i < P_BLOOM_FILTER_BLOCK_WORDS; ++i)
+		block[i] |= mask[i];
+}
+
+P_LIB_API pboolean
+zbloom_filter_contains (const PBloomFilter	*filter,
+			pconstpointer		data,
+			psize			len)
+{
+	const puint32	*block;
+	puint32		mask[P_BLOOM_FILTER_BLOCK_WORDS];
+	puint32		key;
+	pint		i;
+
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	block = pzbloom_filter_find_block (filter, data, len, &key);
+
+	if (filter->shared) {
+		pzbloom_filter_make_mask (key, mask);
+
+		for (i = 0; i < P_BLOOM_FILTER_BLOCK_WORDS; ++i)
+			if ((((puint32) zatomic_int_get ((const volatile pint *) (block + i))) & mask[i]) != mask[i])
+				return FALSE;
+
+		return TRUE;
+	}
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		return pzbloom_filter_contains_avx2 (block, key);
+#endif
+
+	pzbloom_filter_make_mask (key, mask);
+
+	for (i = 0; i < P_BLOOM_FILTER_BLOCK_WORDS; ++i)
+		if ((block[i] & mask[i]) != mask[i])
+			return FALSE;
+
+	return TRUE;
+}
+
+P_LIB_API void
+zbloom_filter_clear (PBloomFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return;
+
+	memset (filter->blocks, 0, (psize) filter->nblocks * P_BLOOM_FILTER_BLOCK_SIZE);
+}
+
+P_LIB_API psize
+zbloom_filter_get_image_size (const PBloomFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return 0;
+
+	return P_BLOOM_FILTER_HEADER_SIZE + (psize) filter->nblocks * P_BLOOM_FILTER_BLOCK_SIZE;
+}
+
+P_LIB_API pboolean
+zbloom_filter_save_image (const PBloomFilter	*filter,
+			  ppointer		buf,
+			  psize			size)
+{
+	psize image_size;
+
+	if (P_UNLIKELY (filter == NULL || buf == NULL))
+		return FALSE;
+
+	image_size = zbloom_filter_get_image_size (filter);
+
+	if (P_UNLIKELY (size < image_size || ((puintptr) buf) % sizeof (puint64) != 0))
+		return FALSE;
+
+	if (buf != (ppointer) filter->header)
+		memmove (buf, filter->header, image_size);
+
+	return TRUE;
+}
+
+P_LIB_API void
+zbloom_filter_free (PBloomFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return;
+
+	zfree (filter->mem);
+	zfree (filter);
+}
@@ -0,0 +1,126 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pcpuinfo-private.h"
+
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+#  include <cpuid.h>
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+#  include <sys/auxv.h>
+#endif
+
+/* ARMv8 hardware capabilities from the Linux kernel */
+#define P_CPU_INFO_ARM_HWCAP_SHA1	(1 << 5)
+#define P_CPU_INFO_ARM_HWCAP_SHA2	(1 << 6)
+
+static puint pzcpu_info_features = 0;
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+static puint64 pzcpu_info_xgetbv (void);
+static puint pzcpu_info_detect_x86 (void);
+
+static puint64
+pzcpu_info_xgetbv (void)
+{
+	puint32 eax, edx;
+
+	__asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (0));
+
+	return ((puint64) edx << 32) | eax;
+}
+
+static puint
+pzcpu_info_detect_x86 (void)
+{
+	puint	eax, ebx, ecx, edx;
+	puint	max_leaf;
+	puint64	xcr0;
+	puint	ret = 0;
+
+	if (__get_cpuid (0, &max_leaf, &ebx, &ecx, &edx) == 0)
+		return 0;
+
+	__cpuid (1, eax, ebx, ecx, edx);
+
+	if (edx & (1 << 26))
+		ret |= P_CPU_FEATURE_SSE2;
+
+	if (ecx & (1 << 9))
+		ret |= P_CPU_FEATURE_SSSE3;
+
+	if (ecx & (1 << 19))
+		ret |= P_CPU_FEATURE_SSE41;
+
+	if (ecx & (1 << 23))
+		ret |= P_CPU_FEATURE_POPCNT;
+
+	/* AVX state must be enabled by the OS (OSXSAVE + XCR0), and AVX itself
+	 * must be reported, some hypervisors hide it while leaving AVX2 set */
+	xcr0 = ((ecx & (1 << 27)) && (ecx & (1 << 28))) ? pzcpu_info_xgetbv () : 0;
+
+	if (max_leaf < 7)
+		return ret;
+
+	__cpuid_count (7, 0, eax, ebx, ecx, edx);
+
+	if ((ebx & (1 << 5)) && (xcr0 & 0x06) == 0x06)
+		ret |= P_CPU_FEATURE_AVX2;
+
+	/* F, BW and VL subsets with opmask and ZMM state enabled */
+	if ((ebx & (1 << 16)) && (ebx & (1 << 30)) && (ebx & (1U << 31)) && (xcr0 & 0xE6) == 0xE6)
+		ret |= P_CPU_FEATURE_AVX512;
+
+	if (ebx & (1 << 29))
+		ret |= P_CPU_FEATURE_SHA;
+
+	return ret;
+}
+#endif
+
+void
+zcpu_info_init (void)
+{
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+	pzcpu_info_features = pzcpu_info_detect_x86 ();
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+	pulong hwcap = getauxval (AT_HWCAP);
+
+	pzcpu_info_features = 0;
+
+	if (hwcap & P_CPU_INFO_ARM_HWCAP_SHA1)
+		pzcpu_info_features |= P_CPU_FEATURE_ARM_SHA1;
+
+	if (hwcap & P_CPU_INFO_ARM_HWCAP_SHA2)
+		pzcpu_info_features |= P_CPU_FEATURE_ARM_SHA2;
+#else
+	pzcpu_info_features = 0;
+#endif
+}
+
+pboolean
+zcpu_info_has_feature (PCpuFeature feature)
+{
+	return (pzcpu_info_features & (puint) feature) != 0;
+}
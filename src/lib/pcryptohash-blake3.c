@@ -0,0 +1,994 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* BLAKE3 hash function, see the specification at
+ * https://github.com/BLAKE3-team/BLAKE3-specs
+ *
+ * The input is split into 1 KiB chunks which form a binary tree, so many
+ * chunks (and parent nodes) can be compressed in parallel. The SIMD kernels
+ * compress 4 (SSE4.1) or 8 (AVX2) inputs at once with one input per vector
+ * lane, large updates can also be split between several threads along the
+ * subtree boundaries. Only the default hashing mode with a 256-bit output is
+ * implemented. */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "pmem.h"
+#include "puthread.h"
+#include "pcryptohash-blake3.h"
+#include "pcpuinfo-private.h"
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+#  include <immintrin.h>
+#endif
+
+#define P_BLAKE3_CHUNK_LEN		1024
+#define P_BLAKE3_MAX_SIMD_DEGREE	8
+/* Subtrees smaller than this are not worth starting a thread for */
+#define P_BLAKE3_THREAD_MIN_LEN		(512 * 1024)
+
+#define P_BLAKE3_CHUNK_START		(1 << 0)
+#define P_BLAKE3_CHUNK_END		(1 << 1)
+#define P_BLAKE3_PARENT			(1 << 2)
+#define P_BLAKE3_ROOT			(1 << 3)
+
+/* Last block of a node, kept uncompressed because its flags depend on the
+ * position of the node in the tree */
+typedef struct PBlake3Output_ {
+	puint32		cv[8];
+	puchar		block[P_BLAKE3_BLOCK_LEN];
+	puint		block_len;
+	puint64		counter;
+	puint		flags;
+} PBlake3Output;
+
+typedef struct PBlake3Subtree_ {
+	const puchar	*input;
+	psize		len;
+	puint64		counter;
+	puchar		*out;
+	puint		threads;
+	psize		result;
+} PBlake3Subtree;
+
+static const puint32 pzcrypto_hash_blake3_IV[8] = {
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+	0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static const puchar pzcrypto_hash_blake3_schedule[7][16] = {
+	{ 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+	{ 2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8},
+	{ 3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1},
+	{10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6},
+	{12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4},
+	{ 9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7},
+	{11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13}
+};
+
+static puint32 pzcrypto_hash_blake3_load32 (const puchar *src);
+static void pzcrypto_hash_blake3_store32 (puchar *dst, puint32 val);
+static void pzcrypto_hash_blake3_store_cv (puchar *dst, const puint32 cv[8]);
+static void pzcrypto_hash_blake3_compress (puint32 cv[8], const puchar block[64], puint block_len, puint64 counter, puint flags);
+static void pzcrypto_hash_blake3_hash_many_portable (const puchar * const *inputs, psize num, psize blocks, puint64 counter,
+						     pboolean increment, puint flags, puint flags_start, puint flags_end, puchar *out);
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+static P_CPU_TARGET ("sse4.1") void pzcrypto_hash_blake3_hash4_sse41 (const puchar * const *inputs, psize blocks, puint64 counter,
+								     pboolean increment, puint flags, puint flags_start, puint flags_end, puchar *out);
+static P_CPU_TARGET ("avx2") void pzcrypto_hash_blake3_hash8_avx2 (const puchar * const *inputs, psize blocks, puint64 counter,
+								  pboolean increment, puint flags, puint flags_start, puint flags_end, puchar *out);
+#endif
+static void pzcrypto_hash_blake3_hash_many (const puchar * const *inputs, psize num, psize blocks, puint64 counter,
+					    pboolean increment, puint flags, puint flags_start, puint flags_end, puchar *out);
+static psize pzcrypto_hash_blake3_simd_degree (void);
+static void pzcrypto_hash_blake3_chunk_init (PBlake3Chunk *chunk, puint64 counter);
+static psize pzcrypto_hash_blake3_chunk_len (const PBlake3Chunk *chunk);
+static void pzcrypto_hash_blake3_chunk_update (PBlake3Chunk *chunk, const puchar *data, psize len);
+static void pzcrypto_hash_blake3_chunk_output (const PBlake3Chunk *chunk, PBlake3Output *output);
+static void pzcrypto_hash_blake3_parent_output (const puchar block[64], PBlake3Output *output);
+static void pzcrypto_hash_blake3_output_cv (const PBlake3Output *output, puchar cv[32]);
+static psize pzcrypto_hash_blake3_compress_chunks (const puchar *input, psize len, puint64 counter, puchar *out);
+static psize pzcrypto_hash_blake3_compress_parents (const puchar *cvs, psize num, puchar *out);
+static ppointer pzcrypto_hash_blake3_subtree_thread (ppointer data);
+static psize pzcrypto_hash_blake3_compress_subtree (const puchar *input, psize len, puint64 counter, puchar *out, puint threads);
+static void pzcrypto_hash_blake3_subtree_to_parent (const puchar *input, psize len, puint64 counter, puchar out[64], puint threads);
+static void pzcrypto_hash_blake3_merge_cv_stack (PHashBLAKE3 *ctx, puint64 total_chunks);
+static void pzcrypto_hash_blake3_push_cv (PHashBLAKE3 *ctx, const puchar cv[32], puint64 counter);
+
+static puint32
+pzcrypto_hash_blake3_load32 (const puchar *src)
+{
+	return ((puint32) src[0])       | ((puint32) src[1] << 8) |
+	       ((puint32) src[2] << 16) | ((puint32) src[3] << 24);
+}
+
+static void
+pzcrypto_hash_blake3_store32 (puchar *dst, puint32 val)
+{
+	dst[0] = (puchar) val;
+	dst[1] = (puchar) (val >> 8);
+	dst[2] = (puchar) (val >> 16);
+	dst[3] = (puchar) (val >> 24);
+}
+
+static void
+pzcrypto_hash_blake3_store_cv (puchar *dst, const puint32 cv[8])
+{
+	puint i;
+
+	for (i = 0; i < 8; ++i)
+		pzcrypto_hash_blake3_store32 (dst + i * 4, cv[i]);
+}
+
+#define P_BLAKE3_ROTR(val, shift) (((val) >> (shift)) | ((val) << (32 - (shift))))
+
+#define P_BLAKE3_G(a, b, c, d, x, y)			\
+{							\
+	a = a + b + (x);				\
+	d = P_BLAKE3_ROTR (d ^ a, 16);			\
+	c = c + d;					\
+	b = P_BLAKE3_ROTR (b ^ c, 12);			\
+	a = a + b + (y);				\
+	d = P_BLAKE3_ROTR (d ^ a, 8);			\
+	c = c + d;					\
+	b = P_BLAKE3_ROTR (b ^ c, 7);			\
+}
+
+static void
+pzcrypto_hash_blake3_compress (puint32		cv[8],
+			       const puchar	block[64],
+			       puint		block_len,
+			       puint64		counter,
+			       puint		flags)
+{
+	const puchar	*s;
+	puint32		m[16];
+	puint32		v[16];
+	puint		i;
+
+	for (i = 0; i < 16; ++i)
+		m[i] = pzcrypto_hash_blake3_load32 (block + i * 4);
+
+	for (i = 0; i < 8; ++i)
+		v[i] = cv[i];
+
+	v[8]  = pzcrypto_hash_blake3_IV[0];
+	v[9]  = pzcrypto_hash_blake3_IV[1];
+	v[10] = pzcrypto_hash_blake3_IV[2];
+	v[11] = pzcrypto_hash_blake3_IV[3];
+	v[12] = (puint32) counter;
+	v[13] = (puint32) (counter >> 32);
+	v[14] = (puint32) block_len;
+	v[15] = (puint32) flags;
+
+	for (i = 0; i < 7; ++i) {
+		s = pzcrypto_hash_blake3_schedule[i];
+
+		P_BLAKE3_G (v[0], v[4], v[8],  v[12], m[s[0]],  m[s[1]]);
+		P_BLAKE3_G (v[1], v[5], v[9],  v[13], m[s[2]],  m[s[3]]);
+		P_BLAKE3_G (v[2], v[6], v[10], v[14], m[s[4]],  m[s[5]]);
+		P_BLAKE3_G (v[3], v[7], v[11], v[15], m[s[6]],  m[s[7]]);
+		P_BLAKE3_G (v[0], v[5], v[10], v[15], m[s[8]],  m[s[9]]);
+		P_BLAKE3_G (v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+		P_BLAKE3_G (v[2], v[7], v[8],  v[13], m[s[12]], m[s[13]]);
+		P_BLAKE3_G (v[3], v[4], v[9],  v[14], m[s[14]], m[s[15]]);
+	}
+
+	for (i = 0; i < 8; ++i)
+		cv[i] = v[i] ^ v[i + 8];
+}
+
+/* Compresses @a num inputs of @a blocks full blocks each, every input is
+ * either a chunk or a parent node and produces one chaining value */
+static void
+pzcrypto_hash_blake3_hash_many_portable (const puchar * const	*inputs,
+					 psize			num,
+					 psize			blocks,
+					 puint64		counter,
+					 pboolean		increment,
+					 puint			flags,
+					 puint			flags_start,
+					 puint			flags_end,
+					 puchar			*out)
+{
+	puint32	cv[8];
+	puint	block_flags;
+	psize	i, j;
+
+	for (i = 0; i < num; ++i) {
+		memcpy (cv, pzcrypto_hash_blake3_IV, sizeof (cv));
+
+		block_flags = flags | flags_start;
+
+		for (j = 0; j < blocks; ++j) {
+			if (j + 1 == blocks)
+				block_flags |= flags_end;
+
+			pzcrypto_hash_blake3_compress (cv,
+						       inputs[i] + j * P_BLAKE3_BLOCK_LEN,
+						       P_BLAKE3_BLOCK_LEN,
+						       counter,
+						       block_flags);
+
+			block_flags = flags;
+		}
+
+		pzcrypto_hash_blake3_store_cv (out + i * P_BLAKE3_OUT_LEN, cv);
+
+		if (increment)
+			++counter;
+	}
+}
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+#define P_BLAKE3_G_SSE41(a, b, c, d, x, y)								\
+{													\
+	a = _mm_add_epi32 (_mm_add_epi32 (a, b), x);							\
+	d = _mm_shuffle_epi8 (_mm_xor_si128 (d, a), rot16);						\
+	c = _mm_add_epi32 (c, d);									\
+	b = _mm_xor_si128 (b, c);									\
+	b = _mm_or_si128 (_mm_srli_epi32 (b, 12), _mm_slli_epi32 (b, 20));				\
+	a = _mm_add_epi32 (_mm_add_epi32 (a, b), y);							\
+	d = _mm_shuffle_epi8 (_mm_xor_si128 (d, a), rot8);						\
+	c = _mm_add_epi32 (c, d);									\
+	b = _mm_xor_si128 (b, c);									\
+	b = _mm_or_si128 (_mm_srli_epi32 (b, 7), _mm_slli_epi32 (b, 25));				\
+}
+
+#define P_BLAKE3_TRANSPOSE4_SSE41(r0, r1, r2, r3)							\
+{													\
+	__m128i	t0 = _mm_unpacklo_epi32 (r0, r1);							\
+	__m128i	t1 = _mm_unpackhi_epi32 (r0, r1);							\
+	__m128i	t2 = _mm_unpacklo_epi32 (r2, r3);							\
+	__m128i	t3 = _mm_unpackhi_epi32 (r2, r3);							\
+	r0 = _mm_unpacklo_epi64 (t0, t2);								\
+	r1 = _mm_unpackhi_epi64 (t0, t2);								\
+	r2 = _mm_unpacklo_epi64 (t1, t3);								\
+	r3 = _mm_unpackhi_epi64 (t1, t3);								\
+}
+
+/* Four inputs at once, every vector holds the same state word of all the
+ * inputs */
+static P_CPU_TARGET ("sse4.1") void
+pzcrypto_hash_blake3_hash4_sse41 (const puchar * const	*inputs,
+				  psize			blocks,
+				  puint64		counter,
+				  pboolean		increment,
+				  puint			flags,
+				  puint			flags_start,
+				  puint			flags_end,
+				  puchar		*out)
+{
+	__m128i		h[8];
+	__m128i		m[16];
+	__m128i		v[16];
+	__m128i		ctr_low, ctr_high;
+	__m128i		rot16, rot8;
+	puint32		low[4], high[4];
+	const puchar	*s;
+	puint		block_flags;
+	psize		i, j;
+
+	rot16 = _mm_set_epi8 (13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+	rot8  = _mm_set_epi8 (12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1);
+
+	for (i = 0; i < 4; ++i) {
+		low[i]  = (puint32) (counter + (increment ? i : 0));
+		high[i] = (puint32) ((counter + (increment ? i : 0)) >> 32);
+	}
+
+	ctr_low  = _mm_loadu_si128 ((const __m128i *) low);
+	ctr_high = _mm_loadu_si128 ((const __m128i *) high);
+
+	for (i = 0; i < 8; ++i)
+		h[i] = _mm_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[i]);
+
+	block_flags = flags | flags_start;
+
+	for (j = 0; j < blocks; ++j) {
+		if (j + 1 == blocks)
+			block_flags |= flags_end;
+
+		for (i = 0; i < 4; ++i) {
+			m[i * 4 + 0] = _mm_loadu_si128 ((const __m128i *) (inputs[0] + j * P_BLAKE3_BLOCK_LEN + i * 16));
+			m[i * 4 + 1] = _mm_loadu_si128 ((const __m128i *) (inputs[1] + j * P_BLAKE3_BLOCK_LEN + i * 16));
+			m[i * 4 + 2] = _mm_loadu_si128 ((const __m128i *) (inputs[2] + j * P_BLAKE3_BLOCK_LEN + i * 16));
+			m[i * 4 + 3] = _mm_loadu_si128 ((const __m128i *) (inputs[3] + j * P_BLAKE3_BLOCK_LEN + i * 16));
+
+			P_BLAKE3_TRANSPOSE4_SSE41 (m[i * 4 + 0], m[i * 4 + 1], m[i * 4 + 2], m[i * 4 + 3]);
+		}
+
+		for (i = 0; i < 8; ++i)
+			v[i] = h[i];
+
+		v[8]  = _mm_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[0]);
+		v[9]  = _mm_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[1]);
+		v[10] = _mm_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[2]);
+		v[11] = _mm_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[3]);
+		v[12] = ctr_low;
+		v[13] = ctr_high;
+		v[14] = _mm_set1_epi32 (P_BLAKE3_BLOCK_LEN);
+		v[15] = _mm_set1_epi32 ((pint) block_flags);
+
+		for (i = 0; i < 7; ++i) {
+			s = pzcrypto_hash_blake3_schedule[i];
+
+			P_BLAKE3_G_SSE41 (v[0], v[4], v[8],  v[12], m[s[0]],  m[s[1]]);
+			P_BLAKE3_G_SSE41 (v[1], v[5], v[9],  v[13], m[s[2]],  m[s[3]]);
+			P_BLAKE3_G_SSE41 (v[2], v[6], v[10], v[14], m[s[4]],  m[s[5]]);
+			P_BLAKE3_G_SSE41 (v[3], v[7], v[11], v[15], m[s[6]],  m[s[7]]);
+			P_BLAKE3_G_SSE41 (v[0], v[5], v[10], v[15], m[s[8]],  m[s[9]]);
+			P_BLAKE3_G_SSE41 (v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+			P_BLAKE3_G_SSE41 (v[2], v[7], v[8],  v[13], m[s[12]], m[s[13]]);
+			P_BLAKE3_G_SSE41 (v[3], v[4], v[9],  v[14], m[s[14]], m[s[15]]);
+		}
+
+		for (i = 0; i < 8; ++i)
+			h[i] = _mm_xor_si128 (v[i], v[i + 8]);
+
+		block_flags = flags;
+	}
+
+	P_BLAKE3_TRANSPOSE4_SSE41 (h[0], h[1], h[2], h[3]);
+	P_BLAKE3_TRANSPOSE4_SSE41 (h[4], h[5], h[6], h[7]);
+
+	for (i = 0; i < 4; ++i) {
+		_mm_storeu_si128 ((__m128i *) (out + i * P_BLAKE3_OUT_LEN),      h[i]);
+		_mm_storeu_si128 ((__m128i *) (out + i * P_BLAKE3_OUT_LEN + 16), h[i + 4]);
+	}
+}
+
+#define P_BLAKE3_G_AVX2(a, b, c, d, x, y)								\
+{													\
+	a = _mm256_add_epi32 (_mm256_add_epi32 (a, b), x);						\
+	d = _mm256_shuffle_epi8 (_mm256_xor_si256 (d, a), rot16);					\
+	c = _mm256_add_epi32 (c, d);									\
+	b = _mm256_xor_si256 (b, c);									\
+	b = _mm256_or_si256 (_mm256_srli_epi32 (b, 12), _mm256_slli_epi32 (b, 20));			\
+	a = _mm256_add_epi32 (_mm256_add_epi32 (a, b), y);						\
+	d = _mm256_shuffle_epi8 (_mm256_xor_si256 (d, a), rot8);					\
+	c = _mm256_add_epi32 (c, d);									\
+	b = _mm256_xor_si256 (b, c);									\
+	b = _mm256_or_si256 (_mm256_srli_epi32 (b, 7), _mm256_slli_epi32 (b, 25));			\
+}
+
+/* Transposes the 8x8 matrix of 32-bit words in place */
+#define P_BLAKE3_TRANSPOSE8_AVX2(r)									\
+{													\
+	__m256i	t[8];											\
+	__m256i	u[8];											\
+	puint	k;											\
+													\
+	for (k = 0; k < 8; k += 2) {									\
+		t[k]     = _mm256_unpacklo_epi32 (r[k], r[k + 1]);					\
+		t[k + 1] = _mm256_unpackhi_epi32 (r[k], r[k + 1]);					\
+	}												\
+													\
+	for (k = 0; k < 8; k += 4) {									\
+		u[k]     = _mm256_unpacklo_epi64 (t[k],     t[k + 2]);					\
+		u[k + 1] = _mm256_unpackhi_epi64 (t[k],     t[k + 2]);					\
+		u[k + 2] = _mm256_unpacklo_epi64 (t[k + 1], t[k + 3]);					\
+		u[k + 3] = _mm256_unpackhi_epi64 (t[k + 1], t[k + 3]);					\
+	}												\
+													\
+	for (k = 0; k < 4; ++k) {									\
+		r[k]     = _mm256_permute2x128_si256 (u[k], u[k + 4], 0x20);				\
+		r[k + 4] = _mm256_permute2x128_si256 (u[k], u[k + 4], 0x31);				\
+	}												\
+}
+
+/* The same as the SSE4.1 version, but with eight inputs */
+static P_CPU_TARGET ("avx2") void
+pzcrypto_hash_blake3_hash8_avx2 (const puchar * const	*inputs,
+				 psize			blocks,
+				 puint64		counter,
+				 pboolean		increment,
+				 puint			flags,
+				 puint			flags_start,
+				 puint			flags_end,
+				 puchar			*out)
+{
+	__m256i		h[8];
+	__m256i		m[16];
+	__m256i		v[16];
+	__m256i		ctr_low, ctr_high;
+	__m256i		rot16, rot8;
+	puint32		low[8], high[8];
+	const puchar	*s;
+	puint		block_flags;
+	psize		i, j;
+
+	rot16 = _mm256_set_epi8 (13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+				 13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+	rot8  = _mm256_set_epi8 (12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1,
+				 12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1);
+
+	for (i = 0; i < 8; ++i) {
+		low[i]  = (puint32) (counter + (increment ? i : 0));
+		high[i] = (puint32) ((counter + (increment ? i : 0)) >> 32);
+	}
+
+	ctr_low  = _mm256_loadu_si256 ((const __m256i *) low);
+	ctr_high = _mm256_loadu_si256 ((const __m256i *) high);
+
+	for (i = 0; i < 8; ++i)
+		h[i] = _mm256_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[i]);
+
+	block_flags = flags | flags_start;
+
+	for (j = 0; j < blocks; ++j) {
+		if (j + 1 == blocks)
+			block_flags |= flags_end;
+
+		for (i = 0; i < 8; ++i) {
+			m[i]     = _mm256_loadu_si256 ((const __m256i *) (inputs[i] + j * P_BLAKE3_BLOCK_LEN));
+			m[i + 8] = _mm256_loadu_si256 ((const __m256i *) (inputs[i] + j * P_BLAKE3_BLOCK_LEN + 32));
+		}
+
+		P_BLAKE3_TRANSPOSE8_AVX2 (m);
+		P_BLAKE3_TRANSPOSE8_AVX2 ((m + 8));
+
+		for (i = 0; i < 8; ++i)
+			v[i] = h[i];
+
+		v[8]  = _mm256_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[0]);
+		v[9]  = _mm256_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[1]);
+		v[10] = _mm256_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[2]);
+		v[11] = _mm256_set1_epi32 ((pint) pzcrypto_hash_blake3_IV[3]);
+		v[12] = ctr_low;
+		v[13] = ctr_high;
+		v[14] = _mm256_set1_epi32 (P_BLAKE3_BLOCK_LEN);
+		v[15] = _mm256_set1_epi32 ((pint) block_flags);
+
+		for (i = 0; i < 7; ++i) {
+			s = pzcrypto_hash_blake3_schedule[i];
+
+			P_BLAKE3_G_AVX2 (v[0], v[4], v[8],  v[12], m[s[0]],  m[s[1]]);
+			P_BLAKE3_G_AVX2 (v[1], v[5], v[9],  v[13], m[s[2]],  m[s[3]]);
+			P_BLAKE3_G_AVX2 (v[2], v[6], v[10], v[14], m[s[4]],  m[s[5]]);
+			P_BLAKE3_G_AVX2 (v[3], v[7], v[11], v[15], m[s[6]],  m[s[7]]);
+			P_BLAKE3_G_AVX2 (v[0], v[5], v[10], v[15], m[s[8]],  m[s[9]]);
+			P_BLAKE3_G_AVX2 (v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+			P_BLAKE3_G_AVX2 (v[2], v[7], v[8],  v[13], m[s[12]], m[s[13]]);
+			P_BLAKE3_G_AVX2 (v[3], v[4], v[9],  v[14], m[s[14]], m[s[15]]);
+		}
+
+		for (i = 0; i < 8; ++i)
+			h[i] = _mm256_xor_si256 (v[i], v[i + 8]);
+
+		block_flags = flags;
+	}
+
+	P_BLAKE3_TRANSPOSE8_AVX2 (h);
+
+	for (i = 0; i < 8; ++i)
+		_mm256_storeu_si256 ((__m256i *) (out + i * P_BLAKE3_OUT_LEN), h[i]);
+}
+#endif
+
+static void
+pzcrypto_hash_blake3_hash_many (const puchar * const	*inputs,
+				psize			num,
+				psize			blocks,
+				puint64			counter,
+				pboolean		increment,
+				puint			flags,
+				puint			flags_start,
+				puint			flags_end,
+				puchar			*out)
+{
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2)) {
+		while (num >= 8) {
+			pzcrypto_hash_blake3_hash8_avx2 (inputs, blocks, counter, increment, flags, flags_start, flags_end, out);
+
+			if (increment)
+				counter += 8;
+
+			inputs += 8;
+			num    -= 8;
+			out    += 8 * P_BLAKE3_OUT_LEN;
+		}
+	}
+
+	if (zcpu_info_has_feature (P_CPU_FEATURE_SSE41)) {
+		while (num >= 4) {
+			pzcrypto_hash_blake3_hash4_sse41 (inputs, blocks, counter, increment, flags, flags_start, flags_end, out);
+
+			if (increment)
+				counter += 4;
+
+			inputs += 4;
+			num    -= 4;
+			out    += 4 * P_BLAKE3_OUT_LEN;
+		}
+	}
+#endif
+
+	pzcrypto_hash_blake3_hash_many_portable (inputs, num, blocks, counter, increment, flags, flags_start, flags_end, out);
+}
+
+static psize
+pzcrypto_hash_blake3_simd_degree (void)
+{
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		return 8;
+
+	if (zcpu_info_has_feature (P_CPU_FEATURE_SSE41))
+		return 4;
+#endif
+
+	return 1;
+}
+
+static void
+pzcrypto_hash_blake3_chunk_init (PBlake3Chunk	*chunk,
+				 puint64	counter)
+{
+	memcpy (chunk->cv, pzcrypto_hash_blake3_IV, sizeof (chunk->cv));
+	memset (chunk->buf, 0, sizeof (chunk->buf));
+
+	chunk->counter           = counter;
+	chunk->buf_len           = 0;
+	chunk->blocks_compressed = 0;
+}
+
+static psize
+pzcrypto_hash_blake3_chunk_len (const PBlake3Chunk *chunk)
+{
+	return (psize) chunk->blocks_compressed * P_BLAKE3_BLOCK_LEN + chunk->buf_len;
+}
+
+/* The last block of a chunk stays in the buffer until it is known whether
+ * there is more data */
+static void
+pzcrypto_hash_blake3_chunk_update (PBlake3Chunk	*chunk,
+				   const puchar	*data,
+				   psize	len)
+{
+	psize to_fill;
+
+	if (chunk->buf_len > 0) {
+		to_fill = P_BLAKE3_BLOCK_LEN - chunk->buf_len;
+
+		if (to_fill > len)
+			to_fill = len;
+
+		memcpy (chunk->buf + chunk->buf_len, data, to_fill);
+
+		chunk->buf_len += (puint) to_fill;
+		data           += to_fill;
+		len            -= to_fill;
+
+		if (len == 0)
+			return;
+
+		pzcrypto_hash_blake3_compress (chunk->cv,
+					       chunk->buf,
+					       P_BLAKE3_BLOCK_LEN,
+					       chunk->counter,
+					       chunk->blocks_compressed == 0 ? P_BLAKE3_CHUNK_START : 0);
+
+		++chunk->blocks_compressed;
+		chunk->buf_len = 0;
+		memset (chunk->buf, 0, sizeof (chunk->buf));
+	}
+
+	while (len > P_BLAKE3_BLOCK_LEN) {
+		pzcrypto_hash_blake3_compress (chunk->cv,
+					       data,
+					       P_BLAKE3_BLOCK_LEN,
+					       chunk->counter,
+					       chunk->blocks_compressed == 0 ? P_BLAKE3_CHUNK_START : 0);
+
+		++chunk->blocks_compressed;
+		data += P_BLAKE3_BLOCK_LEN;
+		len  -= P_BLAKE3_BLOCK_LEN;
+	}
+
+	memcpy (chunk->buf, data, len);
+	chunk->buf_len = (puint) len;
+}
+
+static void
+pzcrypto_hash_blake3_chunk_output (const PBlake3Chunk	*chunk,
+				   PBlake3Output	*output)
+{
+	memcpy (output->cv, chunk->cv, sizeof (output->cv));
+	memcpy (output->block, chunk->buf, P_BLAKE3_BLOCK_LEN);
+
+	output->block_len = chunk->buf_len;
+	output->counter   = chunk->counter;
+	output->flags     = P_BLAKE3_CHUNK_END | (chunk->blocks_compressed == 0 ? P_BLAKE3_CHUNK_START : 0);
+}
+
+static void
+pzcrypto_hash_blake3_parent_output (const puchar	block[64],
+				    PBlake3Output	*output)
+{
+	memcpy (output->cv, pzcrypto_hash_blake3_IV, sizeof (output->cv));
+	memcpy (output->block, block, P_BLAKE3_BLOCK_LEN);
+
+	output->block_len = P_BLAKE3_BLOCK_LEN;
+	output->counter   = 0;
+	output->flags     = P_BLAKE3_PARENT;
+}
+
+static void
+pzcrypto_hash_blake3_output_cv (const PBlake3Output	*output,
+				puchar			cv[32])
+{
+	puint32 words[8];
+
+	memcpy (words, output->cv, sizeof (words));
+
+	pzcrypto_hash_blake3_compress (words, output->block, output->block_len, output->counter, output->flags);
+	pzcrypto_hash_blake3_store_cv (cv, words);
+}
+
+/* Compresses the full chunks of the input in parallel, the last partial
+ * chunk (if any) is hashed separately. Returns the number of chaining
+ * values written. */
+static psize
+pzcrypto_hash_blake3_compress_chunks (const puchar	*input,
+				      psize		len,
+				      puint64		counter,
+				      puchar		*out)
+{
+	const puchar	*chunks[P_BLAKE3_MAX_SIMD_DEGREE];
+	PBlake3Chunk	chunk;
+	PBlake3Output	output;
+	psize		num;
+	psize		pos;
+
+	for (num = 0, pos = 0; len - pos >= P_BLAKE3_CHUNK_LEN; ++num, pos += P_BLAKE3_CHUNK_LEN)
+		chunks[num] = input + pos;
+
+	pzcrypto_hash_blake3_hash_many (chunks,
+					num,
+					P_BLAKE3_CHUNK_LEN / P_BLAKE3_BLOCK_LEN,
+					counter,
+					TRUE,
+					0,
+					P_BLAKE3_CHUNK_START,
+					P_BLAKE3_CHUNK_END,
+					out);
+
+	if (len == pos)
+		return num;
+
+	pzcrypto_hash_blake3_chunk_init (&chunk, counter + num);
+	pzcrypto_hash_blake3_chunk_update (&chunk, input + pos, len - pos);
+	pzcrypto_hash_blake3_chunk_output (&chunk, &output);
+	pzcrypto_hash_blake3_output_cv (&output, out + num * P_BLAKE3_OUT_LEN);
+
+	return num + 1;
+}
+
+/* Combines pairs of chaining values into parents, an odd one is passed
+ * through as is */
+static psize
+pzcrypto_hash_blake3_compress_parents (const puchar	*cvs,
+				       psize		num,
+				       puchar		*out)
+{
+	const puchar	*parents[P_BLAKE3_MAX_SIMD_DEGREE];
+	psize		count;
+
+	for (count = 0; num - count * 2 >= 2; ++count)
+		parents[count] = cvs + count * 2 * P_BLAKE3_OUT_LEN;
+
+	pzcrypto_hash_blake3_hash_many (parents, count, 1, 0, FALSE, P_BLAKE3_PARENT, 0, 0, out);
+
+	if (num == count * 2)
+		return count;
+
+	memcpy (out + count * P_BLAKE3_OUT_LEN, cvs + count * 2 * P_BLAKE3_OUT_LEN, P_BLAKE3_OUT_LEN);
+
+	return count + 1;
+}
+
+static ppointer
+pzcrypto_hash_blake3_subtree_thread (ppointer data)
+{
+	PBlake3Subtree *task = (PBlake3Subtree *) data;
+
+	task->result = pzcrypto_hash_blake3_compress_subtree (task->input,
+							      task->len,
+							      task->counter,
+							      task->out,
+							      task->threads);
+
+	return NULL;
+}
+
+/* Hashes a subtree down to at most the SIMD degree of chaining values (but
+ * at least two if there is more than one chunk), so the parents of the
+ * upper levels can still be compressed in parallel. The left half goes to
+ * another thread if the subtree is large enough and @a threads allows. */
+static psize
+pzcrypto_hash_blake3_compress_subtree (const puchar	*input,
+				       psize		len,
+				       puint64		counter,
+				       puchar		*out,
+				       puint		threads)
+{
+	puchar		cvs[2 * P_BLAKE3_MAX_SIMD_DEGREE * P_BLAKE3_OUT_LEN];
+	PBlake3Subtree	left;
+	PUThread	*thread;
+	psize		degree;
+	psize		left_len;
+	psize		left_chunks;
+	psize		right_num;
+
+	degree = pzcrypto_hash_blake3_simd_degree ();
+
+	if (len <= degree * P_BLAKE3_CHUNK_LEN)
+		return pzcrypto_hash_blake3_compress_chunks (input, len, counter, out);
+
+	/* The left subtree is the largest power of two number of full chunks
+	 * which leaves at least one byte for the right one */
+	left_chunks = (len - 1) / P_BLAKE3_CHUNK_LEN;
+
+	while ((left_chunks & (left_chunks - 1)) != 0)
+		left_chunks &= left_chunks - 1;
+
+	left_len = left_chunks * P_BLAKE3_CHUNK_LEN;
+
+	if (degree == 1)
+		degree = 2;
+
+	left.input   = input;
+	left.len     = left_len;
+	left.counter = counter;
+	left.out     = cvs;
+	left.threads = threads / 2;
+	left.result  = 0;
+
+	thread = NULL;
+
+	if (threads > 1 && len >= P_BLAKE3_THREAD_MIN_LEN)
+		thread = zuthread_create (pzcrypto_hash_blake3_subtree_thread, &left, TRUE, NULL);
+
+	right_num = pzcrypto_hash_blake3_compress_subtree (input + left_len,
+							   len - left_len,
+							   counter + left_chunks,
+							   cvs + degree * P_BLAKE3_OUT_LEN,
+							   thread != NULL ? threads - threads / 2 : threads);
+
+	if (thread != NULL) {
+		zuthread_join (thread);
+		zuthread_unref (thread);
+	} else
+		pzcrypto_hash_blake3_subtree_thread (&left);
+
+	/* The left subtree is a single chunk only when the SIMD degree is one */
+	if (left.result == 1) {
+		memcpy (out, cvs, P_BLAKE3_OUT_LEN);
+		memcpy (out + P_BLAKE3_OUT_LEN, cvs + degree * P_BLAKE3_OUT_LEN, P_BLAKE3_OUT_LEN);
+		return 2;
+	}
+
+	/* Both halves are complete, so the chaining values are contiguous */
+	if (left.result < degree)
+		memmove (cvs + left.result * P_BLAKE3_OUT_LEN, cvs + degree * P_BLAKE3_OUT_LEN, right_num * P_BLAKE3_OUT_LEN);
+
+	return pzcrypto_hash_blake3_compress_parents (cvs, left.result + right_num, out);
+}
+
+static void
+pzcrypto_hash_blake3_subtree_to_parent (const puchar	*input,
+					psize		len,
+					puint64		counter,
+					puchar		out[64],
+					puint		threads)
+{
+	puchar	cvs[P_BLAKE3_MAX_SIMD_DEGREE * P_BLAKE3_OUT_LEN];
+	puchar	parents[P_BLAKE3_MAX_SIMD_DEGREE * P_BLAKE3_OUT_LEN / 2];
+	psize	num;
+
+	num = pzcrypto_hash_blake3_compress_subtree (input, len, counter, cvs, threads);
+
+	while (num > 2) {
+		num = pzcrypto_hash_blake3_compress_parents (cvs, num, parents);
+		memcpy (cvs, parents, num * P_BLAKE3_OUT_LEN);
+	}
+
+	memcpy (out, cvs, 2 * P_BLAKE3_OUT_LEN);
+}
+
+/* Merges the completed subtrees on the stack, the number of them left is the
+ * number of set bits in the total chunk count. The merging is lazy because
+ * the root node must not be compressed before finishing. */
+static void
+pzcrypto_hash_blake3_merge_cv_stack (PHashBLAKE3	*ctx,
+				     puint64		total_chunks)
+{
+	PBlake3Output	output;
+	puchar		*block;
+	puint		subtrees;
+
+	for (subtrees = 0; total_chunks != 0; ++subtrees)
+		total_chunks &= total_chunks - 1;
+
+	while (ctx->cv_stack_len > subtrees) {
+		block = ctx->cv_stack + (ctx->cv_stack_len - 2) * P_BLAKE3_OUT_LEN;
+
+		pzcrypto_hash_blake3_parent_output (block, &output);
+		pzcrypto_hash_blake3_output_cv (&output, block);
+
+		--ctx->cv_stack_len;
+	}
+}
+
+static void
+pzcrypto_hash_blake3_push_cv (PHashBLAKE3	*ctx,
+			      const puchar	cv[32],
+			      puint64		counter)
+{
+	pzcrypto_hash_blake3_merge_cv_stack (ctx, counter);
+
+	memcpy (ctx->cv_stack + ctx->cv_stack_len * P_BLAKE3_OUT_LEN, cv, P_BLAKE3_OUT_LEN);
+	++ctx->cv_stack_len;
+}
+
+void
+zcrypto_hash_blake3_init (PHashBLAKE3 *ctx)
+{
+	ctx->threads = 0;
+
+	zcrypto_hash_blake3_reset (ctx);
+}
+
+void
+zcrypto_hash_blake3_update (PHashBLAKE3		*ctx,
+			    const puchar	*data,
+			    psize		len)
+{
+	PBlake3Chunk	chunk;
+	PBlake3Output	output;
+	puchar		cvs[2 * P_BLAKE3_OUT_LEN];
+	psize		to_fill;
+	psize		subtree_len;
+	puint64		subtree_chunks;
+
+	if (pzcrypto_hash_blake3_chunk_len (&ctx->chunk) > 0) {
+		to_fill = P_BLAKE3_CHUNK_LEN - pzcrypto_hash_blake3_chunk_len (&ctx->chunk);
+
+		if (to_fill > len)
+			to_fill = len;
+
+		pzcrypto_hash_blake3_chunk_update (&ctx->chunk, data, to_fill);
+
+		data += to_fill;
+		len  -= to_fill;
+
+		if (len == 0)
+			return;
+
+		pzcrypto_hash_blake3_chunk_output (&ctx->chunk, &output);
+		pzcrypto_hash_blake3_output_cv (&output, cvs);
+		pzcrypto_hash_blake3_push_cv (ctx, cvs, ctx->chunk.counter);
+		pzcrypto_hash_blake3_chunk_init (&ctx->chunk, ctx->chunk.counter + 1);
+	}
+
+	/* Hash the largest complete subtrees in place, the last chunk is kept
+	 * for the finish */
+	while (len > P_BLAKE3_CHUNK_LEN) {
+		subtree_len = len;
+
+		while ((subtree_len & (subtree_len - 1)) != 0)
+			subtree_len &= subtree_len - 1;
+
+		/* The subtree must be aligned with the chunks hashed so far */
+		while ((((puint64) subtree_len - 1) & (ctx->chunk.counter * P_BLAKE3_CHUNK_LEN)) != 0)
+			subtree_len /= 2;
+
+		subtree_chunks = subtree_len / P_BLAKE3_CHUNK_LEN;
+
+		if (subtree_len <= P_BLAKE3_CHUNK_LEN) {
+			pzcrypto_hash_blake3_chunk_init (&chunk, ctx->chunk.counter);
+			pzcrypto_hash_blake3_chunk_update (&chunk, data, subtree_len);
+			pzcrypto_hash_blake3_chunk_output (&chunk, &output);
+			pzcrypto_hash_blake3_output_cv (&output, cvs);
+			pzcrypto_hash_blake3_push_cv (ctx, cvs, chunk.counter);
+		} else {
+			pzcrypto_hash_blake3_subtree_to_parent (data, subtree_len, ctx->chunk.counter, cvs, ctx->threads);
+			pzcrypto_hash_blake3_push_cv (ctx, cvs, ctx->chunk.counter);
+			pzcrypto_hash_blake3_push_cv (ctx, cvs + P_BLAKE3_OUT_LEN, ctx->chunk.counter + subtree_chunks / 2);
+		}
+
+		ctx->chunk.counter += subtree_chunks;
+
+		data += subtree_len;
+		len  -= subtree_len;
+	}
+
+	if (len > 0) {
+		pzcrypto_hash_blake3_chunk_update (&ctx->chunk, data, len);
+		pzcrypto_hash_blake3_merge_cv_stack (ctx, ctx->chunk.counter);
+	}
+}
+
+void
+zcrypto_hash_blake3_finish (PHashBLAKE3 *ctx)
+{
+	PBlake3Output	output;
+	puchar		block[P_BLAKE3_BLOCK_LEN];
+	puint32		words[8];
+	puint		cvs_left;
+
+	if (ctx->cv_stack_len == 0)
+		pzcrypto_hash_blake3_chunk_output (&ctx->chunk, &output);
+	else {
+		if (pzcrypto_hash_blake3_chunk_len (&ctx->chunk) > 0) {
+			cvs_left = ctx->cv_stack_len;
+			pzcrypto_hash_blake3_chunk_output (&ctx->chunk, &output);
+		} else {
+			cvs_left = ctx->cv_stack_len - 2;
+			pzcrypto_hash_blake3_parent_output (ctx->cv_stack + cvs_left * P_BLAKE3_OUT_LEN, &output);
+		}
+
+		while (cvs_left > 0) {
+			--cvs_left;
+
+			memcpy (block, ctx->cv_stack + cvs_left * P_BLAKE3_OUT_LEN, P_BLAKE3_OUT_LEN);
+			pzcrypto_hash_blake3_output_cv (&output, block + P_BLAKE3_OUT_LEN);
+			pzcrypto_hash_blake3_parent_output (block, &output);
+		}
+	}
+
+	/* The root node is compressed with its output block counter */
+	memcpy (words, output.cv, sizeof (words));
+
+	pzcrypto_hash_blake3_compress (words, output.block, output.block_len, 0, output.flags | P_BLAKE3_ROOT);
+	pzcrypto_hash_blake3_store_cv (ctx->hash, words);
+}
+
+const puchar *
+zcrypto_hash_blake3_digest (PHashBLAKE3 *ctx)
+{
+	return ctx->hash;
+}
+
+void
+zcrypto_hash_blake3_reset (PHashBLAKE3 *ctx)
+{
+	pzcrypto_hash_blake3_chunk_init (&ctx->chunk, 0);
+
+	memset (ctx->cv_stack, 0, sizeof (ctx->cv_stack));
+	memset (ctx->hash, 0, sizeof (ctx->hash));
+
+	ctx->cv_stack_len = 0;
+}
+
+void
+zcrypto_hash_blake3_set_threads (PHashBLAKE3	*ctx,
+				 puint		threads)
+{
+	ctx->threads = threads;
+}
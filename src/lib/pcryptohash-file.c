@@ -0,0 +1,480 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pcryptohash.h"
+#include "pcondvariable.h"
+#include "pmutex.h"
+#include "ptimeprofiler.h"
+#include "puthread.h"
+#include "perror-private.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef P_OS_UNIX
+#  include "psysclose-private.h"
+#  include <sys/types.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <errno.h>
+#endif
+
+#define P_CRYPTO_HASH_FILE_BLOCK_SIZE	(1024 * 1024)
+#define P_CRYPTO_HASH_FILE_MAP_WINDOW	(64 * 1024 * 1024)
+
+typedef struct PCryptoHashFileSource_ {
+#ifdef P_OS_UNIX
+	pint		fd;
+#else
+	FILE		*file;
+#endif
+} PCryptoHashFileSource;
+
+/* Double buffer filled by the helper thread: a buffer is owned by the reader
+ * while it isn't full, and by the hashing thread otherwise */
+typedef struct PCryptoHashFileReader_ {
+	PCryptoHashFileSource	*source;
+	PMutex			*mutex;
+	PCondVariable		*cond;
+	puchar			*buf[2];
+	pssize			len[2];
+	pboolean		is_full[2];
+	PError			*error;
+} PCryptoHashFileReader;
+
+static pboolean pzcrypto_hash_file_open (PCryptoHashFileSource *source, const pchar *path, PError **error);
+static void pzcrypto_hash_file_close (PCryptoHashFileSource *source);
+static pssize pzcrypto_hash_file_read (PCryptoHashFileSource *source, puchar *buf, psize len, PError **error);
+#ifdef P_OS_UNIX
+static puint64 pzcrypto_hash_file_hash_mapped (PCryptoHash *hash, pint fd, puint64 size);
+#endif
+static pboolean pzcrypto_hash_file_hash_read (PCryptoHash *hash, PCryptoHashFileSource *source, puint64 *bytes, PError **error);
+static ppointer pzcrypto_hash_file_reader_thread (ppointer data);
+static pboolean pzcrypto_hash_file_hash_threaded (PCryptoHash *hash, PCryptoHashFileSource *source, puint64 *bytes, PError **error);
+
+static pboolean
+pzcrypto_hash_file_open (PCryptoHashFileSource	*source,
+			 const pchar		*path,
+			 PError			**error)
+{
+#ifdef P_OS_UNIX
+	if (P_UNLIKELY ((source->fd = open (path, O_RDONLY)) == -1)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to open file for reading");
+		return FALSE;
+	}
+
+#  ifdef POSIX_FADV_SEQUENTIAL
+	/* Doubles the readahead window on Linux, it is only a hint */
+	posix_fadvise (source->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#  endif
+#else
+	if (P_UNLIKELY ((source->file = fopen (path, "rb")) == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to open file for reading");
+		return FALSE;
+	}
+#endif
+
+	return TRUE;
+}
+
+static void
+pzcrypto_hash_file_close (PCryptoHashFileSource *source)
+{
+#ifdef P_OS_UNIX
+	if (P_UNLIKELY (zsys_close (source->fd) != 0))
+		P_WARNING ("PCryptoHash::pzcrypto_hash_file_close: failed to close file descriptor");
+#else
+	if (P_UNLIKELY (fclose (source->file) != 0))
+		P_WARNING ("PCryptoHash::pzcrypto_hash_file_close: fclose() failed");
+#endif
+}
+
+/* Fills the whole buffer unless the end of the file is reached, so all the
+ * reads start at block-aligned offsets */
+static pssize
+pzcrypto_hash_file_read (PCryptoHashFileSource	*source,
+			 puchar			*buf,
+			 psize			len,
+			 PError			**error)
+{
+#ifdef P_OS_UNIX
+	psize	total = 0;
+	ssize_t	n_read;
+
+	while (total < len) {
+		n_read = read (source->fd, buf + total, len - total);
+
+		if (n_read == 0)
+			break;
+
+		if (P_UNLIKELY (n_read < 0)) {
+#  ifdef EINTR
+			if (errno == EINTR)
+				continue;
+#  endif
+			zerror_set_error_p (error,
+					     (pint) zerror_get_last_io (),
+					     zerror_get_last_system (),
+					     "Failed to read file");
+			return -1;
+		}
+
+		total += (psize) n_read;
+	}
+
+	return (pssize) total;
+#else
+	psize n_read;
+
+	n_read = fread (buf, 1, len, source->file);
+
+	if (P_UNLIKELY (ferror (source->file) != 0)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to read file");
+		return -1;
+	}
+
+	return (pssize) n_read;
+#endif
+}
+
+#ifdef P_OS_UNIX
+/* The file is mapped window by window to keep the address space usage low on
+ * 32-bit systems, the next window is requested from the disk before hashing
+ * the current one. Returns the number of bytes hashed, which is less than the
+ * size if a window can't be mapped. */
+static puint64
+pzcrypto_hash_file_hash_mapped (PCryptoHash	*hash,
+				pint		fd,
+				puint64		size)
+{
+	puint64		offset;
+	psize		window;
+	ppointer	data;
+
+	for (offset = 0; offset < size; offset += window) {
+		if (size - offset < P_CRYPTO_HASH_FILE_MAP_WINDOW)
+			window = (psize) (size - offset);
+		else
+			window = P_CRYPTO_HASH_FILE_MAP_WINDOW;
+
+		if (P_UNLIKELY ((data = mmap (NULL,
+					      window,
+					      PROT_READ,
+					      MAP_SHARED,
+					      fd,
+					      (off_t) offset)) == (void *) -1))
+			return offset;
+
+#  ifdef MADV_SEQUENTIAL
+		madvise (data, window, MADV_SEQUENTIAL);
+#  endif
+
+#  ifdef POSIX_FADV_WILLNEED
+		if (offset + window < size)
+			posix_fadvise (fd,
+				       (off_t) (offset + window),
+				       P_CRYPTO_HASH_FILE_MAP_WINDOW,
+				       POSIX_FADV_WILLNEED);
+#  endif
+
+		zcrypto_hash_update (hash, (const puchar *) data, window);
+
+		if (P_UNLIKELY (munmap (data, window) != 0))
+			P_WARNING ("PCryptoHash::pzcrypto_hash_file_hash_mapped: failed to unmap file");
+	}
+
+	return size;
+}
+#endif
+
+static pboolean
+pzcrypto_hash_file_hash_read (PCryptoHash		*hash,
+			      PCryptoHashFileSource	*source,
+			      puint64			*bytes,
+			      PError			**error)
+{
+	puchar	*buf;
+	pssize	n_read;
+
+	if (P_UNLIKELY ((buf = zmalloc (P_CRYPTO_HASH_FILE_BLOCK_SIZE)) == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for read buffer");
+		return FALSE;
+	}
+
+	while ((n_read = pzcrypto_hash_file_read (source, buf, P_CRYPTO_HASH_FILE_BLOCK_SIZE, error)) > 0) {
+		zcrypto_hash_update (hash, buf, (psize) n_read);
+		*bytes += (puint64) n_read;
+	}
+
+	zfree (buf);
+
+	return n_read == 0;
+}
+
+static ppointer
+pzcrypto_hash_file_reader_thread (ppointer data)
+{
+	PCryptoHashFileReader	*reader = (PCryptoHashFileReader *) data;
+	pssize			n_read;
+	pint			i = 0;
+
+	while (TRUE) {
+		zmutex_lock (reader->mutex);
+
+		while (reader->is_full[i] == TRUE)
+			zcond_variable_wait (reader->cond, reader->mutex);
+
+		zmutex_unlock (reader->mutex);
+
+		n_read = pzcrypto_hash_file_read (reader->source,
+						  reader->buf[i],
+						  P_CRYPTO_HASH_FILE_BLOCK_SIZE,
+						  &reader->error);
+
+		zmutex_lock (reader->mutex);
+
+		reader->len[i]     = n_read;
+		reader->is_full[i] = TRUE;
+
+		zcond_variable_broadcast (reader->cond);
+		zmutex_unlock (reader->mutex);
+
+		/* End of the file or a failure, the last block tells which */
+		if (n_read <= 0)
+			break;
+
+		i ^= 1;
+	}
+
+	return NULL;
+}
+
+static pboolean
+pzcrypto_hash_file_hash_threaded (PCryptoHash		*hash,
+				  PCryptoHashFileSource	*source,
+				  puint64		*bytes,
+				  PError		**error)
+{
+	PCryptoHashFileReader	reader;
+	PUThread		*thread;
+	pssize			n_read;
+	pint			i = 0;
+
+	memset (&reader, 0, sizeof (reader));
+
+	reader.source = source;
+	reader.mutex  = zmutex_new ();
+	reader.cond   = zcond_variable_new ();
+	reader.buf[0] = zmalloc (P_CRYPTO_HASH_FILE_BLOCK_SIZE);
+	reader.buf[1] = zmalloc (P_CRYPTO_HASH_FILE_BLOCK_SIZE);
+
+	if (P_UNLIKELY (reader.mutex == NULL || reader.cond == NULL ||
+			reader.buf[0] == NULL || reader.buf[1] == NULL)) {
+		zmutex_free (reader.mutex);
+		zcond_variable_free (reader.cond);
+		zfree (reader.buf[0]);
+		zfree (reader.buf[1]);
+
+		/* Not enough resources for the helper thread, go on without it */
+		return pzcrypto_hash_file_hash_read (hash, source, bytes, error);
+	}
+
+	if (P_UNLIKELY ((thread = zuthread_create (pzcrypto_hash_file_reader_thread,
+						   &reader,
+						   TRUE,
+						   NULL)) == NULL)) {
+		zmutex_free (reader.mutex);
+		zcond_variable_free (reader.cond);
+		zfree (reader.buf[0]);
+		zfree (reader.buf[1]);
+
+		return pzcrypto_hash_file_hash_read (hash, source, bytes, error);
+	}
+
+	while (TRUE) {
+		zmutex_lock (reader.mutex);
+
+		while (reader.is_full[i] == FALSE)
+			zcond_variable_wait (reader.cond, reader.mutex);
+
+		n_read = reader.len[i];
+
+		zmutex_unlock (reader.mutex);
+
+		if (n_read <= 0)
+			break;
+
+		zcrypto_hash_update (hash, reader.buf[i], (psize) n_read);
+		*bytes += (puint64) n_read;
+
+		zmutex_lock (reader.mutex);
+
+		reader.is_full[i] = FALSE;
+
+		zcond_variable_broadcast (reader.cond);
+		zmutex_unlock (reader.mutex);
+
+		i ^= 1;
+	}
+
+	zuthread_join (thread);
+	zuthread_unref (thread);
+
+	zmutex_free (reader.mutex);
+	zcond_variable_free (reader.cond);
+	zfree (reader.buf[0]);
+	zfree (reader.buf[1]);
+
+	if (P_UNLIKELY (n_read < 0)) {
+		if (error != NULL)
+			*error = reader.error;
+		else
+			zerror_free (reader.error);
+
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API PCryptoHash *
+zcrypto_hash_file (PCryptoHashType		type,
+		   const pchar			*path,
+		   PCryptoHashFileFlags		flags,
+		   PCryptoHashFileStats		*stats,
+		   PError			**error)
+{
+	PCryptoHashFileSource	source;
+	PCryptoHash		*hash;
+	PTimeProfiler		*profiler = NULL;
+	puint64			bytes     = 0;
+	pboolean		is_mapped = FALSE;
+	pboolean		result    = FALSE;
+#ifdef P_OS_UNIX
+	struct stat		sb;
+#endif
+
+	if (P_UNLIKELY (path == NULL ||
+			type < P_CRYPTO_HASH_TYPE_MD5 ||
+			type > P_CRYPTO_HASH_TYPE_BLAKE3)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((hash = zcrypto_hash_new (type)) == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for hash context");
+		return NULL;
+	}
+
+	if (stats != NULL && P_UNLIKELY ((profiler = ztime_profiler_new ()) == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for time profiler");
+		zcrypto_hash_free (hash);
+		return NULL;
+	}
+
+	if (flags & P_CRYPTO_HASH_FILE_FLAG_THREADED)
+		zcrypto_hash_set_threads (hash, (puint) zuthread_ideal_count ());
+
+	if (P_UNLIKELY (pzcrypto_hash_file_open (&source, path, error) == FALSE)) {
+		ztime_profiler_free (profiler);
+		zcrypto_hash_free (hash);
+		return NULL;
+	}
+
+#ifdef P_OS_UNIX
+	if (!(flags & P_CRYPTO_HASH_FILE_FLAG_NO_MAP) &&
+	    fstat (source.fd, &sb) == 0                &&
+	    S_ISREG (sb.st_mode)                       &&
+	    sb.st_size > 0) {
+		bytes     = pzcrypto_hash_file_hash_mapped (hash, source.fd, (puint64) sb.st_size);
+		is_mapped = bytes > 0;
+		result    = bytes == (puint64) sb.st_size;
+
+		/* The file (or its part) can't be mapped, read the rest of it */
+		if (result == FALSE && P_UNLIKELY (lseek (source.fd, (off_t) bytes, SEEK_SET) == (off_t) -1)) {
+			zerror_set_error_p (error,
+					     (pint) zerror_get_last_io (),
+					     zerror_get_last_system (),
+					     "Failed to call lseek() to skip mapped data");
+			pzcrypto_hash_file_close (&source);
+			ztime_profiler_free (profiler);
+			zcrypto_hash_free (hash);
+			return NULL;
+		}
+	}
+#endif
+
+	if (result == FALSE) {
+		if (flags & P_CRYPTO_HASH_FILE_FLAG_THREADED)
+			result = pzcrypto_hash_file_hash_threaded (hash, &source, &bytes, error);
+		else
+			result = pzcrypto_hash_file_hash_read (hash, &source, &bytes, error);
+	}
+
+	pzcrypto_hash_file_close (&source);
+
+	if (P_UNLIKELY (result == FALSE)) {
+		ztime_profiler_free (profiler);
+		zcrypto_hash_free (hash);
+		return NULL;
+	}
+
+	if (stats != NULL) {
+		stats->bytes         = bytes;
+		stats->elapsed_usecs = ztime_profiler_elapsed_usecs (profiler);
+		stats->bytes_per_sec = stats->elapsed_usecs > 0
+				       ? (puint64) ((double) bytes * 1000000.0 / (double) stats->elapsed_usecs)
+				       : 0;
+		stats->is_mapped     = is_mapped;
+
+		ztime_profiler_free (profiler);
+	}
+
+	return hash;
+}
@@ -29,13 +29,6 @@
 #include <string.h>
 #include <stdlib.h>
 
-struct PHashGOST3411_ {
-	puint32	buf[8];  /* Buffer to handle incoming data. */
-	puint32	hash[8]; /* State of calculated hash.       */
-	puint32	len[8];  /* Length of hashed data, in bits. */
-	puint32	sum[8];  /* 256-bit sum of hashed data.     */
-};
-
 static void pzcrypto_hash_gost3411_swazbytes (puint32 *data, puint words);
 static void pzcrypto_hash_gost3411_sum_256 (puint32 a[8], const puint32 b[8]);
 static void pzcrypto_hash_gost3411_process (PHashGOST3411 *ctx, const puint32 data[8]);
@@ -387,17 +380,10 @@ static void pzcrypto_hash_gost3411_process (PHashGOST3411	*ctx,
 		     ^ V[3]			^ V[4]		^ V[5];
 }
 
-PHashGOST3411 *
-zcrypto_hash_gost3411_new (void)
+void
+zcrypto_hash_gost3411_init (PHashGOST3411 *ctx)
 {
-	PHashGOST3411 *ret;
-
-	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PHashGOST3411))) == NULL))
-		return NULL;
-
-	zcrypto_hash_gost3411_reset (ret);
-
-	return ret;
+	zcrypto_hash_gost3411_reset (ctx);
 }
 
 void
@@ -476,9 +462,3 @@ zcrypto_hash_gost3411_reset (PHashGOST3411 *ctx)
 	memset (ctx->len, 0, 32);
 	memset (ctx->sum, 0, 32);
 }
-
-void
-zcrypto_hash_gost3411_free (PHashGOST3411 *ctx)
-{
-	zfree (ctx);
-}
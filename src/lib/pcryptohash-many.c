@@ -0,0 +1,903 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Multi-buffer hashing: every message gets its own 32-bit lane of the vector
+ * registers, so a single pass of the compression function processes one
+ * block of each of the eight messages in flight. A lane which has finished
+ * its message is refilled with the next one, so the messages don't need to
+ * have equal lengths.
+ *
+ * SHA-3 works on 64-bit words, so the Keccak permutation runs on four
+ * messages at once with the same lane refilling scheme. */
+
+#include <string.h>
+
+#include "pcryptohash-many-private.h"
+#include "pcpuinfo-private.h"
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+#  include <immintrin.h>
+
+#define P_CRYPTO_HASH_MANY_LANES	8
+#define P_CRYPTO_HASH_MANY_KECCAK_LANES	4
+#define P_CRYPTO_HASH_MANY_KECCAK_RATE	144
+
+typedef void (*PCryptoHashManyFunc) (puint32 *state, const puchar * const *blocks);
+
+typedef struct PCryptoHashManyAlgo_ {
+	PCryptoHashManyFunc	func;
+	const puint32		*iv;
+	puint			state_words;
+	puint			digest_len;
+	pboolean		big_endian;
+} PCryptoHashManyAlgo;
+
+typedef struct PCryptoHashLane_ {
+	const puchar	*data;
+	psize		blocks;
+	puchar		tail[128];
+	puint		tail_blocks;
+	puint		tail_pos;
+	psize		index;
+	pboolean	busy;
+} PCryptoHashLane;
+
+typedef struct PCryptoHashKeccakLane_ {
+	const puchar	*data;
+	psize		blocks;
+	puchar		tail[P_CRYPTO_HASH_MANY_KECCAK_RATE];
+	psize		index;
+	pboolean	busy;
+} PCryptoHashKeccakLane;
+
+static const puchar pzcrypto_hash_many_idle[P_CRYPTO_HASH_MANY_KECCAK_RATE] = {0};
+
+static const puint32 pzcrypto_hash_many_md5_iv[] = {
+	0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476
+};
+
+static const puint32 pzcrypto_hash_many_sha1_iv[] = {
+	0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+};
+
+static const puint32 pzcrypto_hash_many_sha2_224_iv[] = {
+	0xC1059ED8, 0x367CD507, 0x3070DD17, 0xF70E5939,
+	0xFFC00B31, 0x68581511, 0x64F98FA7, 0xBEFA4FA4
+};
+
+static const puint32 pzcrypto_hash_many_sha2_256_iv[] = {
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+	0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static const puint32 pzcrypto_hash_many_sha2_256_K[] = {
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+	0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+	0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+	0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+	0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+	0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+	0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+	0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+	0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+	0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+	0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+	0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+	0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+	0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+static const puint64 pzcrypto_hash_many_keccak_K[] = {
+	0x0000000000000001ULL, 0x0000000000008082ULL,
+	0x800000000000808AULL, 0x8000000080008000ULL,
+	0x000000000000808BULL, 0x0000000080000001ULL,
+	0x8000000080008081ULL, 0x8000000000008009ULL,
+	0x000000000000008AULL, 0x0000000000000088ULL,
+	0x0000000080008009ULL, 0x000000008000000AULL,
+	0x000000008000808BULL, 0x800000000000008BULL,
+	0x8000000000008089ULL, 0x8000000000008003ULL,
+	0x8000000000008002ULL, 0x8000000000000080ULL,
+	0x000000000000800AULL, 0x800000008000000AULL,
+	0x8000000080008081ULL, 0x8000000000008080ULL,
+	0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static P_CPU_TARGET ("avx2") void pzcrypto_hash_many_load_avx2 (const puchar * const *blocks, puint half, pboolean swap, __m256i X[8]);
+static P_CPU_TARGET ("avx2") void pzcrypto_hash_many_md5_avx2 (puint32 *state, const puchar * const *blocks);
+static P_CPU_TARGET ("avx2") void pzcrypto_hash_many_sha1_avx2 (puint32 *state, const puchar * const *blocks);
+static P_CPU_TARGET ("avx2") void pzcrypto_hash_many_sha2_256_avx2 (puint32 *state, const puchar * const *blocks);
+static P_CPU_TARGET ("avx2") void pzcrypto_hash_many_keccak_avx2 (puint64 *state, const puchar * const *blocks, puint rate);
+static void pzcrypto_hash_many_start (const PCryptoHashManyAlgo *algo, PCryptoHashLane *lane, puint32 *state,
+				      puint lane_idx, const puchar *data, psize len, psize index);
+static void pzcrypto_hash_many_store (const PCryptoHashManyAlgo *algo, const puint32 *state, puint lane_idx, puchar *digest);
+static void pzcrypto_hash_many_run (const PCryptoHashManyAlgo *algo, const puchar * const *inputs, const psize *lengths,
+				    puchar * const *digests, psize count);
+static void pzcrypto_hash_many_sha3_start (PCryptoHashKeccakLane *lane, puint64 *state, puint lane_idx, puint rate,
+					   const puchar *data, psize len, psize index);
+static void pzcrypto_hash_many_sha3_run (puint digest_len, const puchar * const *inputs, const psize *lengths,
+					 puchar * const *digests, psize count);
+
+#define P_CRYPTO_HASH_MANY_ROTL(val, shift) \
+	_mm256_or_si256 (_mm256_slli_epi32 (val, shift), _mm256_srli_epi32 (val, 32 - (shift)))
+#define P_CRYPTO_HASH_MANY_ROTR(val, shift) \
+	_mm256_or_si256 (_mm256_srli_epi32 (val, shift), _mm256_slli_epi32 (val, 32 - (shift)))
+#define P_CRYPTO_HASH_MANY_XOR3(x, y, z) \
+	_mm256_xor_si256 (_mm256_xor_si256 (x, y), z)
+#define P_CRYPTO_HASH_MANY_CONST(val) \
+	_mm256_set1_epi32 ((pint) (val))
+#define P_CRYPTO_HASH_MANY_ROTL64(val, shift) \
+	_mm256_or_si256 (_mm256_slli_epi64 (val, shift), _mm256_srli_epi64 (val, 64 - (shift)))
+
+/* One Keccak round over four interleaved states, the lanes are named as in
+ * pcryptohash-sha3.c; AVX2 has an AND-NOT instruction, so chi is used as is
+ * without lane complementing */
+#define P_CRYPTO_HASH_MANY_KECCAK_ROUND(A, E, k)							\
+{													\
+	Ca = P_CRYPTO_HASH_MANY_XOR3 (A##ba, A##ga, _mm256_xor_si256 (A##ka, _mm256_xor_si256 (A##ma, A##sa)));	\
+	Ce = P_CRYPTO_HASH_MANY_XOR3 (A##be, A##ge, _mm256_xor_si256 (A##ke, _mm256_xor_si256 (A##me, A##se)));	\
+	Ci = P_CRYPTO_HASH_MANY_XOR3 (A##bi, A##gi, _mm256_xor_si256 (A##ki, _mm256_xor_si256 (A##mi, A##si)));	\
+	Co = P_CRYPTO_HASH_MANY_XOR3 (A##bo, A##go, _mm256_xor_si256 (A##ko, _mm256_xor_si256 (A##mo, A##so)));	\
+	Cu = P_CRYPTO_HASH_MANY_XOR3 (A##bu, A##gu, _mm256_xor_si256 (A##ku, _mm256_xor_si256 (A##mu, A##su)));	\
+													\
+	Da = _mm256_xor_si256 (Cu, P_CRYPTO_HASH_MANY_ROTL64 (Ce, 1));					\
+	De = _mm256_xor_si256 (Ca, P_CRYPTO_HASH_MANY_ROTL64 (Ci, 1));					\
+	Di = _mm256_xor_si256 (Ce, P_CRYPTO_HASH_MANY_ROTL64 (Co, 1));					\
+	Do = _mm256_xor_si256 (Ci, P_CRYPTO_HASH_MANY_ROTL64 (Cu, 1));					\
+	Du = _mm256_xor_si256 (Co, P_CRYPTO_HASH_MANY_ROTL64 (Ca, 1));					\
+													\
+	Ba = _mm256_xor_si256 (A##ba, Da);								\
+	Be = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##ge, De), 44);				\
+	Bi = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##ki, Di), 43);				\
+	Bo = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##mo, Do), 21);				\
+	Bu = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##su, Du), 14);				\
+	E##ba = P_CRYPTO_HASH_MANY_XOR3 (Ba, _mm256_andnot_si256 (Be, Bi), (k));			\
+	E##be = _mm256_xor_si256 (Be, _mm256_andnot_si256 (Bi, Bo));					\
+	E##bi = _mm256_xor_si256 (Bi, _mm256_andnot_si256 (Bo, Bu));					\
+	E##bo = _mm256_xor_si256 (Bo, _mm256_andnot_si256 (Bu, Ba));					\
+	E##bu = _mm256_xor_si256 (Bu, _mm256_andnot_si256 (Ba, Be));					\
+													\
+	Ba = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##bo, Do), 28);				\
+	Be = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##gu, Du), 20);				\
+	Bi = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##ka, Da), 3);				\
+	Bo = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##me, De), 45);				\
+	Bu = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##si, Di), 61);				\
+	E##ga = _mm256_xor_si256 (Ba, _mm256_andnot_si256 (Be, Bi));					\
+	E##ge = _mm256_xor_si256 (Be, _mm256_andnot_si256 (Bi, Bo));					\
+	E##gi = _mm256_xor_si256 (Bi, _mm256_andnot_si256 (Bo, Bu));					\
+	E##go = _mm256_xor_si256 (Bo, _mm256_andnot_si256 (Bu, Ba));					\
+	E##gu = _mm256_xor_si256 (Bu, _mm256_andnot_si256 (Ba, Be));					\
+													\
+	Ba = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##be, De), 1);				\
+	Be = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##gi, Di), 6);				\
+	Bi = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##ko, Do), 25);				\
+	Bo = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##mu, Du), 8);				\
+	Bu = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##sa, Da), 18);				\
+	E##ka = _mm256_xor_si256 (Ba, _mm256_andnot_si256 (Be, Bi));					\
+	E##ke = _mm256_xor_si256 (Be, _mm256_andnot_si256 (Bi, Bo));					\
+	E##ki = _mm256_xor_si256 (Bi, _mm256_andnot_si256 (Bo, Bu));					\
+	E##ko = _mm256_xor_si256 (Bo, _mm256_andnot_si256 (Bu, Ba));					\
+	E##ku = _mm256_xor_si256 (Bu, _mm256_andnot_si256 (Ba, Be));					\
+													\
+	Ba = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##bu, Du), 27);				\
+	Be = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##ga, Da), 36);				\
+	Bi = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##ke, De), 10);				\
+	Bo = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##mi, Di), 15);				\
+	Bu = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##so, Do), 56);				\
+	E##ma = _mm256_xor_si256 (Ba, _mm256_andnot_si256 (Be, Bi));					\
+	E##me = _mm256_xor_si256 (Be, _mm256_andnot_si256 (Bi, Bo));					\
+	E##mi = _mm256_xor_si256 (Bi, _mm256_andnot_si256 (Bo, Bu));					\
+	E##mo = _mm256_xor_si256 (Bo, _mm256_andnot_si256 (Bu, Ba));					\
+	E##mu = _mm256_xor_si256 (Bu, _mm256_andnot_si256 (Ba, Be));					\
+													\
+	Ba = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##bi, Di), 62);				\
+	Be = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##go, Do), 55);				\
+	Bi = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##ku, Du), 39);				\
+	Bo = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##ma, Da), 41);				\
+	Bu = P_CRYPTO_HASH_MANY_ROTL64 (_mm256_xor_si256 (A##se, De), 2);				\
+	E##sa = _mm256_xor_si256 (Ba, _mm256_andnot_si256 (Be, Bi));					\
+	E##se = _mm256_xor_si256 (Be, _mm256_andnot_si256 (Bi, Bo));					\
+	E##si = _mm256_xor_si256 (Bi, _mm256_andnot_si256 (Bo, Bu));					\
+	E##so = _mm256_xor_si256 (Bo, _mm256_andnot_si256 (Bu, Ba));					\
+	E##su = _mm256_xor_si256 (Bu, _mm256_andnot_si256 (Ba, Be));					\
+}
+
+/* Loads eight words (half of a block) of every lane, the result holds the
+ * same word of all the lanes in every vector */
+static P_CPU_TARGET ("avx2") void
+pzcrypto_hash_many_load_avx2 (const puchar * const	*blocks,
+			      puint			half,
+			      pboolean			swap,
+			      __m256i			X[8])
+{
+	__m256i	r[8];
+	__m256i	t[8];
+	__m256i	u[8];
+	__m256i	mask;
+	puint	i;
+
+	mask = _mm256_set_epi8 (12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+				12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+	for (i = 0; i < 8; ++i) {
+		r[i] = _mm256_loadu_si256 ((const __m256i *) (blocks[i] + half * 32));
+
+		if (swap)
+			r[i] = _mm256_shuffle_epi8 (r[i], mask);
+	}
+
+	for (i = 0; i < 8; i += 2) {
+		t[i]     = _mm256_unpacklo_epi32 (r[i], r[i + 1]);
+		t[i + 1] = _mm256_unpackhi_epi32 (r[i], r[i + 1]);
+	}
+
+	for (i = 0; i < 8; i += 4) {
+		u[i]     = _mm256_unpacklo_epi64 (t[i],     t[i + 2]);
+		u[i + 1] = _mm256_unpackhi_epi64 (t[i],     t[i + 2]);
+		u[i + 2] = _mm256_unpacklo_epi64 (t[i + 1], t[i + 3]);
+		u[i + 3] = _mm256_unpackhi_epi64 (t[i + 1], t[i + 3]);
+	}
+
+	for (i = 0; i < 4; ++i) {
+		X[i]     = _mm256_permute2x128_si256 (u[i], u[i + 4], 0x20);
+		X[i + 4] = _mm256_permute2x128_si256 (u[i], u[i + 4], 0x31);
+	}
+}
+
+#define P_MD5_MANY_F(x, y, z) _mm256_xor_si256 (z, _mm256_and_si256 (x, _mm256_xor_si256 (y, z)))
+#define P_MD5_MANY_G(x, y, z) _mm256_xor_si256 (y, _mm256_and_si256 (z, _mm256_xor_si256 (x, y)))
+#define P_MD5_MANY_H(x, y, z) P_CRYPTO_HASH_MANY_XOR3 (x, y, z)
+#define P_MD5_MANY_I(x, y, z) _mm256_xor_si256 (y, _mm256_or_si256 (x, _mm256_xor_si256 (z, ones)))
+
+#define P_MD5_MANY_STEP(f, a, b, c, d, x, s, t)						\
+{												\
+	a = _mm256_add_epi32 (_mm256_add_epi32 (a, f (b, c, d)),				\
+			      _mm256_add_epi32 (x, P_CRYPTO_HASH_MANY_CONST (t)));		\
+	a = _mm256_add_epi32 (b, P_CRYPTO_HASH_MANY_ROTL (a, s));				\
+}
+
+static P_CPU_TARGET ("avx2") void
+pzcrypto_hash_many_md5_avx2 (puint32		*state,
+			     const puchar * const	*blocks)
+{
+	__m256i	X[16];
+	__m256i	a, b, c, d;
+	__m256i	ones;
+
+	pzcrypto_hash_many_load_avx2 (blocks, 0, FALSE, X);
+	pzcrypto_hash_many_load_avx2 (blocks, 1, FALSE, X + 8);
+
+	ones = _mm256_set1_epi32 (-1);
+
+	a = _mm256_loadu_si256 ((const __m256i *) (state + 0 * P_CRYPTO_HASH_MANY_LANES));
+	b = _mm256_loadu_si256 ((const __m256i *) (state + 1 * P_CRYPTO_HASH_MANY_LANES));
+	c = _mm256_loadu_si256 ((const __m256i *) (state + 2 * P_CRYPTO_HASH_MANY_LANES));
+	d = _mm256_loadu_si256 ((const __m256i *) (state + 3 * P_CRYPTO_HASH_MANY_LANES));
+
+		P_MD5_MANY_STEP (P_MD5_MANY_F, a, b, c, d, X[ 0],  7, 0xD76AA478);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, d, a, b, c, X[ 1], 12, 0xE8C7B756);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, c, d, a, b, X[ 2], 17, 0x242070DB);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, b, c, d, a, X[ 3], 22, 0xC1BDCEEE);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, a, b, c, d, X[ 4],  7, 0xF57C0FAF);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, d, a, b, c, X[ 5], 12, 0x4787C62A);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, c, d, a, b, X[ 6], 17, 0xA8304613);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, b, c, d, a, X[ 7], 22, 0xFD469501);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, a, b, c, d, X[ 8],  7, 0x698098D8);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, d, a, b, c, X[ 9], 12, 0x8B44F7AF);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, c, d, a, b, X[10], 17, 0xFFFF5BB1);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, b, c, d, a, X[11], 22, 0x895CD7BE);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, a, b, c, d, X[12],  7, 0x6B901122);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, d, a, b, c, X[13], 12, 0xFD987193);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, c, d, a, b, X[14], 17, 0xA679438E);
+		P_MD5_MANY_STEP (P_MD5_MANY_F, b, c, d, a, X[15], 22, 0x49B40821);
+
+		P_MD5_MANY_STEP (P_MD5_MANY_G, a, b, c, d, X[ 1],  5, 0xF61E2562);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, d, a, b, c, X[ 6],  9, 0xC040B340);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, c, d, a, b, X[11], 14, 0x265E5A51);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, b, c, d, a, X[ 0], 20, 0xE9B6C7AA);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, a, b, c, d, X[ 5],  5, 0xD62F105D);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, d, a, b, c, X[10],  9, 0x02441453);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, c, d, a, b, X[15], 14, 0xD8A1E681);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, b, c, d, a, X[ 4], 20, 0xE7D3FBC8);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, a, b, c, d, X[ 9],  5, 0x21E1CDE6);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, d, a, b, c, X[14],  9, 0xC33707D6);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, c, d, a, b, X[ 3], 14, 0xF4D50D87);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, b, c, d, a, X[ 8], 20, 0x455A14ED);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, a, b, c, d, X[13],  5, 0xA9E3E905);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, d, a, b, c, X[ 2],  9, 0xFCEFA3F8);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, c, d, a, b, X[ 7], 14, 0x676F02D9);
+		P_MD5_MANY_STEP (P_MD5_MANY_G, b, c, d, a, X[12], 20, 0x8D2A4C8A);
+
+		P_MD5_MANY_STEP (P_MD5_MANY_H, a, b, c, d, X[ 5],  4, 0xFFFA3942);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, d, a, b, c, X[ 8], 11, 0x8771F681);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, c, d, a, b, X[11], 16, 0x6D9D6122);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, b, c, d, a, X[14], 23, 0xFDE5380C);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, a, b, c, d, X[ 1],  4, 0xA4BEEA44);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, d, a, b, c, X[ 4], 11, 0x4BDECFA9);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, c, d, a, b, X[ 7], 16, 0xF6BB4B60);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, b, c, d, a, X[10], 23, 0xBEBFBC70);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, a, b, c, d, X[13],  4, 0x289B7EC6);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, d, a, b, c, X[ 0], 11, 0xEAA127FA);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, c, d, a, b, X[ 3], 16, 0xD4EF3085);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, b, c, d, a, X[ 6], 23, 0x04881D05);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, a, b, c, d, X[ 9],  4, 0xD9D4D039);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, d, a, b, c, X[12], 11, 0xE6DB99E5);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, c, d, a, b, X[15], 16, 0x1FA27CF8);
+		P_MD5_MANY_STEP (P_MD5_MANY_H, b, c, d, a, X[ 2], 23, 0xC4AC5665);
+
+		P_MD5_MANY_STEP (P_MD5_MANY_I, a, b, c, d, X[ 0],  6, 0xF4292244);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, d, a, b, c, X[ 7], 10, 0x432AFF97);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, c, d, a, b, X[14], 15, 0xAB9423A7);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, b, c, d, a, X[ 5], 21, 0xFC93A039);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, a, b, c, d, X[12],  6, 0x655B59C3);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, d, a, b, c, X[ 3], 10, 0x8F0CCC92);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, c, d, a, b, X[10], 15, 0xFFEFF47D);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, b, c, d, a, X[ 1], 21, 0x85845DD1);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, a, b, c, d, X[ 8],  6, 0x6FA87E4F);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, d, a, b, c, X[15], 10, 0xFE2CE6E0);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, c, d, a, b, X[ 6], 15, 0xA3014314);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, b, c, d, a, X[13], 21, 0x4E0811A1);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, a, b, c, d, X[ 4],  6, 0xF7537E82);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, d, a, b, c, X[11], 10, 0xBD3AF235);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, c, d, a, b, X[ 2], 15, 0x2AD7D2BB);
+		P_MD5_MANY_STEP (P_MD5_MANY_I, b, c, d, a, X[ 9], 21, 0xEB86D391);
+
+	a = _mm256_add_epi32 (a, _mm256_loadu_si256 ((const __m256i *) (state + 0 * P_CRYPTO_HASH_MANY_LANES)));
+	b = _mm256_add_epi32 (b, _mm256_loadu_si256 ((const __m256i *) (state + 1 * P_CRYPTO_HASH_MANY_LANES)));
+	c = _mm256_add_epi32 (c, _mm256_loadu_si256 ((const __m256i *) (state + 2 * P_CRYPTO_HASH_MANY_LANES)));
+	d = _mm256_add_epi32 (d, _mm256_loadu_si256 ((const __m256i *) (state + 3 * P_CRYPTO_HASH_MANY_LANES)));
+
+	_mm256_storeu_si256 ((__m256i *) (state + 0 * P_CRYPTO_HASH_MANY_LANES), a);
+	_mm256_storeu_si256 ((__m256i *) (state + 1 * P_CRYPTO_HASH_MANY_LANES), b);
+	_mm256_storeu_si256 ((__m256i *) (state + 2 * P_CRYPTO_HASH_MANY_LANES), c);
+	_mm256_storeu_si256 ((__m256i *) (state + 3 * P_CRYPTO_HASH_MANY_LANES), d);
+}
+
+#define P_SHA1_MANY_ROUND(f, k)									\
+{												\
+	tmp = _mm256_add_epi32 (_mm256_add_epi32 (P_CRYPTO_HASH_MANY_ROTL (a, 5), f),		\
+				_mm256_add_epi32 (_mm256_add_epi32 (e, W[i]), k));		\
+	e   = d;										\
+	d   = c;										\
+	c   = P_CRYPTO_HASH_MANY_ROTL (b, 30);							\
+	b   = a;										\
+	a   = tmp;										\
+}
+
+static P_CPU_TARGET ("avx2") void
+pzcrypto_hash_many_sha1_avx2 (puint32		*state,
+			      const puchar * const	*blocks)
+{
+	__m256i	W[80];
+	__m256i	H[5];
+	__m256i	a, b, c, d, e;
+	__m256i	k, tmp;
+	puint	i;
+
+	pzcrypto_hash_many_load_avx2 (blocks, 0, TRUE, W);
+	pzcrypto_hash_many_load_avx2 (blocks, 1, TRUE, W + 8);
+
+	for (i = 16; i < 80; ++i) {
+		tmp  = _mm256_xor_si256 (P_CRYPTO_HASH_MANY_XOR3 (W[i - 3], W[i - 8], W[i - 14]), W[i - 16]);
+		W[i] = P_CRYPTO_HASH_MANY_ROTL (tmp, 1);
+	}
+
+	for (i = 0; i < 5; ++i)
+		H[i] = _mm256_loadu_si256 ((const __m256i *) (state + i * P_CRYPTO_HASH_MANY_LANES));
+
+	a = H[0];
+	b = H[1];
+	c = H[2];
+	d = H[3];
+	e = H[4];
+
+	k = P_CRYPTO_HASH_MANY_CONST (0x5A827999);
+
+	for (i = 0; i < 20; ++i)
+		P_SHA1_MANY_ROUND (_mm256_xor_si256 (d, _mm256_and_si256 (b, _mm256_xor_si256 (c, d))), k);
+
+	k = P_CRYPTO_HASH_MANY_CONST (0x6ED9EBA1);
+
+	for (; i < 40; ++i)
+		P_SHA1_MANY_ROUND (P_CRYPTO_HASH_MANY_XOR3 (b, c, d), k);
+
+	k = P_CRYPTO_HASH_MANY_CONST (0x8F1BBCDC);
+
+	for (; i < 60; ++i)
+		P_SHA1_MANY_ROUND (_mm256_or_si256 (_mm256_and_si256 (b, c), _mm256_and_si256 (d, _mm256_or_si256 (b, c))), k);
+
+	k = P_CRYPTO_HASH_MANY_CONST (0xCA62C1D6);
+
+	for (; i < 80; ++i)
+		P_SHA1_MANY_ROUND (P_CRYPTO_HASH_MANY_XOR3 (b, c, d), k);
+
+	_mm256_storeu_si256 ((__m256i *) (state + 0 * P_CRYPTO_HASH_MANY_LANES), _mm256_add_epi32 (H[0], a));
+	_mm256_storeu_si256 ((__m256i *) (state + 1 * P_CRYPTO_HASH_MANY_LANES), _mm256_add_epi32 (H[1], b));
+	_mm256_storeu_si256 ((__m256i *) (state + 2 * P_CRYPTO_HASH_MANY_LANES), _mm256_add_epi32 (H[2], c));
+	_mm256_storeu_si256 ((__m256i *) (state + 3 * P_CRYPTO_HASH_MANY_LANES), _mm256_add_epi32 (H[3], d));
+	_mm256_storeu_si256 ((__m256i *) (state + 4 * P_CRYPTO_HASH_MANY_LANES), _mm256_add_epi32 (H[4], e));
+}
+
+#define P_SHA2_256_MANY_S0(x) P_CRYPTO_HASH_MANY_XOR3 (P_CRYPTO_HASH_MANY_ROTR (x, 7),		\
+						       P_CRYPTO_HASH_MANY_ROTR (x, 18),		\
+						       _mm256_srli_epi32 (x, 3))
+#define P_SHA2_256_MANY_S1(x) P_CRYPTO_HASH_MANY_XOR3 (P_CRYPTO_HASH_MANY_ROTR (x, 17),		\
+						       P_CRYPTO_HASH_MANY_ROTR (x, 19),		\
+						       _mm256_srli_epi32 (x, 10))
+#define P_SHA2_256_MANY_S2(x) P_CRYPTO_HASH_MANY_XOR3 (P_CRYPTO_HASH_MANY_ROTR (x, 2),		\
+						       P_CRYPTO_HASH_MANY_ROTR (x, 13),		\
+						       P_CRYPTO_HASH_MANY_ROTR (x, 22))
+#define P_SHA2_256_MANY_S3(x) P_CRYPTO_HASH_MANY_XOR3 (P_CRYPTO_HASH_MANY_ROTR (x, 6),		\
+						       P_CRYPTO_HASH_MANY_ROTR (x, 11),		\
+						       P_CRYPTO_HASH_MANY_ROTR (x, 25))
+
+#define P_SHA2_256_MANY_F0(x, y, z) _mm256_or_si256 (_mm256_and_si256 (x, y), _mm256_and_si256 (z, _mm256_or_si256 (x, y)))
+#define P_SHA2_256_MANY_F1(x, y, z) _mm256_xor_si256 (z, _mm256_and_si256 (x, _mm256_xor_si256 (y, z)))
+
+#define P_SHA2_256_MANY_P(a, b, c, d, e, f, g, h, t)							\
+{													\
+	tmp1 = _mm256_add_epi32 (_mm256_add_epi32 (h, P_SHA2_256_MANY_S3 (e)),				\
+				 _mm256_add_epi32 (P_SHA2_256_MANY_F1 (e, f, g),			\
+						   _mm256_add_epi32 (W[t], P_CRYPTO_HASH_MANY_CONST (pzcrypto_hash_many_sha2_256_K[t])))); \
+	tmp2 = _mm256_add_epi32 (P_SHA2_256_MANY_S2 (a), P_SHA2_256_MANY_F0 (a, b, c));		\
+	d    = _mm256_add_epi32 (d, tmp1);								\
+	h    = _mm256_add_epi32 (tmp1, tmp2);								\
+}
+
+static P_CPU_TARGET ("avx2") void
+pzcrypto_hash_many_sha2_256_avx2 (puint32		*state,
+				  const puchar * const	*blocks)
+{
+	__m256i	W[64];
+	__m256i	A[8];
+	__m256i	tmp1, tmp2;
+	puint	i;
+
+	pzcrypto_hash_many_load_avx2 (blocks, 0, TRUE, W);
+	pzcrypto_hash_many_load_avx2 (blocks, 1, TRUE, W + 8);
+
+	for (i = 16; i < 64; ++i)
+		W[i] = _mm256_add_epi32 (_mm256_add_epi32 (P_SHA2_256_MANY_S1 (W[i - 2]), W[i - 7]),
+					 _mm256_add_epi32 (P_SHA2_256_MANY_S0 (W[i - 15]), W[i - 16]));
+
+	for (i = 0; i < 8; ++i)
+		A[i] = _mm256_loadu_si256 ((const __m256i *) (state + i * P_CRYPTO_HASH_MANY_LANES));
+
+	for (i = 0; i < 64; i += 8) {
+		P_SHA2_256_MANY_P (A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], i + 0);
+		P_SHA2_256_MANY_P (A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], i + 1);
+		P_SHA2_256_MANY_P (A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], i + 2);
+		P_SHA2_256_MANY_P (A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], i + 3);
+		P_SHA2_256_MANY_P (A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], i + 4);
+		P_SHA2_256_MANY_P (A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], i + 5);
+		P_SHA2_256_MANY_P (A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], i + 6);
+		P_SHA2_256_MANY_P (A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], i + 7);
+	}
+
+	for (i = 0; i < 8; ++i)
+		_mm256_storeu_si256 ((__m256i *) (state + i * P_CRYPTO_HASH_MANY_LANES),
+				     _mm256_add_epi32 (A[i], _mm256_loadu_si256 ((const __m256i *) (state + i * P_CRYPTO_HASH_MANY_LANES))));
+}
+
+/* Absorbs a block of every lane into the interleaved states and applies the
+ * Keccak-f[1600] permutation, word i of lane j is stored at state[i * 4 + j] */
+static P_CPU_TARGET ("avx2") void
+pzcrypto_hash_many_keccak_avx2 (puint64			*state,
+				const puchar * const	*blocks,
+				puint			rate)
+{
+	__m256i	S[25];
+	__m256i	Aba, Abe, Abi, Abo, Abu, Aga, Age, Agi, Ago, Agu, Aka, Ake, Aki, Ako, Aku;
+	__m256i	Ama, Ame, Ami, Amo, Amu, Asa, Ase, Asi, Aso, Asu;
+	__m256i	Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu, Eka, Eke, Eki, Eko, Eku;
+	__m256i	Ema, Eme, Emi, Emo, Emu, Esa, Ese, Esi, Eso, Esu;
+	__m256i	Ba, Be, Bi, Bo, Bu;
+	__m256i	Ca, Ce, Ci, Co, Cu;
+	__m256i	Da, De, Di, Do, Du;
+	__m256i	r0, r1, r2, r3, t0, t1, t2, t3;
+	puint64	w[P_CRYPTO_HASH_MANY_KECCAK_LANES];
+	puint	words;
+	puint	i, j;
+
+	words = rate / 8;
+
+	for (i = 0; i < 25; ++i)
+		S[i] = _mm256_loadu_si256 ((const __m256i *) (state + i * 4));
+
+	/* Four words of every lane are transposed at once */
+	for (i = 0; i + 4 <= words; i += 4) {
+		r0 = _mm256_loadu_si256 ((const __m256i *) (blocks[0] + i * 8));
+		r1 = _mm256_loadu_si256 ((const __m256i *) (blocks[1] + i * 8));
+		r2 = _mm256_loadu_si256 ((const __m256i *) (blocks[2] + i * 8));
+		r3 = _mm256_loadu_si256 ((const __m256i *) (blocks[3] + i * 8));
+
+		t0 = _mm256_unpacklo_epi64 (r0, r1);
+		t1 = _mm256_unpackhi_epi64 (r0, r1);
+		t2 = _mm256_unpacklo_epi64 (r2, r3);
+		t3 = _mm256_unpackhi_epi64 (r2, r3);
+
+		S[i + 0] = _mm256_xor_si256 (S[i + 0], _mm256_permute2x128_si256 (t0, t2, 0x20));
+		S[i + 1] = _mm256_xor_si256 (S[i + 1], _mm256_permute2x128_si256 (t1, t3, 0x20));
+		S[i + 2] = _mm256_xor_si256 (S[i + 2], _mm256_permute2x128_si256 (t0, t2, 0x31));
+		S[i + 3] = _mm256_xor_si256 (S[i + 3], _mm256_permute2x128_si256 (t1, t3, 0x31));
+	}
+
+	for (; i < words; ++i) {
+		for (j = 0; j < P_CRYPTO_HASH_MANY_KECCAK_LANES; ++j)
+			memcpy (&w[j], blocks[j] + i * 8, sizeof (puint64));
+
+		S[i] = _mm256_xor_si256 (S[i], _mm256_loadu_si256 ((const __m256i *) w));
+	}
+
+	Aba = S[0];  Abe = S[1];  Abi = S[2];  Abo = S[3];  Abu = S[4];
+	Aga = S[5];  Age = S[6];  Agi = S[7];  Ago = S[8];  Agu = S[9];
+	Aka = S[10]; Ake = S[11]; Aki = S[12]; Ako = S[13]; Aku = S[14];
+	Ama = S[15]; Ame = S[16]; Ami = S[17]; Amo = S[18]; Amu = S[19];
+	Asa = S[20]; Ase = S[21]; Asi = S[22]; Aso = S[23]; Asu = S[24];
+
+	for (i = 0; i < 24; i += 2) {
+		P_CRYPTO_HASH_MANY_KECCAK_ROUND (A, E, _mm256_set1_epi64x ((pint64) pzcrypto_hash_many_keccak_K[i]));
+		P_CRYPTO_HASH_MANY_KECCAK_ROUND (E, A, _mm256_set1_epi64x ((pint64) pzcrypto_hash_many_keccak_K[i + 1]));
+	}
+
+	S[0]  = Aba; S[1]  = Abe; S[2]  = Abi; S[3]  = Abo; S[4]  = Abu;
+	S[5]  = Aga; S[6]  = Age; S[7]  = Agi; S[8]  = Ago; S[9]  = Agu;
+	S[10] = Aka; S[11] = Ake; S[12] = Aki; S[13] = Ako; S[14] = Aku;
+	S[15] = Ama; S[16] = Ame; S[17] = Ami; S[18] = Amo; S[19] = Amu;
+	S[20] = Asa; S[21] = Ase; S[22] = Asi; S[23] = Aso; S[24] = Asu;
+
+	for (i = 0; i < 25; ++i)
+		_mm256_storeu_si256 ((__m256i *) (state + i * 4), S[i]);
+}
+
+/* Puts a new message into the lane: its full blocks are read in place, the
+ * remaining bytes are copied into the padded tail */
+static void
+pzcrypto_hash_many_start (const PCryptoHashManyAlgo	*algo,
+			  PCryptoHashLane		*lane,
+			  puint32			*state,
+			  puint				lane_idx,
+			  const puchar			*data,
+			  psize				len,
+			  psize				index)
+{
+	puint64	bits;
+	psize	rem;
+	puchar	*end;
+	puint	i;
+
+	lane->data   = data;
+	lane->blocks = len / 64;
+	lane->index  = index;
+	lane->busy   = TRUE;
+
+	rem = len & 0x3F;
+
+	memset (lane->tail, 0, sizeof (lane->tail));
+
+	if (rem > 0)
+		memcpy (lane->tail, data + len - rem, rem);
+
+	lane->tail[rem]   = 0x80;
+	lane->tail_blocks = rem < 56 ? 1 : 2;
+	lane->tail_pos    = 0;
+
+	bits = ((puint64) len) << 3;
+	end  = lane->tail + lane->tail_blocks * 64 - 8;
+
+	for (i = 0; i < 8; ++i)
+		end[i] = (puchar) (algo->big_endian ? bits >> (56 - i * 8) : bits >> (i * 8));
+
+	for (i = 0; i < algo->state_words; ++i)
+		state[i * P_CRYPTO_HASH_MANY_LANES + lane_idx] = algo->iv[i];
+}
+
+static void
+pzcrypto_hash_many_store (const PCryptoHashManyAlgo	*algo,
+			  const puint32			*state,
+			  puint				lane_idx,
+			  puchar			*digest)
+{
+	puint32	val;
+	puint	i;
+
+	for (i = 0; i < algo->digest_len / 4; ++i) {
+		val = state[i * P_CRYPTO_HASH_MANY_LANES + lane_idx];
+
+		if (algo->big_endian) {
+			digest[i * 4 + 0] = (puchar) (val >> 24);
+			digest[i * 4 + 1] = (puchar) (val >> 16);
+			digest[i * 4 + 2] = (puchar) (val >> 8);
+			digest[i * 4 + 3] = (puchar) val;
+		} else {
+			digest[i * 4 + 0] = (puchar) val;
+			digest[i * 4 + 1] = (puchar) (val >> 8);
+			digest[i * 4 + 2] = (puchar) (val >> 16);
+			digest[i * 4 + 3] = (puchar) (val >> 24);
+		}
+	}
+}
+
+static void
+pzcrypto_hash_many_run (const PCryptoHashManyAlgo	*algo,
+			const puchar * const		*inputs,
+			const psize			*lengths,
+			puchar * const			*digests,
+			psize				count)
+{
+	PCryptoHashLane	lanes[P_CRYPTO_HASH_MANY_LANES];
+	puint32		state[8 * P_CRYPTO_HASH_MANY_LANES];
+	const puchar	*blocks[P_CRYPTO_HASH_MANY_LANES];
+	PCryptoHashLane	*lane;
+	psize		next;
+	puint		busy;
+	puint		i;
+
+	memset (state, 0, sizeof (state));
+
+	for (i = 0; i < P_CRYPTO_HASH_MANY_LANES; ++i)
+		lanes[i].busy = FALSE;
+
+	next = 0;
+	busy = 0;
+
+	for (;;) {
+		for (i = 0; i < P_CRYPTO_HASH_MANY_LANES && next < count; ++i) {
+			if (lanes[i].busy)
+				continue;
+
+			pzcrypto_hash_many_start (algo, &lanes[i], state, i, inputs[next], lengths[next], next);
+
+			++next;
+			++busy;
+		}
+
+		if (busy == 0)
+			break;
+
+		for (i = 0; i < P_CRYPTO_HASH_MANY_LANES; ++i) {
+			lane = &lanes[i];
+
+			if (!lane->busy)
+				blocks[i] = pzcrypto_hash_many_idle;
+			else if (lane->blocks > 0)
+				blocks[i] = lane->data;
+			else
+				blocks[i] = lane->tail + lane->tail_pos * 64;
+		}
+
+		algo->func (state, blocks);
+
+		for (i = 0; i < P_CRYPTO_HASH_MANY_LANES; ++i) {
+			lane = &lanes[i];
+
+			if (!lane->busy)
+				continue;
+
+			if (lane->blocks > 0) {
+				lane->data += 64;
+				--lane->blocks;
+				continue;
+			}
+
+			if (++lane->tail_pos < lane->tail_blocks)
+				continue;
+
+			pzcrypto_hash_many_store (algo, state, i, digests[lane->index]);
+
+			lane->busy = FALSE;
+			--busy;
+		}
+	}
+}
+/* SHA-3 padding always fits into a single block, and the state starts from
+ * zero */
+static void
+pzcrypto_hash_many_sha3_start (PCryptoHashKeccakLane	*lane,
+			       puint64			*state,
+			       puint			lane_idx,
+			       puint			rate,
+			       const puchar		*data,
+			       psize			len,
+			       psize			index)
+{
+	psize	rem;
+	puint	i;
+
+	lane->data   = data;
+	lane->blocks = len / rate;
+	lane->index  = index;
+	lane->busy   = TRUE;
+
+	rem = len % rate;
+
+	memset (lane->tail, 0, sizeof (lane->tail));
+
+	if (rem > 0)
+		memcpy (lane->tail, data + len - rem, rem);
+
+	lane->tail[rem]      ^= 0x06;
+	lane->tail[rate - 1] ^= 0x80;
+
+	for (i = 0; i < 25; ++i)
+		state[i * P_CRYPTO_HASH_MANY_KECCAK_LANES + lane_idx] = 0;
+}
+
+static void
+pzcrypto_hash_many_sha3_run (puint			digest_len,
+			     const puchar * const	*inputs,
+			     const psize		*lengths,
+			     puchar * const		*digests,
+			     psize			count)
+{
+	PCryptoHashKeccakLane	lanes[P_CRYPTO_HASH_MANY_KECCAK_LANES];
+	puint64			state[25 * P_CRYPTO_HASH_MANY_KECCAK_LANES];
+	const puchar		*blocks[P_CRYPTO_HASH_MANY_KECCAK_LANES];
+	PCryptoHashKeccakLane	*lane;
+	puchar			*digest;
+	psize			next;
+	puint			rate;
+	puint			busy;
+	puint			i, k;
+
+	rate = 200 - 2 * digest_len;
+
+	memset (state, 0, sizeof (state));
+
+	for (i = 0; i < P_CRYPTO_HASH_MANY_KECCAK_LANES; ++i)
+		lanes[i].busy = FALSE;
+
+	next = 0;
+	busy = 0;
+
+	for (;;) {
+		for (i = 0; i < P_CRYPTO_HASH_MANY_KECCAK_LANES && next < count; ++i) {
+			if (lanes[i].busy)
+				continue;
+
+			pzcrypto_hash_many_sha3_start (&lanes[i], state, i, rate, inputs[next], lengths[next], next);
+
+			++next;
+			++busy;
+		}
+
+		if (busy == 0)
+			break;
+
+		for (i = 0; i < P_CRYPTO_HASH_MANY_KECCAK_LANES; ++i) {
+			lane = &lanes[i];
+
+			if (!lane->busy)
+				blocks[i] = pzcrypto_hash_many_idle;
+			else if (lane->blocks > 0)
+				blocks[i] = lane->data;
+			else
+				blocks[i] = lane->tail;
+		}
+
+		pzcrypto_hash_many_keccak_avx2 (state, blocks, rate);
+
+		for (i = 0; i < P_CRYPTO_HASH_MANY_KECCAK_LANES; ++i) {
+			lane = &lanes[i];
+
+			if (!lane->busy)
+				continue;
+
+			if (lane->blocks > 0) {
+				lane->data += rate;
+				--lane->blocks;
+				continue;
+			}
+
+			digest = digests[lane->index];
+
+			for (k = 0; k < digest_len; ++k)
+				digest[k] = (puchar) (state[(k / 8) * P_CRYPTO_HASH_MANY_KECCAK_LANES + i] >> ((k % 8) * 8));
+
+			lane->busy = FALSE;
+			--busy;
+		}
+	}
+}
+#endif
+
+pboolean
+zcrypto_hash_many_simd (PCryptoHashType		type,
+			const puchar * const	*inputs,
+			const psize		*lengths,
+			puchar * const		*digests,
+			psize			count)
+{
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	PCryptoHashManyAlgo algo;
+
+	if (!zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		return FALSE;
+
+	/* The SHA extensions compute SHA-256 faster one message at a time than
+	 * eight interleaved messages in AVX2 */
+	if ((type == P_CRYPTO_HASH_TYPE_SHA2_224 || type == P_CRYPTO_HASH_TYPE_SHA2_256) &&
+	    zcpu_info_has_feature (P_CPU_FEATURE_SHA))
+		return FALSE;
+
+	switch (type) {
+	case P_CRYPTO_HASH_TYPE_MD5:
+		algo.func        = pzcrypto_hash_many_md5_avx2;
+		algo.iv          = pzcrypto_hash_many_md5_iv;
+		algo.state_words = 4;
+		algo.digest_len  = 16;
+		algo.big_endian  = FALSE;
+		break;
+	case P_CRYPTO_HASH_TYPE_SHA1:
+		algo.func        = pzcrypto_hash_many_sha1_avx2;
+		algo.iv          = pzcrypto_hash_many_sha1_iv;
+		algo.state_words = 5;
+		algo.digest_len  = 20;
+		algo.big_endian  = TRUE;
+		break;
+	case P_CRYPTO_HASH_TYPE_SHA2_224:
+		algo.func        = pzcrypto_hash_many_sha2_256_avx2;
+		algo.iv          = pzcrypto_hash_many_sha2_224_iv;
+		algo.state_words = 8;
+		algo.digest_len  = 28;
+		algo.big_endian  = TRUE;
+		break;
+	case P_CRYPTO_HASH_TYPE_SHA2_256:
+		algo.func        = pzcrypto_hash_many_sha2_256_avx2;
+		algo.iv          = pzcrypto_hash_many_sha2_256_iv;
+		algo.state_words = 8;
+		algo.digest_len  = 32;
+		algo.big_endian  = TRUE;
+		break;
+	case P_CRYPTO_HASH_TYPE_SHA3_224:
+		pzcrypto_hash_many_sha3_run (28, inputs, lengths, digests, count);
+		return TRUE;
+	case P_CRYPTO_HASH_TYPE_SHA3_256:
+		pzcrypto_hash_many_sha3_run (32, inputs, lengths, digests, count);
+		return TRUE;
+	case P_CRYPTO_HASH_TYPE_SHA3_384:
+		pzcrypto_hash_many_sha3_run (48, inputs, lengths, digests, count);
+		return TRUE;
+	case P_CRYPTO_HASH_TYPE_SHA3_512:
+		pzcrypto_hash_many_sha3_run (64, inputs, lengths, digests, count);
+		return TRUE;
+	default:
+		return FALSE;
+	}
+
+	pzcrypto_hash_many_run (&algo, inputs, lengths, digests, count);
+
+	return TRUE;
+#else
+	P_UNUSED (type);
+	P_UNUSED (inputs);
+	P_UNUSED (lengths);
+	P_UNUSED (digests);
+	P_UNUSED (count);
+
+	return FALSE;
+#endif
+}
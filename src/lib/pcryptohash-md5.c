@@ -29,17 +29,6 @@
 #include <string.h>
 #include <stdlib.h>
 
-struct PHashMD5_ {
-	union buf_ {
-		puchar	buf[64];
-		puint32	buf_w[16];
-	} buf;
-	puint32		hash[4];
-
-	puint32		len_high;
-	puint32		len_low;
-};
-
 static const puchar pzcrypto_hash_md5_pad[64] = {
 	0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 	   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -184,17 +173,10 @@ zcrypto_hash_md5_reset (PHashMD5 *ctx)
 	ctx->hash[3] = 0x10325476;
 }
 
-PHashMD5 *
-zcrypto_hash_md5_new (void)
+void
+zcrypto_hash_md5_init (PHashMD5 *ctx)
 {
-	PHashMD5 *ret;
-
-	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PHashMD5))) == NULL))
-		return NULL;
-
-	zcrypto_hash_md5_reset (ret);
-
-	return ret;
+	zcrypto_hash_md5_reset (ctx);
 }
 
 void
@@ -265,9 +247,3 @@ zcrypto_hash_md5_digest (PHashMD5 *ctx)
 {
 	return (const puchar *) ctx->hash;
 }
-
-void
-zcrypto_hash_md5_free (PHashMD5 *ctx)
-{
-	zfree (ctx);
-}
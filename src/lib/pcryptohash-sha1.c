@@ -28,17 +28,13 @@
 
 #include "pmem.h"
 #include "pcryptohash-sha1.h"
+#include "pcpuinfo-private.h"
 
-struct PHashSHA1_ {
-	union buf_ {
-		puchar	buf[64];
-		puint32	buf_w[16];
-	} buf;
-	puint32		hash[5];
-
-	puint32		len_high;
-	puint32		len_low;
-};
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+#  include <immintrin.h>
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+#  include <arm_neon.h>
+#endif
 
 static const puchar pzcrypto_hash_sha1_pad[64] = {
 	0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -48,7 +44,14 @@ static const puchar pzcrypto_hash_sha1_pad[64] = {
 };
 
 static void pzcrypto_hash_sha1_swazbytes (puint32 *data, puint words);
-static void pzcrypto_hash_sha1_process (PHashSHA1 *ctx, const puint32 data[16]);
+static void pzcrypto_hash_sha1_process (PHashSHA1 *ctx, const puchar data[64]);
+static void pzcrypto_hash_sha1_process_blocks (PHashSHA1 *ctx, const puchar *data, psize blocks);
+
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+static P_CPU_TARGET ("sha,sse4.1") void pzcrypto_hash_sha1_process_shani (puint32 hash[5], const puchar *data, psize blocks);
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+static P_CPU_TARGET ("+crypto") void pzcrypto_hash_sha1_process_arm (puint32 hash[5], const puchar *data, psize blocks);
+#endif
 
 #define P_SHA1_ROTL(val, shift) ((val) << (shift) |  (val) >> (32 - (shift)))
 
@@ -111,7 +114,7 @@ pzcrypto_hash_sha1_swazbytes (puint32	*data,
 
 static void
 pzcrypto_hash_sha1_process (PHashSHA1		*ctx,
-			     const puint32	data[16])
+			     const puchar	data[64])
 {
 	puint32	W[16], A, B, C, D, E;
 
@@ -119,6 +122,7 @@ pzcrypto_hash_sha1_process (PHashSHA1		*ctx,
 		return;
 
 	memcpy (W, data, 64);
+	pzcrypto_hash_sha1_swazbytes (W, 16);
 
 	A = ctx->hash[0];
 	B = ctx->hash[1];
@@ -217,6 +221,392 @@ pzcrypto_hash_sha1_process (PHashSHA1		*ctx,
 	ctx->hash[4] += E;
 }
 
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+/* Intel SHA extensions: ABCD is kept in a single register in the reversed
+ * order, E is carried in the highest lane of a separate one and is merged
+ * into the message words by SHA1NEXTE */
+static P_CPU_TARGET ("sha,sse4.1") void
+pzcrypto_hash_sha1_process_shani (puint32	hash[5],
+				   const puchar	*data,
+				   psize	blocks)
+{
+	__m128i	abcd, abcd_save, e0, e1, e_save;
+	__m128i	msg0, msg1, msg2, msg3;
+	__m128i	mask;
+
+	mask = _mm_set_epi64x (0x0001020304050607LL, 0x08090A0B0C0D0E0FLL);
+	abcd = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *) hash), 0x1B);
+	e0   = _mm_set_epi32 ((pint) hash[4], 0, 0, 0);
+
+	while (blocks-- > 0) {
+		abcd_save = abcd;
+		e_save    = e0;
+
+		/* Rounds 0-3 */
+		msg0 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 0)), mask);
+		e0 = _mm_add_epi32 (e0, msg0);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 0);
+
+		/* Rounds 4-7 */
+		msg1 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 16)), mask);
+		e1 = _mm_sha1nexte_epu32 (e1, msg1);
+		e0 = abcd;
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 0);
+		msg0 = _mm_sha1msg1_epu32 (msg0, msg1);
+
+		/* Rounds 8-11 */
+		msg2 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 32)), mask);
+		e0 = _mm_sha1nexte_epu32 (e0, msg2);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 0);
+		msg1 = _mm_sha1msg1_epu32 (msg1, msg2);
+		msg0 = _mm_xor_si128 (msg0, msg2);
+
+		/* Rounds 12-15 */
+		msg3 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 48)), mask);
+		e1 = _mm_sha1nexte_epu32 (e1, msg3);
+		e0 = abcd;
+		msg0 = _mm_sha1msg2_epu32 (msg0, msg3);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 0);
+		msg2 = _mm_sha1msg1_epu32 (msg2, msg3);
+		msg1 = _mm_xor_si128 (msg1, msg3);
+
+		/* Rounds 16-19 */
+		e0 = _mm_sha1nexte_epu32 (e0, msg0);
+		e1 = abcd;
+		msg1 = _mm_sha1msg2_epu32 (msg1, msg0);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 0);
+		msg3 = _mm_sha1msg1_epu32 (msg3, msg0);
+		msg2 = _mm_xor_si128 (msg2, msg0);
+
+		/* Rounds 20-23 */
+		e1 = _mm_sha1nexte_epu32 (e1, msg1);
+		e0 = abcd;
+		msg2 = _mm_sha1msg2_epu32 (msg2, msg1);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 1);
+		msg0 = _mm_sha1msg1_epu32 (msg0, msg1);
+		msg3 = _mm_xor_si128 (msg3, msg1);
+
+		/* Rounds 24-27 */
+		e0 = _mm_sha1nexte_epu32 (e0, msg2);
+		e1 = abcd;
+		msg3 = _mm_sha1msg2_epu32 (msg3, msg2);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 1);
+		msg1 = _mm_sha1msg1_epu32 (msg1, msg2);
+		msg0 = _mm_xor_si128 (msg0, msg2);
+
+		/* Rounds 28-31 */
+		e1 = _mm_sha1nexte_epu32 (e1, msg3);
+		e0 = abcd;
+		msg0 = _mm_sha1msg2_epu32 (msg0, msg3);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 1);
+		msg2 = _mm_sha1msg1_epu32 (msg2, msg3);
+		msg1 = _mm_xor_si128 (msg1, msg3);
+
+		/* Rounds 32-35 */
+		e0 = _mm_sha1nexte_epu32 (e0, msg0);
+		e1 = abcd;
+		msg1 = _mm_sha1msg2_epu32 (msg1, msg0);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 1);
+		msg3 = _mm_sha1msg1_epu32 (msg3, msg0);
+		msg2 = _mm_xor_si128 (msg2, msg0);
+
+		/* Rounds 36-39 */
+		e1 = _mm_sha1nexte_epu32 (e1, msg1);
+		e0 = abcd;
+		msg2 = _mm_sha1msg2_epu32 (msg2, msg1);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 1);
+		msg0 = _mm_sha1msg1_epu32 (msg0, msg1);
+		msg3 = _mm_xor_si128 (msg3, msg1);
+
+		/* Rounds 40-43 */
+		e0 = _mm_sha1nexte_epu32 (e0, msg2);
+		e1 = abcd;
+		msg3 = _mm_sha1msg2_epu32 (msg3, msg2);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 2);
+		msg1 = _mm_sha1msg1_epu32 (msg1, msg2);
+		msg0 = _mm_xor_si128 (msg0, msg2);
+
+		/* Rounds 44-47 */
+		e1 = _mm_sha1nexte_epu32 (e1, msg3);
+		e0 = abcd;
+		msg0 = _mm_sha1msg2_epu32 (msg0, msg3);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 2);
+		msg2 = _mm_sha1msg1_epu32 (msg2, msg3);
+		msg1 = _mm_xor_si128 (msg1, msg3);
+
+		/* Rounds 48-51 */
+		e0 = _mm_sha1nexte_epu32 (e0, msg0);
+		e1 = abcd;
+		msg1 = _mm_sha1msg2_epu32 (msg1, msg0);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 2);
+		msg3 = _mm_sha1msg1_epu32 (msg3, msg0);
+		msg2 = _mm_xor_si128 (msg2, msg0);
+
+		/* Rounds 52-55 */
+		e1 = _mm_sha1nexte_epu32 (e1, msg1);
+		e0 = abcd;
+		msg2 = _mm_sha1msg2_epu32 (msg2, msg1);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 2);
+		msg0 = _mm_sha1msg1_epu32 (msg0, msg1);
+		msg3 = _mm_xor_si128 (msg3, msg1);
+
+		/* Rounds 56-59 */
+		e0 = _mm_sha1nexte_epu32 (e0, msg2);
+		e1 = abcd;
+		msg3 = _mm_sha1msg2_epu32 (msg3, msg2);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 2);
+		msg1 = _mm_sha1msg1_epu32 (msg1, msg2);
+		msg0 = _mm_xor_si128 (msg0, msg2);
+
+		/* Rounds 60-63 */
+		e1 = _mm_sha1nexte_epu32 (e1, msg3);
+		e0 = abcd;
+		msg0 = _mm_sha1msg2_epu32 (msg0, msg3);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 3);
+		msg2 = _mm_sha1msg1_epu32 (msg2, msg3);
+		msg1 = _mm_xor_si128 (msg1, msg3);
+
+		/* Rounds 64-67 */
+		e0 = _mm_sha1nexte_epu32 (e0, msg0);
+		e1 = abcd;
+		msg1 = _mm_sha1msg2_epu32 (msg1, msg0);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 3);
+		msg3 = _mm_sha1msg1_epu32 (msg3, msg0);
+		msg2 = _mm_xor_si128 (msg2, msg0);
+
+		/* Rounds 68-71 */
+		e1 = _mm_sha1nexte_epu32 (e1, msg1);
+		e0 = abcd;
+		msg2 = _mm_sha1msg2_epu32 (msg2, msg1);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 3);
+		msg3 = _mm_xor_si128 (msg3, msg1);
+
+		/* Rounds 72-75 */
+		e0 = _mm_sha1nexte_epu32 (e0, msg2);
+		e1 = abcd;
+		msg3 = _mm_sha1msg2_epu32 (msg3, msg2);
+		abcd = _mm_sha1rnds4_epu32 (abcd, e0, 3);
+
+		/* Rounds 76-79 */
+		e1 = _mm_sha1nexte_epu32 (e1, msg3);
+		e0 = abcd;
+		abcd = _mm_sha1rnds4_epu32 (abcd, e1, 3);
+		e0   = _mm_sha1nexte_epu32 (e0, e_save);
+		abcd = _mm_add_epi32 (abcd, abcd_save);
+
+		data += 64;
+	}
+
+	_mm_storeu_si128 ((__m128i *) hash, _mm_shuffle_epi32 (abcd, 0x1B));
+	hash[4] = (puint32) _mm_extract_epi32 (e0, 3);
+}
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+/* ARMv8 cryptography extension, four rounds per instruction with the
+ * message schedule computed by SHA1SU0/SHA1SU1 */
+static P_CPU_TARGET ("+crypto") void
+pzcrypto_hash_sha1_process_arm (puint32		hash[5],
+				const puchar	*data,
+				psize		blocks)
+{
+	uint32x4_t	abcd, abcd_save;
+	uint32x4_t	msg0, msg1, msg2, msg3;
+	uint32x4_t	tmp0, tmp1;
+	uint32x4_t	k0, k1, k2, k3;
+	uint32_t	e0, e1, e_save;
+
+	k0 = vdupq_n_u32 (0x5A827999);
+	k1 = vdupq_n_u32 (0x6ED9EBA1);
+	k2 = vdupq_n_u32 (0x8F1BBCDC);
+	k3 = vdupq_n_u32 (0xCA62C1D6);
+
+	abcd = vld1q_u32 (hash);
+	e0   = hash[4];
+
+	while (blocks-- > 0) {
+		abcd_save = abcd;
+		e_save    = e0;
+
+		msg0 = vreinterpretq_u32_u8 (vld1q_u8 (data + 0));
+		msg1 = vreinterpretq_u32_u8 (vld1q_u8 (data + 16));
+		msg2 = vreinterpretq_u32_u8 (vld1q_u8 (data + 32));
+		msg3 = vreinterpretq_u32_u8 (vld1q_u8 (data + 48));
+
+#  ifndef PLIBSYS_IS_BIGENDIAN
+		msg0 = vreinterpretq_u32_u8 (vrev32q_u8 (vreinterpretq_u8_u32 (msg0)));
+		msg1 = vreinterpretq_u32_u8 (vrev32q_u8 (vreinterpretq_u8_u32 (msg1)));
+		msg2 = vreinterpretq_u32_u8 (vrev32q_u8 (vreinterpretq_u8_u32 (msg2)));
+		msg3 = vreinterpretq_u32_u8 (vrev32q_u8 (vreinterpretq_u8_u32 (msg3)));
+#  endif
+
+		tmp0 = vaddq_u32 (msg0, k0);
+		tmp1 = vaddq_u32 (msg1, k0);
+
+		/* Rounds 0-3 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1cq_u32 (abcd, e0, tmp0);
+		tmp0 = vaddq_u32 (msg2, k0);
+		msg0 = vsha1su0q_u32 (msg0, msg1, msg2);
+
+		/* Rounds 4-7 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1cq_u32 (abcd, e1, tmp1);
+		tmp1 = vaddq_u32 (msg3, k0);
+		msg0 = vsha1su1q_u32 (msg0, msg3);
+		msg1 = vsha1su0q_u32 (msg1, msg2, msg3);
+
+		/* Rounds 8-11 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1cq_u32 (abcd, e0, tmp0);
+		tmp0 = vaddq_u32 (msg0, k0);
+		msg1 = vsha1su1q_u32 (msg1, msg0);
+		msg2 = vsha1su0q_u32 (msg2, msg3, msg0);
+
+		/* Rounds 12-15 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1cq_u32 (abcd, e1, tmp1);
+		tmp1 = vaddq_u32 (msg1, k1);
+		msg2 = vsha1su1q_u32 (msg2, msg1);
+		msg3 = vsha1su0q_u32 (msg3, msg0, msg1);
+
+		/* Rounds 16-19 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1cq_u32 (abcd, e0, tmp0);
+		tmp0 = vaddq_u32 (msg2, k1);
+		msg3 = vsha1su1q_u32 (msg3, msg2);
+		msg0 = vsha1su0q_u32 (msg0, msg1, msg2);
+
+		/* Rounds 20-23 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e1, tmp1);
+		tmp1 = vaddq_u32 (msg3, k1);
+		msg0 = vsha1su1q_u32 (msg0, msg3);
+		msg1 = vsha1su0q_u32 (msg1, msg2, msg3);
+
+		/* Rounds 24-27 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e0, tmp0);
+		tmp0 = vaddq_u32 (msg0, k1);
+		msg1 = vsha1su1q_u32 (msg1, msg0);
+		msg2 = vsha1su0q_u32 (msg2, msg3, msg0);
+
+		/* Rounds 28-31 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e1, tmp1);
+		tmp1 = vaddq_u32 (msg1, k1);
+		msg2 = vsha1su1q_u32 (msg2, msg1);
+		msg3 = vsha1su0q_u32 (msg3, msg0, msg1);
+
+		/* Rounds 32-35 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e0, tmp0);
+		tmp0 = vaddq_u32 (msg2, k2);
+		msg3 = vsha1su1q_u32 (msg3, msg2);
+		msg0 = vsha1su0q_u32 (msg0, msg1, msg2);
+
+		/* Rounds 36-39 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e1, tmp1);
+		tmp1 = vaddq_u32 (msg3, k2);
+		msg0 = vsha1su1q_u32 (msg0, msg3);
+		msg1 = vsha1su0q_u32 (msg1, msg2, msg3);
+
+		/* Rounds 40-43 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1mq_u32 (abcd, e0, tmp0);
+		tmp0 = vaddq_u32 (msg0, k2);
+		msg1 = vsha1su1q_u32 (msg1, msg0);
+		msg2 = vsha1su0q_u32 (msg2, msg3, msg0);
+
+		/* Rounds 44-47 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1mq_u32 (abcd, e1, tmp1);
+		tmp1 = vaddq_u32 (msg1, k2);
+		msg2 = vsha1su1q_u32 (msg2, msg1);
+		msg3 = vsha1su0q_u32 (msg3, msg0, msg1);
+
+		/* Rounds 48-51 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1mq_u32 (abcd, e0, tmp0);
+		tmp0 = vaddq_u32 (msg2, k2);
+		msg3 = vsha1su1q_u32 (msg3, msg2);
+		msg0 = vsha1su0q_u32 (msg0, msg1, msg2);
+
+		/* Rounds 52-55 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1mq_u32 (abcd, e1, tmp1);
+		tmp1 = vaddq_u32 (msg3, k3);
+		msg0 = vsha1su1q_u32 (msg0, msg3);
+		msg1 = vsha1su0q_u32 (msg1, msg2, msg3);
+
+		/* Rounds 56-59 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1mq_u32 (abcd, e0, tmp0);
+		tmp0 = vaddq_u32 (msg0, k3);
+		msg1 = vsha1su1q_u32 (msg1, msg0);
+		msg2 = vsha1su0q_u32 (msg2, msg3, msg0);
+
+		/* Rounds 60-63 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e1, tmp1);
+		tmp1 = vaddq_u32 (msg1, k3);
+		msg2 = vsha1su1q_u32 (msg2, msg1);
+		msg3 = vsha1su0q_u32 (msg3, msg0, msg1);
+
+		/* Rounds 64-67 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e0, tmp0);
+		tmp0 = vaddq_u32 (msg2, k3);
+		msg3 = vsha1su1q_u32 (msg3, msg2);
+
+		/* Rounds 68-71 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e1, tmp1);
+		tmp1 = vaddq_u32 (msg3, k3);
+
+		/* Rounds 72-75 */
+		e1 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e0, tmp0);
+
+		/* Rounds 76-79 */
+		e0 = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+		abcd = vsha1pq_u32 (abcd, e1, tmp1);
+		abcd = vaddq_u32 (abcd, abcd_save);
+		e0  += e_save;
+
+		data += 64;
+	}
+
+	vst1q_u32 (hash, abcd);
+	hash[4] = e0;
+}
+#endif
+
+/* Processes full blocks of the raw (big-endian) input */
+static void
+pzcrypto_hash_sha1_process_blocks (PHashSHA1	*ctx,
+				    const puchar	*data,
+				    psize		blocks)
+{
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+	if (zcpu_info_has_feature (P_CPU_FEATURE_SHA) && zcpu_info_has_feature (P_CPU_FEATURE_SSE41)) {
+		pzcrypto_hash_sha1_process_shani (ctx->hash, data, blocks);
+		return;
+	}
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+	if (zcpu_info_has_feature (P_CPU_FEATURE_ARM_SHA1)) {
+		pzcrypto_hash_sha1_process_arm (ctx->hash, data, blocks);
+		return;
+	}
+#endif
+
+	while (blocks-- > 0) {
+		pzcrypto_hash_sha1_process (ctx, data);
+		data += 64;
+	}
+}
+
 void
 zcrypto_hash_sha1_reset (PHashSHA1 *ctx)
 {
@@ -232,17 +622,10 @@ zcrypto_hash_sha1_reset (PHashSHA1 *ctx)
 	ctx->hash[4] = 0xC3D2E1F0;
 }
 
-PHashSHA1 *
-zcrypto_hash_sha1_new (void)
+void
+zcrypto_hash_sha1_init (PHashSHA1 *ctx)
 {
-	PHashSHA1 *ret;
-
-	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PHashSHA1))) == NULL))
-		return NULL;
-
-	zcrypto_hash_sha1_reset (ret);
-
-	return ret;
+	zcrypto_hash_sha1_reset (ctx);
 }
 
 void
@@ -262,21 +645,18 @@ zcrypto_hash_sha1_update (PHashSHA1	*ctx,
 
 	if (left && (puint32) len >= to_fill) {
 		memcpy (ctx->buf.buf + left, data, to_fill);
-		pzcrypto_hash_sha1_swazbytes (ctx->buf.buf_w, 16);
-		pzcrypto_hash_sha1_process (ctx, ctx->buf.buf_w);
+		pzcrypto_hash_sha1_process_blocks (ctx, ctx->buf.buf, 1);
 
 		data += to_fill;
 		len -= to_fill;
 		left = 0;
 	}
 
-	while (len >= 64) {
-		memcpy (ctx->buf.buf, data, 64);
-		pzcrypto_hash_sha1_swazbytes (ctx->buf.buf_w, 16);
-		pzcrypto_hash_sha1_process (ctx, ctx->buf.buf_w);
+	if (len >= 64) {
+		pzcrypto_hash_sha1_process_blocks (ctx, data, len / 64);
 
-		data += 64;
-		len -= 64;
+		data += len & ~((psize) 0x3F);
+		len &= 0x3F;
 	}
 
 	if (len > 0)
@@ -302,8 +682,8 @@ zcrypto_hash_sha1_finish (PHashSHA1 *ctx)
 	ctx->buf.buf_w[14] = high;
 	ctx->buf.buf_w[15] = low;
 
-	pzcrypto_hash_sha1_swazbytes (ctx->buf.buf_w, 14);
-	pzcrypto_hash_sha1_process (ctx, ctx->buf.buf_w);
+	pzcrypto_hash_sha1_swazbytes (ctx->buf.buf_w + 14, 2);
+	pzcrypto_hash_sha1_process_blocks (ctx, ctx->buf.buf, 1);
 
 	pzcrypto_hash_sha1_swazbytes (ctx->hash, 5);
 }
@@ -313,9 +693,3 @@ zcrypto_hash_sha1_digest (PHashSHA1 *ctx)
 {
 	return (const puchar *) ctx->hash;
 }
-
-void
-zcrypto_hash_sha1_free (PHashSHA1 *ctx)
-{
-	zfree (ctx);
-}
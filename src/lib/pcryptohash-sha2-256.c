@@ -28,19 +28,13 @@
 
 #include "pmem.h"
 #include "pcryptohash-sha2-256.h"
+#include "pcpuinfo-private.h"
 
-struct PHashSHA2_256_ {
-	union buf_ {
-		puchar	buf[64];
-		puint32	buf_w[16];
-	} buf;
-	puint32		hash[8];
-
-	puint32		len_high;
-	puint32		len_low;
-
-	pboolean	is224;
-};
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+#  include <immintrin.h>
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+#  include <arm_neon.h>
+#endif
 
 static const puchar pzcrypto_hash_sha2_256_pad[64] = {
 	0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -69,8 +63,15 @@ static const puint32 pzcrypto_hash_sha2_256_K[] = {
 };
 
 static void pzcrypto_hash_sha2_256_swazbytes (puint32 *data, puint words);
-static void pzcrypto_hash_sha2_256_process (PHashSHA2_256 *ctx, const puint32 data[16]);
-static PHashSHA2_256 * pzcrypto_hash_sha2_256_new_internal (pboolean is224);
+static void pzcrypto_hash_sha2_256_process (PHashSHA2_256 *ctx, const puchar data[64]);
+static void pzcrypto_hash_sha2_256_process_blocks (PHashSHA2_256 *ctx, const puchar *data, psize blocks);
+static void pzcrypto_hash_sha2_256_init_internal (PHashSHA2_256 *ctx, pboolean is224);
+
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+static P_CPU_TARGET ("sha,sse4.1") void pzcrypto_hash_sha2_256_process_shani (puint32 hash[8], const puchar *data, psize blocks);
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+static P_CPU_TARGET ("+crypto") void pzcrypto_hash_sha2_256_process_arm (puint32 hash[8], const puchar *data, psize blocks);
+#endif
 
 #define P_SHA2_256_SHR(val, shift) (((val) & 0xFFFFFFFF) >> (shift))
 #define P_SHA2_256_ROTR(val, shift) (P_SHA2_256_SHR(val, shift) | ((val) << (32 - (shift))))
@@ -114,7 +115,7 @@ pzcrypto_hash_sha2_256_swazbytes (puint32	*data,
 
 static void
 pzcrypto_hash_sha2_256_process (PHashSHA2_256	*ctx,
-				 const puint32	data[16])
+				 const puchar	data[64])
 {
 	puint32	tmzsum1, tmzsum2;
 	puint32 W[64];
@@ -125,6 +126,7 @@ pzcrypto_hash_sha2_256_process (PHashSHA2_256	*ctx,
 		A[i] = ctx->hash[i];
 
 	memcpy (W, data, 64);
+	pzcrypto_hash_sha2_256_swazbytes (W, 16);
 
 	for (i = 0; i < 16; i += 8) {
 		P_SHA2_256_P (A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], W[i + 0], pzcrypto_hash_sha2_256_K[i + 0]);
@@ -152,19 +154,368 @@ pzcrypto_hash_sha2_256_process (PHashSHA2_256	*ctx,
 		ctx->hash[i] += A[i];
 }
 
-static PHashSHA2_256 *
-pzcrypto_hash_sha2_256_new_internal (pboolean is224)
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+/* Intel SHA extensions: the state is kept as ABEF and CDGH register pairs,
+ * SHA256RNDS2 does two rounds using the low half of the message register */
+static P_CPU_TARGET ("sha,sse4.1") void
+pzcrypto_hash_sha2_256_process_shani (puint32		hash[8],
+				       const puchar	*data,
+				       psize		blocks)
 {
-	PHashSHA2_256 *ret;
+	__m128i	state0, state1, abef_save, cdgh_save;
+	__m128i	msg, msg0, msg1, msg2, msg3;
+	__m128i	mask, tmp;
+
+	mask   = _mm_set_epi64x (0x0C0D0E0F08090A0BLL, 0x0405060700010203LL);
+	tmp    = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *) hash), 0xB1);
+	state1 = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *) (hash + 4)), 0x1B);
+	state0 = _mm_alignr_epi8 (tmp, state1, 8);
+	state1 = _mm_blend_epi16 (state1, tmp, 0xF0);
+
+	while (blocks-- > 0) {
+		abef_save = state0;
+		cdgh_save = state1;
+
+		/* Rounds 0-3 */
+		msg0 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 0)), mask);
+		msg    = _mm_add_epi32 (msg0, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 0)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+
+		/* Rounds 4-7 */
+		msg1 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 16)), mask);
+		msg    = _mm_add_epi32 (msg1, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 4)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg0   = _mm_sha256msg1_epu32 (msg0, msg1);
+
+		/* Rounds 8-11 */
+		msg2 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 32)), mask);
+		msg    = _mm_add_epi32 (msg2, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 8)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg1   = _mm_sha256msg1_epu32 (msg1, msg2);
+
+		/* Rounds 12-15 */
+		msg3 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + 48)), mask);
+		msg    = _mm_add_epi32 (msg3, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 12)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg0   = _mm_add_epi32 (msg0, _mm_alignr_epi8 (msg3, msg2, 4));
+		msg0   = _mm_sha256msg2_epu32 (msg0, msg3);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg2   = _mm_sha256msg1_epu32 (msg2, msg3);
+
+		/* Rounds 16-19 */
+		msg    = _mm_add_epi32 (msg0, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 16)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg1   = _mm_add_epi32 (msg1, _mm_alignr_epi8 (msg0, msg3, 4));
+		msg1   = _mm_sha256msg2_epu32 (msg1, msg0);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg3   = _mm_sha256msg1_epu32 (msg3, msg0);
+
+		/* Rounds 20-23 */
+		msg    = _mm_add_epi32 (msg1, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 20)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg2   = _mm_add_epi32 (msg2, _mm_alignr_epi8 (msg1, msg0, 4));
+		msg2   = _mm_sha256msg2_epu32 (msg2, msg1);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg0   = _mm_sha256msg1_epu32 (msg0, msg1);
+
+		/* Rounds 24-27 */
+		msg    = _mm_add_epi32 (msg2, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 24)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg3   = _mm_add_epi32 (msg3, _mm_alignr_epi8 (msg2, msg1, 4));
+		msg3   = _mm_sha256msg2_epu32 (msg3, msg2);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg1   = _mm_sha256msg1_epu32 (msg1, msg2);
+
+		/* Rounds 28-31 */
+		msg    = _mm_add_epi32 (msg3, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 28)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg0   = _mm_add_epi32 (msg0, _mm_alignr_epi8 (msg3, msg2, 4));
+		msg0   = _mm_sha256msg2_epu32 (msg0, msg3);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg2   = _mm_sha256msg1_epu32 (msg2, msg3);
+
+		/* Rounds 32-35 */
+		msg    = _mm_add_epi32 (msg0, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 32)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg1   = _mm_add_epi32 (msg1, _mm_alignr_epi8 (msg0, msg3, 4));
+		msg1   = _mm_sha256msg2_epu32 (msg1, msg0);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg3   = _mm_sha256msg1_epu32 (msg3, msg0);
+
+		/* Rounds 36-39 */
+		msg    = _mm_add_epi32 (msg1, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 36)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg2   = _mm_add_epi32 (msg2, _mm_alignr_epi8 (msg1, msg0, 4));
+		msg2   = _mm_sha256msg2_epu32 (msg2, msg1);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg0   = _mm_sha256msg1_epu32 (msg0, msg1);
+
+		/* Rounds 40-43 */
+		msg    = _mm_add_epi32 (msg2, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 40)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg3   = _mm_add_epi32 (msg3, _mm_alignr_epi8 (msg2, msg1, 4));
+		msg3   = _mm_sha256msg2_epu32 (msg3, msg2);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg1   = _mm_sha256msg1_epu32 (msg1, msg2);
+
+		/* Rounds 44-47 */
+		msg    = _mm_add_epi32 (msg3, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 44)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg0   = _mm_add_epi32 (msg0, _mm_alignr_epi8 (msg3, msg2, 4));
+		msg0   = _mm_sha256msg2_epu32 (msg0, msg3);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg2   = _mm_sha256msg1_epu32 (msg2, msg3);
+
+		/* Rounds 48-51 */
+		msg    = _mm_add_epi32 (msg0, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 48)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg1   = _mm_add_epi32 (msg1, _mm_alignr_epi8 (msg0, msg3, 4));
+		msg1   = _mm_sha256msg2_epu32 (msg1, msg0);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		msg3   = _mm_sha256msg1_epu32 (msg3, msg0);
+
+		/* Rounds 52-55 */
+		msg    = _mm_add_epi32 (msg1, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 52)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg2   = _mm_add_epi32 (msg2, _mm_alignr_epi8 (msg1, msg0, 4));
+		msg2   = _mm_sha256msg2_epu32 (msg2, msg1);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+
+		/* Rounds 56-59 */
+		msg    = _mm_add_epi32 (msg2, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 56)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg3   = _mm_add_epi32 (msg3, _mm_alignr_epi8 (msg2, msg1, 4));
+		msg3   = _mm_sha256msg2_epu32 (msg3, msg2);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+
+		/* Rounds 60-63 */
+		msg    = _mm_add_epi32 (msg3, _mm_loadu_si128 ((const __m128i *) (pzcrypto_hash_sha2_256_K + 60)));
+		state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+		msg    = _mm_shuffle_epi32 (msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+		state0 = _mm_add_epi32 (state0, abef_save);
+		state1 = _mm_add_epi32 (state1, cdgh_save);
 
-	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PHashSHA2_256))) == NULL))
-		return NULL;
+		data += 64;
+	}
 
-	ret->is224 = is224;
+	tmp    = _mm_shuffle_epi32 (state0, 0x1B);
+	state1 = _mm_shuffle_epi32 (state1, 0xB1);
+	state0 = _mm_blend_epi16 (tmp, state1, 0xF0);
+	state1 = _mm_alignr_epi8 (state1, tmp, 8);
+
+	_mm_storeu_si128 ((__m128i *) hash, state0);
+	_mm_storeu_si128 ((__m128i *) (hash + 4), state1);
+}
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+/* ARMv8 cryptography extension, four rounds per SHA256H/SHA256H2 pair */
+static P_CPU_TARGET ("+crypto") void
+pzcrypto_hash_sha2_256_process_arm (puint32		hash[8],
+				     const puchar	*data,
+				     psize		blocks)
+{
+	uint32x4_t	state0, state1, abcd_save, efgh_save;
+	uint32x4_t	msg0, msg1, msg2, msg3;
+	uint32x4_t	tmp0, tmp1;
+
+	state0 = vld1q_u32 (hash);
+	state1 = vld1q_u32 (hash + 4);
+
+	while (blocks-- > 0) {
+		abcd_save = state0;
+		efgh_save = state1;
+
+		msg0 = vreinterpretq_u32_u8 (vld1q_u8 (data + 0));
+		msg1 = vreinterpretq_u32_u8 (vld1q_u8 (data + 16));
+		msg2 = vreinterpretq_u32_u8 (vld1q_u8 (data + 32));
+		msg3 = vreinterpretq_u32_u8 (vld1q_u8 (data + 48));
+
+#  ifndef PLIBSYS_IS_BIGENDIAN
+		msg0 = vreinterpretq_u32_u8 (vrev32q_u8 (vreinterpretq_u8_u32 (msg0)));
+		msg1 = vreinterpretq_u32_u8 (vrev32q_u8 (vreinterpretq_u8_u32 (msg1)));
+		msg2 = vreinterpretq_u32_u8 (vrev32q_u8 (vreinterpretq_u8_u32 (msg2)));
+		msg3 = vreinterpretq_u32_u8 (vrev32q_u8 (vreinterpretq_u8_u32 (msg3)));
+#  endif
+
+		/* Rounds 0-3 */
+		tmp0   = vaddq_u32 (msg0, vld1q_u32 (pzcrypto_hash_sha2_256_K + 0));
+		msg0   = vsha256su0q_u32 (msg0, msg1);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg0   = vsha256su1q_u32 (msg0, msg2, msg3);
+
+		/* Rounds 4-7 */
+		tmp0   = vaddq_u32 (msg1, vld1q_u32 (pzcrypto_hash_sha2_256_K + 4));
+		msg1   = vsha256su0q_u32 (msg1, msg2);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg1   = vsha256su1q_u32 (msg1, msg3, msg0);
+
+		/* Rounds 8-11 */
+		tmp0   = vaddq_u32 (msg2, vld1q_u32 (pzcrypto_hash_sha2_256_K + 8));
+		msg2   = vsha256su0q_u32 (msg2, msg3);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg2   = vsha256su1q_u32 (msg2, msg0, msg1);
+
+		/* Rounds 12-15 */
+		tmp0   = vaddq_u32 (msg3, vld1q_u32 (pzcrypto_hash_sha2_256_K + 12));
+		msg3   = vsha256su0q_u32 (msg3, msg0);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg3   = vsha256su1q_u32 (msg3, msg1, msg2);
+
+		/* Rounds 16-19 */
+		tmp0   = vaddq_u32 (msg0, vld1q_u32 (pzcrypto_hash_sha2_256_K + 16));
+		msg0   = vsha256su0q_u32 (msg0, msg1);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg0   = vsha256su1q_u32 (msg0, msg2, msg3);
+
+		/* Rounds 20-23 */
+		tmp0   = vaddq_u32 (msg1, vld1q_u32 (pzcrypto_hash_sha2_256_K + 20));
+		msg1   = vsha256su0q_u32 (msg1, msg2);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg1   = vsha256su1q_u32 (msg1, msg3, msg0);
+
+		/* Rounds 24-27 */
+		tmp0   = vaddq_u32 (msg2, vld1q_u32 (pzcrypto_hash_sha2_256_K + 24));
+		msg2   = vsha256su0q_u32 (msg2, msg3);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg2   = vsha256su1q_u32 (msg2, msg0, msg1);
+
+		/* Rounds 28-31 */
+		tmp0   = vaddq_u32 (msg3, vld1q_u32 (pzcrypto_hash_sha2_256_K + 28));
+		msg3   = vsha256su0q_u32 (msg3, msg0);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg3   = vsha256su1q_u32 (msg3, msg1, msg2);
+
+		/* Rounds 32-35 */
+		tmp0   = vaddq_u32 (msg0, vld1q_u32 (pzcrypto_hash_sha2_256_K + 32));
+		msg0   = vsha256su0q_u32 (msg0, msg1);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg0   = vsha256su1q_u32 (msg0, msg2, msg3);
+
+		/* Rounds 36-39 */
+		tmp0   = vaddq_u32 (msg1, vld1q_u32 (pzcrypto_hash_sha2_256_K + 36));
+		msg1   = vsha256su0q_u32 (msg1, msg2);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg1   = vsha256su1q_u32 (msg1, msg3, msg0);
+
+		/* Rounds 40-43 */
+		tmp0   = vaddq_u32 (msg2, vld1q_u32 (pzcrypto_hash_sha2_256_K + 40));
+		msg2   = vsha256su0q_u32 (msg2, msg3);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg2   = vsha256su1q_u32 (msg2, msg0, msg1);
+
+		/* Rounds 44-47 */
+		tmp0   = vaddq_u32 (msg3, vld1q_u32 (pzcrypto_hash_sha2_256_K + 44));
+		msg3   = vsha256su0q_u32 (msg3, msg0);
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		msg3   = vsha256su1q_u32 (msg3, msg1, msg2);
+
+		/* Rounds 48-51 */
+		tmp0   = vaddq_u32 (msg0, vld1q_u32 (pzcrypto_hash_sha2_256_K + 48));
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+
+		/* Rounds 52-55 */
+		tmp0   = vaddq_u32 (msg1, vld1q_u32 (pzcrypto_hash_sha2_256_K + 52));
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+
+		/* Rounds 56-59 */
+		tmp0   = vaddq_u32 (msg2, vld1q_u32 (pzcrypto_hash_sha2_256_K + 56));
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+
+		/* Rounds 60-63 */
+		tmp0   = vaddq_u32 (msg3, vld1q_u32 (pzcrypto_hash_sha2_256_K + 60));
+		tmp1   = state0;
+		state0 = vsha256hq_u32 (state0, state1, tmp0);
+		state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		state0 = vaddq_u32 (state0, abcd_save);
+		state1 = vaddq_u32 (state1, efgh_save);
 
-	zcrypto_hash_sha2_256_reset (ret);
+		data += 64;
+	}
 
-	return ret;
+	vst1q_u32 (hash, state0);
+	vst1q_u32 (hash + 4, state1);
+}
+#endif
+
+/* Processes full blocks of the raw (big-endian) input */
+static void
+pzcrypto_hash_sha2_256_process_blocks (PHashSHA2_256	*ctx,
+					const puchar	*data,
+					psize		blocks)
+{
+#if defined (PLIBSYS_HAS_X86_TARGET_ATTR)
+	if (zcpu_info_has_feature (P_CPU_FEATURE_SHA) && zcpu_info_has_feature (P_CPU_FEATURE_SSE41)) {
+		pzcrypto_hash_sha2_256_process_shani (ctx->hash, data, blocks);
+		return;
+	}
+#elif defined (PLIBSYS_HAS_ARM_TARGET_ATTR)
+	if (zcpu_info_has_feature (P_CPU_FEATURE_ARM_SHA2)) {
+		pzcrypto_hash_sha2_256_process_arm (ctx->hash, data, blocks);
+		return;
+	}
+#endif
+
+	while (blocks-- > 0) {
+		pzcrypto_hash_sha2_256_process (ctx, data);
+		data += 64;
+	}
+}
+
+static void
+pzcrypto_hash_sha2_256_init_internal (PHashSHA2_256	*ctx,
+				     pboolean		is224)
+{
+	ctx->is224 = is224;
+
+	zcrypto_hash_sha2_256_reset (ctx);
 }
 
 void
@@ -198,16 +549,16 @@ zcrypto_hash_sha2_256_reset (PHashSHA2_256 *ctx)
 	}
 }
 
-PHashSHA2_256 *
-zcrypto_hash_sha2_256_new (void)
+void
+zcrypto_hash_sha2_256_init (PHashSHA2_256 *ctx)
 {
-	return pzcrypto_hash_sha2_256_new_internal (FALSE);
+	pzcrypto_hash_sha2_256_init_internal (ctx, FALSE);
 }
 
-PHashSHA2_256 *
-zcrypto_hash_sha2_224_new (void)
+void
+zcrypto_hash_sha2_224_init (PHashSHA2_256 *ctx)
 {
-	return pzcrypto_hash_sha2_256_new_internal (TRUE);
+	pzcrypto_hash_sha2_256_init_internal (ctx, TRUE);
 }
 
 void
@@ -227,21 +578,18 @@ zcrypto_hash_sha2_256_update (PHashSHA2_256	*ctx,
 
 	if (left && (puint32) len >= to_fill) {
 		memcpy (ctx->buf.buf + left, data, to_fill);
-		pzcrypto_hash_sha2_256_swazbytes (ctx->buf.buf_w, 16);
-		pzcrypto_hash_sha2_256_process (ctx, ctx->buf.buf_w);
+		pzcrypto_hash_sha2_256_process_blocks (ctx, ctx->buf.buf, 1);
 
 		data += to_fill;
 		len -= to_fill;
 		left = 0;
 	}
 
-	while (len >= 64) {
-		memcpy (ctx->buf.buf, data, 64);
-		pzcrypto_hash_sha2_256_swazbytes (ctx->buf.buf_w, 16);
-		pzcrypto_hash_sha2_256_process (ctx, ctx->buf.buf_w);
+	if (len >= 64) {
+		pzcrypto_hash_sha2_256_process_blocks (ctx, data, len / 64);
 
-		data += 64;
-		len -= 64;
+		data += len & ~((psize) 0x3F);
+		len &= 0x3F;
 	}
 
 	if (len > 0)
@@ -267,8 +615,8 @@ zcrypto_hash_sha2_256_finish (PHashSHA2_256 *ctx)
 	ctx->buf.buf_w[14] = high;
 	ctx->buf.buf_w[15] = low;
 
-	pzcrypto_hash_sha2_256_swazbytes (ctx->buf.buf_w, 14);
-	pzcrypto_hash_sha2_256_process (ctx, ctx->buf.buf_w);
+	pzcrypto_hash_sha2_256_swazbytes (ctx->buf.buf_w + 14, 2);
+	pzcrypto_hash_sha2_256_process_blocks (ctx, ctx->buf.buf, 1);
 
 	pzcrypto_hash_sha2_256_swazbytes (ctx->hash, ctx->is224 == FALSE ? 8 : 7);
 }
@@ -278,9 +626,3 @@ zcrypto_hash_sha2_256_digest (PHashSHA2_256 *ctx)
 {
 	return (const puchar *) ctx->hash;
 }
-
-void
-zcrypto_hash_sha2_256_free (PHashSHA2_256 *ctx)
-{
-	zfree (ctx);
-}
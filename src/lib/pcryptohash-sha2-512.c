@@ -28,19 +28,14 @@
 
 #include "pmem.h"
 #include "pcryptohash-sha2-512.h"
+#include "pcpuinfo-private.h"
 
-struct PHashSHA2_512_ {
-	union buf_ {
-		puchar	buf[128];
-		puint64	buf_w[16];
-	} buf;
-	puint64		hash[8];
-
-	puint64		len_high;
-	puint64		len_low;
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+#  include <immintrin.h>
+#endif
 
-	pboolean	is384;
-};
+/* Number of blocks which are scheduled at once by the SIMD code */
+#define P_SHA2_512_SIMD_BLOCKS	4
 
 static const puchar pzcrypto_hash_sha2_512_pad[128] = {
 	0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -97,8 +92,16 @@ static const puint64 pzcrypto_hash_sha2_512_K[] = {
 };
 
 static void pzcrypto_hash_sha2_512_swazbytes (puint64 *data, puint words);
-static void pzcrypto_hash_sha2_512_process (PHashSHA2_512 *ctx, const puint64 data[16]);
-static PHashSHA2_512 * pzcrypto_hash_sha2_512_new_internal (pboolean is384);
+static void pzcrypto_hash_sha2_512_process (PHashSHA2_512 *ctx, const puchar data[128]);
+static void pzcrypto_hash_sha2_512_process_blocks (PHashSHA2_512 *ctx, const puchar *data, psize blocks);
+static void pzcrypto_hash_sha2_512_init_internal (PHashSHA2_512 *ctx, pboolean is384);
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+static void pzcrypto_hash_sha2_512_rounds (puint64 hash[8], const puint64 *wk);
+static P_CPU_TARGET ("avx2") void pzcrypto_hash_sha2_512_load_avx2 (const puchar *data, __m256i W[16]);
+static P_CPU_TARGET ("avx2") psize pzcrypto_hash_sha2_512_process_avx2 (puint64 hash[8], const puchar *data, psize blocks);
+static P_CPU_TARGET ("avx2,avx512f,avx512vl") psize pzcrypto_hash_sha2_512_process_avx512 (puint64 hash[8], const puchar *data, psize blocks);
+#endif
 
 #define P_SHA2_512_SHR(val, shift) ((val) >> (shift))
 #define P_SHA2_512_ROTR(val, shift) (P_SHA2_512_SHR(val, shift) | ((val) << (64 - (shift))))
@@ -119,6 +122,18 @@ static PHashSHA2_512 * pzcrypto_hash_sha2_512_new_internal (pboolean is384);
 	h = tmzsum1 + tmzsum2;						\
 }
 
+/* The same round with the constant already added to the message word, the
+ * majority function reuses (a ^ b) of the previous round as (b ^ c) */
+#define P_SHA2_512_PK(a, b, c, d, e, f, g, h, wk)				\
+{										\
+	tmzsum1 = h + P_SHA2_512_S3 (e) + P_SHA2_512_F1 (e, f, g) + wk;	\
+	tmzab   = a ^ b;							\
+	tmzsum2 = P_SHA2_512_S2 (a) + (b ^ (tmzab & tmzbc));			\
+	tmzbc   = tmzab;							\
+	d += tmzsum1;								\
+	h = tmzsum1 + tmzsum2;						\
+}
+
 static void
 pzcrypto_hash_sha2_512_swazbytes (puint64	*data,
 				    puint	words)
@@ -136,7 +151,7 @@ pzcrypto_hash_sha2_512_swazbytes (puint64	*data,
 
 static void
 pzcrypto_hash_sha2_512_process (PHashSHA2_512	*ctx,
-				 const puint64	data[16])
+				 const puchar	data[128])
 {
 	puint64	tmzsum1, tmzsum2;
 	puint64 W[80];
@@ -147,6 +162,7 @@ pzcrypto_hash_sha2_512_process (PHashSHA2_512	*ctx,
 		A[i] = ctx->hash[i];
 
 	memcpy (W, data, 128);
+	pzcrypto_hash_sha2_512_swazbytes (W, 16);
 
 	for (i = 16; i < 80; ++i)
 		W[i] = P_SHA2_512_S1 (W[i -  2]) + W[i -  7] + P_SHA2_512_S0 (W[i - 15]) + W[i - 16];
@@ -166,19 +182,184 @@ pzcrypto_hash_sha2_512_process (PHashSHA2_512	*ctx,
 		ctx->hash[i] += A[i];
 }
 
-static PHashSHA2_512 *
-pzcrypto_hash_sha2_512_new_internal (pboolean is384)
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+/* Rounds over the message words with the constants added, the words of the
+ * block are interleaved with the ones of the other scheduled blocks */
+static void
+pzcrypto_hash_sha2_512_rounds (puint64		hash[8],
+				const puint64	*wk)
+{
+	puint64	tmzsum1, tmzsum2;
+	puint64	tmzab, tmzbc;
+	puint64	A[8];
+	puint	i;
+
+	for (i = 0; i < 8; ++i)
+		A[i] = hash[i];
+
+	tmzbc = A[1] ^ A[2];
+
+	for (i = 0; i < 80; i += 8) {
+		P_SHA2_512_PK (A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], wk[(i + 0) * P_SHA2_512_SIMD_BLOCKS]);
+		P_SHA2_512_PK (A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], wk[(i + 1) * P_SHA2_512_SIMD_BLOCKS]);
+		P_SHA2_512_PK (A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], wk[(i + 2) * P_SHA2_512_SIMD_BLOCKS]);
+		P_SHA2_512_PK (A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], wk[(i + 3) * P_SHA2_512_SIMD_BLOCKS]);
+		P_SHA2_512_PK (A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], wk[(i + 4) * P_SHA2_512_SIMD_BLOCKS]);
+		P_SHA2_512_PK (A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], wk[(i + 5) * P_SHA2_512_SIMD_BLOCKS]);
+		P_SHA2_512_PK (A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], wk[(i + 6) * P_SHA2_512_SIMD_BLOCKS]);
+		P_SHA2_512_PK (A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], wk[(i + 7) * P_SHA2_512_SIMD_BLOCKS]);
+	}
+
+	for (i = 0; i < 8; ++i)
+		hash[i] += A[i];
+}
+
+/* Loads the first 16 words of four consecutive blocks, every vector holds
+ * the same word of all the blocks */
+static P_CPU_TARGET ("avx2") void
+pzcrypto_hash_sha2_512_load_avx2 (const puchar	*data,
+				   __m256i	W[16])
+{
+	__m256i	mask;
+	__m256i	r0, r1, r2, r3;
+	__m256i	t0, t1, t2, t3;
+	puint	i;
+
+	mask = _mm256_set_epi64x (0x08090A0B0C0D0E0FLL, 0x0001020304050607LL,
+				  0x08090A0B0C0D0E0FLL, 0x0001020304050607LL);
+
+	for (i = 0; i < 4; ++i) {
+		r0 = _mm256_shuffle_epi8 (_mm256_loadu_si256 ((const __m256i *) (data + 0 * 128 + i * 32)), mask);
+		r1 = _mm256_shuffle_epi8 (_mm256_loadu_si256 ((const __m256i *) (data + 1 * 128 + i * 32)), mask);
+		r2 = _mm256_shuffle_epi8 (_mm256_loadu_si256 ((const __m256i *) (data + 2 * 128 + i * 32)), mask);
+		r3 = _mm256_shuffle_epi8 (_mm256_loadu_si256 ((const __m256i *) (data + 3 * 128 + i * 32)), mask);
+
+		t0 = _mm256_unpacklo_epi64 (r0, r1);
+		t1 = _mm256_unpackhi_epi64 (r0, r1);
+		t2 = _mm256_unpacklo_epi64 (r2, r3);
+		t3 = _mm256_unpackhi_epi64 (r2, r3);
+
+		W[i * 4 + 0] = _mm256_permute2x128_si256 (t0, t2, 0x20);
+		W[i * 4 + 1] = _mm256_permute2x128_si256 (t1, t3, 0x20);
+		W[i * 4 + 2] = _mm256_permute2x128_si256 (t0, t2, 0x31);
+		W[i * 4 + 3] = _mm256_permute2x128_si256 (t1, t3, 0x31);
+	}
+}
+
+#define P_SHA2_512_ROTR_AVX2(val, shift) \
+	_mm256_or_si256 (_mm256_srli_epi64 (val, shift), _mm256_slli_epi64 (val, 64 - (shift)))
+
+/* The message schedules of four blocks are independent, so they are computed
+ * side by side in the vector lanes. The rounds are inherently serial and stay
+ * scalar, but they only have to add the precomputed words. */
+static P_CPU_TARGET ("avx2") psize
+pzcrypto_hash_sha2_512_process_avx2 (puint64		hash[8],
+				      const puchar	*data,
+				      psize		blocks)
+{
+	__m256i	W[80];
+	__m256i	s0, s1;
+	puint64	wk[80 * P_SHA2_512_SIMD_BLOCKS];
+	psize	processed;
+	puint	i;
+
+	for (processed = 0; blocks - processed >= P_SHA2_512_SIMD_BLOCKS; processed += P_SHA2_512_SIMD_BLOCKS) {
+		pzcrypto_hash_sha2_512_load_avx2 (data + processed * 128, W);
+
+		for (i = 16; i < 80; ++i) {
+			s0 = _mm256_xor_si256 (_mm256_xor_si256 (P_SHA2_512_ROTR_AVX2 (W[i - 15], 1),
+								 P_SHA2_512_ROTR_AVX2 (W[i - 15], 8)),
+					       _mm256_srli_epi64 (W[i - 15], 7));
+			s1 = _mm256_xor_si256 (_mm256_xor_si256 (P_SHA2_512_ROTR_AVX2 (W[i - 2], 19),
+								 P_SHA2_512_ROTR_AVX2 (W[i - 2], 61)),
+					       _mm256_srli_epi64 (W[i - 2], 6));
+
+			W[i] = _mm256_add_epi64 (_mm256_add_epi64 (s0, s1), _mm256_add_epi64 (W[i - 7], W[i - 16]));
+		}
+
+		for (i = 0; i < 80; ++i)
+			_mm256_storeu_si256 ((__m256i *) (wk + i * P_SHA2_512_SIMD_BLOCKS),
+					     _mm256_add_epi64 (W[i], _mm256_set1_epi64x ((pint64) pzcrypto_hash_sha2_512_K[i])));
+
+		for (i = 0; i < P_SHA2_512_SIMD_BLOCKS; ++i)
+			pzcrypto_hash_sha2_512_rounds (hash, wk + i);
+	}
+
+	return processed;
+}
+
+/* AVX-512 adds the 64-bit rotation instruction, which halves the schedule
+ * cost */
+static P_CPU_TARGET ("avx2,avx512f,avx512vl") psize
+pzcrypto_hash_sha2_512_process_avx512 (puint64		hash[8],
+					const puchar	*data,
+					psize		blocks)
+{
+	__m256i	W[80];
+	__m256i	s0, s1;
+	puint64	wk[80 * P_SHA2_512_SIMD_BLOCKS];
+	psize	processed;
+	puint	i;
+
+	for (processed = 0; blocks - processed >= P_SHA2_512_SIMD_BLOCKS; processed += P_SHA2_512_SIMD_BLOCKS) {
+		pzcrypto_hash_sha2_512_load_avx2 (data + processed * 128, W);
+
+		for (i = 16; i < 80; ++i) {
+			s0 = _mm256_ternarylogic_epi64 (_mm256_ror_epi64 (W[i - 15], 1),
+							_mm256_ror_epi64 (W[i - 15], 8),
+							_mm256_srli_epi64 (W[i - 15], 7),
+							0x96);
+			s1 = _mm256_ternarylogic_epi64 (_mm256_ror_epi64 (W[i - 2], 19),
+							_mm256_ror_epi64 (W[i - 2], 61),
+							_mm256_srli_epi64 (W[i - 2], 6),
+							0x96);
+
+			W[i] = _mm256_add_epi64 (_mm256_add_epi64 (s0, s1), _mm256_add_epi64 (W[i - 7], W[i - 16]));
+		}
+
+		for (i = 0; i < 80; ++i)
+			_mm256_storeu_si256 ((__m256i *) (wk + i * P_SHA2_512_SIMD_BLOCKS),
+					     _mm256_add_epi64 (W[i], _mm256_set1_epi64x ((pint64) pzcrypto_hash_sha2_512_K[i])));
+
+		for (i = 0; i < P_SHA2_512_SIMD_BLOCKS; ++i)
+			pzcrypto_hash_sha2_512_rounds (hash, wk + i);
+	}
+
+	return processed;
+}
+#endif
+
+/* Processes full blocks of the raw (big-endian) input */
+static void
+pzcrypto_hash_sha2_512_process_blocks (PHashSHA2_512	*ctx,
+					const puchar	*data,
+					psize		blocks)
 {
-	PHashSHA2_512 *ret;
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	psize processed = 0;
 
-	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PHashSHA2_512))) == NULL))
-		return NULL;
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX512))
+		processed = pzcrypto_hash_sha2_512_process_avx512 (ctx->hash, data, blocks);
+	else if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		processed = pzcrypto_hash_sha2_512_process_avx2 (ctx->hash, data, blocks);
 
-	ret->is384 = is384;
+	data   += processed * 128;
+	blocks -= processed;
+#endif
+
+	while (blocks-- > 0) {
+		pzcrypto_hash_sha2_512_process (ctx, data);
+		data += 128;
+	}
+}
 
-	zcrypto_hash_sha2_512_reset (ret);
+static void
+pzcrypto_hash_sha2_512_init_internal (PHashSHA2_512	*ctx,
+				     pboolean		is384)
+{
+	ctx->is384 = is384;
 
-	return ret;
+	zcrypto_hash_sha2_512_reset (ctx);
 }
 
 void
@@ -212,16 +393,16 @@ zcrypto_hash_sha2_512_reset (PHashSHA2_512 *ctx)
 	}
 }
 
-PHashSHA2_512 *
-zcrypto_hash_sha2_512_new (void)
+void
+zcrypto_hash_sha2_512_init (PHashSHA2_512 *ctx)
 {
-	return pzcrypto_hash_sha2_512_new_internal (FALSE);
+	pzcrypto_hash_sha2_512_init_internal (ctx, FALSE);
 }
 
-PHashSHA2_512 *
-zcrypto_hash_sha2_384_new (void)
+void
+zcrypto_hash_sha2_384_init (PHashSHA2_512 *ctx)
 {
-	return pzcrypto_hash_sha2_512_new_internal (TRUE);
+	pzcrypto_hash_sha2_512_init_internal (ctx, TRUE);
 }
 
 void
@@ -241,21 +422,18 @@ zcrypto_hash_sha2_512_update (PHashSHA2_512	*ctx,
 
 	if (left && (puint64) len >= to_fill) {
 		memcpy (ctx->buf.buf + left, data, to_fill);
-		pzcrypto_hash_sha2_512_swazbytes (ctx->buf.buf_w, 16);
-		pzcrypto_hash_sha2_512_process (ctx, ctx->buf.buf_w);
+		pzcrypto_hash_sha2_512_process (ctx, ctx->buf.buf);
 
 		data += to_fill;
 		len -= to_fill;
 		left = 0;
 	}
 
-	while (len >= 128) {
-		memcpy (ctx->buf.buf, data, 128);
-		pzcrypto_hash_sha2_512_swazbytes (ctx->buf.buf_w, 16);
-		pzcrypto_hash_sha2_512_process (ctx, ctx->buf.buf_w);
+	if (len >= 128) {
+		pzcrypto_hash_sha2_512_process_blocks (ctx, data, len / 128);
 
-		data += 128;
-		len -= 128;
+		data += len & ~((psize) 0x7F);
+		len &= 0x7F;
 	}
 
 	if (len > 0)
@@ -281,8 +459,8 @@ zcrypto_hash_sha2_512_finish (PHashSHA2_512 *ctx)
 	ctx->buf.buf_w[14] = high;
 	ctx->buf.buf_w[15] = low;
 
-	pzcrypto_hash_sha2_512_swazbytes (ctx->buf.buf_w, 14);
-	pzcrypto_hash_sha2_512_process (ctx, ctx->buf.buf_w);
+	pzcrypto_hash_sha2_512_swazbytes (ctx->buf.buf_w + 14, 2);
+	pzcrypto_hash_sha2_512_process (ctx, ctx->buf.buf);
 
 	pzcrypto_hash_sha2_512_swazbytes (ctx->hash, ctx->is384 == FALSE ? 8 : 6);
 }
@@ -292,9 +470,3 @@ zcrypto_hash_sha2_512_digest (PHashSHA2_512 *ctx)
 {
 	return (const puchar *) ctx->hash;
 }
-
-void
-zcrypto_hash_sha2_512_free (PHashSHA2_512 *ctx)
-{
-	zfree (ctx);
-}
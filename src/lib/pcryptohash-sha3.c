@@ -29,17 +29,6 @@
 #include "pmem.h"
 #include "pcryptohash-sha3.h"
 
-struct PHashSHA3_ {
-	union buf_ {
-		puchar	buf[200];
-		puint64	buf_w[25];
-	} buf;
-	puint64		hash[25];
-
-	puint32		len;
-	puint32		block_size;
-};
-
 static const puint64 pzcrypto_hash_sha3_K[] = {
 	0x0000000000000001ULL, 0x0000000000008082ULL,
 	0x800000000000808AULL, 0x8000000080008000ULL,
@@ -56,16 +45,91 @@ static const puint64 pzcrypto_hash_sha3_K[] = {
 };
 
 static void pzcrypto_hash_sha3_swazbytes (puint64 *data, puint words);
-static void pzcrypto_hash_sha3_keccak_theta (PHashSHA3 *ctx);
-static void pzcrypto_hash_sha3_keccak_rho_pi (PHashSHA3 *ctx);
-static void pzcrypto_hash_sha3_keccak_chi (PHashSHA3 *ctx);
-static void pzcrypto_hash_sha3_keccak_permutate (PHashSHA3 *ctx);
-static void pzcrypto_hash_sha3_process (PHashSHA3 *ctx, const puint64 *data);
-static PHashSHA3 * pzcrypto_hash_sha3_new_internal (puint bits);
+static puint64 pzcrypto_hash_sha3_read64 (const puchar *data);
+static void pzcrypto_hash_sha3_keccak_permutate (puint64 state[25]);
+static void pzcrypto_hash_sha3_process (PHashSHA3 *ctx, const puchar *data);
+static void pzcrypto_hash_sha3_init_internal (PHashSHA3 *ctx, puint bits);
 
 #define P_SHA3_SHL(val, shift) ((val) << (shift))
 #define P_SHA3_ROTL(val, shift) (P_SHA3_SHL(val, shift) | ((val) >> (64 - (shift))))
 
+/* One Keccak round (see [Keccak Reference, Section 2.3]) from the A state into
+ * the E state, the lanes are named after their (y, x) coordinates: b, g, k, m,
+ * s for y = 0..4 and a, e, i, o, u for x = 0..4.
+ *
+ * The lanes be, bi, go, ki, mi and sa are kept complemented, so chi needs a
+ * single NOT per plane instead of five (lane complementing transform, see
+ * [Keccak implementation overview, Section 2.2]). */
+#define P_SHA3_ROUND(A, E, k)									\
+{												\
+	Ca = A##ba ^ A##ga ^ A##ka ^ A##ma ^ A##sa;						\
+	Ce = A##be ^ A##ge ^ A##ke ^ A##me ^ A##se;						\
+	Ci = A##bi ^ A##gi ^ A##ki ^ A##mi ^ A##si;						\
+	Co = A##bo ^ A##go ^ A##ko ^ A##mo ^ A##so;						\
+	Cu = A##bu ^ A##gu ^ A##ku ^ A##mu ^ A##su;						\
+												\
+	Da = Cu ^ P_SHA3_ROTL (Ce, 1);								\
+	De = Ca ^ P_SHA3_ROTL (Ci, 1);								\
+	Di = Ce ^ P_SHA3_ROTL (Co, 1);								\
+	Do = Ci ^ P_SHA3_ROTL (Cu, 1);								\
+	Du = Co ^ P_SHA3_ROTL (Ca, 1);								\
+												\
+	Ba = A##ba ^ Da;									\
+	Be = P_SHA3_ROTL (A##ge ^ De, 44);							\
+	Bi = P_SHA3_ROTL (A##ki ^ Di, 43);							\
+	Bo = P_SHA3_ROTL (A##mo ^ Do, 21);							\
+	Bu = P_SHA3_ROTL (A##su ^ Du, 14);							\
+	E##ba = Ba ^ (Be | Bi) ^ (k);								\
+	E##be = Be ^ (~Bi | Bo);								\
+	E##bi = Bi ^ (Bo & Bu);									\
+	E##bo = Bo ^ (Bu | Ba);									\
+	E##bu = Bu ^ (Ba & Be);									\
+												\
+	Ba = P_SHA3_ROTL (A##bo ^ Do, 28);							\
+	Be = P_SHA3_ROTL (A##gu ^ Du, 20);							\
+	Bi = P_SHA3_ROTL (A##ka ^ Da, 3);							\
+	Bo = P_SHA3_ROTL (A##me ^ De, 45);							\
+	Bu = P_SHA3_ROTL (A##si ^ Di, 61);							\
+	E##ga = Ba ^ (Be | Bi);									\
+	E##ge = Be ^ (Bi & Bo);									\
+	E##gi = Bi ^ (Bo | ~Bu);								\
+	E##go = Bo ^ (Bu | Ba);									\
+	E##gu = Bu ^ (Ba & Be);									\
+												\
+	Ba = P_SHA3_ROTL (A##be ^ De, 1);							\
+	Be = P_SHA3_ROTL (A##gi ^ Di, 6);							\
+	Bi = P_SHA3_ROTL (A##ko ^ Do, 25);							\
+	Bo = P_SHA3_ROTL (A##mu ^ Du, 8);							\
+	Bu = P_SHA3_ROTL (A##sa ^ Da, 18);							\
+	E##ka = Ba ^ (Be | Bi);									\
+	E##ke = Be ^ (Bi & Bo);									\
+	E##ki = Bi ^ (~Bo & Bu);								\
+	E##ko = ~Bo ^ (Bu | Ba);								\
+	E##ku = Bu ^ (Ba & Be);									\
+												\
+	Ba = P_SHA3_ROTL (A##bu ^ Du, 27);							\
+	Be = P_SHA3_ROTL (A##ga ^ Da, 36);							\
+	Bi = P_SHA3_ROTL (A##ke ^ De, 10);							\
+	Bo = P_SHA3_ROTL (A##mi ^ Di, 15);							\
+	Bu = P_SHA3_ROTL (A##so ^ Do, 56);							\
+	E##ma = Ba ^ (Be & Bi);									\
+	E##me = Be ^ (Bi | Bo);									\
+	E##mi = Bi ^ (~Bo | Bu);								\
+	E##mo = ~Bo ^ (Bu & Ba);								\
+	E##mu = Bu ^ (Ba | Be);									\
+												\
+	Ba = P_SHA3_ROTL (A##bi ^ Di, 62);							\
+	Be = P_SHA3_ROTL (A##go ^ Do, 55);							\
+	Bi = P_SHA3_ROTL (A##ku ^ Du, 39);							\
+	Bo = P_SHA3_ROTL (A##ma ^ Da, 41);							\
+	Bu = P_SHA3_ROTL (A##se ^ De, 2);							\
+	E##sa = Ba ^ (~Be & Bi);								\
+	E##se = ~Be ^ (Bi | Bo);								\
+	E##si = Bi ^ (Bo & Bu);									\
+	E##so = Bo ^ (Bu | Ba);									\
+	E##su = Bu ^ (Ba & Be);									\
+}
+
 static void
 pzcrypto_hash_sha3_swazbytes (puint64	*data,
 				puint	words)
@@ -81,127 +145,71 @@ pzcrypto_hash_sha3_swazbytes (puint64	*data,
 #endif
 }
 
-/* Theta step (see [Keccak Reference, Section 2.3.2]) */
-static void
-pzcrypto_hash_sha3_keccak_theta (PHashSHA3 *ctx)
-{
-	puint	i;
-	puint64	C[5], D[5];
-
-	/* Compute the parity of the columns */
-	for (i = 0; i < 5; ++i)
-		C[i] = ctx->hash[i] ^ ctx->hash[i + 5] ^ ctx->hash[i + 10] ^ ctx->hash[i + 15] ^ ctx->hash[i + 20];
-
-	/* Compute the theta effect for a given column */
-	D[0] = P_SHA3_ROTL (C[1], 1) ^ C[4];
-	D[1] = P_SHA3_ROTL (C[2], 1) ^ C[0];
-	D[2] = P_SHA3_ROTL (C[3], 1) ^ C[1];
-	D[3] = P_SHA3_ROTL (C[4], 1) ^ C[2];
-	D[4] = P_SHA3_ROTL (C[0], 1) ^ C[3];
-
-	/* Add the theta effect to the whole column */
-	for (i = 0; i < 5; ++i) {
-		ctx->hash[i]      ^= D[i];
-		ctx->hash[i + 5]  ^= D[i];
-		ctx->hash[i + 10] ^= D[i];
-		ctx->hash[i + 15] ^= D[i];
-		ctx->hash[i + 20] ^= D[i];
-	}
-}
-
-/* Rho and pi steps (see [Keccak Reference, Sections 2.3.3 and 2.3.4]) */
-static void
-pzcrypto_hash_sha3_keccak_rho_pi (PHashSHA3 *ctx)
-{
-	puint64 tmzA;
-
-	/* Unroll the loop over ((0 1)(2 3))^t * (1 0) for 0 ≤ t ≤ 23 */
-	tmzA = ctx->hash[1];
-	ctx->hash[1]  = P_SHA3_ROTL (ctx->hash[6],  44);
-	ctx->hash[6]  = P_SHA3_ROTL (ctx->hash[9],  20);
-	ctx->hash[9]  = P_SHA3_ROTL (ctx->hash[22], 61);
-	ctx->hash[22] = P_SHA3_ROTL (ctx->hash[14], 39);
-	ctx->hash[14] = P_SHA3_ROTL (ctx->hash[20], 18);
-	ctx->hash[20] = P_SHA3_ROTL (ctx->hash[2],  62);
-	ctx->hash[2]  = P_SHA3_ROTL (ctx->hash[12], 43);
-	ctx->hash[12] = P_SHA3_ROTL (ctx->hash[13], 25);
-	ctx->hash[13] = P_SHA3_ROTL (ctx->hash[19],  8);
-	ctx->hash[19] = P_SHA3_ROTL (ctx->hash[23], 56);
-	ctx->hash[23] = P_SHA3_ROTL (ctx->hash[15], 41);
-	ctx->hash[15] = P_SHA3_ROTL (ctx->hash[4],  27);
-	ctx->hash[4]  = P_SHA3_ROTL (ctx->hash[24], 14);
-	ctx->hash[24] = P_SHA3_ROTL (ctx->hash[21],  2);
-	ctx->hash[21] = P_SHA3_ROTL (ctx->hash[8],  55);
-	ctx->hash[8]  = P_SHA3_ROTL (ctx->hash[16], 45);
-	ctx->hash[16] = P_SHA3_ROTL (ctx->hash[5],  36);
-	ctx->hash[5]  = P_SHA3_ROTL (ctx->hash[3],  28);
-	ctx->hash[3]  = P_SHA3_ROTL (ctx->hash[18], 21);
-	ctx->hash[18] = P_SHA3_ROTL (ctx->hash[17], 15);
-	ctx->hash[17] = P_SHA3_ROTL (ctx->hash[11], 10);
-	ctx->hash[11] = P_SHA3_ROTL (ctx->hash[7],   6);
-	ctx->hash[7]  = P_SHA3_ROTL (ctx->hash[10],  3);
-	ctx->hash[10] = P_SHA3_ROTL (tmzA, 1);
-}
-
-/* Chi step (see [Keccak Reference, Section 2.3.1]) */
-static void
-pzcrypto_hash_sha3_keccak_chi (PHashSHA3 *ctx)
+static puint64
+pzcrypto_hash_sha3_read64 (const puchar *data)
 {
-	puint i;
-	puint64	tmzA1, tmzA2;
+	puint64 val;
 
-	for (i = 0; i < 25; i += 5) {
-		tmzA1 = ctx->hash[i + 0];
-		tmzA2 = ctx->hash[i + 1];
+	memcpy (&val, data, sizeof (val));
 
-		ctx->hash[i + 0] ^= ~tmzA2 & ctx->hash[i + 2];
-		ctx->hash[i + 1] ^= ~ctx->hash[i + 2] & ctx->hash[i + 3];
-		ctx->hash[i + 2] ^= ~ctx->hash[i + 3] & ctx->hash[i + 4];
-		ctx->hash[i + 3] ^= ~ctx->hash[i + 4] & tmzA1;
-		ctx->hash[i + 4] ^= ~tmzA1 & tmzA2;
-	}
+	return PUINT64_FROM_LE (val);
 }
 
+/* The whole state is kept in local variables, two rounds per iteration swap
+ * the roles of the A and E states */
 static void
-pzcrypto_hash_sha3_keccak_permutate (PHashSHA3 *ctx)
+pzcrypto_hash_sha3_keccak_permutate (puint64 state[25])
 {
-	puint i;
+	puint64	Aba, Abe, Abi, Abo, Abu, Aga, Age, Agi, Ago, Agu, Aka, Ake, Aki, Ako, Aku;
+	puint64	Ama, Ame, Ami, Amo, Amu, Asa, Ase, Asi, Aso, Asu;
+	puint64	Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu, Eka, Eke, Eki, Eko, Eku;
+	puint64	Ema, Eme, Emi, Emo, Emu, Esa, Ese, Esi, Eso, Esu;
+	puint64	Ba, Be, Bi, Bo, Bu;
+	puint64	Ca, Ce, Ci, Co, Cu;
+	puint64	Da, De, Di, Do, Du;
+	puint	i;
 
-	for (i = 0; i < 24; ++i) {
-		pzcrypto_hash_sha3_keccak_theta (ctx);
-		pzcrypto_hash_sha3_keccak_rho_pi (ctx);
-		pzcrypto_hash_sha3_keccak_chi (ctx);
+	Aba =  state[0];  Abe = ~state[1];  Abi = ~state[2];  Abo =  state[3];  Abu =  state[4];
+	Aga =  state[5];  Age =  state[6];  Agi =  state[7];  Ago = ~state[8];  Agu =  state[9];
+	Aka =  state[10]; Ake =  state[11]; Aki = ~state[12]; Ako =  state[13]; Aku =  state[14];
+	Ama =  state[15]; Ame =  state[16]; Ami = ~state[17]; Amo =  state[18]; Amu =  state[19];
+	Asa = ~state[20]; Ase =  state[21]; Asi =  state[22]; Aso =  state[23]; Asu =  state[24];
 
-		/* Iota step (see [Keccak Reference, Section 2.3.5]) */
-		ctx->hash[0] ^= pzcrypto_hash_sha3_K[i];
+	for (i = 0; i < 24; i += 2) {
+		P_SHA3_ROUND (A, E, pzcrypto_hash_sha3_K[i]);
+		P_SHA3_ROUND (E, A, pzcrypto_hash_sha3_K[i + 1]);
 	}
+
+	state[0]  =  Aba; state[1]  = ~Abe; state[2]  = ~Abi; state[3]  =  Abo; state[4]  =  Abu;
+	state[5]  =  Aga; state[6]  =  Age; state[7]  =  Agi; state[8]  = ~Ago; state[9]  =  Agu;
+	state[10] =  Aka; state[11] =  Ake; state[12] = ~Aki; state[13] =  Ako; state[14] =  Aku;
+	state[15] =  Ama; state[16] =  Ame; state[17] = ~Ami; state[18] =  Amo; state[19] =  Amu;
+	state[20] = ~Asa; state[21] =  Ase; state[22] =  Asi; state[23] =  Aso; state[24] =  Asu;
 }
 
+/* The block is absorbed right from the input, no copy or byte swapping is
+ * needed */
 static void
 pzcrypto_hash_sha3_process (PHashSHA3		*ctx,
-			     const puint64	*data)
+			     const puchar	*data)
 {
 	puint i;
 	puint qwords = ctx->block_size / 8;
 
 	for (i = 0; i < qwords; ++i)
-		ctx->hash[i] ^= data[i];
+		ctx->hash[i] ^= pzcrypto_hash_sha3_read64 (data + i * 8);
 
 	/* Make the Keccak permutation */
-	pzcrypto_hash_sha3_keccak_permutate (ctx);
+	pzcrypto_hash_sha3_keccak_permutate (ctx->hash);
 }
 
-static PHashSHA3 *
-pzcrypto_hash_sha3_new_internal (puint bits)
+static void
+pzcrypto_hash_sha3_init_internal (PHashSHA3	*ctx,
+				  puint		bits)
 {
-	PHashSHA3 *ret;
-
-	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PHashSHA3))) == NULL))
-		return NULL;
-
-	ret->block_size = (1600 - bits * 2) / 8;
+	ctx->block_size = (1600 - bits * 2) / 8;
 
-	return ret;
+	zcrypto_hash_sha3_reset (ctx);
 }
 
 void
@@ -213,28 +221,28 @@ zcrypto_hash_sha3_reset (PHashSHA3 *ctx)
 	ctx->len = 0;
 }
 
-PHashSHA3 *
-zcrypto_hash_sha3_224_new (void)
+void
+zcrypto_hash_sha3_224_init (PHashSHA3 *ctx)
 {
-	return pzcrypto_hash_sha3_new_internal (224);
+	pzcrypto_hash_sha3_init_internal (ctx, 224);
 }
 
-PHashSHA3 *
-zcrypto_hash_sha3_256_new (void)
+void
+zcrypto_hash_sha3_256_init (PHashSHA3 *ctx)
 {
-	return pzcrypto_hash_sha3_new_internal (256);
+	pzcrypto_hash_sha3_init_internal (ctx, 256);
 }
 
-PHashSHA3 *
-zcrypto_hash_sha3_384_new (void)
+void
+zcrypto_hash_sha3_384_init (PHashSHA3 *ctx)
 {
-	return pzcrypto_hash_sha3_new_internal (384);
+	pzcrypto_hash_sha3_init_internal (ctx, 384);
 }
 
-PHashSHA3 *
-zcrypto_hash_sha3_512_new (void)
+void
+zcrypto_hash_sha3_512_init (PHashSHA3 *ctx)
 {
-	return pzcrypto_hash_sha3_new_internal (512);
+	pzcrypto_hash_sha3_init_internal (ctx, 512);
 }
 
 void
@@ -250,8 +258,7 @@ zcrypto_hash_sha3_update (PHashSHA3	*ctx,
 
 	if (left && (puint64) len >= to_fill) {
 		memcpy (ctx->buf.buf + left, data, to_fill);
-		pzcrypto_hash_sha3_swazbytes (ctx->buf.buf_w, ctx->block_size >> 3);
-		pzcrypto_hash_sha3_process (ctx, ctx->buf.buf_w);
+		pzcrypto_hash_sha3_process (ctx, ctx->buf.buf);
 
 		data += to_fill;
 		len -= to_fill;
@@ -259,9 +266,7 @@ zcrypto_hash_sha3_update (PHashSHA3	*ctx,
 	}
 
 	while (len >= ctx->block_size) {
-		memcpy (ctx->buf.buf, data, ctx->block_size);
-		pzcrypto_hash_sha3_swazbytes (ctx->buf.buf_w, ctx->block_size >> 3);
-		pzcrypto_hash_sha3_process (ctx, ctx->buf.buf_w);
+		pzcrypto_hash_sha3_process (ctx, data);
 
 		data += ctx->block_size;
 		len -= ctx->block_size;
@@ -278,8 +283,7 @@ zcrypto_hash_sha3_finish (PHashSHA3 *ctx)
 	ctx->buf.buf[ctx->len]            |= 0x06;
 	ctx->buf.buf[ctx->block_size - 1] |= 0x80;
 
-	pzcrypto_hash_sha3_swazbytes (ctx->buf.buf_w, ctx->block_size >> 3);
-	pzcrypto_hash_sha3_process (ctx, ctx->buf.buf_w);
+	pzcrypto_hash_sha3_process (ctx, ctx->buf.buf);
 
 	pzcrypto_hash_sha3_swazbytes (ctx->hash, (100 - (ctx->block_size >> 2)) >> 3);
 }
@@ -289,9 +293,3 @@ zcrypto_hash_sha3_digest (PHashSHA3 *ctx)
 {
 	return (const puchar *) ctx->hash;
 }
-
-void
-zcrypto_hash_sha3_free (PHashSHA3 *ctx)
-{
-	zfree (ctx);
-}
@@ -25,123 +25,211 @@
 
 #include "pmem.h"
 #include "pcryptohash.h"
+#include "pencoding.h"
+#include "pcryptohash-blake3.h"
 #include "pcryptohash-gost3411.h"
 #include "pcryptohash-md5.h"
 #include "pcryptohash-sha1.h"
 #include "pcryptohash-sha2-256.h"
 #include "pcryptohash-sha2-512.h"
 #include "pcryptohash-sha3.h"
+#include "pcryptohash-many-private.h"
+#include "pcryptohash-private.h"
 
 #include <string.h>
 
 #define P_HASH_FUNCS(ctx, type) \
-	ctx->create = (void * (*) (void)) zcrypto_hash_##type##_new;				\
 	ctx->update = (void (*) (void *, const puchar *, psize)) zcrypto_hash_##type##_update;	\
 	ctx->finish = (void (*) (void *)) zcrypto_hash_##type##_finish;			\
 	ctx->digest = (const puchar * (*) (void *)) zcrypto_hash_##type##_digest;		\
 	ctx->reset = (void (*) (void *)) zcrypto_hash_##type##_reset;				\
-	ctx->free = (void (*) (void *)) zcrypto_hash_##type##_free;
+	zcrypto_hash_##type##_init (ctx->context);
+
+/* The algorithm context follows the #PCryptoHash header in the same memory
+ * block, so a context needs a single allocation or none at all */
+#define P_CRYPTO_HASH_CONTEXT_OFFSET	((sizeof (PCryptoHash) + 7) & ~((psize) 7))
 
 struct PCryptoHash_ {
 	PCryptoHashType	type;
 	ppointer	context;
 	puint		hash_len;
 	pboolean	closed;
-	ppointer	(*create)	(void);
+	pboolean	is_static;
 	void		(*update)	(void *hash, const puchar *data, psize len);
 	void		(*finish)	(void *hash);
 	const puchar *	(*digest)	(void *hash);
 	void		(*reset)	(void *hash);
-	void		(*free)		(void *hash);
 };
 
-static pchar pzcrypto_hash_hex_str[]= "0123456789abcdef";
-
-static void
-pzcrypto_hash_digest_to_hex (const puchar *digest, puint len, pchar *out);
-
-static void
-pzcrypto_hash_digest_to_hex (const puchar *digest, puint len, pchar *out)
+typedef union PCryptoHashContext_ {
+	PHashMD5	md5;
+	PHashSHA1	sha1;
+	PHashSHA2_256	sha2_256;
+	PHashSHA2_512	sha2_512;
+	PHashSHA3	sha3;
+	PHashGOST3411	gost3411;
+	PHashBLAKE3	blake3;
+} PCryptoHashContext;
+
+/* Fails to compile if any context doesn't fit into #PCryptoHashStorage */
+typedef pchar pzcrypto_hash_storage_check[(P_CRYPTO_HASH_CONTEXT_OFFSET +
+					   sizeof (PCryptoHashContext) <= sizeof (PCryptoHashStorage)) ? 1 : -1];
+
+static psize pzcrypto_hash_context_size (PCryptoHashType type);
+static void pzcrypto_hash_setup (PCryptoHash *hash, PCryptoHashType type, pboolean is_static);
+
+static psize
+pzcrypto_hash_context_size (PCryptoHashType type)
 {
-	puint i;
-
-	for (i = 0; i < len; ++i) {
-		*(out + (i << 1)    ) = pzcrypto_hash_hex_str[(digest[i] >> 4) & 0x0F];
-		*(out + (i << 1) + 1) = pzcrypto_hash_hex_str[(digest[i]     ) & 0x0F];
+	switch (type) {
+	case P_CRYPTO_HASH_TYPE_MD5:
+		return sizeof (PHashMD5);
+	case P_CRYPTO_HASH_TYPE_SHA1:
+		return sizeof (PHashSHA1);
+	case P_CRYPTO_HASH_TYPE_SHA2_224:
+	case P_CRYPTO_HASH_TYPE_SHA2_256:
+		return sizeof (PHashSHA2_256);
+	case P_CRYPTO_HASH_TYPE_SHA2_384:
+	case P_CRYPTO_HASH_TYPE_SHA2_512:
+		return sizeof (PHashSHA2_512);
+	case P_CRYPTO_HASH_TYPE_SHA3_224:
+	case P_CRYPTO_HASH_TYPE_SHA3_256:
+	case P_CRYPTO_HASH_TYPE_SHA3_384:
+	case P_CRYPTO_HASH_TYPE_SHA3_512:
+		return sizeof (PHashSHA3);
+	case P_CRYPTO_HASH_TYPE_GOST:
+		return sizeof (PHashGOST3411);
+	case P_CRYPTO_HASH_TYPE_BLAKE3:
+		return sizeof (PHashBLAKE3);
 	}
+
+	return sizeof (PCryptoHashContext);
 }
 
-P_LIB_API PCryptoHash *
-zcrypto_hash_new (PCryptoHashType type)
+static void
+pzcrypto_hash_setup (PCryptoHash	*hash,
+		     PCryptoHashType	type,
+		     pboolean		is_static)
 {
-	PCryptoHash *ret;
-
-	if (P_UNLIKELY (!(type >= P_CRYPTO_HASH_TYPE_MD5 && type <= P_CRYPTO_HASH_TYPE_GOST)))
-		return NULL;
-
-	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PCryptoHash))) == NULL)) {
-		P_ERROR ("PCryptoHash::zcrypto_hash_new: failed to allocate memory");
-		return NULL;
-	}
+	hash->context = (puchar *) hash + P_CRYPTO_HASH_CONTEXT_OFFSET;
 
 	switch (type) {
 	case P_CRYPTO_HASH_TYPE_MD5:
-		P_HASH_FUNCS (ret, md5);
-		ret->hash_len = 16;
+		P_HASH_FUNCS (hash, md5);
+		hash->hash_len = 16;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA1:
-		P_HASH_FUNCS (ret, sha1);
-		ret->hash_len = 20;
+		P_HASH_FUNCS (hash, sha1);
+		hash->hash_len = 20;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA2_224:
-		P_HASH_FUNCS (ret, sha2_224);
-		ret->hash_len = 28;
+		P_HASH_FUNCS (hash, sha2_224);
+		hash->hash_len = 28;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA2_256:
-		P_HASH_FUNCS (ret, sha2_256);
-		ret->hash_len = 32;
+		P_HASH_FUNCS (hash, sha2_256);
+		hash->hash_len = 32;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA2_384:
-		P_HASH_FUNCS (ret, sha2_384);
-		ret->hash_len = 48;
+		P_HASH_FUNCS (hash, sha2_384);
+		hash->hash_len = 48;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA2_512:
-		P_HASH_FUNCS (ret, sha2_512);
-		ret->hash_len = 64;
+		P_HASH_FUNCS (hash, sha2_512);
+		hash->hash_len = 64;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA3_224:
-		P_HASH_FUNCS (ret, sha3_224);
-		ret->hash_len = 28;
+		P_HASH_FUNCS (hash, sha3_224);
+		hash->hash_len = 28;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA3_256:
-		P_HASH_FUNCS (ret, sha3_256);
-		ret->hash_len = 32;
+		P_HASH_FUNCS (hash, sha3_256);
+		hash->hash_len = 32;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA3_384:
-		P_HASH_FUNCS (ret, sha3_384);
-		ret->hash_len = 48;
+		P_HASH_FUNCS (hash, sha3_384);
+		hash->hash_len = 48;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA3_512:
-		P_HASH_FUNCS (ret, sha3_512);
-		ret->hash_len = 64;
+		P_HASH_FUNCS (hash, sha3_512);
+		hash->hash_len = 64;
 		break;
 	case P_CRYPTO_HASH_TYPE_GOST:
-		P_HASH_FUNCS (ret, gost3411);
-		ret->hash_len = 32;
+		P_HASH_FUNCS (hash, gost3411);
+		hash->hash_len = 32;
+		break;
+	case P_CRYPTO_HASH_TYPE_BLAKE3:
+		P_HASH_FUNCS (hash, blake3);
+		hash->hash_len = 32;
 		break;
 	}
 
-	ret->type   = type;
-	ret->closed = FALSE;
+	hash->type      = type;
+	hash->closed    = FALSE;
+	hash->is_static = is_static;
+}
 
-	if (P_UNLIKELY ((ret->context = ret->create ()) == NULL)) {
-		zfree (ret);
+P_LIB_API PCryptoHash *
+zcrypto_hash_new (PCryptoHashType type)
+{
+	PCryptoHash *ret;
+
+	if (P_UNLIKELY (!(type >= P_CRYPTO_HASH_TYPE_MD5 && type <= P_CRYPTO_HASH_TYPE_BLAKE3)))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (P_CRYPTO_HASH_CONTEXT_OFFSET + pzcrypto_hash_context_size (type))) == NULL)) {
+		P_ERROR ("PCryptoHash::zcrypto_hash_new: failed to allocate memory");
 		return NULL;
 	}
 
+	pzcrypto_hash_setup (ret, type, FALSE);
+
+	return ret;
+}
+
+P_LIB_API PCryptoHash *
+zcrypto_hash_init (PCryptoHashStorage	*storage,
+		   PCryptoHashType	type)
+{
+	PCryptoHash *ret;
+
+	if (P_UNLIKELY (storage == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (!(type >= P_CRYPTO_HASH_TYPE_MD5 && type <= P_CRYPTO_HASH_TYPE_BLAKE3)))
+		return NULL;
+
+	ret = (PCryptoHash *) storage;
+
+	pzcrypto_hash_setup (ret, type, TRUE);
+
 	return ret;
 }
 
+P_LIB_API pboolean
+zcrypto_hash_compute (PCryptoHashType	type,
+		      const puchar	*data,
+		      psize		len,
+		      puchar		*digest)
+{
+	PCryptoHashStorage	storage;
+	PCryptoHash		*hash;
+	psize			digest_len;
+
+	if (P_UNLIKELY ((data == NULL && len > 0) || digest == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((hash = zcrypto_hash_init (&storage, type)) == NULL))
+		return FALSE;
+
+	zcrypto_hash_update (hash, data, len);
+
+	digest_len = hash->hash_len;
+	zcrypto_hash_get_digest (hash, digest, &digest_len);
+
+	return digest_len == hash->hash_len;
+}
+
 P_LIB_API void
 zcrypto_hash_update (PCryptoHash *hash, const puchar *data, psize len)
 {
@@ -167,26 +255,46 @@ zcrypto_hash_reset (PCryptoHash *hash)
 P_LIB_API pchar *
 zcrypto_hash_get_string (PCryptoHash *hash)
 {
-	pchar		*ret;
-	const puchar	*digest;
+	pchar *ret;
 
 	if (P_UNLIKELY (hash == NULL))
 		return NULL;
 
+	if (P_UNLIKELY ((ret = zmalloc0 (hash->hash_len * 2 + 1)) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (zcrypto_hash_get_hex (hash, ret, hash->hash_len * 2 + 1) == 0)) {
+		zfree (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API psize
+zcrypto_hash_get_hex (PCryptoHash	*hash,
+		      pchar		*buf,
+		      psize		size)
+{
+	const puchar *digest;
+
+	if (P_UNLIKELY (buf == NULL || size == 0))
+		return 0;
+
+	buf[0] = '\0';
+
+	if (P_UNLIKELY (hash == NULL || size < hash->hash_len * 2 + 1))
+		return 0;
+
 	if (!hash->closed) {
 		hash->finish (hash->context);
 		hash->closed = TRUE;
 	}
 
 	if (P_UNLIKELY ((digest = hash->digest (hash->context)) == NULL))
-		return NULL;
-
-	if (P_UNLIKELY ((ret = zmalloc0 (hash->hash_len * 2 + 1)) == NULL))
-		return NULL;
-
-	pzcrypto_hash_digest_to_hex (digest, hash->hash_len, ret);
+		return 0;
 
-	return ret;
+	return zencoding_hex_encode (digest, hash->hash_len, buf, size);
 }
 
 P_LIB_API void
@@ -245,6 +353,128 @@ zcrypto_hash_free (PCryptoHash *hash)
 	if (P_UNLIKELY (hash == NULL))
 		return;
 
-	hash->free (hash->context);
-	zfree (hash);
+	if (hash->is_static == FALSE)
+		zfree (hash);
+}
+
+P_LIB_API pboolean
+zcrypto_hash_set_threads (PCryptoHash	*hash,
+			  puint		threads)
+{
+	if (P_UNLIKELY (hash == NULL))
+		return FALSE;
+
+	if (hash->type != P_CRYPTO_HASH_TYPE_BLAKE3)
+		return FALSE;
+
+	zcrypto_hash_blake3_set_threads ((PHashBLAKE3 *) hash->context, threads);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+zcrypto_hash_many (PCryptoHashType		type,
+		   const puchar * const		*inputs,
+		   const psize			*lengths,
+		   puchar * const		*digests,
+		   psize			count)
+{
+	PCryptoHashStorage	storage;
+	PCryptoHash		*hash;
+	psize			digest_len;
+	psize			i;
+
+	if (P_UNLIKELY (!(type >= P_CRYPTO_HASH_TYPE_MD5 && type <= P_CRYPTO_HASH_TYPE_BLAKE3)))
+		return FALSE;
+
+	if (count == 0)
+		return TRUE;
+
+	if (P_UNLIKELY (inputs == NULL || lengths == NULL || digests == NULL))
+		return FALSE;
+
+	for (i = 0; i < count; ++i) {
+		if (P_UNLIKELY ((inputs[i] == NULL && lengths[i] > 0) || digests[i] == NULL))
+			return FALSE;
+	}
+
+	if (zcrypto_hash_many_simd (type, inputs, lengths, digests, count) == TRUE)
+		return TRUE;
+
+	/* A single context is reused for all the messages */
+	hash = zcrypto_hash_init (&storage, type);
+
+	for (i = 0; i < count; ++i) {
+		zcrypto_hash_update (hash, inputs[i], lengths[i]);
+
+		digest_len = hash->hash_len;
+		zcrypto_hash_get_digest (hash, digests[i], &digest_len);
+		zcrypto_hash_reset (hash);
+	}
+
+	return TRUE;
+}
+
+psize
+zcrypto_hash_get_block_size (PCryptoHashType type)
+{
+	switch (type) {
+	case P_CRYPTO_HASH_TYPE_MD5:
+	case P_CRYPTO_HASH_TYPE_SHA1:
+	case P_CRYPTO_HASH_TYPE_SHA2_224:
+	case P_CRYPTO_HASH_TYPE_SHA2_256:
+	case P_CRYPTO_HASH_TYPE_BLAKE3:
+		return 64;
+	case P_CRYPTO_HASH_TYPE_SHA2_384:
+	case P_CRYPTO_HASH_TYPE_SHA2_512:
+		return 128;
+	case P_CRYPTO_HASH_TYPE_SHA3_224:
+		return 144;
+	case P_CRYPTO_HASH_TYPE_SHA3_256:
+		return 136;
+	case P_CRYPTO_HASH_TYPE_SHA3_384:
+		return 104;
+	case P_CRYPTO_HASH_TYPE_SHA3_512:
+		return 72;
+	case P_CRYPTO_HASH_TYPE_GOST:
+		return 32;
+	}
+
+	return 0;
+}
+
+psize
+zcrypto_hash_get_memory_size (PCryptoHashType type)
+{
+	if (P_UNLIKELY (!(type >= P_CRYPTO_HASH_TYPE_MD5 && type <= P_CRYPTO_HASH_TYPE_BLAKE3)))
+		return 0;
+
+	return (P_CRYPTO_HASH_CONTEXT_OFFSET + pzcrypto_hash_context_size (type) + 7) & ~((psize) 7);
+}
+
+PCryptoHash *
+zcrypto_hash_init_at (ppointer		mem,
+		      PCryptoHashType	type)
+{
+	PCryptoHash *ret;
+
+	if (P_UNLIKELY (mem == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (!(type >= P_CRYPTO_HASH_TYPE_MD5 && type <= P_CRYPTO_HASH_TYPE_BLAKE3)))
+		return NULL;
+
+	ret = (PCryptoHash *) mem;
+
+	pzcrypto_hash_setup (ret, type, TRUE);
+
+	return ret;
+}
+
+void
+zcrypto_hash_copy_state (PCryptoHash		*dst,
+			 const PCryptoHash	*src)
+{
+	memcpy (dst->context, src->context, pzcrypto_hash_context_size (src->type));
+	dst->closed = src->closed;
 }
@@ -0,0 +1,386 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pcryptohmac.h"
+#include "pcryptohash-private.h"
+
+#include <string.h>
+
+#define P_CRYPTO_HMAC_MAX_BLOCK		144
+#define P_CRYPTO_HMAC_IPAD		0x36
+#define P_CRYPTO_HMAC_OPAD		0x5C
+
+/* The inner and outer contexts hold the hash states right after the padded
+ * key blocks and are never finished, the working context is restored from
+ * the inner one for every message */
+struct PCryptoHmac_ {
+	PCryptoHashType	type;
+	psize		hash_len;
+	psize		ctx_size;
+	PCryptoHash	*inner;
+	PCryptoHash	*outer;
+	PCryptoHash	*hash;
+	pboolean	closed;
+	puchar		digest[P_CRYPTO_HASH_MAX_LENGTH];
+};
+
+/* Memory for the three contexts of a #PCryptoHmac kept on the stack */
+typedef struct PCryptoHmacStorage_ {
+	PCryptoHashStorage	ctx[3];
+} PCryptoHmacStorage;
+
+#define P_CRYPTO_HMAC_OFFSET	((sizeof (PCryptoHmac) + 7) & ~((psize) 7))
+
+static void pzcrypto_hmac_wipe (ppointer mem, psize len);
+static void pzcrypto_hmac_setup (PCryptoHmac *hmac, puchar *mem, PCryptoHashType type,
+				 const puchar *key, psize key_len);
+static void pzcrypto_hmac_finish (const PCryptoHmac *hmac, PCryptoHash *hash, puchar *digest);
+static psize pzcrypto_hkdf_extract (PCryptoHashType type, const puchar *salt, psize salt_len,
+				    const puchar *ikm, psize ikm_len, puchar *prk);
+
+/* Clears the key material in a way the compiler can't drop as a dead store */
+static void
+pzcrypto_hmac_wipe (ppointer	mem,
+		    psize	len)
+{
+	volatile puchar *p = (volatile puchar *) mem;
+
+	while (len-- > 0)
+		*p++ = 0;
+}
+
+static void
+pzcrypto_hmac_setup (PCryptoHmac	*hmac,
+		     puchar		*mem,
+		     PCryptoHashType	type,
+		     const puchar	*key,
+		     psize		key_len)
+{
+	puchar	pad[P_CRYPTO_HMAC_MAX_BLOCK];
+	psize	block_size;
+	psize	i;
+
+	block_size = zcrypto_hash_get_block_size (type);
+
+	hmac->type     = type;
+	hmac->ctx_size = zcrypto_hash_get_memory_size (type);
+	hmac->inner    = zcrypto_hash_init_at (mem, type);
+	hmac->outer    = zcrypto_hash_init_at (mem + hmac->ctx_size, type);
+	hmac->hash     = zcrypto_hash_init_at (mem + hmac->ctx_size * 2, type);
+	hmac->hash_len = (psize) zcrypto_hash_get_length (hmac->inner);
+	hmac->closed   = FALSE;
+
+	memset (pad, 0, sizeof (pad));
+
+	if (key_len > block_size)
+		zcrypto_hash_compute (type, key, key_len, pad);
+	else if (key_len > 0)
+		memcpy (pad, key, key_len);
+
+	for (i = 0; i < block_size; ++i)
+		pad[i] ^= P_CRYPTO_HMAC_IPAD;
+
+	zcrypto_hash_update (hmac->inner, pad, block_size);
+
+	for (i = 0; i < block_size; ++i)
+		pad[i] ^= P_CRYPTO_HMAC_IPAD ^ P_CRYPTO_HMAC_OPAD;
+
+	zcrypto_hash_update (hmac->outer, pad, block_size);
+
+	pzcrypto_hmac_wipe (pad, sizeof (pad));
+
+	zcrypto_hash_copy_state (hmac->hash, hmac->inner);
+}
+
+/* Finishes the inner hash accumulated in the context and runs the outer one
+ * in the same context */
+static void
+pzcrypto_hmac_finish (const PCryptoHmac	*hmac,
+		      PCryptoHash		*hash,
+		      puchar			*digest)
+{
+	puchar	inner[P_CRYPTO_HASH_MAX_LENGTH];
+	psize	len;
+
+	len = sizeof (inner);
+	zcrypto_hash_get_digest (hash, inner, &len);
+
+	zcrypto_hash_copy_state (hash, hmac->outer);
+	zcrypto_hash_update (hash, inner, hmac->hash_len);
+
+	len = P_CRYPTO_HASH_MAX_LENGTH;
+	zcrypto_hash_get_digest (hash, digest, &len);
+}
+
+/* Returns the length of the pseudorandom key, 0 in case of error */
+static psize
+pzcrypto_hkdf_extract (PCryptoHashType	type,
+		       const puchar	*salt,
+		       psize		salt_len,
+		       const puchar	*ikm,
+		       psize		ikm_len,
+		       puchar		*prk)
+{
+	PCryptoHmacStorage	storage;
+	PCryptoHmac		hmac;
+
+	if (P_UNLIKELY ((ikm == NULL && ikm_len > 0) || prk == NULL))
+		return 0;
+
+	if (P_UNLIKELY (zcrypto_hash_get_memory_size (type) == 0))
+		return 0;
+
+	/* A missing salt is a string of zeros of the digest length, which is
+	 * never longer than the block size, so it gives the same padded key
+	 * block as an empty key */
+	if (salt == NULL)
+		salt_len = 0;
+
+	pzcrypto_hmac_setup (&hmac, (puchar *) &storage, type, salt, salt_len);
+
+	zcrypto_hash_update (hmac.hash, ikm, ikm_len);
+	pzcrypto_hmac_finish (&hmac, hmac.hash, prk);
+
+	pzcrypto_hmac_wipe (&storage, hmac.ctx_size * 3);
+
+	return hmac.hash_len;
+}
+
+P_LIB_API PCryptoHmac *
+zcrypto_hmac_new (PCryptoHashType	type,
+		  const puchar		*key,
+		  psize			key_len)
+{
+	PCryptoHmac	*ret;
+	psize		ctx_size;
+
+	if (P_UNLIKELY (key == NULL && key_len > 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ctx_size = zcrypto_hash_get_memory_size (type)) == 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (P_CRYPTO_HMAC_OFFSET + ctx_size * 3)) == NULL)) {
+		P_ERROR ("PCryptoHmac::zcrypto_hmac_new: failed to allocate memory");
+		return NULL;
+	}
+
+	pzcrypto_hmac_setup (ret, (puchar *) ret + P_CRYPTO_HMAC_OFFSET, type, key, key_len);
+
+	return ret;
+}
+
+P_LIB_API void
+zcrypto_hmac_update (PCryptoHmac	*hmac,
+		     const puchar	*data,
+		     psize		len)
+{
+	if (P_UNLIKELY (hmac == NULL || data == NULL || len == 0))
+		return;
+
+	if (P_UNLIKELY (hmac->closed))
+		return;
+
+	zcrypto_hash_update (hmac->hash, data, len);
+}
+
+P_LIB_API void
+zcrypto_hmac_reset (PCryptoHmac *hmac)
+{
+	if (P_UNLIKELY (hmac == NULL))
+		return;
+
+	zcrypto_hash_copy_state (hmac->hash, hmac->inner);
+	hmac->closed = FALSE;
+}
+
+P_LIB_API void
+zcrypto_hmac_get_digest (PCryptoHmac	*hmac,
+			 puchar		*buf,
+			 psize		*len)
+{
+	if (P_UNLIKELY (len == NULL))
+		return;
+
+	if (P_UNLIKELY (hmac == NULL || buf == NULL)) {
+		*len = 0;
+		return;
+	}
+
+	if (P_UNLIKELY (hmac->hash_len > *len)) {
+		*len = 0;
+		return;
+	}
+
+	if (!hmac->closed) {
+		pzcrypto_hmac_finish (hmac, hmac->hash, hmac->digest);
+		hmac->closed = TRUE;
+	}
+
+	memcpy (buf, hmac->digest, hmac->hash_len);
+	*len = hmac->hash_len;
+}
+
+P_LIB_API pssize
+zcrypto_hmac_get_length (const PCryptoHmac *hmac)
+{
+	if (P_UNLIKELY (hmac == NULL))
+		return 0;
+
+	return (pssize) hmac->hash_len;
+}
+
+P_LIB_API PCryptoHashType
+zcrypto_hmac_get_type (const PCryptoHmac *hmac)
+{
+	if (P_UNLIKELY (hmac == NULL))
+		return (PCryptoHashType) -1;
+
+	return hmac->type;
+}
+
+P_LIB_API pboolean
+zcrypto_hmac_compute (const PCryptoHmac	*hmac,
+		      const puchar		*data,
+		      psize			len,
+		      puchar			*digest)
+{
+	PCryptoHashStorage	storage;
+	PCryptoHash		*hash;
+
+	if (P_UNLIKELY (hmac == NULL || (data == NULL && len > 0) || digest == NULL))
+		return FALSE;
+
+	hash = zcrypto_hash_init_at (&storage, hmac->type);
+
+	zcrypto_hash_copy_state (hash, hmac->inner);
+	zcrypto_hash_update (hash, data, len);
+
+	pzcrypto_hmac_finish (hmac, hash, digest);
+
+	return TRUE;
+}
+
+P_LIB_API void
+zcrypto_hmac_free (PCryptoHmac *hmac)
+{
+	if (P_UNLIKELY (hmac == NULL))
+		return;
+
+	pzcrypto_hmac_wipe (hmac, P_CRYPTO_HMAC_OFFSET + hmac->ctx_size * 3);
+
+	zfree (hmac);
+}
+
+P_LIB_API pboolean
+zcrypto_hkdf_extract (PCryptoHashType	type,
+		      const puchar	*salt,
+		      psize		salt_len,
+		      const puchar	*ikm,
+		      psize		ikm_len,
+		      puchar		*prk)
+{
+	return pzcrypto_hkdf_extract (type, salt, salt_len, ikm, ikm_len, prk) > 0;
+}
+
+P_LIB_API pboolean
+zcrypto_hkdf_expand (PCryptoHashType	type,
+		     const puchar	*prk,
+		     psize		prk_len,
+		     const puchar	*info,
+		     psize		info_len,
+		     puchar		*okm,
+		     psize		okm_len)
+{
+	PCryptoHmacStorage	storage;
+	PCryptoHmac		hmac;
+	puchar			block[P_CRYPTO_HASH_MAX_LENGTH];
+	puchar			counter;
+	psize			block_len;
+	psize			pos;
+
+	if (P_UNLIKELY (prk == NULL || (info == NULL && info_len > 0) || (okm == NULL && okm_len > 0)))
+		return FALSE;
+
+	if (P_UNLIKELY (zcrypto_hash_get_memory_size (type) == 0))
+		return FALSE;
+
+	pzcrypto_hmac_setup (&hmac, (puchar *) &storage, type, prk, prk_len);
+
+	if (P_UNLIKELY (prk_len < hmac.hash_len || okm_len > hmac.hash_len * 255)) {
+		pzcrypto_hmac_wipe (&storage, hmac.ctx_size * 3);
+		return FALSE;
+	}
+
+	/* T(i) = HMAC (PRK, T(i - 1) | info | i), T(0) is empty */
+	block_len = 0;
+	counter   = 0;
+
+	for (pos = 0; pos < okm_len; pos += block_len) {
+		zcrypto_hash_copy_state (hmac.hash, hmac.inner);
+
+		zcrypto_hash_update (hmac.hash, block, block_len);
+		zcrypto_hash_update (hmac.hash, info, info_len);
+
+		++counter;
+		zcrypto_hash_update (hmac.hash, &counter, 1);
+
+		pzcrypto_hmac_finish (&hmac, hmac.hash, block);
+
+		block_len = hmac.hash_len;
+		memcpy (okm + pos, block, okm_len - pos < block_len ? okm_len - pos : block_len);
+	}
+
+	pzcrypto_hmac_wipe (block, sizeof (block));
+	pzcrypto_hmac_wipe (&storage, hmac.ctx_size * 3);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+zcrypto_hkdf (PCryptoHashType	type,
+	      const puchar	*salt,
+	      psize		salt_len,
+	      const puchar	*ikm,
+	      psize		ikm_len,
+	      const puchar	*info,
+	      psize		info_len,
+	      puchar		*okm,
+	      psize		okm_len)
+{
+	puchar		prk[P_CRYPTO_HASH_MAX_LENGTH];
+	psize		prk_len;
+	pboolean	ret;
+
+	if (P_UNLIKELY ((prk_len = pzcrypto_hkdf_extract (type, salt, salt_len, ikm, ikm_len, prk)) == 0))
+		return FALSE;
+
+	ret = zcrypto_hkdf_expand (type, prk, prk_len, info, info_len, okm, okm_len);
+
+	pzcrypto_hmac_wipe (prk, sizeof (prk));
+
+	return ret;
+}
@@ -0,0 +1,426 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pcuckoofilter.h"
+#include "pmem.h"
+#include "phashfunc-private.h"
+
+#include <string.h>
+
+#define P_CUCKOO_FILTER_MAGIC		0x464B4350
+#define P_CUCKOO_FILTER_VERSION		1
+#define P_CUCKOO_FILTER_HEADER_SIZE	64
+#define P_CUCKOO_FILTER_SLOTS		4
+#define P_CUCKOO_FILTER_BUCKET_SIZE	(P_CUCKOO_FILTER_SLOTS * sizeof (puint16))
+#define P_CUCKOO_FILTER_MAX_KICKS	500
+#define P_CUCKOO_FILTER_ALIGN		64
+
+/* Maximum load factor is 95%, expressed as a ratio */
+#define P_CUCKOO_FILTER_LOAD_NUM	95
+#define P_CUCKOO_FILTER_LOAD_DEN	100
+
+/* Image header, the buckets follow it */
+typedef struct PCuckooFilterHeader_ {
+	puint32		magic;
+	puint32		version;
+	puint64		nbuckets;
+	puint64		count;
+	puint64		victim_index;
+	puint32		victim_fp;
+	puint32		has_victim;
+	puchar		reserved[P_CUCKOO_FILTER_HEADER_SIZE - 40];
+} PCuckooFilterHeader;
+
+struct PCuckooFilter_ {
+	ppointer		mem;
+	PCuckooFilterHeader	*header;
+	puint16			*buckets;
+	puint64			nbuckets;
+	puint32			rand_state;
+};
+
+static void pzcuckoo_filter_locate (const PCuckooFilter *filter, pconstpointer data, psize len, puint16 *fp, puint64 *index);
+static puint64 pzcuckoo_filter_alt_index (const PCuckooFilter *filter, puint64 index, puint16 fp);
+static pboolean pzcuckoo_filter_bucket_contains (const PCuckooFilter *filter, puint64 index, puint16 fp);
+static pboolean pzcuckoo_filter_bucket_insert (PCuckooFilter *filter, puint64 index, puint16 fp);
+static pboolean pzcuckoo_filter_bucket_remove (PCuckooFilter *filter, puint64 index, puint16 fp);
+static pboolean pzcuckoo_filter_insert_fp (PCuckooFilter *filter, puint64 index, puint16 fp);
+
+static void
+pzcuckoo_filter_locate (const PCuckooFilter	*filter,
+			pconstpointer		data,
+			psize			len,
+			puint16			*fp,
+			puint64			*index)
+{
+	puint64 hash;
+
+	hash = zhash_func_bytes (data, len, 0);
+
+	/* Zero marks an empty slot */
+	*fp    = (puint16) (hash >> 48);
+	*fp    = *fp == 0 ? 1 : *fp;
+	*index = hash & (filter->nbuckets - 1);
+}
+
+static puint64
+pzcuckoo_filter_alt_index (const PCuckooFilter	*filter,
+			   puint64		index,
+			   puint16		fp)
+{
+	/* Partial-key cuckoo hashing: the alternate bucket is derived from the
+	 * current one and the fingerprint only, so it is an involution */
+	return (index ^ zhash_func_mix64 (fp)) & (filter->nbuckets - 1);
+}
+
+static pboolean
+pzcuckoo_filter_bucket_contains (const PCuckooFilter	*filter,
+				 puint64		index,
+				 puint16		fp)
+{
+	puint64 bucket;
+	puint64 diff;
+
+	/* Compare all the 4 slots at once: a zero 16-bit lane in the difference
+	 * means a match */
+	memcpy (&bucket, filter->buckets + index * P_CUCKOO_FILTER_SLOTS, sizeof (bucket));
+
+	diff = bucket ^ (fp * 0x0001000100010001ULL);
+
+	return ((diff - 0x0001000100010001ULL) & ~diff & 0x8000800080008000ULL) != 0;
+}
+
+static pboolean
+pzcuckoo_filter_bucket_insert (PCuckooFilter	*filter,
+			       puint64		index,
+			       puint16		fp)
+{
+	puint16	*bucket;
+	pint	i;
+
+	bucket = filter->buckets + index * P_CUCKOO_FILTER_SLOTS;
+
+	for (i = 0; i < P_CUCKOO_FILTER_SLOTS; ++i)
+		if (bucket[i] == 0) {
+			bucket[i] = fp;
+			return TRUE;
+		}
+
+	return FALSE;
+}
+
+static pboolean
+pzcuckoo_filter_bucket_remove (PCuckooFilter	*filter,
+			       puint64		index,
+			       puint16		fp)
+{
+	puint16	*bucket;
+	pint	i;
+
+	bucket = filter->buckets + index * P_CUCKOO_FILTER_SLOTS;
+
+	for (i = 0; i < P_CUCKOO_FILTER_SLOTS; ++i)
+		if (bucket[i] == fp) {
+			bucket[i] = 0;
+			return TRUE;
+		}
+
+	return FALSE;
+}
+
+static pboolean
+pzcuckoo_filter_insert_fp (PCuckooFilter	*filter,
+			   puint64		index,
+			   puint16		fp)
+{
+	puint16	*slot;
+	puint16	old_fp;
+	pint	kicks;
+
+	if (pzcuckoo_filter_bucket_insert (filter, index, fp))
+		return TRUE;
+
+	index = pzcuckoo_filter_alt_index (filter, index, fp);
+
+	if (pzcuckoo_filter_bucket_insert (filter, index, fp))
+		return TRUE;
+
+	for (kicks = 0; kicks < P_CUCKOO_FILTER_MAX_KICKS; ++kicks) {
+		/* Xorshift is good enough to choose a victim slot */
+		filter->rand_state ^= filter->rand_state << 13;
+		filter->rand_state ^= filter->rand_state >> 17;
+		filter->rand_state ^= filter->rand_state << 5;
+
+		slot   = filter->buckets + index * P_CUCKOO_FILTER_SLOTS +
+			 (filter->rand_state % P_CUCKOO_FILTER_SLOTS);
+		old_fp = *slot;
+		*slot  = fp;
+		fp     = old_fp;
+		index  = pzcuckoo_filter_alt_index (filter, index, fp);
+
+		if (pzcuckoo_filter_bucket_insert (filter, index, fp))
+			return TRUE;
+	}
+
+	/* Keep the last evicted fingerprint aside, the table is full now */
+	filter->header->victim_index = index;
+	filter->header->victim_fp    = fp;
+	filter->header->has_victim   = 1;
+
+	return TRUE;
+}
+
+P_LIB_API PCuckooFilter *
+zcuckoo_filter_new (psize capacity)
+{
+	PCuckooFilter	*ret;
+	puint64		nbuckets;
+	psize		image_size;
+
+	if (P_UNLIKELY (capacity == 0))
+		return NULL;
+
+	for (nbuckets = 2;
+	     nbuckets * P_CUCKOO_FILTER_SLOTS * P_CUCKOO_FILTER_LOAD_NUM / P_CUCKOO_FILTER_LOAD_DEN < capacity;
+	     nbuckets <<= 1) {
+		if (P_UNLIKELY (nbuckets > (P_MAXSIZE - P_CUCKOO_FILTER_HEADER_SIZE - P_CUCKOO_FILTER_ALIGN) /
+					   P_CUCKOO_FILTER_BUCKET_SIZE / 2))
+			return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PCuckooFilter))) == NULL)) {
+		P_ERROR ("PCuckooFilter::zcuckoo_filter_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	image_size = P_CUCKOO_FILTER_HEADER_SIZE + (psize) nbuckets * P_CUCKOO_FILTER_BUCKET_SIZE;
+
+	if (P_UNLIKELY ((ret->mem = zmalloc0 (image_size + P_CUCKOO_FILTER_ALIGN)) == NULL)) {
+		P_ERROR ("PCuckooFilter::zcuckoo_filter_new: failed(2) to allocate memory");
+		zfree (ret);
+		return NULL;
+	}
+
+	ret->header = (PCuckooFilterHeader *) (((puintptr) ret->mem + P_CUCKOO_FILTER_ALIGN - 1) &
+					       ~((puintptr) P_CUCKOO_FILTER_ALIGN - 1));
+	ret->buckets    = (puint16 *) ((puchar *) ret->header + P_CUCKOO_FILTER_HEADER_SIZE);
+	ret->nbuckets   = nbuckets;
+	ret->rand_state = 0x9E3779B9U;
+
+	ret->header->magic    = P_CUCKOO_FILTER_MAGIC;
+	ret->header->version  = P_CUCKOO_FILTER_VERSION;
+	ret->header->nbuckets = nbuckets;
+
+	return ret;
+}
+
+P_LIB_API PCuckooFilter *
+zcuckoo_filter_new_from_image (ppointer	image,
+			       psize	size)
+{
+	PCuckooFilter		*ret;
+	PCuckooFilterHeader	*header;
+
+	if (P_UNLIKELY (image == NULL || size < P_CUCKOO_FILTER_HEADER_SIZE))
+		return NULL;
+
+	if (P_UNLIKELY (((puintptr) image) % sizeof (puint64) != 0))
+		return NULL;
+
+	header = (PCuckooFilterHeader *) image;
+
+	if (P_UNLIKELY (header->magic != P_CUCKOO_FILTER_MAGIC ||
+			header->version != P_CUCKOO_FILTER_VERSION))
+		return NULL;
+
+	/* Number of buckets must be a power of two */
+	if (P_UNLIKELY (header->nbuckets < 2 || (header->nbuckets & (header->nbuckets - 1)) != 0 ||
+			header->nbuckets > (size - P_CUCKOO_FILTER_HEADER_SIZE) / P_CUCKOO_FILTER_BUCKET_SIZE))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PCuckooFilter))) == NULL)) {
+		P_ERROR ("PCuckooFilter::zcuckoo_filter_new_from_image: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->mem        = NULL;
+	ret->header     = header;
+	ret->buckets    = (puint16 *) ((puchar *) image + P_CUCKOO_FILTER_HEADER_SIZE);
+	ret->nbuckets   = header->nbuckets;
+	ret->rand_state = 0x9E3779B9U;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+zcuckoo_filter_insert (PCuckooFilter	*filter,
+		       pconstpointer	data,
+		       psize		len)
+{
+	puint64	index;
+	puint16	fp;
+
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	if (filter->header->has_victim)
+		return FALSE;
+
+	pzcuckoo_filter_locate (filter, data, len, &fp, &index);
+
+	if (P_UNLIKELY (pzcuckoo_filter_insert_fp (filter, index, fp) == FALSE))
+		return FALSE;
+
+	++filter->header->count;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+zcuckoo_filter_contains (const PCuckooFilter	*filter,
+			 pconstpointer		data,
+			 psize			len)
+{
+	const PCuckooFilterHeader	*header;
+	puint64				index, alt_index;
+	puint16				fp;
+
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	pzcuckoo_filter_locate (filter, data, len, &fp, &index);
+
+	alt_index = pzcuckoo_filter_alt_index (filter, index, fp);
+	header    = filter->header;
+
+	if (header->has_victim && header->victim_fp == fp &&
+	    (header->victim_index == index || header->victim_index == alt_index))
+		return TRUE;
+
+	return pzcuckoo_filter_bucket_contains (filter, index, fp) ||
+	       pzcuckoo_filter_bucket_contains (filter, alt_index, fp);
+}
+
+P_LIB_API pboolean
+zcuckoo_filter_remove (PCuckooFilter	*filter,
+		       pconstpointer	data,
+		       psize		len)
+{
+	PCuckooFilterHeader	*header;
+	puint64			index, alt_index;
+	puint16			fp;
+
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	pzcuckoo_filter_locate (filter, data, len, &fp, &index);
+
+	alt_index = pzcuckoo_filter_alt_index (filter, index, fp);
+	header    = filter->header;
+
+	if (pzcuckoo_filter_bucket_remove (filter, index, fp) ||
+	    pzcuckoo_filter_bucket_remove (filter, alt_index, fp)) {
+		--header->count;
+
+		/* There is a free slot now, try to put the victim back */
+		if (header->has_victim) {
+			header->has_victim = 0;
+			pzcuckoo_filter_insert_fp (filter, header->victim_index, (puint16) header->victim_fp);
+		}
+
+		return TRUE;
+	}
+
+	if (header->has_victim && header->victim_fp == fp &&
+	    (header->victim_index == index || header->victim_index == alt_index)) {
+		header->has_victim = 0;
+		--header->count;
+
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+P_LIB_API psize
+zcuckoo_filter_get_count (const PCuckooFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return 0;
+
+	return (psize) filter->header->count;
+}
+
+P_LIB_API void
+zcuckoo_filter_clear (PCuckooFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return;
+
+	memset (filter->buckets, 0, (psize) filter->nbuckets * P_CUCKOO_FILTER_BUCKET_SIZE);
+
+	filter->header->count      = 0;
+	filter->header->has_victim = 0;
+}
+
+P_LIB_API psize
+zcuckoo_filter_get_image_size (const PCuckooFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return 0;
+
+	return P_CUCKOO_FILTER_HEADER_SIZE + (psize) filter->nbuckets * P_CUCKOO_FILTER_BUCKET_SIZE;
+}
+
+P_LIB_API pboolean
+zcuckoo_filter_save_image (const PCuckooFilter	*filter,
+			   ppointer		buf,
+			   psize		size)
+{
+	psize image_size;
+
+	if (P_UNLIKELY (filter == NULL || buf == NULL))
+		return FALSE;
+
+	image_size = zcuckoo_filter_get_image_size (filter);
+
+	if (P_UNLIKELY (size < image_size || ((puintptr) buf) % sizeof (puint64) != 0))
+		return FALSE;
+
+	if (buf != (ppointer) filter->header)
+		memmove (buf, filter->header, image_size);
+
+	return TRUE;
+}
+
+P_LIB_API void
+zcuckoo_filter_free (PCuckooFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return;
+
+	zfree (filter->mem);
+	zfree (filter);
+}
@@ -0,0 +1,630 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pencoding.h"
+#include "pcpuinfo-private.h"
+
+#include <string.h>
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+#  include <immintrin.h>
+#endif
+
+#define P_ENCODING_INVALID	0xFF
+
+static const pchar pz_encoding_hex_digits[] = "0123456789abcdef";
+
+static const pchar pz_encoding_base64_alphabet[] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Both are filled on the first use, the race is harmless as all the threads
+ * write the same values */
+static puchar pz_encoding_hex_values[256];
+static puchar pz_encoding_base64_values[256];
+static pboolean pz_encoding_tables_ready = FALSE;
+
+static void pzencoding_init_tables (void);
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+static P_CPU_TARGET ("ssse3") psize pzencoding_hex_encode_ssse3 (const puchar *data, psize len, pchar *buf);
+static P_CPU_TARGET ("avx2") psize pzencoding_hex_encode_avx2 (const puchar *data, psize len, pchar *buf);
+static P_CPU_TARGET ("ssse3") pssize pzencoding_hex_decode_ssse3 (const pchar *str, psize len, puchar *buf);
+static P_CPU_TARGET ("avx2") pssize pzencoding_hex_decode_avx2 (const pchar *str, psize len, puchar *buf);
+static P_CPU_TARGET ("ssse3") psize pzencoding_base64_encode_ssse3 (const puchar *data, psize len, pchar *buf);
+static P_CPU_TARGET ("avx2") psize pzencoding_base64_encode_avx2 (const puchar *data, psize len, pchar *buf);
+static P_CPU_TARGET ("ssse3") pssize pzencoding_base64_decode_ssse3 (const pchar *str, psize len, puchar *buf);
+static P_CPU_TARGET ("avx2") pssize pzencoding_base64_decode_avx2 (const pchar *str, psize len, puchar *buf);
+#endif
+
+static void
+pzencoding_init_tables (void)
+{
+	pint i;
+
+	memset (pz_encoding_hex_values, P_ENCODING_INVALID, sizeof (pz_encoding_hex_values));
+	memset (pz_encoding_base64_values, P_ENCODING_INVALID, sizeof (pz_encoding_base64_values));
+
+	for (i = 0; i < 10; ++i)
+		pz_encoding_hex_values['0' + i] = (puchar) i;
+
+	for (i = 0; i < 6; ++i) {
+		pz_encoding_hex_values['a' + i] = (puchar) (10 + i);
+		pz_encoding_hex_values['A' + i] = (puchar) (10 + i);
+	}
+
+	for (i = 0; i < 64; ++i)
+		pz_encoding_base64_values[(puchar) pz_encoding_base64_alphabet[i]] = (puchar) i;
+
+	pz_encoding_tables_ready = TRUE;
+}
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+
+/* Splits every byte into two nibbles and looks them up in the digits table,
+ * returns the number of processed bytes */
+static P_CPU_TARGET ("ssse3") psize
+pzencoding_hex_encode_ssse3 (const puchar	*data,
+			     psize		len,
+			     pchar		*buf)
+{
+	__m128i	digits;
+	__m128i	mask;
+	__m128i	in, hi, lo;
+	psize	i;
+
+	digits = _mm_loadu_si128 ((const __m128i *) pz_encoding_hex_digits);
+	mask   = _mm_set1_epi8 (0x0F);
+
+	for (i = 0; i + 16 <= len; i += 16) {
+		in = _mm_loadu_si128 ((const __m128i *) (data + i));
+		hi = _mm_shuffle_epi8 (digits, _mm_and_si128 (_mm_srli_epi16 (in, 4), mask));
+		lo = _mm_shuffle_epi8 (digits, _mm_and_si128 (in, mask));
+
+		_mm_storeu_si128 ((__m128i *) (buf + 2 * i), _mm_unpacklo_epi8 (hi, lo));
+		_mm_storeu_si128 ((__m128i *) (buf + 2 * i + 16), _mm_unpackhi_epi8 (hi, lo));
+	}
+
+	return i;
+}
+
+static P_CPU_TARGET ("avx2") psize
+pzencoding_hex_encode_avx2 (const puchar	*data,
+			    psize		len,
+			    pchar		*buf)
+{
+	__m256i	digits;
+	__m256i	mask;
+	__m256i	in, hi, lo, first, second;
+	psize	i;
+
+	digits = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) pz_encoding_hex_digits));
+	mask   = _mm256_set1_epi8 (0x0F);
+
+	for (i = 0; i + 32 <= len; i += 32) {
+		in = _mm256_loadu_si256 ((const __m256i *) (data + i));
+		hi = _mm256_shuffle_epi8 (digits, _mm256_and_si256 (_mm256_srli_epi16 (in, 4), mask));
+		lo = _mm256_shuffle_epi8 (digits, _mm256_and_si256 (in, mask));
+
+		/* Unpacking works inside 128-bit lanes, restore the order */
+		first  = _mm256_unpacklo_epi8 (hi, lo);
+		second = _mm256_unpackhi_epi8 (hi, lo);
+
+		_mm256_storeu_si256 ((__m256i *) (buf + 2 * i), _mm256_permute2x128_si256 (first, second, 0x20));
+		_mm256_storeu_si256 ((__m256i *) (buf + 2 * i + 32), _mm256_permute2x128_si256 (first, second, 0x31));
+	}
+
+	return i;
+}
+
+/* Returns the number of processed characters, -1 for invalid input */
+static P_CPU_TARGET ("ssse3") pssize
+pzencoding_hex_decode_ssse3 (const pchar	*str,
+			     psize		len,
+			     puchar		*buf)
+{
+	__m128i	c_0, c_a, c_9, c_5, c_10, c_20, weights;
+	__m128i	in, dig, alpha, is_dig, is_alpha, val, pairs[2];
+	pint	k;
+	psize	i;
+
+	c_0     = _mm_set1_epi8 ('0');
+	c_a     = _mm_set1_epi8 ('a');
+	c_9     = _mm_set1_epi8 (9);
+	c_5     = _mm_set1_epi8 (5);
+	c_10    = _mm_set1_epi8 (10);
+	c_20    = _mm_set1_epi8 (0x20);
+	weights = _mm_set1_epi16 (0x0110);
+
+	for (i = 0; i + 32 <= len; i += 32) {
+		for (k = 0; k < 2; ++k) {
+			in    = _mm_loadu_si128 ((const __m128i *) (str + i + 16 * k));
+			dig   = _mm_sub_epi8 (in, c_0);
+			alpha = _mm_sub_epi8 (_mm_or_si128 (in, c_20), c_a);
+
+			/* Unsigned range checks: x <= max if min (x, max) == x */
+			is_dig   = _mm_cmpeq_epi8 (_mm_min_epu8 (dig, c_9), dig);
+			is_alpha = _mm_cmpeq_epi8 (_mm_min_epu8 (alpha, c_5), alpha);
+
+			if (_mm_movemask_epi8 (_mm_or_si128 (is_dig, is_alpha)) != 0xFFFF)
+				return -1;
+
+			val = _mm_or_si128 (_mm_and_si128 (is_dig, dig),
+					    _mm_andnot_si128 (is_dig, _mm_add_epi8 (alpha, c_10)));
+
+			/* High nibble * 16 + low nibble for every pair */
+			pairs[k] = _mm_maddubs_epi16 (val, weights);
+		}
+
+		_mm_storeu_si128 ((__m128i *) (buf + i / 2), _mm_packus_epi16 (pairs[0], pairs[1]));
+	}
+
+	return (pssize) i;
+}
+
+static P_CPU_TARGET ("avx2") pssize
+pzencoding_hex_decode_avx2 (const pchar	*str,
+			    psize	len,
+			    puchar	*buf)
+{
+	__m256i	c_0, c_a, c_9, c_5, c_10, c_20, weights;
+	__m256i	in, dig, alpha, is_dig, is_alpha, val, pairs[2];
+	pint	k;
+	psize	i;
+
+	c_0     = _mm256_set1_epi8 ('0');
+	c_a     = _mm256_set1_epi8 ('a');
+	c_9     = _mm256_set1_epi8 (9);
+	c_5     = _mm256_set1_epi8 (5);
+	c_10    = _mm256_set1_epi8 (10);
+	c_20    = _mm256_set1_epi8 (0x20);
+	weights = _mm256_set1_epi16 (0x0110);
+
+	for (i = 0; i + 64 <= len; i += 64) {
+		for (k = 0; k < 2; ++k) {
+			in    = _mm256_loadu_si256 ((const __m256i *) (str + i + 32 * k));
+			dig   = _mm256_sub_epi8 (in, c_0);
+			alpha = _mm256_sub_epi8 (_mm256_or_si256 (in, c_20), c_a);
+
+			is_dig   = _mm256_cmpeq_epi8 (_mm256_min_epu8 (dig, c_9), dig);
+			is_alpha = _mm256_cmpeq_epi8 (_mm256_min_epu8 (alpha, c_5), alpha);
+
+			if (_mm256_movemask_epi8 (_mm256_or_si256 (is_dig, is_alpha)) != -1)
+				return -1;
+
+			val = _mm256_blendv_epi8 (_mm256_add_epi8 (alpha, c_10), dig, is_dig);
+
+			pairs[k] = _mm256_maddubs_epi16 (val, weights);
+		}
+
+		/* Packing works inside 128-bit lanes, restore the order */
+		_mm256_storeu_si256 ((__m256i *) (buf + i / 2),
+				     _mm256_permute4x64_epi64 (_mm256_packus_epi16 (pairs[0], pairs[1]), 0xD8));
+	}
+
+	return (pssize) i;
+}
+
+/* Every 3 input bytes are spread into 4 bytes with 6 bits each, which are
+ * then mapped to the alphabet with a small shift table. Reads 16 bytes while
+ * consuming 12, returns the number of processed bytes. */
+static P_CPU_TARGET ("ssse3") psize
+pzencoding_base64_encode_ssse3 (const puchar	*data,
+				psize		len,
+				pchar		*buf)
+{
+	__m128i	shuf, mask_hi, mul_hi, mask_lo, mul_lo, c_51, c_26, c_13, shift_lut;
+	__m128i	in, idx, res;
+	psize	i, o;
+
+	shuf      = _mm_set_epi8 (10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	mask_hi   = _mm_set1_epi32 (0x0FC0FC00);
+	mul_hi    = _mm_set1_epi32 (0x04000040);
+	mask_lo   = _mm_set1_epi32 (0x003F03F0);
+	mul_lo    = _mm_set1_epi32 (0x01000010);
+	c_51      = _mm_set1_epi8 (51);
+	c_26      = _mm_set1_epi8 (26);
+	c_13      = _mm_set1_epi8 (13);
+	shift_lut = _mm_setr_epi8 ('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+				   '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				   '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+				   '/' - 63, 'A', 0, 0);
+
+	for (i = 0, o = 0; i + 16 <= len; i += 12, o += 16) {
+		in  = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + i)), shuf);
+		idx = _mm_or_si128 (_mm_mulhi_epu16 (_mm_and_si128 (in, mask_hi), mul_hi),
+				    _mm_mullo_epi16 (_mm_and_si128 (in, mask_lo), mul_lo));
+
+		/* 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12 */
+		res = _mm_subs_epu8 (idx, c_51);
+		res = _mm_or_si128 (res, _mm_and_si128 (_mm_cmpgt_epi8 (c_26, idx), c_13));
+		res = _mm_add_epi8 (_mm_shuffle_epi8 (shift_lut, res), idx);
+
+		_mm_storeu_si128 ((__m128i *) (buf + o), res);
+	}
+
+	return i;
+}
+
+/* Reads 28 bytes while consuming 24 */
+static P_CPU_TARGET ("avx2") psize
+pzencoding_base64_encode_avx2 (const puchar	*data,
+			       psize		len,
+			       pchar		*buf)
+{
+	__m256i	shuf, mask_hi, mul_hi, mask_lo, mul_lo, c_51, c_26, c_13, shift_lut;
+	__m256i	in, idx, res;
+	psize	i, o;
+
+	shuf      = _mm256_set_epi8 (10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+				     10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	mask_hi   = _mm256_set1_epi32 (0x0FC0FC00);
+	mul_hi    = _mm256_set1_epi32 (0x04000040);
+	mask_lo   = _mm256_set1_epi32 (0x003F03F0);
+	mul_lo    = _mm256_set1_epi32 (0x01000010);
+	c_51      = _mm256_set1_epi8 (51);
+	c_26      = _mm256_set1_epi8 (26);
+	c_13      = _mm256_set1_epi8 (13);
+	shift_lut = _mm256_setr_epi8 ('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+				      '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				      '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+				      '/' - 63, 'A', 0, 0,
+				      'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+				      '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				      '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+				      '/' - 63, 'A', 0, 0);
+
+	for (i = 0, o = 0; i + 28 <= len; i += 24, o += 32) {
+		/* Every 128-bit lane gets its own 12 input bytes */
+		in = _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_loadu_si128 ((const __m128i *) (data + i))),
+					      _mm_loadu_si128 ((const __m128i *) (data + i + 12)),
+					      1);
+		in  = _mm256_shuffle_epi8 (in, shuf);
+		idx = _mm256_or_si256 (_mm256_mulhi_epu16 (_mm256_and_si256 (in, mask_hi), mul_hi),
+				       _mm256_mullo_epi16 (_mm256_and_si256 (in, mask_lo), mul_lo));
+
+		res = _mm256_subs_epu8 (idx, c_51);
+		res = _mm256_or_si256 (res, _mm256_and_si256 (_mm256_cmpgt_epi8 (c_26, idx), c_13));
+		res = _mm256_add_epi8 (_mm256_shuffle_epi8 (shift_lut, res), idx);
+
+		_mm256_storeu_si256 ((__m256i *) (buf + o), res);
+	}
+
+	return i;
+}
+
+/* Characters are validated and translated using lookups by their nibbles,
+ * then every 4 values of 6 bits are merged into 3 bytes. Writes 16 bytes while
+ * producing 12, returns the number of processed characters or -1 for invalid
+ * input. */
+static P_CPU_TARGET ("ssse3") pssize
+pzencoding_base64_decode_ssse3 (const pchar	*str,
+				psize		len,
+				puchar		*buf)
+{
+	__m128i	lut_lo, lut_hi, lut_roll, mask, c_2f, merge_ab, merge_abc, shuf;
+	__m128i	in, hi_nibbles, lo, hi, roll, val;
+	psize	i, o;
+
+	lut_lo    = _mm_setr_epi8 (0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+				   0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	lut_hi    = _mm_setr_epi8 (0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+				   0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	lut_roll  = _mm_setr_epi8 (0, 16, 19, 4, -65, -65, -71, -71,
+				   0, 0, 0, 0, 0, 0, 0, 0);
+	mask      = _mm_set1_epi8 (0x0F);
+	c_2f      = _mm_set1_epi8 ('/');
+	merge_ab  = _mm_set1_epi32 (0x01400140);
+	merge_abc = _mm_set1_epi32 (0x00011000);
+	shuf      = _mm_setr_epi8 (2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+	for (i = 0, o = 0; i + 16 <= len; i += 16, o += 12) {
+		in         = _mm_loadu_si128 ((const __m128i *) (str + i));
+		hi_nibbles = _mm_and_si128 (_mm_srli_epi32 (in, 4), mask);
+
+		lo = _mm_shuffle_epi8 (lut_lo, _mm_and_si128 (in, mask));
+		hi = _mm_shuffle_epi8 (lut_hi, hi_nibbles);
+
+		if (_mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_and_si128 (lo, hi), _mm_setzero_si128 ())) != 0xFFFF)
+			return -1;
+
+		roll = _mm_shuffle_epi8 (lut_roll, _mm_add_epi8 (_mm_cmpeq_epi8 (in, c_2f), hi_nibbles));
+		val  = _mm_add_epi8 (in, roll);
+
+		val = _mm_madd_epi16 (_mm_maddubs_epi16 (val, merge_ab), merge_abc);
+
+		_mm_storeu_si128 ((__m128i *) (buf + o), _mm_shuffle_epi8 (val, shuf));
+	}
+
+	return (pssize) i;
+}
+
+/* Writes 32 bytes while producing 24 */
+static P_CPU_TARGET ("avx2") pssize
+pzencoding_base64_decode_avx2 (const pchar	*str,
+			       psize		len,
+			       puchar		*buf)
+{
+	__m256i	lut_lo, lut_hi, lut_roll, mask, c_2f, merge_ab, merge_abc, shuf, perm;
+	__m256i	in, hi_nibbles, lo, hi, roll, val;
+	psize	i, o;
+
+	lut_lo    = _mm256_setr_epi8 (0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+				      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+				      0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+				      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	lut_hi    = _mm256_setr_epi8 (0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+				      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+				      0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+				      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	lut_roll  = _mm256_setr_epi8 (0, 16, 19, 4, -65, -65, -71, -71,
+				      0, 0, 0, 0, 0, 0, 0, 0,
+				      0, 16, 19, 4, -65, -65, -71, -71,
+				      0, 0, 0, 0, 0, 0, 0, 0);
+	mask      = _mm256_set1_epi8 (0x0F);
+	c_2f      = _mm256_set1_epi8 ('/');
+	merge_ab  = _mm256_set1_epi32 (0x01400140);
+	merge_abc = _mm256_set1_epi32 (0x00011000);
+	shuf      = _mm256_setr_epi8 (2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+				      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	perm      = _mm256_setr_epi32 (0, 1, 2, 4, 5, 6, 3, 7);
+
+	for (i = 0, o = 0; i + 32 <= len; i += 32, o += 24) {
+		in         = _mm256_loadu_si256 ((const __m256i *) (str + i));
+		hi_nibbles = _mm256_and_si256 (_mm256_srli_epi32 (in, 4), mask);
+
+		lo = _mm256_shuffle_epi8 (lut_lo, _mm256_and_si256 (in, mask));
+		hi = _mm256_shuffle_epi8 (lut_hi, hi_nibbles);
+
+		if (!_mm256_testz_si256 (lo, hi))
+			return -1;
+
+		roll = _mm256_shuffle_epi8 (lut_roll, _mm256_add_epi8 (_mm256_cmpeq_epi8 (in, c_2f), hi_nibbles));
+		val  = _mm256_add_epi8 (in, roll);
+
+		val = _mm256_madd_epi16 (_mm256_maddubs_epi16 (val, merge_ab), merge_abc);
+		val = _mm256_shuffle_epi8 (val, shuf);
+
+		/* 12 bytes in every lane, join them together */
+		_mm256_storeu_si256 ((__m256i *) (buf + o), _mm256_permutevar8x32_epi32 (val, perm));
+	}
+
+	return (pssize) i;
+}
+
+#endif /* PLIBSYS_HAS_X86_TARGET_ATTR */
+
+P_LIB_API psize
+zencoding_hex_encode (const puchar	*data,
+		      psize		len,
+		      pchar		*buf,
+		      psize		size)
+{
+	psize	i = 0;
+	puchar	ch;
+
+	if (P_UNLIKELY (buf == NULL || size == 0))
+		return 0;
+
+	if (P_UNLIKELY ((data == NULL && len > 0) || len > (P_MAXSIZE - 1) / 2 || size < len * 2 + 1)) {
+		buf[0] = '\0';
+		return 0;
+	}
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		i = pzencoding_hex_encode_avx2 (data, len, buf);
+	else if (zcpu_info_has_feature (P_CPU_FEATURE_SSSE3))
+		i = pzencoding_hex_encode_ssse3 (data, len, buf);
+#endif
+
+	for (; i < len; ++i) {
+		ch = data[i];
+
+		buf[2 * i]     = pz_encoding_hex_digits[ch >> 4];
+		buf[2 * i + 1] = pz_encoding_hex_digits[ch & 0x0F];
+	}
+
+	buf[len * 2] = '\0';
+
+	return len * 2;
+}
+
+P_LIB_API pssize
+zencoding_hex_decode (const pchar	*str,
+		      psize		len,
+		      puchar		*buf,
+		      psize		size)
+{
+	pssize	done = 0;
+	psize	i;
+	puchar	hi, lo;
+
+	if (P_UNLIKELY ((str == NULL && len > 0) || (buf == NULL && len > 0)))
+		return -1;
+
+	if (P_UNLIKELY (len % 2 != 0 || size < len / 2 || len / 2 > (psize) P_MAXSSIZE))
+		return -1;
+
+	if (P_UNLIKELY (pz_encoding_tables_ready == FALSE))
+		pzencoding_init_tables ();
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		done = pzencoding_hex_decode_avx2 (str, len, buf);
+	else if (zcpu_info_has_feature (P_CPU_FEATURE_SSSE3))
+		done = pzencoding_hex_decode_ssse3 (str, len, buf);
+#endif
+
+	if (P_UNLIKELY (done < 0))
+		return -1;
+
+	for (i = (psize) done; i < len; i += 2) {
+		hi = pz_encoding_hex_values[(puchar) str[i]];
+		lo = pz_encoding_hex_values[(puchar) str[i + 1]];
+
+		if (P_UNLIKELY (hi == P_ENCODING_INVALID || lo == P_ENCODING_INVALID))
+			return -1;
+
+		buf[i / 2] = (puchar) ((hi << 4) | lo);
+	}
+
+	return (pssize) (len / 2);
+}
+
+P_LIB_API psize
+zencoding_base64_encode (const puchar	*data,
+			 psize		len,
+			 pchar		*buf,
+			 psize		size)
+{
+	psize	i = 0;
+	psize	o;
+	puint32	val;
+
+	if (P_UNLIKELY (buf == NULL || size == 0))
+		return 0;
+
+	if (P_UNLIKELY ((data == NULL && len > 0) || len / 3 > (P_MAXSIZE - 5) / 4 ||
+			size < P_ENCODING_BASE64_ENCODED_LEN (len) + 1)) {
+		buf[0] = '\0';
+		return 0;
+	}
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		i = pzencoding_base64_encode_avx2 (data, len, buf);
+	else if (zcpu_info_has_feature (P_CPU_FEATURE_SSSE3))
+		i = pzencoding_base64_encode_ssse3 (data, len, buf);
+#endif
+
+	o = i / 3 * 4;
+
+	for (; i + 3 <= len; i += 3, o += 4) {
+		val = ((puint32) data[i] << 16) | ((puint32) data[i + 1] << 8) | data[i + 2];
+
+		buf[o]     = pz_encoding_base64_alphabet[(val >> 18) & 0x3F];
+		buf[o + 1] = pz_encoding_base64_alphabet[(val >> 12) & 0x3F];
+		buf[o + 2] = pz_encoding_base64_alphabet[(val >> 6) & 0x3F];
+		buf[o + 3] = pz_encoding_base64_alphabet[val & 0x3F];
+	}
+
+	if (i < len) {
+		val = (puint32) data[i] << 16;
+
+		if (i + 1 < len)
+			val |= (puint32) data[i + 1] << 8;
+
+		buf[o]     = pz_encoding_base64_alphabet[(val >> 18) & 0x3F];
+		buf[o + 1] = pz_encoding_base64_alphabet[(val >> 12) & 0x3F];
+		buf[o + 2] = i + 1 < len ? pz_encoding_base64_alphabet[(val >> 6) & 0x3F] : '=';
+		buf[o + 3] = '=';
+
+		o += 4;
+	}
+
+	buf[o] = '\0';
+
+	return o;
+}
+
+P_LIB_API pssize
+zencoding_base64_decode (const pchar	*str,
+			 psize		len,
+			 puchar		*buf,
+			 psize		size)
+{
+	pssize	done = 0;
+	psize	body_len;
+	psize	out_len;
+	psize	i, o;
+	puint32	val;
+	puchar	a, b, c, d;
+
+	if (P_UNLIKELY ((str == NULL && len > 0) || (buf == NULL && len > 0)))
+		return -1;
+
+	/* Strip correct padding only */
+	body_len = len;
+
+	if (len > 0 && len % 4 == 0 && str[len - 1] == '=')
+		body_len -= (str[len - 2] == '=') ? 2 : 1;
+
+	if (P_UNLIKELY (body_len % 4 == 1))
+		return -1;
+
+	out_len = body_len / 4 * 3 + (body_len % 4 == 0 ? 0 : body_len % 4 - 1);
+
+	if (P_UNLIKELY (size < out_len || out_len > (psize) P_MAXSSIZE))
+		return -1;
+
+	if (P_UNLIKELY (pz_encoding_tables_ready == FALSE))
+		pzencoding_init_tables ();
+
+	/* Keep the last quantum for the scalar code, vector code writes more
+	 * bytes than it produces */
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (body_len > 4 && out_len >= 32 && zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		done = pzencoding_base64_decode_avx2 (str, (out_len - 32) / 3 * 4 + 4, buf);
+	else if (body_len > 4 && out_len >= 16 && zcpu_info_has_feature (P_CPU_FEATURE_SSSE3))
+		done = pzencoding_base64_decode_ssse3 (str, (out_len - 16) / 3 * 4 + 4, buf);
+#endif
+
+	if (P_UNLIKELY (done < 0))
+		return -1;
+
+	for (i = (psize) done, o = (psize) done / 4 * 3; i + 4 <= body_len; i += 4, o += 3) {
+		a = pz_encoding_base64_values[(puchar) str[i]];
+		b = pz_encoding_base64_values[(puchar) str[i + 1]];
+		c = pz_encoding_base64_values[(puchar) str[i + 2]];
+		d = pz_encoding_base64_values[(puchar) str[i + 3]];
+
+		if (P_UNLIKELY (((a | b | c | d) & 0xC0) != 0))
+			return -1;
+
+		val = ((puint32) a << 18) | ((puint32) b << 12) | ((puint32) c << 6) | d;
+
+		buf[o]     = (puchar) (val >> 16);
+		buf[o + 1] = (puchar) (val >> 8);
+		buf[o + 2] = (puchar) val;
+	}
+
+	if (i < body_len) {
+		a = pz_encoding_base64_values[(puchar) str[i]];
+		b = pz_encoding_base64_values[(puchar) str[i + 1]];
+		c = i + 2 < body_len ? pz_encoding_base64_values[(puchar) str[i + 2]] : 0;
+
+		if (P_UNLIKELY (((a | b | c) & 0xC0) != 0))
+			return -1;
+
+		val = ((puint32) a << 18) | ((puint32) b << 12) | ((puint32) c << 6);
+
+		buf[o++] = (puchar) (val >> 16);
+
+		if (i + 2 < body_len)
+			buf[o++] = (puchar) (val >> 8);
+	}
+
+	return (pssize) out_len;
+}
@@ -0,0 +1,316 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Epoch-based reclamation.
+ *
+ * Every thread gets a record in the global registry on its first critical
+ * section and keeps it until it exits. Entering a critical section publishes
+ * the current global epoch in the record of the thread, so readers write
+ * only to their own record and never to a shared counter.
+ *
+ * A retired object is stamped with the global epoch and pushed into the limbo
+ * list of its data structure. The global epoch advances only when every thread
+ * inside a critical section has already observed it, so once it has advanced
+ * twice since the object was retired, no thread can hold a reference to the
+ * object anymore and it is freed.
+ *
+ * The limbo list is reclaimed as soon as it grows up to its threshold, so
+ * the amount of retired memory stays bounded unless some thread stays inside
+ * a critical section forever. A thread which can't get a record (out of
+ * memory) blocks the epoch from advancing while it is inside. */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "puthread.h"
+#include "pepoch-private.h"
+
+#define P_EPOCH_MASK			0x3FFFFFFF
+#define P_EPOCH_RECORD_SIZE		64
+
+struct PEpochRecord_ {
+	PEpochRecord	*next;
+	volatile pint	state;
+	volatile pint	in_use;
+	puint		nesting;
+	/* Records of different threads shouldn't share a cache line */
+	pchar		pad[P_EPOCH_RECORD_SIZE - sizeof (ppointer) - 3 * sizeof (pint)];
+};
+
+static volatile pint	pz_epoch_global   = 0;
+static volatile pint	pz_epoch_blockers = 0;
+static ppointer		pz_epoch_records  = NULL;
+static PUThreadKey	*pz_epoch_key     = NULL;
+
+void zepoch_init (void);
+void zepoch_shutdown (void);
+
+static PEpochRecord * pzepoch_record_acquire (void);
+static void pzepoch_record_release (PEpochRecord *record);
+static puint pzepoch_try_advance (void);
+static void pzepoch_push_chain (PEpochLimbo *limbo, PEpochEntry *first, PEpochEntry *last);
+
+static PEpochRecord *
+pzepoch_record_acquire (void)
+{
+	PEpochRecord	*record;
+	PEpochRecord	*head;
+
+	if (P_UNLIKELY (pz_epoch_key == NULL))
+		return NULL;
+
+	/* Records of the exited threads are reused */
+	for (record = zatomic_pointer_get (&pz_epoch_records); record != NULL; record = record->next) {
+		if (zatomic_int_get (&record->in_use) == 0 &&
+		    zatomic_int_compare_and_exchange (&record->in_use, 0, 1) == TRUE)
+			break;
+	}
+
+	if (record == NULL) {
+		if (P_UNLIKELY ((record = zmalloc0 (sizeof (PEpochRecord))) == NULL))
+			return NULL;
+
+		record->in_use = 1;
+
+		do {
+			head         = zatomic_pointer_get (&pz_epoch_records);
+			record->next = head;
+		} while (zatomic_pointer_compare_and_exchange (&pz_epoch_records, head, record) == FALSE);
+	}
+
+	zuthread_set_local (pz_epoch_key, record);
+
+	if (P_UNLIKELY (zuthread_get_local (pz_epoch_key) != record)) {
+		pzepoch_record_release (record);
+		return NULL;
+	}
+
+	return record;
+}
+
+/* Called on the thread exit */
+static void
+pzepoch_record_release (PEpochRecord *record)
+{
+	record->nesting = 0;
+
+	zatomic_int_set (&record->state, 0);
+	zatomic_int_set (&record->in_use, 0);
+}
+
+/* Returns the global epoch after trying to advance it */
+static puint
+pzepoch_try_advance (void)
+{
+	PEpochRecord	*record;
+	puint		global;
+	pint		state;
+
+	global = (puint) zatomic_int_get (&pz_epoch_global);
+
+	if (zatomic_int_get (&pz_epoch_blockers) > 0)
+		return global;
+
+	for (record = zatomic_pointer_get (&pz_epoch_records); record != NULL; record = record->next) {
+		state = zatomic_int_get (&record->state);
+
+		if ((state & 1) != 0 && ((puint) state >> 1) != global)
+			return global;
+	}
+
+	zatomic_int_compare_and_exchange (&pz_epoch_global, (pint) global, (pint) ((global + 1) & P_EPOCH_MASK));
+
+	return (puint) zatomic_int_get (&pz_epoch_global);
+}
+
+static void
+pzepoch_push_chain (PEpochLimbo	*limbo,
+		    PEpochEntry	*first,
+		    PEpochEntry	*last)
+{
+	PEpochEntry *head;
+
+	do {
+		head       = zatomic_pointer_get (&limbo->head);
+		last->next = head;
+	} while (zatomic_pointer_compare_and_exchange (&limbo->head, head, first) == FALSE);
+}
+
+void
+zepoch_init (void)
+{
+	if (P_LIKELY (pz_epoch_key == NULL))
+		pz_epoch_key = zuthread_local_new ((PDestroyFunc) pzepoch_record_release);
+}
+
+void
+zepoch_shutdown (void)
+{
+	PEpochRecord	*record;
+	PEpochRecord	*next;
+
+	if (pz_epoch_key != NULL) {
+		if ((record = zuthread_get_local (pz_epoch_key)) != NULL)
+			pzepoch_record_release (record);
+
+		zuthread_set_local (pz_epoch_key, NULL);
+		zuthread_local_free (pz_epoch_key);
+		pz_epoch_key = NULL;
+	}
+
+	/* Records of the threads which are still alive are released on their
+	 * exit, so they can't be freed here */
+	for (record = pz_epoch_records; record != NULL; record = next) {
+		next = record->next;
+
+		if (zatomic_int_get (&record->in_use) == 0)
+			zfree (record);
+	}
+
+	pz_epoch_records  = NULL;
+	pz_epoch_global   = 0;
+	pz_epoch_blockers = 0;
+}
+
+void
+zepoch_limbo_init (PEpochLimbo		*limbo,
+		   pint			threshold,
+		   PEpochFreeFunc	free_func,
+		   ppointer		user_data)
+{
+	limbo->head      = NULL;
+	limbo->count     = 0;
+	limbo->threshold = threshold;
+	limbo->free_func = free_func;
+	limbo->user_data = user_data;
+}
+
+void
+zepoch_limbo_flush (PEpochLimbo *limbo)
+{
+	PEpochEntry	*entry;
+	PEpochEntry	*next;
+
+	for (entry = (PEpochEntry *) limbo->head; entry != NULL; entry = next) {
+		next = entry->next;
+		limbo->free_func (entry, limbo->user_data);
+	}
+
+	limbo->head  = NULL;
+	limbo->count = 0;
+}
+
+PEpochRecord *
+zepoch_enter (void)
+{
+	PEpochRecord	*record;
+	puint		global;
+
+	record = pz_epoch_key != NULL ? zuthread_get_local (pz_epoch_key) : NULL;
+
+	if (P_UNLIKELY (record == NULL) && (record = pzepoch_record_acquire ()) == NULL) {
+		zatomic_int_inc (&pz_epoch_blockers);
+		return NULL;
+	}
+
+	if (record->nesting++ == 0) {
+		global = (puint) zatomic_int_get (&pz_epoch_global);
+		zatomic_int_set (&record->state, (pint) ((global << 1) | 1));
+	}
+
+	return record;
+}
+
+void
+zepoch_leave (PEpochRecord *record)
+{
+	if (P_UNLIKELY (record == NULL)) {
+		zatomic_int_add (&pz_epoch_blockers, -1);
+		return;
+	}
+
+	if (--record->nesting == 0)
+		zatomic_int_set (&record->state, 0);
+}
+
+void
+zepoch_retire (PEpochLimbo	*limbo,
+	       PEpochEntry	*entry)
+{
+	entry->epoch = (puint) zatomic_int_get (&pz_epoch_global);
+
+	pzepoch_push_chain (limbo, entry, entry);
+
+	zatomic_int_inc (&limbo->count);
+}
+
+void
+zepoch_reclaim (PEpochLimbo *limbo)
+{
+	PEpochEntry	*entry;
+	PEpochEntry	*first;
+	PEpochEntry	*keep_first;
+	PEpochEntry	*keep_last;
+	puint		global;
+	pint		freed;
+
+	if (zatomic_int_get (&limbo->count) < limbo->threshold)
+		return;
+
+	do {
+		first = zatomic_pointer_get (&limbo->head);
+	} while (first != NULL && zatomic_pointer_compare_and_exchange (&limbo->head, first, NULL) == FALSE);
+
+	/* Read the epoch after taking the entries, otherwise an entry retired in
+	 * between would look older than the epoch because of the wrap around */
+	global = pzepoch_try_advance ();
+
+	keep_first = NULL;
+	keep_last  = NULL;
+	freed      = 0;
+
+	while (first != NULL) {
+		entry = first;
+		first = first->next;
+
+		/* The epoch wraps around, an entry older than the mask range only
+		 * waits longer */
+		if (((global - entry->epoch) & P_EPOCH_MASK) >= 2) {
+			limbo->free_func (entry, limbo->user_data);
+			++freed;
+			continue;
+		}
+
+		entry->next = keep_first;
+		keep_first  = entry;
+
+		if (keep_last == NULL)
+			keep_last = entry;
+	}
+
+	if (keep_first != NULL)
+		pzepoch_push_chain (limbo, keep_first, keep_last);
+
+	zatomic_int_add (&limbo->count, -freed);
+}
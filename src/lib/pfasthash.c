@@ -0,0 +1,929 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* XXH3 hash function (64- and 128-bit), see the xxHash specification at
+ * https://github.com/Cyan4973/xxHash. Inputs up to 240 bytes are hashed with
+ * a few multiplications depending on the length range, longer ones are
+ * processed in 64-byte stripes with eight 64-bit accumulators. */
+
+#include "pmem.h"
+#include "pfasthash.h"
+#include "pcpuinfo-private.h"
+
+#include <string.h>
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+#  include <immintrin.h>
+#endif
+
+#define P_FAST_HASH_SECRET_SIZE		192
+#define P_FAST_HASH_STRIPE_LEN		64
+#define P_FAST_HASH_BLOCK_STRIPES	((P_FAST_HASH_SECRET_SIZE - P_FAST_HASH_STRIPE_LEN) / 8)
+#define P_FAST_HASH_BLOCK_LEN		(P_FAST_HASH_STRIPE_LEN * P_FAST_HASH_BLOCK_STRIPES)
+#define P_FAST_HASH_BUFFER_SIZE		256
+#define P_FAST_HASH_MIDSIZE_MAX		240
+#define P_FAST_HASH_MIDSIZE_START	3
+#define P_FAST_HASH_MIDSIZE_LAST	17
+#define P_FAST_HASH_LAST_ACC_START	7
+#define P_FAST_HASH_MERGE_ACCS_START	11
+#define P_FAST_HASH_SECRET_SIZE_MIN	136
+
+#define P_FAST_HASH_PRIME32_1		0x9E3779B1U
+#define P_FAST_HASH_PRIME32_2		0x85EBCA77U
+#define P_FAST_HASH_PRIME32_3		0xC2B2AE3DU
+#define P_FAST_HASH_PRIME64_1		0x9E3779B185EBCA87ULL
+#define P_FAST_HASH_PRIME64_2		0xC2B2AE3D27D4EB4FULL
+#define P_FAST_HASH_PRIME64_3		0x165667B19E3779F9ULL
+#define P_FAST_HASH_PRIME64_4		0x85EBCA77C2B2AE63ULL
+#define P_FAST_HASH_PRIME64_5		0x27D4EB2F165667C5ULL
+#define P_FAST_HASH_PRIME_MX1		0x165667919E3779F9ULL
+#define P_FAST_HASH_PRIME_MX2		0x9FB21C651E98DF25ULL
+
+struct PFastHash_ {
+	puint64		acc[8];
+	puchar		secret[P_FAST_HASH_SECRET_SIZE];
+	puchar		buf[P_FAST_HASH_BUFFER_SIZE];
+	puchar		last[P_FAST_HASH_STRIPE_LEN];
+	psize		buf_len;
+	psize		stripes;
+	puint64		total_len;
+	puint64		seed;
+};
+
+static const puchar pzfast_hash_secret[P_FAST_HASH_SECRET_SIZE] = {
+	0xB8, 0xFE, 0x6C, 0x39, 0x23, 0xA4, 0x4B, 0xBE, 0x7C, 0x01, 0x81, 0x2C, 0xF7, 0x21, 0xAD, 0x1C,
+	0xDE, 0xD4, 0x6D, 0xE9, 0x83, 0x90, 0x97, 0xDB, 0x72, 0x40, 0xA4, 0xA4, 0xB7, 0xB3, 0x67, 0x1F,
+	0xCB, 0x79, 0xE6, 0x4E, 0xCC, 0xC0, 0xE5, 0x78, 0x82, 0x5A, 0xD0, 0x7D, 0xCC, 0xFF, 0x72, 0x21,
+	0xB8, 0x08, 0x46, 0x74, 0xF7, 0x43, 0x24, 0x8E, 0xE0, 0x35, 0x90, 0xE6, 0x81, 0x3A, 0x26, 0x4C,
+	0x3C, 0x28, 0x52, 0xBB, 0x91, 0xC3, 0x00, 0xCB, 0x88, 0xD0, 0x65, 0x8B, 0x1B, 0x53, 0x2E, 0xA3,
+	0x71, 0x64, 0x48, 0x97, 0xA2, 0x0D, 0xF9, 0x4E, 0x38, 0x19, 0xEF, 0x46, 0xA9, 0xDE, 0xAC, 0xD8,
+	0xA8, 0xFA, 0x76, 0x3F, 0xE3, 0x9C, 0x34, 0x3F, 0xF9, 0xDC, 0xBB, 0xC7, 0xC7, 0x0B, 0x4F, 0x1D,
+	0x8A, 0x51, 0xE0, 0x4B, 0xCD, 0xB4, 0x59, 0x31, 0xC8, 0x9F, 0x7E, 0xC9, 0xD9, 0x78, 0x73, 0x64,
+	0xEA, 0xC5, 0xAC, 0x83, 0x34, 0xD3, 0xEB, 0xC3, 0xC5, 0x81, 0xA0, 0xFF, 0xFA, 0x13, 0x63, 0xEB,
+	0x17, 0x0D, 0xDD, 0x51, 0xB7, 0xF0, 0xDA, 0x49, 0xD3, 0x16, 0x55, 0x26, 0x29, 0xD4, 0x68, 0x9E,
+	0x2B, 0x16, 0xBE, 0x58, 0x7D, 0x47, 0xA1, 0xFC, 0x8F, 0xF8, 0xB8, 0xD1, 0x7A, 0xD0, 0x31, 0xCE,
+	0x45, 0xCB, 0x3A, 0x8F, 0x95, 0x16, 0x04, 0x28, 0xAF, 0xD7, 0xFB, 0xCA, 0xBB, 0x4B, 0x40, 0x7E
+};
+
+static puint32 pzfast_hash_read32 (const puchar *ptr);
+static puint64 pzfast_hash_read64 (const puchar *ptr);
+static puint32 pzfast_hash_swap32 (puint32 val);
+static puint64 pzfast_hash_swap64 (puint64 val);
+static void pzfast_hash_mul_64x64 (puint64 a, puint64 b, puint64 *hi, puint64 *lo);
+static puint64 pzfast_hash_mul_fold64 (puint64 a, puint64 b);
+static puint64 pzfast_hash_avalanche (puint64 h);
+static puint64 pzfast_hash_avalanche_xxh64 (puint64 h);
+static puint64 pzfast_hash_rrmxmx (puint64 h, puint64 len);
+static puint64 pzfast_hash_mix16 (const puchar *input, const puchar *secret, puint64 seed);
+static void pzfast_hash_mix32 (puint64 acc[2], const puchar *input1, const puchar *input2, const puchar *secret, puint64 seed);
+static puint64 pzfast_hash64_short (const puchar *input, psize len, puint64 seed);
+static void pzfast_hash128_short (const puchar *input, psize len, puint64 seed, PFastHash128 *result);
+static void pzfast_hash_init_secret (puchar *secret, puint64 seed);
+static void pzfast_hash_init_acc (puint64 acc[8]);
+static void pzfast_hash_accumulate_scalar (puint64 acc[8], const puchar *input, const puchar *secret, psize stripes);
+static void pzfast_hash_scramble_scalar (puint64 acc[8], const puchar *secret);
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+static P_CPU_TARGET ("sse2") void pzfast_hash_accumulate_sse2 (puint64 acc[8], const puchar *input, const puchar *secret, psize stripes);
+static P_CPU_TARGET ("sse2") void pzfast_hash_scramble_sse2 (puint64 acc[8], const puchar *secret);
+static P_CPU_TARGET ("avx2") void pzfast_hash_accumulate_avx2 (puint64 acc[8], const puchar *input, const puchar *secret, psize stripes);
+static P_CPU_TARGET ("avx2") void pzfast_hash_scramble_avx2 (puint64 acc[8], const puchar *secret);
+#endif
+static void pzfast_hash_accumulate (puint64 acc[8], const puchar *input, const puchar *secret, psize stripes);
+static void pzfast_hash_scramble (puint64 acc[8], const puchar *secret);
+static void pzfast_hash_consume (puint64 acc[8], psize *stripes_done, const puchar *input, psize stripes, const puchar *secret);
+static void pzfast_hash_long (const puchar *input, psize len, const puchar *secret, puint64 acc[8]);
+static puint64 pzfast_hash_merge (const puint64 acc[8], const puchar *secret, puint64 start);
+static void pzfast_hash_digest_long (const PFastHash *hash, puint64 acc[8]);
+
+static puint32
+pzfast_hash_read32 (const puchar *ptr)
+{
+	puint32 val;
+
+	memcpy (&val, ptr, sizeof (val));
+
+	return PUINT32_FROM_LE (val);
+}
+
+static puint64
+pzfast_hash_read64 (const puchar *ptr)
+{
+	puint64 val;
+
+	memcpy (&val, ptr, sizeof (val));
+
+	return PUINT64_FROM_LE (val);
+}
+
+static puint32
+pzfast_hash_swap32 (puint32 val)
+{
+	return ((val << 24) & 0xFF000000U) | ((val << 8) & 0x00FF0000U) |
+	       ((val >> 8)  & 0x0000FF00U) | ((val >> 24) & 0x000000FFU);
+}
+
+static puint64
+pzfast_hash_swap64 (puint64 val)
+{
+	return ((puint64) pzfast_hash_swap32 ((puint32) val) << 32) | pzfast_hash_swap32 ((puint32) (val >> 32));
+}
+
+static void
+pzfast_hash_mul_64x64 (puint64 a, puint64 b, puint64 *hi, puint64 *lo)
+{
+#if defined (P_CC_GNU) && defined (__SIZEOF_INT128__)
+	__extension__ unsigned __int128 res;
+
+	res = (unsigned __int128) a * b;
+
+	*hi = (puint64) (res >> 64);
+	*lo = (puint64) res;
+#else
+	puint64 a_lo, a_hi, b_lo, b_hi;
+	puint64 p00, p01, p10, p11;
+	puint64 mid;
+
+	a_lo = a & 0xFFFFFFFFULL;
+	a_hi = a >> 32;
+	b_lo = b & 0xFFFFFFFFULL;
+	b_hi = b >> 32;
+
+	p00 = a_lo * b_lo;
+	p01 = a_lo * b_hi;
+	p10 = a_hi * b_lo;
+	p11 = a_hi * b_hi;
+
+	mid = (p00 >> 32) + (p01 & 0xFFFFFFFFULL) + (p10 & 0xFFFFFFFFULL);
+
+	*hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+	*lo = (mid << 32) | (p00 & 0xFFFFFFFFULL);
+#endif
+}
+
+static puint64
+pzfast_hash_mul_fold64 (puint64 a, puint64 b)
+{
+	puint64 hi, lo;
+
+	pzfast_hash_mul_64x64 (a, b, &hi, &lo);
+
+	return hi ^ lo;
+}
+
+static puint64
+pzfast_hash_avalanche (puint64 h)
+{
+	h ^= h >> 37;
+	h *= P_FAST_HASH_PRIME_MX1;
+	h ^= h >> 32;
+
+	return h;
+}
+
+static puint64
+pzfast_hash_avalanche_xxh64 (puint64 h)
+{
+	h ^= h >> 33;
+	h *= P_FAST_HASH_PRIME64_2;
+	h ^= h >> 29;
+	h *= P_FAST_HASH_PRIME64_3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+static puint64
+pzfast_hash_rrmxmx (puint64 h, puint64 len)
+{
+	h ^= ((h << 49) | (h >> 15)) ^ ((h << 24) | (h >> 40));
+	h *= P_FAST_HASH_PRIME_MX2;
+	h ^= (h >> 35) + len;
+	h *= P_FAST_HASH_PRIME_MX2;
+	h ^= h >> 28;
+
+	return h;
+}
+
+static puint64
+pzfast_hash_mix16 (const puchar	*input,
+		   const puchar	*secret,
+		   puint64	seed)
+{
+	return pzfast_hash_mul_fold64 (pzfast_hash_read64 (input)     ^ (pzfast_hash_read64 (secret)     + seed),
+				       pzfast_hash_read64 (input + 8) ^ (pzfast_hash_read64 (secret + 8) - seed));
+}
+
+static void
+pzfast_hash_mix32 (puint64	acc[2],
+		   const puchar	*input1,
+		   const puchar	*input2,
+		   const puchar	*secret,
+		   puint64	seed)
+{
+	acc[0] += pzfast_hash_mix16 (input1, secret, seed);
+	acc[0] ^= pzfast_hash_read64 (input2) + pzfast_hash_read64 (input2 + 8);
+	acc[1] += pzfast_hash_mix16 (input2, secret + 16, seed);
+	acc[1] ^= pzfast_hash_read64 (input1) + pzfast_hash_read64 (input1 + 8);
+}
+
+/* Inputs up to P_FAST_HASH_MIDSIZE_MAX bytes, always with the default
+ * secret */
+static puint64
+pzfast_hash64_short (const puchar	*input,
+		     psize		len,
+		     puint64		seed)
+{
+	const puchar	*secret = pzfast_hash_secret;
+	puint64		acc, lo, hi;
+	puint32		combined;
+	psize		i;
+
+	if (len == 0)
+		return pzfast_hash_avalanche_xxh64 (seed ^ (pzfast_hash_read64 (secret + 56) ^ pzfast_hash_read64 (secret + 64)));
+
+	if (len <= 3) {
+		combined = ((puint32) input[0] << 16) | ((puint32) input[len >> 1] << 24) |
+			   ((puint32) input[len - 1])  | ((puint32) len << 8);
+
+		return pzfast_hash_avalanche_xxh64 ((puint64) combined ^
+						    ((puint64) (pzfast_hash_read32 (secret) ^ pzfast_hash_read32 (secret + 4)) + seed));
+	}
+
+	if (len <= 8) {
+		seed ^= (puint64) pzfast_hash_swap32 ((puint32) seed) << 32;
+
+		lo = pzfast_hash_read32 (input + len - 4) + ((puint64) pzfast_hash_read32 (input) << 32);
+
+		return pzfast_hash_rrmxmx (lo ^ ((pzfast_hash_read64 (secret + 8) ^ pzfast_hash_read64 (secret + 16)) - seed), len);
+	}
+
+	if (len <= 16) {
+		lo = pzfast_hash_read64 (input)           ^ ((pzfast_hash_read64 (secret + 24) ^ pzfast_hash_read64 (secret + 32)) + seed);
+		hi = pzfast_hash_read64 (input + len - 8) ^ ((pzfast_hash_read64 (secret + 40) ^ pzfast_hash_read64 (secret + 48)) - seed);
+
+		return pzfast_hash_avalanche (len + pzfast_hash_swap64 (lo) + hi + pzfast_hash_mul_fold64 (lo, hi));
+	}
+
+	acc = len * P_FAST_HASH_PRIME64_1;
+
+	if (len <= 128) {
+		if (len > 32) {
+			if (len > 64) {
+				if (len > 96) {
+					acc += pzfast_hash_mix16 (input + 48, secret + 96, seed);
+					acc += pzfast_hash_mix16 (input + len - 64, secret + 112, seed);
+				}
+
+				acc += pzfast_hash_mix16 (input + 32, secret + 64, seed);
+				acc += pzfast_hash_mix16 (input + len - 48, secret + 80, seed);
+			}
+
+			acc += pzfast_hash_mix16 (input + 16, secret + 32, seed);
+			acc += pzfast_hash_mix16 (input + len - 32, secret + 48, seed);
+		}
+
+		acc += pzfast_hash_mix16 (input, secret, seed);
+		acc += pzfast_hash_mix16 (input + len - 16, secret + 16, seed);
+
+		return pzfast_hash_avalanche (acc);
+	}
+
+	for (i = 0; i < 8; ++i)
+		acc += pzfast_hash_mix16 (input + i * 16, secret + i * 16, seed);
+
+	acc = pzfast_hash_avalanche (acc);
+
+	for (i = 8; i < len / 16; ++i)
+		acc += pzfast_hash_mix16 (input + i * 16, secret + (i - 8) * 16 + P_FAST_HASH_MIDSIZE_START, seed);
+
+	acc += pzfast_hash_mix16 (input + len - 16,
+				  secret + P_FAST_HASH_SECRET_SIZE_MIN - P_FAST_HASH_MIDSIZE_LAST,
+				  seed);
+
+	return pzfast_hash_avalanche (acc);
+}
+
+static void
+pzfast_hash128_short (const puchar	*input,
+		      psize		len,
+		      puint64		seed,
+		      PFastHash128	*result)
+{
+	const puchar	*secret = pzfast_hash_secret;
+	puint64		acc[2];
+	puint64		lo, hi;
+	puint64		m_lo, m_hi;
+	puint32		combined;
+	puint32		combined_hi;
+	psize		i;
+
+	if (len == 0) {
+		result->low  = pzfast_hash_avalanche_xxh64 (seed ^ pzfast_hash_read64 (secret + 64) ^ pzfast_hash_read64 (secret + 72));
+		result->high = pzfast_hash_avalanche_xxh64 (seed ^ pzfast_hash_read64 (secret + 80) ^ pzfast_hash_read64 (secret + 88));
+		return;
+	}
+
+	if (len <= 3) {
+		combined    = ((puint32) input[0] << 16) | ((puint32) input[len >> 1] << 24) |
+			      ((puint32) input[len - 1])  | ((puint32) len << 8);
+		combined_hi = pzfast_hash_swap32 (combined);
+		combined_hi = (combined_hi << 13) | (combined_hi >> 19);
+
+		result->low  = pzfast_hash_avalanche_xxh64 ((puint64) combined ^
+							    ((puint64) (pzfast_hash_read32 (secret) ^ pzfast_hash_read32 (secret + 4)) + seed));
+		result->high = pzfast_hash_avalanche_xxh64 ((puint64) combined_hi ^
+							    ((puint64) (pzfast_hash_read32 (secret + 8) ^ pzfast_hash_read32 (secret + 12)) - seed));
+		return;
+	}
+
+	if (len <= 8) {
+		seed ^= (puint64) pzfast_hash_swap32 ((puint32) seed) << 32;
+
+		lo = pzfast_hash_read32 (input) + ((puint64) pzfast_hash_read32 (input + len - 4) << 32);
+		lo ^= (pzfast_hash_read64 (secret + 16) ^ pzfast_hash_read64 (secret + 24)) + seed;
+
+		pzfast_hash_mul_64x64 (lo, P_FAST_HASH_PRIME64_1 + ((puint64) len << 2), &m_hi, &m_lo);
+
+		m_hi += m_lo << 1;
+		m_lo ^= m_hi >> 3;
+		m_lo ^= m_lo >> 35;
+		m_lo *= P_FAST_HASH_PRIME_MX2;
+		m_lo ^= m_lo >> 28;
+
+		result->low  = m_lo;
+		result->high = pzfast_hash_avalanche (m_hi);
+		return;
+	}
+
+	if (len <= 16) {
+		lo = pzfast_hash_read64 (input);
+		hi = pzfast_hash_read64 (input + len - 8);
+
+		pzfast_hash_mul_64x64 (lo ^ hi ^ ((pzfast_hash_read64 (secret + 32) ^ pzfast_hash_read64 (secret + 40)) - seed),
+				       P_FAST_HASH_PRIME64_1,
+				       &m_hi,
+				       &m_lo);
+
+		m_lo += (puint64) (len - 1) << 54;
+		hi   ^= (pzfast_hash_read64 (secret + 48) ^ pzfast_hash_read64 (secret + 56)) + seed;
+		m_hi += hi + (puint64) (puint32) hi * (P_FAST_HASH_PRIME32_2 - 1);
+		m_lo ^= pzfast_hash_swap64 (m_hi);
+
+		pzfast_hash_mul_64x64 (m_lo, P_FAST_HASH_PRIME64_2, &hi, &lo);
+
+		hi += m_hi * P_FAST_HASH_PRIME64_2;
+
+		result->low  = pzfast_hash_avalanche (lo);
+		result->high = pzfast_hash_avalanche (hi);
+		return;
+	}
+
+	acc[0] = len * P_FAST_HASH_PRIME64_1;
+	acc[1] = 0;
+
+	if (len <= 128) {
+		if (len > 32) {
+			if (len > 64) {
+				if (len > 96)
+					pzfast_hash_mix32 (acc, input + 48, input + len - 64, secret + 96, seed);
+
+				pzfast_hash_mix32 (acc, input + 32, input + len - 48, secret + 64, seed);
+			}
+
+			pzfast_hash_mix32 (acc, input + 16, input + len - 32, secret + 32, seed);
+		}
+
+		pzfast_hash_mix32 (acc, input, input + len - 16, secret, seed);
+	} else {
+		for (i = 0; i < 4; ++i)
+			pzfast_hash_mix32 (acc, input + i * 32, input + i * 32 + 16, secret + i * 32, seed);
+
+		acc[0] = pzfast_hash_avalanche (acc[0]);
+		acc[1] = pzfast_hash_avalanche (acc[1]);
+
+		for (i = 4; i < len / 32; ++i)
+			pzfast_hash_mix32 (acc,
+					   input + i * 32,
+					   input + i * 32 + 16,
+					   secret + P_FAST_HASH_MIDSIZE_START + (i - 4) * 32,
+					   seed);
+
+		pzfast_hash_mix32 (acc,
+				   input + len - 16,
+				   input + len - 32,
+				   secret + P_FAST_HASH_SECRET_SIZE_MIN - P_FAST_HASH_MIDSIZE_LAST - 16,
+				   0 - seed);
+	}
+
+	result->low  = pzfast_hash_avalanche (acc[0] + acc[1]);
+	result->high = 0 - pzfast_hash_avalanche (acc[0] * P_FAST_HASH_PRIME64_1 +
+						  acc[1] * P_FAST_HASH_PRIME64_4 +
+						  (len - seed) * P_FAST_HASH_PRIME64_2);
+}
+
+/* The long inputs use the default secret shifted by the seed */
+static void
+pzfast_hash_init_secret (puchar		*secret,
+			 puint64	seed)
+{
+	puint64	lo, hi;
+	psize	i;
+
+	for (i = 0; i < P_FAST_HASH_SECRET_SIZE; i += 16) {
+		lo = PUINT64_TO_LE (pzfast_hash_read64 (pzfast_hash_secret + i) + seed);
+		hi = PUINT64_TO_LE (pzfast_hash_read64 (pzfast_hash_secret + i + 8) - seed);
+
+		memcpy (secret + i, &lo, 8);
+		memcpy (secret + i + 8, &hi, 8);
+	}
+}
+
+static void
+pzfast_hash_init_acc (puint64 acc[8])
+{
+	acc[0] = P_FAST_HASH_PRIME32_3;
+	acc[1] = P_FAST_HASH_PRIME64_1;
+	acc[2] = P_FAST_HASH_PRIME64_2;
+	acc[3] = P_FAST_HASH_PRIME64_3;
+	acc[4] = P_FAST_HASH_PRIME64_4;
+	acc[5] = P_FAST_HASH_PRIME32_2;
+	acc[6] = P_FAST_HASH_PRIME64_5;
+	acc[7] = P_FAST_HASH_PRIME32_1;
+}
+
+/* Every stripe uses the secret shifted by 8 bytes from the previous one */
+static void
+pzfast_hash_accumulate_scalar (puint64		acc[8],
+			       const puchar	*input,
+			       const puchar	*secret,
+			       psize		stripes)
+{
+	puint64	data_val;
+	puint64	data_key;
+	psize	i, j;
+
+	for (i = 0; i < stripes; ++i) {
+		for (j = 0; j < 8; ++j) {
+			data_val = pzfast_hash_read64 (input + j * 8);
+			data_key = data_val ^ pzfast_hash_read64 (secret + j * 8);
+
+			acc[j ^ 1] += data_val;
+			acc[j]     += (data_key & 0xFFFFFFFFULL) * (data_key >> 32);
+		}
+
+		input  += P_FAST_HASH_STRIPE_LEN;
+		secret += 8;
+	}
+}
+
+static void
+pzfast_hash_scramble_scalar (puint64		acc[8],
+			     const puchar	*secret)
+{
+	psize i;
+
+	for (i = 0; i < 8; ++i) {
+		acc[i] ^= acc[i] >> 47;
+		acc[i] ^= pzfast_hash_read64 (secret + i * 8);
+		acc[i] *= P_FAST_HASH_PRIME32_1;
+	}
+}
+
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+static P_CPU_TARGET ("sse2") void
+pzfast_hash_accumulate_sse2 (puint64		acc[8],
+			     const puchar	*input,
+			     const puchar	*secret,
+			     psize		stripes)
+{
+	__m128i	vacc[4];
+	__m128i	data_val, data_key;
+	psize	i, j;
+
+	for (j = 0; j < 4; ++j)
+		vacc[j] = _mm_loadu_si128 ((const __m128i *) (acc + j * 2));
+
+	for (i = 0; i < stripes; ++i) {
+		for (j = 0; j < 4; ++j) {
+			data_val = _mm_loadu_si128 ((const __m128i *) (input + j * 16));
+			data_key = _mm_xor_si128 (data_val, _mm_loadu_si128 ((const __m128i *) (secret + j * 16)));
+
+			/* Low half of every key word multiplied by its high half,
+			 * the data words are added to the neighbour accumulators */
+			vacc[j] = _mm_add_epi64 (vacc[j], _mm_shuffle_epi32 (data_val, _MM_SHUFFLE (1, 0, 3, 2)));
+			vacc[j] = _mm_add_epi64 (vacc[j], _mm_mul_epu32 (data_key, _mm_shuffle_epi32 (data_key, _MM_SHUFFLE (0, 3, 0, 1))));
+		}
+
+		input  += P_FAST_HASH_STRIPE_LEN;
+		secret += 8;
+	}
+
+	for (j = 0; j < 4; ++j)
+		_mm_storeu_si128 ((__m128i *) (acc + j * 2), vacc[j]);
+}
+
+static P_CPU_TARGET ("sse2") void
+pzfast_hash_scramble_sse2 (puint64		acc[8],
+			   const puchar		*secret)
+{
+	__m128i	vacc, prime;
+	psize	j;
+
+	prime = _mm_set1_epi32 ((pint) P_FAST_HASH_PRIME32_1);
+
+	for (j = 0; j < 4; ++j) {
+		vacc = _mm_loadu_si128 ((const __m128i *) (acc + j * 2));
+		vacc = _mm_xor_si128 (vacc, _mm_srli_epi64 (vacc, 47));
+		vacc = _mm_xor_si128 (vacc, _mm_loadu_si128 ((const __m128i *) (secret + j * 16)));
+
+		/* 64-bit multiplication by a 32-bit constant */
+		vacc = _mm_add_epi64 (_mm_mul_epu32 (vacc, prime),
+				      _mm_slli_epi64 (_mm_mul_epu32 (_mm_shuffle_epi32 (vacc, _MM_SHUFFLE (0, 3, 0, 1)), prime), 32));
+
+		_mm_storeu_si128 ((__m128i *) (acc + j * 2), vacc);
+	}
+}
+
+static P_CPU_TARGET ("avx2") void
+pzfast_hash_accumulate_avx2 (puint64		acc[8],
+			     const puchar	*input,
+			     const puchar	*secret,
+			     psize		stripes)
+{
+	__m256i	vacc[2];
+	__m256i	data_val, data_key;
+	psize	i, j;
+
+	for (j = 0; j < 2; ++j)
+		vacc[j] = _mm256_loadu_si256 ((const __m256i *) (acc + j * 4));
+
+	for (i = 0; i < stripes; ++i) {
+		for (j = 0; j < 2; ++j) {
+			data_val = _mm256_loadu_si256 ((const __m256i *) (input + j * 32));
+			data_key = _mm256_xor_si256 (data_val, _mm256_loadu_si256 ((const __m256i *) (secret + j * 32)));
+
+			vacc[j] = _mm256_add_epi64 (vacc[j], _mm256_shuffle_epi32 (data_val, _MM_SHUFFLE (1, 0, 3, 2)));
+			vacc[j] = _mm256_add_epi64 (vacc[j], _mm256_mul_epu32 (data_key, _mm256_shuffle_epi32 (data_key, _MM_SHUFFLE (0, 3, 0, 1))));
+		}
+
+		input  += P_FAST_HASH_STRIPE_LEN;
+		secret += 8;
+	}
+
+	for (j = 0; j < 2; ++j)
+		_mm256_storeu_si256 ((__m256i *) (acc + j * 4), vacc[j]);
+}
+
+static P_CPU_TARGET ("avx2") void
+pzfast_hash_scramble_avx2 (puint64		acc[8],
+			   const puchar		*secret)
+{
+	__m256i	vacc, prime;
+	psize	j;
+
+	prime = _mm256_set1_epi32 ((pint) P_FAST_HASH_PRIME32_1);
+
+	for (j = 0; j < 2; ++j) {
+		vacc = _mm256_loadu_si256 ((const __m256i *) (acc + j * 4));
+		vacc = _mm256_xor_si256 (vacc, _mm256_srli_epi64 (vacc, 47));
+		vacc = _mm256_xor_si256 (vacc, _mm256_loadu_si256 ((const __m256i *) (secret + j * 32)));
+		vacc = _mm256_add_epi64 (_mm256_mul_epu32 (vacc, prime),
+					 _mm256_slli_epi64 (_mm256_mul_epu32 (_mm256_shuffle_epi32 (vacc, _MM_SHUFFLE (0, 3, 0, 1)), prime), 32));
+
+		_mm256_storeu_si256 ((__m256i *) (acc + j * 4), vacc);
+	}
+}
+#endif
+
+static void
+pzfast_hash_accumulate (puint64		acc[8],
+			const puchar	*input,
+			const puchar	*secret,
+			psize		stripes)
+{
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		pzfast_hash_accumulate_avx2 (acc, input, secret, stripes);
+	else if (zcpu_info_has_feature (P_CPU_FEATURE_SSE2))
+		pzfast_hash_accumulate_sse2 (acc, input, secret, stripes);
+	else
+#endif
+		pzfast_hash_accumulate_scalar (acc, input, secret, stripes);
+}
+
+static void
+pzfast_hash_scramble (puint64		acc[8],
+		      const puchar	*secret)
+{
+#ifdef PLIBSYS_HAS_X86_TARGET_ATTR
+	if (zcpu_info_has_feature (P_CPU_FEATURE_AVX2))
+		pzfast_hash_scramble_avx2 (acc, secret);
+	else if (zcpu_info_has_feature (P_CPU_FEATURE_SSE2))
+		pzfast_hash_scramble_sse2 (acc, secret);
+	else
+#endif
+		pzfast_hash_scramble_scalar (acc, secret);
+}
+
+/* Accumulates the stripes continuing the current block, the accumulators are
+ * scrambled at the end of every block */
+static void
+pzfast_hash_consume (puint64		acc[8],
+		     psize		*stripes_done,
+		     const puchar	*input,
+		     psize		stripes,
+		     const puchar	*secret)
+{
+	psize count;
+
+	while (stripes > 0) {
+		count = P_FAST_HASH_BLOCK_STRIPES - *stripes_done;
+
+		if (count > stripes)
+			count = stripes;
+
+		pzfast_hash_accumulate (acc, input, secret + *stripes_done * 8, count);
+
+		*stripes_done += count;
+		input         += count * P_FAST_HASH_STRIPE_LEN;
+		stripes       -= count;
+
+		if (*stripes_done == P_FAST_HASH_BLOCK_STRIPES) {
+			pzfast_hash_scramble (acc, secret + P_FAST_HASH_SECRET_SIZE - P_FAST_HASH_STRIPE_LEN);
+			*stripes_done = 0;
+		}
+	}
+}
+
+/* The last stripe is always the final 64 bytes of the input, it may overlap
+ * with the previous one */
+static void
+pzfast_hash_long (const puchar	*input,
+		  psize		len,
+		  const puchar	*secret,
+		  puint64	acc[8])
+{
+	psize stripes_done = 0;
+
+	pzfast_hash_init_acc (acc);
+	pzfast_hash_consume (acc, &stripes_done, input, (len - 1) / P_FAST_HASH_STRIPE_LEN, secret);
+	pzfast_hash_accumulate (acc,
+				input + len - P_FAST_HASH_STRIPE_LEN,
+				secret + P_FAST_HASH_SECRET_SIZE - P_FAST_HASH_STRIPE_LEN - P_FAST_HASH_LAST_ACC_START,
+				1);
+}
+
+static puint64
+pzfast_hash_merge (const puint64	acc[8],
+		   const puchar		*secret,
+		   puint64		start)
+{
+	psize i;
+
+	for (i = 0; i < 4; ++i)
+		start += pzfast_hash_mul_fold64 (acc[i * 2]     ^ pzfast_hash_read64 (secret + i * 16),
+						 acc[i * 2 + 1] ^ pzfast_hash_read64 (secret + i * 16 + 8));
+
+	return pzfast_hash_avalanche (start);
+}
+
+static void
+pzfast_hash_digest_long (const PFastHash	*hash,
+			 puint64		acc[8])
+{
+	puchar		last[P_FAST_HASH_STRIPE_LEN];
+	const puchar	*last_ptr;
+	psize		stripes_done;
+
+	memcpy (acc, hash->acc, sizeof (hash->acc));
+	stripes_done = hash->stripes;
+
+	if (hash->buf_len >= P_FAST_HASH_STRIPE_LEN) {
+		pzfast_hash_consume (acc,
+				     &stripes_done,
+				     hash->buf,
+				     (hash->buf_len - 1) / P_FAST_HASH_STRIPE_LEN,
+				     hash->secret);
+
+		last_ptr = hash->buf + hash->buf_len - P_FAST_HASH_STRIPE_LEN;
+	} else {
+		/* Complete the last stripe with the tail of the consumed data */
+		memcpy (last, hash->last + hash->buf_len, P_FAST_HASH_STRIPE_LEN - hash->buf_len);
+		memcpy (last + P_FAST_HASH_STRIPE_LEN - hash->buf_len, hash->buf, hash->buf_len);
+
+		last_ptr = last;
+	}
+
+	pzfast_hash_accumulate (acc,
+				last_ptr,
+				hash->secret + P_FAST_HASH_SECRET_SIZE - P_FAST_HASH_STRIPE_LEN - P_FAST_HASH_LAST_ACC_START,
+				1);
+}
+
+P_LIB_API puint64
+zfast_hash64 (pconstpointer	data,
+	      psize		len,
+	      puint64		seed)
+{
+	puchar	secret[P_FAST_HASH_SECRET_SIZE];
+	puint64	acc[8];
+
+	if (P_UNLIKELY (data == NULL && len > 0))
+		return 0;
+
+	if (len <= P_FAST_HASH_MIDSIZE_MAX)
+		return pzfast_hash64_short ((const puchar *) data, len, seed);
+
+	pzfast_hash_init_secret (secret, seed);
+	pzfast_hash_long ((const puchar *) data, len, secret, acc);
+
+	return pzfast_hash_merge (acc, secret + P_FAST_HASH_MERGE_ACCS_START, (puint64) len * P_FAST_HASH_PRIME64_1);
+}
+
+P_LIB_API void
+zfast_hash128 (pconstpointer	data,
+	       psize		len,
+	       puint64		seed,
+	       PFastHash128	*result)
+{
+	puchar	secret[P_FAST_HASH_SECRET_SIZE];
+	puint64	acc[8];
+
+	if (P_UNLIKELY (result == NULL))
+		return;
+
+	if (P_UNLIKELY (data == NULL && len > 0)) {
+		result->low  = 0;
+		result->high = 0;
+		return;
+	}
+
+	if (len <= P_FAST_HASH_MIDSIZE_MAX) {
+		pzfast_hash128_short ((const puchar *) data, len, seed, result);
+		return;
+	}
+
+	pzfast_hash_init_secret (secret, seed);
+	pzfast_hash_long ((const puchar *) data, len, secret, acc);
+
+	result->low  = pzfast_hash_merge (acc,
+					  secret + P_FAST_HASH_MERGE_ACCS_START,
+					  (puint64) len * P_FAST_HASH_PRIME64_1);
+	result->high = pzfast_hash_merge (acc,
+					  secret + P_FAST_HASH_SECRET_SIZE - P_FAST_HASH_STRIPE_LEN - P_FAST_HASH_MERGE_ACCS_START,
+					  ~((puint64) len * P_FAST_HASH_PRIME64_2));
+}
+
+P_LIB_API PFastHash *
+zfast_hash_new (puint64 seed)
+{
+	PFastHash *ret;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PFastHash))) == NULL)) {
+		P_ERROR ("PFastHash::zfast_hash_new: failed to allocate memory");
+		return NULL;
+	}
+
+	zfast_hash_reset (ret, seed);
+
+	return ret;
+}
+
+/* Stripes are consumed only when more data follows them, so the buffer is
+ * never empty on digest and short inputs stay entirely in the buffer */
+P_LIB_API void
+zfast_hash_update (PFastHash		*hash,
+		   pconstpointer	data,
+		   psize		len)
+{
+	const puchar	*input = (const puchar *) data;
+	psize		to_fill;
+	psize		stripes;
+
+	if (P_UNLIKELY (hash == NULL || input == NULL || len == 0))
+		return;
+
+	hash->total_len += len;
+
+	if (hash->buf_len + len <= P_FAST_HASH_BUFFER_SIZE) {
+		memcpy (hash->buf + hash->buf_len, input, len);
+		hash->buf_len += len;
+		return;
+	}
+
+	if (hash->buf_len > 0) {
+		to_fill = P_FAST_HASH_BUFFER_SIZE - hash->buf_len;
+
+		memcpy (hash->buf + hash->buf_len, input, to_fill);
+
+		input += to_fill;
+		len   -= to_fill;
+
+		pzfast_hash_consume (hash->acc,
+				     &hash->stripes,
+				     hash->buf,
+				     P_FAST_HASH_BUFFER_SIZE / P_FAST_HASH_STRIPE_LEN,
+				     hash->secret);
+
+		memcpy (hash->last, hash->buf + P_FAST_HASH_BUFFER_SIZE - P_FAST_HASH_STRIPE_LEN, P_FAST_HASH_STRIPE_LEN);
+		hash->buf_len = 0;
+	}
+
+	if (len > P_FAST_HASH_BUFFER_SIZE) {
+		stripes = (len - 1) / P_FAST_HASH_STRIPE_LEN;
+
+		pzfast_hash_consume (hash->acc, &hash->stripes, input, stripes, hash->secret);
+
+		input += stripes * P_FAST_HASH_STRIPE_LEN;
+		len   -= stripes * P_FAST_HASH_STRIPE_LEN;
+
+		memcpy (hash->last, input - P_FAST_HASH_STRIPE_LEN, P_FAST_HASH_STRIPE_LEN);
+	}
+
+	memcpy (hash->buf, input, len);
+	hash->buf_len = len;
+}
+
+P_LIB_API puint64
+zfast_hash_digest64 (const PFastHash *hash)
+{
+	puint64 acc[8];
+
+	if (P_UNLIKELY (hash == NULL))
+		return 0;
+
+	if (hash->total_len <= P_FAST_HASH_MIDSIZE_MAX)
+		return pzfast_hash64_short (hash->buf, hash->buf_len, hash->seed);
+
+	pzfast_hash_digest_long (hash, acc);
+
+	return pzfast_hash_merge (acc, hash->secret + P_FAST_HASH_MERGE_ACCS_START, hash->total_len * P_FAST_HASH_PRIME64_1);
+}
+
+P_LIB_API void
+zfast_hash_digest128 (const PFastHash	*hash,
+		      PFastHash128	*result)
+{
+	puint64 acc[8];
+
+	if (P_UNLIKELY (hash == NULL || result == NULL))
+		return;
+
+	if (hash->total_len <= P_FAST_HASH_MIDSIZE_MAX) {
+		pzfast_hash128_short (hash->buf, hash->buf_len, hash->seed, result);
+		return;
+	}
+
+	pzfast_hash_digest_long (hash, acc);
+
+	result->low  = pzfast_hash_merge (acc,
+					  hash->secret + P_FAST_HASH_MERGE_ACCS_START,
+					  hash->total_len * P_FAST_HASH_PRIME64_1);
+	result->high = pzfast_hash_merge (acc,
+					  hash->secret + P_FAST_HASH_SECRET_SIZE - P_FAST_HASH_STRIPE_LEN - P_FAST_HASH_MERGE_ACCS_START,
+					  ~(hash->total_len * P_FAST_HASH_PRIME64_2));
+}
+
+P_LIB_API void
+zfast_hash_reset (PFastHash	*hash,
+		  puint64	seed)
+{
+	if (P_UNLIKELY (hash == NULL))
+		return;
+
+	pzfast_hash_init_acc (hash->acc);
+	pzfast_hash_init_secret (hash->secret, seed);
+
+	hash->buf_len   = 0;
+	hash->stripes   = 0;
+	hash->total_len = 0;
+	hash->seed      = seed;
+}
+
+P_LIB_API void
+zfast_hash_free (PFastHash *hash)
+{
+	zfree (hash);
+}
@@ -0,0 +1,524 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pflatmap.h"
+
+#include <string.h>
+
+#define P_FLAT_MAP_MIN_CAPACITY		8
+#define P_FLAT_MAP_SMALL_BATCH		8
+#define P_FLAT_MAP_INSERTION_RUN	16
+
+#define P_FLAT_MAP_MIN(a, b)		((a) < (b) ? (a) : (b))
+
+typedef struct PFlatMapEntry_ {
+	ppointer	key;
+	ppointer	value;
+} PFlatMapEntry;
+
+struct PFlatMap_ {
+	PFlatMapEntry		*entries;
+	psize			nsorted;
+	psize			nentries;
+	psize			capacity;
+	PCompareDataFunc	compare_func;
+	ppointer		data;
+	PDestroyFunc		key_destroy_func;
+	PDestroyFunc		value_destroy_func;
+};
+
+static void pzflat_map_destroy_entry (PFlatMap *map, PFlatMapEntry *entry);
+static psize pzflat_map_lower_bound (const PFlatMap *map, pconstpointer key);
+static void pzflat_map_sort (PFlatMap *map, PFlatMapEntry *entries, psize count, PFlatMapEntry *buf);
+static psize pzflat_map_dedupe (PFlatMap *map, PFlatMapEntry *entries, psize count);
+static void pzflat_map_commit_small (PFlatMap *map);
+
+static void
+pzflat_map_destroy_entry (PFlatMap	*map,
+			  PFlatMapEntry	*entry)
+{
+	if (map->key_destroy_func != NULL)
+		map->key_destroy_func (entry->key);
+
+	if (map->value_destroy_func != NULL)
+		map->value_destroy_func (entry->value);
+}
+
+/* Returns index of the first sorted entry with the key not less than the given
+ * one. Search range is halved without branching on the comparison result, so
+ * the compiler can use conditional moves instead of the mispredicted jumps. */
+static psize
+pzflat_map_lower_bound (const PFlatMap	*map,
+			pconstpointer	key)
+{
+	const PFlatMapEntry	*base;
+	psize			len;
+	psize			half;
+
+	if (map->nsorted == 0)
+		return 0;
+
+	base = map->entries;
+	len  = map->nsorted;
+
+	while (len > 1) {
+		half  = len >> 1;
+		base += (map->compare_func (base[half].key, key, map->data) < 0) ? half : 0;
+		len  -= half;
+	}
+
+	return (psize) (base - map->entries) + (map->compare_func (base->key, key, map->data) < 0 ? 1 : 0);
+}
+
+/* Stable bottom-up merge sort: short runs are sorted with insertions and then
+ * merged pairwise, ping-ponging between the entries and the buffer */
+static void
+pzflat_map_sort (PFlatMap	*map,
+		 PFlatMapEntry	*entries,
+		 psize		count,
+		 PFlatMapEntry	*buf)
+{
+	PFlatMapEntry	*src;
+	PFlatMapEntry	*dst;
+	PFlatMapEntry	*tmp;
+	PFlatMapEntry	entry;
+	psize		width;
+	psize		start;
+	psize		mid;
+	psize		end;
+	psize		i;
+	psize		j;
+	psize		k;
+
+	for (start = 0; start < count; start += P_FLAT_MAP_INSERTION_RUN) {
+		end = P_FLAT_MAP_MIN (start + P_FLAT_MAP_INSERTION_RUN, count);
+
+		for (i = start + 1; i < end; ++i) {
+			entry = entries[i];
+
+			for (j = i; j > start && map->compare_func (entries[j - 1].key, entry.key, map->data) > 0; --j)
+				entries[j] = entries[j - 1];
+
+			entries[j] = entry;
+		}
+	}
+
+	src = entries;
+	dst = buf;
+
+	for (width = P_FLAT_MAP_INSERTION_RUN; width < count; width <<= 1) {
+		for (start = 0; start < count; start += width << 1) {
+			mid = P_FLAT_MAP_MIN (start + width, count);
+			end = P_FLAT_MAP_MIN (start + (width << 1), count);
+
+			i = start;
+			j = mid;
+			k = start;
+
+			while (i < mid && j < end) {
+				if (map->compare_func (src[j].key, src[i].key, map->data) < 0)
+					dst[k++] = src[j++];
+				else
+					dst[k++] = src[i++];
+			}
+
+			if (i < mid)
+				memcpy (dst + k, src + i, (mid - i) * sizeof (PFlatMapEntry));
+			else if (j < end)
+				memcpy (dst + k, src + j, (end - j) * sizeof (PFlatMapEntry));
+		}
+
+		tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	if (src != entries)
+		memcpy (entries, src, count * sizeof (PFlatMapEntry));
+}
+
+/* Keeps only the last inserted entry among the equal keys */
+static psize
+pzflat_map_dedupe (PFlatMap		*map,
+		   PFlatMapEntry	*entries,
+		   psize		count)
+{
+	psize i;
+	psize out;
+
+	if (count == 0)
+		return 0;
+
+	out = 0;
+
+	for (i = 1; i < count; ++i) {
+		if (map->compare_func (entries[out].key, entries[i].key, map->data) == 0)
+			pzflat_map_destroy_entry (map, &entries[out]);
+		else
+			++out;
+
+		entries[out] = entries[i];
+	}
+
+	return out + 1;
+}
+
+/* Merges pending entries one by one, requires no extra memory */
+static void
+pzflat_map_commit_small (PFlatMap *map)
+{
+	PFlatMapEntry	entry;
+	psize		pos;
+
+	while (map->nsorted < map->nentries) {
+		entry = map->entries[map->nsorted];
+		pos   = pzflat_map_lower_bound (map, entry.key);
+
+		if (pos < map->nsorted &&
+		    map->compare_func (map->entries[pos].key, entry.key, map->data) == 0) {
+			pzflat_map_destroy_entry (map, &map->entries[pos]);
+			map->entries[pos] = entry;
+
+			memmove (map->entries + map->nsorted,
+				 map->entries + map->nsorted + 1,
+				 (map->nentries - map->nsorted - 1) * sizeof (PFlatMapEntry));
+			--map->nentries;
+		} else {
+			memmove (map->entries + pos + 1,
+				 map->entries + pos,
+				 (map->nsorted - pos) * sizeof (PFlatMapEntry));
+			map->entries[pos] = entry;
+			++map->nsorted;
+		}
+	}
+}
+
+P_LIB_API PFlatMap *
+zflat_map_new (PCompareFunc func)
+{
+	return zflat_map_new_full ((PCompareDataFunc) func, NULL, NULL, NULL);
+}
+
+P_LIB_API PFlatMap *
+zflat_map_new_with_data (PCompareDataFunc	func,
+			 ppointer		data)
+{
+	return zflat_map_new_full (func, data, NULL, NULL);
+}
+
+P_LIB_API PFlatMap *
+zflat_map_new_full (PCompareDataFunc	func,
+		    ppointer		data,
+		    PDestroyFunc	key_destroy,
+		    PDestroyFunc	value_destroy)
+{
+	PFlatMap *ret;
+
+	if (P_UNLIKELY (func == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PFlatMap))) == NULL)) {
+		P_ERROR ("PFlatMap::zflat_map_new_full: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	ret->compare_func       = func;
+	ret->data               = data;
+	ret->key_destroy_func   = key_destroy;
+	ret->value_destroy_func = value_destroy;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+zflat_map_reserve (PFlatMap	*map,
+		   psize	npairs)
+{
+	PFlatMapEntry *entries;
+
+	if (P_UNLIKELY (map == NULL))
+		return FALSE;
+
+	if (npairs <= map->capacity)
+		return TRUE;
+
+	if (P_UNLIKELY (npairs > ((psize) -1) / sizeof (PFlatMapEntry)))
+		return FALSE;
+
+	if (P_UNLIKELY ((entries = zrealloc (map->entries, npairs * sizeof (PFlatMapEntry))) == NULL)) {
+		P_ERROR ("PFlatMap::zflat_map_reserve: failed(1) to allocate memory");
+		return FALSE;
+	}
+
+	map->entries  = entries;
+	map->capacity = npairs;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+zflat_map_insert (PFlatMap	*map,
+		  ppointer	key,
+		  ppointer	value)
+{
+	psize capacity;
+
+	if (P_UNLIKELY (map == NULL))
+		return FALSE;
+
+	if (map->nentries == map->capacity) {
+		capacity = map->capacity < P_FLAT_MAP_MIN_CAPACITY ? P_FLAT_MAP_MIN_CAPACITY
+								   : map->capacity << 1;
+
+		if (P_UNLIKELY (zflat_map_reserve (map, capacity) == FALSE))
+			return FALSE;
+	}
+
+	map->entries[map->nentries].key   = key;
+	map->entries[map->nentries].value = value;
+
+	/* Keep the map sorted while keys come in order */
+	if (map->nsorted == map->nentries &&
+	    (map->nsorted == 0 ||
+	     map->compare_func (map->entries[map->nsorted - 1].key, key, map->data) < 0))
+		++map->nsorted;
+
+	++map->nentries;
+
+	return TRUE;
+}
+
+P_LIB_API void
+zflat_map_commit (PFlatMap *map)
+{
+	PFlatMapEntry	*pending;
+	psize		npending;
+	psize		src;
+	psize		dst;
+	pssize		main_idx;
+	pssize		pend_idx;
+	pint		cmp;
+
+	if (P_UNLIKELY (map == NULL))
+		return;
+
+	npending = map->nentries - map->nsorted;
+
+	if (npending == 0)
+		return;
+
+	if (npending <= P_FLAT_MAP_SMALL_BATCH ||
+	    (pending = zmalloc (npending * sizeof (PFlatMapEntry))) == NULL) {
+		pzflat_map_commit_small (map);
+		return;
+	}
+
+	pzflat_map_sort (map, map->entries + map->nsorted, npending, pending);
+	npending = pzflat_map_dedupe (map, map->entries + map->nsorted, npending);
+
+	memcpy (pending, map->entries + map->nsorted, npending * sizeof (PFlatMapEntry));
+
+	/* Merge from the tail, so the sorted part stays in place as long as
+	 * possible. Old entries with the same keys are replaced. */
+	main_idx = (pssize) map->nsorted - 1;
+	pend_idx = (pssize) npending - 1;
+	dst      = map->nsorted + npending;
+
+	while (pend_idx >= 0) {
+		cmp = main_idx >= 0 ? map->compare_func (map->entries[main_idx].key,
+							 pending[pend_idx].key,
+							 map->data)
+				    : -1;
+
+		if (cmp > 0)
+			map->entries[--dst] = map->entries[main_idx--];
+		else {
+			if (cmp == 0)
+				pzflat_map_destroy_entry (map, &map->entries[main_idx--]);
+
+			map->entries[--dst] = pending[pend_idx--];
+		}
+	}
+
+	/* Close the gap left by the replaced entries */
+	src = (psize) (main_idx + 1);
+
+	if (dst != src)
+		memmove (map->entries + src,
+			 map->entries + dst,
+			 (map->nsorted + npending - dst) * sizeof (PFlatMapEntry));
+
+	map->nsorted  = map->nsorted + npending - (dst - src);
+	map->nentries = map->nsorted;
+
+	zfree (pending);
+}
+
+P_LIB_API pboolean
+zflat_map_remove (PFlatMap	*map,
+		  pconstpointer	key)
+{
+	psize pos;
+
+	if (P_UNLIKELY (map == NULL))
+		return FALSE;
+
+	zflat_map_commit (map);
+
+	pos = pzflat_map_lower_bound (map, key);
+
+	if (pos == map->nsorted || map->compare_func (map->entries[pos].key, key, map->data) != 0)
+		return FALSE;
+
+	pzflat_map_destroy_entry (map, &map->entries[pos]);
+
+	memmove (map->entries + pos,
+		 map->entries + pos + 1,
+		 (map->nsorted - pos - 1) * sizeof (PFlatMapEntry));
+
+	--map->nsorted;
+	--map->nentries;
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+zflat_map_lookup (PFlatMap	*map,
+		  pconstpointer	key)
+{
+	psize pos;
+
+	if (P_UNLIKELY (map == NULL))
+		return NULL;
+
+	zflat_map_commit (map);
+
+	pos = pzflat_map_lower_bound (map, key);
+
+	if (pos == map->nsorted || map->compare_func (map->entries[pos].key, key, map->data) != 0)
+		return NULL;
+
+	return map->entries[pos].value;
+}
+
+P_LIB_API pboolean
+zflat_map_contains (PFlatMap		*map,
+		    pconstpointer	key)
+{
+	psize pos;
+
+	if (P_UNLIKELY (map == NULL))
+		return FALSE;
+
+	zflat_map_commit (map);
+
+	pos = pzflat_map_lower_bound (map, key);
+
+	return pos < map->nsorted && map->compare_func (map->entries[pos].key, key, map->data) == 0;
+}
+
+P_LIB_API void
+zflat_map_foreach (PFlatMap		*map,
+		   PTraverseFunc	traverse_func,
+		   ppointer		user_data)
+{
+	psize i;
+
+	if (P_UNLIKELY (map == NULL || traverse_func == NULL))
+		return;
+
+	zflat_map_commit (map);
+
+	for (i = 0; i < map->nsorted; ++i) {
+		if (traverse_func (map->entries[i].key, map->entries[i].value, user_data) == TRUE)
+			break;
+	}
+}
+
+P_LIB_API void
+zflat_map_foreach_range (PFlatMap		*map,
+			 pconstpointer		from,
+			 pconstpointer		to,
+			 PTraverseFunc		traverse_func,
+			 ppointer		user_data)
+{
+	psize i;
+
+	if (P_UNLIKELY (map == NULL || traverse_func == NULL))
+		return;
+
+	zflat_map_commit (map);
+
+	for (i = pzflat_map_lower_bound (map, from); i < map->nsorted; ++i) {
+		if (map->compare_func (map->entries[i].key, to, map->data) >= 0)
+			break;
+
+		if (traverse_func (map->entries[i].key, map->entries[i].value, user_data) == TRUE)
+			break;
+	}
+}
+
+P_LIB_API pint
+zflat_map_get_nnodes (PFlatMap *map)
+{
+	if (P_UNLIKELY (map == NULL))
+		return 0;
+
+	zflat_map_commit (map);
+
+	return (pint) map->nsorted;
+}
+
+P_LIB_API void
+zflat_map_clear (PFlatMap *map)
+{
+	psize i;
+
+	if (P_UNLIKELY (map == NULL))
+		return;
+
+	if (map->key_destroy_func != NULL || map->value_destroy_func != NULL) {
+		for (i = 0; i < map->nentries; ++i)
+			pzflat_map_destroy_entry (map, &map->entries[i]);
+	}
+
+	map->nsorted  = 0;
+	map->nentries = 0;
+}
+
+P_LIB_API void
+zflat_map_free (PFlatMap *map)
+{
+	if (P_UNLIKELY (map == NULL))
+		return;
+
+	zflat_map_clear (map);
+
+	if (map->entries != NULL)
+		zfree (map->entries);
+
+	zfree (map);
+}
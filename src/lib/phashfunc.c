@@ -0,0 +1,89 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "phashfunc-private.h"
+
+#include <string.h>
+
+#define P_HASH_FUNC_M		0xC6A4A7935BD1E995ULL
+#define P_HASH_FUNC_R		47
+
+puint64
+zhash_func_bytes (pconstpointer	data,
+		  psize		len,
+		  puint64	seed)
+{
+	const puchar	*ptr = (const puchar *) data;
+	const puchar	*tail;
+	puint64		h, k;
+
+	h = seed ^ ((puint64) len * P_HASH_FUNC_M);
+
+	while (len >= 8) {
+		memcpy (&k, ptr, 8);
+		k = PUINT64_FROM_LE (k);
+
+		k *= P_HASH_FUNC_M;
+		k ^= k >> P_HASH_FUNC_R;
+		k *= P_HASH_FUNC_M;
+
+		h ^= k;
+		h *= P_HASH_FUNC_M;
+
+		ptr += 8;
+		len -= 8;
+	}
+
+	tail = ptr;
+
+	switch (len) {
+	case 7: h ^= (puint64) tail[6] << 48;	/* Fall through */
+	case 6: h ^= (puint64) tail[5] << 40;	/* Fall through */
+	case 5: h ^= (puint64) tail[4] << 32;	/* Fall through */
+	case 4: h ^= (puint64) tail[3] << 24;	/* Fall through */
+	case 3: h ^= (puint64) tail[2] << 16;	/* Fall through */
+	case 2: h ^= (puint64) tail[1] << 8;	/* Fall through */
+	case 1: h ^= (puint64) tail[0];
+		h *= P_HASH_FUNC_M;
+	}
+
+	h ^= h >> P_HASH_FUNC_R;
+	h *= P_HASH_FUNC_M;
+	h ^= h >> P_HASH_FUNC_R;
+
+	return h;
+}
+
+puint64
+zhash_func_mix64 (puint64 val)
+{
+	val ^= val >> 33;
+	val *= 0xFF51AFD7ED558CCDULL;
+	val ^= val >> 33;
+	val *= 0xC4CEB9FE1A85EC53ULL;
+	val ^= val >> 33;
+
+	return val;
+}
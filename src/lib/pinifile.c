@@ -23,57 +23,189 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+/* Parsed contents of the file are kept in an immutable view, which is
+ * published with a single atomic pointer store. Readers never block: a reader
+ * uses a view inside an epoch critical section (see pepoch.c), and a replaced
+ * view is retired and freed as soon as all the readers which could have seen
+ * it have left.
+ *
+ * Sections are reference counted, so a reload reuses the sections which body
+ * text has the same hash as in the previous view and parses only the changed
+ * ones.
+ *
+ * Integer, floating point and boolean conversions of a value are cached in its
+ * parameter after the first request. The first thread which claims the busy
+ * bit of a conversion stores the value and sets the ready bit after that,
+ * other threads either read the stored value or convert on their own until it
+ * is ready. */
+
 #include "perror.h"
 #include "pinifile.h"
 #include "plist.h"
 #include "pmem.h"
+#include "pmutex.h"
+#include "patomic.h"
 #include "pstring.h"
+#include "pepoch-private.h"
 #include "perror-private.h"
+#include "phashfunc-private.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
 
-#define	P_INI_FILE_MAX_LINE	1024
+#ifdef P_OS_UNIX
+#  include "psysclose-private.h"
+#  include <sys/types.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#endif
+
+#define	P_INI_FILE_MAX_LINE		1024
+#define P_INI_FILE_INDEX_MIN_SLOTS	8
+#define P_INI_FILE_INDEX_SEED		0x9E3779B97F4A7C15ULL
+#define P_INI_FILE_READ_CHUNK		65536
+#define P_INI_FILE_CACHE_INT		0x01
+#define P_INI_FILE_CACHE_DOUBLE		0x04
+#define P_INI_FILE_CACHE_BOOLEAN	0x10
+#define P_INI_FILE_CACHE_BUSY(flag)	((flag) << 1)
 
 typedef struct PIniParameter_ {
 	pchar		*name;
 	pchar		*value;
+	volatile pint	cache_state;
+	pint		int_value;
+	pboolean	boolean_value;
+	double		double_value;
 } PIniParameter;
 
+/* Open addressing hash table over the names of a list. Without slots (empty
+ * list or out of memory) the lookups fall back to a linear scan of the list. */
+typedef struct PIniIndexSlot_ {
+	const pchar	*name;
+	ppointer	data;
+	psize		name_len;
+	puint64		hash;
+} PIniIndexSlot;
+
+typedef struct PIniIndex_ {
+	PIniIndexSlot	*slots;
+	psize		nslots;
+} PIniIndex;
+
+/* In the mapped mode all the names and values of a section are stored one
+ * after another in the arena following the section structure. Every stored
+ * string is a distinct part of the section text followed by at least one
+ * delimiter (or the end of the file), so the arena never needs more than the
+ * text length plus two bytes. */
 typedef struct PIniSection_ {
 	pchar		*name;
 	PList		*keys;
+	PIniIndex	index;
+	pchar		*arena;
+	psize		arena_used;
+	puint64		hash;
+	volatile pint	ref_count;
 } PIniSection;
 
-struct PIniFile_ {
-	pchar		*path;
+typedef struct PIniView_ PIniView;
+
+struct PIniView_ {
+	PEpochEntry	epoch_entry;
 	PList		*sections;
-	pboolean	is_parsed;
+	PIniIndex	index;
+};
+
+struct PIniFile_ {
+	pchar			*path;
+	ppointer		view;
+	PEpochLimbo		limbo;
+	PMutex			*mutex;
+	PIniFileParseFlags	flags;
+	puint64			content_hash;
+	psize			size;
+	pint64			mtime;
 };
 
-static PIniParameter * pzini_file_parameter_new (const pchar *name, const pchar *val);
-static void pzini_file_parameter_free (PIniParameter *param);
-static PIniSection * pzini_file_section_new (const pchar *name);
+/* Published when the parsed view can't be allocated, so the file is still
+ * considered as parsed */
+static PIniView pz_ini_file_empty_view;
+
+static pchar * pzini_file_store_string (PIniSection *section, const pchar *str, psize len);
+static PIniParameter * pzini_file_parameter_new (PIniSection *section, const pchar *name, psize name_len, const pchar *val, psize val_len);
+static void pzini_file_parameter_free (PIniParameter *param, const PIniSection *section);
+static PIniSection * pzini_file_section_new (const pchar *name, psize name_len, psize arena_size);
 static void pzini_file_section_free (PIniSection *section);
+static void pzini_file_section_unref (PIniSection *section);
+static pboolean pzini_file_parse_value (const pchar *str, psize len, const pchar **val, psize *val_len);
+static PIniIndexSlot * pzini_file_index_find_slot (const PIniIndex *index, const pchar *name, psize name_len, puint64 hash);
+static void pzini_file_index_build (PIniIndex *index, PList *list, pboolean is_section);
+static PIniSection * pzini_file_find_section (const PIniView *view, const pchar *section, psize section_len);
+static PIniParameter * pzini_file_find_key (const PIniSection *section, const pchar *key);
+static PIniParameter * pzini_file_lookup (const PIniView *view, const pchar *section, const pchar *key);
 static pchar * pzini_file_find_parameter (const PIniFile *file, const pchar *section, const pchar *key);
+static pboolean pzini_file_cache_claim (PIniParameter *param, pint flag);
+static void pzini_file_cache_publish (PIniParameter *param, pint flag);
+static pint pzini_file_parameter_to_int (PIniParameter *param);
+static double pzini_file_parameter_to_double (PIniParameter *param);
+static pboolean pzini_file_parameter_to_boolean (PIniParameter *param);
+static pint pzini_file_bom_length (const puchar *data, psize len);
+static const pchar * pzini_file_next_line (const pchar **ptr, const pchar *end, psize max_line, psize *line_len);
+static pboolean pzini_file_parse_section_line (const pchar *line, psize line_len, const pchar **name, psize *name_len);
+static void pzini_file_parse_parameter_line (PIniSection *section, const pchar *line, psize line_len);
+static PIniSection * pzini_file_build_section (const PIniView *old_view, const pchar *name, psize name_len, const pchar *body, const pchar *body_end, psize max_line);
+static void pzini_file_view_add_section (PIniView *view, PIniSection *section, pboolean is_last);
+static PIniView * pzini_file_view_build (const PIniView *old_view, const pchar *data, psize size, psize max_line);
+static void pzini_file_view_free (PIniView *view);
+static void pzini_file_view_reclaim (PEpochEntry *entry, ppointer data);
+static PIniView * pzini_file_enter (PIniFile *file, PEpochRecord **record);
+static void pzini_file_leave (PIniFile *file, PEpochRecord *record);
+static pboolean pzini_file_get_mtime (const pchar *path, psize *size, pint64 *mtime);
+static pboolean pzini_file_load (const pchar *path, pchar **data, psize *size, pboolean *is_mapped, PError **error);
+static void pzini_file_unload (pchar *data, psize size, pboolean is_mapped);
+static pboolean pzini_file_update (PIniFile *file, pboolean *is_changed, PError **error);
+
+/* Copies a string either into the section arena or into a new heap block */
+static pchar *
+pzini_file_store_string (PIniSection	*section,
+			 const pchar	*str,
+			 psize		len)
+{
+	pchar *ret;
+
+	if (section->arena == NULL)
+		return zstrndup (str, len);
+
+	ret = section->arena + section->arena_used;
+
+	memcpy (ret, str, len);
+	ret[len] = '\0';
+
+	section->arena_used += len + 1;
+
+	return ret;
+}
 
 static PIniParameter *
-pzini_file_parameter_new (const pchar	*name,
-			   const pchar	*val)
+pzini_file_parameter_new (PIniSection	*section,
+			  const pchar	*name,
+			  psize		name_len,
+			  const pchar	*val,
+			  psize		val_len)
 {
 	PIniParameter *ret;
 
 	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PIniParameter))) == NULL))
 		return NULL;
 
-	if (P_UNLIKELY ((ret->name = zstrdup (name)) == NULL)) {
+	if (P_UNLIKELY ((ret->name = pzini_file_store_string (section, name, name_len)) == NULL)) {
 		zfree (ret);
 		return NULL;
 	}
 
-	if (P_UNLIKELY ((ret->value = zstrdup (val)) == NULL)) {
+	if (P_UNLIKELY ((ret->value = pzini_file_store_string (section, val, val_len)) == NULL)) {
 		zfree (ret->name);
 		zfree (ret);
 		return NULL;
@@ -83,58 +215,856 @@ pzini_file_parameter_new (const pchar	*name,
 }
 
 static void
-pzini_file_parameter_free (PIniParameter *param)
+pzini_file_parameter_free (PIniParameter	*param,
+			   const PIniSection	*section)
 {
-	zfree (param->name);
-	zfree (param->value);
+	if (section->arena == NULL) {
+		zfree (param->name);
+		zfree (param->value);
+	}
+
 	zfree (param);
 }
 
+/* Arena is allocated together with the section if requested */
 static PIniSection *
-pzini_file_section_new (const pchar *name)
+pzini_file_section_new (const pchar	*name,
+			psize		name_len,
+			psize		arena_size)
 {
 	PIniSection *ret;
 
-	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PIniSection))) == NULL))
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PIniSection) + arena_size)) == NULL))
 		return NULL;
 
-	if (P_UNLIKELY ((ret->name = zstrdup (name)) == NULL)) {
+	if (arena_size > 0)
+		ret->arena = (pchar *) (ret + 1);
+
+	if (P_UNLIKELY ((ret->name = pzini_file_store_string (ret, name, name_len)) == NULL)) {
 		zfree (ret);
 		return NULL;
 	}
 
+	ret->ref_count = 1;
+
 	return ret;
 }
 
 static void
 pzini_file_section_free (PIniSection *section)
 {
-	zlist_foreach (section->keys, (PFunc) pzini_file_parameter_free, NULL);
+	zlist_foreach (section->keys, (PFunc) pzini_file_parameter_free, section);
 	zlist_free (section->keys);
-	zfree (section->name);
+	zfree (section->index.slots);
+
+	if (section->arena == NULL)
+		zfree (section->name);
+
 	zfree (section);
 }
 
+static void
+pzini_file_section_unref (PIniSection *section)
+{
+	if (zatomic_int_dec_and_test (&section->ref_count) == TRUE)
+		pzini_file_section_free (section);
+}
+
+/* Parses the part of the line after '=', a value is either quoted with '"' or
+ * '\'' (the closing quote is optional), or runs up to a comment start */
+static pboolean
+pzini_file_parse_value (const pchar	*str,
+			psize		len,
+			const pchar	**val,
+			psize		*val_len)
+{
+	const pchar	*end;
+	const pchar	*ptr;
+	pchar		quote;
+
+	end = str + len;
+
+	while (str < end && isspace (* ((const puchar *) str)))
+		++str;
+
+	if (str == end)
+		return FALSE;
+
+	if ((*str == '"' || *str == '\'') && str + 1 < end && str[1] != *str) {
+		quote = *str++;
+
+		for (ptr = str; ptr < end && *ptr != quote; ++ptr)
+			;
+	} else {
+		for (ptr = str; ptr < end && *ptr != ';' && *ptr != '#'; ++ptr)
+			;
+
+		if (ptr == str)
+			return FALSE;
+	}
+
+	*val = zstrchomp_span (str, (psize) (ptr - str), val_len);
+
+	/* Empty quoted value without a content */
+	if (*val_len == 2 && ((*val)[0] == '"' || (*val)[0] == '\'') && (*val)[1] == (*val)[0])
+		*val_len = 0;
+
+	return TRUE;
+}
+
+/* Returns either the slot with the given name or an empty slot where it
+ * should be placed */
+static PIniIndexSlot *
+pzini_file_index_find_slot (const PIniIndex	*index,
+			    const pchar		*name,
+			    psize		name_len,
+			    puint64		hash)
+{
+	PIniIndexSlot	*slot;
+	psize		mask;
+	psize		pos;
+
+	mask = index->nslots - 1;
+	pos  = (psize) hash & mask;
+
+	while (TRUE) {
+		slot = &index->slots[pos];
+
+		if (slot->name == NULL)
+			return slot;
+
+		if (slot->hash == hash && slot->name_len == name_len && memcmp (slot->name, name, name_len) == 0)
+			return slot;
+
+		pos = (pos + 1) & mask;
+	}
+}
+
+/* Indexes either sections or parameters of the list by names, the first item
+ * wins for the duplicated names as it was with the linear lookup */
+static void
+pzini_file_index_build (PIniIndex	*index,
+			PList		*list,
+			pboolean	is_section)
+{
+	PIniIndexSlot	*slot;
+	PList		*item;
+	const pchar	*name;
+	psize		name_len;
+	psize		count;
+	puint64		hash;
+
+	zfree (index->slots);
+
+	index->slots  = NULL;
+	index->nslots = 0;
+
+	if ((count = zlist_length (list)) == 0)
+		return;
+
+	/* Load factor never exceeds 1/2, so the probe sequences stay short */
+	for (index->nslots = P_INI_FILE_INDEX_MIN_SLOTS; index->nslots < count * 2; index->nslots <<= 1)
+		;
+
+	if (P_UNLIKELY ((index->slots = zmalloc0 (index->nslots * sizeof (PIniIndexSlot))) == NULL)) {
+		P_ERROR ("PIniFile::pzini_file_index_build: failed to allocate memory");
+		index->nslots = 0;
+		return;
+	}
+
+	for (item = list; item != NULL; item = item->next) {
+		name     = is_section ? ((PIniSection *) item->data)->name : ((PIniParameter *) item->data)->name;
+		name_len = strlen (name);
+		hash     = zhash_func_bytes (name, name_len, P_INI_FILE_INDEX_SEED);
+		slot     = pzini_file_index_find_slot (index, name, name_len, hash);
+
+		if (slot->name != NULL)
+			continue;
+
+		slot->name     = name;
+		slot->data     = item->data;
+		slot->name_len = name_len;
+		slot->hash     = hash;
+	}
+}
+
+static PIniSection *
+pzini_file_find_section (const PIniView	*view,
+			 const pchar	*section,
+			 psize		section_len)
+{
+	PIniSection	*sect;
+	PList		*item;
+
+	if (P_LIKELY (view->index.slots != NULL))
+		return (PIniSection *) pzini_file_index_find_slot (&view->index,
+								   section,
+								   section_len,
+								   zhash_func_bytes (section,
+										     section_len,
+										     P_INI_FILE_INDEX_SEED))->data;
+
+	for (item = view->sections; item != NULL; item = item->next) {
+		sect = (PIniSection *) item->data;
+
+		if (strncmp (sect->name, section, section_len) == 0 && sect->name[section_len] == '\0')
+			return sect;
+	}
+
+	return NULL;
+}
+
+static PIniParameter *
+pzini_file_find_key (const PIniSection	*section,
+		     const pchar	*key)
+{
+	PList	*item;
+	psize	key_len;
+
+	if (P_LIKELY (section->index.slots != NULL)) {
+		key_len = strlen (key);
+
+		return (PIniParameter *) pzini_file_index_find_slot (&section->index,
+								     key,
+								     key_len,
+								     zhash_func_bytes (key,
+										       key_len,
+										       P_INI_FILE_INDEX_SEED))->data;
+	}
+
+	for (item = section->keys; item != NULL; item = item->next)
+		if (strcmp (((PIniParameter *) item->data)->name, key) == 0)
+			return (PIniParameter *) item->data;
+
+	return NULL;
+}
+
+static PIniParameter *
+pzini_file_lookup (const PIniView	*view,
+		   const pchar		*section,
+		   const pchar		*key)
+{
+	PIniSection *sect;
+
+	if (view == NULL || section == NULL || key == NULL)
+		return NULL;
+
+	if ((sect = pzini_file_find_section (view, section, strlen (section))) == NULL)
+		return NULL;
+
+	return pzini_file_find_key (sect, key);
+}
+
 static pchar *
 pzini_file_find_parameter (const PIniFile *file, const pchar *section, const pchar *key)
 {
-	PList	*item;
+	PEpochRecord	*record;
+	PIniParameter	*param;
+	pchar		*ret;
 
-	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE || section == NULL || key == NULL))
+	if (P_UNLIKELY (file == NULL))
 		return NULL;
 
-	for (item = file->sections; item != NULL; item = item->next)
-		if (strcmp (((PIniSection *) item->data)->name, section) == 0)
-			break;
+	ret = NULL;
+
+	if ((param = pzini_file_lookup (pzini_file_enter ((PIniFile *) file, &record), section, key)) != NULL)
+		ret = zstrdup (param->value);
+
+	pzini_file_leave ((PIniFile *) file, record);
+
+	return ret;
+}
+
+/* Returns TRUE if the caller should store the converted value */
+static pboolean
+pzini_file_cache_claim (PIniParameter	*param,
+			pint		flag)
+{
+	pint state;
+
+	do {
+		state = zatomic_int_get (&param->cache_state);
+
+		if ((state & P_INI_FILE_CACHE_BUSY (flag)) != 0)
+			return FALSE;
+	} while (zatomic_int_compare_and_exchange (&param->cache_state,
+						   state,
+						   state | P_INI_FILE_CACHE_BUSY (flag)) == FALSE);
 
-	if (item == NULL)
+	return TRUE;
+}
+
+static void
+pzini_file_cache_publish (PIniParameter	*param,
+			  pint		flag)
+{
+	pint state;
+
+	do {
+		state = zatomic_int_get (&param->cache_state);
+	} while (zatomic_int_compare_and_exchange (&param->cache_state, state, state | flag) == FALSE);
+}
+
+static pint
+pzini_file_parameter_to_int (PIniParameter *param)
+{
+	pint ret;
+
+	if ((zatomic_int_get (&param->cache_state) & P_INI_FILE_CACHE_INT) != 0)
+		return param->int_value;
+
+	ret = atoi (param->value);
+
+	if (pzini_file_cache_claim (param, P_INI_FILE_CACHE_INT) == TRUE) {
+		param->int_value = ret;
+		pzini_file_cache_publish (param, P_INI_FILE_CACHE_INT);
+	}
+
+	return ret;
+}
+
+static double
+pzini_file_parameter_to_double (PIniParameter *param)
+{
+	double ret;
+
+	if ((zatomic_int_get (&param->cache_state) & P_INI_FILE_CACHE_DOUBLE) != 0)
+		return param->double_value;
+
+	ret = zstrtod (param->value);
+
+	if (pzini_file_cache_claim (param, P_INI_FILE_CACHE_DOUBLE) == TRUE) {
+		param->double_value = ret;
+		pzini_file_cache_publish (param, P_INI_FILE_CACHE_DOUBLE);
+	}
+
+	return ret;
+}
+
+static pboolean
+pzini_file_parameter_to_boolean (PIniParameter *param)
+{
+	const pchar	*val;
+	pboolean	ret;
+
+	if ((zatomic_int_get (&param->cache_state) & P_INI_FILE_CACHE_BOOLEAN) != 0)
+		return param->boolean_value;
+
+	val = param->value;
+
+	if (strcmp (val, "true") == 0 || strcmp (val, "TRUE") == 0)
+		ret = TRUE;
+	else if (strcmp (val, "false") == 0 || strcmp (val, "FALSE") == 0)
+		ret = FALSE;
+	else if (atoi (val) > 0)
+		ret = TRUE;
+	else
+		ret = FALSE;
+
+	if (pzini_file_cache_claim (param, P_INI_FILE_CACHE_BOOLEAN) == TRUE) {
+		param->boolean_value = ret;
+		pzini_file_cache_publish (param, P_INI_FILE_CACHE_BOOLEAN);
+	}
+
+	return ret;
+}
+
+/* UTF-8, UTF-16 and UTF-32 BOM detection */
+static pint
+pzini_file_bom_length (const puchar	*data,
+		       psize		len)
+{
+	if (len >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF)
+		return 3;
+	else if (len >= 4 && data[0] == 0x00 && data[1] == 0x00 && data[2] == 0xFE && data[3] == 0xFF)
+		return 4;
+	else if (len >= 4 && data[0] == 0xFF && data[1] == 0xFE && data[2] == 0x00 && data[3] == 0x00)
+		return 4;
+	else if (len >= 2 && ((data[0] == 0xFE && data[1] == 0xFF) || (data[0] == 0xFF && data[1] == 0xFE)))
+		return 2;
+	else
+		return 0;
+}
+
+/* Returns the next line of the buffer. With a line limit lines are split the
+ * same way as fgets() does with a buffer of that size, cut at a zero byte and
+ * checked for a BOM each, as it was done when reading with the stdio. */
+static const pchar *
+pzini_file_next_line (const pchar	**ptr,
+		      const pchar	*end,
+		      psize		max_line,
+		      psize		*line_len)
+{
+	const pchar	*line;
+	const pchar	*eol;
+	psize		avail;
+	pint		bom_shift;
+
+	if ((line = *ptr) >= end)
 		return NULL;
 
-	for (item = ((PIniSection *) item->data)->keys; item != NULL; item = item->next)
-		if (strcmp (((PIniParameter *) item->data)->name, key) == 0)
-			return zstrdup (((PIniParameter *) item->data)->value);
+	avail = (psize) (end - line);
 
-	return NULL;
+	if (max_line > 0 && avail > max_line)
+		avail = max_line;
+
+	if ((eol = memchr (line, '\n', avail)) != NULL) {
+		*line_len = (psize) (eol - line);
+		*ptr      = eol + 1;
+	} else {
+		*line_len = avail;
+		*ptr      = line + avail;
+	}
+
+	if (max_line > 0) {
+		if ((eol = memchr (line, '\0', *line_len)) != NULL)
+			*line_len = (psize) (eol - line);
+
+		bom_shift  = pzini_file_bom_length ((const puchar *) line, *line_len);
+		line      += bom_shift;
+		*line_len -= (psize) bom_shift;
+	}
+
+	return line;
+}
+
+static pboolean
+pzini_file_parse_section_line (const pchar	*line,
+			       psize		line_len,
+			       const pchar	**name,
+			       psize		*name_len)
+{
+	const pchar *ptr;
+
+	line = zstrchomp_span (line, line_len, &line_len);
+
+	if (!(line_len > 2 && line[0] == '[' && line[line_len - 1] == ']' && line[1] != ']'))
+		return FALSE;
+
+	for (ptr = line + 1; *ptr != ']'; ++ptr)
+		;
+
+	*name = zstrchomp_span (line + 1, (psize) (ptr - line - 1), name_len);
+
+	return TRUE;
+}
+
+/* All the parsing is done on spans inside the line */
+static void
+pzini_file_parse_parameter_line (PIniSection	*section,
+				 const pchar	*line,
+				 psize		line_len)
+{
+	PIniParameter	*param;
+	const pchar	*key, *value, *ptr;
+	psize		key_len, value_len;
+
+	line = zstrchomp_span (line, line_len, &line_len);
+
+	if (line_len == 0 || line[0] == '=' || (ptr = memchr (line, '=', line_len)) == NULL)
+		return;
+
+	if (pzini_file_parse_value (ptr + 1, line_len - (psize) (ptr - line) - 1, &value, &value_len) == FALSE)
+		return;
+
+	key = zstrchomp_span (line, (psize) (ptr - line), &key_len);
+
+	if ((param = pzini_file_parameter_new (section, key, key_len, value, value_len)) != NULL)
+		section->keys = zlist_prepend (section->keys, param);
+}
+
+/* Takes the section from the previous view if its body is the same, parses
+ * the body otherwise */
+static PIniSection *
+pzini_file_build_section (const PIniView	*old_view,
+			  const pchar		*name,
+			  psize			name_len,
+			  const pchar		*body,
+			  const pchar		*body_end,
+			  psize			max_line)
+{
+	PIniSection	*section;
+	const pchar	*line;
+	psize		line_len;
+	puint64		hash;
+
+	hash = zhash_func_bytes (body, (psize) (body_end - body), P_INI_FILE_INDEX_SEED);
+
+	if (old_view != NULL &&
+	    (section = pzini_file_find_section (old_view, name, name_len)) != NULL &&
+	    section->hash == hash) {
+		zatomic_int_inc (&section->ref_count);
+		return section;
+	}
+
+	if (P_UNLIKELY ((section = pzini_file_section_new (name,
+							   name_len,
+							   max_line > 0 ? 0 : name_len + (psize) (body_end - body) + 2)) == NULL))
+		return NULL;
+
+	section->hash = hash;
+
+	while ((line = pzini_file_next_line (&body, body_end, max_line, &line_len)) != NULL)
+		pzini_file_parse_parameter_line (section, line, line_len);
+
+	pzini_file_index_build (&section->index, section->keys, FALSE);
+
+	return section;
+}
+
+/* Empty sections are dropped. All the sections except the last one are
+ * prepended, and the lookups depend on that order for the duplicated names. */
+static void
+pzini_file_view_add_section (PIniView		*view,
+			     PIniSection	*section,
+			     pboolean		is_last)
+{
+	if (section == NULL)
+		return;
+
+	if (section->keys == NULL)
+		pzini_file_section_unref (section);
+	else if (is_last)
+		view->sections = zlist_append (view->sections, section);
+	else
+		view->sections = zlist_prepend (view->sections, section);
+}
+
+/* Line limit is used for the stdio compatible parsing, 0 means no limit */
+static PIniView *
+pzini_file_view_build (const PIniView	*old_view,
+		       const pchar	*data,
+		       psize		size,
+		       psize		max_line)
+{
+	PIniView	*view;
+	PIniSection	*section;
+	const pchar	*ptr, *end, *next, *prev, *line, *name;
+	psize		line_len, name_len;
+	pboolean	is_found;
+
+	if (P_UNLIKELY ((view = zmalloc0 (sizeof (PIniView))) == NULL))
+		return NULL;
+
+	section = NULL;
+	ptr     = data;
+	end     = data + size;
+
+	if (max_line == 0 && size > 0)
+		ptr += pzini_file_bom_length ((const puchar *) data, size);
+
+	while ((line = pzini_file_next_line (&ptr, end, max_line, &line_len)) != NULL) {
+		/* Parameters outside of sections are skipped */
+		if (pzini_file_parse_section_line (line, line_len, &name, &name_len) == FALSE)
+			continue;
+
+		/* Section body lasts up to the next section line */
+		next     = ptr;
+		prev     = ptr;
+		is_found = FALSE;
+
+		while (is_found == FALSE && (line = pzini_file_next_line (&next, end, max_line, &line_len)) != NULL) {
+			if (pzini_file_parse_section_line (line, line_len, &line, &line_len) == TRUE)
+				is_found = TRUE;
+			else
+				prev = next;
+		}
+
+		pzini_file_view_add_section (view, section, FALSE);
+
+		section = pzini_file_build_section (old_view, name, name_len, ptr, prev, max_line);
+		ptr     = prev;
+	}
+
+	pzini_file_view_add_section (view, section, TRUE);
+
+	pzini_file_index_build (&view->index, view->sections, TRUE);
+
+	return view;
+}
+
+static void
+pzini_file_view_free (PIniView *view)
+{
+	if (view == &pz_ini_file_empty_view)
+		return;
+
+	zlist_foreach (view->sections, (PFunc) pzini_file_section_unref, NULL);
+	zlist_free (view->sections);
+	zfree (view->index.slots);
+	zfree (view);
+}
+
+static void
+pzini_file_view_reclaim (PEpochEntry	*entry,
+			 ppointer	data)
+{
+	P_UNUSED (data);
+
+	pzini_file_view_free ((PIniView *) entry);
+}
+
+/* Returns the current view, which stays valid until pzini_file_leave() */
+static PIniView *
+pzini_file_enter (PIniFile	*file,
+		  PEpochRecord	**record)
+{
+	*record = zepoch_enter ();
+
+	return (PIniView *) zatomic_pointer_get (&file->view);
+}
+
+static void
+pzini_file_leave (PIniFile	*file,
+		  PEpochRecord	*record)
+{
+	zepoch_leave (record);
+	zepoch_reclaim (&file->limbo);
+}
+
+/* Modification time in nanoseconds, FALSE if it can't be checked */
+static pboolean
+pzini_file_get_mtime (const pchar	*path,
+		      psize		*size,
+		      pint64		*mtime)
+{
+#ifdef P_OS_UNIX
+	struct stat sb;
+
+	if (stat (path, &sb) != 0)
+		return FALSE;
+
+	*size  = (psize) sb.st_size;
+#  if defined (P_OS_LINUX)
+	*mtime = (pint64) sb.st_mtim.tv_sec * 1000000000 + (pint64) sb.st_mtim.tv_nsec;
+#  else
+	*mtime = (pint64) sb.st_mtime * 1000000000;
+#  endif
+
+	return TRUE;
+#else
+	P_UNUSED (path);
+	P_UNUSED (size);
+	P_UNUSED (mtime);
+
+	return FALSE;
+#endif
+}
+
+/* Maps the whole file into memory, or reads it where mapping is not
+ * supported. Empty files are not mapped at all. */
+static pboolean
+pzini_file_load (const pchar	*path,
+		 pchar		**data,
+		 psize		*size,
+		 pboolean	*is_mapped,
+		 PError		**error)
+{
+#ifdef P_OS_UNIX
+	struct stat	sb;
+	pint		fd;
+
+	*data      = NULL;
+	*size      = 0;
+	*is_mapped = FALSE;
+
+	if (P_UNLIKELY ((fd = open (path, O_RDONLY)) == -1)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to open file for reading");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (fstat (fd, &sb) != 0)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to get file status");
+		zsys_close (fd);
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (sb.st_size < 0 || (puint64) sb.st_size >= (puint64) P_MAXSIZE)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "File is too large to be mapped");
+		zsys_close (fd);
+		return FALSE;
+	}
+
+	if (sb.st_size > 0) {
+		if (P_UNLIKELY ((*data = mmap (NULL,
+					      (size_t) sb.st_size,
+					      PROT_READ,
+					      MAP_PRIVATE,
+					      fd,
+					      0)) == (void *) -1)) {
+			zerror_set_error_p (error,
+					     (pint) zerror_get_last_io (),
+					     zerror_get_last_system (),
+					     "Failed to call mmap() to map file");
+			*data = NULL;
+			zsys_close (fd);
+			return FALSE;
+		}
+
+#  ifdef MADV_SEQUENTIAL
+		madvise (*data, (size_t) sb.st_size, MADV_SEQUENTIAL);
+#  endif
+
+		*size      = (psize) sb.st_size;
+		*is_mapped = TRUE;
+	}
+
+	if (P_UNLIKELY (zsys_close (fd) != 0))
+		P_WARNING ("PIniFile::pzini_file_load: failed to close file descriptor");
+
+	return TRUE;
+#else
+	FILE	*in_file;
+	pchar	*new_data;
+	psize	capacity;
+	psize	n_read;
+
+	*data      = NULL;
+	*size      = 0;
+	*is_mapped = FALSE;
+
+	if (P_UNLIKELY ((in_file = fopen (path, "rb")) == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to open file for reading");
+		return FALSE;
+	}
+
+	capacity = 0;
+
+	do {
+		if (*size == capacity) {
+			capacity += P_INI_FILE_READ_CHUNK;
+
+			if (P_UNLIKELY ((new_data = zrealloc (*data, capacity)) == NULL)) {
+				zerror_set_error_p (error,
+						     (pint) P_ERROR_IO_NO_RESOURCES,
+						     0,
+						     "Failed to allocate memory for file contents");
+				zfree (*data);
+				*data = NULL;
+				fclose (in_file);
+				return FALSE;
+			}
+
+			*data = new_data;
+		}
+
+		n_read = fread (*data + *size, 1, capacity - *size, in_file);
+		*size += n_read;
+	} while (n_read > 0);
+
+	if (P_UNLIKELY (ferror (in_file) != 0)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to read file");
+		zfree (*data);
+		*data = NULL;
+		fclose (in_file);
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (fclose (in_file) != 0))
+		P_WARNING ("PIniFile::pzini_file_load: fclose() failed");
+
+	return TRUE;
+#endif
+}
+
+static void
+pzini_file_unload (pchar	*data,
+		   psize	size,
+		   pboolean	is_mapped)
+{
+#ifdef P_OS_UNIX
+	if (is_mapped) {
+		if (P_UNLIKELY (munmap (data, size) != 0))
+			P_WARNING ("PIniFile::pzini_file_unload: munmap() failed");
+
+		return;
+	}
+#else
+	P_UNUSED (is_mapped);
+#endif
+
+	P_UNUSED (size);
+	zfree (data);
+}
+
+/* Called with the mutex locked. Unchanged file (by the modification time and
+ * the size, or by the contents hash) keeps the current view. */
+static pboolean
+pzini_file_update (PIniFile	*file,
+		   pboolean	*is_changed,
+		   PError	**error)
+{
+	PEpochRecord	*record;
+	PIniView	*old_view;
+	PIniView	*new_view;
+	pchar		*data;
+	psize		size;
+	psize		stat_size;
+	pint64		mtime;
+	puint64		hash;
+	pboolean	is_mapped;
+	pboolean	has_mtime;
+
+	old_view  = (PIniView *) zatomic_pointer_get (&file->view);
+	has_mtime = pzini_file_get_mtime (file->path, &stat_size, &mtime);
+
+	if (old_view != NULL && has_mtime == TRUE && mtime == file->mtime && stat_size == file->size)
+		return TRUE;
+
+	if (P_UNLIKELY (pzini_file_load (file->path, &data, &size, &is_mapped, error) == FALSE))
+		return FALSE;
+
+	hash = zhash_func_bytes (data, size, P_INI_FILE_INDEX_SEED);
+
+	file->mtime = has_mtime ? mtime : 0;
+
+	if (old_view != NULL && hash == file->content_hash && size == file->size) {
+		pzini_file_unload (data, size, is_mapped);
+		return TRUE;
+	}
+
+	/* Old view must stay alive while its sections are being reused */
+	old_view = pzini_file_enter (file, &record);
+
+	new_view = pzini_file_view_build (old_view,
+					  data,
+					  size,
+					  (file->flags & P_INI_FILE_PARSE_FLAG_MAPPED) ? 0 : P_INI_FILE_MAX_LINE);
+
+	if (P_UNLIKELY (new_view == NULL))
+		new_view = &pz_ini_file_empty_view;
+
+	zatomic_pointer_set (&file->view, new_view);
+
+	if (old_view != NULL && old_view != &pz_ini_file_empty_view)
+		zepoch_retire (&file->limbo, &old_view->epoch_entry);
+
+	pzini_file_leave (file, record);
+
+	pzini_file_unload (data, size, is_mapped);
+
+	file->content_hash = hash;
+	file->size         = size;
+
+	if (is_changed != NULL)
+		*is_changed = TRUE;
+
+	return TRUE;
 }
 
 P_LIB_API PIniFile *
@@ -153,7 +1083,14 @@ zini_file_new (const pchar *path)
 		return NULL;
 	}
 
-	ret->is_parsed = FALSE;
+	if (P_UNLIKELY ((ret->mutex = zmutex_new ()) == NULL)) {
+		zfree (ret->path);
+		zfree (ret);
+		return NULL;
+	}
+
+	/* Views are large and rarely replaced, free them as soon as possible */
+	zepoch_limbo_init (&ret->limbo, 1, pzini_file_view_reclaim, NULL);
 
 	return ret;
 }
@@ -164,8 +1101,12 @@ zini_file_free (PIniFile *file)
 	if (P_UNLIKELY (file == NULL))
 		return;
 
-	zlist_foreach (file->sections, (PFunc) pzini_file_section_free, NULL);
-	zlist_free (file->sections);
+	if (file->view != NULL)
+		pzini_file_view_free ((PIniView *) file->view);
+
+	zepoch_limbo_flush (&file->limbo);
+
+	zmutex_free (file->mutex);
 	zfree (file->path);
 	zfree (file);
 }
@@ -174,14 +1115,15 @@ P_LIB_API pboolean
 zini_file_parse (PIniFile	*file,
 		  PError	**error)
 {
-	PIniSection	*section;
-	PIniParameter	*param;
-	FILE		*in_file;
-	pchar		*dst_line, *tmzstr;
-	pchar		src_line[P_INI_FILE_MAX_LINE + 1],
-			key[P_INI_FILE_MAX_LINE + 1],
-			value[P_INI_FILE_MAX_LINE + 1];
-	pint		bom_shift;
+	return zini_file_parse_with_flags (file, P_INI_FILE_PARSE_FLAG_NONE, error);
+}
+
+P_LIB_API pboolean
+zini_file_parse_with_flags (PIniFile		*file,
+			     PIniFileParseFlags	flags,
+			     PError		**error)
+{
+	pboolean result;
 
 	if (P_UNLIKELY (file == NULL)) {
 		zerror_set_error_p (error,
@@ -191,114 +1133,45 @@ zini_file_parse (PIniFile	*file,
 		return FALSE;
 	}
 
-	if (file->is_parsed)
+	if (zatomic_pointer_get (&file->view) != NULL)
 		return TRUE;
 
-	if (P_UNLIKELY ((in_file = fopen (file->path, "r")) == NULL)) {
-		zerror_set_error_p (error,
-				     (pint) zerror_get_last_io (),
-				     zerror_get_last_system (),
-				     "Failed to open file for reading");
-		return FALSE;
-	}
-
-	dst_line = NULL;
-	section  = NULL;
-	param    = NULL;
+	zmutex_lock (file->mutex);
 
-	memset (src_line, 0, sizeof (src_line));
+	if (zatomic_pointer_get (&file->view) == NULL) {
+		file->flags = flags;
+		result      = pzini_file_update (file, NULL, error);
+	} else
+		result = TRUE;
 
-	while (fgets (src_line, sizeof (src_line), in_file) != NULL) {
-		/* UTF-8, UTF-16 and UTF-32 BOM detection */
-		if ((puchar) src_line[0] == 0xEF && (puchar) src_line[1] == 0xBB && (puchar) src_line[2] == 0xBF)
-			bom_shift = 3;
-		else if (((puchar) src_line[0] == 0xFE && (puchar) src_line[1] == 0xFF) ||
-			 ((puchar) src_line[0] == 0xFF && (puchar) src_line[1] == 0xFE))
-			bom_shift = 2;
-		else if ((puchar) src_line[0] == 0x00 && (puchar) src_line[1] == 0x00 &&
-			 (puchar) src_line[2] == 0xFE && (puchar) src_line[3] == 0xFF)
-			bom_shift = 4;
-		else if ((puchar) src_line[0] == 0xFF && (puchar) src_line[1] == 0xFE &&
-			 (puchar) src_line[2] == 0x00 && (puchar) src_line[3] == 0x00)
-			bom_shift = 4;
-		else
-			bom_shift = 0;
+	zmutex_unlock (file->mutex);
 
-		dst_line = zstrchomp (src_line + bom_shift);
-
-		if (dst_line == NULL)
-			continue;
+	return result;
+}
 
-		/* This should not happen */
-		if (P_UNLIKELY (strlen (dst_line) > P_INI_FILE_MAX_LINE))
-			dst_line[P_INI_FILE_MAX_LINE] = '\0';
-
-		if (dst_line[0] == '[' && dst_line[strlen (dst_line) - 1] == ']' &&
-		    sscanf (dst_line, "[%[^]]", key) == 1) {
-			/* New section found */
-			if ((tmzstr = zstrchomp (key)) != NULL) {
-				/* This should not happen */
-				if (P_UNLIKELY (strlen (tmzstr) > P_INI_FILE_MAX_LINE))
-					tmzstr[P_INI_FILE_MAX_LINE] = '\0';
-
-				strcpy (key, tmzstr);
-				zfree (tmzstr);
-
-				if (section != NULL) {
-					if (section->keys == NULL)
-						pzini_file_section_free (section);
-					else
-						file->sections = zlist_prepend (file->sections, section);
-				}
-
-				section = pzini_file_section_new (key);
-			}
-		} else if (sscanf (dst_line, "%[^=] = \"%[^\"]\"", key, value) == 2 ||
-			   sscanf (dst_line, "%[^=] = '%[^\']'", key, value) == 2 ||
-			   sscanf (dst_line, "%[^=] = %[^;#]", key, value) == 2) {
-			/* New parameter found */
-			if ((tmzstr = zstrchomp (key)) != NULL) {
-				/* This should not happen */
-				if (P_UNLIKELY (strlen (tmzstr) > P_INI_FILE_MAX_LINE))
-					tmzstr[P_INI_FILE_MAX_LINE] = '\0';
-
-				strcpy (key, tmzstr);
-				zfree (tmzstr);
-
-				if ((tmzstr = zstrchomp (value)) != NULL) {
-					/* This should not happen */
-					if (P_UNLIKELY (strlen (tmzstr) > P_INI_FILE_MAX_LINE))
-						tmzstr[P_INI_FILE_MAX_LINE] = '\0';
-
-					strcpy (value, tmzstr);
-					zfree (tmzstr);
-
-					if (strcmp (value, "\"\"") == 0 || (strcmp (value, "''") == 0))
-						value[0] = '\0';
-
-					if (section != NULL && (param = pzini_file_parameter_new (key, value)) != NULL)
-						section->keys = zlist_prepend (section->keys, param);
-				}
-			}
-		}
+P_LIB_API pboolean
+zini_file_reload (PIniFile	*file,
+		   pboolean	*is_changed,
+		   PError	**error)
+{
+	pboolean result;
 
-		zfree (dst_line);
-		memset (src_line, 0, sizeof (src_line));
-	}
+	if (is_changed != NULL)
+		*is_changed = FALSE;
 
-	if (section != NULL) {
-		if (section->keys == NULL)
-			pzini_file_section_free (section);
-		else
-			file->sections = zlist_append (file->sections, section);
+	if (P_UNLIKELY (file == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
 	}
 
-	if (P_UNLIKELY (fclose (in_file) != 0))
-		P_WARNING ("PIniFile::zini_file_parse: fclose() failed");
-
-	file->is_parsed = TRUE;
+	zmutex_lock (file->mutex);
+	result = pzini_file_update (file, is_changed, error);
+	zmutex_unlock (file->mutex);
 
-	return TRUE;
+	return result;
 }
 
 P_LIB_API pboolean
@@ -307,22 +1180,28 @@ zini_file_is_parsed (const PIniFile *file)
 	if (P_UNLIKELY (file == NULL))
 		return FALSE;
 
-	return file->is_parsed;
+	return zatomic_pointer_get (&file->view) != NULL;
 }
 
 P_LIB_API PList *
 zini_file_sections (const PIniFile *file)
 {
-	PList	*ret;
-	PList	*sec;
+	PEpochRecord	*record;
+	PIniView	*view;
+	PList		*ret;
+	PList		*sec;
 
-	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE))
+	if (P_UNLIKELY (file == NULL))
 		return NULL;
 
 	ret = NULL;
 
-	for (sec = file->sections; sec != NULL; sec = sec->next)
-		ret = zlist_prepend (ret, zstrdup (((PIniSection *) sec->data)->name));
+	if ((view = pzini_file_enter ((PIniFile *) file, &record)) != NULL) {
+		for (sec = view->sections; sec != NULL; sec = sec->next)
+			ret = zlist_prepend (ret, zstrdup (((PIniSection *) sec->data)->name));
+	}
+
+	pzini_file_leave ((PIniFile *) file, record);
 
 	return ret;
 }
@@ -331,23 +1210,24 @@ P_LIB_API PList *
 zini_file_keys (const PIniFile	*file,
 		 const pchar	*section)
 {
-	PList	*ret;
-	PList	*item;
+	PEpochRecord	*record;
+	PIniView	*view;
+	PIniSection	*sect;
+	PList		*ret;
+	PList		*item;
 
-	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE || section == NULL))
+	if (P_UNLIKELY (file == NULL || section == NULL))
 		return NULL;
 
 	ret = NULL;
 
-	for (item = file->sections; item != NULL; item = item->next)
-		if (strcmp (((PIniSection *) item->data)->name, section) == 0)
-			break;
-
-	if (item == NULL)
-		return NULL;
+	if ((view = pzini_file_enter ((PIniFile *) file, &record)) != NULL &&
+	    (sect = pzini_file_find_section (view, section, strlen (section))) != NULL) {
+		for (item = sect->keys; item != NULL; item = item->next)
+			ret = zlist_prepend (ret, zstrdup (((PIniParameter *) item->data)->name));
+	}
 
-	for (item = ((PIniSection *) item->data)->keys; item != NULL; item = item->next)
-		ret = zlist_prepend (ret, zstrdup (((PIniParameter *) item->data)->name));
+	pzini_file_leave ((PIniFile *) file, record);
 
 	return ret;
 }
@@ -357,23 +1237,23 @@ zini_file_is_key_exists (const PIniFile	*file,
 			  const pchar		*section,
 			  const pchar		*key)
 {
-	PList	*item;
+	PEpochRecord	*record;
+	PIniView	*view;
+	PIniSection	*sect;
+	pboolean	ret;
 
-	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE || section == NULL || key == NULL))
+	if (P_UNLIKELY (file == NULL || section == NULL || key == NULL))
 		return FALSE;
 
-	for (item = file->sections; item != NULL; item = item->next)
-		if (strcmp (((PIniSection *) item->data)->name, section) == 0)
-			break;
+	ret = FALSE;
 
-	if (item == NULL)
-		return FALSE;
+	if ((view = pzini_file_enter ((PIniFile *) file, &record)) != NULL &&
+	    (sect = pzini_file_find_section (view, section, strlen (section))) != NULL)
+		ret = pzini_file_find_key (sect, key) != NULL;
 
-	for (item = ((PIniSection *) item->data)->keys; item != NULL; item = item->next)
-		if (strcmp (((PIniParameter *) item->data)->name, key) == 0)
-			return TRUE;
+	pzini_file_leave ((PIniFile *) file, record);
 
-	return FALSE;
+	return ret;
 }
 
 P_LIB_API pchar *
@@ -390,20 +1270,48 @@ zini_file_parameter_string (const PIniFile	*file,
 	return val;
 }
 
+P_LIB_API const pchar *
+zini_file_parameter_string_view (const PIniFile	*file,
+				  const pchar		*section,
+				  const pchar		*key,
+				  const pchar		*default_val)
+{
+	PEpochRecord	*record;
+	PIniParameter	*param;
+	const pchar	*ret;
+
+	if (P_UNLIKELY (file == NULL))
+		return default_val;
+
+	ret = default_val;
+
+	if ((param = pzini_file_lookup (pzini_file_enter ((PIniFile *) file, &record), section, key)) != NULL)
+		ret = param->value;
+
+	pzini_file_leave ((PIniFile *) file, record);
+
+	return ret;
+}
+
 P_LIB_API pint
 zini_file_parameter_int (const PIniFile	*file,
 			  const pchar		*section,
 			  const pchar		*key,
 			  pint			default_val)
 {
-	pchar	*val;
-	pint	ret;
+	PEpochRecord	*record;
+	PIniParameter	*param;
+	pint		ret;
 
-	if ((val = pzini_file_find_parameter (file, section, key)) == NULL)
+	if (P_UNLIKELY (file == NULL))
 		return default_val;
 
-	ret = atoi (val);
-	zfree (val);
+	ret = default_val;
+
+	if ((param = pzini_file_lookup (pzini_file_enter ((PIniFile *) file, &record), section, key)) != NULL)
+		ret = pzini_file_parameter_to_int (param);
+
+	pzini_file_leave ((PIniFile *) file, record);
 
 	return ret;
 }
@@ -414,14 +1322,19 @@ zini_file_parameter_double (const PIniFile	*file,
 			     const pchar	*key,
 			     double		default_val)
 {
-	pchar	*val;
-	pdouble	ret;
+	PEpochRecord	*record;
+	PIniParameter	*param;
+	double		ret;
 
-	if ((val = pzini_file_find_parameter (file, section, key)) == NULL)
+	if (P_UNLIKELY (file == NULL))
 		return default_val;
 
-	ret = zstrtod (val);
-	zfree (val);
+	ret = default_val;
+
+	if ((param = pzini_file_lookup (pzini_file_enter ((PIniFile *) file, &record), section, key)) != NULL)
+		ret = pzini_file_parameter_to_double (param);
+
+	pzini_file_leave ((PIniFile *) file, record);
 
 	return ret;
 }
@@ -432,22 +1345,19 @@ zini_file_parameter_boolean (const PIniFile	*file,
 			      const pchar	*key,
 			      pboolean		default_val)
 {
-	pchar		*val;
+	PEpochRecord	*record;
+	PIniParameter	*param;
 	pboolean	ret;
 
-	if ((val = pzini_file_find_parameter (file, section, key)) == NULL)
+	if (P_UNLIKELY (file == NULL))
 		return default_val;
 
-	if (strcmp (val, "true") == 0 || strcmp (val, "TRUE") == 0)
-		ret = TRUE;
-	else if (strcmp (val, "false") == 0 || strcmp (val, "FALSE") == 0)
-		ret = FALSE;
-	else if (atoi (val) > 0)
-		ret = TRUE;
-	else
-		ret = FALSE;
+	ret = default_val;
 
-	zfree (val);
+	if ((param = pzini_file_lookup (pzini_file_enter ((PIniFile *) file, &record), section, key)) != NULL)
+		ret = pzini_file_parameter_to_boolean (param);
+
+	pzini_file_leave ((PIniFile *) file, record);
 
 	return ret;
 }
@@ -457,10 +1367,11 @@ zini_file_parameter_list (const PIniFile	*file,
 			   const pchar		*section,
 			   const pchar		*key)
 {
-	PList	*ret = NULL;
-	pchar	*val, *str;
-	pchar	buf[P_INI_FILE_MAX_LINE + 1];
-	psize	len, buf_cnt;
+	PList		*ret = NULL;
+	pchar		*val;
+	const pchar	*str;
+	const pchar	*token;
+	psize		len, token_len;
 
 	if ((val = pzini_file_find_parameter (file, section, key)) == NULL)
 		return NULL;
@@ -472,30 +1383,12 @@ zini_file_parameter_list (const PIniFile	*file,
 		return NULL;
 	}
 
-	/* Skip first brace '{' symbol */
+	/* Skip first brace '{' symbol, stop at the first closing one */
 	str = val + 1;
-	buf[0] = '\0';
-	buf_cnt = 0;
-
-	while (*str && *str != '}') {
-		if (!isspace (* ((const puchar *) str)))
-			buf[buf_cnt++] = *str;
-		else {
-			buf[buf_cnt] = '\0';
-
-			if (buf_cnt > 0)
-				ret = zlist_append (ret, zstrdup (buf));
+	len = (psize) (strchr (str, '}') - str);
 
-			buf_cnt = 0;
-		}
-
-		++str;
-	}
-
-	if (buf_cnt > 0) {
-		buf[buf_cnt] = '\0';
-		ret = zlist_append (ret, zstrdup (buf));
-	}
+	while ((token = zstrtok_span (&str, &len, " \t\n\v\f\r", &token_len)) != NULL)
+		ret = zlist_append (ret, zstrndup (token, token_len));
 
 	zfree (val);
 
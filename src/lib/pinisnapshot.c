@@ -0,0 +1,998 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "pinisnapshot.h"
+#include "plist.h"
+#include "pprocess.h"
+#include "pstring.h"
+#include "pstringbuilder.h"
+#include "perror-private.h"
+#include "phashfunc-private.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef P_OS_UNIX
+#  include "psysclose-private.h"
+#  include <sys/types.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <errno.h>
+#endif
+
+#ifdef P_OS_WIN
+#  include <io.h>
+#endif
+
+#define P_INI_SNAPSHOT_MAGIC		"PINISNAP"
+#define P_INI_SNAPSHOT_MAGIC_LEN	8
+#define P_INI_SNAPSHOT_VERSION		1
+#define P_INI_SNAPSHOT_BYTE_ORDER	0x01020304
+#define P_INI_SNAPSHOT_SEED		0x9E3779B97F4A7C15ULL
+#define P_INI_SNAPSHOT_MIN_SLOTS	4
+#define P_INI_SNAPSHOT_MAX_STRINGS	((psize) 0xFFFFFFFFU)
+#define P_INI_SNAPSHOT_READ_CHUNK	65536
+#define P_INI_SNAPSHOT_TEMP_TRIES	16
+#define P_INI_SNAPSHOT_TEMP_SUFFIX	32
+
+/* Snapshot layout (all the offsets are from the beginning of the snapshot,
+ * string offsets are from the beginning of the string table):
+ *
+ *   PIniSnapshotHeader
+ *   PIniSnapshotSection[section_slots]	- hash index of the sections
+ *   PIniSnapshotKey[key_slot_count]	- hash indexes of the keys
+ *   string table			- zero-terminated names and values
+ *
+ * Every section owns a power of two block of the key slots. The string
+ * table starts with a zero byte, so the zero string offset marks an empty
+ * slot. All the records are multiples of 8 bytes in size, thus they are
+ * properly aligned within a mapped snapshot. */
+
+typedef struct PIniSnapshotHeader_ {
+	pchar	magic[P_INI_SNAPSHOT_MAGIC_LEN];
+	puint32	version;
+	puint32	byte_order;
+	puint32	section_slots;
+	puint32	section_count;
+	puint64	key_slots_offset;
+	puint64	key_slot_count;
+	puint64	strings_offset;
+	puint64	strings_size;
+	puint64	total_size;
+} PIniSnapshotHeader;
+
+typedef struct PIniSnapshotSection_ {
+	puint64	hash;
+	puint32	name_offset;
+	puint32	name_len;
+	puint32	key_first;
+	puint32	key_slots;
+} PIniSnapshotSection;
+
+typedef struct PIniSnapshotKey_ {
+	puint64	hash;
+	puint32	name_offset;
+	puint32	name_len;
+	puint32	value_offset;
+	puint32	value_len;
+} PIniSnapshotKey;
+
+/* Deduplication index of the string table, used only while writing */
+typedef struct PIniSnapshotString_ {
+	puint64	hash;
+	puint32	offset;
+	puint32	len;
+} PIniSnapshotString;
+
+typedef struct PIniSnapshotBuilder_ {
+	PStringBuilder		*strings;
+	PIniSnapshotString	*string_slots;
+	psize			string_slot_count;
+	psize			string_count;
+	PIniSnapshotSection	*sections;
+	puint32			section_slots;
+	puint32			section_count;
+	PIniSnapshotKey		*keys;
+	psize			key_count;
+	psize			key_capacity;
+} PIniSnapshotBuilder;
+
+struct PIniSnapshot_ {
+	puchar				*data;
+	psize				size;
+	pboolean			is_mapped;
+	const PIniSnapshotHeader	*header;
+	const PIniSnapshotSection	*sections;
+	const PIniSnapshotKey		*keys;
+	const pchar			*strings;
+};
+
+static volatile pint pz_ini_snapshot_temp_counter = 0;
+
+static puint32 pzini_snapshot_slots_for (psize count);
+static pboolean pzini_snapshot_grow_strings (PIniSnapshotBuilder *builder);
+static pboolean pzini_snapshot_add_string (PIniSnapshotBuilder *builder, const pchar *str, psize len, puint32 *offset, PError **error);
+static pboolean pzini_snapshot_add_section (PIniSnapshotBuilder *builder, const PIniFile *file, const pchar *name, PError **error);
+static FILE * pzini_snapshot_open_temp (const pchar *path, pchar *tmp_path);
+static pboolean pzini_snapshot_save (const PIniSnapshotBuilder *builder, const pchar *path, PError **error);
+static pboolean pzini_snapshot_load (PIniSnapshot *snapshot, const pchar *path, PError **error);
+static void pzini_snapshot_unload (PIniSnapshot *snapshot);
+static pboolean pzini_snapshot_validate (PIniSnapshot *snapshot);
+static pboolean pzini_snapshot_name_equals (const PIniSnapshot *snapshot, puint32 offset, puint32 len, const pchar *name, psize name_len);
+static const PIniSnapshotKey * pzini_snapshot_lookup (const PIniSnapshot *snapshot, const pchar *section, const pchar *key);
+
+/* Smallest power of two keeping the load factor at most 1/2 */
+static puint32
+pzini_snapshot_slots_for (psize count)
+{
+	puint32 slots;
+
+	slots = P_INI_SNAPSHOT_MIN_SLOTS;
+
+	while ((psize) slots < count * 2)
+		slots <<= 1;
+
+	return slots;
+}
+
+static pboolean
+pzini_snapshot_grow_strings (PIniSnapshotBuilder *builder)
+{
+	PIniSnapshotString	*new_slots;
+	PIniSnapshotString	*str;
+	psize			new_count;
+	psize			mask;
+	psize			pos;
+	psize			i;
+
+	new_count = builder->string_slot_count == 0 ? 64 : builder->string_slot_count * 2;
+
+	if (P_UNLIKELY ((new_slots = zmalloc0 (new_count * sizeof (PIniSnapshotString))) == NULL))
+		return FALSE;
+
+	mask = new_count - 1;
+
+	for (i = 0; i < builder->string_slot_count; ++i) {
+		str = &builder->string_slots[i];
+
+		if (str->offset == 0)
+			continue;
+
+		for (pos = (psize) str->hash & mask; new_slots[pos].offset != 0; pos = (pos + 1) & mask)
+			;
+
+		new_slots[pos] = *str;
+	}
+
+	zfree (builder->string_slots);
+
+	builder->string_slots      = new_slots;
+	builder->string_slot_count = new_count;
+
+	return TRUE;
+}
+
+/* Appends a string to the string table, the same strings are stored once */
+static pboolean
+pzini_snapshot_add_string (PIniSnapshotBuilder	*builder,
+			   const pchar		*str,
+			   psize		len,
+			   puint32		*offset,
+			   PError		**error)
+{
+	PIniSnapshotString	*slot;
+	const pchar		*table;
+	puint64			hash;
+	psize			mask;
+	psize			pos;
+	psize			table_len;
+
+	if (P_UNLIKELY ((builder->string_count + 1) * 2 > builder->string_slot_count &&
+			pzini_snapshot_grow_strings (builder) == FALSE)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for snapshot strings");
+		return FALSE;
+	}
+
+	hash  = zhash_func_bytes (str, len, P_INI_SNAPSHOT_SEED);
+	table = zstring_builder_get_str (builder->strings);
+	mask  = builder->string_slot_count - 1;
+
+	for (pos = (psize) hash & mask; builder->string_slots[pos].offset != 0; pos = (pos + 1) & mask) {
+		slot = &builder->string_slots[pos];
+
+		if (slot->hash == hash && slot->len == len && memcmp (table + slot->offset, str, len) == 0) {
+			*offset = slot->offset;
+			return TRUE;
+		}
+	}
+
+	table_len = zstring_builder_get_len (builder->strings);
+
+	if (P_UNLIKELY (len >= P_INI_SNAPSHOT_MAX_STRINGS - table_len)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Snapshot string table is too large");
+		return FALSE;
+	}
+
+	/* The string is zero-terminated, so the terminator is copied too */
+	if (P_UNLIKELY (zstring_builder_append_len (builder->strings, str, len + 1) == FALSE)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for snapshot strings");
+		return FALSE;
+	}
+
+	slot = &builder->string_slots[pos];
+
+	slot->hash   = hash;
+	slot->offset = (puint32) table_len;
+	slot->len    = (puint32) len;
+
+	++builder->string_count;
+
+	*offset = (puint32) table_len;
+
+	return TRUE;
+}
+
+static pboolean
+pzini_snapshot_add_section (PIniSnapshotBuilder	*builder,
+			    const PIniFile	*file,
+			    const pchar		*name,
+			    PError		**error)
+{
+	PIniSnapshotSection	*sect;
+	PIniSnapshotKey		*new_keys;
+	PIniSnapshotKey		*block;
+	PIniSnapshotKey		*slot;
+	PList			*keys;
+	PList			*item;
+	const pchar		*table;
+	const pchar		*key;
+	const pchar		*value;
+	puint64			hash;
+	psize			name_len;
+	psize			key_len;
+	psize			mask;
+	psize			pos;
+	puint32			key_slots;
+	puint32			name_offset;
+	puint32			value_offset;
+	pboolean		result;
+
+	name_len = strlen (name);
+	hash     = zhash_func_bytes (name, name_len, P_INI_SNAPSHOT_SEED);
+	table    = zstring_builder_get_str (builder->strings);
+	mask     = builder->section_slots - 1;
+
+	/* Only the first section with the given name is visible in PIniFile */
+	for (pos = (psize) hash & mask; builder->sections[pos].name_offset != 0; pos = (pos + 1) & mask) {
+		sect = &builder->sections[pos];
+
+		if (sect->hash == hash && sect->name_len == name_len &&
+		    memcmp (table + sect->name_offset, name, name_len) == 0)
+			return TRUE;
+	}
+
+	sect       = &builder->sections[pos];
+	sect->hash = hash;
+
+	if (P_UNLIKELY (pzini_snapshot_add_string (builder, name, name_len, &name_offset, error) == FALSE))
+		return FALSE;
+
+	keys      = zini_file_keys (file, name);
+	key_slots = pzini_snapshot_slots_for (zlist_length (keys));
+
+	if (builder->key_count + key_slots > builder->key_capacity) {
+		builder->key_capacity *= 2;
+
+		if (builder->key_capacity < builder->key_count + key_slots)
+			builder->key_capacity = builder->key_count + key_slots;
+
+		if (P_UNLIKELY ((new_keys = zrealloc (builder->keys,
+						       builder->key_capacity * sizeof (PIniSnapshotKey))) == NULL)) {
+			zerror_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for snapshot keys");
+			zlist_foreach (keys, (PFunc) zfree, NULL);
+			zlist_free (keys);
+			return FALSE;
+		}
+
+		builder->keys = new_keys;
+	}
+
+	block  = builder->keys + builder->key_count;
+	mask   = key_slots - 1;
+	result = TRUE;
+
+	memset (block, 0, key_slots * sizeof (PIniSnapshotKey));
+
+	for (item = keys; item != NULL && result == TRUE; item = item->next) {
+		key     = (const pchar *) item->data;
+		key_len = strlen (key);
+		hash    = zhash_func_bytes (key, key_len, P_INI_SNAPSHOT_SEED);
+		table   = zstring_builder_get_str (builder->strings);
+
+		for (pos = (psize) hash & mask; block[pos].name_offset != 0; pos = (pos + 1) & mask) {
+			slot = &block[pos];
+
+			if (slot->hash == hash && slot->name_len == key_len &&
+			    memcmp (table + slot->name_offset, key, key_len) == 0)
+				break;
+		}
+
+		/* Duplicated key, the value is the same as for the first one */
+		if (block[pos].name_offset != 0)
+			continue;
+
+		if (P_UNLIKELY ((value = zini_file_parameter_string_view (file, name, key, NULL)) == NULL))
+			continue;
+
+		slot = &block[pos];
+
+		if (P_UNLIKELY (pzini_snapshot_add_string (builder, key, key_len, &slot->name_offset, error) == FALSE ||
+				pzini_snapshot_add_string (builder, value, strlen (value), &value_offset, error) == FALSE)) {
+			slot->name_offset = 0;
+			result            = FALSE;
+			break;
+		}
+
+		slot->hash         = hash;
+		slot->name_len     = (puint32) key_len;
+		slot->value_offset = value_offset;
+		slot->value_len    = (puint32) strlen (value);
+	}
+
+	zlist_foreach (keys, (PFunc) zfree, NULL);
+	zlist_free (keys);
+
+	if (P_UNLIKELY (result == FALSE))
+		return FALSE;
+
+	sect->name_offset = name_offset;
+	sect->name_len    = (puint32) name_len;
+	sect->key_first   = (puint32) builder->key_count;
+	sect->key_slots   = key_slots;
+
+	builder->key_count += key_slots;
+	++builder->section_count;
+
+	return TRUE;
+}
+
+/* Creates a temporary file with a unique name next to the snapshot, as several
+ * processes may compile the same snapshot at once */
+static FILE *
+pzini_snapshot_open_temp (const pchar	*path,
+			  pchar		*tmp_path)
+{
+	FILE	*ret;
+	pint	i;
+#ifdef P_OS_UNIX
+	pint	fd;
+#endif
+
+	for (i = 0; i < P_INI_SNAPSHOT_TEMP_TRIES; ++i) {
+		sprintf (tmp_path,
+			 "%s.%u.%d.tmp",
+			 path,
+			 (puint) zprocess_get_current_pid (),
+			 zatomic_int_add (&pz_ini_snapshot_temp_counter, 1));
+
+#ifdef P_OS_UNIX
+		/* A file left by a crashed process with the same PID is skipped */
+		if ((fd = open (tmp_path, O_WRONLY | O_CREAT | O_EXCL, 0666)) == -1) {
+			if (errno == EEXIST)
+				continue;
+
+			return NULL;
+		}
+
+		if (P_UNLIKELY ((ret = fdopen (fd, "wb")) == NULL)) {
+			if (P_UNLIKELY (zsys_close (fd) != 0))
+				P_WARNING ("PIniSnapshot::pzini_snapshot_open_temp: failed to close file descriptor");
+
+			remove (tmp_path);
+		}
+
+		return ret;
+#else
+		if ((ret = fopen (tmp_path, "rb")) != NULL) {
+			fclose (ret);
+			continue;
+		}
+
+		return fopen (tmp_path, "wb");
+#endif
+	}
+
+	return NULL;
+}
+
+/* Writes into a temporary file first and replaces the target one with it, so
+ * the snapshot opened by other processes stays intact */
+static pboolean
+pzini_snapshot_save (const PIniSnapshotBuilder	*builder,
+		     const pchar		*path,
+		     PError			**error)
+{
+	PIniSnapshotHeader	header;
+	FILE			*out_file;
+	pchar			*tmp_path;
+	psize			sections_size;
+	psize			keys_size;
+	psize			strings_size;
+	pboolean		result;
+
+	sections_size = (psize) builder->section_slots * sizeof (PIniSnapshotSection);
+	keys_size     = builder->key_count * sizeof (PIniSnapshotKey);
+	strings_size  = zstring_builder_get_len (builder->strings);
+
+	memset (&header, 0, sizeof (header));
+	memcpy (header.magic, P_INI_SNAPSHOT_MAGIC, P_INI_SNAPSHOT_MAGIC_LEN);
+
+	header.version          = P_INI_SNAPSHOT_VERSION;
+	header.byte_order       = P_INI_SNAPSHOT_BYTE_ORDER;
+	header.section_slots    = builder->section_slots;
+	header.section_count    = builder->section_count;
+	header.key_slots_offset = (puint64) (sizeof (header) + sections_size);
+	header.key_slot_count   = (puint64) builder->key_count;
+	header.strings_offset   = header.key_slots_offset + (puint64) keys_size;
+	header.strings_size     = (puint64) strings_size;
+	header.total_size       = header.strings_offset + (puint64) strings_size;
+
+	if (P_UNLIKELY ((tmp_path = zmalloc (strlen (path) + P_INI_SNAPSHOT_TEMP_SUFFIX)) == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for temporary path");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((out_file = pzini_snapshot_open_temp (path, tmp_path)) == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to open file for writing");
+		zfree (tmp_path);
+		return FALSE;
+	}
+
+	result = fwrite (&header, sizeof (header), 1, out_file) == 1 &&
+		 fwrite (builder->sections, 1, sections_size, out_file) == sections_size &&
+		 (keys_size == 0 || fwrite (builder->keys, 1, keys_size, out_file) == keys_size) &&
+		 fwrite (zstring_builder_get_str (builder->strings), 1, strings_size, out_file) == strings_size;
+
+	/* The data must reach the disk before the rename, otherwise a crash could
+	 * publish an empty or short snapshot */
+	if (result == TRUE && P_UNLIKELY (fflush (out_file) != 0))
+		result = FALSE;
+
+#if defined (P_OS_UNIX)
+	if (result == TRUE && P_UNLIKELY (fsync (fileno (out_file)) != 0))
+		result = FALSE;
+#elif defined (P_OS_WIN)
+	if (result == TRUE && P_UNLIKELY (_commit (_fileno (out_file)) != 0))
+		result = FALSE;
+#endif
+
+	if (P_UNLIKELY (fclose (out_file) != 0))
+		result = FALSE;
+
+	if (P_UNLIKELY (result == FALSE)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to write snapshot file");
+		remove (tmp_path);
+		zfree (tmp_path);
+		return FALSE;
+	}
+
+#ifdef P_OS_WIN
+	remove (path);
+#endif
+
+	if (P_UNLIKELY (rename (tmp_path, path) != 0)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to replace snapshot file");
+		remove (tmp_path);
+		zfree (tmp_path);
+		return FALSE;
+	}
+
+	zfree (tmp_path);
+
+	return TRUE;
+}
+
+/* Maps the whole snapshot into memory, or reads it where mapping is not
+ * supported */
+static pboolean
+pzini_snapshot_load (PIniSnapshot	*snapshot,
+		     const pchar	*path,
+		     PError		**error)
+{
+#ifdef P_OS_UNIX
+	struct stat	sb;
+	pint		fd;
+
+	if (P_UNLIKELY ((fd = open (path, O_RDONLY)) == -1)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to open file for reading");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (fstat (fd, &sb) != 0)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to get file status");
+		zsys_close (fd);
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (sb.st_size < (off_t) sizeof (PIniSnapshotHeader) ||
+			(puint64) sb.st_size >= (puint64) P_MAXSIZE)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid snapshot file size");
+		zsys_close (fd);
+		return FALSE;
+	}
+
+	/* Shared read-only mapping, the pages come right from the page cache */
+	if (P_UNLIKELY ((snapshot->data = mmap (NULL,
+						(size_t) sb.st_size,
+						PROT_READ,
+						MAP_SHARED,
+						fd,
+						0)) == (void *) -1)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to call mmap() to map file");
+		snapshot->data = NULL;
+		zsys_close (fd);
+		return FALSE;
+	}
+
+#  ifdef MADV_RANDOM
+	madvise (snapshot->data, (size_t) sb.st_size, MADV_RANDOM);
+#  endif
+
+	snapshot->size      = (psize) sb.st_size;
+	snapshot->is_mapped = TRUE;
+
+	if (P_UNLIKELY (zsys_close (fd) != 0))
+		P_WARNING ("PIniSnapshot::pzini_snapshot_load: failed to close file descriptor");
+
+	return TRUE;
+#else
+	FILE	*in_file;
+	puchar	*new_data;
+	psize	capacity;
+	psize	n_read;
+
+	if (P_UNLIKELY ((in_file = fopen (path, "rb")) == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) zerror_get_last_io (),
+				     zerror_get_last_system (),
+				     "Failed to open file for reading");
+		return FALSE;
+	}
+
+	capacity = 0;
+
+	do {
+		if (snapshot->size == capacity) {
+			capacity += P_INI_SNAPSHOT_READ_CHUNK;
+
+			if (P_UNLIKELY ((new_data = zrealloc (snapshot->data, capacity)) == NULL)) {
+				zerror_set_error_p (error,
+						     (pint) P_ERROR_IO_NO_RESOURCES,
+						     0,
+						     "Failed to allocate memory for snapshot contents");
+				fclose (in_file);
+				return FALSE;
+			}
+
+			snapshot->data = new_data;
+		}
+
+		n_read = fread (snapshot->data + snapshot->size, 1, capacity - snapshot->size, in_file);
+		snapshot->size += n_read;
+	} while (n_read > 0);
+
+	if (P_UNLIKELY (ferror (in_file) != 0)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to read file");
+		fclose (in_file);
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (fclose (in_file) != 0))
+		P_WARNING ("PIniSnapshot::pzini_snapshot_load: fclose() failed");
+
+	if (P_UNLIKELY (snapshot->size < sizeof (PIniSnapshotHeader))) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid snapshot file size");
+		return FALSE;
+	}
+
+	return TRUE;
+#endif
+}
+
+static void
+pzini_snapshot_unload (PIniSnapshot *snapshot)
+{
+	if (snapshot->data == NULL)
+		return;
+
+#ifdef P_OS_UNIX
+	if (snapshot->is_mapped) {
+		if (P_UNLIKELY (munmap (snapshot->data, snapshot->size) != 0))
+			P_WARNING ("PIniSnapshot::pzini_snapshot_unload: munmap() failed");
+
+		return;
+	}
+#endif
+
+	zfree (snapshot->data);
+}
+
+/* Checks only the header and the table bounds, so the contents are not touched
+ * until they are really needed. The records are checked on every access. */
+static pboolean
+pzini_snapshot_validate (PIniSnapshot *snapshot)
+{
+	const PIniSnapshotHeader	*header;
+	puint64				size;
+
+	header = (const PIniSnapshotHeader *) snapshot->data;
+	size   = (puint64) snapshot->size;
+
+	if (memcmp (header->magic, P_INI_SNAPSHOT_MAGIC, P_INI_SNAPSHOT_MAGIC_LEN) != 0 ||
+	    header->version != P_INI_SNAPSHOT_VERSION ||
+	    header->byte_order != P_INI_SNAPSHOT_BYTE_ORDER)
+		return FALSE;
+
+	if (header->section_slots == 0 ||
+	    (header->section_slots & (header->section_slots - 1)) != 0 ||
+	    header->section_count >= header->section_slots)
+		return FALSE;
+
+	if (header->total_size != size ||
+	    header->key_slots_offset != sizeof (PIniSnapshotHeader) +
+					(puint64) header->section_slots * sizeof (PIniSnapshotSection) ||
+	    header->key_slots_offset > size ||
+	    header->key_slot_count > (size - header->key_slots_offset) / sizeof (PIniSnapshotKey) ||
+	    header->strings_offset != header->key_slots_offset +
+				      header->key_slot_count * sizeof (PIniSnapshotKey) ||
+	    header->strings_size == 0 ||
+	    header->strings_size != size - header->strings_offset ||
+	    header->strings_size > (puint64) P_INI_SNAPSHOT_MAX_STRINGS)
+		return FALSE;
+
+	snapshot->header   = header;
+	snapshot->sections = (const PIniSnapshotSection *) (snapshot->data + sizeof (PIniSnapshotHeader));
+	snapshot->keys     = (const PIniSnapshotKey *) (snapshot->data + header->key_slots_offset);
+	snapshot->strings  = (const pchar *) (snapshot->data + header->strings_offset);
+
+	/* Every string is terminated even in a damaged string table */
+	return snapshot->strings[0] == '\0' && snapshot->strings[header->strings_size - 1] == '\0';
+}
+
+static pboolean
+pzini_snapshot_name_equals (const PIniSnapshot	*snapshot,
+			    puint32		offset,
+			    puint32		len,
+			    const pchar		*name,
+			    psize		name_len)
+{
+	return (psize) len == name_len &&
+	       (puint64) offset + len < snapshot->header->strings_size &&
+	       memcmp (snapshot->strings + offset, name, name_len) == 0;
+}
+
+static const PIniSnapshotKey *
+pzini_snapshot_lookup (const PIniSnapshot	*snapshot,
+		       const pchar		*section,
+		       const pchar		*key)
+{
+	const PIniSnapshotSection	*sect;
+	const PIniSnapshotKey		*block;
+	const PIniSnapshotKey		*slot;
+	puint64				hash;
+	psize				len;
+	psize				mask;
+	psize				pos;
+	psize				i;
+
+	if (P_UNLIKELY (snapshot == NULL || section == NULL || key == NULL))
+		return NULL;
+
+	len  = strlen (section);
+	hash = zhash_func_bytes (section, len, P_INI_SNAPSHOT_SEED);
+	mask = snapshot->header->section_slots - 1;
+	sect = NULL;
+
+	for (i = 0, pos = (psize) hash & mask; i <= mask; ++i, pos = (pos + 1) & mask) {
+		if (snapshot->sections[pos].name_offset == 0)
+			return NULL;
+
+		if (snapshot->sections[pos].hash == hash &&
+		    pzini_snapshot_name_equals (snapshot,
+						snapshot->sections[pos].name_offset,
+						snapshot->sections[pos].name_len,
+						section,
+						len) == TRUE) {
+			sect = &snapshot->sections[pos];
+			break;
+		}
+	}
+
+	if (P_UNLIKELY (sect == NULL || sect->key_slots == 0 ||
+			(sect->key_slots & (sect->key_slots - 1)) != 0 ||
+			(puint64) sect->key_first + sect->key_slots > snapshot->header->key_slot_count))
+		return NULL;
+
+	block = snapshot->keys + sect->key_first;
+	len   = strlen (key);
+	hash  = zhash_func_bytes (key, len, P_INI_SNAPSHOT_SEED);
+	mask  = sect->key_slots - 1;
+
+	for (i = 0, pos = (psize) hash & mask; i <= mask; ++i, pos = (pos + 1) & mask) {
+		slot = &block[pos];
+
+		if (slot->name_offset == 0)
+			return NULL;
+
+		if (slot->hash == hash &&
+		    pzini_snapshot_name_equals (snapshot, slot->name_offset, slot->name_len, key, len) == TRUE)
+			return (puint64) slot->value_offset < snapshot->header->strings_size ? slot : NULL;
+	}
+
+	return NULL;
+}
+
+P_LIB_API pboolean
+zini_snapshot_write (const PIniFile	*file,
+		     const pchar	*path,
+		     PError		**error)
+{
+	PIniSnapshotBuilder	builder;
+	PList			*sections;
+	PList			*item;
+	pboolean		result;
+
+	if (P_UNLIKELY (file == NULL || path == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (zini_file_is_parsed (file) == FALSE)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "File is not parsed");
+		return FALSE;
+	}
+
+	memset (&builder, 0, sizeof (builder));
+
+	sections              = zini_file_sections (file);
+	builder.section_slots = pzini_snapshot_slots_for (zlist_length (sections));
+	builder.strings       = zstring_builder_new (0);
+	builder.sections      = zmalloc0 ((psize) builder.section_slots * sizeof (PIniSnapshotSection));
+
+	/* Offset 0 is reserved for the empty slots */
+	if (P_UNLIKELY (builder.strings == NULL || builder.sections == NULL ||
+			zstring_builder_append_char (builder.strings, '\0') == FALSE)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for snapshot");
+		result = FALSE;
+	} else {
+		result = TRUE;
+
+		for (item = sections; item != NULL && result == TRUE; item = item->next)
+			result = pzini_snapshot_add_section (&builder, file, (const pchar *) item->data, error);
+
+		if (result == TRUE)
+			result = pzini_snapshot_save (&builder, path, error);
+	}
+
+	zlist_foreach (sections, (PFunc) zfree, NULL);
+	zlist_free (sections);
+
+	zstring_builder_free (builder.strings);
+	zfree (builder.string_slots);
+	zfree (builder.sections);
+	zfree (builder.keys);
+
+	return result;
+}
+
+P_LIB_API PIniSnapshot *
+zini_snapshot_open (const pchar	*path,
+		    PError	**error)
+{
+	PIniSnapshot *ret;
+
+	if (P_UNLIKELY (path == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PIniSnapshot))) == NULL)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for snapshot");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pzini_snapshot_load (ret, path, error) == FALSE)) {
+		pzini_snapshot_unload (ret);
+		zfree (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pzini_snapshot_validate (ret) == FALSE)) {
+		zerror_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid or incompatible snapshot file");
+		pzini_snapshot_unload (ret);
+		zfree (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+zini_snapshot_close (PIniSnapshot *snapshot)
+{
+	if (P_UNLIKELY (snapshot == NULL))
+		return;
+
+	pzini_snapshot_unload (snapshot);
+	zfree (snapshot);
+}
+
+P_LIB_API psize
+zini_snapshot_section_count (const PIniSnapshot *snapshot)
+{
+	if (P_UNLIKELY (snapshot == NULL))
+		return 0;
+
+	return (psize) snapshot->header->section_count;
+}
+
+P_LIB_API pboolean
+zini_snapshot_is_key_exists (const PIniSnapshot	*snapshot,
+			     const pchar		*section,
+			     const pchar		*key)
+{
+	return pzini_snapshot_lookup (snapshot, section, key) != NULL;
+}
+
+P_LIB_API const pchar *
+zini_snapshot_parameter_string (const PIniSnapshot	*snapshot,
+				const pchar		*section,
+				const pchar		*key,
+				const pchar		*default_val)
+{
+	const PIniSnapshotKey *param;
+
+	if ((param = pzini_snapshot_lookup (snapshot, section, key)) == NULL)
+		return default_val;
+
+	return snapshot->strings + param->value_offset;
+}
+
+P_LIB_API pint
+zini_snapshot_parameter_int (const PIniSnapshot	*snapshot,
+			     const pchar		*section,
+			     const pchar		*key,
+			     pint			default_val)
+{
+	const PIniSnapshotKey *param;
+
+	if ((param = pzini_snapshot_lookup (snapshot, section, key)) == NULL)
+		return default_val;
+
+	return atoi (snapshot->strings + param->value_offset);
+}
+
+P_LIB_API double
+zini_snapshot_parameter_double (const PIniSnapshot	*snapshot,
+				const pchar		*section,
+				const pchar		*key,
+				double			default_val)
+{
+	const PIniSnapshotKey *param;
+
+	if ((param = pzini_snapshot_lookup (snapshot, section, key)) == NULL)
+		return default_val;
+
+	return zstrtod (snapshot->strings + param->value_offset);
+}
+
+P_LIB_API pboolean
+zini_snapshot_parameter_boolean (const PIniSnapshot	*snapshot,
+				 const pchar		*section,
+				 const pchar		*key,
+				 pboolean		default_val)
+{
+	const PIniSnapshotKey	*param;
+	const pchar		*val;
+
+	if ((param = pzini_snapshot_lookup (snapshot, section, key)) == NULL)
+		return default_val;
+
+	val = snapshot->strings + param->value_offset;
+
+	if (strcmp (val, "true") == 0 || strcmp (val, "TRUE") == 0)
+		return TRUE;
+	else if (strcmp (val, "false") == 0 || strcmp (val, "FALSE") == 0)
+		return FALSE;
+	else if (atoi (val) > 0)
+		return TRUE;
+	else
+		return FALSE;
+}
@@ -26,6 +26,7 @@
 #include "pmem.h"
 #include "pcryptohash.h"
 #include "pstring.h"
+#include "pstringbuilder.h"
 #include "psysclose-private.h"
 
 #include <stdlib.h>
@@ -44,39 +45,35 @@
 pchar *
 zipc_unix_get_temzdir (void)
 {
-	pchar	*str, *ret;
-	psize	len;
+	PStringBuilder	*builder;
+	const pchar	*tmzdir;
+	pchar		*ret;
+	psize		len;
 
 #ifdef P_tmpdir
-	if (strlen (P_tmpdir) > 0)
-		str = zstrdup (P_tmpdir);
-	else
-		return zstrdup ("/tmp/");
+	tmzdir = P_tmpdir;
 #else
-	const pchar *tmzenv;
-
-	tmzenv = getenv ("TMPDIR");
+	tmzdir = getenv ("TMPDIR");
+#endif /* P_tmpdir */
 
-	if (tmzenv != NULL)
-		str = zstrdup (tmzenv);
-	else
+	if (tmzdir == NULL || *tmzdir == '\0')
 		return zstrdup ("/tmp/");
-#endif /* P_tmpdir */
 
 	/* Now we need to ensure that we have only the one trailing slash */
-	len = strlen (str);
-	while (*(str + --len) == '/')
-		;
-	*(str + ++len) = '\0';
-
-	/* len + / + zero symbol */
-	if (P_UNLIKELY ((ret = zmalloc0 (len + 2)) == NULL)) {
-		zfree (str);
+	len = strlen (tmzdir);
+
+	while (len > 0 && tmzdir[len - 1] == '/')
+		--len;
+
+	/* len + / */
+	if (P_UNLIKELY ((builder = zstring_builder_new (len + 1)) == NULL))
 		return NULL;
-	}
 
-	strcpy (ret, str);
-	strcat (ret, "/");
+	zstring_builder_append_len (builder, tmzdir, len);
+	zstring_builder_append_char (builder, '/');
+
+	ret = zstring_builder_steal (builder);
+	zstring_builder_free (builder);
 
 	return ret;
 }
@@ -124,6 +121,7 @@ zipc_get_platform_key (const pchar *name, pboolean posix)
 #if defined (P_OS_WIN) || defined (P_OS_OS2) || defined (P_OS_AMIGA)
 	P_UNUSED (posix);
 #else
+	PStringBuilder	*builder;
 	pchar		*path_name, *tmzpath;
 #endif
 
@@ -156,19 +154,26 @@ zipc_get_platform_key (const pchar *name, pboolean posix)
 		strcpy (path_name, "/");
 		strncat (path_name, hash_str, 13);
 	} else {
-		tmzpath = zipc_unix_get_temzdir ();
+		if (P_UNLIKELY ((tmzpath = zipc_unix_get_temzdir ()) == NULL)) {
+			zfree (hash_str);
+			return NULL;
+		}
 
-		/* tmp dir + filename + zero symbol */
-		path_name = zmalloc0 (strlen (tmzpath) + strlen (hash_str) + 1);
+		/* tmp dir + filename */
+		builder = zstring_builder_new (strlen (tmzpath) + strlen (hash_str));
 
-		if (P_UNLIKELY ((path_name) == NULL)) {
+		if (P_UNLIKELY (builder == NULL)) {
 			zfree (tmzpath);
 			zfree (hash_str);
 			return NULL;
 		}
 
-		strcpy (path_name, tmzpath);
-		strcat (path_name, hash_str);
+		zstring_builder_append (builder, tmzpath);
+		zstring_builder_append (builder, hash_str);
+
+		path_name = zstring_builder_steal (builder);
+
+		zstring_builder_free (builder);
 		zfree (tmzpath);
 	}
 
@@ -30,10 +30,14 @@ extern void zmem_init			(void);
 extern void zmem_shutdown		(void);
 extern void zatomic_thread_init	(void);
 extern void zatomic_thread_shutdown	(void);
+extern void zstr_intern_init		(void);
+extern void zstr_intern_shutdown	(void);
 extern void zsocket_init_once		(void);
 extern void zsocket_close_once		(void);
 extern void zuthread_init		(void);
 extern void zuthread_shutdown		(void);
+extern void zepoch_init			(void);
+extern void zepoch_shutdown		(void);
 extern void zcond_variable_init	(void);
 extern void zcond_variable_shutdown	(void);
 extern void zrwlock_init		(void);
@@ -42,6 +46,7 @@ extern void ztime_profiler_init	(void);
 extern void ztime_profiler_shutdown	(void);
 extern void zlibrary_loader_init	(void);
 extern void zlibrary_loader_shutdown	(void);
+extern void zcpu_info_init		(void);
 
 static pboolean pzplibsys_inited = FALSE;
 static pchar pzplibsys_version[] = PLIBSYS_VERSION_STR;
@@ -55,9 +60,12 @@ zlibsys_init (void)
 	pzplibsys_inited = TRUE;
 
 	zmem_init ();
+	zcpu_info_init ();
 	zatomic_thread_init ();
+	zstr_intern_init ();
 	zsocket_init_once ();
 	zuthread_init ();
+	zepoch_init ();
 	zcond_variable_init ();
 	zrwlock_init ();
 	ztime_profiler_init ();
@@ -85,8 +93,10 @@ zlibsys_shutdown (void)
 	ztime_profiler_shutdown ();
 	zrwlock_shutdown ();
 	zcond_variable_shutdown ();
+	zepoch_shutdown ();
 	zuthread_shutdown ();
 	zsocket_close_once ();
+	zstr_intern_shutdown ();
 	zatomic_thread_shutdown ();
 	zmem_shutdown ();
 }
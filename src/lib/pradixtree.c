@@ -0,0 +1,577 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pradixtree.h"
+#include "plibsys-private.h"
+
+#include <string.h>
+
+#ifndef P_OS_WIN
+#  include <arpa/inet.h>
+#endif
+
+#if defined (P_OS_BEOS) || defined (P_OS_OS2)
+#  ifdef AF_INET6
+#    undef AF_INET6
+#  endif
+#endif
+
+#define P_RADIX_TREE_MAX_KEY	16
+#define P_RADIX_TREE_INET_BITS	32
+#define P_RADIX_TREE_INET6_BITS	128
+
+typedef struct PRadixNode_ PRadixNode;
+
+struct PRadixNode_ {
+	puchar		key[P_RADIX_TREE_MAX_KEY];
+	puint		len;
+	pboolean	has_value;
+	ppointer	value;
+	PRadixNode	*child[2];
+};
+
+struct PRadixTree_ {
+	PRadixNode	*root4;
+	PRadixNode	*root6;
+	psize		nprefixes;
+	PDestroyFunc	value_destroy;
+};
+
+static puint pzradix_tree_get_bit (const puchar *key, puint index);
+static puint pzradix_tree_common_len (const puchar *a, const puchar *b, puint max_len);
+static void pzradix_tree_mask_key (puchar *dst, const puchar *src, puint len);
+static PRadixNode * pzradix_tree_node_new (const puchar *key, puint len);
+static void pzradix_tree_node_free (PRadixTree *tree, PRadixNode *node);
+static PRadixNode ** pzradix_tree_get_root (const PRadixTree *tree, puint max_bits);
+static pboolean pzradix_tree_native_to_key (pconstpointer native, psize len, puchar *key, puint *max_bits);
+static pboolean pzradix_tree_addr_to_key (const PSocketAddress *addr, puchar *key, puint *max_bits);
+static pboolean pzradix_tree_insert_key (PRadixTree *tree, const puchar *key, puint max_bits, puint prefix_len, ppointer value);
+static pboolean pzradix_tree_remove_key (PRadixTree *tree, const puchar *key, puint max_bits, puint prefix_len);
+static ppointer pzradix_tree_lookup_key (const PRadixTree *tree, const puchar *key, puint max_bits, puint *prefix_len);
+
+static puint
+pzradix_tree_get_bit (const puchar	*key,
+		      puint		index)
+{
+	return (key[index >> 3] >> (7 - (index & 7))) & 1;
+}
+
+static puint
+pzradix_tree_common_len (const puchar	*a,
+			 const puchar	*b,
+			 puint		max_len)
+{
+	puint	i;
+	puint	nbytes;
+	puint	common;
+	puchar	diff;
+
+	nbytes = (max_len + 7) >> 3;
+
+	for (i = 0; i < nbytes; ++i) {
+		diff = a[i] ^ b[i];
+
+		if (diff != 0)
+			break;
+	}
+
+	if (i == nbytes)
+		return max_len;
+
+	common = i << 3;
+
+	while ((diff & 0x80) == 0) {
+		diff <<= 1;
+		++common;
+	}
+
+	return common < max_len ? common : max_len;
+}
+
+static void
+pzradix_tree_mask_key (puchar		*dst,
+		       const puchar	*src,
+		       puint		len)
+{
+	puint nbytes;
+
+	nbytes = len >> 3;
+
+	memset (dst, 0, P_RADIX_TREE_MAX_KEY);
+	memcpy (dst, src, nbytes);
+
+	if ((len & 7) != 0)
+		dst[nbytes] = src[nbytes] & (puchar) (0xFF << (8 - (len & 7)));
+}
+
+static PRadixNode *
+pzradix_tree_node_new (const puchar	*key,
+		       puint		len)
+{
+	PRadixNode *ret;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PRadixNode))) == NULL))
+		return NULL;
+
+	pzradix_tree_mask_key (ret->key, key, len);
+	ret->len = len;
+
+	return ret;
+}
+
+static void
+pzradix_tree_node_free (PRadixTree	*tree,
+			PRadixNode	*node)
+{
+	if (node == NULL)
+		return;
+
+	pzradix_tree_node_free (tree, node->child[0]);
+	pzradix_tree_node_free (tree, node->child[1]);
+
+	if (node->has_value && tree->value_destroy != NULL)
+		tree->value_destroy (node->value);
+
+	zfree (node);
+}
+
+static PRadixNode **
+pzradix_tree_get_root (const PRadixTree	*tree,
+		       puint		max_bits)
+{
+	if (max_bits == P_RADIX_TREE_INET_BITS)
+		return (PRadixNode **) &tree->root4;
+	else
+		return (PRadixNode **) &tree->root6;
+}
+
+static pboolean
+pzradix_tree_native_to_key (pconstpointer	native,
+			    psize		len,
+			    puchar		*key,
+			    puint		*max_bits)
+{
+	const struct sockaddr *sa;
+
+	if (P_UNLIKELY (native == NULL || len < sizeof (struct sockaddr_in)))
+		return FALSE;
+
+	sa = (const struct sockaddr *) native;
+
+	if (sa->sa_family == AF_INET) {
+		memcpy (key, &((const struct sockaddr_in *) native)->sin_addr, 4);
+		*max_bits = P_RADIX_TREE_INET_BITS;
+		return TRUE;
+	}
+#ifdef AF_INET6
+	else if (sa->sa_family == AF_INET6) {
+		if (P_UNLIKELY (len < sizeof (struct sockaddr_in6)))
+			return FALSE;
+
+		memcpy (key, &((const struct sockaddr_in6 *) native)->sin6_addr, 16);
+		*max_bits = P_RADIX_TREE_INET6_BITS;
+		return TRUE;
+	}
+#endif
+
+	return FALSE;
+}
+
+static pboolean
+pzradix_tree_addr_to_key (const PSocketAddress	*addr,
+			  puchar		*key,
+			  puint			*max_bits)
+{
+	struct sockaddr_storage	sa;
+	psize			len;
+
+	if (P_UNLIKELY (addr == NULL))
+		return FALSE;
+
+	len = zsocket_address_get_native_size (addr);
+
+	if (P_UNLIKELY (len == 0 || len > sizeof (sa)))
+		return FALSE;
+
+	if (P_UNLIKELY (zsocket_address_to_native (addr, &sa, sizeof (sa)) == FALSE))
+		return FALSE;
+
+	return pzradix_tree_native_to_key (&sa, len, key, max_bits);
+}
+
+static pboolean
+pzradix_tree_insert_key (PRadixTree	*tree,
+			 const puchar	*key,
+			 puint		max_bits,
+			 puint		prefix_len,
+			 ppointer	value)
+{
+	PRadixNode	**link;
+	PRadixNode	*node;
+	PRadixNode	*new_node;
+	PRadixNode	*split;
+	puint		common;
+
+	if (P_UNLIKELY (prefix_len > max_bits))
+		return FALSE;
+
+	link = pzradix_tree_get_root (tree, max_bits);
+
+	while (TRUE) {
+		node = *link;
+
+		if (node == NULL) {
+			if (P_UNLIKELY ((new_node = pzradix_tree_node_new (key, prefix_len)) == NULL)) {
+				P_ERROR ("PRadixTree::zradix_tree_insert: failed(1) to allocate memory");
+				return FALSE;
+			}
+
+			new_node->has_value = TRUE;
+			new_node->value     = value;
+			*link               = new_node;
+
+			++tree->nprefixes;
+			return TRUE;
+		}
+
+		common = pzradix_tree_common_len (node->key,
+						  key,
+						  node->len < prefix_len ? node->len : prefix_len);
+
+		if (common == node->len) {
+			if (node->len == prefix_len) {
+				if (node->has_value) {
+					if (tree->value_destroy != NULL && node->value != value)
+						tree->value_destroy (node->value);
+				} else
+					++tree->nprefixes;
+
+				node->has_value = TRUE;
+				node->value     = value;
+
+				return TRUE;
+			}
+
+			/* Prefix is longer than the node, go deeper */
+			link = &node->child[pzradix_tree_get_bit (key, node->len)];
+			continue;
+		}
+
+		/* Paths diverge inside the node, new node goes above it */
+		if (P_UNLIKELY ((new_node = pzradix_tree_node_new (key, prefix_len)) == NULL)) {
+			P_ERROR ("PRadixTree::zradix_tree_insert: failed(2) to allocate memory");
+			return FALSE;
+		}
+
+		new_node->has_value = TRUE;
+		new_node->value     = value;
+
+		if (common == prefix_len) {
+			new_node->child[pzradix_tree_get_bit (node->key, prefix_len)] = node;
+			*link = new_node;
+		} else {
+			if (P_UNLIKELY ((split = pzradix_tree_node_new (key, common)) == NULL)) {
+				P_ERROR ("PRadixTree::zradix_tree_insert: failed(3) to allocate memory");
+				zfree (new_node);
+				return FALSE;
+			}
+
+			split->child[pzradix_tree_get_bit (node->key, common)] = node;
+			split->child[pzradix_tree_get_bit (key, common)]       = new_node;
+			*link = split;
+		}
+
+		++tree->nprefixes;
+		return TRUE;
+	}
+}
+
+static pboolean
+pzradix_tree_remove_key (PRadixTree	*tree,
+			 const puchar	*key,
+			 puint		max_bits,
+			 puint		prefix_len)
+{
+	PRadixNode	**link;
+	PRadixNode	**parent_link;
+	PRadixNode	*node;
+	PRadixNode	*parent;
+
+	if (P_UNLIKELY (prefix_len > max_bits))
+		return FALSE;
+
+	parent_link = NULL;
+	link        = pzradix_tree_get_root (tree, max_bits);
+
+	while (TRUE) {
+		node = *link;
+
+		if (node == NULL || node->len > prefix_len)
+			return FALSE;
+
+		if (pzradix_tree_common_len (node->key, key, node->len) != node->len)
+			return FALSE;
+
+		if (node->len == prefix_len)
+			break;
+
+		parent_link = link;
+		link        = &node->child[pzradix_tree_get_bit (key, node->len)];
+	}
+
+	if (!node->has_value)
+		return FALSE;
+
+	if (tree->value_destroy != NULL)
+		tree->value_destroy (node->value);
+
+	node->has_value = FALSE;
+	node->value     = NULL;
+
+	--tree->nprefixes;
+
+	/* Keep the node as a branching point */
+	if (node->child[0] != NULL && node->child[1] != NULL)
+		return TRUE;
+
+	*link = node->child[0] != NULL ? node->child[0] : node->child[1];
+	zfree (node);
+
+	/* Collapse the parent if it became a valueless node with a single child */
+	if (parent_link != NULL && *link == NULL) {
+		parent = *parent_link;
+
+		if (!parent->has_value) {
+			*parent_link = parent->child[0] != NULL ? parent->child[0] : parent->child[1];
+			zfree (parent);
+		}
+	}
+
+	return TRUE;
+}
+
+static ppointer
+pzradix_tree_lookup_key (const PRadixTree	*tree,
+			 const puchar		*key,
+			 puint			max_bits,
+			 puint			*prefix_len)
+{
+	const PRadixNode	*node;
+	const PRadixNode	*best;
+	puint			nbytes;
+	puint			rest;
+
+	node = *pzradix_tree_get_root (tree, max_bits);
+	best = NULL;
+
+	while (node != NULL) {
+		nbytes = node->len >> 3;
+		rest   = node->len & 7;
+
+		if (memcmp (node->key, key, nbytes) != 0)
+			break;
+
+		if (rest != 0 && ((node->key[nbytes] ^ key[nbytes]) >> (8 - rest)) != 0)
+			break;
+
+		if (node->has_value)
+			best = node;
+
+		if (node->len == max_bits)
+			break;
+
+		node = node->child[pzradix_tree_get_bit (key, node->len)];
+	}
+
+	if (best == NULL)
+		return NULL;
+
+	if (prefix_len != NULL)
+		*prefix_len = best->len;
+
+	return best->value;
+}
+
+P_LIB_API PRadixTree *
+zradix_tree_new (void)
+{
+	return zradix_tree_new_full (NULL);
+}
+
+P_LIB_API PRadixTree *
+zradix_tree_new_full (PDestroyFunc value_destroy)
+{
+	PRadixTree *ret;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PRadixTree))) == NULL)) {
+		P_ERROR ("PRadixTree::zradix_tree_new_full: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	ret->value_destroy = value_destroy;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+zradix_tree_insert (PRadixTree		*tree,
+		    const PSocketAddress	*prefix,
+		    puint		prefix_len,
+		    ppointer		value)
+{
+	puchar	key[P_RADIX_TREE_MAX_KEY];
+	puint	max_bits;
+
+	if (P_UNLIKELY (tree == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (pzradix_tree_addr_to_key (prefix, key, &max_bits) == FALSE))
+		return FALSE;
+
+	return pzradix_tree_insert_key (tree, key, max_bits, prefix_len, value);
+}
+
+P_LIB_API pboolean
+zradix_tree_insert_native (PRadixTree	*tree,
+			   pconstpointer	native,
+			   psize		len,
+			   puint		prefix_len,
+			   ppointer		value)
+{
+	puchar	key[P_RADIX_TREE_MAX_KEY];
+	puint	max_bits;
+
+	if (P_UNLIKELY (tree == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (pzradix_tree_native_to_key (native, len, key, &max_bits) == FALSE))
+		return FALSE;
+
+	return pzradix_tree_insert_key (tree, key, max_bits, prefix_len, value);
+}
+
+P_LIB_API pboolean
+zradix_tree_remove (PRadixTree		*tree,
+		    const PSocketAddress	*prefix,
+		    puint		prefix_len)
+{
+	puchar	key[P_RADIX_TREE_MAX_KEY];
+	puint	max_bits;
+
+	if (P_UNLIKELY (tree == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (pzradix_tree_addr_to_key (prefix, key, &max_bits) == FALSE))
+		return FALSE;
+
+	return pzradix_tree_remove_key (tree, key, max_bits, prefix_len);
+}
+
+P_LIB_API pboolean
+zradix_tree_remove_native (PRadixTree	*tree,
+			   pconstpointer	native,
+			   psize		len,
+			   puint		prefix_len)
+{
+	puchar	key[P_RADIX_TREE_MAX_KEY];
+	puint	max_bits;
+
+	if (P_UNLIKELY (tree == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (pzradix_tree_native_to_key (native, len, key, &max_bits) == FALSE))
+		return FALSE;
+
+	return pzradix_tree_remove_key (tree, key, max_bits, prefix_len);
+}
+
+P_LIB_API ppointer
+zradix_tree_lookup (const PRadixTree	*tree,
+		    const PSocketAddress	*addr,
+		    puint		*prefix_len)
+{
+	puchar	key[P_RADIX_TREE_MAX_KEY];
+	puint	max_bits;
+
+	if (P_UNLIKELY (tree == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (pzradix_tree_addr_to_key (addr, key, &max_bits) == FALSE))
+		return NULL;
+
+	return pzradix_tree_lookup_key (tree, key, max_bits, prefix_len);
+}
+
+P_LIB_API ppointer
+zradix_tree_lookup_native (const PRadixTree	*tree,
+			   pconstpointer	native,
+			   psize		len,
+			   puint		*prefix_len)
+{
+	puchar	key[P_RADIX_TREE_MAX_KEY];
+	puint	max_bits;
+
+	if (P_UNLIKELY (tree == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (pzradix_tree_native_to_key (native, len, key, &max_bits) == FALSE))
+		return NULL;
+
+	return pzradix_tree_lookup_key (tree, key, max_bits, prefix_len);
+}
+
+P_LIB_API psize
+zradix_tree_get_nprefixes (const PRadixTree *tree)
+{
+	if (P_UNLIKELY (tree == NULL))
+		return 0;
+
+	return tree->nprefixes;
+}
+
+P_LIB_API void
+zradix_tree_clear (PRadixTree *tree)
+{
+	if (P_UNLIKELY (tree == NULL))
+		return;
+
+	pzradix_tree_node_free (tree, tree->root4);
+	pzradix_tree_node_free (tree, tree->root6);
+
+	tree->root4     = NULL;
+	tree->root6     = NULL;
+	tree->nprefixes = 0;
+}
+
+P_LIB_API void
+zradix_tree_free (PRadixTree *tree)
+{
+	if (P_UNLIKELY (tree == NULL))
+		return;
+
+	zradix_tree_clear (tree);
+	zfree (tree);
+}
@@ -0,0 +1,560 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Lock-free skip list is based on the algorithm from "The Art of
+ * Multiprocessor Programming" by M. Herlihy and N. Shavit. A node is removed
+ * logically by setting the lowest bit of its next pointers (starting from the
+ * top level), and then unlinked physically by any thread which walks through
+ * it.
+ *
+ * Every operation runs inside an epoch critical section (see pepoch.c), and
+ * a removed node is retired into the limbo list of the skip list once it is
+ * not reachable anymore. It is freed after all the threads which could have
+ * seen it have left their critical sections.
+ *
+ * A node can be removed while its inserter is still linking the upper levels,
+ * and a late link could make it reachable again. So the node is retired by
+ * whichever of the two operations finishes last, after unlinking it once
+ * more. */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "pskiplist.h"
+#include "pepoch-private.h"
+#include "phashfunc-private.h"
+
+#define P_SKIP_LIST_MAX_HEIGHT	16
+#define P_SKIP_LIST_MARK	((puintptr) 1)
+#define P_SKIP_LIST_LINKING	0x1U
+#define P_SKIP_LIST_REMOVED	0x2U
+#define P_SKIP_LIST_RECLAIM_AT	64
+
+#define P_SKIP_LIST_IS_MARKED(ptr)	((((puintptr) (ptr)) & P_SKIP_LIST_MARK) != 0)
+#define P_SKIP_LIST_UNMARK(ptr)		((PSkipListNode *) (((puintptr) (ptr)) & ~P_SKIP_LIST_MARK))
+
+typedef struct PSkipListNode_ PSkipListNode;
+
+struct PSkipListNode_ {
+	PEpochEntry	epoch_entry;
+	ppointer	key;
+	ppointer	value;
+	volatile puint	state;
+	puint		height;
+	ppointer	next[1];
+};
+
+struct PSkipList_ {
+	PSkipListNode	*head;
+	PCompareDataFunc	compare_func;
+	ppointer	data;
+	PDestroyFunc	key_destroy_func;
+	PDestroyFunc	value_destroy_func;
+	volatile pint	nnodes;
+	volatile pint	seed;
+	PEpochLimbo	limbo;
+};
+
+static pint pzskip_list_compare_keys (pconstpointer a, pconstpointer b, ppointer data);
+static PSkipListNode * pzskip_list_node_new (puint height);
+static void pzskip_list_node_free (PSkipList *list, PSkipListNode *node);
+static puint pzskip_list_random_height (PSkipList *list);
+static void pzskip_list_node_reclaim (PEpochEntry *entry, ppointer list);
+static void pzskip_list_release (PSkipList *list, PSkipListNode *node, puint flag);
+static pboolean pzskip_list_find (PSkipList *list, pconstpointer key, PSkipListNode **preds, PSkipListNode **succs);
+static void pzskip_list_unlink (PSkipList *list, pconstpointer key);
+static PSkipListNode * pzskip_list_lower_bound (PSkipList *list, pconstpointer key, pboolean use_key);
+static void pzskip_list_traverse (PSkipList *list, pconstpointer from, pconstpointer to, pboolean use_range, PTraverseFunc traverse_func, ppointer user_data);
+
+static pint
+pzskip_list_compare_keys (pconstpointer	a,
+			  pconstpointer	b,
+			  ppointer	data)
+{
+	return ((PCompareFunc) data) (a, b);
+}
+
+static PSkipListNode *
+pzskip_list_node_new (puint height)
+{
+	return zmalloc0 (sizeof (PSkipListNode) + (height - 1) * sizeof (ppointer));
+}
+
+static void
+pzskip_list_node_free (PSkipList	*list,
+		       PSkipListNode	*node)
+{
+	if (list->key_destroy_func != NULL)
+		list->key_destroy_func (node->key);
+
+	if (list->value_destroy_func != NULL)
+		list->value_destroy_func (node->value);
+
+	zfree (node);
+}
+
+static puint
+pzskip_list_random_height (PSkipList *list)
+{
+	puint64	rnd;
+	puint	height;
+
+	rnd    = zhash_func_mix64 ((puint64) (puint) zatomic_int_add (&list->seed, 1));
+	height = 1;
+
+	/* Each level keeps a quarter of the nodes from the level below */
+	while ((rnd & 3) == 0 && height < P_SKIP_LIST_MAX_HEIGHT) {
+		rnd >>= 2;
+		++height;
+	}
+
+	return height;
+}
+
+static void
+pzskip_list_node_reclaim (PEpochEntry	*entry,
+			  ppointer	list)
+{
+	pzskip_list_node_free ((PSkipList *) list, (PSkipListNode *) entry);
+}
+
+/* Drops the linking or the removing side of the node, the last one retires
+ * the node (the remover has already unlinked it) */
+static void
+pzskip_list_release (PSkipList		*list,
+		     PSkipListNode	*node,
+		     puint		flag)
+{
+	if (flag == P_SKIP_LIST_LINKING) {
+		if ((zatomic_int_and (&node->state, ~P_SKIP_LIST_LINKING) & P_SKIP_LIST_REMOVED) == 0)
+			return;
+
+		/* The node has been removed while linking */
+		pzskip_list_unlink (list, node->key);
+	} else if ((zatomic_int_or (&node->state, P_SKIP_LIST_REMOVED) & P_SKIP_LIST_LINKING) != 0)
+		return;
+
+	zepoch_retire (&list->limbo, &node->epoch_entry);
+}
+
+/* Finds predecessors and successors for the key on every level, unlinking all
+ * the removed nodes along the way. Successor on the bottom level is the first
+ * node with the key greater or equal to the given one. */
+static pboolean
+pzskip_list_find (PSkipList		*list,
+		  pconstpointer		key,
+		  PSkipListNode		**preds,
+		  PSkipListNode		**succs)
+{
+	PSkipListNode	*pred;
+	PSkipListNode	*curr;
+	ppointer	succ;
+	pint		level;
+
+retry:
+	pred = list->head;
+
+	for (level = P_SKIP_LIST_MAX_HEIGHT - 1; level >= 0; --level) {
+		curr = P_SKIP_LIST_UNMARK (zatomic_pointer_get (&pred->next[level]));
+
+		while (curr != NULL) {
+			succ = zatomic_pointer_get (&curr->next[level]);
+
+			while (P_SKIP_LIST_IS_MARKED (succ)) {
+				if (zatomic_pointer_compare_and_exchange (&pred->next[level],
+									  curr,
+									  P_SKIP_LIST_UNMARK (succ)) == FALSE)
+					goto retry;
+
+				curr = P_SKIP_LIST_UNMARK (succ);
+
+				if (curr == NULL)
+					break;
+
+				succ = zatomic_pointer_get (&curr->next[level]);
+			}
+
+			if (curr == NULL || list->compare_func (curr->key, key, list->data) >= 0)
+				break;
+
+			pred = curr;
+			curr = succ;
+		}
+
+		preds[level] = pred;
+		succs[level] = curr;
+	}
+
+	return succs[0] != NULL && list->compare_func (succs[0]->key, key, list->data) == 0;
+}
+
+static void
+pzskip_list_unlink (PSkipList		*list,
+		    pconstpointer	key)
+{
+	PSkipListNode *preds[P_SKIP_LIST_MAX_HEIGHT];
+	PSkipListNode *succs[P_SKIP_LIST_MAX_HEIGHT];
+
+	pzskip_list_find (list, key, preds, succs);
+}
+
+/* Read-only search which skips removed nodes without unlinking them */
+static PSkipListNode *
+pzskip_list_lower_bound (PSkipList	*list,
+			 pconstpointer	key,
+			 pboolean	use_key)
+{
+	PSkipListNode	*pred;
+	PSkipListNode	*curr;
+	ppointer	succ;
+	pint		level;
+
+	pred = list->head;
+	curr = NULL;
+
+	for (level = use_key ? P_SKIP_LIST_MAX_HEIGHT - 1 : 0; level >= 0; --level) {
+		curr = P_SKIP_LIST_UNMARK (zatomic_pointer_get (&pred->next[level]));
+
+		while (curr != NULL) {
+			succ = zatomic_pointer_get (&curr->next[level]);
+
+			if (P_SKIP_LIST_IS_MARKED (succ)) {
+				curr = P_SKIP_LIST_UNMARK (succ);
+				continue;
+			}
+
+			if (!use_key || list->compare_func (curr->key, key, list->data) >= 0)
+				break;
+
+			pred = curr;
+			curr = succ;
+		}
+	}
+
+	return curr;
+}
+
+static void
+pzskip_list_traverse (PSkipList		*list,
+		      pconstpointer	from,
+		      pconstpointer	to,
+		      pboolean		use_range,
+		      PTraverseFunc	traverse_func,
+		      ppointer		user_data)
+{
+	PEpochRecord	*record;
+	PSkipListNode	*curr;
+	ppointer	succ;
+
+	record = zepoch_enter ();
+
+	curr = pzskip_list_lower_bound (list, from, use_range);
+
+	while (curr != NULL) {
+		succ = zatomic_pointer_get (&curr->next[0]);
+
+		if (!P_SKIP_LIST_IS_MARKED (succ)) {
+			if (use_range && list->compare_func (curr->key, to, list->data) >= 0)
+				break;
+
+			if (traverse_func (curr->key, curr->value, user_data) == TRUE)
+				break;
+		}
+
+		curr = P_SKIP_LIST_UNMARK (succ);
+	}
+
+	zepoch_leave (record);
+}
+
+P_LIB_API PSkipList *
+zskip_list_new (PCompareFunc func)
+{
+	return zskip_list_new_full ((PCompareDataFunc) pzskip_list_compare_keys,
+				    (ppointer) func,
+				    NULL,
+				    NULL);
+}
+
+P_LIB_API PSkipList *
+zskip_list_new_with_data (PCompareDataFunc	func,
+			  ppointer		data)
+{
+	return zskip_list_new_full (func, data, NULL, NULL);
+}
+
+P_LIB_API PSkipList *
+zskip_list_new_full (PCompareDataFunc	func,
+		     ppointer		data,
+		     PDestroyFunc	key_destroy,
+		     PDestroyFunc	value_destroy)
+{
+	PSkipList *ret;
+
+	if (P_UNLIKELY (func == NULL || (func == pzskip_list_compare_keys && data == NULL)))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PSkipList))) == NULL)) {
+		P_ERROR ("PSkipList::zskip_list_new_full: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->head = pzskip_list_node_new (P_SKIP_LIST_MAX_HEIGHT)) == NULL)) {
+		P_ERROR ("PSkipList::zskip_list_new_full: failed(2) to allocate memory");
+		zfree (ret);
+		return NULL;
+	}
+
+	ret->head->height       = P_SKIP_LIST_MAX_HEIGHT;
+	ret->compare_func       = func;
+	ret->data               = data;
+	ret->key_destroy_func   = key_destroy;
+	ret->value_destroy_func = value_destroy;
+
+	zepoch_limbo_init (&ret->limbo, P_SKIP_LIST_RECLAIM_AT, pzskip_list_node_reclaim, ret);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+zskip_list_insert (PSkipList	*list,
+		   ppointer	key,
+		   ppointer	value)
+{
+	PSkipListNode	*preds[P_SKIP_LIST_MAX_HEIGHT];
+	PSkipListNode	*succs[P_SKIP_LIST_MAX_HEIGHT];
+	PEpochRecord	*record;
+	PSkipListNode	*node;
+	PSkipListNode	*succ;
+	ppointer	old_next;
+	puint		height;
+	puint		level;
+
+	if (P_UNLIKELY (list == NULL))
+		return FALSE;
+
+	node = NULL;
+
+	record = zepoch_enter ();
+
+	while (TRUE) {
+		if (pzskip_list_find (list, key, preds, succs) == TRUE) {
+			if (node != NULL)
+				zfree (node);
+
+			zepoch_leave (record);
+			return FALSE;
+		}
+
+		if (node == NULL) {
+			height = pzskip_list_random_height (list);
+
+			if (P_UNLIKELY ((node = pzskip_list_node_new (height)) == NULL)) {
+				P_ERROR ("PSkipList::zskip_list_insert: failed(1) to allocate memory");
+				zepoch_leave (record);
+				return FALSE;
+			}
+
+			node->key    = key;
+			node->value  = value;
+			node->height = height;
+			node->state  = P_SKIP_LIST_LINKING;
+		}
+
+		for (level = 0; level < node->height; ++level)
+			node->next[level] = succs[level];
+
+		/* Linking on the bottom level makes the node visible */
+		if (zatomic_pointer_compare_and_exchange (&preds[0]->next[0], succs[0], node) == TRUE)
+			break;
+	}
+
+	zatomic_int_inc (&list->nnodes);
+
+	if (succs[0] != NULL && P_SKIP_LIST_IS_MARKED (zatomic_pointer_get (&succs[0]->next[0])))
+		pzskip_list_unlink (list, succs[0]->key);
+
+	for (level = 1; level < node->height; ++level) {
+		while (TRUE) {
+			succ     = succs[level];
+			old_next = zatomic_pointer_get (&node->next[level]);
+
+			/* Node is being removed, stop linking it */
+			if (P_SKIP_LIST_IS_MARKED (old_next))
+				goto out;
+
+			if (old_next != succ &&
+			    zatomic_pointer_compare_and_exchange (&node->next[level], old_next, succ) == FALSE)
+				goto out;
+
+			if (zatomic_pointer_compare_and_exchange (&preds[level]->next[level], succ, node) == TRUE)
+				break;
+
+			if (pzskip_list_find (list, key, preds, succs) == FALSE || succs[0] != node)
+				goto out;
+		}
+
+		/* The node or its successor could be removed while linking, make sure
+		 * that the removed one is not reachable through the new link */
+		if (P_SKIP_LIST_IS_MARKED (zatomic_pointer_get (&node->next[level]))) {
+			pzskip_list_unlink (list, key);
+			goto out;
+		}
+
+		if (succ != NULL && P_SKIP_LIST_IS_MARKED (zatomic_pointer_get (&succ->next[level])))
+			pzskip_list_unlink (list, succ->key);
+	}
+
+out:
+	pzskip_list_release (list, node, P_SKIP_LIST_LINKING);
+
+	zepoch_leave (record);
+	zepoch_reclaim (&list->limbo);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+zskip_list_remove (PSkipList		*list,
+		   pconstpointer	key)
+{
+	PSkipListNode	*preds[P_SKIP_LIST_MAX_HEIGHT];
+	PSkipListNode	*succs[P_SKIP_LIST_MAX_HEIGHT];
+	PEpochRecord	*record;
+	PSkipListNode	*node;
+	psize		old_next;
+	pint		level;
+
+	if (P_UNLIKELY (list == NULL))
+		return FALSE;
+
+	record = zepoch_enter ();
+
+	if (pzskip_list_find (list, key, preds, succs) == FALSE) {
+		zepoch_leave (record);
+		return FALSE;
+	}
+
+	node = succs[0];
+
+	for (level = (pint) node->height - 1; level > 0; --level)
+		zatomic_pointer_or (&node->next[level], P_SKIP_LIST_MARK);
+
+	old_next = zatomic_pointer_or (&node->next[0], P_SKIP_LIST_MARK);
+
+	/* Another thread has removed the node first */
+	if (P_SKIP_LIST_IS_MARKED (old_next)) {
+		zepoch_leave (record);
+		return FALSE;
+	}
+
+	zatomic_int_add (&list->nnodes, -1);
+
+	pzskip_list_unlink (list, node->key);
+	pzskip_list_release (list, node, P_SKIP_LIST_REMOVED);
+
+	zepoch_leave (record);
+	zepoch_reclaim (&list->limbo);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+zskip_list_lookup (PSkipList		*list,
+		   pconstpointer	key,
+		   ppointer		*value)
+{
+	PEpochRecord	*record;
+	PSkipListNode	*node;
+	pboolean	ret;
+
+	if (P_UNLIKELY (list == NULL))
+		return FALSE;
+
+	record = zepoch_enter ();
+
+	node = pzskip_list_lower_bound (list, key, TRUE);
+	ret  = node != NULL && list->compare_func (node->key, key, list->data) == 0;
+
+	if (ret == TRUE && value != NULL)
+		*value = node->value;
+
+	zepoch_leave (record);
+
+	return ret;
+}
+
+P_LIB_API void
+zskip_list_foreach (PSkipList		*list,
+		    PTraverseFunc	traverse_func,
+		    ppointer		user_data)
+{
+	if (P_UNLIKELY (list == NULL || traverse_func == NULL))
+		return;
+
+	pzskip_list_traverse (list, NULL, NULL, FALSE, traverse_func, user_data);
+}
+
+P_LIB_API void
+zskip_list_foreach_range (PSkipList		*list,
+			  pconstpointer		from,
+			  pconstpointer		to,
+			  PTraverseFunc		traverse_func,
+			  ppointer		user_data)
+{
+	if (P_UNLIKELY (list == NULL || traverse_func == NULL))
+		return;
+
+	pzskip_list_traverse (list, from, to, TRUE, traverse_func, user_data);
+}
+
+P_LIB_API pint
+zskip_list_get_nnodes (const PSkipList *list)
+{
+	if (P_UNLIKELY (list == NULL))
+		return 0;
+
+	return zatomic_int_get (&list->nnodes);
+}
+
+P_LIB_API void
+zskip_list_free (PSkipList *list)
+{
+	PSkipListNode	*node;
+	PSkipListNode	*next;
+
+	if (P_UNLIKELY (list == NULL))
+		return;
+
+	/* There are no removed nodes left on the bottom level */
+	for (node = list->head->next[0]; node != NULL; node = next) {
+		next = node->next[0];
+		pzskip_list_node_free (list, node);
+	}
+
+	zepoch_limbo_flush (&list->limbo);
+
+	zfree (list->head);
+	zfree (list);
+}
@@ -0,0 +1,305 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* String interning pool.
+ *
+ * Every distinct string is stored exactly once in arena chunks which are
+ * never freed until the library shutdown, so the returned pointers stay valid
+ * and can be compared directly. The pool is split into several shards by the
+ * hash value, each shard has its own lock, open addressing hash table and
+ * arena, so concurrent callers rarely contend for the same lock.
+ */
+
+#include "pmem.h"
+#include "pspinlock.h"
+#include "pstring.h"
+#include "phashfunc-private.h"
+
+#include <string.h>
+
+#define P_STR_INTERN_SHARD_BITS		4
+#define P_STR_INTERN_SHARDS		(1 << P_STR_INTERN_SHARD_BITS)
+#define P_STR_INTERN_MIN_SLOTS		64
+#define P_STR_INTERN_CHUNK_SIZE		4096
+#define P_STR_INTERN_HASH_SEED		0x9E3779B97F4A7C15ULL
+
+typedef struct PStrInternChunk_ {
+	struct PStrInternChunk_	*next;
+	psize			used;
+	psize			size;
+} PStrInternChunk;
+
+typedef struct PStrInternSlot_ {
+	const pchar	*str;
+	psize		len;
+	puint64		hash;
+} PStrInternSlot;
+
+typedef struct PStrInternShard_ {
+	PSpinLock	*lock;
+	PStrInternSlot	*slots;
+	psize		nslots;
+	psize		nused;
+	PStrInternChunk	*chunks;
+} PStrInternShard;
+
+static PStrInternShard pz_str_intern_shards[P_STR_INTERN_SHARDS];
+
+static PStrInternShard * pzstr_intern_get_shard (puint64 hash);
+static PStrInternSlot * pzstr_intern_find (const PStrInternShard *shard, const pchar *str, psize len, puint64 hash);
+static pboolean pzstr_intern_grow (PStrInternShard *shard);
+static pchar * pzstr_intern_store (PStrInternShard *shard, const pchar *str, psize len);
+
+static PStrInternShard *
+pzstr_intern_get_shard (puint64 hash)
+{
+	return &pz_str_intern_shards[hash >> (64 - P_STR_INTERN_SHARD_BITS)];
+}
+
+/* Returns either the slot with the given string or an empty slot where it
+ * should be placed */
+static PStrInternSlot *
+pzstr_intern_find (const PStrInternShard	*shard,
+		   const pchar			*str,
+		   psize			len,
+		   puint64			hash)
+{
+	PStrInternSlot	*slot;
+	psize		mask;
+	psize		index;
+
+	mask  = shard->nslots - 1;
+	index = (psize) hash & mask;
+
+	while (TRUE) {
+		slot = &shard->slots[index];
+
+		if (slot->str == NULL)
+			return slot;
+
+		if (slot->hash == hash && slot->len == len && memcmp (slot->str, str, len) == 0)
+			return slot;
+
+		index = (index + 1) & mask;
+	}
+}
+
+static pboolean
+pzstr_intern_grow (PStrInternShard *shard)
+{
+	PStrInternSlot	*old_slots;
+	PStrInternSlot	*slot;
+	psize		old_nslots;
+	psize		new_nslots;
+	psize		i;
+
+	old_slots  = shard->slots;
+	old_nslots = shard->nslots;
+	new_nslots = old_nslots == 0 ? P_STR_INTERN_MIN_SLOTS : old_nslots * 2;
+
+	if (P_UNLIKELY ((shard->slots = zmalloc0 (new_nslots * sizeof (PStrInternSlot))) == NULL)) {
+		shard->slots = old_slots;
+		return FALSE;
+	}
+
+	shard->nslots = new_nslots;
+
+	for (i = 0; i < old_nslots; ++i) {
+		if (old_slots[i].str == NULL)
+			continue;
+
+		slot  = pzstr_intern_find (shard, old_slots[i].str, old_slots[i].len, old_slots[i].hash);
+		*slot = old_slots[i];
+	}
+
+	zfree (old_slots);
+
+	return TRUE;
+}
+
+static pchar *
+pzstr_intern_store (PStrInternShard	*shard,
+		    const pchar		*str,
+		    psize		len)
+{
+	PStrInternChunk	*chunk;
+	pboolean	dedicated;
+	psize		size;
+	pchar		*ret;
+
+	chunk = shard->chunks;
+
+	if (chunk == NULL || chunk->size - chunk->used < len + 1) {
+		/* Long strings get their own chunk to not waste the current one */
+		dedicated = (len + 1 > P_STR_INTERN_CHUNK_SIZE / 4);
+		size      = dedicated ? len + 1 : P_STR_INTERN_CHUNK_SIZE;
+
+		if (P_UNLIKELY ((chunk = zmalloc (sizeof (PStrInternChunk) + size)) == NULL))
+			return NULL;
+
+		chunk->used = 0;
+		chunk->size = size;
+
+		if (dedicated && shard->chunks != NULL) {
+			chunk->next         = shard->chunks->next;
+			shard->chunks->next = chunk;
+		} else {
+			chunk->next   = shard->chunks;
+			shard->chunks = chunk;
+		}
+	}
+
+	ret = ((pchar *) (chunk + 1)) + chunk->used;
+
+	memcpy (ret, str, len);
+	ret[len] = '\0';
+
+	chunk->used += len + 1;
+
+	return ret;
+}
+
+void
+zstr_intern_init (void)
+{
+	pint i;
+
+	for (i = 0; i < P_STR_INTERN_SHARDS; ++i) {
+		if (P_LIKELY (pz_str_intern_shards[i].lock == NULL))
+			pz_str_intern_shards[i].lock = zspinlock_new ();
+	}
+}
+
+void
+zstr_intern_shutdown (void)
+{
+	PStrInternChunk	*chunk;
+	PStrInternChunk	*next;
+	pint		i;
+
+	for (i = 0; i < P_STR_INTERN_SHARDS; ++i) {
+		for (chunk = pz_str_intern_shards[i].chunks; chunk != NULL; chunk = next) {
+			next = chunk->next;
+			zfree (chunk);
+		}
+
+		if (pz_str_intern_shards[i].lock != NULL)
+			zspinlock_free (pz_str_intern_shards[i].lock);
+
+		zfree (pz_str_intern_shards[i].slots);
+
+		memset (&pz_str_intern_shards[i], 0, sizeof (PStrInternShard));
+	}
+}
+
+P_LIB_API const pchar *
+zstr_intern (const pchar *str)
+{
+	if (P_UNLIKELY (str == NULL))
+		return NULL;
+
+	return zstr_intern_len (str, strlen (str));
+}
+
+P_LIB_API const pchar *
+zstr_intern_len (const pchar	*str,
+		 psize		len)
+{
+	PStrInternShard	*shard;
+	PStrInternSlot	*slot;
+	const pchar	*ret;
+	puint64		hash;
+
+	if (P_UNLIKELY (str == NULL || len > P_MAXSIZE - sizeof (PStrInternChunk) - 1))
+		return NULL;
+
+	hash  = zhash_func_bytes (str, len, P_STR_INTERN_HASH_SEED);
+	shard = pzstr_intern_get_shard (hash);
+
+	if (P_UNLIKELY (shard->lock == NULL))
+		return NULL;
+
+	zspinlock_lock (shard->lock);
+
+	/* Keep the load factor under 1/2 */
+	if (P_UNLIKELY ((shard->nused + 1) * 2 > shard->nslots)) {
+		if (P_UNLIKELY (pzstr_intern_grow (shard) == FALSE)) {
+			zspinlock_unlock (shard->lock);
+			P_ERROR ("PString::zstr_intern_len: failed(1) to allocate memory");
+			return NULL;
+		}
+	}
+
+	slot = pzstr_intern_find (shard, str, len, hash);
+
+	if (slot->str == NULL) {
+		if (P_UNLIKELY ((slot->str = pzstr_intern_store (shard, str, len)) == NULL)) {
+			zspinlock_unlock (shard->lock);
+			P_ERROR ("PString::zstr_intern_len: failed(2) to allocate memory");
+			return NULL;
+		}
+
+		slot->len  = len;
+		slot->hash = hash;
+
+		++shard->nused;
+	}
+
+	ret = slot->str;
+
+	zspinlock_unlock (shard->lock);
+
+	return ret;
+}
+
+P_LIB_API const pchar *
+zstr_intern_lookup (const pchar *str)
+{
+	PStrInternShard	*shard;
+	const pchar	*ret;
+	puint64		hash;
+	psize		len;
+
+	if (P_UNLIKELY (str == NULL))
+		return NULL;
+
+	len   = strlen (str);
+	hash  = zhash_func_bytes (str, len, P_STR_INTERN_HASH_SEED);
+	shard = pzstr_intern_get_shard (hash);
+
+	if (P_UNLIKELY (shard->lock == NULL))
+		return NULL;
+
+	zspinlock_lock (shard->lock);
+
+	if (shard->nslots == 0)
+		ret = NULL;
+	else
+		ret = pzstr_intern_find (shard, str, len, hash)->str;
+
+	zspinlock_unlock (shard->lock);
+
+	return ret;
+}
@@ -30,8 +30,6 @@
 #include <string.h>
 #include <ctype.h>
 
-#define P_STR_MAX_EXPON		308
-
 P_LIB_API pchar *
 zstrdup (const pchar *str)
 {
@@ -51,6 +49,27 @@ zstrdup (const pchar *str)
 	return ret;
 }
 
+P_LIB_API pchar *
+zstrndup (const pchar	*str,
+	  psize		len)
+{
+	pchar	*ret;
+
+	if (P_UNLIKELY (str == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (len == P_MAXSIZE))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = zmalloc (len + 1)) == NULL))
+		return NULL;
+
+	memcpy (ret, str, len);
+	ret[len] = '\0';
+
+	return ret;
+}
+
 P_LIB_API pchar *
 zstrchomp (const pchar *str)
 {
@@ -91,6 +110,114 @@ zstrchomp (const pchar *str)
 	return ret;
 }
 
+P_LIB_API const pchar *
+zstrchomp_span (const pchar	*str,
+		psize		len,
+		psize		*span_len)
+{
+	const pchar	*end;
+
+	if (P_UNLIKELY (str == NULL)) {
+		if (span_len != NULL)
+			*span_len = 0;
+
+		return NULL;
+	}
+
+	end = str + len;
+
+	while (str < end && isspace (* ((const puchar *) str)))
+		++str;
+
+	while (end > str && isspace (* ((const puchar *) (end - 1))))
+		--end;
+
+	if (span_len != NULL)
+		*span_len = (psize) (end - str);
+
+	return str;
+}
+
+P_LIB_API pchar *
+zstrchomp_inplace (pchar *str)
+{
+	pchar	*ret;
+	psize	len;
+
+	if (P_UNLIKELY (str == NULL))
+		return NULL;
+
+	ret = (pchar *) zstrchomp_span (str, strlen (str), &len);
+	ret[len] = '\0';
+
+	return ret;
+}
+
+P_LIB_API const pchar *
+zstrtok_span (const pchar	**str,
+	      psize		*len,
+	      const pchar	*delim,
+	      psize		*token_len)
+{
+	puint32		table[256 / 32];
+	const pchar	*ptr;
+	const pchar	*end;
+	const pchar	*ret;
+	puchar		ch;
+
+	if (token_len != NULL)
+		*token_len = 0;
+
+	if (P_UNLIKELY (str == NULL || *str == NULL || len == NULL || delim == NULL))
+		return NULL;
+
+	memset (table, 0, sizeof (table));
+
+	for (; *delim != '\0'; ++delim) {
+		ch = (puchar) *delim;
+		table[ch >> 5] |= ((puint32) 1) << (ch & 31);
+	}
+
+	ptr = *str;
+	end = *str + *len;
+
+	/* Skip leading delimiters */
+	while (ptr < end) {
+		ch = (puchar) *ptr;
+
+		if ((table[ch >> 5] & (((puint32) 1) << (ch & 31))) == 0)
+			break;
+
+		++ptr;
+	}
+
+	if (ptr == end) {
+		*str = end;
+		*len = 0;
+
+		return NULL;
+	}
+
+	ret = ptr;
+
+	while (ptr < end) {
+		ch = (puchar) *ptr;
+
+		if ((table[ch >> 5] & (((puint32) 1) << (ch & 31))) != 0)
+			break;
+
+		++ptr;
+	}
+
+	if (token_len != NULL)
+		*token_len = (psize) (ptr - ret);
+
+	*len -= (psize) (ptr - *str);
+	*str  = ptr;
+
+	return ret;
+}
+
 P_LIB_API pchar *
 zstrtok (pchar *str, const pchar *delim, pchar **buf)
 {
@@ -118,89 +245,3 @@ zstrtok (pchar *str, const pchar *delim, pchar **buf)
 	return strtok_r (str, delim, buf);
 #endif
 }
-
-P_LIB_API double
-zstrtod (const pchar *str)
-{
-	double	sign;
-	double	value;
-	double	scale;
-	double	pow10;
-	puint	expon;
-	pint	frac;
-	pchar	*orig_str, *strp;
-
-	orig_str = zstrchomp (str);
-
-	if (P_UNLIKELY (orig_str == NULL))
-		return 0.0;
-
-	strp = orig_str;
-	sign = 1.0;
-
-	if (*strp == '-') {
-		sign = -1.0;
-		strp += 1;
-	} else if (*strp == '+')
-		strp += 1;
-
-	/* Get digits before decimal point or exponent, if any */
-	for (value = 0.0; isdigit ((pint) *strp); strp += 1)
-		value = value * 10.0 + (*strp - '0');
-
-	/* Get digits after decimal point, if any */
-	if (*strp == '.') {
-		pow10 = 10.0;
-		strp += 1;
-
-		while (isdigit ((pint) *strp)) {
-			value += (*strp - '0') / pow10;
-			pow10 *= 10.0;
-			strp += 1;
-		}
-	}
-
-	/* Handle exponent, if any */
-	frac  = 0;
-	scale = 1.0;
-
-	if ((*strp == 'e') || (*strp == 'E')) {
-		/* Get sign of exponent, if any */
-		strp += 1;
-
-		if (*strp == '-') {
-			frac = 1;
-			strp += 1;
-
-		} else if (*strp == '+')
-			strp += 1;
-
-		/* Get digits of exponent, if any */
-		for (expon = 0; isdigit ((pint) *strp); strp += 1)
-			expon = expon * 10 + (puint) ((*strp - '0'));
-
-		if (P_UNLIKELY (expon > P_STR_MAX_EXPON))
-			expon = P_STR_MAX_EXPON;
-
-		/* Calculate scaling factor */
-		while (expon >= 50) {
-			scale *= 1e50;
-			expon -= 50;
-		}
-
-		while (expon >= 8) {
-			scale *= 1e8;
-			expon -= 8;
-		}
-
-		while (expon > 0) {
-			scale *= 10.0;
-			expon -= 1;
-		}
-	}
-
-	zfree (orig_str);
-
-	/* Return signed and scaled floating point result */
-	return sign * (frac ? (value / scale) : (value * scale));
-}
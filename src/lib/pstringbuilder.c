@@ -0,0 +1,312 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pstring.h"
+#include "pstringbuilder.h"
+
+#include <string.h>
+
+#define P_STRING_BUILDER_MIN_CAPACITY	32
+
+struct PStringBuilder_ {
+	pchar	*str;
+	psize	len;
+	psize	capacity;
+};
+
+static pboolean pzstring_builder_grow (PStringBuilder *builder, psize len);
+
+static pboolean
+pzstring_builder_grow (PStringBuilder	*builder,
+		       psize		len)
+{
+	pchar	*str;
+	psize	needed;
+	psize	capacity;
+
+	/* Current string + new characters + trailing zero */
+	if (P_UNLIKELY (len > P_MAXSIZE - builder->len - 1))
+		return FALSE;
+
+	needed = builder->len + len + 1;
+
+	if (P_LIKELY (needed <= builder->capacity))
+		return TRUE;
+
+	capacity = builder->capacity < P_STRING_BUILDER_MIN_CAPACITY ? P_STRING_BUILDER_MIN_CAPACITY
+								      : builder->capacity;
+
+	while (capacity < needed) {
+		if (capacity > P_MAXSIZE / 2) {
+			capacity = needed;
+			break;
+		}
+
+		capacity <<= 1;
+	}
+
+	if (P_UNLIKELY ((str = zrealloc (builder->str, capacity)) == NULL)) {
+		P_ERROR ("PStringBuilder::pzstring_builder_grow: failed(1) to allocate memory");
+		return FALSE;
+	}
+
+	if (builder->str == NULL)
+		str[0] = '\0';
+
+	builder->str      = str;
+	builder->capacity = capacity;
+
+	return TRUE;
+}
+
+P_LIB_API PStringBuilder *
+zstring_builder_new (psize reserve)
+{
+	PStringBuilder *ret;
+
+	if (P_UNLIKELY ((ret = zmalloc0 (sizeof (PStringBuilder))) == NULL)) {
+		P_ERROR ("PStringBuilder::zstring_builder_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pzstring_builder_grow (ret, reserve) == FALSE)) {
+		zfree (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+zstring_builder_reserve (PStringBuilder	*builder,
+			 psize		len)
+{
+	if (P_UNLIKELY (builder == NULL))
+		return FALSE;
+
+	return pzstring_builder_grow (builder, len);
+}
+
+P_LIB_API pboolean
+zstring_builder_append (PStringBuilder	*builder,
+			const pchar	*str)
+{
+	if (P_UNLIKELY (str == NULL))
+		return FALSE;
+
+	return zstring_builder_append_len (builder, str, strlen (str));
+}
+
+P_LIB_API pboolean
+zstring_builder_append_len (PStringBuilder	*builder,
+			    const pchar		*data,
+			    psize		len)
+{
+	if (P_UNLIKELY (builder == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	if (P_UNLIKELY (pzstring_builder_grow (builder, len) == FALSE))
+		return FALSE;
+
+	if (len > 0)
+		memcpy (builder->str + builder->len, data, len);
+
+	builder->len += len;
+	builder->str[builder->len] = '\0';
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+zstring_builder_append_char (PStringBuilder	*builder,
+			     pchar		c)
+{
+	if (P_UNLIKELY (builder == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (pzstring_builder_grow (builder, 1) == FALSE))
+		return FALSE;
+
+	builder->str[builder->len++] = c;
+	builder->str[builder->len]   = '\0';
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+zstring_builder_append_int64 (PStringBuilder	*builder,
+			      pint64		val)
+{
+	pchar	buf[P_STR_INT64_BUF_SIZE];
+	psize	len;
+
+	len = zstr_from_int64 (val, buf, sizeof (buf));
+
+	return zstring_builder_append_len (builder, buf, len);
+}
+
+P_LIB_API pboolean
+zstring_builder_append_uint64 (PStringBuilder	*builder,
+			       puint64		val)
+{
+	pchar	buf[P_STR_INT64_BUF_SIZE];
+	psize	len;
+
+	len = zstr_from_uint64 (val, buf, sizeof (buf));
+
+	return zstring_builder_append_len (builder, buf, len);
+}
+
+P_LIB_API pboolean
+zstring_builder_append_double (PStringBuilder	*builder,
+			       double		val)
+{
+	pchar	buf[P_STR_DOUBLE_BUF_SIZE];
+	psize	len;
+
+	len = zstr_from_double (val, buf, sizeof (buf));
+
+	return zstring_builder_append_len (builder, buf, len);
+}
+
+P_LIB_API pboolean
+zstring_builder_append_printf (PStringBuilder	*builder,
+			       const pchar	*format,
+			       ...)
+{
+	zva_list	args;
+	pboolean	ret;
+
+	zva_start (args, format);
+	ret = zstring_builder_append_vprintf (builder, format, args);
+	zva_end (args);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+zstring_builder_append_vprintf (PStringBuilder	*builder,
+				const pchar	*format,
+				zva_list	args)
+{
+	zva_list	args_copy;
+	pint		len;
+	psize		avail;
+
+	if (P_UNLIKELY (builder == NULL || format == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (pzstring_builder_grow (builder, 0) == FALSE))
+		return FALSE;
+
+	/* Try to print into the free space first, it's usually enough */
+	avail = builder->capacity - builder->len;
+
+	zva_copy (args_copy, args);
+	len = vsnprintf (builder->str + builder->len, avail, format, args_copy);
+	zva_end (args_copy);
+
+	if (P_UNLIKELY (len < 0)) {
+		builder->str[builder->len] = '\0';
+		return FALSE;
+	}
+
+	if ((psize) len >= avail) {
+		if (P_UNLIKELY (pzstring_builder_grow (builder, (psize) len) == FALSE)) {
+			builder->str[builder->len] = '\0';
+			return FALSE;
+		}
+
+		zva_copy (args_copy, args);
+		vsnprintf (builder->str + builder->len, (psize) len + 1, format, args_copy);
+		zva_end (args_copy);
+	}
+
+	builder->len += (psize) len;
+
+	return TRUE;
+}
+
+P_LIB_API const pchar *
+zstring_builder_get_str (const PStringBuilder *builder)
+{
+	if (P_UNLIKELY (builder == NULL))
+		return NULL;
+
+	return builder->str != NULL ? builder->str : "";
+}
+
+P_LIB_API psize
+zstring_builder_get_len (const PStringBuilder *builder)
+{
+	if (P_UNLIKELY (builder == NULL))
+		return 0;
+
+	return builder->len;
+}
+
+P_LIB_API void
+zstring_builder_truncate (PStringBuilder	*builder,
+			  psize			len)
+{
+	if (P_UNLIKELY (builder == NULL || len >= builder->len))
+		return;
+
+	builder->len      = len;
+	builder->str[len] = '\0';
+}
+
+P_LIB_API pchar *
+zstring_builder_steal (PStringBuilder *builder)
+{
+	pchar *ret;
+
+	if (P_UNLIKELY (builder == NULL))
+		return NULL;
+
+	if (builder->str == NULL && pzstring_builder_grow (builder, 0) == FALSE)
+		return NULL;
+
+	ret = builder->str;
+
+	builder->str      = NULL;
+	builder->len      = 0;
+	builder->capacity = 0;
+
+	return ret;
+}
+
+P_LIB_API void
+zstring_builder_free (PStringBuilder *builder)
+{
+	if (P_UNLIKELY (builder == NULL))
+		return;
+
+	if (builder->str != NULL)
+		zfree (builder->str);
+
+	zfree (builder);
+}
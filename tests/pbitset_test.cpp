@@ -0,0 +1,382 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PBITSET_TEST_NBITS	10007
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pboolean bitset_test_collect_func (psize index, ppointer user_data)
+{
+	pboolean *bits = (pboolean *) user_data;
+
+	bits[index] = TRUE;
+
+	return FALSE;
+}
+
+static pboolean bitset_test_stop_func (psize index, ppointer user_data)
+{
+	psize *count = (psize *) user_data;
+
+	P_UNUSED (index);
+
+	return ++(*count) == 3;
+}
+
+P_TEST_CASE_BEGIN (pbitset_nomem_test)
+{
+	zlibsys_init ();
+
+	PMemVTable	vtable;
+	puint64		mem[4];
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zbitset_new (100) == NULL);
+	P_TEST_CHECK (zbitset_new_from_memory (mem, sizeof (mem), 100) == NULL);
+
+	zmem_restore_vtable ();
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbitset_invalid_test)
+{
+	zlibsys_init ();
+
+	puint64	mem[4];
+	PBitSet	*bitset;
+	PBitSet	*other;
+
+	P_TEST_CHECK (zbitset_new (0) == NULL);
+	P_TEST_CHECK (zbitset_new_from_memory (NULL, 64, 100) == NULL);
+	P_TEST_CHECK (zbitset_new_from_memory (mem, sizeof (mem), 0) == NULL);
+	P_TEST_CHECK (zbitset_new_from_memory (mem, 8, 100) == NULL);
+	P_TEST_CHECK (zbitset_new_from_memory ((puchar *) mem + 1, 24, 100) == NULL);
+	P_TEST_CHECK (zbitset_get_nbits (NULL) == 0);
+	P_TEST_CHECK (zbitset_test_bit (NULL, 0) == FALSE);
+	P_TEST_CHECK (zbitset_and (NULL, NULL) == FALSE);
+	P_TEST_CHECK (zbitset_or (NULL, NULL) == FALSE);
+	P_TEST_CHECK (zbitset_xor (NULL, NULL) == FALSE);
+	P_TEST_CHECK (zbitset_andnot (NULL, NULL) == FALSE);
+	P_TEST_CHECK (zbitset_count (NULL) == 0);
+	P_TEST_CHECK (zbitset_find_next_set (NULL, 0) == -1);
+	P_TEST_CHECK (zbitset_find_next_clear (NULL, 0) == -1);
+
+	zbitset_set_bit (NULL, 0);
+	zbitset_clear_bit (NULL, 0);
+	zbitset_flip_bit (NULL, 0);
+	zbitset_set_all (NULL);
+	zbitset_clear_all (NULL);
+	zbitset_foreach (NULL, bitset_test_collect_func, NULL);
+	zbitset_free (NULL);
+
+	bitset = zbitset_new (100);
+	other  = zbitset_new (101);
+	P_TEST_REQUIRE (bitset != NULL && other != NULL);
+
+	/* Out of range access is ignored */
+	zbitset_set_bit (bitset, 100);
+	P_TEST_CHECK (zbitset_test_bit (bitset, 100) == FALSE);
+	P_TEST_CHECK (zbitset_count (bitset) == 0);
+	P_TEST_CHECK (zbitset_find_next_set (bitset, 1000) == -1);
+
+	P_TEST_CHECK (zbitset_and (bitset, other) == FALSE);
+	P_TEST_CHECK (zbitset_or (bitset, other) == FALSE);
+	P_TEST_CHECK (zbitset_xor (bitset, other) == FALSE);
+	P_TEST_CHECK (zbitset_andnot (bitset, other) == FALSE);
+
+	zbitset_free (bitset);
+	zbitset_free (other);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbitset_general_test)
+{
+	zlibsys_init ();
+
+	PBitSet		*bitset;
+	pboolean	*model;
+	pboolean	*collected;
+	psize		count;
+	pssize		index;
+
+	bitset    = zbitset_new (PBITSET_TEST_NBITS);
+	model     = (pboolean *) zmalloc0 (PBITSET_TEST_NBITS * sizeof (pboolean));
+	collected = (pboolean *) zmalloc0 (PBITSET_TEST_NBITS * sizeof (pboolean));
+	P_TEST_REQUIRE (bitset != NULL && model != NULL && collected != NULL);
+
+	P_TEST_CHECK (zbitset_get_nbits (bitset) == PBITSET_TEST_NBITS);
+	P_TEST_CHECK (zbitset_count (bitset) == 0);
+	P_TEST_CHECK (zbitset_find_next_set (bitset, 0) == -1);
+	P_TEST_CHECK (zbitset_find_next_clear (bitset, 0) == 0);
+
+	srand (100);
+
+	/* Sparse random bits with long empty runs */
+	for (psize i = 0; i < PBITSET_TEST_NBITS; ++i) {
+		if (i > 3000 && i < 6000)
+			continue;
+
+		if (rand () % 7 == 0) {
+			zbitset_set_bit (bitset, i);
+			model[i] = TRUE;
+		}
+	}
+
+	zbitset_flip_bit (bitset, 0);
+	model[0] = !model[0];
+	zbitset_clear_bit (bitset, PBITSET_TEST_NBITS - 1);
+	model[PBITSET_TEST_NBITS - 1] = FALSE;
+
+	count = 0;
+
+	for (psize i = 0; i < PBITSET_TEST_NBITS; ++i) {
+		P_TEST_CHECK (zbitset_test_bit (bitset, i) == model[i]);
+
+		if (model[i])
+			++count;
+	}
+
+	P_TEST_CHECK (zbitset_count (bitset) == count);
+
+	/* Iteration with the search */
+	count = 0;
+
+	for (index = zbitset_find_next_set (bitset, 0);
+	     index >= 0;
+	     index = zbitset_find_next_set (bitset, (psize) index + 1)) {
+		P_TEST_CHECK (model[index] == TRUE);
+		++count;
+	}
+
+	P_TEST_CHECK (zbitset_count (bitset) == count);
+
+	for (psize i = 0; i < PBITSET_TEST_NBITS; i += 13) {
+		pssize expected_set   = -1;
+		pssize expected_clear = -1;
+
+		for (psize j = i; j < PBITSET_TEST_NBITS; ++j)
+			if (model[j]) {
+				expected_set = (pssize) j;
+				break;
+			}
+
+		for (psize j = i; j < PBITSET_TEST_NBITS; ++j)
+			if (!model[j]) {
+				expected_clear = (pssize) j;
+				break;
+			}
+
+		P_TEST_CHECK (zbitset_find_next_set (bitset, i) == expected_set);
+		P_TEST_CHECK (zbitset_find_next_clear (bitset, i) == expected_clear);
+	}
+
+	/* Iteration with the callback */
+	zbitset_foreach (bitset, bitset_test_collect_func, collected);
+	P_TEST_CHECK (memcmp (model, collected, PBITSET_TEST_NBITS * sizeof (pboolean)) == 0);
+
+	count = 0;
+	zbitset_foreach (bitset, bitset_test_stop_func, &count);
+	P_TEST_CHECK (count == 3);
+
+	/* Bulk fill, the tail bits must be ignored */
+	zbitset_set_all (bitset);
+	P_TEST_CHECK (zbitset_count (bitset) == PBITSET_TEST_NBITS);
+	P_TEST_CHECK (zbitset_find_next_clear (bitset, 0) == -1);
+	P_TEST_CHECK (zbitset_find_next_set (bitset, PBITSET_TEST_NBITS - 1) == PBITSET_TEST_NBITS - 1);
+
+	zbitset_clear_bit (bitset, 9000);
+	P_TEST_CHECK (zbitset_find_next_clear (bitset, 10) == 9000);
+
+	zbitset_clear_all (bitset);
+	P_TEST_CHECK (zbitset_count (bitset) == 0);
+	P_TEST_CHECK (zbitset_find_next_set (bitset, 0) == -1);
+
+	zfree (collected);
+	zfree (model);
+	zbitset_free (bitset);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbitset_ops_test)
+{
+	zlibsys_init ();
+
+	PBitSet	*a;
+	PBitSet	*b;
+	PBitSet	*res;
+	psize	count;
+
+	a   = zbitset_new (PBITSET_TEST_NBITS);
+	b   = zbitset_new (PBITSET_TEST_NBITS);
+	res = zbitset_new (PBITSET_TEST_NBITS);
+	P_TEST_REQUIRE (a != NULL && b != NULL && res != NULL);
+
+	for (psize i = 0; i < PBITSET_TEST_NBITS; ++i) {
+		if (i % 2 == 0)
+			zbitset_set_bit (a, i);
+
+		if (i % 3 == 0)
+			zbitset_set_bit (b, i);
+	}
+
+	/* And */
+	zbitset_clear_all (res);
+	P_TEST_CHECK (zbitset_or (res, a) == TRUE);
+	P_TEST_CHECK (zbitset_and (res, b) == TRUE);
+
+	count = 0;
+
+	for (psize i = 0; i < PBITSET_TEST_NBITS; ++i) {
+		P_TEST_CHECK (zbitset_test_bit (res, i) == (i % 6 == 0));
+		count += (i % 6 == 0) ? 1 : 0;
+	}
+
+	P_TEST_CHECK (zbitset_count (res) == count);
+
+	/* Or */
+	zbitset_clear_all (res);
+	P_TEST_CHECK (zbitset_or (res, a) == TRUE);
+	P_TEST_CHECK (zbitset_or (res, b) == TRUE);
+
+	for (psize i = 0; i < PBITSET_TEST_NBITS; ++i)
+		P_TEST_CHECK (zbitset_test_bit (res, i) == (i % 2 == 0 || i % 3 == 0));
+
+	/* Xor */
+	zbitset_clear_all (res);
+	P_TEST_CHECK (zbitset_or (res, a) == TRUE);
+	P_TEST_CHECK (zbitset_xor (res, b) == TRUE);
+
+	for (psize i = 0; i < PBITSET_TEST_NBITS; ++i)
+		P_TEST_CHECK (zbitset_test_bit (res, i) == ((i % 2 == 0) != (i % 3 == 0)));
+
+	/* And not */
+	zbitset_clear_all (res);
+	P_TEST_CHECK (zbitset_or (res, a) == TRUE);
+	P_TEST_CHECK (zbitset_andnot (res, b) == TRUE);
+
+	for (psize i = 0; i < PBITSET_TEST_NBITS; ++i)
+		P_TEST_CHECK (zbitset_test_bit (res, i) == (i % 2 == 0 && i % 3 != 0));
+
+	/* Xor with itself gives an empty set */
+	P_TEST_CHECK (zbitset_xor (res, res) == TRUE);
+	P_TEST_CHECK (zbitset_count (res) == 0);
+
+	zbitset_free (res);
+	zbitset_free (b);
+	zbitset_free (a);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbitset_memory_test)
+{
+	zlibsys_init ();
+
+	PShm	*shm;
+	PBitSet	*bitset;
+	psize	mem_size;
+
+	mem_size = zbitset_get_memory_size (1000);
+	P_TEST_CHECK (mem_size == 16 * sizeof (puint64));
+	P_TEST_CHECK (zbitset_get_memory_size (64) == sizeof (puint64));
+	P_TEST_CHECK (zbitset_get_memory_size (65) == 2 * sizeof (puint64));
+
+	shm = zshm_new ("pbitset_test_memory", mem_size, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	zshm_take_ownership (shm);
+
+	P_TEST_CHECK (zbitset_new_from_memory (zshm_get_address (shm), mem_size - 1, 1000) == NULL);
+
+	bitset = zbitset_new_from_memory (zshm_get_address (shm), zshm_get_size (shm), 1000);
+	P_TEST_REQUIRE (bitset != NULL);
+
+	zbitset_clear_all (bitset);
+
+	for (psize i = 0; i < 1000; i += 10)
+		zbitset_set_bit (bitset, i);
+
+	zbitset_free (bitset);
+
+	/* Contents must survive in the memory */
+	bitset = zbitset_new_from_memory (zshm_get_address (shm), zshm_get_size (shm), 1000);
+	P_TEST_REQUIRE (bitset != NULL);
+
+	P_TEST_CHECK (zbitset_count (bitset) == 100);
+	P_TEST_CHECK (zbitset_test_bit (bitset, 990) == TRUE);
+	P_TEST_CHECK (zbitset_test_bit (bitset, 991) == FALSE);
+	P_TEST_CHECK (((puint64 *) zshm_get_address (shm))[0] == 0x1004010040100401ULL);
+
+	zbitset_free (bitset);
+	zshm_free (shm);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pbitset_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pbitset_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pbitset_general_test);
+	P_TEST_SUITE_RUN_CASE (pbitset_ops_test);
+	P_TEST_SUITE_RUN_CASE (pbitset_memory_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,247 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PBLOOM_FILTER_TEST_CAPACITY	10000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void bloom_filter_test_key (pint num, pchar *buf)
+{
+	sprintf (buf, "bloom_filter_key_%d", num);
+}
+
+P_TEST_CASE_BEGIN (pbloomfilter_nomem_test)
+{
+	zlibsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zbloom_filter_new (100, 0.01) == NULL);
+
+	zmem_restore_vtable ();
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbloomfilter_invalid_test)
+{
+	zlibsys_init ();
+
+	puint64 buf[16];
+
+	P_TEST_CHECK (zbloom_filter_new (0, 0.01) == NULL);
+	P_TEST_CHECK (zbloom_filter_new (100, 0.0) == NULL);
+	P_TEST_CHECK (zbloom_filter_new (100, 1.0) == NULL);
+	P_TEST_CHECK (zbloom_filter_new (100, -0.5) == NULL);
+	P_TEST_CHECK (zbloom_filter_new_from_image (NULL, 1024, FALSE) == NULL);
+	P_TEST_CHECK (zbloom_filter_new_from_image (buf, 8, FALSE) == NULL);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (zbloom_filter_new_from_image (buf, sizeof (buf), FALSE) == NULL);
+
+	P_TEST_CHECK (zbloom_filter_contains (NULL, "a", 1) == FALSE);
+	P_TEST_CHECK (zbloom_filter_get_image_size (NULL) == 0);
+	P_TEST_CHECK (zbloom_filter_save_image (NULL, buf, sizeof (buf)) == FALSE);
+
+	zbloom_filter_insert (NULL, "a", 1);
+	zbloom_filter_clear (NULL);
+	zbloom_filter_free (NULL);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbloomfilter_general_test)
+{
+	zlibsys_init ();
+
+	PBloomFilter	*filter;
+	pchar		key[64];
+	pint		false_positives;
+
+	filter = zbloom_filter_new (PBLOOM_FILTER_TEST_CAPACITY, 0.01);
+	P_TEST_REQUIRE (filter != NULL);
+
+	P_TEST_CHECK (zbloom_filter_contains (filter, "", 0) == FALSE);
+	zbloom_filter_insert (filter, "", 0);
+	P_TEST_CHECK (zbloom_filter_contains (filter, "", 0) == TRUE);
+
+	for (pint i = 0; i < PBLOOM_FILTER_TEST_CAPACITY; ++i) {
+		bloom_filter_test_key (i, key);
+		zbloom_filter_insert (filter, key, strlen (key));
+	}
+
+	/* No false negatives are allowed */
+	for (pint i = 0; i < PBLOOM_FILTER_TEST_CAPACITY; ++i) {
+		bloom_filter_test_key (i, key);
+		P_TEST_CHECK (zbloom_filter_contains (filter, key, strlen (key)) == TRUE);
+	}
+
+	false_positives = 0;
+
+	for (pint i = PBLOOM_FILTER_TEST_CAPACITY; i < PBLOOM_FILTER_TEST_CAPACITY * 11; ++i) {
+		bloom_filter_test_key (i, key);
+
+		if (zbloom_filter_contains (filter, key, strlen (key)))
+			++false_positives;
+	}
+
+	/* Expected about 1000 false positives for 1% probability, allow 20% above
+	 * it for the sampling noise */
+	P_TEST_CHECK (false_positives < PBLOOM_FILTER_TEST_CAPACITY * 10 / 100 * 12 / 10);
+
+	zbloom_filter_clear (filter);
+
+	for (pint i = 0; i < 100; ++i) {
+		bloom_filter_test_key (i, key);
+		P_TEST_CHECK (zbloom_filter_contains (filter, key, strlen (key)) == FALSE);
+	}
+
+	zbloom_filter_free (filter);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbloomfilter_image_test)
+{
+	zlibsys_init ();
+
+	PBloomFilter	*filter;
+	PBloomFilter	*image_filter;
+	PShm		*shm;
+	pchar		key[64];
+	psize		image_size;
+	pint		false_positives;
+
+	filter = zbloom_filter_new (1000, 0.001);
+	P_TEST_REQUIRE (filter != NULL);
+
+	for (pint i = 0; i < 1000; i += 2) {
+		bloom_filter_test_key (i, key);
+		zbloom_filter_insert (filter, key, strlen (key));
+	}
+
+	image_size = zbloom_filter_get_image_size (filter);
+	P_TEST_CHECK (image_size > 1000);
+
+	shm = zshm_new ("pbloomfilter_test_image", image_size, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	zshm_take_ownership (shm);
+
+	P_TEST_CHECK (zbloom_filter_save_image (filter, zshm_get_address (shm), image_size - 1) == FALSE);
+	P_TEST_CHECK (zbloom_filter_save_image (filter, zshm_get_address (shm), zshm_get_size (shm)) == TRUE);
+
+	P_TEST_CHECK (zbloom_filter_new_from_image (zshm_get_address (shm), image_size - 1, TRUE) == NULL);
+
+	image_filter = zbloom_filter_new_from_image (zshm_get_address (shm), zshm_get_size (shm), TRUE);
+	P_TEST_REQUIRE (image_filter != NULL);
+	P_TEST_CHECK (zbloom_filter_get_image_size (image_filter) == image_size);
+
+	for (pint i = 0; i < 1000; i += 2) {
+		bloom_filter_test_key (i, key);
+		P_TEST_CHECK (zbloom_filter_contains (image_filter, key, strlen (key)) == TRUE);
+	}
+
+	/* Insertions into the shared image must not affect the source filter */
+	for (pint i = 1; i < 1000; i += 2) {
+		bloom_filter_test_key (i, key);
+		zbloom_filter_insert (image_filter, key, strlen (key));
+	}
+
+	for (pint i = 0; i < 1000; ++i) {
+		bloom_filter_test_key (i, key);
+		P_TEST_CHECK (zbloom_filter_contains (image_filter, key, strlen (key)) == TRUE);
+	}
+
+	false_positives = 0;
+
+	for (pint i = 1; i < 1000; i += 2) {
+		bloom_filter_test_key (i, key);
+
+		if (zbloom_filter_contains (filter, key, strlen (key)))
+			++false_positives;
+	}
+
+	P_TEST_CHECK (false_positives < 50);
+
+	zbloom_filter_free (image_filter);
+
+	/* Open the image once again, all the insertions must be there */
+	image_filter = zbloom_filter_new_from_image (zshm_get_address (shm), zshm_get_size (shm), FALSE);
+	P_TEST_REQUIRE (image_filter != NULL);
+
+	for (pint i = 0; i < 1000; ++i) {
+		bloom_filter_test_key (i, key);
+		P_TEST_CHECK (zbloom_filter_contains (image_filter, key, strlen (key)) == TRUE);
+	}
+
+	zbloom_filter_free (image_filter);
+	zbloom_filter_free (filter);
+	zshm_free (shm);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pbloomfilter_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pbloomfilter_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pbloomfilter_general_test);
+	P_TEST_SUITE_RUN_CASE (pbloomfilter_image_test);
+}
+P_TEST_SUITE_END()
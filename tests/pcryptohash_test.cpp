@@ -26,12 +26,15 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <stdio.h>
 #include <string.h>
 
 P_TEST_MODULE_INIT ();
 
 #define PCRYPTO_STRESS_LENGTH	10000
 #define PCRYPTO_MAX_UPDATES	1000000
+#define PCRYPTO_FILE_SIZE	(3 * 1024 * 1024 + 12345)
+#define PCRYPTO_FILE		"." P_DIR_SEPARATOR "pcryptohash_test_file"
 
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
@@ -173,6 +176,27 @@ general_hash_test (PCryptoHashType	type,
 	zcrypto_hash_free (crypto_hash);
 }
 
+static pchar *
+hash_in_chunks (PCryptoHashType	type,
+		const puchar	*data,
+		psize		len,
+		psize		chunk)
+{
+	PCryptoHash	*crypto_hash;
+	pchar		*ret;
+	psize		offset;
+
+	crypto_hash = zcrypto_hash_new (type);
+
+	for (offset = 0; offset < len; offset += chunk)
+		zcrypto_hash_update (crypto_hash, data + offset, len - offset < chunk ? len - offset : chunk);
+
+	ret = zcrypto_hash_get_string (crypto_hash);
+	zcrypto_hash_free (crypto_hash);
+
+	return ret;
+}
+
 P_TEST_CASE_BEGIN (pcryptohash_nomem_test)
 {
 	zlibsys_init ();
@@ -189,6 +213,33 @@ P_TEST_CASE_BEGIN (pcryptohash_nomem_test)
 	P_TEST_CHECK (zcrypto_hash_new (P_CRYPTO_HASH_TYPE_SHA1) == NULL);
 	P_TEST_CHECK (zcrypto_hash_new (P_CRYPTO_HASH_TYPE_GOST) == NULL);
 
+	const puchar		*input  = (const puchar *) "abc";
+	psize			length  = 3;
+	puchar			digest[32];
+	puchar			compute_digest[32];
+	puchar			*digest_ptr = digest;
+	pchar			hex[41];
+	PCryptoHashStorage	storage;
+	PCryptoHash		*hash;
+
+	/* Caller-storage contexts and one-shot hashing don't allocate memory */
+	P_TEST_CHECK (zcrypto_hash_compute (P_CRYPTO_HASH_TYPE_MD5, input, length, compute_digest) == TRUE);
+	P_TEST_CHECK (memcmp (compute_digest, "\x90\x01\x50\x98\x3c\xd2\x4f\xb0\xd6\x96\x3f\x7d\x28\xe1\x7f\x72", 16) == 0);
+
+	hash = zcrypto_hash_init (&storage, P_CRYPTO_HASH_TYPE_SHA1);
+	P_TEST_REQUIRE (hash != NULL);
+
+	zcrypto_hash_update (hash, input, length);
+	P_TEST_CHECK (zcrypto_hash_get_hex (hash, hex, sizeof (hex)) == 40);
+	P_TEST_CHECK (strcmp (hex, "a9993e364706816aba3e25717850c26c9cd0d89d") == 0);
+	zcrypto_hash_free (hash);
+
+	P_TEST_CHECK (zcrypto_hash_compute (P_CRYPTO_HASH_TYPE_GOST, input, length, compute_digest) == TRUE);
+	P_TEST_CHECK (zcrypto_hash_many (P_CRYPTO_HASH_TYPE_GOST, &input, &length, &digest_ptr, 1) == TRUE);
+	P_TEST_CHECK (memcmp (digest, compute_digest, 32) == 0);
+	P_TEST_CHECK (zcrypto_hash_file (P_CRYPTO_HASH_TYPE_MD5, "." P_DIR_SEPARATOR "pcryptohash_no_file",
+					 P_CRYPTO_HASH_FILE_FLAG_NONE, NULL, NULL) == NULL);
+
 	zmem_restore_vtable ();
 
 	zlibsys_shutdown ();
@@ -201,6 +252,7 @@ P_TEST_CASE_BEGIN (pcryptohash_invalid_test)
 	psize		len;
 	pssize		md5_len;
 	pchar		*hash_str;
+	pchar		hex[33];
 	puchar		*buf;
 
 	zlibsys_init ();
@@ -208,6 +260,8 @@ P_TEST_CASE_BEGIN (pcryptohash_invalid_test)
 	P_TEST_CHECK (zcrypto_hash_new ((PCryptoHashType) -1) == NULL);
 	P_TEST_CHECK (zcrypto_hash_get_length (NULL) == 0);
 	P_TEST_CHECK (zcrypto_hash_get_string (NULL) == NULL);
+	P_TEST_CHECK (zcrypto_hash_get_hex (NULL, hex, sizeof (hex)) == 0);
+	P_TEST_CHECK (hex[0] == '\0');
 	P_TEST_CHECK ((pint) zcrypto_hash_get_type (NULL) == -1);
 	zcrypto_hash_free (NULL);
 
@@ -245,6 +299,12 @@ P_TEST_CASE_BEGIN (pcryptohash_invalid_test)
 	P_TEST_CHECK (strcmp (hash_str, "900150983cd24fb0d6963f7d28e17f72") == 0);
 	zfree (hash_str);
 
+	P_TEST_CHECK (zcrypto_hash_get_hex (hash, NULL, sizeof (hex)) == 0);
+	P_TEST_CHECK (zcrypto_hash_get_hex (hash, hex, sizeof (hex) - 1) == 0);
+	P_TEST_CHECK (hex[0] == '\0');
+	P_TEST_CHECK (zcrypto_hash_get_hex (hash, hex, sizeof (hex)) == 32);
+	P_TEST_CHECK (strcmp (hex, "900150983cd24fb0d6963f7d28e17f72") == 0);
+
 	zcrypto_hash_free (hash);
 	zfree (buf);
 
@@ -643,6 +703,390 @@ P_TEST_CASE_BEGIN (gost3411_94_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (blake3_test)
+{
+	PCryptoHash	*blake3_hash;
+	pchar		*hash_str;
+	pchar		*thread_str;
+	puchar		*data;
+	const psize	data_len = 3000001;
+	const puchar	hash_etalon_1[] = {100,  55, 179, 172,  56,  70,  81,  51,
+					   255, 182,  59, 117,  39,  58, 141, 181,
+					    72, 197,  88,  70,  93, 121, 219,   3,
+					   253,  53, 156, 108, 213, 189, 157, 133};
+	const puchar	hash_etalon_2[] = {193, 144,  18, 204,  42, 175,  13, 195,
+					   216, 229, 196,  90,  27, 121,  17,  77,
+					    45, 244,  42, 187,  42,  65,  11, 245,
+					    75, 224, 158, 137,  26, 240, 111, 248};
+	const puchar	hash_etalon_3[] = { 97, 111,  87,  90,  27,  88, 212, 201,
+					   121, 125,  66,  23, 185, 115,  10, 229,
+					   230, 235,  49, 157, 118, 237, 239, 101,
+					    73, 180, 111,  78, 254,  49, 255, 139};
+
+	zlibsys_init ();
+
+	general_hash_test (P_CRYPTO_HASH_TYPE_BLAKE3,
+			   32,
+			   "abc",
+			   "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+			   hash_etalon_1,
+			   hash_etalon_2,
+			   hash_etalon_3,
+			   "6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85",
+			   "c19012cc2aaf0dc3d8e5c45a1b79114d2df42abb2a410bf54be09e891af06ff8",
+			   "616f575a1b58d4c9797d4217b9730ae5e6eb319d76edef6549b46f4efe31ff8b",
+			   "6c48eaa673f9fed5d3d8f9df4456ef9a2ef6cfc23588f6361b82175187ec5067");
+
+	/* Large input, hashed with and without the additional threads */
+	data = (puchar *) zmalloc (data_len);
+	P_TEST_REQUIRE (data != NULL);
+
+	for (psize i = 0; i < data_len; ++i)
+		data[i] = (puchar) (i % 251);
+
+	blake3_hash = zcrypto_hash_new (P_CRYPTO_HASH_TYPE_BLAKE3);
+	P_TEST_REQUIRE (blake3_hash != NULL);
+
+	P_TEST_CHECK (zcrypto_hash_set_threads (NULL, 4) == FALSE);
+	P_TEST_CHECK (zcrypto_hash_set_threads (blake3_hash, 1) == TRUE);
+
+	zcrypto_hash_update (blake3_hash, data, data_len);
+	hash_str = zcrypto_hash_get_string (blake3_hash);
+
+	P_TEST_CHECK (strcmp (hash_str, "a1ead512edfce7caaecf9c124bb4da104432bfd8ca640e62ab376f1d72a51428") == 0);
+
+	zcrypto_hash_reset (blake3_hash);
+	P_TEST_CHECK (zcrypto_hash_set_threads (blake3_hash, 4) == TRUE);
+
+	/* Unaligned first update, so the subtrees start in the middle */
+	zcrypto_hash_update (blake3_hash, data, 1500);
+	zcrypto_hash_update (blake3_hash, data + 1500, data_len - 1500);
+	thread_str = zcrypto_hash_get_string (blake3_hash);
+
+	P_TEST_CHECK (strcmp (hash_str, thread_str) == 0);
+
+	zfree (hash_str);
+	zfree (thread_str);
+	zcrypto_hash_free (blake3_hash);
+
+	/* Other types are not parallel */
+	blake3_hash = zcrypto_hash_new (P_CRYPTO_HASH_TYPE_SHA2_256);
+	P_TEST_CHECK (zcrypto_hash_set_threads (blake3_hash, 4) == FALSE);
+	zcrypto_hash_free (blake3_hash);
+
+	zfree (data);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcryptohash_chunks_test)
+{
+	const psize	lengths[] = {0, 1, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 200, 511, 512, 640, 1000};
+	const psize	chunks[]  = {1, 7, 63, 64, 65, 128, 513, 1000};
+	puchar		data[1000];
+	pchar		*whole_str;
+	pchar		*chunk_str;
+
+	zlibsys_init ();
+
+	for (int i = 0; i < 1000; ++i)
+		data[i] = (puchar) (i * 131 + 7);
+
+	/* Many blocks in a single update */
+	whole_str = hash_in_chunks (P_CRYPTO_HASH_TYPE_SHA1, data, 1000, 1000);
+	P_TEST_CHECK (strcmp (whole_str, "425b5f2d2d344f4f6467cda9065cdc840619dc2d") == 0);
+	zfree (whole_str);
+
+	whole_str = hash_in_chunks (P_CRYPTO_HASH_TYPE_SHA2_224, data, 1000, 1000);
+	P_TEST_CHECK (strcmp (whole_str, "ab145b330355b6c708082c2e68b977f1a7ec493dbf7e72cb8f6ff542") == 0);
+	zfree (whole_str);
+
+	whole_str = hash_in_chunks (P_CRYPTO_HASH_TYPE_SHA2_256, data, 1000, 1000);
+	P_TEST_CHECK (strcmp (whole_str, "533b698850849b7908b20a22658f639c0b2a476f1791f85f50188287c31a9aba") == 0);
+	zfree (whole_str);
+
+	whole_str = hash_in_chunks (P_CRYPTO_HASH_TYPE_SHA2_384, data, 1000, 1000);
+	P_TEST_CHECK (strcmp (whole_str, "e36ffc77467bef3a40cce15905f31f4877714eb8ecafb673f1352c8c9fbe7be59e8d9fd7bb4b8687b7a9a4e54060ea81") == 0);
+	zfree (whole_str);
+
+	whole_str = hash_in_chunks (P_CRYPTO_HASH_TYPE_SHA2_512, data, 1000, 1000);
+	P_TEST_CHECK (strcmp (whole_str, "7881dc60b1a8061810f37f35e9b90cd7725a42f8bbdd7eb516dba2563b4b1d89"
+					 "a2f92967fb721d93a72df061f52a038b6e62473161cd132b3390101909c58b2e") == 0);
+	zfree (whole_str);
+
+	whole_str = hash_in_chunks (P_CRYPTO_HASH_TYPE_BLAKE3, data, 1000, 1000);
+	P_TEST_CHECK (strcmp (whole_str, "ac68403a5c8e8bba840dd9c6c19015510d6d48e9881dc8f3088283c35812da4d") == 0);
+	zfree (whole_str);
+
+	/* Splitting the input must not change the result */
+	for (int type = (int) P_CRYPTO_HASH_TYPE_MD5; type <= (int) P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		for (psize i = 0; i < sizeof (lengths) / sizeof (lengths[0]); ++i) {
+			whole_str = hash_in_chunks ((PCryptoHashType) type, data, lengths[i], 1000);
+
+			for (psize j = 0; j < sizeof (chunks) / sizeof (chunks[0]); ++j) {
+				chunk_str = hash_in_chunks ((PCryptoHashType) type, data, lengths[i], chunks[j]);
+				P_TEST_CHECK (strcmp (whole_str, chunk_str) == 0);
+				zfree (chunk_str);
+			}
+
+			zfree (whole_str);
+		}
+	}
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcryptohash_many_test)
+{
+	const psize	count = 77;
+	puchar		data[1000];
+	const puchar	*inputs[count];
+	psize		lengths[count];
+	puchar		*digests[count];
+	puchar		ref[64];
+	psize		ref_len;
+	PCryptoHash	*hash;
+
+	zlibsys_init ();
+
+	for (int i = 0; i < 1000; ++i)
+		data[i] = (puchar) (i * 131 + 7);
+
+	/* Lengths around the padding boundaries, the messages of a batch finish
+	 * at different times */
+	for (psize i = 0; i < count; ++i) {
+		lengths[i] = (i * 53) % 260;
+		inputs[i]  = lengths[i] > 0 ? data + (i * 11) % 700 : NULL;
+		digests[i] = (puchar *) zmalloc0 (64);
+	}
+
+	P_TEST_CHECK (zcrypto_hash_many ((PCryptoHashType) -1, inputs, lengths, digests, count) == FALSE);
+	P_TEST_CHECK (zcrypto_hash_many (P_CRYPTO_HASH_TYPE_MD5, NULL, lengths, digests, count) == FALSE);
+	P_TEST_CHECK (zcrypto_hash_many (P_CRYPTO_HASH_TYPE_MD5, inputs, NULL, digests, count) == FALSE);
+	P_TEST_CHECK (zcrypto_hash_many (P_CRYPTO_HASH_TYPE_MD5, inputs, lengths, NULL, count) == FALSE);
+	P_TEST_CHECK (zcrypto_hash_many (P_CRYPTO_HASH_TYPE_MD5, NULL, NULL, NULL, 0) == TRUE);
+
+	lengths[0] = 1;
+	P_TEST_CHECK (zcrypto_hash_many (P_CRYPTO_HASH_TYPE_MD5, inputs, lengths, digests, count) == FALSE);
+	lengths[0] = 0;
+
+	for (int type = (int) P_CRYPTO_HASH_TYPE_MD5; type <= (int) P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		P_TEST_CHECK (zcrypto_hash_many ((PCryptoHashType) type, inputs, lengths, digests, count) == TRUE);
+
+		for (psize i = 0; i < count; ++i) {
+			hash = zcrypto_hash_new ((PCryptoHashType) type);
+			zcrypto_hash_update (hash, inputs[i], lengths[i]);
+
+			ref_len = sizeof (ref);
+			zcrypto_hash_get_digest (hash, ref, &ref_len);
+
+			P_TEST_CHECK (memcmp (ref, digests[i], ref_len) == 0);
+
+			zcrypto_hash_free (hash);
+		}
+	}
+
+	/* Known digest through the batch path */
+	inputs[0]  = (const puchar *) "abc";
+	lengths[0] = 3;
+
+	P_TEST_CHECK (zcrypto_hash_many (P_CRYPTO_HASH_TYPE_MD5, inputs, lengths, digests, 1) == TRUE);
+	P_TEST_CHECK (memcmp (digests[0], "\x90\x01\x50\x98\x3c\xd2\x4f\xb0\xd6\x96\x3f\x7d\x28\xe1\x7f\x72", 16) == 0);
+
+	P_TEST_CHECK (zcrypto_hash_many (P_CRYPTO_HASH_TYPE_SHA3_256, inputs, lengths, digests, 1) == TRUE);
+	P_TEST_CHECK (memcmp (digests[0], "\x3a\x98\x5d\xa7\x4f\xe2\x25\xb2\x04\x5c\x17\x2d\x6b\xd3\x90\xbd"
+					  "\x85\x5f\x08\x6e\x3e\x9d\x52\x5b\x46\xbf\xe2\x45\x11\x43\x15\x32", 32) == 0);
+
+	for (psize i = 0; i < count; ++i)
+		zfree (digests[i]);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcryptohash_file_test)
+{
+	zlibsys_init ();
+
+	const PCryptoHashType types[] = {
+		P_CRYPTO_HASH_TYPE_SHA2_256,
+		P_CRYPTO_HASH_TYPE_BLAKE3
+	};
+
+	const PCryptoHashFileFlags flags[] = {
+		P_CRYPTO_HASH_FILE_FLAG_NONE,
+		P_CRYPTO_HASH_FILE_FLAG_NO_MAP,
+		P_CRYPTO_HASH_FILE_FLAG_THREADED,
+		(PCryptoHashFileFlags) (P_CRYPTO_HASH_FILE_FLAG_NO_MAP | P_CRYPTO_HASH_FILE_FLAG_THREADED)
+	};
+
+	PCryptoHash		*crypto_hash;
+	PCryptoHash		*file_hash;
+	PCryptoHashFileStats	stats;
+	PError			*error = NULL;
+	puchar			*data;
+	pchar			*hash_str;
+	pchar			*file_hash_str;
+	FILE			*file;
+
+	data = (puchar *) zmalloc (PCRYPTO_FILE_SIZE);
+	P_TEST_REQUIRE (data != NULL);
+
+	for (psize i = 0; i < PCRYPTO_FILE_SIZE; ++i)
+		data[i] = (puchar) (i * 7 + (i >> 11));
+
+	file = fopen (PCRYPTO_FILE, "wb");
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_REQUIRE (fwrite (data, 1, PCRYPTO_FILE_SIZE, file) == PCRYPTO_FILE_SIZE);
+	P_TEST_REQUIRE (fclose (file) == 0);
+
+	for (psize i = 0; i < sizeof (types) / sizeof (types[0]); ++i) {
+		crypto_hash = zcrypto_hash_new (types[i]);
+		P_TEST_REQUIRE (crypto_hash != NULL);
+
+		zcrypto_hash_update (crypto_hash, data, PCRYPTO_FILE_SIZE);
+		hash_str = zcrypto_hash_get_string (crypto_hash);
+
+		for (psize j = 0; j < sizeof (flags) / sizeof (flags[0]); ++j) {
+			file_hash = zcrypto_hash_file (types[i], PCRYPTO_FILE, flags[j], &stats, NULL);
+			P_TEST_REQUIRE (file_hash != NULL);
+
+			file_hash_str = zcrypto_hash_get_string (file_hash);
+			P_TEST_CHECK (strcmp (hash_str, file_hash_str) == 0);
+
+			P_TEST_CHECK (stats.bytes == PCRYPTO_FILE_SIZE);
+			P_TEST_CHECK (stats.is_mapped == ((flags[j] & P_CRYPTO_HASH_FILE_FLAG_NO_MAP) == 0));
+			P_TEST_CHECK (stats.elapsed_usecs == 0 || stats.bytes_per_sec > 0);
+
+			zfree (file_hash_str);
+			zcrypto_hash_free (file_hash);
+		}
+
+		zfree (hash_str);
+		zcrypto_hash_free (crypto_hash);
+	}
+
+	/* Empty file can't be mapped */
+	file = fopen (PCRYPTO_FILE, "wb");
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_REQUIRE (fclose (file) == 0);
+
+	file_hash = zcrypto_hash_file (P_CRYPTO_HASH_TYPE_MD5, PCRYPTO_FILE, P_CRYPTO_HASH_FILE_FLAG_NONE, &stats, NULL);
+	P_TEST_REQUIRE (file_hash != NULL);
+
+	file_hash_str = zcrypto_hash_get_string (file_hash);
+	P_TEST_CHECK (strcmp (file_hash_str, "d41d8cd98f00b204e9800998ecf8427e") == 0);
+	P_TEST_CHECK (stats.bytes == 0);
+	P_TEST_CHECK (stats.is_mapped == FALSE);
+
+	zfree (file_hash_str);
+	zcrypto_hash_free (file_hash);
+
+	P_TEST_CHECK (zfile_remove (PCRYPTO_FILE, NULL) == TRUE);
+
+	P_TEST_CHECK (zcrypto_hash_file (P_CRYPTO_HASH_TYPE_MD5,
+					 PCRYPTO_FILE,
+					 P_CRYPTO_HASH_FILE_FLAG_NONE,
+					 NULL,
+					 &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (zerror_get_code (error) == (pint) P_ERROR_IO_NOT_EXISTS);
+	zerror_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (zcrypto_hash_file (P_CRYPTO_HASH_TYPE_MD5, NULL, P_CRYPTO_HASH_FILE_FLAG_NONE, NULL, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	zerror_free (error);
+
+	P_TEST_CHECK (zcrypto_hash_file ((PCryptoHashType) -1,
+					 PCRYPTO_FILE,
+					 P_CRYPTO_HASH_FILE_FLAG_NONE,
+					 NULL,
+					 NULL) == NULL);
+
+	zfree (data);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcryptohash_storage_test)
+{
+	zlibsys_init ();
+
+	const psize lengths[] = {0, 3, 64, 1000, 5000};
+
+	PCryptoHashStorage	storage;
+	PCryptoHash		*hash;
+	PCryptoHash		*storage_hash;
+	puchar			*data;
+	puchar			digest[P_CRYPTO_HASH_MAX_LENGTH];
+	puchar			compute_digest[P_CRYPTO_HASH_MAX_LENGTH];
+	puchar			storage_digest[P_CRYPTO_HASH_MAX_LENGTH];
+	psize			digest_len;
+	psize			storage_digest_len;
+
+	data = (puchar *) zmalloc (5000);
+	P_TEST_REQUIRE (data != NULL);
+
+	for (psize i = 0; i < 5000; ++i)
+		data[i] = (puchar) (i * 13 + 5);
+
+	for (pint type = P_CRYPTO_HASH_TYPE_MD5; type <= P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		hash = zcrypto_hash_new ((PCryptoHashType) type);
+		P_TEST_REQUIRE (hash != NULL);
+
+		storage_hash = zcrypto_hash_init (&storage, (PCryptoHashType) type);
+		P_TEST_REQUIRE (storage_hash != NULL);
+
+		P_TEST_CHECK (zcrypto_hash_get_type (storage_hash) == (PCryptoHashType) type);
+		P_TEST_CHECK (zcrypto_hash_get_length (storage_hash) == zcrypto_hash_get_length (hash));
+		P_TEST_CHECK (zcrypto_hash_get_length (storage_hash) <= P_CRYPTO_HASH_MAX_LENGTH);
+
+		for (psize i = 0; i < sizeof (lengths) / sizeof (lengths[0]); ++i) {
+			zcrypto_hash_update (hash, data, lengths[i]);
+			zcrypto_hash_update (storage_hash, data, lengths[i]);
+
+			digest_len         = sizeof (digest);
+			storage_digest_len = sizeof (storage_digest);
+
+			zcrypto_hash_get_digest (hash, digest, &digest_len);
+			zcrypto_hash_get_digest (storage_hash, storage_digest, &storage_digest_len);
+
+			P_TEST_CHECK (zcrypto_hash_compute ((PCryptoHashType) type,
+							    lengths[i] > 0 ? data : NULL,
+							    lengths[i],
+							    compute_digest) == TRUE);
+
+			P_TEST_CHECK (digest_len == (psize) zcrypto_hash_get_length (hash));
+			P_TEST_CHECK (storage_digest_len == digest_len);
+			P_TEST_CHECK (memcmp (digest, storage_digest, digest_len) == 0);
+			P_TEST_CHECK (memcmp (digest, compute_digest, digest_len) == 0);
+
+			zcrypto_hash_reset (hash);
+			zcrypto_hash_reset (storage_hash);
+		}
+
+		zcrypto_hash_free (hash);
+		zcrypto_hash_free (storage_hash);
+	}
+
+	P_TEST_CHECK (zcrypto_hash_init (NULL, P_CRYPTO_HASH_TYPE_MD5) == NULL);
+	P_TEST_CHECK (zcrypto_hash_init (&storage, (PCryptoHashType) -1) == NULL);
+	P_TEST_CHECK (zcrypto_hash_init (&storage, (PCryptoHashType) (P_CRYPTO_HASH_TYPE_BLAKE3 + 1)) == NULL);
+
+	P_TEST_CHECK (zcrypto_hash_compute ((PCryptoHashType) -1, data, 10, digest) == FALSE);
+	P_TEST_CHECK (zcrypto_hash_compute (P_CRYPTO_HASH_TYPE_MD5, NULL, 10, digest) == FALSE);
+	P_TEST_CHECK (zcrypto_hash_compute (P_CRYPTO_HASH_TYPE_MD5, data, 10, NULL) == FALSE);
+
+	zfree (data);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pcryptohash_nomem_test);
@@ -658,5 +1102,10 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (sha3_384_test);
 	P_TEST_SUITE_RUN_CASE (sha3_512_test);
 	P_TEST_SUITE_RUN_CASE (gost3411_94_test);
+	P_TEST_SUITE_RUN_CASE (blake3_test);
+	P_TEST_SUITE_RUN_CASE (pcryptohash_chunks_test);
+	P_TEST_SUITE_RUN_CASE (pcryptohash_many_test);
+	P_TEST_SUITE_RUN_CASE (pcryptohash_file_test);
+	P_TEST_SUITE_RUN_CASE (pcryptohash_storage_test);
 }
 P_TEST_SUITE_END()
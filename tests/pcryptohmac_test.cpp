@@ -0,0 +1,341 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static bool
+check_hex (const puchar *data, psize len, const pchar *hex)
+{
+	pchar buf[P_ENCODING_HEX_ENCODED_LEN (P_CRYPTO_HASH_MAX_LENGTH) + 1];
+
+	if (zencoding_hex_encode (data, len, buf, sizeof (buf)) != len * 2)
+		return false;
+
+	return strcmp (buf, hex) == 0;
+}
+
+static const pchar *pcryptohmac_jefe_key  = "Jefe";
+static const pchar *pcryptohmac_jefe_data = "what do ya want for nothing?";
+static const pchar *pcryptohmac_long_data = "Test Using Larger Than Block-Size Key - Hash Key First";
+
+P_TEST_CASE_BEGIN (pcryptohmac_nomem_test)
+{
+	zlibsys_init ();
+
+	PCryptoHmac	*hmac;
+	puchar		digest[P_CRYPTO_HASH_MAX_LENGTH];
+	puchar		okm[42];
+	puchar		ikm[22];
+	PMemVTable	vtable;
+
+	P_TEST_REQUIRE ((hmac = zcrypto_hmac_new (P_CRYPTO_HASH_TYPE_SHA2_256,
+						  (const puchar *) pcryptohmac_jefe_key, 4)) != NULL);
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zcrypto_hmac_new (P_CRYPTO_HASH_TYPE_SHA2_256, NULL, 0) == NULL);
+
+	/* Neither the cached key nor HKDF need memory */
+	P_TEST_CHECK (zcrypto_hmac_compute (hmac, (const puchar *) pcryptohmac_jefe_data, 28, digest) == TRUE);
+	P_TEST_CHECK (check_hex (digest, 32, "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+
+	memset (ikm, 0x0B, sizeof (ikm));
+
+	P_TEST_CHECK (zcrypto_hkdf (P_CRYPTO_HASH_TYPE_SHA2_256, NULL, 0, ikm, sizeof (ikm),
+				    NULL, 0, okm, sizeof (okm)) == TRUE);
+	P_TEST_CHECK (check_hex (okm, sizeof (okm), "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c73"
+						    "8d2d9d201395faa4b61a96c8"));
+
+	zmem_restore_vtable ();
+
+	zcrypto_hmac_free (hmac);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcryptohmac_invalid_test)
+{
+	zlibsys_init ();
+
+	puchar	digest[P_CRYPTO_HASH_MAX_LENGTH];
+	puchar	prk[P_CRYPTO_HASH_MAX_LENGTH];
+	psize	len;
+
+	P_TEST_CHECK (zcrypto_hmac_new ((PCryptoHashType) -1, NULL, 0) == NULL);
+	P_TEST_CHECK (zcrypto_hmac_new ((PCryptoHashType) 100, NULL, 0) == NULL);
+	P_TEST_CHECK (zcrypto_hmac_new (P_CRYPTO_HASH_TYPE_MD5, NULL, 10) == NULL);
+
+	zcrypto_hmac_update (NULL, (const puchar *) "abc", 3);
+	zcrypto_hmac_reset (NULL);
+	zcrypto_hmac_free (NULL);
+
+	len = sizeof (digest);
+	zcrypto_hmac_get_digest (NULL, digest, &len);
+	P_TEST_CHECK (len == 0);
+
+	zcrypto_hmac_get_digest (NULL, digest, NULL);
+
+	P_TEST_CHECK (zcrypto_hmac_get_length (NULL) == 0);
+	P_TEST_CHECK (zcrypto_hmac_get_type (NULL) == (PCryptoHashType) -1);
+	P_TEST_CHECK (zcrypto_hmac_compute (NULL, (const puchar *) "abc", 3, digest) == FALSE);
+
+	P_TEST_CHECK (zcrypto_hkdf_extract ((PCryptoHashType) -1, NULL, 0, NULL, 0, prk) == FALSE);
+	P_TEST_CHECK (zcrypto_hkdf_extract (P_CRYPTO_HASH_TYPE_SHA2_256, NULL, 0, NULL, 1, prk) == FALSE);
+	P_TEST_CHECK (zcrypto_hkdf_extract (P_CRYPTO_HASH_TYPE_SHA2_256, NULL, 0, NULL, 0, NULL) == FALSE);
+
+	memset (prk, 0, sizeof (prk));
+
+	P_TEST_CHECK (zcrypto_hkdf_expand ((PCryptoHashType) -1, prk, 32, NULL, 0, digest, 32) == FALSE);
+	P_TEST_CHECK (zcrypto_hkdf_expand (P_CRYPTO_HASH_TYPE_SHA2_256, NULL, 32, NULL, 0, digest, 32) == FALSE);
+	P_TEST_CHECK (zcrypto_hkdf_expand (P_CRYPTO_HASH_TYPE_SHA2_256, prk, 32, NULL, 1, digest, 32) == FALSE);
+	P_TEST_CHECK (zcrypto_hkdf_expand (P_CRYPTO_HASH_TYPE_SHA2_256, prk, 32, NULL, 0, NULL, 32) == FALSE);
+
+	/* The pseudorandom key must be at least of the digest length */
+	P_TEST_CHECK (zcrypto_hkdf_expand (P_CRYPTO_HASH_TYPE_SHA2_256, prk, 31, NULL, 0, digest, 32) == FALSE);
+
+	/* No more than 255 output blocks */
+	P_TEST_CHECK (zcrypto_hkdf_expand (P_CRYPTO_HASH_TYPE_SHA2_256, prk, 32, NULL, 0, digest, 255 * 32 + 1) == FALSE);
+
+	P_TEST_CHECK (zcrypto_hkdf (P_CRYPTO_HASH_TYPE_SHA2_256, NULL, 0, NULL, 1, NULL, 0, digest, 32) == FALSE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcryptohmac_general_test)
+{
+	zlibsys_init ();
+
+	PCryptoHmac	*hmac;
+	puchar		long_key[200];
+	puchar		digest[P_CRYPTO_HASH_MAX_LENGTH];
+	psize		len;
+
+	/* RFC 2202 and RFC 4231, test case 2 */
+	P_TEST_REQUIRE ((hmac = zcrypto_hmac_new (P_CRYPTO_HASH_TYPE_MD5,
+						  (const puchar *) pcryptohmac_jefe_key, 4)) != NULL);
+
+	P_TEST_CHECK (zcrypto_hmac_get_type (hmac) == P_CRYPTO_HASH_TYPE_MD5);
+	P_TEST_CHECK (zcrypto_hmac_get_length (hmac) == 16);
+
+	zcrypto_hmac_update (hmac, (const puchar *) pcryptohmac_jefe_data, 28);
+
+	len = 15;
+	zcrypto_hmac_get_digest (hmac, digest, &len);
+	P_TEST_CHECK (len == 0);
+
+	len = sizeof (digest);
+	zcrypto_hmac_get_digest (hmac, digest, &len);
+	P_TEST_CHECK (len == 16);
+	P_TEST_CHECK (check_hex (digest, len, "750c783e6ab0b503eaa86e310a5db738"));
+
+	zcrypto_hmac_free (hmac);
+
+	P_TEST_REQUIRE ((hmac = zcrypto_hmac_new (P_CRYPTO_HASH_TYPE_SHA1,
+						  (const puchar *) pcryptohmac_jefe_key, 4)) != NULL);
+
+	P_TEST_CHECK (zcrypto_hmac_compute (hmac, (const puchar *) pcryptohmac_jefe_data, 28, digest) == TRUE);
+	P_TEST_CHECK (check_hex (digest, 20, "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79"));
+
+	zcrypto_hmac_free (hmac);
+
+	/* Keys longer than the block size are hashed first (RFC 4231, test
+	 * case 6) */
+	memset (long_key, 0xAA, sizeof (long_key));
+
+	P_TEST_REQUIRE ((hmac = zcrypto_hmac_new (P_CRYPTO_HASH_TYPE_SHA2_512, long_key, 131)) != NULL);
+
+	P_TEST_CHECK (zcrypto_hmac_compute (hmac, (const puchar *) pcryptohmac_long_data, 54, digest) == TRUE);
+	P_TEST_CHECK (check_hex (digest, 64, "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+					     "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598"));
+
+	zcrypto_hmac_free (hmac);
+
+	/* SHA-3 uses the rate as the block size */
+	P_TEST_REQUIRE ((hmac = zcrypto_hmac_new (P_CRYPTO_HASH_TYPE_SHA3_512, long_key, 200)) != NULL);
+
+	P_TEST_CHECK (zcrypto_hmac_compute (hmac, (const puchar *) pcryptohmac_long_data, 54, digest) == TRUE);
+	P_TEST_CHECK (check_hex (digest, 64, "fafc7b7fe3332ce153966b27f6586fa5b49ec5d8dff3d7fd26a011451ca4c9de"
+					     "437913879159d9c5181a9a6f377ef18b48399756decea695b04fe90a9d3b93d1"));
+
+	zcrypto_hmac_free (hmac);
+
+	P_TEST_REQUIRE ((hmac = zcrypto_hmac_new (P_CRYPTO_HASH_TYPE_SHA3_256, (const puchar *) "key", 3)) != NULL);
+
+	zcrypto_hmac_update (hmac, (const puchar *) "The quick brown fox ", 20);
+	zcrypto_hmac_update (hmac, (const puchar *) "jumps over the lazy dog", 23);
+
+	len = sizeof (digest);
+	zcrypto_hmac_get_digest (hmac, digest, &len);
+	P_TEST_CHECK (len == 32);
+	P_TEST_CHECK (check_hex (digest, len, "8c6e0683409427f8931711b10ca92a506eb1fafa48fadd66d76126f47ac2c333"));
+
+	zcrypto_hmac_free (hmac);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcryptohmac_reuse_test)
+{
+	zlibsys_init ();
+
+	PCryptoHmac	*hmac;
+	puchar		data[300];
+	puchar		digest[P_CRYPTO_HASH_MAX_LENGTH];
+	puchar		ref[P_CRYPTO_HASH_MAX_LENGTH];
+	psize		len;
+	psize		ref_len;
+
+	for (int i = 0; i < 300; ++i)
+		data[i] = (puchar) (i * 7 + 1);
+
+	for (int type = (int) P_CRYPTO_HASH_TYPE_MD5; type <= (int) P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		P_TEST_REQUIRE ((hmac = zcrypto_hmac_new ((PCryptoHashType) type, data, 100)) != NULL);
+
+		for (psize msg_len = 0; msg_len < 300; msg_len += 37) {
+			zcrypto_hmac_reset (hmac);
+			zcrypto_hmac_update (hmac, data, msg_len / 2);
+			zcrypto_hmac_update (hmac, data + msg_len / 2, msg_len - msg_len / 2);
+
+			ref_len = sizeof (ref);
+			zcrypto_hmac_get_digest (hmac, ref, &ref_len);
+			P_TEST_CHECK (ref_len == (psize) zcrypto_hmac_get_length (hmac));
+
+			/* The context is closed until the next reset */
+			zcrypto_hmac_update (hmac, data, 10);
+
+			len = sizeof (digest);
+			zcrypto_hmac_get_digest (hmac, digest, &len);
+			P_TEST_CHECK (len == ref_len && memcmp (digest, ref, len) == 0);
+
+			/* One-shot result with the cached key */
+			memset (digest, 0, sizeof (digest));
+			P_TEST_CHECK (zcrypto_hmac_compute (hmac, data, msg_len, digest) == TRUE);
+			P_TEST_CHECK (memcmp (digest, ref, ref_len) == 0);
+		}
+
+		zcrypto_hmac_free (hmac);
+	}
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcryptohmac_hkdf_test)
+{
+	zlibsys_init ();
+
+	puchar	ikm[22];
+	puchar	salt[13];
+	puchar	info[10];
+	puchar	prk[P_CRYPTO_HASH_MAX_LENGTH];
+	puchar	okm[42];
+	puchar	okm_long[255 * 32];
+
+	memset (ikm, 0x0B, sizeof (ikm));
+
+	for (int i = 0; i < 13; ++i)
+		salt[i] = (puchar) i;
+
+	for (int i = 0; i < 10; ++i)
+		info[i] = (puchar) (0xF0 + i);
+
+	/* RFC 5869, test case 1 */
+	P_TEST_CHECK (zcrypto_hkdf_extract (P_CRYPTO_HASH_TYPE_SHA2_256, salt, sizeof (salt),
+					    ikm, sizeof (ikm), prk) == TRUE);
+	P_TEST_CHECK (check_hex (prk, 32, "077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5"));
+
+	P_TEST_CHECK (zcrypto_hkdf_expand (P_CRYPTO_HASH_TYPE_SHA2_256, prk, 32, info, sizeof (info),
+					   okm, sizeof (okm)) == TRUE);
+	P_TEST_CHECK (check_hex (okm, sizeof (okm), "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4"
+						    "c5bf34007208d5b887185865"));
+
+	memset (okm, 0, sizeof (okm));
+
+	P_TEST_CHECK (zcrypto_hkdf (P_CRYPTO_HASH_TYPE_SHA2_256, salt, sizeof (salt), ikm, sizeof (ikm),
+				    info, sizeof (info), okm, sizeof (okm)) == TRUE);
+	P_TEST_CHECK (check_hex (okm, sizeof (okm), "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4"
+						    "c5bf34007208d5b887185865"));
+
+	/* RFC 5869, test case 3: a missing salt is the same as an empty one */
+	P_TEST_CHECK (zcrypto_hkdf_extract (P_CRYPTO_HASH_TYPE_SHA2_256, NULL, 0, ikm, sizeof (ikm), prk) == TRUE);
+	P_TEST_CHECK (check_hex (prk, 32, "19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04"));
+
+	P_TEST_CHECK (zcrypto_hkdf_extract (P_CRYPTO_HASH_TYPE_SHA2_256, salt, 0, ikm, sizeof (ikm), prk) == TRUE);
+	P_TEST_CHECK (check_hex (prk, 32, "19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04"));
+
+	/* Output blocks are chained, so a shorter key is a prefix of a longer
+	 * one */
+	P_TEST_CHECK (zcrypto_hkdf_expand (P_CRYPTO_HASH_TYPE_SHA2_256, prk, 32, NULL, 0,
+					   okm_long, sizeof (okm_long)) == TRUE);
+	P_TEST_CHECK (zcrypto_hkdf_expand (P_CRYPTO_HASH_TYPE_SHA2_256, prk, 32, NULL, 0, okm, sizeof (okm)) == TRUE);
+	P_TEST_CHECK (memcmp (okm, okm_long, sizeof (okm)) == 0);
+	P_TEST_CHECK (check_hex (okm, sizeof (okm), "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c73"
+						    "8d2d9d201395faa4b61a96c8"));
+
+	P_TEST_CHECK (zcrypto_hkdf_expand (P_CRYPTO_HASH_TYPE_SHA2_256, prk, 32, NULL, 0, okm, 0) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pcryptohmac_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pcryptohmac_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pcryptohmac_general_test);
+	P_TEST_SUITE_RUN_CASE (pcryptohmac_reuse_test);
+	P_TEST_SUITE_RUN_CASE (pcryptohmac_hkdf_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,306 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PCUCKOO_FILTER_TEST_CAPACITY	10000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void cuckoo_filter_test_key (pint num, pchar *buf)
+{
+	sprintf (buf, "cuckoo_filter_key_%d", num);
+}
+
+P_TEST_CASE_BEGIN (pcuckoofilter_nomem_test)
+{
+	zlibsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zcuckoo_filter_new (100) == NULL);
+
+	zmem_restore_vtable ();
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcuckoofilter_invalid_test)
+{
+	zlibsys_init ();
+
+	puint64 buf[16];
+
+	P_TEST_CHECK (zcuckoo_filter_new (0) == NULL);
+	P_TEST_CHECK (zcuckoo_filter_new_from_image (NULL, 1024) == NULL);
+	P_TEST_CHECK (zcuckoo_filter_new_from_image (buf, 8) == NULL);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (zcuckoo_filter_new_from_image (buf, sizeof (buf)) == NULL);
+
+	P_TEST_CHECK (zcuckoo_filter_insert (NULL, "a", 1) == FALSE);
+	P_TEST_CHECK (zcuckoo_filter_contains (NULL, "a", 1) == FALSE);
+	P_TEST_CHECK (zcuckoo_filter_remove (NULL, "a", 1) == FALSE);
+	P_TEST_CHECK (zcuckoo_filter_get_count (NULL) == 0);
+	P_TEST_CHECK (zcuckoo_filter_get_image_size (NULL) == 0);
+	P_TEST_CHECK (zcuckoo_filter_save_image (NULL, buf, sizeof (buf)) == FALSE);
+
+	zcuckoo_filter_clear (NULL);
+	zcuckoo_filter_free (NULL);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcuckoofilter_general_test)
+{
+	zlibsys_init ();
+
+	PCuckooFilter	*filter;
+	pchar		key[64];
+	pint		false_positives;
+
+	filter = zcuckoo_filter_new (PCUCKOO_FILTER_TEST_CAPACITY);
+	P_TEST_REQUIRE (filter != NULL);
+
+	P_TEST_CHECK (zcuckoo_filter_get_count (filter) == 0);
+
+	for (pint i = 0; i < PCUCKOO_FILTER_TEST_CAPACITY; ++i) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_insert (filter, key, strlen (key)) == TRUE);
+	}
+
+	P_TEST_CHECK (zcuckoo_filter_get_count (filter) == PCUCKOO_FILTER_TEST_CAPACITY);
+
+	for (pint i = 0; i < PCUCKOO_FILTER_TEST_CAPACITY; ++i) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_contains (filter, key, strlen (key)) == TRUE);
+	}
+
+	false_positives = 0;
+
+	for (pint i = PCUCKOO_FILTER_TEST_CAPACITY; i < PCUCKOO_FILTER_TEST_CAPACITY * 11; ++i) {
+		cuckoo_filter_test_key (i, key);
+
+		if (zcuckoo_filter_contains (filter, key, strlen (key)))
+			++false_positives;
+	}
+
+	/* Expected probability is about 0.01% */
+	P_TEST_CHECK (false_positives < 100);
+
+	/* Remove every even element */
+	for (pint i = 0; i < PCUCKOO_FILTER_TEST_CAPACITY; i += 2) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_remove (filter, key, strlen (key)) == TRUE);
+	}
+
+	P_TEST_CHECK (zcuckoo_filter_get_count (filter) == PCUCKOO_FILTER_TEST_CAPACITY / 2);
+
+	false_positives = 0;
+
+	for (pint i = 0; i < PCUCKOO_FILTER_TEST_CAPACITY; ++i) {
+		cuckoo_filter_test_key (i, key);
+
+		if (i % 2 == 1)
+			P_TEST_CHECK (zcuckoo_filter_contains (filter, key, strlen (key)) == TRUE);
+		else if (zcuckoo_filter_contains (filter, key, strlen (key)))
+			++false_positives;
+	}
+
+	P_TEST_CHECK (false_positives < 10);
+
+	/* Duplicates are counted */
+	P_TEST_CHECK (zcuckoo_filter_insert (filter, "dup", 3) == TRUE);
+	P_TEST_CHECK (zcuckoo_filter_insert (filter, "dup", 3) == TRUE);
+	P_TEST_CHECK (zcuckoo_filter_remove (filter, "dup", 3) == TRUE);
+	P_TEST_CHECK (zcuckoo_filter_contains (filter, "dup", 3) == TRUE);
+	P_TEST_CHECK (zcuckoo_filter_remove (filter, "dup", 3) == TRUE);
+
+	zcuckoo_filter_clear (filter);
+	P_TEST_CHECK (zcuckoo_filter_get_count (filter) == 0);
+
+	for (pint i = 0; i < 100; ++i) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_contains (filter, key, strlen (key)) == FALSE);
+	}
+
+	zcuckoo_filter_free (filter);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcuckoofilter_full_test)
+{
+	zlibsys_init ();
+
+	PCuckooFilter	*filter;
+	pchar		key[64];
+	pint		inserted;
+
+	filter = zcuckoo_filter_new (100);
+	P_TEST_REQUIRE (filter != NULL);
+
+	for (inserted = 0; inserted < 100000; ++inserted) {
+		cuckoo_filter_test_key (inserted, key);
+
+		if (!zcuckoo_filter_insert (filter, key, strlen (key)))
+			break;
+	}
+
+	/* Capacity is rounded up to the power of two buckets */
+	P_TEST_CHECK (inserted >= 100);
+	P_TEST_CHECK (inserted < 100000);
+	P_TEST_CHECK (zcuckoo_filter_get_count (filter) == (psize) inserted);
+
+	for (pint i = 0; i < inserted; ++i) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_contains (filter, key, strlen (key)) == TRUE);
+	}
+
+	/* Removal frees space for new elements */
+	cuckoo_filter_test_key (0, key);
+	P_TEST_CHECK (zcuckoo_filter_remove (filter, key, strlen (key)) == TRUE);
+
+	for (pint i = 1; i < inserted; ++i) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_contains (filter, key, strlen (key)) == TRUE);
+	}
+
+	P_TEST_CHECK (zcuckoo_filter_insert (filter, key, strlen (key)) == TRUE);
+
+	zcuckoo_filter_free (filter);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcuckoofilter_image_test)
+{
+	zlibsys_init ();
+
+	PCuckooFilter	*filter;
+	PCuckooFilter	*image_filter;
+	PShm		*shm;
+	pchar		key[64];
+	psize		image_size;
+
+	filter = zcuckoo_filter_new (1000);
+	P_TEST_REQUIRE (filter != NULL);
+
+	for (pint i = 0; i < 1000; ++i) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_insert (filter, key, strlen (key)) == TRUE);
+	}
+
+	image_size = zcuckoo_filter_get_image_size (filter);
+	P_TEST_CHECK (image_size > 1000 * sizeof (puint16));
+
+	shm = zshm_new ("pcuckoofilter_test_image", image_size, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	zshm_take_ownership (shm);
+
+	P_TEST_CHECK (zcuckoo_filter_save_image (filter, zshm_get_address (shm), image_size - 1) == FALSE);
+	P_TEST_CHECK (zcuckoo_filter_save_image (filter, zshm_get_address (shm), zshm_get_size (shm)) == TRUE);
+
+	P_TEST_CHECK (zcuckoo_filter_new_from_image (zshm_get_address (shm), image_size - 1) == NULL);
+
+	image_filter = zcuckoo_filter_new_from_image (zshm_get_address (shm), zshm_get_size (shm));
+	P_TEST_REQUIRE (image_filter != NULL);
+
+	P_TEST_CHECK (zcuckoo_filter_get_count (image_filter) == 1000);
+	P_TEST_CHECK (zcuckoo_filter_get_image_size (image_filter) == image_size);
+
+	for (pint i = 0; i < 1000; ++i) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_contains (image_filter, key, strlen (key)) == TRUE);
+	}
+
+	for (pint i = 0; i < 500; ++i) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_remove (image_filter, key, strlen (key)) == TRUE);
+	}
+
+	zcuckoo_filter_free (image_filter);
+
+	/* Removals are stored in the image only */
+	image_filter = zcuckoo_filter_new_from_image (zshm_get_address (shm), zshm_get_size (shm));
+	P_TEST_REQUIRE (image_filter != NULL);
+
+	P_TEST_CHECK (zcuckoo_filter_get_count (image_filter) == 500);
+	P_TEST_CHECK (zcuckoo_filter_get_count (filter) == 1000);
+
+	for (pint i = 500; i < 1000; ++i) {
+		cuckoo_filter_test_key (i, key);
+		P_TEST_CHECK (zcuckoo_filter_contains (image_filter, key, strlen (key)) == TRUE);
+	}
+
+	zcuckoo_filter_free (image_filter);
+	zcuckoo_filter_free (filter);
+	zshm_free (shm);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pcuckoofilter_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pcuckoofilter_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pcuckoofilter_general_test);
+	P_TEST_SUITE_RUN_CASE (pcuckoofilter_full_test);
+	P_TEST_SUITE_RUN_CASE (pcuckoofilter_image_test);
+}
+P_TEST_SUITE_END()
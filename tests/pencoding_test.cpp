@@ -0,0 +1,282 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PENCODING_TEST_MAX_LEN	300
+
+static const pchar *base64_vectors[][2] = {
+	{"",       ""},
+	{"f",      "Zg=="},
+	{"fo",     "Zm8="},
+	{"foo",    "Zm9v"},
+	{"foob",   "Zm9vYg=="},
+	{"fooba",  "Zm9vYmE="},
+	{"foobar", "Zm9vYmFy"}
+};
+
+static void fill_random (puchar *data, psize len)
+{
+	psize i;
+
+	for (i = 0; i < len; ++i)
+		data[i] = (puchar) (rand () & 0xFF);
+}
+
+P_TEST_CASE_BEGIN (pencoding_invalid_test)
+{
+	pchar	str[16];
+	puchar	bin[16];
+
+	zlibsys_init ();
+
+	P_TEST_CHECK (zencoding_hex_encode (bin, 1, NULL, 16) == 0);
+	P_TEST_CHECK (zencoding_hex_encode (bin, 1, str, 0) == 0);
+	P_TEST_CHECK (zencoding_hex_encode (NULL, 1, str, 16) == 0);
+	P_TEST_CHECK (str[0] == '\0');
+
+	P_TEST_CHECK (zencoding_hex_decode (NULL, 2, bin, 16) == -1);
+	P_TEST_CHECK (zencoding_hex_decode ("00", 2, NULL, 16) == -1);
+	P_TEST_CHECK (zencoding_hex_decode (NULL, 0, NULL, 0) == 0);
+
+	P_TEST_CHECK (zencoding_base64_encode (bin, 1, NULL, 16) == 0);
+	P_TEST_CHECK (zencoding_base64_encode (bin, 1, str, 0) == 0);
+	P_TEST_CHECK (zencoding_base64_encode (NULL, 1, str, 16) == 0);
+	P_TEST_CHECK (str[0] == '\0');
+
+	P_TEST_CHECK (zencoding_base64_decode (NULL, 4, bin, 16) == -1);
+	P_TEST_CHECK (zencoding_base64_decode ("Zm9v", 4, NULL, 16) == -1);
+	P_TEST_CHECK (zencoding_base64_decode (NULL, 0, NULL, 0) == 0);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pencoding_hex_test)
+{
+	pchar	str[16];
+	puchar	bin[8];
+
+	zlibsys_init ();
+
+	bin[0] = 0x01;
+	bin[1] = 0xAB;
+	bin[2] = 0xF0;
+
+	P_TEST_CHECK (zencoding_hex_encode (bin, 0, str, 1) == 0);
+	P_TEST_CHECK (str[0] == '\0');
+
+	P_TEST_CHECK (zencoding_hex_encode (bin, 3, str, sizeof (str)) == 6);
+	P_TEST_CHECK (strcmp (str, "01abf0") == 0);
+
+	/* No room for the terminating zero */
+	P_TEST_CHECK (zencoding_hex_encode (bin, 3, str, 6) == 0);
+	P_TEST_CHECK (str[0] == '\0');
+	P_TEST_CHECK (zencoding_hex_encode (bin, 3, str, 7) == 6);
+
+	memset (bin, 0, sizeof (bin));
+
+	P_TEST_CHECK (zencoding_hex_decode ("01ABf0", 6, bin, sizeof (bin)) == 3);
+	P_TEST_CHECK (bin[0] == 0x01 && bin[1] == 0xAB && bin[2] == 0xF0);
+	P_TEST_CHECK (zencoding_hex_decode ("01ABf0", 6, bin, 3) == 3);
+	P_TEST_CHECK (zencoding_hex_decode ("01ABf0", 6, bin, 2) == -1);
+	P_TEST_CHECK (zencoding_hex_decode ("01A", 3, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_hex_decode ("0g", 2, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_hex_decode ("G0", 2, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_hex_decode (" 0", 2, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_hex_decode ("", 0, bin, 0) == 0);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pencoding_base64_test)
+{
+	pchar	str[16];
+	puchar	bin[16];
+	psize	i;
+	psize	len;
+
+	zlibsys_init ();
+
+	for (i = 0; i < sizeof (base64_vectors) / sizeof (base64_vectors[0]); ++i) {
+		len = strlen (base64_vectors[i][0]);
+
+		P_TEST_CHECK (zencoding_base64_encode ((const puchar *) base64_vectors[i][0],
+						       len,
+						       str,
+						       sizeof (str)) == strlen (base64_vectors[i][1]));
+		P_TEST_CHECK (strcmp (str, base64_vectors[i][1]) == 0);
+
+		P_TEST_CHECK (zencoding_base64_decode (base64_vectors[i][1],
+						       strlen (base64_vectors[i][1]),
+						       bin,
+						       sizeof (bin)) == (pssize) len);
+		P_TEST_CHECK (memcmp (bin, base64_vectors[i][0], len) == 0);
+
+		/* Exact output size is enough */
+		P_TEST_CHECK (zencoding_base64_decode (base64_vectors[i][1],
+						       strlen (base64_vectors[i][1]),
+						       bin,
+						       len) == (pssize) len);
+
+		if (len > 0) {
+			P_TEST_CHECK (zencoding_base64_decode (base64_vectors[i][1],
+							       strlen (base64_vectors[i][1]),
+							       bin,
+							       len - 1) == -1);
+			P_TEST_CHECK (zencoding_base64_encode ((const puchar *) base64_vectors[i][0],
+							       len,
+							       str,
+							       strlen (base64_vectors[i][1])) == 0);
+			P_TEST_CHECK (str[0] == '\0');
+		}
+	}
+
+	/* Padding is optional */
+	P_TEST_CHECK (zencoding_base64_decode ("Zg", 2, bin, sizeof (bin)) == 1);
+	P_TEST_CHECK (bin[0] == 'f');
+	P_TEST_CHECK (zencoding_base64_decode ("Zm9vYmE", 7, bin, sizeof (bin)) == 5);
+	P_TEST_CHECK (memcmp (bin, "fooba", 5) == 0);
+
+	/* But must be correct if present */
+	P_TEST_CHECK (zencoding_base64_decode ("Zg=", 3, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_base64_decode ("Z===", 4, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_base64_decode ("Zm9v=", 5, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_base64_decode ("Zg==Zm9v", 8, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_base64_decode ("Z", 1, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_base64_decode ("Zm9vY", 5, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_base64_decode ("Zm 9v", 5, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_base64_decode ("Zm9v\n", 5, bin, sizeof (bin)) == -1);
+	P_TEST_CHECK (zencoding_base64_decode ("Zm-v", 4, bin, sizeof (bin)) == -1);
+
+	P_TEST_CHECK (zencoding_base64_encode ((const puchar *) "\xFB\xFF", 2, str, sizeof (str)) == 4);
+	P_TEST_CHECK (strcmp (str, "+/8=") == 0);
+	P_TEST_CHECK (zencoding_base64_decode ("+/8=", 4, bin, sizeof (bin)) == 2);
+	P_TEST_CHECK (bin[0] == 0xFB && bin[1] == 0xFF);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pencoding_roundtrip_test)
+{
+	puchar	*data;
+	puchar	*decoded;
+	pchar	*str;
+	pchar	*ref;
+	psize	len;
+	psize	enc_len;
+	psize	i;
+	pchar	saved;
+
+	zlibsys_init ();
+
+	srand (1234);
+
+	data    = (puchar *) zmalloc0 (PENCODING_TEST_MAX_LEN);
+	decoded = (puchar *) zmalloc0 (PENCODING_TEST_MAX_LEN);
+	str     = (pchar *) zmalloc0 (PENCODING_TEST_MAX_LEN * 2 + 1);
+	ref     = (pchar *) zmalloc0 (PENCODING_TEST_MAX_LEN * 2 + 1);
+
+	P_TEST_REQUIRE (data != NULL && decoded != NULL && str != NULL && ref != NULL);
+
+	for (len = 0; len <= PENCODING_TEST_MAX_LEN; ++len) {
+		fill_random (data, len);
+
+		/* Hex, compared with a byte-by-byte encoding */
+		for (i = 0; i < len; ++i)
+			sprintf (ref + 2 * i, "%02x", data[i]);
+
+		ref[len * 2] = '\0';
+
+		enc_len = zencoding_hex_encode (data, len, str, len * 2 + 1);
+		P_TEST_CHECK (enc_len == len * 2);
+		P_TEST_CHECK (strcmp (str, ref) == 0);
+
+		P_TEST_CHECK (zencoding_hex_decode (str, enc_len, decoded, len) == (pssize) len);
+		P_TEST_CHECK (memcmp (data, decoded, len) == 0);
+
+		for (i = 0; i < enc_len; ++i) {
+			if (str[i] >= 'a' && str[i] <= 'f')
+				str[i] = (pchar) (str[i] - 'a' + 'A');
+		}
+
+		P_TEST_CHECK (zencoding_hex_decode (str, enc_len, decoded, len) == (pssize) len);
+		P_TEST_CHECK (memcmp (data, decoded, len) == 0);
+
+		if (len > 0) {
+			i = (psize) rand () % enc_len;
+
+			saved  = str[i];
+			str[i] = 'x';
+			P_TEST_CHECK (zencoding_hex_decode (str, enc_len, decoded, len) == -1);
+			str[i] = saved;
+		}
+
+		/* Base64 */
+		enc_len = zencoding_base64_encode (data, len, str, P_ENCODING_BASE64_ENCODED_LEN (len) + 1);
+		P_TEST_CHECK (enc_len == P_ENCODING_BASE64_ENCODED_LEN (len));
+		P_TEST_CHECK (strlen (str) == enc_len);
+
+		memset (decoded, 0, PENCODING_TEST_MAX_LEN);
+		P_TEST_CHECK (zencoding_base64_decode (str, enc_len, decoded, len) == (pssize) len);
+		P_TEST_CHECK (memcmp (data, decoded, len) == 0);
+
+		for (i = 0; i < enc_len; ++i) {
+			if (str[i] == '=')
+				break;
+
+			saved  = str[i];
+			str[i] = (pchar) ((i % 3 == 0) ? '*' : (i % 3 == 1) ? '\0' : '\x80');
+			P_TEST_CHECK (zencoding_base64_decode (str, enc_len, decoded, len) == -1);
+			str[i] = saved;
+		}
+	}
+
+	zfree (data);
+	zfree (decoded);
+	zfree (str);
+	zfree (ref);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pencoding_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pencoding_hex_test);
+	P_TEST_SUITE_RUN_CASE (pencoding_base64_test);
+	P_TEST_SUITE_RUN_CASE (pencoding_roundtrip_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,237 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PFASTHASH_BUF_SIZE	5000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+/* Reference values are produced by the xxHash library (XXH3_64bits_withSeed
+ * and XXH3_128bits_withSeed) over the buffer from fill_buffer() */
+static const struct {
+	psize		len;
+	puint64		seed;
+	puint64		hash64;
+	puint64		hash128_high;
+	puint64		hash128_low;
+} pfasthash_etalons[] = {
+	{ 0,    0x0ULL,                0x2D06800538D394C2ULL, 0x99AA06D3014798D8ULL, 0x6001C324468D497FULL },
+	{ 0,    0x1ULL,                0x4DC5B0CC826F6703ULL, 0xD9265CC53BB2B9AEULL, 0x6131B78F753823CDULL },
+	{ 1,    0x0ULL,                0x4C5CCA45D0F4811FULL, 0x495B62073EF70CA4ULL, 0x4C5CCA45D0F4811FULL },
+	{ 2,    0x2AULL,               0xED2E7515375A990CULL, 0xF87C46D861458D5FULL, 0xED2E7515375A990CULL },
+	{ 3,    0x0ULL,                0x15F7093B173D005CULL, 0x46F66CB935381565ULL, 0x15F7093B173D005CULL },
+	{ 4,    0x0ULL,                0xDCA012F95811B6B9ULL, 0x7FEFEEFFB4D0EAB3ULL, 0xB987CA5D9241572AULL },
+	{ 7,    0x2AULL,               0x6C5B5E17C0E5E559ULL, 0xF39C5213EEE07E81ULL, 0x933C86428EB9E90BULL },
+	{ 8,    0x0ULL,                0xDEC6A9A43575982EULL, 0x803C675A846CC6C2ULL, 0x56BB836CEB6D4BAAULL },
+	{ 9,    0x0ULL,                0xCBE393399F17FFBDULL, 0xD46556872D230F22ULL, 0x4376673580310154ULL },
+	{ 16,   0x0ULL,                0x7E484C18D74895D0ULL, 0x650FE308C566747DULL, 0xF853DD94614DFA07ULL },
+	{ 17,   0x0ULL,                0x208BDE5EE2BED407ULL, 0x18217300B5132D5AULL, 0x78C349FE81B2F26CULL },
+	{ 100,  0x2AULL,               0x4CA5C3A331119E67ULL, 0x50524DAC88F99C9AULL, 0x145AAF80746EBA85ULL },
+	{ 128,  0x0ULL,                0xF92B70EAA21A6288ULL, 0xB4F87B99D2DB8A51ULL, 0x1E04FAD9F0CACB4DULL },
+	{ 129,  0x0ULL,                0xF8F76713F2BB60FAULL, 0x6881633650CD8924ULL, 0xC51BC887976AEF63ULL },
+	{ 240,  0x0ULL,                0xCCC7375172C41F03ULL, 0xDE57AAB31E77A2FFULL, 0x93E173833F75AB66ULL },
+	{ 241,  0x0ULL,                0x0B3B630948CE4A00ULL, 0x92B991A7192F3F08ULL, 0x0B3B630948CE4A00ULL },
+	{ 1024, 0x0ULL,                0x23BC880EBF0D29C6ULL, 0x4C17271C906DF792ULL, 0x23BC880EBF0D29C6ULL },
+	{ 1025, 0x0ULL,                0xC09FDFBC398C7D82ULL, 0x70A4EB1B9691D77FULL, 0xC09FDFBC398C7D82ULL },
+	{ 5000, 0x0ULL,                0x559FFF92C2B7F8EEULL, 0x3BF60AA89C7FEEAAULL, 0x559FFF92C2B7F8EEULL },
+	{ 5000, 0x9E3779B97F4A7C15ULL, 0xD5959148128EBCABULL, 0xB31EE1F8EA37CC11ULL, 0xD5959148128EBCABULL }
+};
+
+static void
+fill_buffer (puchar *buf, psize len)
+{
+	for (psize i = 0; i < len; ++i)
+		buf[i] = (puchar) (i * 31 + 7);
+}
+
+P_TEST_CASE_BEGIN (pfasthash_nomem_test)
+{
+	zlibsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zfast_hash_new (0) == NULL);
+
+	/* One-shot hashing doesn't allocate memory */
+	P_TEST_CHECK (zfast_hash64 ("abc", 3, 0) == 0x78AF5F94892F3950ULL);
+
+	zmem_restore_vtable ();
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfasthash_invalid_test)
+{
+	zlibsys_init ();
+
+	PFastHash128	result;
+
+	P_TEST_CHECK (zfast_hash64 (NULL, 10, 0) == 0);
+
+	result.low  = 1;
+	result.high = 1;
+	zfast_hash128 (NULL, 10, 0, &result);
+	P_TEST_CHECK (result.low == 0 && result.high == 0);
+
+	zfast_hash128 ("abc", 3, 0, NULL);
+
+	zfast_hash_update (NULL, "abc", 3);
+	zfast_hash_reset (NULL, 0);
+	zfast_hash_digest128 (NULL, &result);
+	zfast_hash_free (NULL);
+
+	P_TEST_CHECK (zfast_hash_digest64 (NULL) == 0);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfasthash_oneshot_test)
+{
+	zlibsys_init ();
+
+	puchar		*buf;
+	PFastHash128	result;
+
+	buf = (puchar *) zmalloc0 (PFASTHASH_BUF_SIZE);
+	P_TEST_REQUIRE (buf != NULL);
+
+	fill_buffer (buf, PFASTHASH_BUF_SIZE);
+
+	for (psize i = 0; i < sizeof (pfasthash_etalons) / sizeof (pfasthash_etalons[0]); ++i) {
+		psize	len  = pfasthash_etalons[i].len;
+		puint64	seed = pfasthash_etalons[i].seed;
+
+		P_TEST_CHECK (zfast_hash64 (buf, len, seed) == pfasthash_etalons[i].hash64);
+
+		zfast_hash128 (buf, len, seed, &result);
+
+		P_TEST_CHECK (result.high == pfasthash_etalons[i].hash128_high);
+		P_TEST_CHECK (result.low  == pfasthash_etalons[i].hash128_low);
+	}
+
+	/* Unaligned input */
+	memmove (buf + 1, buf, PFASTHASH_BUF_SIZE - 1);
+	P_TEST_CHECK (zfast_hash64 (buf + 1, 1025, 0) == 0xC09FDFBC398C7D82ULL);
+
+	zfree (buf);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfasthash_streaming_test)
+{
+	zlibsys_init ();
+
+	PFastHash	*hash;
+	puchar		*buf;
+	PFastHash128	result;
+	PFastHash128	stream_result;
+
+	buf = (puchar *) zmalloc0 (PFASTHASH_BUF_SIZE);
+	P_TEST_REQUIRE (buf != NULL);
+
+	fill_buffer (buf, PFASTHASH_BUF_SIZE);
+
+	hash = zfast_hash_new (0);
+	P_TEST_REQUIRE (hash != NULL);
+
+	P_TEST_CHECK (zfast_hash_digest64 (hash) == 0x2D06800538D394C2ULL);
+
+	const psize lengths[] = {0, 3, 16, 128, 240, 241, 255, 256, 257, 511, 1024, 1025, 1088, 2049, 5000};
+	const psize chunks[]  = {1, 7, 63, 64, 65, 255, 256, 257, 1024, 5000};
+
+	for (psize i = 0; i < sizeof (lengths) / sizeof (lengths[0]); ++i) {
+		for (psize j = 0; j < sizeof (chunks) / sizeof (chunks[0]); ++j) {
+			puint64 seed = (puint64) j * 0x9E3779B97F4A7C15ULL;
+
+			zfast_hash_reset (hash, seed);
+
+			for (psize offset = 0; offset < lengths[i]; offset += chunks[j])
+				zfast_hash_update (hash,
+						   buf + offset,
+						   lengths[i] - offset < chunks[j] ? lengths[i] - offset : chunks[j]);
+
+			zfast_hash128 (buf, lengths[i], seed, &result);
+			zfast_hash_digest128 (hash, &stream_result);
+
+			P_TEST_CHECK (zfast_hash_digest64 (hash) == zfast_hash64 (buf, lengths[i], seed));
+			P_TEST_CHECK (stream_result.low  == result.low);
+			P_TEST_CHECK (stream_result.high == result.high);
+		}
+	}
+
+	/* Digest doesn't finalize the state */
+	zfast_hash_reset (hash, 0);
+	zfast_hash_update (hash, buf, 1000);
+	P_TEST_CHECK (zfast_hash_digest64 (hash) == zfast_hash64 (buf, 1000, 0));
+	zfast_hash_update (hash, buf + 1000, 4000);
+	P_TEST_CHECK (zfast_hash_digest64 (hash) == 0x559FFF92C2B7F8EEULL);
+
+	zfast_hash_free (hash);
+	zfree (buf);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pfasthash_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pfasthash_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pfasthash_oneshot_test);
+	P_TEST_SUITE_RUN_CASE (pfasthash_streaming_test);
+}
+P_TEST_SUITE_END()
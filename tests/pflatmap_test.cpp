@@ -0,0 +1,356 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PFLATMAP_TEST_NKEYS	3000
+
+typedef struct _FlatMapCollectData {
+	pint		count;
+	pint		last;
+	pboolean	ordered;
+	pint		stop_at;
+	pint		*values;
+} FlatMapCollectData;
+
+static pint flat_map_test_key_destroyed = 0;
+static pint flat_map_test_value_destroyed = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+extern "C" pint flat_map_test_compare (pconstpointer a, pconstpointer b)
+{
+	pint p1 = PPOINTER_TO_INT (a);
+	pint p2 = PPOINTER_TO_INT (b);
+
+	if (p1 < p2)
+		return -1;
+	else if (p1 > p2)
+		return 1;
+	else
+		return 0;
+}
+
+extern "C" pint flat_map_test_compare_data (pconstpointer a, pconstpointer b, ppointer data)
+{
+	P_UNUSED (data);
+
+	return flat_map_test_compare (a, b);
+}
+
+extern "C" void flat_map_test_key_destroy (ppointer data)
+{
+	P_UNUSED (data);
+	++flat_map_test_key_destroyed;
+}
+
+extern "C" void flat_map_test_value_destroy (ppointer data)
+{
+	P_UNUSED (data);
+	++flat_map_test_value_destroyed;
+}
+
+extern "C" pboolean flat_map_test_collect (ppointer key, ppointer value, ppointer user_data)
+{
+	FlatMapCollectData *data = (FlatMapCollectData *) user_data;
+
+	if (PPOINTER_TO_INT (key) <= data->last)
+		data->ordered = FALSE;
+
+	if (data->values != NULL && data->values[PPOINTER_TO_INT (key)] != PPOINTER_TO_INT (value))
+		data->ordered = FALSE;
+
+	data->last = PPOINTER_TO_INT (key);
+	++data->count;
+
+	return data->count == data->stop_at;
+}
+
+static void flat_map_test_init_collect (FlatMapCollectData *data, pint *values)
+{
+	memset (data, 0, sizeof (FlatMapCollectData));
+
+	data->last    = -1;
+	data->ordered = TRUE;
+	data->values  = values;
+}
+
+static pboolean flat_map_test_check (PFlatMap *map, pint *values)
+{
+	FlatMapCollectData	collect;
+	pint			count;
+
+	count = 0;
+
+	for (pint i = 0; i < PFLATMAP_TEST_NKEYS; ++i) {
+		if (values[i] == 0) {
+			if (zflat_map_contains (map, PINT_TO_POINTER (i)) == TRUE)
+				return FALSE;
+		} else {
+			if (PPOINTER_TO_INT (zflat_map_lookup (map, PINT_TO_POINTER (i))) != values[i])
+				return FALSE;
+
+			++count;
+		}
+	}
+
+	if (zflat_map_get_nnodes (map) != count)
+		return FALSE;
+
+	flat_map_test_init_collect (&collect, values);
+	zflat_map_foreach (map, flat_map_test_collect, &collect);
+
+	return collect.ordered == TRUE && collect.count == count;
+}
+
+P_TEST_CASE_BEGIN (pflatmap_nomem_test)
+{
+	zlibsys_init ();
+
+	PFlatMap	*map;
+	PMemVTable	vtable;
+
+	map = zflat_map_new (flat_map_test_compare);
+	P_TEST_REQUIRE (map != NULL);
+
+	/* Pending entries are merged without extra memory */
+	for (pint i = 100; i > 0; --i)
+		P_TEST_CHECK (zflat_map_insert (map, PINT_TO_POINTER (i), PINT_TO_POINTER (i)) == TRUE);
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zflat_map_new (flat_map_test_compare) == NULL);
+	P_TEST_CHECK (zflat_map_new_with_data (flat_map_test_compare_data, NULL) == NULL);
+	P_TEST_CHECK (zflat_map_reserve (map, 1000) == FALSE);
+
+	P_TEST_CHECK (zflat_map_get_nnodes (map) == 100);
+	P_TEST_CHECK (zflat_map_lookup (map, PINT_TO_POINTER (50)) == PINT_TO_POINTER (50));
+
+	zmem_restore_vtable ();
+
+	zflat_map_free (map);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pflatmap_invalid_test)
+{
+	zlibsys_init ();
+
+	P_TEST_CHECK (zflat_map_new (NULL) == NULL);
+	P_TEST_CHECK (zflat_map_new_with_data (NULL, NULL) == NULL);
+	P_TEST_CHECK (zflat_map_new_full (NULL, NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (zflat_map_reserve (NULL, 10) == FALSE);
+	P_TEST_CHECK (zflat_map_insert (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (zflat_map_remove (NULL, NULL) == FALSE);
+	P_TEST_CHECK (zflat_map_lookup (NULL, NULL) == NULL);
+	P_TEST_CHECK (zflat_map_contains (NULL, NULL) == FALSE);
+	P_TEST_CHECK (zflat_map_get_nnodes (NULL) == 0);
+
+	zflat_map_commit (NULL);
+	zflat_map_foreach (NULL, NULL, NULL);
+	zflat_map_foreach_range (NULL, NULL, NULL, NULL, NULL);
+	zflat_map_clear (NULL);
+	zflat_map_free (NULL);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pflatmap_general_test)
+{
+	zlibsys_init ();
+
+	PFlatMap		*map;
+	FlatMapCollectData	collect;
+	pint			*values;
+	pint			key;
+	pint			batch;
+	pint			count;
+
+	flat_map_test_key_destroyed   = 0;
+	flat_map_test_value_destroyed = 0;
+
+	map    = zflat_map_new_full (flat_map_test_compare_data,
+				     NULL,
+				     flat_map_test_key_destroy,
+				     flat_map_test_value_destroy);
+	values = (pint *) zmalloc0 (PFLATMAP_TEST_NKEYS * sizeof (pint));
+	P_TEST_REQUIRE (map != NULL && values != NULL);
+
+	P_TEST_CHECK (zflat_map_get_nnodes (map) == 0);
+	P_TEST_CHECK (zflat_map_lookup (map, PINT_TO_POINTER (10)) == NULL);
+	P_TEST_CHECK (zflat_map_remove (map, PINT_TO_POINTER (10)) == FALSE);
+	P_TEST_CHECK (zflat_map_reserve (map, 100) == TRUE);
+
+	srand (400);
+
+	/* Batches of various sizes with duplicated keys, including the keys
+	 * duplicated within the same batch */
+	count = 0;
+
+	for (pint round = 0; round < 40; ++round) {
+		batch = (round % 5 == 0) ? rand () % 5 + 1 : rand () % 300 + 1;
+
+		for (pint i = 0; i < batch; ++i) {
+			key = rand () % PFLATMAP_TEST_NKEYS;
+
+			P_TEST_CHECK (zflat_map_insert (map,
+							PINT_TO_POINTER (key),
+							PINT_TO_POINTER (++count)) == TRUE);
+
+			values[key] = count;
+		}
+
+		P_TEST_CHECK (flat_map_test_check (map, values) == TRUE);
+
+		/* Remove some keys */
+		for (pint i = 0; i < batch / 4; ++i) {
+			key = rand () % PFLATMAP_TEST_NKEYS;
+
+			P_TEST_CHECK (zflat_map_remove (map, PINT_TO_POINTER (key)) == (values[key] != 0));
+			values[key] = 0;
+		}
+	}
+
+	P_TEST_CHECK (flat_map_test_check (map, values) == TRUE);
+
+	/* Every replaced or removed pair has been destroyed */
+	P_TEST_CHECK (flat_map_test_key_destroyed + zflat_map_get_nnodes (map) == count);
+	P_TEST_CHECK (flat_map_test_value_destroyed == flat_map_test_key_destroyed);
+
+	/* Range iteration */
+	flat_map_test_init_collect (&collect, values);
+	collect.last = 999;
+
+	zflat_map_foreach_range (map,
+				 PINT_TO_POINTER (1000),
+				 PINT_TO_POINTER (2000),
+				 flat_map_test_collect,
+				 &collect);
+
+	key = 0;
+
+	for (pint i = 1000; i < 2000; ++i) {
+		if (values[i] != 0)
+			++key;
+	}
+
+	P_TEST_CHECK (collect.count == key);
+	P_TEST_CHECK (collect.ordered == TRUE);
+	P_TEST_CHECK (collect.last < 2000);
+
+	flat_map_test_init_collect (&collect, values);
+
+	zflat_map_foreach_range (map,
+				 PINT_TO_POINTER (PFLATMAP_TEST_NKEYS),
+				 PINT_TO_POINTER (PFLATMAP_TEST_NKEYS * 2),
+				 flat_map_test_collect,
+				 &collect);
+
+	P_TEST_CHECK (collect.count == 0);
+
+	/* Stop the iteration */
+	flat_map_test_init_collect (&collect, values);
+	collect.stop_at = 7;
+
+	zflat_map_foreach (map, flat_map_test_collect, &collect);
+
+	P_TEST_CHECK (collect.count == 7);
+
+	/* Pending pairs are destroyed on clear as well */
+	zflat_map_insert (map, PINT_TO_POINTER (1), PINT_TO_POINTER (1));
+
+	count                       = zflat_map_get_nnodes (map);
+	flat_map_test_key_destroyed = 0;
+
+	zflat_map_insert (map, PINT_TO_POINTER (PFLATMAP_TEST_NKEYS + 1), PINT_TO_POINTER (1));
+	zflat_map_insert (map, PINT_TO_POINTER (0), PINT_TO_POINTER (1));
+	zflat_map_clear (map);
+
+	P_TEST_CHECK (flat_map_test_key_destroyed == count + 2);
+	P_TEST_CHECK (zflat_map_get_nnodes (map) == 0);
+
+	/* Ascending insertion keeps the map sorted */
+	for (pint i = 0; i < PFLATMAP_TEST_NKEYS; ++i) {
+		values[i] = i + 1;
+		P_TEST_CHECK (zflat_map_insert (map, PINT_TO_POINTER (i), PINT_TO_POINTER (i + 1)) == TRUE);
+	}
+
+	P_TEST_CHECK (flat_map_test_check (map, values) == TRUE);
+
+	/* Descending insertion */
+	zflat_map_clear (map);
+
+	for (pint i = PFLATMAP_TEST_NKEYS - 1; i >= 0; --i)
+		P_TEST_CHECK (zflat_map_insert (map, PINT_TO_POINTER (i), PINT_TO_POINTER (i + 1)) == TRUE);
+
+	P_TEST_CHECK (flat_map_test_check (map, values) == TRUE);
+
+	flat_map_test_key_destroyed = 0;
+
+	zflat_map_free (map);
+	zfree (values);
+
+	P_TEST_CHECK (flat_map_test_key_destroyed == PFLATMAP_TEST_NKEYS);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pflatmap_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pflatmap_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pflatmap_general_test);
+}
+P_TEST_SUITE_END()
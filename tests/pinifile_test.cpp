@@ -35,6 +35,15 @@ P_TEST_MODULE_INIT ();
 
 #define PINIFILE_STRESS_LINE	2048
 #define PINIFILE_MAX_LINE	1024
+#define PINIFILE_MANY_SECTIONS	50
+#define PINIFILE_MANY_KEYS	200
+#define PINIFILE_RELOAD_THREADS	4
+#define PINIFILE_RELOAD_ROUNDS	200
+#define PINIFILE_RELOAD_MAX_BLOCKS	1000
+
+static volatile pint pinifile_reload_stop   = 0;
+static volatile pint pinifile_reload_errors = 0;
+static volatile pint pinifile_reload_blocks = 0;
 
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
@@ -54,6 +63,23 @@ extern "C" void pmem_free (ppointer block)
 	P_UNUSED (block);
 }
 
+extern "C" ppointer pmem_count_alloc (psize nbytes)
+{
+	zatomic_int_inc (&pinifile_reload_blocks);
+	return malloc (nbytes);
+}
+
+extern "C" ppointer pmem_count_realloc (ppointer block, psize nbytes)
+{
+	return realloc (block, nbytes);
+}
+
+extern "C" void pmem_count_free (ppointer block)
+{
+	zatomic_int_add (&pinifile_reload_blocks, -1);
+	free (block);
+}
+
 static bool create_test_ini_file (bool last_empty_section)
 {
 	FILE *file = fopen ("." P_DIR_SEPARATOR "zini_test_file.ini", "w");
@@ -114,6 +140,48 @@ static bool create_test_ini_file (bool last_empty_section)
 	return fclose (file) == 0;
 }
 
+static bool create_reload_ini_file (pint version, pint nkeys)
+{
+	FILE *file = fopen ("." P_DIR_SEPARATOR "zini_test_file_reload.ini", "w");
+
+	if (file == NULL)
+		return false;
+
+	fprintf (file, "[static_section]\n");
+	fprintf (file, "static_parameter = 42\n");
+
+	fprintf (file, "[dynamic_section]\n");
+	fprintf (file, "version = %d\n", version);
+
+	for (pint i = 0; i < nkeys; ++i)
+		fprintf (file, "key_%d = %d\n", i, i);
+
+	return fclose (file) == 0;
+}
+
+static ppointer pinifile_reload_thread_func (ppointer data)
+{
+	PIniFile *ini = (PIniFile *) data;
+
+	while (zatomic_int_get (&pinifile_reload_stop) == 0) {
+		if (zini_file_parameter_int (ini, "static_section", "static_parameter", -1) != 42)
+			zatomic_int_inc (&pinifile_reload_errors);
+
+		if (zini_file_parameter_int (ini, "dynamic_section", "version", -1) < 0)
+			zatomic_int_inc (&pinifile_reload_errors);
+
+		PList *keys = zini_file_keys (ini, "dynamic_section");
+
+		if (keys == NULL)
+			zatomic_int_inc (&pinifile_reload_errors);
+
+		zlist_foreach (keys, (PFunc) zfree, NULL);
+		zlist_free (keys);
+	}
+
+	return NULL;
+}
+
 P_TEST_CASE_BEGIN (pinifile_nomem_test)
 {
 	zlibsys_init ();
@@ -348,10 +416,442 @@ P_TEST_CASE_BEGIN (pinifile_read_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pinifile_many_keys_test)
+{
+	pchar	section[32];
+	pchar	key[32];
+	pchar	*str_val;
+
+	zlibsys_init ();
+
+	FILE *file = fopen ("." P_DIR_SEPARATOR "zini_test_file_many.ini", "w");
+	P_TEST_REQUIRE (file != NULL);
+
+	for (int i = 0; i < PINIFILE_MANY_SECTIONS; ++i) {
+		fprintf (file, "[section_%d]\n", i);
+
+		for (int j = 0; j < PINIFILE_MANY_KEYS; ++j)
+			fprintf (file, "key_%d = %d\n", j, i * PINIFILE_MANY_KEYS + j);
+
+		/* The last value wins for a duplicated key */
+		fprintf (file, "key_0 = -1\n");
+	}
+
+	P_TEST_REQUIRE (fclose (file) == 0);
+
+	PIniFile *ini = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file_many.ini");
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+
+	PList *section_list = zini_file_sections (ini);
+	P_TEST_CHECK (zlist_length (section_list) == PINIFILE_MANY_SECTIONS);
+	zlist_foreach (section_list, (PFunc) zfree, NULL);
+	zlist_free (section_list);
+
+	for (int i = 0; i < PINIFILE_MANY_SECTIONS; ++i) {
+		sprintf (section, "section_%d", i);
+
+		PList *key_list = zini_file_keys (ini, section);
+		P_TEST_CHECK (zlist_length (key_list) == PINIFILE_MANY_KEYS + 1);
+		zlist_foreach (key_list, (PFunc) zfree, NULL);
+		zlist_free (key_list);
+
+		P_TEST_CHECK (zini_file_parameter_int (ini, section, "key_0", 0) == -1);
+
+		for (int j = 1; j < PINIFILE_MANY_KEYS; ++j) {
+			sprintf (key, "key_%d", j);
+
+			P_TEST_CHECK (zini_file_is_key_exists (ini, section, key) == TRUE);
+			P_TEST_CHECK (zini_file_parameter_int (ini, section, key, -1) == i * PINIFILE_MANY_KEYS + j);
+		}
+
+		sprintf (key, "key_%d", PINIFILE_MANY_KEYS);
+
+		P_TEST_CHECK (zini_file_is_key_exists (ini, section, key) == FALSE);
+		P_TEST_CHECK (zini_file_is_key_exists (ini, section, "key_") == FALSE);
+		P_TEST_CHECK (zini_file_is_key_exists (ini, section, "") == FALSE);
+	}
+
+	sprintf (section, "section_%d", PINIFILE_MANY_SECTIONS);
+
+	P_TEST_CHECK (zini_file_is_key_exists (ini, section, "key_0") == FALSE);
+	P_TEST_CHECK (zini_file_keys (ini, section) == NULL);
+
+	str_val = zini_file_parameter_string (ini, "section_7", "key_12", NULL);
+	P_TEST_CHECK (str_val != NULL && strcmp (str_val, "1412") == 0);
+	zfree (str_val);
+
+	zini_file_free (ini);
+
+	P_TEST_CHECK (zfile_remove ("." P_DIR_SEPARATOR "zini_test_file_many.ini", NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static bool create_test_ini_file_raw (const pchar *path, const pchar *data, psize len)
+{
+	FILE *file = fopen (path, "wb");
+
+	if (file == NULL)
+		return false;
+
+	if (len > 0 && fwrite (data, 1, len, file) != len) {
+		fclose (file);
+		return false;
+	}
+
+	return fclose (file) == 0;
+}
+
+P_TEST_CASE_BEGIN (pinifile_mapped_test)
+{
+	zlibsys_init ();
+
+	P_TEST_REQUIRE (create_test_ini_file (true));
+
+	PIniFile *ini     = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file.ini");
+	PIniFile *ini_map = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file.ini");
+	P_TEST_REQUIRE (ini != NULL && ini_map != NULL);
+
+	P_TEST_CHECK (zini_file_parse_with_flags (NULL, P_INI_FILE_PARSE_FLAG_MAPPED, NULL) == FALSE);
+
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+	P_TEST_REQUIRE (zini_file_parse_with_flags (ini_map, P_INI_FILE_PARSE_FLAG_MAPPED, NULL) == TRUE);
+	P_TEST_CHECK (zini_file_is_parsed (ini_map) == TRUE);
+	P_TEST_REQUIRE (zini_file_parse_with_flags (ini_map, P_INI_FILE_PARSE_FLAG_MAPPED, NULL) == TRUE);
+
+	/* Both modes give the same results for the short lines */
+	PList *sections = zini_file_sections (ini);
+	PList *sections_map = zini_file_sections (ini_map);
+	P_TEST_CHECK (zlist_length (sections) == 4);
+	P_TEST_CHECK (zlist_length (sections_map) == 4);
+
+	for (PList *sec = sections; sec != NULL; sec = sec->next) {
+		const pchar *sec_name = (const pchar *) sec->data;
+		PList       *keys     = zini_file_keys (ini, sec_name);
+
+		for (PList *key = keys; key != NULL; key = key->next) {
+			const pchar *key_name = (const pchar *) key->data;
+
+			if (strcmp (key_name, "string_parameter_6") == 0)
+				continue;
+
+			pchar *val     = zini_file_parameter_string (ini, sec_name, key_name, NULL);
+			pchar *val_map = zini_file_parameter_string (ini_map, sec_name, key_name, NULL);
+
+			P_TEST_CHECK (val != NULL && val_map != NULL && strcmp (val, val_map) == 0);
+
+			zfree (val);
+			zfree (val_map);
+		}
+
+		zlist_foreach (keys, (PFunc) zfree, NULL);
+		zlist_free (keys);
+	}
+
+	zlist_foreach (sections, (PFunc) zfree, NULL);
+	zlist_free (sections);
+	zlist_foreach (sections_map, (PFunc) zfree, NULL);
+	zlist_free (sections_map);
+
+	/* Long lines are not truncated in the mapped mode */
+	pchar *str = zini_file_parameter_string (ini_map, "string_section", "string_parameter_6", NULL);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strlen (str) == PINIFILE_STRESS_LINE);
+
+	for (int i = 0; i < PINIFILE_STRESS_LINE; ++i)
+		P_TEST_CHECK (str[i] == (pchar) (97 + i % 20));
+
+	P_TEST_CHECK (zini_file_is_key_exists (ini_map, "string_section", str) == TRUE);
+	P_TEST_CHECK (zini_file_is_key_exists (ini, "string_section", str) == FALSE);
+
+	pchar *stress_val = zini_file_parameter_string (ini_map, "string_section", str, NULL);
+	P_TEST_CHECK (stress_val != NULL && strcmp (stress_val, "stress line") == 0);
+	zfree (stress_val);
+	zfree (str);
+
+	PList *list = zini_file_keys (ini_map, "string_section");
+	P_TEST_CHECK (zlist_length (list) == 9);
+	zlist_foreach (list, (PFunc) zfree, NULL);
+	zlist_free (list);
+
+	zini_file_free (ini);
+	zini_file_free (ini_map);
+
+	/* BOM, CRLF line endings and no trailing new line */
+	const pchar crlf_data[] = "\xEF\xBB\xBF[section]\r\nkey_1 = 1\r\nkey_2 = 'two'\r\n\r\n[other]\r\nkey_3=3";
+
+	P_TEST_REQUIRE (create_test_ini_file_raw ("." P_DIR_SEPARATOR "zini_test_file.ini",
+						  crlf_data,
+						  sizeof (crlf_data) - 1));
+
+	ini_map = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file.ini");
+	P_TEST_REQUIRE (ini_map != NULL);
+	P_TEST_REQUIRE (zini_file_parse_with_flags (ini_map, P_INI_FILE_PARSE_FLAG_MAPPED, NULL) == TRUE);
+
+	P_TEST_CHECK (zini_file_parameter_int (ini_map, "section", "key_1", -1) == 1);
+	P_TEST_CHECK (zini_file_parameter_int (ini_map, "other", "key_3", -1) == 3);
+
+	str = zini_file_parameter_string (ini_map, "section", "key_2", NULL);
+	P_TEST_CHECK (str != NULL && strcmp (str, "two") == 0);
+	zfree (str);
+
+	zini_file_free (ini_map);
+
+	/* Empty file */
+	P_TEST_REQUIRE (create_test_ini_file_raw ("." P_DIR_SEPARATOR "zini_test_file.ini", NULL, 0));
+
+	ini_map = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file.ini");
+	P_TEST_REQUIRE (ini_map != NULL);
+	P_TEST_CHECK (zini_file_parse_with_flags (ini_map, P_INI_FILE_PARSE_FLAG_MAPPED, NULL) == TRUE);
+	P_TEST_CHECK (zini_file_sections (ini_map) == NULL);
+	zini_file_free (ini_map);
+
+	P_TEST_CHECK (zfile_remove ("." P_DIR_SEPARATOR "zini_test_file.ini", NULL) == TRUE);
+
+	/* Missing file */
+	PError *error = NULL;
+
+	ini_map = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file.ini");
+	P_TEST_REQUIRE (ini_map != NULL);
+	P_TEST_CHECK (zini_file_parse_with_flags (ini_map, P_INI_FILE_PARSE_FLAG_MAPPED, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (zini_file_is_parsed (ini_map) == FALSE);
+	zerror_free (error);
+	zini_file_free (ini_map);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pinifile_reload_test)
+{
+	PError		*error = NULL;
+	pboolean	is_changed;
+
+	zlibsys_init ();
+
+	P_TEST_CHECK (zini_file_reload (NULL, &is_changed, NULL) == FALSE);
+	P_TEST_CHECK (is_changed == FALSE);
+
+	for (pint mode = 0; mode < 2; ++mode) {
+		PIniFileParseFlags flags = mode == 0 ? P_INI_FILE_PARSE_FLAG_NONE : P_INI_FILE_PARSE_FLAG_MAPPED;
+
+		P_TEST_REQUIRE (create_reload_ini_file (1, 3));
+
+		PIniFile *ini = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file_reload.ini");
+		P_TEST_REQUIRE (ini != NULL);
+		P_TEST_REQUIRE (zini_file_parse_with_flags (ini, flags, NULL) == TRUE);
+		P_TEST_CHECK (zini_file_parameter_int (ini, "dynamic_section", "version", -1) == 1);
+
+		/* Nothing was changed */
+		is_changed = TRUE;
+		P_TEST_CHECK (zini_file_reload (ini, &is_changed, NULL) == TRUE);
+		P_TEST_CHECK (is_changed == FALSE);
+
+		/* Rewritten with the same contents */
+		P_TEST_REQUIRE (create_reload_ini_file (1, 3));
+		is_changed = TRUE;
+		P_TEST_CHECK (zini_file_reload (ini, &is_changed, NULL) == TRUE);
+		P_TEST_CHECK (is_changed == FALSE);
+		P_TEST_CHECK (zini_file_parameter_int (ini, "dynamic_section", "version", -1) == 1);
+
+		/* One section is changed */
+		P_TEST_REQUIRE (create_reload_ini_file (2, 5));
+		P_TEST_CHECK (zini_file_reload (ini, &is_changed, NULL) == TRUE);
+		P_TEST_CHECK (is_changed == TRUE);
+		P_TEST_CHECK (zini_file_parameter_int (ini, "dynamic_section", "version", -1) == 2);
+		P_TEST_CHECK (zini_file_parameter_int (ini, "dynamic_section", "key_4", -1) == 4);
+		P_TEST_CHECK (zini_file_parameter_int (ini, "static_section", "static_parameter", -1) == 42);
+
+		PList *keys = zini_file_keys (ini, "dynamic_section");
+		P_TEST_CHECK (zlist_length (keys) == 6);
+		zlist_foreach (keys, (PFunc) zfree, NULL);
+		zlist_free (keys);
+
+		/* Failed reload keeps the contents */
+		P_TEST_CHECK (zfile_remove ("." P_DIR_SEPARATOR "zini_test_file_reload.ini", NULL) == TRUE);
+		P_TEST_CHECK (zini_file_reload (ini, &is_changed, &error) == FALSE);
+		P_TEST_CHECK (is_changed == FALSE);
+		P_TEST_CHECK (error != NULL);
+		zerror_free (error);
+		error = NULL;
+
+		P_TEST_CHECK (zini_file_is_parsed (ini) == TRUE);
+		P_TEST_CHECK (zini_file_parameter_int (ini, "dynamic_section", "version", -1) == 2);
+
+		/* Section is removed */
+		FILE *file = fopen ("." P_DIR_SEPARATOR "zini_test_file_reload.ini", "w");
+		P_TEST_REQUIRE (file != NULL);
+		fprintf (file, "[static_section]\nstatic_parameter = 42\n");
+		P_TEST_REQUIRE (fclose (file) == 0);
+
+		P_TEST_CHECK (zini_file_reload (ini, &is_changed, NULL) == TRUE);
+		P_TEST_CHECK (is_changed == TRUE);
+		P_TEST_CHECK (zini_file_is_key_exists (ini, "dynamic_section", "version") == FALSE);
+		P_TEST_CHECK (zini_file_parameter_int (ini, "static_section", "static_parameter", -1) == 42);
+
+		zini_file_free (ini);
+
+		/* Reload of a file which was not parsed yet */
+		ini = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file_reload.ini");
+		P_TEST_REQUIRE (ini != NULL);
+		P_TEST_CHECK (zini_file_reload (ini, &is_changed, NULL) == TRUE);
+		P_TEST_CHECK (is_changed == TRUE);
+		P_TEST_CHECK (zini_file_is_parsed (ini) == TRUE);
+		P_TEST_CHECK (zini_file_parameter_int (ini, "static_section", "static_parameter", -1) == 42);
+		zini_file_free (ini);
+	}
+
+	P_TEST_CHECK (zfile_remove ("." P_DIR_SEPARATOR "zini_test_file_reload.ini", NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pinifile_reload_thread_test)
+{
+	PUThread	*threads[PINIFILE_RELOAD_THREADS];
+	PMemVTable	vtable;
+	pboolean	is_changed;
+	pint		blocks;
+	pint		tries;
+
+	zlibsys_init ();
+
+	P_TEST_REQUIRE (create_reload_ini_file (0, 10));
+
+	PIniFile *ini = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file_reload.ini");
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (zini_file_parse_with_flags (ini, P_INI_FILE_PARSE_FLAG_MAPPED, NULL) == TRUE);
+
+	zatomic_int_set (&pinifile_reload_stop, 0);
+	zatomic_int_set (&pinifile_reload_errors, 0);
+	zatomic_int_set (&pinifile_reload_blocks, 0);
+
+	/* Count the live memory blocks to make sure that the replaced views are
+	 * freed while the readers are still running */
+	vtable.free    = pmem_count_free;
+	vtable.malloc  = pmem_count_alloc;
+	vtable.realloc = pmem_count_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	for (pint i = 0; i < PINIFILE_RELOAD_THREADS; ++i) {
+		threads[i] = zuthread_create ((PUThreadFunc) pinifile_reload_thread_func,
+					       ini,
+					       TRUE,
+					       "ini_reader");
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	/* Every version has a different size, so the change is always detected */
+	for (pint i = 1; i <= PINIFILE_RELOAD_ROUNDS; ++i) {
+		P_TEST_REQUIRE (create_reload_ini_file (i, 10 + i % 7));
+		P_TEST_CHECK (zini_file_reload (ini, &is_changed, NULL) == TRUE);
+		P_TEST_CHECK (is_changed == TRUE);
+		P_TEST_CHECK (zini_file_parameter_int (ini, "dynamic_section", "version", -1) == i);
+	}
+
+	/* A reader may be preempted while it uses an old view, give it a chance
+	 * to move on before the check */
+	blocks = zatomic_int_get (&pinifile_reload_blocks);
+
+	for (tries = 0; tries < 1000 && blocks > PINIFILE_RELOAD_MAX_BLOCKS; ++tries) {
+		zuthread_yield ();
+		zini_file_parameter_int (ini, "dynamic_section", "version", -1);
+
+		blocks = zatomic_int_get (&pinifile_reload_blocks);
+	}
+
+	/* Only a bounded number of the replaced views is left */
+	P_TEST_CHECK (blocks <= PINIFILE_RELOAD_MAX_BLOCKS);
+
+	zatomic_int_set (&pinifile_reload_stop, 1);
+
+	for (pint i = 0; i < PINIFILE_RELOAD_THREADS; ++i) {
+		P_TEST_CHECK (zuthread_join (threads[i]) == 0);
+		zuthread_unref (threads[i]);
+	}
+
+	zmem_restore_vtable ();
+
+	P_TEST_CHECK (zatomic_int_get (&pinifile_reload_errors) == 0);
+
+	zini_file_free (ini);
+
+	P_TEST_CHECK (zfile_remove ("." P_DIR_SEPARATOR "zini_test_file_reload.ini", NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pinifile_string_view_test)
+{
+	zlibsys_init ();
+
+	P_TEST_CHECK (zini_file_parameter_string_view (NULL, "string_section", "string_parameter_1", "def") != NULL);
+	P_TEST_CHECK (strcmp (zini_file_parameter_string_view (NULL, "a", "b", "def"), "def") == 0);
+
+	P_TEST_REQUIRE (create_test_ini_file (true));
+
+	PIniFile *ini = zini_file_new ("." P_DIR_SEPARATOR "zini_test_file.ini");
+	P_TEST_REQUIRE (ini != NULL);
+
+	P_TEST_CHECK (zini_file_parameter_string_view (ini, "string_section", "string_parameter_1", NULL) == NULL);
+
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+
+	const pchar *str = zini_file_parameter_string_view (ini, "string_section", "string_parameter_1", NULL);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strcmp (str, "Test string") == 0);
+
+	/* The same storage is returned every time */
+	P_TEST_CHECK (zini_file_parameter_string_view (ini, "string_section", "string_parameter_1", NULL) == str);
+
+	str = zini_file_parameter_string_view (ini, "string_section", "string_parameter_2", NULL);
+	P_TEST_CHECK (str != NULL && strcmp (str, "Test string with #'") == 0);
+
+	str = zini_file_parameter_string_view (ini, "string_section", "string_parameter_7", NULL);
+	P_TEST_CHECK (str != NULL && strcmp (str, "") == 0);
+
+	P_TEST_CHECK (zini_file_parameter_string_view (ini, "string_section", "string_parameter_def", NULL) == NULL);
+	P_TEST_CHECK (strcmp (zini_file_parameter_string_view (ini, "string_section_no", "a", "def"), "def") == 0);
+	P_TEST_CHECK (zini_file_parameter_string_view (ini, NULL, "string_parameter_1", NULL) == NULL);
+	P_TEST_CHECK (zini_file_parameter_string_view (ini, "string_section", NULL, NULL) == NULL);
+
+	/* Cached conversions give the same results */
+	for (int i = 0; i < 3; ++i) {
+		P_TEST_CHECK (zini_file_parameter_int (ini, "numeric_section", "int_parameter_2", -1) == 5);
+		P_TEST_CHECK_CLOSE (zini_file_parameter_double (ini, "numeric_section", "float_parameter_1", -1.0), 3.24, 0.0001);
+		P_TEST_CHECK (zini_file_parameter_boolean (ini, "boolean_section", "boolean_parameter_1", FALSE) == TRUE);
+		P_TEST_CHECK (zini_file_parameter_boolean (ini, "boolean_section", "boolean_parameter_3", TRUE) == FALSE);
+
+		/* Different conversions of the same value */
+		P_TEST_CHECK (zini_file_parameter_int (ini, "numeric_section", "float_parameter_1", -1) == 3);
+		P_TEST_CHECK (zini_file_parameter_boolean (ini, "numeric_section", "float_parameter_1", FALSE) == TRUE);
+		P_TEST_CHECK (zini_file_parameter_boolean (ini, "numeric_section", "float_parameter_2", TRUE) == FALSE);
+		P_TEST_CHECK_CLOSE (zini_file_parameter_double (ini, "numeric_section", "int_parameter_3", -1.0), 6.0, 0.0001);
+	}
+
+	zini_file_free (ini);
+
+	P_TEST_CHECK (zfile_remove ("." P_DIR_SEPARATOR "zini_test_file.ini", NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pinifile_nomem_test);
 	P_TEST_SUITE_RUN_CASE (pinifile_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (pinifile_read_test);
+	P_TEST_SUITE_RUN_CASE (pinifile_many_keys_test);
+	P_TEST_SUITE_RUN_CASE (pinifile_mapped_test);
+	P_TEST_SUITE_RUN_CASE (pinifile_string_view_test);
+	P_TEST_SUITE_RUN_CASE (pinifile_reload_test);
+	P_TEST_SUITE_RUN_CASE (pinifile_reload_thread_test);
 }
 P_TEST_SUITE_END()
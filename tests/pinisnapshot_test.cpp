@@ -0,0 +1,591 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PINISNAPSHOT_MANY_SECTIONS	64
+#define PINISNAPSHOT_MANY_KEYS		300
+
+#define PINISNAPSHOT_WRITE_THREADS	4
+#define PINISNAPSHOT_WRITE_ROUNDS	20
+
+#define PINISNAPSHOT_INI_FILE		"." P_DIR_SEPARATOR "zini_snapshot_test.ini"
+#define PINISNAPSHOT_FILE		"." P_DIR_SEPARATOR "zini_snapshot_test.snap"
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static bool create_test_ini_file (pint version)
+{
+	FILE *file = fopen (PINISNAPSHOT_INI_FILE, "w");
+
+	if (file == NULL)
+		return false;
+
+	fprintf (file, "[numeric_section]\n");
+	fprintf (file, "int_parameter_1 = 4\n");
+	fprintf (file, "int_parameter_2 = 5 ;This is a comment\n");
+	fprintf (file, "float_parameter_1 = 3.24\n");
+	fprintf (file, "version = %d\n", version);
+
+	fprintf (file, "[string_section]\n");
+	fprintf (file, "string_parameter_1 = Test string\n");
+	fprintf (file, "string_parameter_2 = \"Test string with #'\"\n");
+	fprintf (file, "string_parameter_3 = \n");
+	fprintf (file, "string_parameter_4 = 12345\n");
+	fprintf (file, "string_parameter_4 = 54321\n");
+	fprintf (file, "string_parameter_5 = Test string\n");
+
+	fprintf (file, "[boolean_section]\n");
+	fprintf (file, "boolean_parameter_1 = TRUE\n");
+	fprintf (file, "boolean_parameter_2 = 0\n");
+	fprintf (file, "boolean_parameter_3 = false\n");
+	fprintf (file, "boolean_parameter_4 = 1\n");
+
+	fprintf (file, "[list_section]\n");
+	fprintf (file, "list_parameter_1 = {1\t2\t5\t10}\n");
+
+	/* Duplicated section */
+	fprintf (file, "[numeric_section]\n");
+	fprintf (file, "int_parameter_1 = 7\n");
+	fprintf (file, "duplicated_parameter = 8\n");
+
+	return fclose (file) == 0;
+}
+
+static bool create_many_keys_ini_file ()
+{
+	FILE *file = fopen (PINISNAPSHOT_INI_FILE, "w");
+
+	if (file == NULL)
+		return false;
+
+	for (int i = 0; i < PINISNAPSHOT_MANY_SECTIONS; ++i) {
+		fprintf (file, "[section_%d]\n", i);
+
+		for (int j = 0; j < PINISNAPSHOT_MANY_KEYS; ++j)
+			fprintf (file, "key_%d = %d\n", j, (i * PINISNAPSHOT_MANY_KEYS + j) % 1000);
+	}
+
+	return fclose (file) == 0;
+}
+
+/* Every key of the parsed file must have the same value in the snapshot */
+static bool compare_with_ini_file (PIniFile *ini, PIniSnapshot *snapshot)
+{
+	bool	result = true;
+	PList	*sections = zini_file_sections (ini);
+
+	for (PList *sect = sections; sect != NULL; sect = sect->next) {
+		const pchar	*section = (const pchar *) sect->data;
+		PList		*keys    = zini_file_keys (ini, section);
+
+		for (PList *key = keys; key != NULL; key = key->next) {
+			const pchar *ini_val  = zini_file_parameter_string_view (ini, section, (const pchar *) key->data, NULL);
+			const pchar *snap_val = zini_snapshot_parameter_string (snapshot, section, (const pchar *) key->data, NULL);
+
+			if (ini_val == NULL || snap_val == NULL || strcmp (ini_val, snap_val) != 0)
+				result = false;
+		}
+
+		zlist_foreach (keys, (PFunc) zfree, NULL);
+		zlist_free (keys);
+	}
+
+	zlist_foreach (sections, (PFunc) zfree, NULL);
+	zlist_free (sections);
+
+	return result;
+}
+
+static bool write_raw_file (const pchar *path, const puchar *data, psize len)
+{
+	FILE *file = fopen (path, "wb");
+
+	if (file == NULL)
+		return false;
+
+	bool result = fwrite (data, 1, len, file) == len;
+
+	return fclose (file) == 0 && result;
+}
+
+static pint write_thread_func (ppointer data)
+{
+	pint	failed = 0;
+
+	for (int i = 0; i < PINISNAPSHOT_WRITE_ROUNDS; ++i) {
+		if (zini_snapshot_write ((const PIniFile *) data, PINISNAPSHOT_FILE, NULL) == FALSE)
+			++failed;
+	}
+
+	zuthread_exit (failed);
+
+	return failed;
+}
+
+static bool has_temp_files ()
+{
+	PDir		*dir;
+	PDirEntry	*entry;
+	bool		found = false;
+
+	if ((dir = zdir_new (".", NULL)) == NULL)
+		return true;
+
+	while ((entry = zdir_get_next_entry (dir, NULL)) != NULL) {
+		if (strncmp (entry->name, "zini_snapshot_test.snap.", 24) == 0)
+			found = true;
+
+		zdir_entry_free (entry);
+	}
+
+	zdir_free (dir);
+
+	return found;
+}
+
+P_TEST_CASE_BEGIN (pinisnapshot_nomem_test)
+{
+	zlibsys_init ();
+
+	P_TEST_REQUIRE (create_test_ini_file (1));
+
+	PIniFile *ini = zini_file_new (PINISNAPSHOT_INI_FILE);
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+	P_TEST_REQUIRE (zini_snapshot_write (ini, PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zini_snapshot_write (ini, PINISNAPSHOT_FILE, NULL) == FALSE);
+	P_TEST_CHECK (zini_snapshot_open (PINISNAPSHOT_FILE, NULL) == NULL);
+
+	zmem_restore_vtable ();
+
+	/* Failed write keeps the previous snapshot */
+	PIniSnapshot *snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+	P_TEST_CHECK (snapshot != NULL);
+	P_TEST_CHECK (zini_snapshot_parameter_int (snapshot, "numeric_section", "version", 0) == 1);
+	zini_snapshot_close (snapshot);
+
+	zini_file_free (ini);
+
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_INI_FILE, NULL) == TRUE);
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pinisnapshot_bad_input_test)
+{
+	PError *error = NULL;
+
+	zlibsys_init ();
+
+	zini_snapshot_close (NULL);
+
+	P_TEST_CHECK (zini_snapshot_write (NULL, PINISNAPSHOT_FILE, NULL) == FALSE);
+	P_TEST_CHECK (zini_snapshot_open (NULL, NULL) == NULL);
+	P_TEST_CHECK (zini_snapshot_section_count (NULL) == 0);
+	P_TEST_CHECK (zini_snapshot_is_key_exists (NULL, "section", "key") == FALSE);
+	P_TEST_CHECK (zini_snapshot_parameter_string (NULL, "section", "key", "default") != NULL);
+	P_TEST_CHECK (zini_snapshot_parameter_int (NULL, "section", "key", 10) == 10);
+	P_TEST_CHECK_CLOSE (zini_snapshot_parameter_double (NULL, "section", "key", 1.0), 1.0, 0.0001);
+	P_TEST_CHECK (zini_snapshot_parameter_boolean (NULL, "section", "key", TRUE) == TRUE);
+
+	/* Not parsed file */
+	PIniFile *ini = zini_file_new (PINISNAPSHOT_INI_FILE);
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_CHECK (zini_snapshot_write (ini, PINISNAPSHOT_FILE, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (zerror_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	zerror_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (zini_snapshot_open ("./bad_file_path/fake.snap", &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	zerror_free (error);
+	error = NULL;
+
+	P_TEST_REQUIRE (create_test_ini_file (1));
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+	P_TEST_CHECK (zini_snapshot_write (ini, "./bad_file_path/fake.snap", &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	zerror_free (error);
+	error = NULL;
+
+	P_TEST_REQUIRE (zini_snapshot_write (ini, PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	PIniSnapshot *snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+	P_TEST_REQUIRE (snapshot != NULL);
+
+	P_TEST_CHECK (zini_snapshot_is_key_exists (snapshot, NULL, "int_parameter_1") == FALSE);
+	P_TEST_CHECK (zini_snapshot_is_key_exists (snapshot, "numeric_section", NULL) == FALSE);
+	P_TEST_CHECK (zini_snapshot_parameter_string (snapshot, NULL, NULL, NULL) == NULL);
+
+	zini_snapshot_close (snapshot);
+	zini_file_free (ini);
+
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_INI_FILE, NULL) == TRUE);
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pinisnapshot_read_test)
+{
+	zlibsys_init ();
+
+	P_TEST_REQUIRE (create_test_ini_file (1));
+
+	PIniFile *ini = zini_file_new (PINISNAPSHOT_INI_FILE);
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+	P_TEST_REQUIRE (zini_snapshot_write (ini, PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	PIniSnapshot *snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+	P_TEST_REQUIRE (snapshot != NULL);
+
+	P_TEST_CHECK (zini_snapshot_section_count (snapshot) == 4);
+	P_TEST_CHECK (compare_with_ini_file (ini, snapshot));
+
+	/* Numeric section */
+	P_TEST_CHECK (zini_snapshot_parameter_int (snapshot, "numeric_section", "int_parameter_1", -1) ==
+		      zini_file_parameter_int (ini, "numeric_section", "int_parameter_1", -1));
+	P_TEST_CHECK (zini_snapshot_parameter_int (snapshot, "numeric_section", "int_parameter_2", -1) == 5);
+	P_TEST_CHECK_CLOSE (zini_snapshot_parameter_double (snapshot, "numeric_section", "float_parameter_1", 0.0),
+			    3.24, 0.0001);
+	P_TEST_CHECK (zini_snapshot_is_key_exists (snapshot, "numeric_section", "duplicated_parameter") ==
+		      zini_file_is_key_exists (ini, "numeric_section", "duplicated_parameter"));
+	P_TEST_CHECK (zini_snapshot_parameter_int (snapshot, "numeric_section", "int_parameter_10", -1) == -1);
+
+	/* String section */
+	P_TEST_CHECK (strcmp (zini_snapshot_parameter_string (snapshot, "string_section", "string_parameter_1", ""),
+			      "Test string") == 0);
+	P_TEST_CHECK (strcmp (zini_snapshot_parameter_string (snapshot, "string_section", "string_parameter_2", ""),
+			      "Test string with #'") == 0);
+	P_TEST_CHECK (zini_snapshot_is_key_exists (snapshot, "string_section", "string_parameter_3") == FALSE);
+	P_TEST_CHECK (strcmp (zini_snapshot_parameter_string (snapshot, "string_section", "string_parameter_4", ""),
+			      "54321") == 0);
+
+	/* The same strings are stored once */
+	P_TEST_CHECK (zini_snapshot_parameter_string (snapshot, "string_section", "string_parameter_1", NULL) ==
+		      zini_snapshot_parameter_string (snapshot, "string_section", "string_parameter_5", NULL));
+
+	/* Boolean section */
+	P_TEST_CHECK (zini_snapshot_parameter_boolean (snapshot, "boolean_section", "boolean_parameter_1", FALSE) == TRUE);
+	P_TEST_CHECK (zini_snapshot_parameter_boolean (snapshot, "boolean_section", "boolean_parameter_2", TRUE) == FALSE);
+	P_TEST_CHECK (zini_snapshot_parameter_boolean (snapshot, "boolean_section", "boolean_parameter_3", TRUE) == FALSE);
+	P_TEST_CHECK (zini_snapshot_parameter_boolean (snapshot, "boolean_section", "boolean_parameter_4", FALSE) == TRUE);
+	P_TEST_CHECK (zini_snapshot_parameter_boolean (snapshot, "boolean_section", "boolean_parameter_5", TRUE) == TRUE);
+
+	/* Lists are stored as strings */
+	P_TEST_CHECK (strcmp (zini_snapshot_parameter_string (snapshot, "list_section", "list_parameter_1", ""),
+			      "{1\t2\t5\t10}") == 0);
+
+	/* Missing section and keys */
+	P_TEST_CHECK (zini_snapshot_is_key_exists (snapshot, "numeric_section", "") == FALSE);
+	P_TEST_CHECK (zini_snapshot_is_key_exists (snapshot, "", "int_parameter_1") == FALSE);
+	P_TEST_CHECK (zini_snapshot_is_key_exists (snapshot, "numeric", "int_parameter_1") == FALSE);
+	P_TEST_CHECK (zini_snapshot_parameter_int (snapshot, "empty_section", "int_parameter_1", 3) == 3);
+
+	zini_snapshot_close (snapshot);
+	zini_file_free (ini);
+
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_INI_FILE, NULL) == TRUE);
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pinisnapshot_many_keys_test)
+{
+	pchar section[32];
+	pchar key[32];
+
+	zlibsys_init ();
+
+	P_TEST_REQUIRE (create_many_keys_ini_file ());
+
+	PIniFile *ini = zini_file_new (PINISNAPSHOT_INI_FILE);
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+	P_TEST_REQUIRE (zini_snapshot_write (ini, PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	PIniSnapshot *snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+	P_TEST_REQUIRE (snapshot != NULL);
+
+	P_TEST_CHECK (zini_snapshot_section_count (snapshot) == PINISNAPSHOT_MANY_SECTIONS);
+	P_TEST_CHECK (compare_with_ini_file (ini, snapshot));
+
+	for (int i = 0; i < PINISNAPSHOT_MANY_SECTIONS; ++i) {
+		sprintf (section, "section_%d", i);
+
+		for (int j = 0; j < PINISNAPSHOT_MANY_KEYS; ++j) {
+			sprintf (key, "key_%d", j);
+
+			P_TEST_CHECK (zini_snapshot_parameter_int (snapshot, section, key, -1) ==
+				      (i * PINISNAPSHOT_MANY_KEYS + j) % 1000);
+		}
+
+		sprintf (key, "key_%d", PINISNAPSHOT_MANY_KEYS);
+		P_TEST_CHECK (zini_snapshot_is_key_exists (snapshot, section, key) == FALSE);
+	}
+
+	sprintf (section, "section_%d", PINISNAPSHOT_MANY_SECTIONS);
+	P_TEST_CHECK (zini_snapshot_is_key_exists (snapshot, section, "key_0") == FALSE);
+
+	zini_snapshot_close (snapshot);
+	zini_file_free (ini);
+
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_INI_FILE, NULL) == TRUE);
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pinisnapshot_replace_test)
+{
+	zlibsys_init ();
+
+	P_TEST_REQUIRE (create_test_ini_file (1));
+
+	PIniFile *ini = zini_file_new (PINISNAPSHOT_INI_FILE);
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+	P_TEST_REQUIRE (zini_snapshot_write (ini, PINISNAPSHOT_FILE, NULL) == TRUE);
+	zini_file_free (ini);
+
+	PIniSnapshot *old_snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+	P_TEST_REQUIRE (old_snapshot != NULL);
+
+	P_TEST_REQUIRE (create_test_ini_file (2));
+
+	ini = zini_file_new (PINISNAPSHOT_INI_FILE);
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+	P_TEST_REQUIRE (zini_snapshot_write (ini, PINISNAPSHOT_FILE, NULL) == TRUE);
+	zini_file_free (ini);
+
+	PIniSnapshot *new_snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+	P_TEST_REQUIRE (new_snapshot != NULL);
+
+	/* The opened snapshot is not affected by the replacement */
+	P_TEST_CHECK (zini_snapshot_parameter_int (old_snapshot, "numeric_section", "version", 0) == 1);
+	P_TEST_CHECK (zini_snapshot_parameter_int (new_snapshot, "numeric_section", "version", 0) == 2);
+
+	zini_snapshot_close (old_snapshot);
+	zini_snapshot_close (new_snapshot);
+
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_INI_FILE, NULL) == TRUE);
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pinisnapshot_concurrent_write_test)
+{
+	PUThread	*threads[PINISNAPSHOT_WRITE_THREADS];
+
+	zlibsys_init ();
+
+	P_TEST_REQUIRE (create_many_keys_ini_file ());
+
+	PIniFile *ini = zini_file_new (PINISNAPSHOT_INI_FILE);
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+	P_TEST_REQUIRE (zini_snapshot_write (ini, PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	for (int i = 0; i < PINISNAPSHOT_WRITE_THREADS; ++i) {
+		threads[i] = zuthread_create ((PUThreadFunc) write_thread_func, ini, TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	/* Readers must always see a complete snapshot while it is being replaced */
+	for (int i = 0; i < PINISNAPSHOT_WRITE_ROUNDS; ++i) {
+		PIniSnapshot *snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+		P_TEST_REQUIRE (snapshot != NULL);
+		P_TEST_CHECK (zini_snapshot_section_count (snapshot) == PINISNAPSHOT_MANY_SECTIONS);
+		zini_snapshot_close (snapshot);
+	}
+
+	for (int i = 0; i < PINISNAPSHOT_WRITE_THREADS; ++i) {
+		P_TEST_CHECK (zuthread_join (threads[i]) == 0);
+		zuthread_unref (threads[i]);
+	}
+
+	PIniSnapshot *snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+	P_TEST_REQUIRE (snapshot != NULL);
+	P_TEST_CHECK (compare_with_ini_file (ini, snapshot));
+	zini_snapshot_close (snapshot);
+
+	/* Every writer must have renamed or removed its temporary file */
+	P_TEST_CHECK (has_temp_files () == false);
+
+	zini_file_free (ini);
+
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_INI_FILE, NULL) == TRUE);
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pinisnapshot_damaged_test)
+{
+	static const pchar *lookups[][2] = {
+		{"numeric_section", "int_parameter_1"},
+		{"numeric_section", "version"},
+		{"string_section", "string_parameter_2"},
+		{"string_section", "string_parameter_4"},
+		{"boolean_section", "boolean_parameter_3"},
+		{"list_section", "list_parameter_1"},
+		{"list_section", "list_parameter_2"},
+		{"empty_section", "int_parameter_1"}
+	};
+
+	zlibsys_init ();
+
+	P_TEST_REQUIRE (create_test_ini_file (1));
+
+	PIniFile *ini = zini_file_new (PINISNAPSHOT_INI_FILE);
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (zini_file_parse (ini, NULL) == TRUE);
+	P_TEST_REQUIRE (zini_snapshot_write (ini, PINISNAPSHOT_FILE, NULL) == TRUE);
+	zini_file_free (ini);
+
+	FILE *file = fopen (PINISNAPSHOT_FILE, "rb");
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_REQUIRE (fseek (file, 0, SEEK_END) == 0);
+
+	psize size = (psize) ftell (file);
+	P_TEST_REQUIRE (size > 64);
+	P_TEST_REQUIRE (fseek (file, 0, SEEK_SET) == 0);
+
+	puchar *data    = (puchar *) zmalloc (size);
+	puchar *damaged = (puchar *) zmalloc (size);
+	P_TEST_REQUIRE (data != NULL && damaged != NULL);
+	P_TEST_REQUIRE (fread (data, 1, size, file) == size);
+	P_TEST_REQUIRE (fclose (file) == 0);
+
+	/* Empty, truncated and foreign files */
+	P_TEST_REQUIRE (write_raw_file (PINISNAPSHOT_FILE, data, 0));
+	P_TEST_CHECK (zini_snapshot_open (PINISNAPSHOT_FILE, NULL) == NULL);
+
+	P_TEST_REQUIRE (write_raw_file (PINISNAPSHOT_FILE, data, 32));
+	P_TEST_CHECK (zini_snapshot_open (PINISNAPSHOT_FILE, NULL) == NULL);
+
+	P_TEST_REQUIRE (write_raw_file (PINISNAPSHOT_FILE, data, size - 1));
+	P_TEST_CHECK (zini_snapshot_open (PINISNAPSHOT_FILE, NULL) == NULL);
+
+	memcpy (damaged, data, size);
+	damaged[0] = 'X';
+	P_TEST_REQUIRE (write_raw_file (PINISNAPSHOT_FILE, damaged, size));
+	P_TEST_CHECK (zini_snapshot_open (PINISNAPSHOT_FILE, NULL) == NULL);
+
+	/* Damaged indexes must never lead outside of the snapshot */
+	for (psize offset = 0; offset < size; ++offset) {
+		memcpy (damaged, data, size);
+		damaged[offset] ^= 0xA5;
+
+		P_TEST_REQUIRE (write_raw_file (PINISNAPSHOT_FILE, damaged, size));
+
+		PIniSnapshot *snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+
+		if (snapshot == NULL)
+			continue;
+
+		for (psize i = 0; i < sizeof (lookups) / sizeof (lookups[0]); ++i) {
+			const pchar *val = zini_snapshot_parameter_string (snapshot, lookups[i][0], lookups[i][1], NULL);
+
+			if (val != NULL)
+				P_TEST_CHECK (strlen (val) < size);
+		}
+
+		zini_snapshot_close (snapshot);
+	}
+
+	/* The original contents are fine */
+	P_TEST_REQUIRE (write_raw_file (PINISNAPSHOT_FILE, data, size));
+
+	PIniSnapshot *snapshot = zini_snapshot_open (PINISNAPSHOT_FILE, NULL);
+	P_TEST_CHECK (snapshot != NULL);
+	P_TEST_CHECK (zini_snapshot_parameter_int (snapshot, "numeric_section", "version", -1) == 1);
+	zini_snapshot_close (snapshot);
+
+	zfree (data);
+	zfree (damaged);
+
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_INI_FILE, NULL) == TRUE);
+	P_TEST_CHECK (zfile_remove (PINISNAPSHOT_FILE, NULL) == TRUE);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pinisnapshot_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pinisnapshot_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pinisnapshot_read_test);
+	P_TEST_SUITE_RUN_CASE (pinisnapshot_many_keys_test);
+	P_TEST_SUITE_RUN_CASE (pinisnapshot_replace_test);
+	P_TEST_SUITE_RUN_CASE (pinisnapshot_concurrent_write_test);
+	P_TEST_SUITE_RUN_CASE (pinisnapshot_damaged_test);
+}
+P_TEST_SUITE_END()
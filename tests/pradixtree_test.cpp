@@ -0,0 +1,463 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef P_OS_WIN
+#  include <arpa/inet.h>
+#endif
+
+P_TEST_MODULE_INIT ();
+
+#define PRADIXTREE_TEST_NPREFIXES	500
+#define PRADIXTREE_TEST_NLOOKUPS	5000
+
+typedef struct _RadixTestPrefix {
+	puint32	addr;
+	puint	len;
+	pboolean	used;
+} RadixTestPrefix;
+
+static pint radix_test_destroy_count = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+extern "C" void radix_test_destroy_func (ppointer data)
+{
+	P_UNUSED (data);
+	++radix_test_destroy_count;
+}
+
+static pboolean radix_test_insert (PRadixTree *tree, const pchar *addr, puint len, ppointer value)
+{
+	PSocketAddress	*sock_addr;
+	pboolean	ret;
+
+	sock_addr = zsocket_address_new (addr, 0);
+
+	if (sock_addr == NULL)
+		return FALSE;
+
+	ret = zradix_tree_insert (tree, sock_addr, len, value);
+	zsocket_address_free (sock_addr);
+
+	return ret;
+}
+
+static pboolean radix_test_remove (PRadixTree *tree, const pchar *addr, puint len)
+{
+	PSocketAddress	*sock_addr;
+	pboolean	ret;
+
+	sock_addr = zsocket_address_new (addr, 0);
+
+	if (sock_addr == NULL)
+		return FALSE;
+
+	ret = zradix_tree_remove (tree, sock_addr, len);
+	zsocket_address_free (sock_addr);
+
+	return ret;
+}
+
+static ppointer radix_test_lookup (PRadixTree *tree, const pchar *addr, puint *len)
+{
+	PSocketAddress	*sock_addr;
+	ppointer	ret;
+
+	sock_addr = zsocket_address_new (addr, 1234);
+
+	if (sock_addr == NULL)
+		return NULL;
+
+	ret = zradix_tree_lookup (tree, sock_addr, len);
+	zsocket_address_free (sock_addr);
+
+	return ret;
+}
+
+static puint32 radix_test_rand32 (void)
+{
+	return ((puint32) (rand () & 0xFFFF) << 16) | (puint32) (rand () & 0xFFFF);
+}
+
+static puint32 radix_test_mask (puint len)
+{
+	return len == 0 ? 0 : (puint32) (0xFFFFFFFFU << (32 - len));
+}
+
+P_TEST_CASE_BEGIN (pradixtree_nomem_test)
+{
+	zlibsys_init ();
+
+	PRadixTree	*tree;
+	PSocketAddress	*addr;
+	PMemVTable	vtable;
+
+	tree = zradix_tree_new ();
+	addr = zsocket_address_new ("10.0.0.0", 0);
+	P_TEST_REQUIRE (tree != NULL && addr != NULL);
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zradix_tree_new () == NULL);
+	P_TEST_CHECK (zradix_tree_new_full (radix_test_destroy_func) == NULL);
+	P_TEST_CHECK (zradix_tree_insert (tree, addr, 8, PINT_TO_POINTER (1)) == FALSE);
+
+	zmem_restore_vtable ();
+
+	P_TEST_CHECK (zradix_tree_get_nprefixes (tree) == 0);
+	P_TEST_CHECK (zradix_tree_lookup (tree, addr, NULL) == NULL);
+
+	zsocket_address_free (addr);
+	zradix_tree_free (tree);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pradixtree_invalid_test)
+{
+	zlibsys_init ();
+
+	PRadixTree		*tree;
+	PSocketAddress		*addr;
+	struct sockaddr_in	sa;
+
+	P_TEST_CHECK (zradix_tree_insert (NULL, NULL, 0, NULL) == FALSE);
+	P_TEST_CHECK (zradix_tree_insert_native (NULL, NULL, 0, 0, NULL) == FALSE);
+	P_TEST_CHECK (zradix_tree_remove (NULL, NULL, 0) == FALSE);
+	P_TEST_CHECK (zradix_tree_remove_native (NULL, NULL, 0, 0) == FALSE);
+	P_TEST_CHECK (zradix_tree_lookup (NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (zradix_tree_lookup_native (NULL, NULL, 0, NULL) == NULL);
+	P_TEST_CHECK (zradix_tree_get_nprefixes (NULL) == 0);
+
+	zradix_tree_clear (NULL);
+	zradix_tree_free (NULL);
+
+	tree = zradix_tree_new ();
+	addr = zsocket_address_new ("192.168.0.0", 0);
+	P_TEST_REQUIRE (tree != NULL && addr != NULL);
+
+	P_TEST_CHECK (zradix_tree_insert (tree, NULL, 8, NULL) == FALSE);
+	P_TEST_CHECK (zradix_tree_insert (tree, addr, 33, NULL) == FALSE);
+	P_TEST_CHECK (zradix_tree_remove (tree, addr, 33) == FALSE);
+	P_TEST_CHECK (zradix_tree_remove (tree, addr, 16) == FALSE);
+
+	P_TEST_CHECK (zsocket_address_to_native (addr, &sa, sizeof (sa)) == TRUE);
+	P_TEST_CHECK (zradix_tree_insert_native (tree, &sa, sizeof (sa) - 1, 16, NULL) == FALSE);
+	P_TEST_CHECK (zradix_tree_lookup_native (tree, &sa, 2, NULL) == NULL);
+
+	sa.sin_family = AF_UNIX;
+	P_TEST_CHECK (zradix_tree_insert_native (tree, &sa, sizeof (sa), 16, NULL) == FALSE);
+
+	P_TEST_CHECK (zradix_tree_get_nprefixes (tree) == 0);
+
+	zsocket_address_free (addr);
+	zradix_tree_free (tree);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pradixtree_ipv4_test)
+{
+	zlibsys_init ();
+
+	PRadixTree		*tree;
+	PSocketAddress		*addr;
+	struct sockaddr_in	sa;
+	puint			len;
+
+	radix_test_destroy_count = 0;
+
+	tree = zradix_tree_new_full (radix_test_destroy_func);
+	P_TEST_REQUIRE (tree != NULL);
+
+	P_TEST_CHECK (radix_test_lookup (tree, "10.1.2.3", NULL) == NULL);
+
+	P_TEST_CHECK (radix_test_insert (tree, "10.0.0.0", 8, PINT_TO_POINTER (8)) == TRUE);
+	P_TEST_CHECK (radix_test_insert (tree, "10.1.0.0", 16, PINT_TO_POINTER (16)) == TRUE);
+	P_TEST_CHECK (radix_test_insert (tree, "10.1.2.0", 24, PINT_TO_POINTER (24)) == TRUE);
+	P_TEST_CHECK (radix_test_insert (tree, "10.1.2.3", 32, PINT_TO_POINTER (32)) == TRUE);
+	P_TEST_CHECK (radix_test_insert (tree, "10.128.0.0", 9, PINT_TO_POINTER (9)) == TRUE);
+
+	/* Host bits are ignored */
+	P_TEST_CHECK (radix_test_insert (tree, "172.16.99.99", 12, PINT_TO_POINTER (12)) == TRUE);
+
+	P_TEST_CHECK (zradix_tree_get_nprefixes (tree) == 6);
+
+	len = 0;
+	P_TEST_CHECK (radix_test_lookup (tree, "10.1.2.3", &len) == PINT_TO_POINTER (32));
+	P_TEST_CHECK (len == 32);
+	P_TEST_CHECK (radix_test_lookup (tree, "10.1.2.4", &len) == PINT_TO_POINTER (24));
+	P_TEST_CHECK (len == 24);
+	P_TEST_CHECK (radix_test_lookup (tree, "10.1.3.4", &len) == PINT_TO_POINTER (16));
+	P_TEST_CHECK (len == 16);
+	P_TEST_CHECK (radix_test_lookup (tree, "10.2.3.4", &len) == PINT_TO_POINTER (8));
+	P_TEST_CHECK (len == 8);
+	P_TEST_CHECK (radix_test_lookup (tree, "10.200.3.4", &len) == PINT_TO_POINTER (9));
+	P_TEST_CHECK (len == 9);
+	P_TEST_CHECK (radix_test_lookup (tree, "172.31.0.1", NULL) == PINT_TO_POINTER (12));
+	P_TEST_CHECK (radix_test_lookup (tree, "172.32.0.1", NULL) == NULL);
+	P_TEST_CHECK (radix_test_lookup (tree, "11.0.0.1", NULL) == NULL);
+
+	/* Lookup with the native address */
+	addr = zsocket_address_new ("10.1.2.200", 80);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (zsocket_address_to_native (addr, &sa, sizeof (sa)) == TRUE);
+	P_TEST_CHECK (zradix_tree_lookup_native (tree, &sa, sizeof (sa), &len) == PINT_TO_POINTER (24));
+	P_TEST_CHECK (len == 24);
+	zsocket_address_free (addr);
+
+	/* Replacing the value */
+	P_TEST_CHECK (radix_test_insert (tree, "10.1.0.0", 16, PINT_TO_POINTER (160)) == TRUE);
+	P_TEST_CHECK (zradix_tree_get_nprefixes (tree) == 6);
+	P_TEST_CHECK (radix_test_destroy_count == 1);
+	P_TEST_CHECK (radix_test_lookup (tree, "10.1.3.4", NULL) == PINT_TO_POINTER (160));
+
+	/* Default route */
+	P_TEST_CHECK (radix_test_insert (tree, "0.0.0.0", 0, PINT_TO_POINTER (100)) == TRUE);
+	P_TEST_CHECK (radix_test_lookup (tree, "11.0.0.1", &len) == PINT_TO_POINTER (100));
+	P_TEST_CHECK (len == 0);
+
+	/* Removal */
+	P_TEST_CHECK (radix_test_remove (tree, "10.1.2.0", 23) == FALSE);
+	P_TEST_CHECK (radix_test_remove (tree, "10.1.2.0", 24) == TRUE);
+	P_TEST_CHECK (radix_test_remove (tree, "10.1.2.0", 24) == FALSE);
+	P_TEST_CHECK (radix_test_destroy_count == 2);
+	P_TEST_CHECK (radix_test_lookup (tree, "10.1.2.4", NULL) == PINT_TO_POINTER (160));
+	P_TEST_CHECK (radix_test_lookup (tree, "10.1.2.3", NULL) == PINT_TO_POINTER (32));
+
+	P_TEST_CHECK (radix_test_remove (tree, "10.0.0.0", 8) == TRUE);
+	P_TEST_CHECK (radix_test_lookup (tree, "10.2.3.4", NULL) == PINT_TO_POINTER (100));
+	P_TEST_CHECK (radix_test_lookup (tree, "10.1.2.3", NULL) == PINT_TO_POINTER (32));
+	P_TEST_CHECK (zradix_tree_get_nprefixes (tree) == 5);
+
+	/* IPv6 addresses are kept separately */
+	if (zsocket_address_is_ipv6_supported ())
+		P_TEST_CHECK (radix_test_lookup (tree, "::1", NULL) == NULL);
+
+	zradix_tree_clear (tree);
+	P_TEST_CHECK (zradix_tree_get_nprefixes (tree) == 0);
+	P_TEST_CHECK (radix_test_destroy_count == 8);
+	P_TEST_CHECK (radix_test_lookup (tree, "10.1.2.3", NULL) == NULL);
+
+	P_TEST_CHECK (radix_test_insert (tree, "10.0.0.0", 8, PINT_TO_POINTER (8)) == TRUE);
+	zradix_tree_free (tree);
+	P_TEST_CHECK (radix_test_destroy_count == 9);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pradixtree_ipv6_test)
+{
+	zlibsys_init ();
+
+	PRadixTree	*tree;
+	puint		len;
+
+	if (!zsocket_address_is_ipv6_supported ()) {
+		zlibsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	tree = zradix_tree_new ();
+	P_TEST_REQUIRE (tree != NULL);
+
+	P_TEST_CHECK (radix_test_insert (tree, "2001:db8::", 32, PINT_TO_POINTER (32)) == TRUE);
+	P_TEST_CHECK (radix_test_insert (tree, "2001:db8:1::", 48, PINT_TO_POINTER (48)) == TRUE);
+	P_TEST_CHECK (radix_test_insert (tree, "2001:db8:1::1", 128, PINT_TO_POINTER (128)) == TRUE);
+	P_TEST_CHECK (radix_test_insert (tree, "fe80::", 10, PINT_TO_POINTER (10)) == TRUE);
+	P_TEST_CHECK (radix_test_insert (tree, "2001:db8::", 129, NULL) == FALSE);
+
+	P_TEST_CHECK (zradix_tree_get_nprefixes (tree) == 4);
+
+	P_TEST_CHECK (radix_test_lookup (tree, "2001:db8:1::1", &len) == PINT_TO_POINTER (128));
+	P_TEST_CHECK (len == 128);
+	P_TEST_CHECK (radix_test_lookup (tree, "2001:db8:1::2", &len) == PINT_TO_POINTER (48));
+	P_TEST_CHECK (len == 48);
+	P_TEST_CHECK (radix_test_lookup (tree, "2001:db8:2::1", &len) == PINT_TO_POINTER (32));
+	P_TEST_CHECK (len == 32);
+	P_TEST_CHECK (radix_test_lookup (tree, "febf::1", NULL) == PINT_TO_POINTER (10));
+	P_TEST_CHECK (radix_test_lookup (tree, "fec0::1", NULL) == NULL);
+	P_TEST_CHECK (radix_test_lookup (tree, "2001:db9::", NULL) == NULL);
+
+	/* IPv4 addresses are kept separately */
+	P_TEST_CHECK (radix_test_lookup (tree, "32.1.13.184", NULL) == NULL);
+
+	P_TEST_CHECK (radix_test_remove (tree, "2001:db8:1::", 48) == TRUE);
+	P_TEST_CHECK (radix_test_lookup (tree, "2001:db8:1::2", NULL) == PINT_TO_POINTER (32));
+	P_TEST_CHECK (radix_test_lookup (tree, "2001:db8:1::1", NULL) == PINT_TO_POINTER (128));
+	P_TEST_CHECK (zradix_tree_get_nprefixes (tree) == 3);
+
+	zradix_tree_free (tree);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pradixtree_random_test)
+{
+	zlibsys_init ();
+
+	PRadixTree		*tree;
+	RadixTestPrefix		*prefixes;
+	struct sockaddr_in	sa;
+	puint32			addr;
+	puint			best_len;
+	pint			best;
+	pint			nused;
+	ppointer		value;
+	puint			len;
+
+	tree     = zradix_tree_new ();
+	prefixes = (RadixTestPrefix *) zmalloc0 (PRADIXTREE_TEST_NPREFIXES * sizeof (RadixTestPrefix));
+	P_TEST_REQUIRE (tree != NULL && prefixes != NULL);
+
+	memset (&sa, 0, sizeof (sa));
+	sa.sin_family = AF_INET;
+
+	srand (200);
+
+	/* Random prefixes clustered in a small space to get many nested ones */
+	for (pint i = 0; i < PRADIXTREE_TEST_NPREFIXES; ++i) {
+		prefixes[i].len  = 8 + (puint) (rand () % 25);
+		prefixes[i].addr = (0x0A000000U | (radix_test_rand32 () & 0x00FF0F0FU)) &
+				   radix_test_mask (prefixes[i].len);
+		prefixes[i].used = TRUE;
+
+		for (pint j = 0; j < i; ++j) {
+			if (prefixes[j].used &&
+			    prefixes[j].len == prefixes[i].len &&
+			    prefixes[j].addr == prefixes[i].addr) {
+				prefixes[i].used = FALSE;
+				break;
+			}
+		}
+
+		if (!prefixes[i].used)
+			continue;
+
+		sa.sin_addr.s_addr = htonl (prefixes[i].addr);
+		P_TEST_CHECK (zradix_tree_insert_native (tree,
+							 &sa,
+							 sizeof (sa),
+							 prefixes[i].len,
+							 PINT_TO_POINTER (i + 1)) == TRUE);
+	}
+
+	for (pint round = 0; round < 2; ++round) {
+		nused = 0;
+
+		for (pint i = 0; i < PRADIXTREE_TEST_NPREFIXES; ++i) {
+			if (prefixes[i].used)
+				++nused;
+		}
+
+		P_TEST_CHECK (zradix_tree_get_nprefixes (tree) == (psize) nused);
+
+		for (pint i = 0; i < PRADIXTREE_TEST_NLOOKUPS; ++i) {
+			addr = 0x0A000000U | (radix_test_rand32 () & 0x00FF0F0FU);
+
+			best     = -1;
+			best_len = 0;
+
+			for (pint j = 0; j < PRADIXTREE_TEST_NPREFIXES; ++j) {
+				if (!prefixes[j].used)
+					continue;
+
+				if ((addr & radix_test_mask (prefixes[j].len)) != prefixes[j].addr)
+					continue;
+
+				if (best < 0 || prefixes[j].len > best_len) {
+					best     = j;
+					best_len = prefixes[j].len;
+				}
+			}
+
+			sa.sin_addr.s_addr = htonl (addr);
+			value = zradix_tree_lookup_native (tree, &sa, sizeof (sa), &len);
+
+			if (best < 0)
+				P_TEST_CHECK (value == NULL);
+			else {
+				P_TEST_CHECK (value == PINT_TO_POINTER (best + 1));
+				P_TEST_CHECK (len == best_len);
+			}
+		}
+
+		/* Remove every second prefix and check again */
+		for (pint i = 0; i < PRADIXTREE_TEST_NPREFIXES; i += 2) {
+			if (!prefixes[i].used)
+				continue;
+
+			sa.sin_addr.s_addr = htonl (prefixes[i].addr);
+			P_TEST_CHECK (zradix_tree_remove_native (tree, &sa, sizeof (sa), prefixes[i].len) == TRUE);
+			prefixes[i].used = FALSE;
+		}
+	}
+
+	zfree (prefixes);
+	zradix_tree_free (tree);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pradixtree_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pradixtree_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pradixtree_ipv4_test);
+	P_TEST_SUITE_RUN_CASE (pradixtree_ipv6_test);
+	P_TEST_SUITE_RUN_CASE (pradixtree_random_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,548 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSKIPLIST_TEST_NKEYS		2000
+#define PSKIPLIST_TEST_NTHREADS		4
+#define PSKIPLIST_TEST_THREAD_NKEYS	2000
+#define PSKIPLIST_TEST_RECLAIM_NKEYS	1000
+#define PSKIPLIST_TEST_RECLAIM_ROUNDS	40
+#define PSKIPLIST_TEST_MAX_RETIRED	256
+
+typedef struct _SkipListTestData {
+	PSkipList	*list;
+	pint		index;
+} SkipListTestData;
+
+typedef struct _SkipListCollectData {
+	pint		count;
+	pint		last;
+	pboolean	ordered;
+	pint		stop_at;
+} SkipListCollectData;
+
+static pint skip_list_test_key_destroyed = 0;
+static pint skip_list_test_value_destroyed = 0;
+static volatile pint skip_list_test_errors = 0;
+static volatile pint skip_list_test_inserted = 0;
+static volatile pint skip_list_test_stop = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+extern "C" pint skip_list_test_compare (pconstpointer a, pconstpointer b)
+{
+	pint p1 = PPOINTER_TO_INT (a);
+	pint p2 = PPOINTER_TO_INT (b);
+
+	if (p1 < p2)
+		return -1;
+	else if (p1 > p2)
+		return 1;
+	else
+		return 0;
+}
+
+extern "C" pint skip_list_test_compare_data (pconstpointer a, pconstpointer b, ppointer data)
+{
+	P_UNUSED (data);
+
+	return skip_list_test_compare (a, b);
+}
+
+extern "C" void skip_list_test_key_destroy (ppointer data)
+{
+	P_UNUSED (data);
+	zatomic_int_inc (&skip_list_test_key_destroyed);
+}
+
+extern "C" void skip_list_test_value_destroy (ppointer data)
+{
+	P_UNUSED (data);
+	zatomic_int_inc (&skip_list_test_value_destroyed);
+}
+
+extern "C" pboolean skip_list_test_collect (ppointer key, ppointer value, ppointer user_data)
+{
+	SkipListCollectData *data = (SkipListCollectData *) user_data;
+
+	if (PPOINTER_TO_INT (key) <= data->last || PPOINTER_TO_INT (value) != PPOINTER_TO_INT (key) * 10)
+		data->ordered = FALSE;
+
+	data->last = PPOINTER_TO_INT (key);
+	++data->count;
+
+	return data->count == data->stop_at;
+}
+
+static void * skip_list_test_thread (void *arg)
+{
+	SkipListTestData	*data = (SkipListTestData *) arg;
+	SkipListCollectData	collect;
+	ppointer		value;
+	pint			base;
+	pint			key;
+
+	/* Own keys are interleaved with the keys of other threads */
+	base = data->index;
+
+	for (pint i = 0; i < PSKIPLIST_TEST_THREAD_NKEYS; ++i) {
+		key = (i * PSKIPLIST_TEST_NTHREADS + base) + 1;
+
+		if (zskip_list_insert (data->list, PINT_TO_POINTER (key), PINT_TO_POINTER (key * 10)) == FALSE)
+			zatomic_int_inc (&skip_list_test_errors);
+		else
+			zatomic_int_inc (&skip_list_test_inserted);
+	}
+
+	for (pint i = 0; i < PSKIPLIST_TEST_THREAD_NKEYS; ++i) {
+		key = (i * PSKIPLIST_TEST_NTHREADS + base) + 1;
+
+		if (zskip_list_lookup (data->list, PINT_TO_POINTER (key), &value) == FALSE ||
+		    PPOINTER_TO_INT (value) != key * 10)
+			zatomic_int_inc (&skip_list_test_errors);
+
+		/* Remove odd keys */
+		if ((i & 1) == 1 && zskip_list_remove (data->list, PINT_TO_POINTER (key)) == FALSE)
+			zatomic_int_inc (&skip_list_test_errors);
+	}
+
+	/* Contended keys: every thread competes for the same ones */
+	for (pint i = 0; i < PSKIPLIST_TEST_THREAD_NKEYS; ++i) {
+		key = -(i % 64) - 1;
+
+		if (i % 3 == 0)
+			zskip_list_remove (data->list, PINT_TO_POINTER (key));
+		else if (zskip_list_insert (data->list, PINT_TO_POINTER (key), PINT_TO_POINTER (key * 10)) == TRUE)
+			zatomic_int_inc (&skip_list_test_inserted);
+
+		if (i % 100 == 0) {
+			memset (&collect, 0, sizeof (collect));
+			collect.last    = -1000;
+			collect.ordered = TRUE;
+
+			zskip_list_foreach (data->list, skip_list_test_collect, &collect);
+
+			if (collect.ordered == FALSE)
+				zatomic_int_inc (&skip_list_test_errors);
+		}
+	}
+
+	return NULL;
+}
+
+static void * skip_list_test_reader_thread (void *arg)
+{
+	SkipListTestData	*data = (SkipListTestData *) arg;
+	ppointer		value;
+	pint			key;
+
+	key = data->index;
+
+	/* Readers are inside the list all the time while the writer removes */
+	while (zatomic_int_get (&skip_list_test_stop) == 0) {
+		key = (key + 7) % PSKIPLIST_TEST_RECLAIM_NKEYS;
+
+		if (zskip_list_lookup (data->list, PINT_TO_POINTER (key), &value) == TRUE &&
+		    PPOINTER_TO_INT (value) != key * 10)
+			zatomic_int_inc (&skip_list_test_errors);
+	}
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pskiplist_nomem_test)
+{
+	zlibsys_init ();
+
+	PSkipList	*list;
+	PMemVTable	vtable;
+
+	list = zskip_list_new (skip_list_test_compare);
+	P_TEST_REQUIRE (list != NULL);
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zskip_list_new (skip_list_test_compare) == NULL);
+	P_TEST_CHECK (zskip_list_new_with_data (skip_list_test_compare_data, NULL) == NULL);
+	P_TEST_CHECK (zskip_list_insert (list, PINT_TO_POINTER (1), NULL) == FALSE);
+
+	zmem_restore_vtable ();
+
+	P_TEST_CHECK (zskip_list_get_nnodes (list) == 0);
+	P_TEST_CHECK (zskip_list_lookup (list, PINT_TO_POINTER (1), NULL) == FALSE);
+
+	zskip_list_free (list);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pskiplist_invalid_test)
+{
+	zlibsys_init ();
+
+	P_TEST_CHECK (zskip_list_new (NULL) == NULL);
+	P_TEST_CHECK (zskip_list_new_with_data (NULL, NULL) == NULL);
+	P_TEST_CHECK (zskip_list_new_full (NULL, NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (zskip_list_insert (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (zskip_list_remove (NULL, NULL) == FALSE);
+	P_TEST_CHECK (zskip_list_lookup (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (zskip_list_get_nnodes (NULL) == 0);
+
+	zskip_list_foreach (NULL, NULL, NULL);
+	zskip_list_foreach_range (NULL, NULL, NULL, NULL, NULL);
+	zskip_list_free (NULL);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pskiplist_general_test)
+{
+	zlibsys_init ();
+
+	PSkipList		*list;
+	SkipListCollectData	collect;
+	pboolean		*model;
+	ppointer		value;
+	pint			inserted;
+	pint			count;
+	pint			key;
+
+	skip_list_test_key_destroyed   = 0;
+	skip_list_test_value_destroyed = 0;
+
+	list  = zskip_list_new_full (skip_list_test_compare_data,
+				     NULL,
+				     skip_list_test_key_destroy,
+				     skip_list_test_value_destroy);
+	model = (pboolean *) zmalloc0 (PSKIPLIST_TEST_NKEYS * sizeof (pboolean));
+	P_TEST_REQUIRE (list != NULL && model != NULL);
+
+	P_TEST_CHECK (zskip_list_lookup (list, PINT_TO_POINTER (10), NULL) == FALSE);
+	P_TEST_CHECK (zskip_list_remove (list, PINT_TO_POINTER (10)) == FALSE);
+
+	srand (300);
+
+	inserted = 0;
+
+	for (pint i = 0; i < PSKIPLIST_TEST_NKEYS * 2; ++i) {
+		key = rand () % PSKIPLIST_TEST_NKEYS;
+
+		P_TEST_CHECK (zskip_list_insert (list,
+						 PINT_TO_POINTER (key),
+						 PINT_TO_POINTER (key * 10)) == !model[key]);
+
+		if (!model[key])
+			++inserted;
+
+		model[key] = TRUE;
+	}
+
+	count = 0;
+
+	for (pint i = 0; i < PSKIPLIST_TEST_NKEYS; ++i) {
+		value = NULL;
+
+		P_TEST_CHECK (zskip_list_lookup (list, PINT_TO_POINTER (i), &value) == model[i]);
+
+		if (model[i]) {
+			P_TEST_CHECK (PPOINTER_TO_INT (value) == i * 10);
+			++count;
+		}
+	}
+
+	P_TEST_CHECK (zskip_list_get_nnodes (list) == count);
+
+	/* Keys which failed to insert are still owned by the caller */
+	P_TEST_CHECK (skip_list_test_key_destroyed == 0);
+
+	memset (&collect, 0, sizeof (collect));
+	collect.last    = -1;
+	collect.ordered = TRUE;
+
+	zskip_list_foreach (list, skip_list_test_collect, &collect);
+
+	P_TEST_CHECK (collect.count == count);
+	P_TEST_CHECK (collect.ordered == TRUE);
+
+	/* Remove a half of the keys */
+	for (pint i = 0; i < PSKIPLIST_TEST_NKEYS; i += 2) {
+		P_TEST_CHECK (zskip_list_remove (list, PINT_TO_POINTER (i)) == model[i]);
+
+		if (model[i]) {
+			model[i] = FALSE;
+			--count;
+		}
+	}
+
+	P_TEST_CHECK (zskip_list_get_nnodes (list) == count);
+	P_TEST_CHECK (skip_list_test_key_destroyed == skip_list_test_value_destroyed);
+	P_TEST_CHECK (skip_list_test_key_destroyed > 0);
+
+	for (pint i = 0; i < PSKIPLIST_TEST_NKEYS; ++i)
+		P_TEST_CHECK (zskip_list_lookup (list, PINT_TO_POINTER (i), NULL) == model[i]);
+
+	/* Range iteration */
+	memset (&collect, 0, sizeof (collect));
+	collect.last    = 99;
+	collect.ordered = TRUE;
+
+	zskip_list_foreach_range (list,
+				  PINT_TO_POINTER (100),
+				  PINT_TO_POINTER (200),
+				  skip_list_test_collect,
+				  &collect);
+
+	count = 0;
+
+	for (pint i = 100; i < 200; ++i) {
+		if (model[i])
+			++count;
+	}
+
+	P_TEST_CHECK (collect.count == count);
+	P_TEST_CHECK (collect.ordered == TRUE);
+	P_TEST_CHECK (collect.last < 200);
+
+	/* Stop the iteration */
+	memset (&collect, 0, sizeof (collect));
+	collect.last    = -1;
+	collect.ordered = TRUE;
+	collect.stop_at = 5;
+
+	zskip_list_foreach (list, skip_list_test_collect, &collect);
+
+	P_TEST_CHECK (collect.count == 5);
+
+	/* Empty range */
+	memset (&collect, 0, sizeof (collect));
+	collect.last    = -1;
+	collect.ordered = TRUE;
+
+	zskip_list_foreach_range (list,
+				  PINT_TO_POINTER (PSKIPLIST_TEST_NKEYS),
+				  PINT_TO_POINTER (PSKIPLIST_TEST_NKEYS * 2),
+				  skip_list_test_collect,
+				  &collect);
+
+	P_TEST_CHECK (collect.count == 0);
+
+	zskip_list_free (list);
+	zfree (model);
+
+	/* Removed nodes still waiting for reclamation are destroyed as well */
+	P_TEST_CHECK (skip_list_test_key_destroyed == inserted);
+	P_TEST_CHECK (skip_list_test_value_destroyed == inserted);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pskiplist_thread_test)
+{
+	zlibsys_init ();
+
+	PSkipList		*list;
+	PUThread		*threads[PSKIPLIST_TEST_NTHREADS];
+	SkipListTestData	data[PSKIPLIST_TEST_NTHREADS];
+	SkipListCollectData	collect;
+	pint			key;
+
+	skip_list_test_key_destroyed   = 0;
+	skip_list_test_value_destroyed = 0;
+	skip_list_test_errors          = 0;
+	skip_list_test_inserted        = 0;
+
+	list = zskip_list_new_full (skip_list_test_compare_data,
+				    NULL,
+				    NULL,
+				    skip_list_test_value_destroy);
+	P_TEST_REQUIRE (list != NULL);
+
+	for (pint i = 0; i < PSKIPLIST_TEST_NTHREADS; ++i) {
+		data[i].list  = list;
+		data[i].index = i;
+
+		threads[i] = zuthread_create ((PUThreadFunc) skip_list_test_thread, &data[i], TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (pint i = 0; i < PSKIPLIST_TEST_NTHREADS; ++i) {
+		P_TEST_CHECK (zuthread_join (threads[i]) == 0);
+		zuthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (skip_list_test_errors == 0);
+
+	/* Only even own keys of every thread are left */
+	for (pint i = 0; i < PSKIPLIST_TEST_THREAD_NKEYS; ++i) {
+		for (pint j = 0; j < PSKIPLIST_TEST_NTHREADS; ++j) {
+			key = (i * PSKIPLIST_TEST_NTHREADS + j) + 1;
+			P_TEST_CHECK (zskip_list_lookup (list, PINT_TO_POINTER (key), NULL) == ((i & 1) == 0));
+		}
+	}
+
+	memset (&collect, 0, sizeof (collect));
+	collect.last    = -1000;
+	collect.ordered = TRUE;
+
+	zskip_list_foreach (list, skip_list_test_collect, &collect);
+
+	P_TEST_CHECK (collect.ordered == TRUE);
+	P_TEST_CHECK (collect.count == zskip_list_get_nnodes (list));
+
+	/* Only a bounded number of the removed nodes waits for reclamation */
+	P_TEST_CHECK (skip_list_test_value_destroyed + zskip_list_get_nnodes (list) <=
+		      skip_list_test_inserted);
+	P_TEST_CHECK (skip_list_test_inserted - zskip_list_get_nnodes (list) -
+		      skip_list_test_value_destroyed <= PSKIPLIST_TEST_MAX_RETIRED);
+
+	zskip_list_free (list);
+
+	/* Every inserted node has been destroyed exactly once */
+	P_TEST_CHECK (skip_list_test_value_destroyed == skip_list_test_inserted);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pskiplist_reclaim_test)
+{
+	zlibsys_init ();
+
+	PSkipList		*list;
+	PUThread		*threads[PSKIPLIST_TEST_NTHREADS];
+	SkipListTestData	data[PSKIPLIST_TEST_NTHREADS];
+	pint			removed;
+	pint			pending;
+	pint			max_pending;
+	pint			tries;
+
+	skip_list_test_value_destroyed = 0;
+	skip_list_test_errors          = 0;
+	skip_list_test_stop            = 0;
+
+	list = zskip_list_new_full (skip_list_test_compare_data,
+				    NULL,
+				    NULL,
+				    skip_list_test_value_destroy);
+	P_TEST_REQUIRE (list != NULL);
+
+	for (pint i = 0; i < PSKIPLIST_TEST_NTHREADS; ++i) {
+		data[i].list  = list;
+		data[i].index = i;
+
+		threads[i] = zuthread_create ((PUThreadFunc) skip_list_test_reader_thread, &data[i], TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	removed     = 0;
+	max_pending = 0;
+
+	for (pint r = 0; r < PSKIPLIST_TEST_RECLAIM_ROUNDS; ++r) {
+		for (pint i = 0; i < PSKIPLIST_TEST_RECLAIM_NKEYS; ++i)
+			P_TEST_CHECK (zskip_list_insert (list, PINT_TO_POINTER (i), PINT_TO_POINTER (i * 10)) == TRUE);
+
+		for (pint i = 0; i < PSKIPLIST_TEST_RECLAIM_NKEYS; ++i) {
+			P_TEST_CHECK (zskip_list_remove (list, PINT_TO_POINTER (i)) == TRUE);
+			++removed;
+		}
+
+		/* A reader may be preempted inside the list for a while, give it
+		 * a chance to move on before the check */
+		pending = removed - zatomic_int_get (&skip_list_test_value_destroyed);
+
+		for (tries = 0; tries < 1000 && pending > PSKIPLIST_TEST_MAX_RETIRED; ++tries) {
+			zuthread_yield ();
+
+			zskip_list_insert (list, PINT_TO_POINTER (-1), PINT_TO_POINTER (-10));
+			zskip_list_remove (list, PINT_TO_POINTER (-1));
+			++removed;
+
+			pending = removed - zatomic_int_get (&skip_list_test_value_destroyed);
+		}
+
+		if (pending > max_pending)
+			max_pending = pending;
+	}
+
+	/* Retired memory stays bounded while the readers are still inside */
+	P_TEST_CHECK (max_pending <= PSKIPLIST_TEST_MAX_RETIRED);
+
+	zatomic_int_set (&skip_list_test_stop, 1);
+
+	for (pint i = 0; i < PSKIPLIST_TEST_NTHREADS; ++i) {
+		P_TEST_CHECK (zuthread_join (threads[i]) == 0);
+		zuthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (skip_list_test_errors == 0);
+	P_TEST_CHECK (zskip_list_get_nnodes (list) == 0);
+
+	zskip_list_free (list);
+
+	P_TEST_CHECK (skip_list_test_value_destroyed == removed);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pskiplist_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pskiplist_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pskiplist_general_test);
+	P_TEST_SUITE_RUN_CASE (pskiplist_thread_test);
+	P_TEST_SUITE_RUN_CASE (pskiplist_reclaim_test);
+}
+P_TEST_SUITE_END()
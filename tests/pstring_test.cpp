@@ -26,12 +26,76 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <float.h>
 #include <math.h>
 
 P_TEST_MODULE_INIT ();
 
+static puint64 pstring_test_rand_state = 0x9E3779B97F4A7C15ULL;
+
+static puint64
+pstring_test_rand (void)
+{
+	pstring_test_rand_state ^= pstring_test_rand_state << 13;
+	pstring_test_rand_state ^= pstring_test_rand_state >> 7;
+	pstring_test_rand_state ^= pstring_test_rand_state << 17;
+
+	return pstring_test_rand_state;
+}
+
+#define PSTRING_INTERN_THREADS	4
+#define PSTRING_INTERN_STRINGS	2000
+
+static const pchar *pstring_intern_results[PSTRING_INTERN_THREADS][PSTRING_INTERN_STRINGS];
+
+static ppointer
+pstring_intern_thread_func (ppointer data)
+{
+	pint	index = P_POINTER_TO_INT (data);
+	pchar	buf[32];
+	pint	i, j;
+
+	/* Each thread interns the same set in a different order */
+	for (i = 0; i < PSTRING_INTERN_STRINGS; ++i) {
+		j = (i * 7 + index * 13) % PSTRING_INTERN_STRINGS;
+
+		sprintf (buf, "label_%d", j);
+		pstring_intern_results[index][j] = zstr_intern (buf);
+	}
+
+	return NULL;
+}
+
+static bool
+pstring_test_same_double (double a, double b)
+{
+	return memcmp (&a, &b, sizeof (double)) == 0;
+}
+
+static bool
+pstring_test_check_strtod (const pchar *str)
+{
+	const pchar	*end;
+	pchar		*sys_end;
+	double		val;
+	double		sys_val;
+
+	sys_val = strtod (str, &sys_end);
+	val     = zstrntod (str, strlen (str), &end);
+
+	if (!pstring_test_same_double (val, sys_val) || end != sys_end)
+		return false;
+
+	/* Legacy call clamps the explicit positive exponent only */
+	if (strchr (str, 'e') != NULL && atoi (strchr (str, 'e') + 1) > 308)
+		return true;
+
+	return pstring_test_same_double (zstrtod (str), sys_val);
+}
+
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
 	P_UNUSED (nbytes);
@@ -63,6 +127,9 @@ P_TEST_CASE_BEGIN (pstring_nomem_test)
 	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
 
 	P_TEST_CHECK (zstrdup ("test string") == NULL);
+	P_TEST_CHECK (zstrndup ("test string", 4) == NULL);
+	P_TEST_CHECK (zstr_intern ("test string") == NULL);
+	P_TEST_CHECK (zstr_intern_lookup ("test string") == NULL);
 
 	zmem_restore_vtable ();
 
@@ -238,6 +305,130 @@ P_TEST_CASE_BEGIN (pstring_strtok_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pstring_strndup_test)
+{
+	pchar *str;
+
+	zlibsys_init ();
+
+	P_TEST_CHECK (zstrndup (NULL, 5) == NULL);
+
+	str = zstrndup ("Test string", 4);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strcmp (str, "Test") == 0);
+	zfree (str);
+
+	str = zstrndup ("Test", 0);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (str[0] == '\0');
+	zfree (str);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_strchomp_span_test)
+{
+	const pchar	*span;
+	pchar		*str;
+	pchar		buf[32];
+	psize		len;
+
+	zlibsys_init ();
+
+	P_TEST_CHECK (zstrchomp_span (NULL, 10, &len) == NULL);
+	P_TEST_CHECK (len == 0);
+	P_TEST_CHECK (zstrchomp_inplace (NULL) == NULL);
+
+	const pchar *test_str = " \t Test string \n\r  tail";
+
+	span = zstrchomp_span (test_str, 19, &len);
+	P_TEST_CHECK (span == test_str + 3);
+	P_TEST_CHECK (len == 11);
+	P_TEST_CHECK (strncmp (span, "Test string", len) == 0);
+
+	span = zstrchomp_span (test_str, 3, &len);
+	P_TEST_CHECK (len == 0);
+
+	span = zstrchomp_span (test_str, strlen (test_str), NULL);
+	P_TEST_CHECK (span == test_str + 3);
+
+	span = zstrchomp_span ("", 0, &len);
+	P_TEST_CHECK (span != NULL && len == 0);
+
+	strcpy (buf, "  In place\t\n");
+	str = zstrchomp_inplace (buf);
+	P_TEST_CHECK (str == buf + 2);
+	P_TEST_CHECK (strcmp (str, "In place") == 0);
+
+	strcpy (buf, " \t\n ");
+	str = zstrchomp_inplace (buf);
+	P_TEST_CHECK (str != NULL && str[0] == '\0');
+
+	strcpy (buf, "Text");
+	str = zstrchomp_inplace (buf);
+	P_TEST_CHECK (str == buf && strcmp (str, "Text") == 0);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_strtok_span_test)
+{
+	const pchar	*str;
+	const pchar	*token;
+	psize		len;
+	psize		token_len;
+
+	zlibsys_init ();
+
+	str = "a";
+	len = 1;
+
+	P_TEST_CHECK (zstrtok_span (NULL, &len, ",", &token_len) == NULL);
+	P_TEST_CHECK (zstrtok_span (&str, NULL, ",", &token_len) == NULL);
+	P_TEST_CHECK (zstrtok_span (&str, &len, NULL, &token_len) == NULL);
+
+	/* Tokens with repeated delimiters */
+	str = ",,Test, string,,,1 ;";
+	len = strlen (str);
+
+	token = zstrtok_span (&str, &len, ", ", &token_len);
+	P_TEST_REQUIRE (token != NULL);
+	P_TEST_CHECK (token_len == 4 && strncmp (token, "Test", token_len) == 0);
+
+	token = zstrtok_span (&str, &len, ", ", &token_len);
+	P_TEST_REQUIRE (token != NULL);
+	P_TEST_CHECK (token_len == 6 && strncmp (token, "string", token_len) == 0);
+
+	/* Delimiters may change between the calls */
+	token = zstrtok_span (&str, &len, ",", &token_len);
+	P_TEST_REQUIRE (token != NULL);
+	P_TEST_CHECK (token_len == 3 && strncmp (token, "1 ;", token_len) == 0);
+	P_TEST_CHECK (len == 0);
+
+	P_TEST_CHECK (zstrtok_span (&str, &len, ",", &token_len) == NULL);
+	P_TEST_CHECK (token_len == 0);
+
+	/* Length bound and no delimiters */
+	str = "Test string";
+	len = 6;
+
+	token = zstrtok_span (&str, &len, "", NULL);
+	P_TEST_CHECK (token != NULL && strncmp (token, "Test s", 6) == 0);
+	P_TEST_CHECK (len == 0 && *str == 't');
+
+	/* Only delimiters */
+	str = " \t ";
+	len = strlen (str);
+
+	P_TEST_CHECK (zstrtok_span (&str, &len, " \t", &token_len) == NULL);
+	P_TEST_CHECK (len == 0);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_CASE_BEGIN (pstring_strtod_test)
 {
 	zlibsys_init ();
@@ -273,6 +464,335 @@ P_TEST_CASE_BEGIN (pstring_strtod_test)
 	P_TEST_CHECK_CLOSE (zstrtod ("2.14e10"), 2.14e10, 0.0001);
 	P_TEST_CHECK_CLOSE (zstrtod ("2.14e-10"), 2.14e-10, 0.0001);
 	P_TEST_CHECK_CLOSE (zstrtod ("1.10e310"), 1.10e308, 0.0001);
+	P_TEST_CHECK (zstrtod ("4.9406564584124654e-324") == 4.9406564584124654e-324);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_strntod_test)
+{
+	const pchar	*end;
+	const pchar	*str;
+	pchar		buf[1024];
+	double		val;
+	puint64		bits;
+	pint		i, j, len;
+
+	zlibsys_init ();
+
+	/* Incorrect input */
+	P_TEST_CHECK (zstrntod (NULL, 10, &end) == 0.0 && end == NULL);
+
+	str = "abc";
+	P_TEST_CHECK (zstrntod (str, 3, &end) == 0.0 && end == str);
+
+	str = "  -.e5";
+	P_TEST_CHECK (zstrntod (str, strlen (str), &end) == 0.0 && end == str);
+
+	P_TEST_CHECK (zstrntod ("12", 0, &end) == 0.0);
+
+	/* End position and length bound */
+	str = "  12.5e";
+	P_TEST_CHECK (zstrntod (str, strlen (str), &end) == 12.5);
+	P_TEST_CHECK (end == str + 6);
+
+	str = "1.5e+x";
+	P_TEST_CHECK (zstrntod (str, strlen (str), &end) == 1.5);
+	P_TEST_CHECK (end == str + 3);
+
+	str = "123456";
+	P_TEST_CHECK (zstrntod (str, 3, &end) == 123.0);
+	P_TEST_CHECK (end == str + 3);
+
+	str = "1e5";
+	P_TEST_CHECK (zstrntod (str, 2, &end) == 1.0);
+	P_TEST_CHECK (end == str + 1);
+
+	str = "-.5;";
+	P_TEST_CHECK (zstrntod (str, strlen (str), &end) == -0.5);
+	P_TEST_CHECK (end == str + 3);
+
+	P_TEST_CHECK (zstrntod ("5.", 2, NULL) == 5.0);
+
+	val = zstrntod ("-0.0", 4, NULL);
+	P_TEST_CHECK (val == 0.0 && signbit (val));
+
+	/* Overflow and underflow */
+	P_TEST_CHECK (zstrntod ("1e309", 5, NULL) > DBL_MAX);
+	P_TEST_CHECK (zstrntod ("-1e99999999999", 14, NULL) < -DBL_MAX);
+	P_TEST_CHECK (zstrntod ("1e-400", 6, NULL) == 0.0);
+	P_TEST_CHECK (zstrntod ("1e-99999999999", 14, NULL) == 0.0);
+	P_TEST_CHECK (zstrtod ("1e-400") == 0.0);
+	P_TEST_CHECK (zstrtod ("1e400") == 1e308);
+
+	/* Hard cases */
+	P_TEST_CHECK (pstring_test_check_strtod ("9007199254740993"));
+	P_TEST_CHECK (pstring_test_check_strtod ("9007199254740993.0000000000000000001"));
+	P_TEST_CHECK (pstring_test_check_strtod ("9007199254740995"));
+	P_TEST_CHECK (pstring_test_check_strtod ("1.00000000000000011102230246251565404236316680908203125"));
+	P_TEST_CHECK (pstring_test_check_strtod ("1.00000000000000011102230246251565404236316680908203124"));
+	P_TEST_CHECK (pstring_test_check_strtod ("1.000000000000000111022302462515654042363166809082031250000001"));
+	P_TEST_CHECK (pstring_test_check_strtod ("4.9406564584124654e-324"));
+	P_TEST_CHECK (pstring_test_check_strtod ("2.4703282292062327e-324"));
+	P_TEST_CHECK (pstring_test_check_strtod ("2.4703282292062328e-324"));
+	P_TEST_CHECK (pstring_test_check_strtod ("2.2250738585072011e-308"));
+	P_TEST_CHECK (pstring_test_check_strtod ("2.2250738585072012e-308"));
+	P_TEST_CHECK (pstring_test_check_strtod ("1.7976931348623157e308"));
+	P_TEST_CHECK (pstring_test_check_strtod ("1.7976931348623158e308"));
+	P_TEST_CHECK (pstring_test_check_strtod ("1.7976931348623159e308"));
+	P_TEST_CHECK (pstring_test_check_strtod ("0.1"));
+	P_TEST_CHECK (pstring_test_check_strtod ("0.3"));
+	P_TEST_CHECK (pstring_test_check_strtod ("0.000000000000000000000000000000000000000000001e300"));
+	P_TEST_CHECK (pstring_test_check_strtod ("000000000000000000000000000000000000000000123.456"));
+
+	/* Long halfway input which needs all the digits */
+	strcpy (buf, "1.00000000000000011102230246251565404236316680908203125");
+	len = (pint) strlen (buf);
+
+	for (i = len; i < 900; ++i)
+		buf[i] = '0';
+
+	buf[i] = '\0';
+	P_TEST_CHECK (pstring_test_check_strtod (buf));
+
+	buf[899] = '1';
+	P_TEST_CHECK (pstring_test_check_strtod (buf));
+
+	/* Random doubles printed with different precision */
+	for (i = 0; i < 20000; ++i) {
+		do {
+			bits = pstring_test_rand ();
+			memcpy (&val, &bits, sizeof (double));
+		} while (val != val || val > DBL_MAX || val < -DBL_MAX);
+
+		sprintf (buf, "%.17g", val);
+		P_TEST_CHECK (pstring_test_check_strtod (buf));
+
+		sprintf (buf, "%.25e", val);
+		P_TEST_CHECK (pstring_test_check_strtod (buf));
+
+		sprintf (buf, "%.8g", val);
+		P_TEST_CHECK (pstring_test_check_strtod (buf));
+	}
+
+	/* Random decimal strings */
+	for (i = 0; i < 20000; ++i) {
+		len = (pint) (pstring_test_rand () % 40) + 1;
+
+		for (j = 0; j < len; ++j)
+			buf[j] = (pchar) ('0' + pstring_test_rand () % 10);
+
+		sprintf (buf + len, "e%d", (pint) (pstring_test_rand () % 700) - 350);
+		P_TEST_CHECK (pstring_test_check_strtod (buf));
+	}
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_intern_test)
+{
+	const pchar	*str1;
+	const pchar	*str2;
+	const pchar	*ptrs[3000];
+	pchar		buf[32];
+	pchar		*long_str;
+	pint		i;
+
+	zlibsys_init ();
+
+	P_TEST_CHECK (zstr_intern (NULL) == NULL);
+	P_TEST_CHECK (zstr_intern_len (NULL, 5) == NULL);
+	P_TEST_CHECK (zstr_intern_lookup (NULL) == NULL);
+	P_TEST_CHECK (zstr_intern_lookup ("not interned") == NULL);
+
+	/* Same strings from different buffers give the same pointer */
+	strcpy (buf, "section");
+
+	str1 = zstr_intern (buf);
+	P_TEST_REQUIRE (str1 != NULL);
+	P_TEST_CHECK (str1 != buf);
+	P_TEST_CHECK (strcmp (str1, "section") == 0);
+
+	str2 = zstr_intern ("section");
+	P_TEST_CHECK (str1 == str2);
+	P_TEST_CHECK (zstr_intern_lookup ("section") == str1);
+
+	str2 = zstr_intern_len ("section_name", 7);
+	P_TEST_CHECK (str1 == str2);
+
+	str2 = zstr_intern ("section_name");
+	P_TEST_REQUIRE (str2 != NULL);
+	P_TEST_CHECK (str1 != str2);
+	P_TEST_CHECK (strcmp (str2, "section_name") == 0);
+
+	/* Empty string */
+	str1 = zstr_intern ("");
+	P_TEST_REQUIRE (str1 != NULL);
+	P_TEST_CHECK (str1[0] == '\0');
+	P_TEST_CHECK (zstr_intern_len ("abc", 0) == str1);
+
+	/* Long strings */
+	long_str = (pchar *) zmalloc0 (10001);
+	P_TEST_REQUIRE (long_str != NULL);
+	memset (long_str, 'x', 10000);
+
+	str1 = zstr_intern (long_str);
+	P_TEST_REQUIRE (str1 != NULL);
+	P_TEST_CHECK (strlen (str1) == 10000);
+	P_TEST_CHECK (zstr_intern (long_str) == str1);
+
+	long_str[5000] = 'y';
+	P_TEST_CHECK (zstr_intern (long_str) != str1);
+	zfree (long_str);
+
+	/* Many strings */
+	for (i = 0; i < 3000; ++i) {
+		sprintf (buf, "key_%d", i);
+		ptrs[i] = zstr_intern (buf);
+		P_TEST_REQUIRE (ptrs[i] != NULL);
+	}
+
+	for (i = 0; i < 3000; ++i) {
+		sprintf (buf, "key_%d", i);
+		P_TEST_CHECK (zstr_intern (buf) == ptrs[i]);
+		P_TEST_CHECK (zstr_intern_lookup (buf) == ptrs[i]);
+		P_TEST_CHECK (strcmp (ptrs[i], buf) == 0);
+	}
+
+	/* Interned strings work as hash table keys */
+	PHashTable *table = zhash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	zhash_table_insert (table, (ppointer) zstr_intern ("key_10"), P_INT_TO_POINTER (10));
+	strcpy (buf, "key_10");
+	P_TEST_CHECK (zhash_table_lookup (table, zstr_intern (buf)) == P_INT_TO_POINTER (10));
+	zhash_table_free (table);
+
+	zlibsys_shutdown ();
+
+	/* Pool is empty after the library restart */
+	zlibsys_init ();
+
+	P_TEST_CHECK (zstr_intern_lookup ("key_10") == NULL);
+	P_TEST_CHECK (zstr_intern ("key_10") != NULL);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_intern_thread_test)
+{
+	PUThread	*threads[PSTRING_INTERN_THREADS];
+	pint		i, j;
+
+	zlibsys_init ();
+
+	for (i = 0; i < PSTRING_INTERN_THREADS; ++i) {
+		threads[i] = zuthread_create ((PUThreadFunc) pstring_intern_thread_func,
+					       P_INT_TO_POINTER (i),
+					       TRUE,
+					       "intern_worker");
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (i = 0; i < PSTRING_INTERN_THREADS; ++i) {
+		P_TEST_CHECK (zuthread_join (threads[i]) == 0);
+		zuthread_unref (threads[i]);
+	}
+
+	for (j = 0; j < PSTRING_INTERN_STRINGS; ++j) {
+		P_TEST_REQUIRE (pstring_intern_results[0][j] != NULL);
+
+		for (i = 1; i < PSTRING_INTERN_THREADS; ++i)
+			P_TEST_CHECK (pstring_intern_results[i][j] == pstring_intern_results[0][j]);
+	}
+
+	/* Thread names are not kept in the pool */
+	P_TEST_CHECK (zstr_intern_lookup ("intern_worker") == NULL);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_from_number_test)
+{
+	pchar	buf[P_STR_DOUBLE_BUF_SIZE];
+	double	val;
+	puint64	bits;
+	psize	len;
+	pint	i;
+
+	zlibsys_init ();
+
+	/* Integers */
+	P_TEST_CHECK (zstr_from_int64 (0, buf, sizeof (buf)) == 1 && strcmp (buf, "0") == 0);
+	P_TEST_CHECK (zstr_from_int64 (-7, buf, sizeof (buf)) == 2 && strcmp (buf, "-7") == 0);
+	P_TEST_CHECK (zstr_from_int64 (1234567890, buf, sizeof (buf)) == 10 &&
+		      strcmp (buf, "1234567890") == 0);
+	P_TEST_CHECK (zstr_from_int64 (P_MININT64, buf, P_STR_INT64_BUF_SIZE) == 20 &&
+		      strcmp (buf, "-9223372036854775808") == 0);
+	P_TEST_CHECK (zstr_from_int64 (P_MAXINT64, buf, sizeof (buf)) == 19 &&
+		      strcmp (buf, "9223372036854775807") == 0);
+	P_TEST_CHECK (zstr_from_uint64 (P_MAXUINT64, buf, P_STR_INT64_BUF_SIZE) == 20 &&
+		      strcmp (buf, "18446744073709551615") == 0);
+	P_TEST_CHECK (zstr_from_uint64 (100, buf, sizeof (buf)) == 3 && strcmp (buf, "100") == 0);
+
+	/* Small buffers */
+	P_TEST_CHECK (zstr_from_int64 (-12, buf, 3) == 0 && buf[0] == '\0');
+	P_TEST_CHECK (zstr_from_int64 (-12, buf, 4) == 3 && strcmp (buf, "-12") == 0);
+	P_TEST_CHECK (zstr_from_uint64 (12, NULL, 10) == 0);
+	P_TEST_CHECK (zstr_from_uint64 (12, buf, 0) == 0);
+	P_TEST_CHECK (zstr_from_double (0.5, buf, 3) == 0 && buf[0] == '\0');
+	P_TEST_CHECK (zstr_from_double (0.5, NULL, 10) == 0);
+
+	/* Doubles */
+	P_TEST_CHECK (zstr_from_double (0.0, buf, sizeof (buf)) == 1 && strcmp (buf, "0") == 0);
+	P_TEST_CHECK (zstr_from_double (-0.0, buf, sizeof (buf)) == 2 && strcmp (buf, "-0") == 0);
+	P_TEST_CHECK (zstr_from_double (1.0, buf, sizeof (buf)) == 1 && strcmp (buf, "1") == 0);
+	P_TEST_CHECK (zstr_from_double (-1.5, buf, sizeof (buf)) == 4 && strcmp (buf, "-1.5") == 0);
+	P_TEST_CHECK (zstr_from_double (0.1, buf, sizeof (buf)) == 3 && strcmp (buf, "0.1") == 0);
+	P_TEST_CHECK (zstr_from_double (0.3, buf, sizeof (buf)) == 3 && strcmp (buf, "0.3") == 0);
+	P_TEST_CHECK (zstr_from_double (100.0, buf, sizeof (buf)) == 3 && strcmp (buf, "100") == 0);
+	P_TEST_CHECK (zstr_from_double (0.0001, buf, sizeof (buf)) == 6 && strcmp (buf, "0.0001") == 0);
+	P_TEST_CHECK (zstr_from_double (1e-5, buf, sizeof (buf)) == 5 && strcmp (buf, "1e-05") == 0);
+	P_TEST_CHECK (zstr_from_double (1e16, buf, sizeof (buf)) == 17 &&
+		      strcmp (buf, "10000000000000000") == 0);
+	P_TEST_CHECK (zstr_from_double (1e17, buf, sizeof (buf)) == 5 && strcmp (buf, "1e+17") == 0);
+	P_TEST_CHECK (zstr_from_double (2.0 / 3.0, buf, sizeof (buf)) == 18 &&
+		      strcmp (buf, "0.6666666666666666") == 0);
+	P_TEST_CHECK (zstr_from_double (-2.5e-300, buf, sizeof (buf)) == 9 &&
+		      strcmp (buf, "-2.5e-300") == 0);
+	P_TEST_CHECK (zstr_from_double (5e-324, buf, sizeof (buf)) == 6 && strcmp (buf, "5e-324") == 0);
+	P_TEST_CHECK (zstr_from_double (DBL_MAX, buf, sizeof (buf)) == 23 &&
+		      strcmp (buf, "1.7976931348623157e+308") == 0);
+	P_TEST_CHECK (zstr_from_double (-DBL_MIN, buf, sizeof (buf)) == 24 &&
+		      strcmp (buf, "-2.2250738585072014e-308") == 0);
+
+	/* Powers of two have asymmetric rounding intervals */
+	P_TEST_CHECK (zstr_from_double (ldexp (1.0, 172), buf, sizeof (buf)) == 21 &&
+		      strcmp (buf, "5.986310706507379e+51") == 0);
+
+	val = HUGE_VAL;
+	P_TEST_CHECK (zstr_from_double (val, buf, sizeof (buf)) == 3 && strcmp (buf, "inf") == 0);
+	P_TEST_CHECK (zstr_from_double (-val, buf, sizeof (buf)) == 4 && strcmp (buf, "-inf") == 0);
+
+	bits = 0x7FF8000000000000ULL;
+	memcpy (&val, &bits, sizeof (val));
+	P_TEST_CHECK (zstr_from_double (val, buf, sizeof (buf)) == 3 && strcmp (buf, "nan") == 0);
+
+	/* Random values must read back exactly */
+	for (i = 0; i < 100000; ++i) {
+		do {
+			bits = pstring_test_rand ();
+			memcpy (&val, &bits, sizeof (double));
+		} while (val != val || val > DBL_MAX || val < -DBL_MAX);
+
+		len = zstr_from_double (val, buf, sizeof (buf));
+		P_TEST_CHECK (len > 0 && len == strlen (buf));
+		P_TEST_CHECK (pstring_test_same_double (zstrntod (buf, len, NULL), val));
+	}
 
 	zlibsys_shutdown ();
 }
@@ -284,6 +804,13 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (pstring_strduztest);
 	P_TEST_SUITE_RUN_CASE (pstring_strchomztest);
 	P_TEST_SUITE_RUN_CASE (pstring_strtok_test);
+	P_TEST_SUITE_RUN_CASE (pstring_strndup_test);
+	P_TEST_SUITE_RUN_CASE (pstring_strchomp_span_test);
+	P_TEST_SUITE_RUN_CASE (pstring_strtok_span_test);
 	P_TEST_SUITE_RUN_CASE (pstring_strtod_test);
+	P_TEST_SUITE_RUN_CASE (pstring_strntod_test);
+	P_TEST_SUITE_RUN_CASE (pstring_from_number_test);
+	P_TEST_SUITE_RUN_CASE (pstring_intern_test);
+	P_TEST_SUITE_RUN_CASE (pstring_intern_thread_test);
 }
 P_TEST_SUITE_END()
@@ -0,0 +1,239 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pboolean string_builder_test_vprintf (PStringBuilder *builder, const pchar *format, ...)
+{
+	zva_list	args;
+	pboolean	ret;
+
+	zva_start (args, format);
+	ret = zstring_builder_append_vprintf (builder, format, args);
+	zva_end (args);
+
+	return ret;
+}
+
+P_TEST_CASE_BEGIN (pstringbuilder_nomem_test)
+{
+	zlibsys_init ();
+
+	PStringBuilder	*builder;
+	PMemVTable	vtable;
+
+	builder = zstring_builder_new (4);
+	P_TEST_REQUIRE (builder != NULL);
+	P_TEST_CHECK (zstring_builder_append (builder, "test") == TRUE);
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (zmem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (zstring_builder_new (0) == NULL);
+	P_TEST_CHECK (zstring_builder_reserve (builder, 1024) == FALSE);
+	P_TEST_CHECK (zstring_builder_append_len (builder, "0123456789012345678901234567890123456789", 40) == FALSE);
+	P_TEST_CHECK (zstring_builder_append_printf (builder, "%0100d", 1) == FALSE);
+
+	zmem_restore_vtable ();
+
+	/* Contents are left untouched */
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder), "test") == 0);
+	P_TEST_CHECK (zstring_builder_get_len (builder) == 4);
+
+	zstring_builder_free (builder);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstringbuilder_invalid_test)
+{
+	zlibsys_init ();
+
+	PStringBuilder *builder;
+
+	P_TEST_CHECK (zstring_builder_reserve (NULL, 10) == FALSE);
+	P_TEST_CHECK (zstring_builder_append (NULL, "test") == FALSE);
+	P_TEST_CHECK (zstring_builder_append_len (NULL, "test", 4) == FALSE);
+	P_TEST_CHECK (zstring_builder_append_char (NULL, 'a') == FALSE);
+	P_TEST_CHECK (zstring_builder_append_int64 (NULL, 10) == FALSE);
+	P_TEST_CHECK (zstring_builder_append_uint64 (NULL, 10) == FALSE);
+	P_TEST_CHECK (zstring_builder_append_double (NULL, 1.0) == FALSE);
+	P_TEST_CHECK (zstring_builder_append_printf (NULL, "%d", 10) == FALSE);
+	P_TEST_CHECK (zstring_builder_get_str (NULL) == NULL);
+	P_TEST_CHECK (zstring_builder_get_len (NULL) == 0);
+	P_TEST_CHECK (zstring_builder_steal (NULL) == NULL);
+
+	zstring_builder_truncate (NULL, 0);
+	zstring_builder_free (NULL);
+
+	builder = zstring_builder_new (0);
+	P_TEST_REQUIRE (builder != NULL);
+
+	P_TEST_CHECK (zstring_builder_append (builder, NULL) == FALSE);
+	P_TEST_CHECK (zstring_builder_append_len (builder, NULL, 10) == FALSE);
+	P_TEST_CHECK (zstring_builder_append_len (builder, NULL, 0) == TRUE);
+	P_TEST_CHECK (zstring_builder_append_printf (builder, NULL) == FALSE);
+	P_TEST_CHECK (zstring_builder_get_len (builder) == 0);
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder), "") == 0);
+
+	zstring_builder_free (builder);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstringbuilder_general_test)
+{
+	zlibsys_init ();
+
+	PStringBuilder	*builder;
+	pchar		*str;
+	pchar		expected[64];
+
+	builder = zstring_builder_new (0);
+	P_TEST_REQUIRE (builder != NULL);
+
+	P_TEST_CHECK (zstring_builder_append (builder, "key") == TRUE);
+	P_TEST_CHECK (zstring_builder_append_char (builder, '=') == TRUE);
+	P_TEST_CHECK (zstring_builder_append_int64 (builder, -42) == TRUE);
+	P_TEST_CHECK (zstring_builder_append_char (builder, ';') == TRUE);
+	P_TEST_CHECK (zstring_builder_append_uint64 (builder, 18446744073709551615ULL) == TRUE);
+	P_TEST_CHECK (zstring_builder_append_char (builder, ';') == TRUE);
+	P_TEST_CHECK (zstring_builder_append_int64 (builder, P_MININT64) == TRUE);
+	P_TEST_CHECK (zstring_builder_append_char (builder, ';') == TRUE);
+	P_TEST_CHECK (zstring_builder_append_int64 (builder, 0) == TRUE);
+	P_TEST_CHECK (zstring_builder_append_len (builder, ";abc", 2) == TRUE);
+
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder),
+			      "key=-42;18446744073709551615;-9223372036854775808;0;a") == 0);
+	P_TEST_CHECK (zstring_builder_get_len (builder) == strlen (zstring_builder_get_str (builder)));
+
+	/* Doubles */
+	zstring_builder_truncate (builder, 0);
+	P_TEST_CHECK (zstring_builder_get_len (builder) == 0);
+
+	P_TEST_CHECK (zstring_builder_append_double (builder, 0.1) == TRUE);
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder), "0.1") == 0);
+
+	zstring_builder_truncate (builder, 0);
+	P_TEST_CHECK (zstring_builder_append_double (builder, -2.5e-300) == TRUE);
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder), "-2.5e-300") == 0);
+
+	zstring_builder_truncate (builder, 0);
+	P_TEST_CHECK (zstring_builder_append_double (builder, 1.0 / 3.0) == TRUE);
+	P_TEST_CHECK (zstrtod (zstring_builder_get_str (builder)) == 1.0 / 3.0);
+
+	zstring_builder_truncate (builder, 0);
+	P_TEST_CHECK (zstring_builder_append_double (builder, 100.0) == TRUE);
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder), "100") == 0);
+
+	/* Formatting, including the output longer than the free space */
+	zstring_builder_truncate (builder, 0);
+	P_TEST_CHECK (zstring_builder_append_printf (builder, "%s:%d", "port", 8080) == TRUE);
+	P_TEST_CHECK (zstring_builder_append_printf (builder, "/%0200d", 7) == TRUE);
+	P_TEST_CHECK (string_builder_test_vprintf (builder, "|%c%x", 'z', 255) == TRUE);
+
+	P_TEST_CHECK (zstring_builder_get_len (builder) == 9 + 201 + 4);
+	P_TEST_CHECK (strncmp (zstring_builder_get_str (builder), "port:8080/000", 13) == 0);
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder) + 9 + 201, "|zff") == 0);
+
+	/* Stealing the buffer */
+	str = zstring_builder_steal (builder);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strlen (str) == 9 + 201 + 4);
+	P_TEST_CHECK (zstring_builder_get_len (builder) == 0);
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder), "") == 0);
+	zfree (str);
+
+	str = zstring_builder_steal (builder);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strcmp (str, "") == 0);
+	zfree (str);
+
+	/* Building a long string piece by piece */
+	P_TEST_CHECK (zstring_builder_reserve (builder, 10) == TRUE);
+
+	for (pint i = 0; i < 10000; ++i) {
+		P_TEST_CHECK (zstring_builder_append_int64 (builder, i % 10) == TRUE);
+	}
+
+	P_TEST_CHECK (zstring_builder_get_len (builder) == 10000);
+
+	for (pint i = 0; i < 10000; ++i) {
+		if (zstring_builder_get_str (builder)[i] != '0' + (i % 10)) {
+			P_TEST_CHECK (FALSE);
+			break;
+		}
+	}
+
+	zstring_builder_truncate (builder, 3);
+	zstring_builder_truncate (builder, 100);
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder), "012") == 0);
+
+	snprintf (expected, sizeof (expected), "%d-%s", 12, "end");
+	P_TEST_CHECK (zstring_builder_append_printf (builder, "%d-%s", 12, "end") == TRUE);
+	P_TEST_CHECK (strcmp (zstring_builder_get_str (builder) + 3, expected) == 0);
+
+	zstring_builder_free (builder);
+
+	zlibsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pstringbuilder_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pstringbuilder_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pstringbuilder_general_test);
+}
+P_TEST_SUITE_END()